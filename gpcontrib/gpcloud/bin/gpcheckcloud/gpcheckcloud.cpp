@@ -148,6 +148,8 @@ static void printTemplate() {
         "version = 1\n"
         "proxy = \"\"\n"
         "autocompress = true\n"
+        "autocompress_type = gzip\n"
+        "parallel_decompress = true\n"
         "verifycert = true\n"
         "server_side_encryption = \"\"\n"
         "# gpcheckcloud config\n"
@@ -1,6 +1,7 @@
 #ifndef INCLUDE_DECOMPRESS_READER_H_
 #define INCLUDE_DECOMPRESS_READER_H_
 
+#include "gpcommon.h"
 #include "reader.h"
 #include "s3common_headers.h"
 #include "s3exception.h"
@@ -10,6 +11,13 @@
 // 2MB by default
 extern uint64_t S3_ZIP_DECOMPRESS_CHUNKSIZE;
 
+// S3KeyReader appends eolString to a key that does not end with one, which for a compressed key
+// puts it after the last frame. Return true if the 'len' bytes at 'p' are just that.
+inline bool IsAppendedEol(const char *p, uint64_t len) {
+    return len > 0 && len <= EOL_CHARS_MAX_LEN && eolString[len] == '\0' &&
+           memcmp(p, eolString, len) == 0;
+}
+
 class DecompressReader : public Reader {
    public:
     DecompressReader();
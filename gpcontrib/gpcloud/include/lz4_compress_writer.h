@@ -0,0 +1,45 @@
+#ifndef INCLUDE_LZ4_COMPRESS_WRITER_H_
+#define INCLUDE_LZ4_COMPRESS_WRITER_H_
+
+#include <lz4frame.h>
+
+#include "compress_writer.h"
+
+// Lz4CompressWriter compresses the data into a single frame of the lz4 frame format before
+// handing it to the underlying writer.
+//
+// It feeds lz4 with at most S3_ZIP_COMPRESS_CHUNKSIZE bytes at a time, and sizes its output
+// buffer for the worst case of that.
+class Lz4CompressWriter : public Writer {
+   public:
+    Lz4CompressWriter();
+    virtual ~Lz4CompressWriter();
+
+    virtual void open(const S3Params &params);
+
+    // write() attempts to write up to count bytes from the buffer.
+    // If 'count' is larger than the chunk-buffer, it invokes writeOneChunk()
+    // repeatedly to finish upload. Throw exception if encounters errors.
+    virtual uint64_t write(const char *buf, uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setWriter(Writer *writer);
+
+   private:
+    uint64_t writeOneChunk(const char *buf, uint64_t count);
+
+    Writer *writer;
+
+    // lz4 related variables.
+    LZ4F_cctx *cctx;
+    LZ4F_preferences_t prefs;
+    char *out;         // Output buffer for compression.
+    uint64_t outSize;  // Size of 'out'.
+
+    // add this flag to make close() reentrant
+    bool isClosed;
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef INCLUDE_LZ4_DECOMPRESS_READER_H_
+#define INCLUDE_LZ4_DECOMPRESS_READER_H_
+
+#include <lz4frame.h>
+
+#include "decompress_reader.h"
+
+// Lz4DecompressReader decodes data in the lz4 frame format from the underlying reader.
+// Concatenated frames are decoded one after the other.
+//
+// It shares S3_ZIP_DECOMPRESS_CHUNKSIZE with DecompressReader for its buffers.
+class Lz4DecompressReader : public Reader {
+   public:
+    Lz4DecompressReader();
+    virtual ~Lz4DecompressReader();
+
+    virtual void open(const S3Params &params);
+
+    // read() attempts to read up to count bytes into the buffer.
+    // Return 0 if EOF. Throw exception if encounters errors.
+    virtual uint64_t read(char *buf, uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setReader(Reader *reader);
+
+    void resizeDecompressReaderBuffer(uint64_t size);
+
+   private:
+    void decompress();
+
+    Reader *reader;
+
+    // lz4 related variables.
+    LZ4F_dctx *dctx;
+    size_t frameHint;       // 0 if the last frame is complete.
+    bool hasPendingOutput;  // lz4 may have more output without more input.
+    bool isInputEnd;        // The underlying reader has no more data.
+
+    char *in;            // Input buffer for decompression.
+    uint64_t inOffset;   // Next position to decompress in 'in' buffer.
+    uint64_t inLen;      // Length of data in 'in' buffer.
+    char *out;           // Output buffer for decompression.
+    uint64_t outLen;     // Length of decompressed data in 'out' buffer.
+    uint64_t bufSize;    // Size of 'in' and 'out'.
+    uint64_t outOffset;  // Next position to read in out buffer.
+
+    bool isClosed;
+};
+
+#endif /* INCLUDE_LZ4_DECOMPRESS_READER_H_ */
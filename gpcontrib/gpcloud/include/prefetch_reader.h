@@ -0,0 +1,59 @@
+#ifndef INCLUDE_PREFETCH_READER_H_
+#define INCLUDE_PREFETCH_READER_H_
+
+#include "reader.h"
+#include "s3common_headers.h"
+#include "s3exception.h"
+#include "s3macros.h"
+
+// number of buffers the prefetching thread fills ahead of read()
+#define S3_PREFETCH_BUFFER_NUM 4
+
+// PrefetchReader runs the underlying reader, usually a decompressor, in a thread of its own. The
+// thread reads ahead into a ring of S3_PREFETCH_BUFFER_NUM buffers of S3_ZIP_DECOMPRESS_CHUNKSIZE
+// bytes, so decompression runs in parallel with both the downloading threads of S3KeyReader and
+// the caller of read().
+class PrefetchReader : public Reader {
+   public:
+    PrefetchReader();
+    virtual ~PrefetchReader();
+
+    virtual void open(const S3Params &params);
+
+    // read() attempts to read up to count bytes into the buffer.
+    // Return 0 if EOF. Throw exception if encounters errors, after the data read before them.
+    virtual uint64_t read(char *buf, uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    // It waits for the thread to finish the read() of the underlying reader it is in.
+    virtual void close();
+
+    void setReader(Reader *reader);
+
+   private:
+    static void *PrefetchThreadFunc(void *data);
+    void prefetch();
+
+    Reader *reader;
+
+    pthread_t thread;
+    bool threadStarted;
+
+    // protect all the fields below, and signal changes to them.
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    vector<char> buffers[S3_PREFETCH_BUFFER_NUM];
+    uint64_t bufferLens[S3_PREFETCH_BUFFER_NUM];
+    uint64_t filledNum;   // Number of buffers filled and not read yet.
+    uint64_t readIndex;   // Buffer read() reads from, if filledNum > 0.
+    uint64_t fillIndex;   // Buffer the thread fills next.
+    uint64_t outOffset;   // Next position to read in buffers[readIndex].
+    bool isEOF;           // The thread got all data of the underlying reader.
+    bool isStopping;      // close() asks the thread to stop.
+    string errorMessage;  // Why the thread failed, if it did.
+
+    bool isClosed;
+};
+
+#endif /* INCLUDE_PREFETCH_READER_H_ */
@@ -2,10 +2,18 @@
 #define INCLUDE_S3COMMON_READER_H_
 
 #include "decompress_reader.h"
+#include "prefetch_reader.h"
 #include "s3common_headers.h"
 #include "s3exception.h"
 #include "s3key_reader.h"
 
+#ifdef GPCLOUD_ZSTD
+#include "zstd_decompress_reader.h"
+#endif
+#ifdef GPCLOUD_LZ4
+#include "lz4_decompress_reader.h"
+#endif
+
 class S3CommonReader : public Reader {
    public:
     S3CommonReader() : upstreamReader(NULL), s3InterfaceService(NULL) {
@@ -34,6 +42,13 @@ class S3CommonReader : public Reader {
     S3Interface* s3InterfaceService;
     S3KeyReader keyReader;
     DecompressReader decompressReader;
+#ifdef GPCLOUD_ZSTD
+    ZstdDecompressReader zstdDecompressReader;
+#endif
+#ifdef GPCLOUD_LZ4
+    Lz4DecompressReader lz4DecompressReader;
+#endif
+    PrefetchReader prefetchReader;
 };
 
 #endif /* INCLUDE_S3COMMON_READER_H_ */
@@ -6,6 +6,13 @@
 #include "s3key_writer.h"
 #include "s3url.h"
 
+#ifdef GPCLOUD_ZSTD
+#include "zstd_compress_writer.h"
+#endif
+#ifdef GPCLOUD_LZ4
+#include "lz4_compress_writer.h"
+#endif
+
 class S3CommonWriter : public Writer {
    public:
     S3CommonWriter() : upstreamWriter(NULL), s3InterfaceService(NULL) {
@@ -35,6 +42,12 @@ class S3CommonWriter : public Writer {
     S3Interface* s3InterfaceService;
     S3KeyWriter keyWriter;
     CompressWriter compressWriter;
+#ifdef GPCLOUD_ZSTD
+    ZstdCompressWriter zstdCompressWriter;
+#endif
+#ifdef GPCLOUD_LZ4
+    Lz4CompressWriter lz4CompressWriter;
+#endif
 };
 
 #endif
@@ -7,6 +7,14 @@
 
 enum S3SSEType { SSE_NONE, SSE_S3 };
 
+enum S3CompressionType {
+    S3_COMPRESSION_GZIP,
+    S3_COMPRESSION_PLAIN,
+    S3_COMPRESSION_DEFLATE,
+    S3_COMPRESSION_ZSTD,
+    S3_COMPRESSION_LZ4,
+};
+
 class S3Params {
    public:
     S3Params(const string& sourceUrl = "", bool useHttps = true, const string& version = "",
@@ -20,6 +28,8 @@ class S3Params {
           proxy(""),
           debugCurl(false),
           autoCompress(false),
+          autoCompressType(S3_COMPRESSION_GZIP),
+          parallelDecompress(false),
           verifyCert(false),
           sseType(SSE_NONE),
           gpcheckcloud_newline("") {
@@ -111,6 +121,22 @@ class S3Params {
         this->autoCompress = autoCompress;
     }
 
+    S3CompressionType getAutoCompressType() const {
+        return autoCompressType;
+    }
+
+    void setAutoCompressType(S3CompressionType autoCompressType) {
+        this->autoCompressType = autoCompressType;
+    }
+
+    bool isParallelDecompress() const {
+        return parallelDecompress;
+    }
+
+    void setParallelDecompress(bool parallelDecompress) {
+        this->parallelDecompress = parallelDecompress;
+    }
+
     const S3MemoryContext& getMemoryContext() const {
         return memoryContext;
     }
@@ -164,6 +190,8 @@ class S3Params {
 
     bool debugCurl;     // debug curl or not
     bool autoCompress;  // whether to compress data before uploading
+    S3CompressionType autoCompressType;  // gzip, zstd or lz4, if autoCompress
+    bool parallelDecompress;  // decompress downloaded data in a thread of its own
     bool verifyCert;  // This option determines whether curl verifies the authenticity of the peer's
                       // certificate.
 
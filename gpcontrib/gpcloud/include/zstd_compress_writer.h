@@ -0,0 +1,42 @@
+#ifndef INCLUDE_ZSTD_COMPRESS_WRITER_H_
+#define INCLUDE_ZSTD_COMPRESS_WRITER_H_
+
+#include <zstd.h>
+
+#include "compress_writer.h"
+
+// ZstdCompressWriter compresses the data into a single zstd frame before handing it to the
+// underlying writer.
+//
+// It shares S3_ZIP_COMPRESS_CHUNKSIZE with CompressWriter for its output buffer.
+class ZstdCompressWriter : public Writer {
+   public:
+    ZstdCompressWriter();
+    virtual ~ZstdCompressWriter();
+
+    virtual void open(const S3Params &params);
+
+    // write() attempts to write up to count bytes from the buffer.
+    // Throw exception if encounters errors.
+    virtual uint64_t write(const char *buf, uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setWriter(Writer *writer);
+
+   private:
+    void flush();
+
+    Writer *writer;
+
+    // zstd related variables.
+    ZSTD_CStream *zstream;
+    ZSTD_outBuffer output;  // Compressed data in 'out' buffer.
+    char *out;              // Output buffer for compression.
+
+    // add this flag to make close() reentrant
+    bool isClosed;
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef INCLUDE_ZSTD_DECOMPRESS_READER_H_
+#define INCLUDE_ZSTD_DECOMPRESS_READER_H_
+
+#include <zstd.h>
+
+#include "decompress_reader.h"
+
+// ZstdDecompressReader decodes zstd data from the underlying reader. Concatenated frames, as
+// written by pzstd or by appending files, are decoded one after the other.
+//
+// It shares S3_ZIP_DECOMPRESS_CHUNKSIZE with DecompressReader for its buffers.
+class ZstdDecompressReader : public Reader {
+   public:
+    ZstdDecompressReader();
+    virtual ~ZstdDecompressReader();
+
+    virtual void open(const S3Params &params);
+
+    // read() attempts to read up to count bytes into the buffer.
+    // Return 0 if EOF. Throw exception if encounters errors.
+    virtual uint64_t read(char *buf, uint64_t count);
+
+    // This should be reentrant, has no side effects when called multiple times.
+    virtual void close();
+
+    void setReader(Reader *reader);
+
+    void resizeDecompressReaderBuffer(uint64_t size);
+
+   private:
+    void decompress();
+
+    Reader *reader;
+
+    // zstd related variables.
+    ZSTD_DStream *zstream;
+    ZSTD_inBuffer input;    // Compressed data in 'in' buffer.
+    ZSTD_outBuffer output;  // Decompressed data in 'out' buffer.
+    size_t frameHint;       // 0 if the last frame is complete.
+    bool hasPendingOutput;  // zstd may have more output without more input.
+    bool isInputEnd;        // The underlying reader has no more data.
+
+    char *in;            // Input buffer for decompression.
+    char *out;           // Output buffer for decompression.
+    uint64_t bufSize;    // Size of 'in' and 'out'.
+    uint64_t outOffset;  // Next position to read in out buffer.
+
+    bool isClosed;
+};
+
+#endif /* INCLUDE_ZSTD_DECOMPRESS_READER_H_ */
@@ -80,7 +80,20 @@ GPWriter* writer_init(const char* url_with_options, const char* format) {
         // Prepare memory to be used for thread chunk buffer.
         PrepareS3MemContext(params);
 
-        string extName = params.isAutoCompress() ? string(format) + ".gz" : format;
+        string extName = format;
+        if (params.isAutoCompress()) {
+            switch (params.getAutoCompressType()) {
+                case S3_COMPRESSION_ZSTD:
+                    extName += ".zst";
+                    break;
+                case S3_COMPRESSION_LZ4:
+                    extName += ".lz4";
+                    break;
+                default:
+                    extName += ".gz";
+                    break;
+            }
+        }
         writer = new(std::nothrow) GPWriter(params, extName);
         if (writer == NULL) {
             return NULL;
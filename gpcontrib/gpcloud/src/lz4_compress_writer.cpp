@@ -0,0 +1,102 @@
+#include "lz4_compress_writer.h"
+
+Lz4CompressWriter::Lz4CompressWriter()
+    : writer(NULL), cctx(NULL), out(NULL), outSize(0), isClosed(true) {
+    memset(&this->prefs, 0, sizeof(this->prefs));
+    this->prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+}
+
+Lz4CompressWriter::~Lz4CompressWriter() {
+    try {
+        this->close();
+    } catch (...) {
+    }
+    delete[] this->out;
+}
+
+void Lz4CompressWriter::open(const S3Params& params) {
+    LZ4F_errorCode_t err = LZ4F_createCompressionContext(&this->cctx, LZ4F_VERSION);
+    S3_CHECK_OR_DIE(!LZ4F_isError(err), S3RuntimeError,
+                    string("Failed to initialize lz4 library: ") + LZ4F_getErrorName(err));
+
+    // The bound covers the end of the frame as well; the header is written on its own.
+    uint64_t size = std::max(LZ4F_compressBound(S3_ZIP_COMPRESS_CHUNKSIZE, &this->prefs),
+                             (size_t)LZ4F_HEADER_SIZE_MAX);
+    if (size > this->outSize) {
+        delete[] this->out;
+        this->out = new char[size];
+        this->outSize = size;
+    }
+
+    this->isClosed = false;
+
+    this->writer->open(params);
+
+    size_t ret = LZ4F_compressBegin(this->cctx, this->out, this->outSize, &this->prefs);
+    S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                    string("Failed to compress data: ") + LZ4F_getErrorName(ret));
+
+    this->writer->write(this->out, ret);
+}
+
+uint64_t Lz4CompressWriter::writeOneChunk(const char* buf, uint64_t count) {
+    // Defensive code
+    if (buf == NULL || count == 0) {
+        return 0;
+    }
+
+    size_t ret = LZ4F_compressUpdate(this->cctx, this->out, this->outSize, buf, count, NULL);
+    S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                    string("Failed to compress data: ") + LZ4F_getErrorName(ret));
+
+    // lz4 buffers input up to a block, so there might be nothing to write yet.
+    if (ret > 0) {
+        this->writer->write(this->out, ret);
+    }
+
+    return count;
+}
+
+uint64_t Lz4CompressWriter::write(const char* buf, uint64_t count) {
+    // Defensive code
+    if (buf == NULL || count == 0) {
+        return 0;
+    }
+
+    uint64_t writtenLen = 0;
+
+    for (uint64_t i = 0; i < (count / S3_ZIP_COMPRESS_CHUNKSIZE); i++) {
+        writtenLen += this->writeOneChunk(buf + writtenLen, S3_ZIP_COMPRESS_CHUNKSIZE);
+    }
+
+    if (writtenLen < count) {
+        writtenLen += this->writeOneChunk(buf + writtenLen, count - writtenLen);
+    }
+
+    return writtenLen;
+}
+
+void Lz4CompressWriter::close() {
+    if (this->isClosed) {
+        return;
+    }
+
+    size_t ret = LZ4F_compressEnd(this->cctx, this->out, this->outSize, NULL);
+
+    LZ4F_freeCompressionContext(this->cctx);
+    this->cctx = NULL;
+    this->isClosed = true;
+
+    S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                    string("Failed to compress data: ") + LZ4F_getErrorName(ret));
+
+    this->writer->write(this->out, ret);
+
+    S3DEBUG("Compression finished: end of lz4 frame.");
+
+    this->writer->close();
+}
+
+void Lz4CompressWriter::setWriter(Writer* writer) {
+    this->writer = writer;
+}
@@ -0,0 +1,142 @@
+#include "lz4_decompress_reader.h"
+
+Lz4DecompressReader::Lz4DecompressReader() : reader(NULL), dctx(NULL), isClosed(true) {
+    this->bufSize = S3_ZIP_DECOMPRESS_CHUNKSIZE;
+    this->in = new char[this->bufSize];
+    this->out = new char[this->bufSize];
+    this->inOffset = 0;
+    this->inLen = 0;
+    this->outLen = 0;
+    this->outOffset = 0;
+    this->frameHint = 0;
+    this->hasPendingOutput = false;
+    this->isInputEnd = false;
+}
+
+Lz4DecompressReader::~Lz4DecompressReader() {
+    this->close();
+
+    delete[] this->in;
+    delete[] this->out;
+}
+
+// Used for unit test to adjust buffer size
+void Lz4DecompressReader::resizeDecompressReaderBuffer(uint64_t size) {
+    delete[] this->in;
+    delete[] this->out;
+    this->bufSize = size;
+    this->in = new char[size];
+    this->out = new char[size];
+    this->inOffset = 0;
+    this->inLen = 0;
+    this->outLen = 0;
+    this->outOffset = 0;
+}
+
+void Lz4DecompressReader::setReader(Reader *reader) {
+    this->reader = reader;
+}
+
+void Lz4DecompressReader::open(const S3Params &params) {
+    LZ4F_errorCode_t ret = LZ4F_createDecompressionContext(&this->dctx, LZ4F_VERSION);
+    S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                    string("failed to initialize lz4 library: ") + LZ4F_getErrorName(ret));
+
+    this->inOffset = 0;
+    this->inLen = 0;
+    this->outLen = 0;
+    this->outOffset = 0;
+    this->frameHint = 0;
+    this->hasPendingOutput = false;
+    this->isInputEnd = false;
+
+    this->isClosed = false;
+
+    this->reader->open(params);
+}
+
+uint64_t Lz4DecompressReader::read(char *buf, uint64_t bufSize) {
+    uint64_t remainingOutLen = this->outLen - this->outOffset;
+
+    if (remainingOutLen == 0) {
+        this->decompress();
+        this->outOffset = 0;  // reset cursor for out buffer to read from beginning.
+        remainingOutLen = this->outLen;
+    }
+
+    uint64_t count = std::min(remainingOutLen, bufSize);
+    memcpy(buf, this->out + outOffset, count);
+
+    this->outOffset += count;
+
+    return count;
+}
+
+// Read compressed data from underlying reader and decompress to this->out buffer.
+// A call of LZ4F_decompress() may consume input without producing any output, e.g. a frame
+// header, so loop until there is some. If no more data to consume, this->outLen == 0.
+void Lz4DecompressReader::decompress() {
+    this->outLen = 0;
+
+    while (this->outLen == 0) {
+        if (this->inOffset == this->inLen && !this->hasPendingOutput) {
+            // read bufSize data from underlying reader and put into this->in buffer. read() might
+            // happen more than once when reaching EOF, make sure every time read() will return 0.
+            uint64_t hasRead = 0;
+            while (hasRead < this->bufSize) {
+                uint64_t count = this->reader->read(this->in + hasRead, this->bufSize - hasRead);
+
+                if (count == 0) {
+                    this->isInputEnd = true;
+                    break;
+                }
+
+                hasRead += count;
+            }
+
+            // EOF, no more data to decompress.
+            if (hasRead == 0) {
+                S3_CHECK_OR_DIE(this->frameHint == 0, S3RuntimeError,
+                                "Failed to decompress data: lz4 frame is truncated");
+                S3DEBUG("No more data to decompress.");
+                return;
+            }
+
+            this->inOffset = 0;
+            this->inLen = hasRead;
+        }
+
+        // Skip the end-of-line that S3KeyReader might append after the last frame.
+        if (this->frameHint == 0 && this->isInputEnd &&
+            IsAppendedEol(this->in + this->inOffset, this->inLen - this->inOffset)) {
+            this->inOffset = this->inLen;
+            continue;
+        }
+
+        size_t dstSize = this->bufSize;
+        size_t srcSize = this->inLen - this->inOffset;
+        size_t ret = LZ4F_decompress(this->dctx, this->out, &dstSize, this->in + this->inOffset,
+                                     &srcSize, NULL);
+        S3_CHECK_OR_DIE(!LZ4F_isError(ret), S3RuntimeError,
+                        string("Failed to decompress data: ") + LZ4F_getErrorName(ret));
+
+        this->inOffset += srcSize;
+        this->outLen = dstSize;
+        this->frameHint = ret;
+
+        // A full output buffer might leave decoded data within lz4, to get in the next call.
+        this->hasPendingOutput = (dstSize == this->bufSize);
+        if (ret == 0) {
+            S3DEBUG("Decompression of a lz4 frame finished.");
+        }
+    }
+}
+
+void Lz4DecompressReader::close() {
+    if (!this->isClosed) {
+        LZ4F_freeDecompressionContext(this->dctx);
+        this->dctx = NULL;
+        this->reader->close();
+        this->isClosed = true;
+    }
+}
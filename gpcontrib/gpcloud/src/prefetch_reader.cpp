@@ -0,0 +1,180 @@
+#include "prefetch_reader.h"
+
+PrefetchReader::PrefetchReader()
+    : reader(NULL),
+      threadStarted(false),
+      filledNum(0),
+      readIndex(0),
+      fillIndex(0),
+      outOffset(0),
+      isEOF(false),
+      isStopping(false),
+      isClosed(true) {
+    pthread_mutex_init(&this->mutex, NULL);
+    pthread_cond_init(&this->cond, NULL);
+}
+
+PrefetchReader::~PrefetchReader() {
+    try {
+        this->close();
+    } catch (...) {
+    }
+
+    pthread_mutex_destroy(&this->mutex);
+    pthread_cond_destroy(&this->cond);
+}
+
+void PrefetchReader::setReader(Reader *reader) {
+    this->reader = reader;
+}
+
+void PrefetchReader::open(const S3Params &params) {
+    this->filledNum = 0;
+    this->readIndex = 0;
+    this->fillIndex = 0;
+    this->outOffset = 0;
+    this->isEOF = false;
+    this->isStopping = false;
+    this->errorMessage.clear();
+
+    for (int i = 0; i < S3_PREFETCH_BUFFER_NUM; i++) {
+        this->buffers[i].resize(S3_ZIP_DECOMPRESS_CHUNKSIZE);
+        this->bufferLens[i] = 0;
+    }
+
+    this->isClosed = false;
+
+    this->reader->open(params);
+
+    int ret = pthread_create(&this->thread, NULL, PrefetchThreadFunc, this);
+    S3_CHECK_OR_DIE(ret == 0, S3RuntimeError,
+                    string("Failed to create prefetching thread: ") + strerror(ret));
+    this->threadStarted = true;
+}
+
+void *PrefetchReader::PrefetchThreadFunc(void *data) {
+    MaskThreadSignals();
+
+    PrefetchReader *prefetchReader = static_cast<PrefetchReader *>(data);
+
+    S3DEBUG("Prefetching thread starts");
+    prefetchReader->prefetch();
+    S3DEBUG("Prefetching thread ended");
+
+    return NULL;
+}
+
+// The loop of the prefetching thread: fill the free buffers one by one, until EOF, an error, or
+// close().
+void PrefetchReader::prefetch() {
+    while (true) {
+        uint64_t index;
+
+        {
+            UniqueLock lock(&this->mutex);
+            while (this->filledNum == S3_PREFETCH_BUFFER_NUM && !this->isStopping) {
+                pthread_cond_wait(&this->cond, &this->mutex);
+            }
+            if (this->isStopping) {
+                return;
+            }
+            index = this->fillIndex;
+        }
+
+        // Only this thread touches a buffer that is not filled, no need to lock.
+        vector<char> &buffer = this->buffers[index];
+        uint64_t filledLen = 0;
+        string error;
+
+        try {
+            while (filledLen < buffer.size()) {
+                uint64_t count =
+                    this->reader->read(buffer.data() + filledLen, buffer.size() - filledLen);
+                if (count == 0) {
+                    break;
+                }
+                filledLen += count;
+            }
+        } catch (S3Exception &e) {
+            error = e.getFullMessage();
+        } catch (...) {
+            error = "Unexpected exception in prefetching thread";
+        }
+
+        UniqueLock lock(&this->mutex);
+        if (filledLen > 0) {
+            this->bufferLens[index] = filledLen;
+            this->fillIndex = (index + 1) % S3_PREFETCH_BUFFER_NUM;
+            this->filledNum++;
+        }
+        if (!error.empty()) {
+            this->errorMessage = error;
+        } else if (filledLen < buffer.size()) {
+            this->isEOF = true;
+        }
+        pthread_cond_signal(&this->cond);
+
+        if (this->isEOF || !this->errorMessage.empty()) {
+            return;
+        }
+    }
+}
+
+uint64_t PrefetchReader::read(char *buf, uint64_t count) {
+    const char *data;
+    uint64_t len;
+
+    {
+        UniqueLock lock(&this->mutex);
+
+        while (true) {
+            // Give back the buffer that has been read through.
+            if (this->filledNum > 0 && this->outOffset == this->bufferLens[this->readIndex]) {
+                this->readIndex = (this->readIndex + 1) % S3_PREFETCH_BUFFER_NUM;
+                this->filledNum--;
+                this->outOffset = 0;
+                pthread_cond_signal(&this->cond);
+            }
+
+            if (this->filledNum > 0 || this->isEOF || !this->errorMessage.empty()) {
+                break;
+            }
+
+            pthread_cond_wait(&this->cond, &this->mutex);
+        }
+
+        if (this->filledNum == 0) {
+            S3_CHECK_OR_DIE(this->errorMessage.empty(), S3RuntimeError, this->errorMessage);
+            return 0;
+        }
+
+        data = this->buffers[this->readIndex].data() + this->outOffset;
+        len = std::min(count, this->bufferLens[this->readIndex] - this->outOffset);
+    }
+
+    // The thread does not touch a filled buffer until it is given back, no need to lock.
+    memcpy(buf, data, len);
+    this->outOffset += len;
+
+    return len;
+}
+
+void PrefetchReader::close() {
+    if (this->isClosed) {
+        return;
+    }
+
+    if (this->threadStarted) {
+        {
+            UniqueLock lock(&this->mutex);
+            this->isStopping = true;
+            pthread_cond_signal(&this->cond);
+        }
+
+        pthread_join(this->thread, NULL);
+        this->threadStarted = false;
+    }
+
+    this->isClosed = true;
+    this->reader->close();
+}
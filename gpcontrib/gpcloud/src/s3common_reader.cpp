@@ -11,6 +11,24 @@ void S3CommonReader::open(const S3Params &params) {
             this->upstreamReader = &this->decompressReader;
             this->decompressReader.setReader(&this->keyReader);
             break;
+        case S3_COMPRESSION_ZSTD:
+#ifdef GPCLOUD_ZSTD
+            this->upstreamReader = &this->zstdDecompressReader;
+            this->zstdDecompressReader.setReader(&this->keyReader);
+            break;
+#else
+            S3_DIE(S3RuntimeError,
+                   "zstd compressed data found, but gpcloud is built without zstd support");
+#endif
+        case S3_COMPRESSION_LZ4:
+#ifdef GPCLOUD_LZ4
+            this->upstreamReader = &this->lz4DecompressReader;
+            this->lz4DecompressReader.setReader(&this->keyReader);
+            break;
+#else
+            S3_DIE(S3RuntimeError,
+                   "lz4 compressed data found, but gpcloud is built without lz4 support");
+#endif
         case S3_COMPRESSION_PLAIN:
             this->upstreamReader = &this->keyReader;
             break;
@@ -18,6 +36,12 @@ void S3CommonReader::open(const S3Params &params) {
             S3_CHECK_OR_DIE(false, S3RuntimeError, "unknown file type");
     };
 
+    // Decompress in a thread of its own, while the caller consumes what is decompressed already.
+    if (compressionType != S3_COMPRESSION_PLAIN && params.isParallelDecompress()) {
+        this->prefetchReader.setReader(this->upstreamReader);
+        this->upstreamReader = &this->prefetchReader;
+    }
+
     this->upstreamReader->open(params);
 }
 
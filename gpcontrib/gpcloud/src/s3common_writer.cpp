@@ -4,8 +4,24 @@ void S3CommonWriter::open(const S3Params& params) {
     this->keyWriter.setS3InterfaceService(this->s3InterfaceService);
 
     if (params.isAutoCompress()) {
-        this->upstreamWriter = &this->compressWriter;
-        this->compressWriter.setWriter(&this->keyWriter);
+        switch (params.getAutoCompressType()) {
+#ifdef GPCLOUD_ZSTD
+            case S3_COMPRESSION_ZSTD:
+                this->upstreamWriter = &this->zstdCompressWriter;
+                this->zstdCompressWriter.setWriter(&this->keyWriter);
+                break;
+#endif
+#ifdef GPCLOUD_LZ4
+            case S3_COMPRESSION_LZ4:
+                this->upstreamWriter = &this->lz4CompressWriter;
+                this->lz4CompressWriter.setWriter(&this->keyWriter);
+                break;
+#endif
+            default:
+                this->upstreamWriter = &this->compressWriter;
+                this->compressWriter.setWriter(&this->keyWriter);
+                break;
+        }
     } else {
         this->upstreamWriter = &this->keyWriter;
     }
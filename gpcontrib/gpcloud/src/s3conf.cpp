@@ -125,6 +125,30 @@ S3Params InitConfig(const string& urlWithOptions) {
 
     params.setAutoCompress(s3Cfg.GetBool(configSection, "autocompress", "true"));
 
+    string compressType = s3Cfg.Get(configSection, "autocompress_type", "gzip");
+    if (compressType == "zstd") {
+#ifndef GPCLOUD_ZSTD
+        S3_DIE(S3ConfigError,
+               "\"FATAL: autocompress_type is zstd, but gpcloud is built without zstd support\"",
+               "autocompress_type");
+#endif
+        params.setAutoCompressType(S3_COMPRESSION_ZSTD);
+    } else if (compressType == "lz4") {
+#ifndef GPCLOUD_LZ4
+        S3_DIE(S3ConfigError,
+               "\"FATAL: autocompress_type is lz4, but gpcloud is built without lz4 support\"",
+               "autocompress_type");
+#endif
+        params.setAutoCompressType(S3_COMPRESSION_LZ4);
+    } else {
+        S3_CHECK_OR_DIE(compressType == "gzip", S3ConfigError,
+                        "\"FATAL: autocompress_type must be gzip, zstd or lz4\"",
+                        "autocompress_type");
+        params.setAutoCompressType(S3_COMPRESSION_GZIP);
+    }
+
+    params.setParallelDecompress(s3Cfg.GetBool(configSection, "parallel_decompress", "true"));
+
     params.setVerifyCert(s3Cfg.GetBool(configSection, "verifycert", "true"));
 
     string sse_type = s3Cfg.Get(configSection, "server_side_encryption", "");
@@ -405,6 +405,18 @@ S3CompressionType S3InterfaceService::checkCompressionType(const S3Url &s3Url) {
         if ((responseData[0] == 0x1f) && (responseData[1] == 0x8b)) {
             return S3_COMPRESSION_GZIP;
         }
+
+        // magic number of a zstd frame, 0xFD2FB528 in little-endian
+        if ((responseData[0] == 0x28) && (responseData[1] == 0xb5) && (responseData[2] == 0x2f) &&
+            (responseData[3] == 0xfd)) {
+            return S3_COMPRESSION_ZSTD;
+        }
+
+        // magic number of an lz4 frame, 0x184D2204 in little-endian
+        if ((responseData[0] == 0x04) && (responseData[1] == 0x22) && (responseData[2] == 0x4d) &&
+            (responseData[3] == 0x18)) {
+            return S3_COMPRESSION_LZ4;
+        }
     } else if (resp.getStatus() == RESPONSE_ERROR) {
         S3MessageParser s3msg(resp);
         S3_DIE(S3LogicError, s3msg.getCode(), s3msg.getMessage());
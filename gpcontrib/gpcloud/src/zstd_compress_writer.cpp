@@ -0,0 +1,97 @@
+#include "zstd_compress_writer.h"
+
+ZstdCompressWriter::ZstdCompressWriter() : writer(NULL), zstream(NULL), isClosed(true) {
+    this->out = new char[S3_ZIP_COMPRESS_CHUNKSIZE];
+}
+
+ZstdCompressWriter::~ZstdCompressWriter() {
+    try {
+        this->close();
+    } catch (...) {
+    }
+    delete[] this->out;
+}
+
+void ZstdCompressWriter::open(const S3Params& params) {
+    this->zstream = ZSTD_createCStream();
+    S3_CHECK_OR_DIE(this->zstream != NULL, S3RuntimeError, "Failed to initialize zstd library");
+
+    size_t ret = ZSTD_initCStream(this->zstream, ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(ret)) {
+        ZSTD_freeCStream(this->zstream);
+        this->zstream = NULL;
+        S3_DIE(S3RuntimeError,
+               string("Failed to initialize zstd library: ") + ZSTD_getErrorName(ret));
+    }
+
+    this->isClosed = false;
+
+    // init them here to get ready for both writer() and close()
+    this->output.dst = this->out;
+    this->output.size = S3_ZIP_COMPRESS_CHUNKSIZE;
+    this->output.pos = 0;
+
+    this->writer->open(params);
+}
+
+uint64_t ZstdCompressWriter::write(const char* buf, uint64_t count) {
+    // Defensive code
+    if (buf == NULL || count == 0) {
+        return 0;
+    }
+
+    ZSTD_inBuffer input = {buf, count, 0};
+
+    // zstd takes input of any size, and returns once it is all consumed or the output buffer is
+    // full; incompressible input can take several rounds.
+    while (input.pos < input.size) {
+        size_t ret = ZSTD_compressStream(this->zstream, &this->output, &input);
+        S3_CHECK_OR_DIE(!ZSTD_isError(ret), S3RuntimeError,
+                        string("Failed to compress data: ") + ZSTD_getErrorName(ret));
+
+        if (this->output.pos == this->output.size) {
+            this->flush();
+        }
+    }
+
+    return count;
+}
+
+void ZstdCompressWriter::close() {
+    if (this->isClosed) {
+        return;
+    }
+
+    size_t ret;
+    do {
+        ret = ZSTD_endStream(this->zstream, &this->output);
+        if (ZSTD_isError(ret)) {
+            break;
+        }
+        this->flush();
+    } while (ret > 0);
+
+    ZSTD_freeCStream(this->zstream);
+    this->zstream = NULL;
+    this->isClosed = true;
+
+    if (ZSTD_isError(ret)) {
+        S3_CHECK_OR_DIE(false, S3RuntimeError,
+                        string("Failed to compress data: ") + ZSTD_getErrorName(ret));
+    }
+
+    S3DEBUG("Compression finished: end of zstd frame.");
+
+    this->writer->close();
+}
+
+void ZstdCompressWriter::setWriter(Writer* writer) {
+    this->writer = writer;
+}
+
+void ZstdCompressWriter::flush() {
+    if (this->output.pos > 0) {
+        this->writer->write(this->out, this->output.pos);
+        this->output.pos = 0;
+    }
+}
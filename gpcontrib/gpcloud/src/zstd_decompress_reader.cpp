@@ -0,0 +1,156 @@
+#include "zstd_decompress_reader.h"
+
+ZstdDecompressReader::ZstdDecompressReader() : reader(NULL), zstream(NULL), isClosed(true) {
+    this->bufSize = S3_ZIP_DECOMPRESS_CHUNKSIZE;
+    this->in = new char[this->bufSize];
+    this->out = new char[this->bufSize];
+    this->outOffset = 0;
+    this->frameHint = 0;
+    this->hasPendingOutput = false;
+    this->isInputEnd = false;
+
+    this->input.src = this->in;
+    this->input.size = 0;
+    this->input.pos = 0;
+    this->output.dst = this->out;
+    this->output.size = this->bufSize;
+    this->output.pos = 0;
+}
+
+ZstdDecompressReader::~ZstdDecompressReader() {
+    this->close();
+
+    delete[] this->in;
+    delete[] this->out;
+}
+
+// Used for unit test to adjust buffer size
+void ZstdDecompressReader::resizeDecompressReaderBuffer(uint64_t size) {
+    delete[] this->in;
+    delete[] this->out;
+    this->bufSize = size;
+    this->in = new char[size];
+    this->out = new char[size];
+    this->outOffset = 0;
+
+    this->input.src = this->in;
+    this->input.size = 0;
+    this->input.pos = 0;
+    this->output.dst = this->out;
+    this->output.size = size;
+    this->output.pos = 0;
+}
+
+void ZstdDecompressReader::setReader(Reader *reader) {
+    this->reader = reader;
+}
+
+void ZstdDecompressReader::open(const S3Params &params) {
+    this->zstream = ZSTD_createDStream();
+    S3_CHECK_OR_DIE(this->zstream != NULL, S3RuntimeError, "failed to initialize zstd library");
+
+    size_t ret = ZSTD_initDStream(this->zstream);
+    if (ZSTD_isError(ret)) {
+        ZSTD_freeDStream(this->zstream);
+        this->zstream = NULL;
+        S3_DIE(S3RuntimeError,
+               string("failed to initialize zstd library: ") + ZSTD_getErrorName(ret));
+    }
+
+    this->input.src = this->in;
+    this->input.size = 0;
+    this->input.pos = 0;
+    this->output.dst = this->out;
+    this->output.size = this->bufSize;
+    this->output.pos = 0;
+    this->outOffset = 0;
+    this->frameHint = 0;
+    this->hasPendingOutput = false;
+    this->isInputEnd = false;
+
+    this->isClosed = false;
+
+    this->reader->open(params);
+}
+
+uint64_t ZstdDecompressReader::read(char *buf, uint64_t bufSize) {
+    uint64_t remainingOutLen = this->output.pos - this->outOffset;
+
+    if (remainingOutLen == 0) {
+        this->decompress();
+        this->outOffset = 0;  // reset cursor for out buffer to read from beginning.
+        remainingOutLen = this->output.pos;
+    }
+
+    uint64_t count = std::min(remainingOutLen, bufSize);
+    memcpy(buf, this->out + outOffset, count);
+
+    this->outOffset += count;
+
+    return count;
+}
+
+// Read compressed data from underlying reader and decompress to this->out buffer.
+// Unlike inflate(), a call of ZSTD_decompressStream() may consume input without producing any
+// output, so loop until there is some. If no more data to consume, this->output.pos == 0.
+void ZstdDecompressReader::decompress() {
+    this->output.pos = 0;
+
+    while (this->output.pos == 0) {
+        if (this->input.pos == this->input.size && !this->hasPendingOutput) {
+            // read bufSize data from underlying reader and put into this->in buffer. read() might
+            // happen more than once when reaching EOF, make sure every time read() will return 0.
+            uint64_t hasRead = 0;
+            while (hasRead < this->bufSize) {
+                uint64_t count = this->reader->read(this->in + hasRead, this->bufSize - hasRead);
+
+                if (count == 0) {
+                    this->isInputEnd = true;
+                    break;
+                }
+
+                hasRead += count;
+            }
+
+            // EOF, no more data to decompress.
+            if (hasRead == 0) {
+                S3_CHECK_OR_DIE(this->frameHint == 0, S3RuntimeError,
+                                "Failed to decompress data: zstd frame is truncated");
+                S3DEBUG("No more data to decompress.");
+                return;
+            }
+
+            this->input.src = this->in;
+            this->input.size = hasRead;
+            this->input.pos = 0;
+        }
+
+        // Skip the end-of-line that S3KeyReader might append after the last frame.
+        if (this->frameHint == 0 && this->isInputEnd &&
+            IsAppendedEol(this->in + this->input.pos, this->input.size - this->input.pos)) {
+            this->input.pos = this->input.size;
+            continue;
+        }
+
+        size_t ret = ZSTD_decompressStream(this->zstream, &this->output, &this->input);
+        S3_CHECK_OR_DIE(!ZSTD_isError(ret), S3RuntimeError,
+                        string("Failed to decompress data: ") + ZSTD_getErrorName(ret));
+
+        this->frameHint = ret;
+
+        // A full output buffer might leave decoded data within zstd, to get in the next call.
+        this->hasPendingOutput = (this->output.pos == this->output.size);
+        if (ret == 0) {
+            S3DEBUG("Decompression of a zstd frame finished.");
+        }
+    }
+}
+
+void ZstdDecompressReader::close() {
+    if (!this->isClosed) {
+        ZSTD_freeDStream(this->zstream);
+        this->zstream = NULL;
+        this->reader->close();
+        this->isClosed = true;
+    }
+}
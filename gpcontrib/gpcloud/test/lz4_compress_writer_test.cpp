@@ -0,0 +1,134 @@
+#include "lz4_compress_writer.cpp"
+#include <random>
+#include "gtest/gtest.h"
+
+class MockLz4Writer : public Writer {
+   public:
+    virtual void open(const S3Params &params) {
+    }
+
+    virtual uint64_t write(const char *buf, uint64_t count) {
+        this->data.insert(this->data.end(), buf, buf + count);
+        return count;
+    }
+
+    virtual void close() {
+    }
+
+    const char *getRawData() const {
+        return this->data.data();
+    }
+
+    size_t getDataSize() const {
+        return this->data.size();
+    }
+
+   private:
+    vector<char> data;
+};
+
+class Lz4CompressWriterTest : public testing::Test {
+   protected:
+    // Remember that SetUp() is run immediately before a test starts.
+    virtual void SetUp() {
+        lz4Writer.setWriter(&writer);
+        lz4Writer.open(S3Params("s3://abc/def/"));
+    }
+
+    // TearDown() is invoked immediately after a test finishes.
+    virtual void TearDown() {
+        lz4Writer.close();
+    }
+
+    vector<char> uncompress() {
+        LZ4F_dctx *dctx;
+        EXPECT_FALSE(LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION)));
+
+        // The size is unknown for a streamed frame, so be generous.
+        vector<char> out(S3_ZIP_COMPRESS_CHUNKSIZE * 30);
+        size_t outLen = out.size();
+        size_t inLen = writer.getDataSize();
+        size_t ret =
+            LZ4F_decompress(dctx, out.data(), &outLen, writer.getRawData(), &inLen, NULL);
+        LZ4F_freeDecompressionContext(dctx);
+
+        // 0 means the whole frame was decoded, checksum included.
+        EXPECT_EQ((size_t)0, ret);
+        EXPECT_EQ(writer.getDataSize(), inLen);
+        out.resize(LZ4F_isError(ret) ? 0 : outLen);
+        return out;
+    }
+
+    Lz4CompressWriter lz4Writer;
+    MockLz4Writer writer;
+};
+
+TEST_F(Lz4CompressWriterTest, AbleToInputNull) {
+    // open() has written the frame header already.
+    size_t headerSize = writer.getDataSize();
+
+    lz4Writer.write(NULL, 0);
+    EXPECT_EQ(headerSize, writer.getDataSize());
+}
+
+TEST_F(Lz4CompressWriterTest, AbleToCompressEmptyData) {
+    lz4Writer.close();
+
+    EXPECT_EQ((size_t)0, this->uncompress().size());
+}
+
+TEST_F(Lz4CompressWriterTest, AbleToCompressAndCheckLz4Header) {
+    char input[10] = {0};
+    lz4Writer.write(input, sizeof(input));
+    lz4Writer.close();
+
+    const char *header = writer.getRawData();
+    ASSERT_TRUE(header[0] == char(0x04));
+    ASSERT_TRUE(header[1] == char(0x22));
+    ASSERT_TRUE(header[2] == char(0x4d));
+    ASSERT_TRUE(header[3] == char(0x18));
+}
+
+TEST_F(Lz4CompressWriterTest, CloseMultipleTimes) {
+    const char input[] = "The quick brown fox jumps over the lazy dog";
+    lz4Writer.write(input, sizeof(input));
+
+    lz4Writer.close();
+    lz4Writer.close();
+
+    vector<char> out = this->uncompress();
+    ASSERT_EQ(sizeof(input), out.size());
+    EXPECT_STREQ(input, out.data());
+}
+
+TEST_F(Lz4CompressWriterTest, AbleToWriteServeralTimesBeforeClose) {
+    const char pangram[] = "The quick brown fox jumps over the lazy dog\n";
+    for (int i = 0; i < 100; i++) {
+        lz4Writer.write(pangram, sizeof(pangram) - 1);
+    }
+    lz4Writer.close();
+
+    vector<char> out = this->uncompress();
+    ASSERT_EQ((sizeof(pangram) - 1) * 100, out.size());
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(0, memcmp(pangram, out.data() + i * (sizeof(pangram) - 1), sizeof(pangram) - 1));
+    }
+}
+
+TEST_F(Lz4CompressWriterTest, CompressIncompressibleDataLargerThanChunkSize) {
+    // random data does not compress, and is fed to lz4 in several chunks.
+    size_t dataLen = S3_ZIP_COMPRESS_CHUNKSIZE * 3 + 17;
+    vector<char> data(dataLen);
+
+    std::mt19937 gen(42);
+    for (size_t i = 0; i < dataLen; i++) {
+        data[i] = (char)gen();
+    }
+
+    lz4Writer.write(data.data(), dataLen);
+    lz4Writer.close();
+
+    vector<char> out = this->uncompress();
+    ASSERT_EQ(dataLen, out.size());
+    EXPECT_TRUE(data == out);
+}
@@ -0,0 +1,133 @@
+#include "prefetch_reader.cpp"
+#include "gtest/gtest.h"
+
+class MockPrefetchSourceReader : public Reader {
+   public:
+    MockPrefetchSourceReader() : offset(0), chunkSize(7), failAfter(0), isOpened(false) {
+    }
+
+    void open(const S3Params &params) {
+        this->isOpened = true;
+    }
+    void close() {
+        this->isOpened = false;
+    }
+
+    void setData(uint64_t size) {
+        this->data.resize(size);
+        for (uint64_t i = 0; i < size; i++) {
+            this->data[i] = 'a' + (i % 26);
+        }
+        this->offset = 0;
+    }
+
+    // Throw once 'failAfter' bytes have been read, if not 0.
+    void setFailAfter(uint64_t failAfter) {
+        this->failAfter = failAfter;
+    }
+
+    uint64_t read(char *buf, uint64_t count) {
+        if (this->failAfter > 0 && this->offset >= this->failAfter) {
+            throw S3RuntimeError("failed to read");
+        }
+
+        uint64_t size = std::min(std::min(count, this->chunkSize), this->data.size() - offset);
+        memcpy(buf, this->data.data() + this->offset, size);
+        this->offset += size;
+        return size;
+    }
+
+    vector<char> data;
+    uint64_t offset;
+    uint64_t chunkSize;
+    uint64_t failAfter;
+    bool isOpened;
+};
+
+class PrefetchReaderTest : public testing::Test {
+   protected:
+    // Remember that SetUp() is run immediately before a test starts.
+    virtual void SetUp() {
+        // small buffers, to go round the ring several times.
+        S3_ZIP_DECOMPRESS_CHUNKSIZE = 64;
+        prefetchReader.setReader(&sourceReader);
+    }
+
+    // TearDown() is invoked immediately after a test finishes.
+    virtual void TearDown() {
+        prefetchReader.close();
+
+        // reset to default, because some tests will modify it
+        S3_ZIP_DECOMPRESS_CHUNKSIZE = S3_ZIP_DEFAULT_CHUNKSIZE;
+    }
+
+    uint64_t readAll(vector<char> &out, uint64_t readSize) {
+        char buf[1000];
+        uint64_t count;
+        while ((count = prefetchReader.read(buf, readSize)) > 0) {
+            out.insert(out.end(), buf, buf + count);
+        }
+        return out.size();
+    }
+
+    PrefetchReader prefetchReader;
+    MockPrefetchSourceReader sourceReader;
+};
+
+TEST_F(PrefetchReaderTest, ReadEmptyData) {
+    sourceReader.setData(0);
+    prefetchReader.open(S3Params("s3://abc/def"));
+
+    char buf[100];
+    EXPECT_EQ((uint64_t)0, prefetchReader.read(buf, sizeof(buf)));
+    EXPECT_EQ((uint64_t)0, prefetchReader.read(buf, sizeof(buf)));
+}
+
+TEST_F(PrefetchReaderTest, ReadAllDataInOrder) {
+    sourceReader.setData(10000);
+    prefetchReader.open(S3Params("s3://abc/def"));
+
+    vector<char> out;
+    EXPECT_EQ((uint64_t)10000, this->readAll(out, 100));
+    EXPECT_TRUE(sourceReader.data == out);
+}
+
+TEST_F(PrefetchReaderTest, ReadWithSmallReadBuffer) {
+    sourceReader.setData(1000);
+    prefetchReader.open(S3Params("s3://abc/def"));
+
+    vector<char> out;
+    EXPECT_EQ((uint64_t)1000, this->readAll(out, 5));
+    EXPECT_TRUE(sourceReader.data == out);
+}
+
+TEST_F(PrefetchReaderTest, ThrowErrorAfterData) {
+    sourceReader.setData(1000);
+    sourceReader.setFailAfter(200);
+    prefetchReader.open(S3Params("s3://abc/def"));
+
+    // All the data read before the error comes first.
+    char buf[1000];
+    uint64_t total = 0;
+    EXPECT_THROW(
+        {
+            uint64_t count;
+            while ((count = prefetchReader.read(buf, sizeof(buf))) > 0) {
+                total += count;
+            }
+        },
+        S3RuntimeError);
+    EXPECT_EQ(sourceReader.offset, total);
+}
+
+TEST_F(PrefetchReaderTest, CloseBeforeEOF) {
+    sourceReader.setData(100000);
+    prefetchReader.open(S3Params("s3://abc/def"));
+
+    char buf[10];
+    EXPECT_EQ((uint64_t)10, prefetchReader.read(buf, sizeof(buf)));
+
+    prefetchReader.close();
+    prefetchReader.close();
+    EXPECT_FALSE(sourceReader.isOpened);
+}
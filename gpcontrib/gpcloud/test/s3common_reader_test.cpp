@@ -86,3 +86,81 @@ TEST_F(S3CommonReaderTest, ReadGZip) {
     EXPECT_EQ((uint64_t)0, this->upstreamReader->read(result, sizeof(result)));
     EXPECT_EQ(0, memcmp(result, hello, sizeof(hello)));
 }
+
+#ifdef GPCLOUD_ZSTD
+TEST_F(S3CommonReaderTest, ReadZstd) {
+    char compressionBuff[0x100];
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+
+    size_t compressedLen =
+        ZSTD_compress(compressionBuff, sizeof(compressionBuff), hello, sizeof(hello), 1);
+
+    mockS3Interface.setData((Byte *)compressionBuff, compressedLen);
+
+    EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_ZSTD));
+
+    EXPECT_CALL(mockS3Interface, fetchData(_, _, _, _))
+        .WillOnce(Invoke(&mockS3Interface, &MockS3InterfaceForCompressionRead::mockFetchData));
+
+    char result[0x100];
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setChunkSize(1024 * 1024 * 2);
+    params.setKeySize(compressedLen);
+    this->open(params);
+
+    ASSERT_EQ(this->upstreamReader, &this->zstdDecompressReader);
+    EXPECT_EQ(sizeof(hello), this->upstreamReader->read(result, sizeof(result)));
+    EXPECT_EQ((uint64_t)0, this->upstreamReader->read(result, sizeof(result)));
+    EXPECT_EQ(0, memcmp(result, hello, sizeof(hello)));
+}
+#else
+TEST_F(S3CommonReaderTest, ReadZstdWithoutSupport) {
+    EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_ZSTD));
+
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setChunkSize(1024 * 1024 * 2);
+    EXPECT_THROW(this->open(params), S3RuntimeError);
+}
+#endif
+
+#ifdef GPCLOUD_LZ4
+TEST_F(S3CommonReaderTest, ReadLz4InParallel) {
+    char compressionBuff[0x100];
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+
+    size_t compressedLen =
+        LZ4F_compressFrame(compressionBuff, sizeof(compressionBuff), hello, sizeof(hello), NULL);
+
+    mockS3Interface.setData((Byte *)compressionBuff, compressedLen);
+
+    EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_LZ4));
+
+    EXPECT_CALL(mockS3Interface, fetchData(_, _, _, _))
+        .WillOnce(Invoke(&mockS3Interface, &MockS3InterfaceForCompressionRead::mockFetchData));
+
+    char result[0x100];
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setChunkSize(1024 * 1024 * 2);
+    params.setKeySize(compressedLen);
+    params.setParallelDecompress(true);
+    this->open(params);
+
+    // the lz4 reader runs in the thread of the prefetching reader.
+    ASSERT_EQ(this->upstreamReader, &this->prefetchReader);
+    EXPECT_EQ(sizeof(hello), this->upstreamReader->read(result, sizeof(result)));
+    EXPECT_EQ((uint64_t)0, this->upstreamReader->read(result, sizeof(result)));
+    EXPECT_EQ(0, memcmp(result, hello, sizeof(hello)));
+}
+#else
+TEST_F(S3CommonReaderTest, ReadLz4WithoutSupport) {
+    EXPECT_CALL(mockS3Interface, checkCompressionType(_)).WillOnce(Return(S3_COMPRESSION_LZ4));
+
+    S3Params params("s3://abc/def");
+    params.setNumOfChunks(1);
+    params.setChunkSize(1024 * 1024 * 2);
+    EXPECT_THROW(this->open(params), S3RuntimeError);
+}
+#endif
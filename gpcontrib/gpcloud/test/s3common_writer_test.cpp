@@ -228,3 +228,75 @@ TEST_F(S3CommonWriteTest, WriteGZipDataMultipleTimes) {
         ASSERT_TRUE(memcmp(input, (const char *)this->out + i * sizeof(input), sizeof(input)) == 0);
     }
 }
+
+#ifdef GPCLOUD_ZSTD
+TEST_F(S3CommonWriteTest, WriteZstdData) {
+    EXPECT_CALL(mockS3Interface, getUploadId(_))
+        .WillOnce(Invoke(&mockS3Interface, &MockS3InterfaceForCompressionWrite::mockGetUploadId));
+    EXPECT_CALL(mockS3Interface, uploadPartOfData(_, _, _, _))
+        .WillOnce(
+            Invoke(&mockS3Interface, &MockS3InterfaceForCompressionWrite::mockUploadPartOfData));
+    EXPECT_CALL(mockS3Interface, completeMultiPart(_, _, _))
+        .WillOnce(
+            Invoke(&mockS3Interface, &MockS3InterfaceForCompressionWrite::mockCompleteMultiPart));
+
+    S3Params params("s3://abc/def");
+    params.setAutoCompress(true);
+    params.setAutoCompressType(S3_COMPRESSION_ZSTD);
+    params.setNumOfChunks(1);
+    params.setChunkSize(S3_ZIP_COMPRESS_CHUNKSIZE + 1);
+
+    this->open(params);
+    ASSERT_EQ(this->upstreamWriter, &this->zstdCompressWriter);
+
+    // 44 bytes
+    const char input[] = "The quick brown fox jumps over the lazy dog";
+    this->write(input, sizeof(input));
+    this->close();
+
+    size_t ret = ZSTD_decompress(this->out, S3_ZIP_DECOMPRESS_CHUNKSIZE,
+                                 this->mockS3Interface.getRawData(),
+                                 this->mockS3Interface.getDataSize());
+    EXPECT_EQ(sizeof(input), ret);
+    EXPECT_STREQ(input, (const char *)this->out);
+}
+#endif
+
+#ifdef GPCLOUD_LZ4
+TEST_F(S3CommonWriteTest, WriteLz4Data) {
+    EXPECT_CALL(mockS3Interface, getUploadId(_))
+        .WillOnce(Invoke(&mockS3Interface, &MockS3InterfaceForCompressionWrite::mockGetUploadId));
+    EXPECT_CALL(mockS3Interface, uploadPartOfData(_, _, _, _))
+        .WillOnce(
+            Invoke(&mockS3Interface, &MockS3InterfaceForCompressionWrite::mockUploadPartOfData));
+    EXPECT_CALL(mockS3Interface, completeMultiPart(_, _, _))
+        .WillOnce(
+            Invoke(&mockS3Interface, &MockS3InterfaceForCompressionWrite::mockCompleteMultiPart));
+
+    S3Params params("s3://abc/def");
+    params.setAutoCompress(true);
+    params.setAutoCompressType(S3_COMPRESSION_LZ4);
+    params.setNumOfChunks(1);
+    params.setChunkSize(S3_ZIP_COMPRESS_CHUNKSIZE + 1);
+
+    this->open(params);
+    ASSERT_EQ(this->upstreamWriter, &this->lz4CompressWriter);
+
+    // 44 bytes
+    const char input[] = "The quick brown fox jumps over the lazy dog";
+    this->write(input, sizeof(input));
+    this->close();
+
+    LZ4F_dctx *dctx;
+    ASSERT_FALSE(LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION)));
+    size_t outLen = S3_ZIP_DECOMPRESS_CHUNKSIZE;
+    size_t inLen = this->mockS3Interface.getDataSize();
+    size_t ret = LZ4F_decompress(dctx, this->out, &outLen, this->mockS3Interface.getRawData(),
+                                 &inLen, NULL);
+    LZ4F_freeDecompressionContext(dctx);
+
+    EXPECT_EQ((size_t)0, ret);
+    EXPECT_EQ(sizeof(input), outLen);
+    EXPECT_STREQ(input, (const char *)this->out);
+}
+#endif
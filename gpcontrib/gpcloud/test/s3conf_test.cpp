@@ -34,6 +34,8 @@ TEST(Config, Basic) {
     EXPECT_EQ("", params.getProxy());
 
     EXPECT_TRUE(params.isAutoCompress());
+    EXPECT_EQ(S3_COMPRESSION_GZIP, params.getAutoCompressType());
+    EXPECT_TRUE(params.isParallelDecompress());
     EXPECT_TRUE(params.isVerifyCert());
 
     EXPECT_EQ(SSE_S3, params.getSSEType());
@@ -73,6 +75,29 @@ TEST(Config, SpecialSwitches) {
 
     EXPECT_TRUE(params.isDebugCurl());
     EXPECT_FALSE(params.isAutoCompress());
+    EXPECT_FALSE(params.isParallelDecompress());
+}
+
+TEST(Config, AutoCompressType) {
+#ifdef GPCLOUD_ZSTD
+    S3Params params = InitConfig("s3://abc/a config=data/s3test.conf section=zstd_compress");
+    EXPECT_EQ(S3_COMPRESSION_ZSTD, params.getAutoCompressType());
+#else
+    // a codec that is not built is refused
+    EXPECT_THROW(InitConfig("s3://abc/a config=data/s3test.conf section=zstd_compress"),
+                 S3ConfigError);
+#endif
+
+#ifdef GPCLOUD_LZ4
+    S3Params lz4Params = InitConfig("s3://abc/a config=data/s3test.conf section=lz4_compress");
+    EXPECT_EQ(S3_COMPRESSION_LZ4, lz4Params.getAutoCompressType());
+#else
+    EXPECT_THROW(InitConfig("s3://abc/a config=data/s3test.conf section=lz4_compress"),
+                 S3ConfigError);
+#endif
+
+    EXPECT_THROW(InitConfig("s3://abc/a config=data/s3test.conf section=wrong_compress"),
+                 S3ConfigError);
 }
 
 TEST(Config, SectionExist) {
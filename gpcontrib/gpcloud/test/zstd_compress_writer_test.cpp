@@ -0,0 +1,126 @@
+#include "zstd_compress_writer.cpp"
+#include <random>
+#include "gtest/gtest.h"
+
+class MockZstdWriter : public Writer {
+   public:
+    virtual void open(const S3Params &params) {
+    }
+
+    virtual uint64_t write(const char *buf, uint64_t count) {
+        this->data.insert(this->data.end(), buf, buf + count);
+        return count;
+    }
+
+    virtual void close() {
+    }
+
+    const char *getRawData() const {
+        return this->data.data();
+    }
+
+    size_t getDataSize() const {
+        return this->data.size();
+    }
+
+   private:
+    vector<char> data;
+};
+
+class ZstdCompressWriterTest : public testing::Test {
+   protected:
+    // Remember that SetUp() is run immediately before a test starts.
+    virtual void SetUp() {
+        zstdWriter.setWriter(&writer);
+        zstdWriter.open(S3Params("s3://abc/def/"));
+    }
+
+    // TearDown() is invoked immediately after a test finishes.
+    virtual void TearDown() {
+        zstdWriter.close();
+    }
+
+    vector<char> uncompress() {
+        unsigned long long len =
+            ZSTD_getFrameContentSize(writer.getRawData(), writer.getDataSize());
+        EXPECT_NE(ZSTD_CONTENTSIZE_ERROR, len);
+
+        // The size is unknown for a streamed frame, so be generous.
+        vector<char> out(S3_ZIP_COMPRESS_CHUNKSIZE * 30);
+        size_t ret =
+            ZSTD_decompress(out.data(), out.size(), writer.getRawData(), writer.getDataSize());
+        EXPECT_FALSE(ZSTD_isError(ret));
+        out.resize(ZSTD_isError(ret) ? 0 : ret);
+        return out;
+    }
+
+    ZstdCompressWriter zstdWriter;
+    MockZstdWriter writer;
+};
+
+TEST_F(ZstdCompressWriterTest, AbleToInputNull) {
+    zstdWriter.write(NULL, 0);
+    EXPECT_EQ((uint64_t)0, writer.getDataSize());
+}
+
+TEST_F(ZstdCompressWriterTest, AbleToCompressEmptyData) {
+    zstdWriter.close();
+
+    EXPECT_EQ((size_t)0, this->uncompress().size());
+}
+
+TEST_F(ZstdCompressWriterTest, AbleToCompressAndCheckZstdHeader) {
+    char input[10] = {0};
+    zstdWriter.write(input, sizeof(input));
+    zstdWriter.close();
+
+    const char *header = writer.getRawData();
+    ASSERT_TRUE(header[0] == char(0x28));
+    ASSERT_TRUE(header[1] == char(0xb5));
+    ASSERT_TRUE(header[2] == char(0x2f));
+    ASSERT_TRUE(header[3] == char(0xfd));
+}
+
+TEST_F(ZstdCompressWriterTest, CloseMultipleTimes) {
+    const char input[] = "The quick brown fox jumps over the lazy dog";
+    zstdWriter.write(input, sizeof(input));
+
+    zstdWriter.close();
+    zstdWriter.close();
+
+    vector<char> out = this->uncompress();
+    ASSERT_EQ(sizeof(input), out.size());
+    EXPECT_STREQ(input, out.data());
+}
+
+TEST_F(ZstdCompressWriterTest, AbleToWriteServeralTimesBeforeClose) {
+    const char pangram[] = "The quick brown fox jumps over the lazy dog\n";
+    for (int i = 0; i < 100; i++) {
+        zstdWriter.write(pangram, sizeof(pangram) - 1);
+    }
+    zstdWriter.close();
+
+    vector<char> out = this->uncompress();
+    ASSERT_EQ((sizeof(pangram) - 1) * 100, out.size());
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQ(0, memcmp(pangram, out.data() + i * (sizeof(pangram) - 1), sizeof(pangram) - 1));
+    }
+}
+
+TEST_F(ZstdCompressWriterTest, CompressIncompressibleDataLargerThanChunkSize) {
+    // random data does not compress, so the output buffer fills up several times.
+    size_t dataLen = S3_ZIP_COMPRESS_CHUNKSIZE * 3 + 17;
+    vector<char> data(dataLen);
+
+    std::mt19937 gen(42);
+    for (size_t i = 0; i < dataLen; i++) {
+        data[i] = (char)gen();
+    }
+
+    zstdWriter.write(data.data(), dataLen);
+    zstdWriter.close();
+
+    vector<char> out = this->uncompress();
+    ASSERT_EQ(dataLen, out.size());
+    EXPECT_TRUE(data == out);
+}
@@ -0,0 +1,200 @@
+#include "zstd_decompress_reader.cpp"
+#include "gtest/gtest.h"
+
+class MockZstdBufferReader : public Reader {
+   public:
+    MockZstdBufferReader() {
+        this->offset = 0;
+        this->chunkSize = 0;
+    }
+
+    void open(const S3Params &params) {
+    }
+    void close() {
+    }
+
+    void setData(const void *input, uint64_t size) {
+        const char *p = static_cast<const char *>(input);
+
+        this->clear();
+        this->data.insert(this->data.end(), p, p + size);
+    }
+
+    void appendData(const void *input, uint64_t size) {
+        const char *p = static_cast<const char *>(input);
+        this->data.insert(this->data.end(), p, p + size);
+    }
+
+    uint64_t read(char *buf, uint64_t count) {
+        uint64_t remaining = this->data.size() - offset;
+        if (remaining <= 0) {
+            return 0;
+        }
+
+        uint64_t size = (remaining > count) ? count : remaining;
+        size = size < this->chunkSize ? size : this->chunkSize;
+        memcpy(buf, this->data.data() + offset, size);
+
+        this->offset += size;
+        return size;
+    }
+
+    void clear() {
+        this->data.clear();
+        this->offset = 0;
+    }
+
+    void setChunkSize(uint64_t size) {
+        this->chunkSize = size;
+    }
+
+   private:
+    std::vector<char> data;
+    uint64_t offset;
+    uint64_t chunkSize;
+};
+
+class ZstdDecompressReaderTest : public testing::Test {
+   protected:
+    // Remember that SetUp() is run immediately before a test starts.
+    virtual void SetUp() {
+        // reset to default, because some tests will modify it
+        S3_ZIP_DECOMPRESS_CHUNKSIZE = S3_ZIP_DEFAULT_CHUNKSIZE;
+
+        // need to setup upstreamReader before open.
+        this->bufReader.setChunkSize(1024 * 1024 * 64);
+        zstdReader.setReader(&bufReader);
+        zstdReader.open(S3Params("s3://abc/def"));
+    }
+
+    // TearDown() is invoked immediately after a test finishes.
+    virtual void TearDown() {
+        zstdReader.close();
+
+        // reset to default, because some tests will modify it
+        S3_ZIP_DECOMPRESS_CHUNKSIZE = S3_ZIP_DEFAULT_CHUNKSIZE;
+    }
+
+    size_t compressData(const void *input, size_t len) {
+        size_t compressedLen =
+            ZSTD_compress(compressionBuff, sizeof(compressionBuff), input, len, 1);
+        EXPECT_FALSE(ZSTD_isError(compressedLen));
+        return compressedLen;
+    }
+
+    void setBufReaderByRawData(const void *input, size_t len) {
+        bufReader.setData(compressionBuff, this->compressData(input, len));
+    }
+
+    uint64_t readAll(char *buf, uint64_t bufLen, uint64_t readSize) {
+        uint64_t offset = 0;
+        uint64_t count;
+        while ((count = zstdReader.read(buf + offset, std::min(readSize, bufLen - offset))) > 0) {
+            offset += count;
+        }
+        return offset;
+    }
+
+    ZstdDecompressReader zstdReader;
+    MockZstdBufferReader bufReader;
+    char compressionBuff[10000];
+};
+
+TEST_F(ZstdDecompressReaderTest, AbleToDecompressEmptyData) {
+    unsigned char input[10] = {0};
+    bufReader.setData(input, 0);
+
+    char buf[10000];
+    uint64_t count = zstdReader.read(buf, sizeof(buf));
+
+    EXPECT_EQ((uint64_t)0, count);
+}
+
+TEST_F(ZstdDecompressReaderTest, AbleToDecompressSmallCompressedData) {
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+    setBufReaderByRawData(hello, sizeof(hello));
+
+    char buf[10000];
+    uint64_t count = zstdReader.read(buf, sizeof(buf));
+
+    EXPECT_EQ(sizeof(hello), count);
+    EXPECT_EQ(0, strncmp(hello, buf, count));
+    EXPECT_EQ((uint64_t)0, zstdReader.read(buf, sizeof(buf)));
+}
+
+TEST_F(ZstdDecompressReaderTest, AbleToDecompressFragmentalCompressedData) {
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+    setBufReaderByRawData(hello, sizeof(hello));
+
+    // one byte at a time, which could not be decompressed by itself.
+    this->bufReader.setChunkSize(1);
+
+    char buf[100];
+    uint64_t count = this->readAll(buf, sizeof(buf), sizeof(buf));
+
+    EXPECT_EQ(sizeof(hello), count);
+    EXPECT_EQ(0, strncmp(hello, buf, count));
+}
+
+TEST_F(ZstdDecompressReaderTest, AbleToDecompressWithSmallBuffers) {
+    // Decompressed data is much larger than the internal buffers, so zstd keeps some of it while
+    // the output buffer is full.
+    S3_ZIP_DECOMPRESS_CHUNKSIZE = 32;
+    zstdReader.resizeDecompressReaderBuffer(S3_ZIP_DECOMPRESS_CHUNKSIZE);
+
+    char input[5000];
+    for (size_t i = 0; i < sizeof(input); i++) {
+        input[i] = 'A' + (i % 7);
+    }
+    setBufReaderByRawData(input, sizeof(input));
+
+    char buf[sizeof(input)];
+    uint64_t count = this->readAll(buf, sizeof(buf), 9);
+
+    EXPECT_EQ(sizeof(input), count);
+    EXPECT_EQ(0, memcmp(input, buf, count));
+}
+
+TEST_F(ZstdDecompressReaderTest, AbleToDecompressConcatenatedFrames) {
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+    const char world[] = "Pack my box with five dozen liquor jugs";
+
+    bufReader.setData(compressionBuff, this->compressData(hello, sizeof(hello) - 1));
+    bufReader.appendData(compressionBuff, this->compressData(world, sizeof(world)));
+
+    char buf[200];
+    uint64_t count = this->readAll(buf, sizeof(buf), sizeof(buf));
+
+    EXPECT_EQ(sizeof(hello) + sizeof(world) - 1, count);
+    EXPECT_STREQ("The quick brown fox jumps over the lazy dogPack my box with five dozen liquor jugs",
+                 buf);
+}
+
+TEST_F(ZstdDecompressReaderTest, SkipAppendedEol) {
+    // S3KeyReader appends eolString to a key that does not end with it.
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+    bufReader.setData(compressionBuff, this->compressData(hello, sizeof(hello)));
+    bufReader.appendData(eolString, strlen(eolString));
+
+    char buf[100];
+    uint64_t count = this->readAll(buf, sizeof(buf), sizeof(buf));
+
+    EXPECT_EQ(sizeof(hello), count);
+    EXPECT_EQ(0, strncmp(hello, buf, count));
+}
+
+TEST_F(ZstdDecompressReaderTest, ThrowOnTruncatedData) {
+    const char hello[] = "The quick brown fox jumps over the lazy dog";
+    bufReader.setData(compressionBuff, this->compressData(hello, sizeof(hello)) - 3);
+
+    char buf[100];
+    EXPECT_THROW(this->readAll(buf, sizeof(buf), sizeof(buf)), S3RuntimeError);
+}
+
+TEST_F(ZstdDecompressReaderTest, ThrowOnCorruptedData) {
+    const char garbage[] = "\x28\xb5\x2f\xfd this is not zstd data";
+    bufReader.setData(garbage, sizeof(garbage));
+
+    char buf[100];
+    EXPECT_THROW(zstdReader.read(buf, sizeof(buf)), S3RuntimeError);
+}
@@ -0,0 +1,263 @@
+/*-------------------------------------------------------------------------
+ *
+ * aocs_batch.c
+ *	  Qual evaluation on column vectors for scans of column tables.
+ *
+ * In batch mode (gp_enable_aocs_batch_scan), aocs_getnext() reads ahead
+ * AOCS_BATCH_SIZE rows at a time into one vector per column, instead of
+ * handing out each row as soon as it is decoded.  The simple "column op
+ * constant" clauses of the scan's qual are then evaluated here, one clause
+ * over a whole vector at a time, in loops without branches or function
+ * calls that the compiler can vectorize.  Only the rows that pass all of
+ * them are stored into a slot and go through ExecQual() for the rest of the
+ * qual.  For selective quals, that saves most of the per-row cost of slot
+ * handling and expression evaluation.
+ *
+ * Only integer and integer-like types (int2, int4, int8, date, and
+ * timestamps) with the btree comparison operators are handled; any other
+ * clause stays in the qual of the scan node.
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ *	  src/backend/access/aocs/aocs_batch.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/aocs_batch.h"
+#include "catalog/pg_am.h"
+#include "catalog/pg_type.h"
+#include "commands/defrem.h"
+#include "nodes/primnodes.h"
+#include "utils/date.h"
+#include "utils/lsyscache.h"
+#include "utils/timestamp.h"
+
+static bool
+is_integer_type(Oid typid)
+{
+	return typid == INT2OID || typid == INT4OID || typid == INT8OID;
+}
+
+/*
+ * The value of a datum of one of the supported types, as int64.
+ */
+static int64
+batch_datum_value(Datum d, Oid typid)
+{
+	switch (typid)
+	{
+		case INT2OID:
+			return DatumGetInt16(d);
+		case INT4OID:
+			return DatumGetInt32(d);
+		case INT8OID:
+			return DatumGetInt64(d);
+		case DATEOID:
+			return DatumGetDateADT(d);
+#ifdef HAVE_INT64_TIMESTAMP
+		case TIMESTAMPOID:
+			return DatumGetTimestamp(d);
+		case TIMESTAMPTZOID:
+			return DatumGetTimestampTz(d);
+#endif
+		default:
+			elog(ERROR, "unexpected type %u in batch qual", typid);
+			return 0;			/* keep compiler quiet */
+	}
+}
+
+/*
+ * Try to turn a qual clause into a batch qual.
+ */
+static bool
+batch_qual_from_clause(TupleDesc tupdesc, Node *clause, Index scanrelid,
+					   AOCSBatchQual *bq)
+{
+	OpExpr	   *op;
+	Node	   *left;
+	Node	   *right;
+	Oid			opno;
+	Var		   *var;
+	Const	   *con;
+	Form_pg_attribute attr;
+	Oid			opclass;
+	Oid			opfamily;
+	int			strategy;
+	Oid			lefttype;
+	Oid			righttype;
+
+	if (!IsA(clause, OpExpr))
+		return false;
+	op = (OpExpr *) clause;
+	if (list_length(op->args) != 2)
+		return false;
+
+	left = linitial(op->args);
+	right = lsecond(op->args);
+	opno = op->opno;
+
+	if (IsA(left, Var) && IsA(right, Const))
+	{
+		var = (Var *) left;
+		con = (Const *) right;
+	}
+	else if (IsA(right, Var) && IsA(left, Const))
+	{
+		var = (Var *) right;
+		con = (Const *) left;
+		opno = get_commutator(opno);
+		if (!OidIsValid(opno))
+			return false;
+	}
+	else
+		return false;
+
+	if (var->varno != scanrelid || var->varlevelsup != 0 ||
+		var->varattno <= 0 || var->varattno > tupdesc->natts)
+		return false;
+	if (con->constisnull)
+		return false;
+
+	attr = tupdesc->attrs[var->varattno - 1];
+	if (attr->attisdropped || !attr->attbyval ||
+		attr->atttypid != var->vartype)
+		return false;
+
+	opclass = GetDefaultOpClass(var->vartype, BTREE_AM_OID);
+	if (!OidIsValid(opclass))
+		return false;
+	opfamily = get_opclass_family(opclass);
+
+	if (!op_in_opfamily(opno, opfamily))
+		return false;
+	get_op_opfamily_properties(opno, opfamily, false,
+							   &strategy, &lefttype, &righttype);
+	if (lefttype != var->vartype)
+		return false;
+
+	/*
+	 * Integers of different widths compare by value.  For the other types,
+	 * cross-type operators involve conversions, and are left alone.
+	 */
+	if (is_integer_type(lefttype))
+	{
+		if (!is_integer_type(righttype))
+			return false;
+	}
+	else if (lefttype != righttype ||
+			 (lefttype != DATEOID
+#ifdef HAVE_INT64_TIMESTAMP
+			  && lefttype != TIMESTAMPOID && lefttype != TIMESTAMPTZOID
+#endif
+			  ))
+		return false;
+
+	/* the constant must be by-value too, for batch_datum_value() */
+	if (con->consttype != righttype || !con->constbyval)
+		return false;
+
+	bq->attno = var->varattno - 1;
+	bq->typlen = attr->attlen;
+	bq->strategy = strategy;
+	bq->value = batch_datum_value(con->constvalue, con->consttype);
+
+	return true;
+}
+
+/*
+ * Collect the clauses of a scan's qual that can be evaluated in batch mode.
+ *
+ * pushed[] must have an entry for each clause of the qual; it is set to
+ * true for the clauses that were collected, which the caller no longer
+ * needs to evaluate.  Returns NULL if there are none.
+ */
+AOCSBatchQual *
+AOCSBatchExtractQuals(TupleDesc tupdesc, List *qual, Index scanrelid,
+					  bool *pushed, int *nquals)
+{
+	AOCSBatchQual *bquals = NULL;
+	ListCell   *lc;
+	int			i = 0;
+
+	*nquals = 0;
+
+	foreach(lc, qual)
+	{
+		AOCSBatchQual bq;
+
+		pushed[i] = false;
+		if (batch_qual_from_clause(tupdesc, lfirst(lc), scanrelid, &bq))
+		{
+			if (bquals == NULL)
+				bquals = palloc(sizeof(AOCSBatchQual) * list_length(qual));
+			bquals[(*nquals)++] = bq;
+			pushed[i] = true;
+		}
+		i++;
+	}
+
+	return bquals;
+}
+
+/*
+ * The comparison loops.  'match' is and-ed with the result of the clause,
+ * NULLs never match.
+ */
+#define BATCH_FILTER_LOOP(get, op) \
+	do { \
+		for (i = 0; i < nrows; i++) \
+			match[i] &= !nulls[i] & ((int64) get(values[i]) op value); \
+	} while (0)
+
+#define BATCH_FILTER_STRATEGY(get) \
+	do { \
+		switch (bq->strategy) \
+		{ \
+			case BTLessStrategyNumber: \
+				BATCH_FILTER_LOOP(get, <); \
+				break; \
+			case BTLessEqualStrategyNumber: \
+				BATCH_FILTER_LOOP(get, <=); \
+				break; \
+			case BTEqualStrategyNumber: \
+				BATCH_FILTER_LOOP(get, ==); \
+				break; \
+			case BTGreaterEqualStrategyNumber: \
+				BATCH_FILTER_LOOP(get, >=); \
+				break; \
+			case BTGreaterStrategyNumber: \
+				BATCH_FILTER_LOOP(get, >); \
+				break; \
+			default: \
+				elog(ERROR, "unexpected strategy %d in batch qual", \
+					 bq->strategy); \
+		} \
+	} while (0)
+
+/*
+ * Evaluate a batch qual on a column vector of 'nrows' rows.
+ */
+void
+AOCSBatchFilter(const AOCSBatchQual *bq, const Datum *values,
+				const bool *nulls, bool *match, int nrows)
+{
+	int64		value = bq->value;
+	int			i;
+
+	switch (bq->typlen)
+	{
+		case 2:
+			BATCH_FILTER_STRATEGY(DatumGetInt16);
+			break;
+		case 4:
+			BATCH_FILTER_STRATEGY(DatumGetInt32);
+			break;
+		case 8:
+			BATCH_FILTER_STRATEGY(DatumGetInt64);
+			break;
+		default:
+			elog(ERROR, "unexpected type length %d in batch qual", bq->typlen);
+	}
+}
@@ -0,0 +1,450 @@
+/*-------------------------------------------------------------------------
+ *
+ * aocs_zonemap.c
+ *	  Block-level min/max summaries of append-only column tables.
+ *
+ * A zone map records the smallest and largest value, and the number of
+ * NULLs, of one column in one varblock.  A scan with a qual like
+ * "col < 10" can skip a varblock of "col" whose smallest value is 10 or
+ * more without decompressing it, and then skip the same rows in all the
+ * other columns it reads.  For tables loaded in roughly sorted order, e.g.
+ * by date, this turns a range predicate on a large fact table into a scan
+ * of just a few blocks.
+ *
+ * The zone maps are not stored on disk.  A scan computes the zone map of
+ * a key column block the first time it reads the block, and publishes it
+ * in a hash table in shared memory, so that later scans of the same block
+ * by any backend can skip the block by looking at its header only.  Only
+ * by-value column types are summarized, so that the min and max values fit
+ * in the shared entry.
+ *
+ * An entry is keyed by the relfilenode, segment file, column, file offset
+ * and first row number of the block.  Blocks are never modified in place,
+ * and row numbers are never reused within a segment file, so an entry
+ * stays valid for as long as the relfilenode exists; it is dropped when the
+ * files of the relation are unlinked or truncated.  If the hash table runs
+ * out of space, it is emptied.
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ *	  src/backend/access/aocs/aocs_zonemap.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/aocs_zonemap.h"
+#include "access/nbtree.h"
+#include "catalog/pg_am.h"
+#include "commands/defrem.h"
+#include "nodes/primnodes.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/hsearch.h"
+#include "utils/lsyscache.h"
+
+/* GUC: size of the shared zone map cache in kB, 0 disables it */
+int			gp_aocs_zonemap_cache_size = 0;
+
+typedef struct AOCSZoneMapKey
+{
+	RelFileNode node;
+	int32		segno;
+	int32		attno;
+	int64		fileOffset;
+	int64		firstRowNum;
+} AOCSZoneMapKey;
+
+typedef struct AOCSZoneMapEntry
+{
+	AOCSZoneMapKey key;			/* hash key, must be first */
+	AOCSZoneMap zonemap;
+} AOCSZoneMapEntry;
+
+typedef struct AOCSZoneMapControl
+{
+	LWLock	   *lock;			/* protects the hash table */
+} AOCSZoneMapControl;
+
+static AOCSZoneMapControl *ZoneMapControl = NULL;
+static HTAB *ZoneMapHash = NULL;
+
+static inline long
+AOCSZoneMapMaxEntries(void)
+{
+	return Max(mul_size(gp_aocs_zonemap_cache_size, 1024L) /
+			   sizeof(AOCSZoneMapEntry), 128);
+}
+
+/*
+ * Calculate shmem size for the zone map cache.
+ */
+Size
+AOCSZoneMapShmemSize(void)
+{
+	if (gp_aocs_zonemap_cache_size <= 0)
+		return 0;
+
+	return add_size(sizeof(AOCSZoneMapControl),
+					hash_estimate_size(AOCSZoneMapMaxEntries(),
+									   sizeof(AOCSZoneMapEntry)));
+}
+
+/*
+ * Initialize the zone map cache.
+ */
+void
+AOCSZoneMapShmemInit(void)
+{
+	HASHCTL		info;
+	long		max_entries;
+	bool		found;
+
+	if (gp_aocs_zonemap_cache_size <= 0)
+		return;
+
+	ZoneMapControl = (AOCSZoneMapControl *)
+		ShmemInitStruct("AOCS zone map cache", sizeof(AOCSZoneMapControl),
+						&found);
+
+	max_entries = AOCSZoneMapMaxEntries();
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(AOCSZoneMapKey);
+	info.entrysize = sizeof(AOCSZoneMapEntry);
+	info.hash = tag_hash;
+
+	ZoneMapHash = ShmemInitHash("AOCS zone map cache hash",
+								max_entries, max_entries,
+								&info,
+								HASH_ELEM | HASH_FUNCTION | HASH_FIXED_SIZE);
+
+	if (!found)
+		ZoneMapControl->lock = LWLockAssign();
+}
+
+bool
+AOCSZoneMapEnabled(void)
+{
+	return ZoneMapControl != NULL;
+}
+
+/*
+ * Try to turn a qual clause into a zone map key.
+ *
+ * Only "column op constant" clauses, or the commuted form, are usable, where
+ * op is a strict btree comparison operator of the default operator class of
+ * the column type.  On success, fills in *key and returns the column number
+ * (starting from 1); otherwise returns InvalidAttrNumber.
+ */
+static AttrNumber
+zonemap_key_from_clause(TupleDesc tupdesc, Node *clause, Index scanrelid,
+						ScanKey key, Oid *opfamily)
+{
+	OpExpr	   *op;
+	Node	   *left;
+	Node	   *right;
+	Oid			opno;
+	Var		   *var;
+	Const	   *con;
+	Form_pg_attribute attr;
+	Oid			opclass;
+	int			strategy;
+	Oid			lefttype;
+	Oid			righttype;
+	Oid			cmpproc;
+
+	if (!IsA(clause, OpExpr))
+		return InvalidAttrNumber;
+	op = (OpExpr *) clause;
+	if (list_length(op->args) != 2)
+		return InvalidAttrNumber;
+
+	left = linitial(op->args);
+	right = lsecond(op->args);
+	opno = op->opno;
+
+	if (IsA(left, Var) && IsA(right, Const))
+	{
+		var = (Var *) left;
+		con = (Const *) right;
+	}
+	else if (IsA(right, Var) && IsA(left, Const))
+	{
+		var = (Var *) right;
+		con = (Const *) left;
+		opno = get_commutator(opno);
+		if (!OidIsValid(opno))
+			return InvalidAttrNumber;
+	}
+	else
+		return InvalidAttrNumber;
+
+	if (var->varno != scanrelid || var->varlevelsup != 0 ||
+		var->varattno <= 0 || var->varattno > tupdesc->natts)
+		return InvalidAttrNumber;
+	if (con->constisnull)
+		return InvalidAttrNumber;
+
+	attr = tupdesc->attrs[var->varattno - 1];
+	if (attr->attisdropped || !attr->attbyval ||
+		attr->atttypid != var->vartype)
+		return InvalidAttrNumber;
+
+	opclass = GetDefaultOpClass(var->vartype, BTREE_AM_OID);
+	if (!OidIsValid(opclass))
+		return InvalidAttrNumber;
+	*opfamily = get_opclass_family(opclass);
+
+	if (!op_in_opfamily(opno, *opfamily) || !op_strict(opno))
+		return InvalidAttrNumber;
+	get_op_opfamily_properties(opno, *opfamily, false,
+							   &strategy, &lefttype, &righttype);
+	if (lefttype != var->vartype)
+		return InvalidAttrNumber;
+
+	cmpproc = get_opfamily_proc(*opfamily, lefttype, righttype, BTORDER_PROC);
+	if (!RegProcedureIsValid(cmpproc))
+		return InvalidAttrNumber;
+
+	ScanKeyEntryInitialize(key, 0, var->varattno, strategy, righttype,
+						   op->inputcollid, cmpproc, con->constvalue);
+
+	return var->varattno;
+}
+
+/*
+ * Collect the zone map keys of a scan from its qual.
+ *
+ * Returns an array of the columns that have keys on them, and their number
+ * in *ncols.  Returns NULL if the qual has no usable clauses.
+ */
+AOCSZoneMapScanColumn *
+AOCSZoneMapExtractKeys(TupleDesc tupdesc, List *qual, Index scanrelid,
+					   int *ncols)
+{
+	AOCSZoneMapScanColumn *cols = NULL;
+	ListCell   *lc;
+
+	*ncols = 0;
+
+	foreach(lc, qual)
+	{
+		ScanKeyData key;
+		Oid			opfamily;
+		AttrNumber	attnum;
+		AOCSZoneMapScanColumn *col = NULL;
+		int			i;
+
+		attnum = zonemap_key_from_clause(tupdesc, lfirst(lc), scanrelid,
+										 &key, &opfamily);
+		if (attnum == InvalidAttrNumber)
+			continue;
+
+		for (i = 0; i < *ncols; i++)
+		{
+			if (cols[i].attno == attnum - 1)
+			{
+				col = &cols[i];
+				break;
+			}
+		}
+
+		if (col == NULL)
+		{
+			Oid			typid = tupdesc->attrs[attnum - 1]->atttypid;
+			Oid			cmpproc;
+
+			cmpproc = get_opfamily_proc(opfamily, typid, typid, BTORDER_PROC);
+			if (!RegProcedureIsValid(cmpproc))
+				continue;
+
+			if (cols == NULL)
+				cols = palloc(sizeof(AOCSZoneMapScanColumn) * tupdesc->natts);
+			col = &cols[(*ncols)++];
+			col->attno = attnum - 1;
+			fmgr_info(cmpproc, &col->cmp);
+			col->collation = key.sk_collation;
+			col->nkeys = 0;
+			col->keys = palloc(sizeof(ScanKeyData) * list_length(qual));
+		}
+
+		col->keys[col->nkeys++] = key;
+	}
+
+	return cols;
+}
+
+static inline void
+zonemap_make_key(AOCSZoneMapKey *key, RelFileNode node, int32 segno,
+				 int32 attno, int64 fileOffset, int64 firstRowNum)
+{
+	/* the key is hashed as a whole, including any padding */
+	MemSet(key, 0, sizeof(*key));
+	key->node = node;
+	key->segno = segno;
+	key->attno = attno;
+	key->fileOffset = fileOffset;
+	key->firstRowNum = firstRowNum;
+}
+
+/*
+ * Look up the zone map of a block.  'rowCount' is the row count from the
+ * block header, as a cross-check.
+ */
+bool
+AOCSZoneMapLookup(RelFileNode node, int32 segno, int32 attno,
+				  int64 fileOffset, int64 firstRowNum, int32 rowCount,
+				  AOCSZoneMap *zonemap)
+{
+	AOCSZoneMapKey key;
+	AOCSZoneMapEntry *entry;
+	bool		found = false;
+
+	Assert(AOCSZoneMapEnabled());
+
+	zonemap_make_key(&key, node, segno, attno, fileOffset, firstRowNum);
+
+	LWLockAcquire(ZoneMapControl->lock, LW_SHARED);
+
+	entry = (AOCSZoneMapEntry *) hash_search(ZoneMapHash, &key,
+											 HASH_FIND, NULL);
+	if (entry != NULL && entry->zonemap.rowCount == rowCount)
+	{
+		*zonemap = entry->zonemap;
+		found = true;
+	}
+
+	LWLockRelease(ZoneMapControl->lock);
+
+	return found;
+}
+
+/*
+ * Remove all entries.  Caller must hold the lock exclusively.
+ */
+static void
+zonemap_reset(void)
+{
+	HASH_SEQ_STATUS status;
+	AOCSZoneMapEntry *entry;
+
+	hash_seq_init(&status, ZoneMapHash);
+	while ((entry = (AOCSZoneMapEntry *) hash_seq_search(&status)) != NULL)
+		hash_search(ZoneMapHash, &entry->key, HASH_REMOVE, NULL);
+}
+
+/*
+ * Publish the zone map of a block.
+ */
+void
+AOCSZoneMapInsert(RelFileNode node, int32 segno, int32 attno,
+				  int64 fileOffset, int64 firstRowNum,
+				  const AOCSZoneMap *zonemap)
+{
+	AOCSZoneMapKey key;
+	AOCSZoneMapEntry *entry;
+
+	Assert(AOCSZoneMapEnabled());
+
+	zonemap_make_key(&key, node, segno, attno, fileOffset, firstRowNum);
+
+	LWLockAcquire(ZoneMapControl->lock, LW_EXCLUSIVE);
+
+	entry = (AOCSZoneMapEntry *) hash_search(ZoneMapHash, &key,
+											 HASH_ENTER_NULL, NULL);
+	if (entry == NULL)
+	{
+		/* hash table is full, start over */
+		zonemap_reset();
+		entry = (AOCSZoneMapEntry *) hash_search(ZoneMapHash, &key,
+												 HASH_ENTER_NULL, NULL);
+	}
+	if (entry != NULL)
+		entry->zonemap = *zonemap;
+
+	LWLockRelease(ZoneMapControl->lock);
+}
+
+/*
+ * Can the keys of the column be true for any row of a block with the given
+ * zone map?  Returns true if the block can be skipped.
+ */
+bool
+AOCSZoneMapExcludes(AOCSZoneMapScanColumn *col, const AOCSZoneMap *zonemap)
+{
+	int			i;
+
+	/* all the operators are strict */
+	if (zonemap->nullCount >= zonemap->rowCount)
+		return true;
+
+	for (i = 0; i < col->nkeys; i++)
+	{
+		ScanKey		key = &col->keys[i];
+		int32		cmpmin;
+		int32		cmpmax;
+
+		cmpmin = DatumGetInt32(FunctionCall2Coll(&key->sk_func,
+												 key->sk_collation,
+												 zonemap->min,
+												 key->sk_argument));
+		cmpmax = DatumGetInt32(FunctionCall2Coll(&key->sk_func,
+												 key->sk_collation,
+												 zonemap->max,
+												 key->sk_argument));
+
+		switch (key->sk_strategy)
+		{
+			case BTLessStrategyNumber:
+				if (cmpmin >= 0)
+					return true;
+				break;
+			case BTLessEqualStrategyNumber:
+				if (cmpmin > 0)
+					return true;
+				break;
+			case BTEqualStrategyNumber:
+				if (cmpmin > 0 || cmpmax < 0)
+					return true;
+				break;
+			case BTGreaterEqualStrategyNumber:
+				if (cmpmax < 0)
+					return true;
+				break;
+			case BTGreaterStrategyNumber:
+				if (cmpmax <= 0)
+					return true;
+				break;
+			default:
+				break;
+		}
+	}
+
+	return false;
+}
+
+/*
+ * Drop the zone maps of all blocks of the given relfilenode.  Called when
+ * its files are unlinked or truncated.
+ */
+void
+AOCSZoneMapInvalidateRelation(RelFileNode node)
+{
+	HASH_SEQ_STATUS status;
+	AOCSZoneMapEntry *entry;
+
+	if (ZoneMapControl == NULL)
+		return;
+
+	LWLockAcquire(ZoneMapControl->lock, LW_EXCLUSIVE);
+
+	hash_seq_init(&status, ZoneMapHash);
+	while ((entry = (AOCSZoneMapEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (RelFileNodeEquals(entry->key.node, node))
+			hash_search(ZoneMapHash, &entry->key, HASH_REMOVE, NULL);
+	}
+
+	LWLockRelease(ZoneMapControl->lock);
+}
@@ -16,6 +16,8 @@
 #include "postgres.h"
 
 #include "common/relpath.h"
+#include "access/aocs_batch.h"
+#include "access/aocs_zonemap.h"
 #include "access/aocssegfiles.h"
 #include "access/aomd.h"
 #include "access/appendonlytid.h"
@@ -40,11 +42,13 @@
 #include "pgstat.h"
 #include "storage/procarray.h"
 #include "storage/smgr.h"
+#include "utils/datum.h"
 #include "utils/datumstream.h"
 #include "utils/faultinjector.h"
 #include "utils/guc.h"
 #include "utils/inval.h"
 #include "utils/lsyscache.h"
+#include "utils/memutils.h"
 #include "utils/relcache.h"
 #include "utils/snapmgr.h"
 #include "utils/syscache.h"
@@ -557,6 +561,13 @@ aocs_rescan(AOCSScanDesc scan)
 {
 	aocs_afterscan(scan);
 	aocs_initscan(scan);
+
+	if (scan->batch)
+	{
+		scan->batch->nsel = 0;
+		scan->batch->next = 0;
+		scan->batch->eof = false;
+	}
 }
 
 void
@@ -590,6 +601,15 @@ aocs_endscan(AOCSScanDesc scan)
 
 	AppendOnlyVisimap_Finish(&scan->visibilityMap, AccessShareLock);
 
+	if (scan->batch)
+		MemoryContextDelete(scan->batch->valuecxt);
+
+	if (Debug_appendonly_print_scan && scan->zonemap_natts > 0)
+		elog(LOG, "AOCS scan of table '%s' skipped " INT64_FORMAT " blocks "
+			 "using zone maps",
+			 RelationGetRelationName(scan->aos_rel),
+			 scan->zonemap_skipped_blocks);
+
 	pfree(scan);
 }
 
@@ -667,23 +687,241 @@ static void upgrade_datum_fetch(AOCSFetchDesc fetch, int attno, Datum values[],
 					   values, isnull, formatversion);
 }
 
-bool
-aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
+/*
+ * Set up zone map filtering of the scan, using the "column op constant"
+ * clauses of the given qual.  The scan may still return rows that the qual
+ * rules out, the caller must evaluate the qual as usual.
+ */
+void
+aocs_set_zonemap_quals(AOCSScanDesc scan, List *qual, Index scanrelid)
+{
+	AOCSZoneMapScanColumn *cols;
+	int			ncols;
+	int			i;
+	int			j;
+
+	if (!AOCSZoneMapEnabled() || qual == NIL)
+		return;
+
+	cols = AOCSZoneMapExtractKeys(scan->relationTupleDesc, qual, scanrelid,
+								  &ncols);
+	if (ncols == 0)
+		return;
+
+	scan->zonemap_atts = palloc(sizeof(int) * ncols);
+	scan->zonemap_cols = palloc0(sizeof(AOCSZoneMapScanColumn *) *
+								 scan->relationTupleDesc->natts);
+
+	/* Only the columns that the scan reads anyway are worth checking */
+	for (i = 0; i < ncols; i++)
+	{
+		for (j = 0; j < scan->num_proj_atts; j++)
+		{
+			if (scan->proj_atts[j] == cols[i].attno)
+			{
+				scan->zonemap_atts[scan->zonemap_natts++] = cols[i].attno;
+				scan->zonemap_cols[cols[i].attno] = &cols[i];
+				break;
+			}
+		}
+	}
+}
+
+/*
+ * Put all the columns of the scan before the first block of the segment
+ * file, with no block read.
+ */
+static void
+aocs_zonemap_reset_columns(AOCSScanDesc scan)
+{
+	int			i;
+
+	for (i = 0; i < scan->num_proj_atts; i++)
+	{
+		DatumStreamRead *ds = scan->ds[scan->proj_atts[i]];
+
+		datumstreamread_reset_block(ds);
+		ds->blockFirstRowNum = 0;
+		ds->blockRowCount = 0;
+	}
+	scan->zonemap_next_row = 0;
+}
+
+/*
+ * Compute the zone map of the current block of a column.
+ */
+static void
+aocs_zonemap_build(DatumStreamRead *ds, AOCSZoneMapScanColumn *col,
+				   AOCSZoneMap *zonemap)
+{
+	bool		first = true;
+
+	zonemap->rowCount = 0;
+	zonemap->nullCount = 0;
+	zonemap->min = (Datum) 0;
+	zonemap->max = (Datum) 0;
+
+	while (datumstreamread_advance(ds))
+	{
+		Datum		d;
+		bool		isnull;
+
+		zonemap->rowCount++;
+
+		datumstreamread_get(ds, &d, &isnull);
+		if (isnull)
+		{
+			zonemap->nullCount++;
+			continue;
+		}
+
+		if (first)
+		{
+			zonemap->min = zonemap->max = d;
+			first = false;
+		}
+		else if (DatumGetInt32(FunctionCall2Coll(&col->cmp, col->collation,
+												 d, zonemap->min)) < 0)
+			zonemap->min = d;
+		else if (DatumGetInt32(FunctionCall2Coll(&col->cmp, col->collation,
+												 d, zonemap->max)) > 0)
+			zonemap->max = d;
+	}
+
+	datumstreamread_rewind_block(ds);
+}
+
+/*
+ * Move a column so that the next datumstreamread_advance() returns the row
+ * *target, or the first row after it.  If the column has zone map keys,
+ * also skip the blocks that the keys rule out, moving *target past them.
+ *
+ * Returns false if there are no such rows left in the segment file.
+ */
+static bool
+aocs_zonemap_position_column(AOCSScanDesc scan, int attno, int64 *target)
+{
+	DatumStreamRead *ds = scan->ds[attno];
+	AOCSZoneMapScanColumn *col = scan->zonemap_cols[attno];
+	int32		segno = scan->seginfo[scan->cur_seg]->segno;
+	AOCSZoneMap zonemap;
+	int64		n;
+
+	while (*target >= ds->blockFirstRowNum + ds->blockRowCount)
+	{
+		bool		known = false;
+
+		if (!datumstreamread_block_header(ds))
+			return false;
+
+		if (ds->blockFirstRowNum + ds->blockRowCount <= *target)
+		{
+			/* All the rows of the block come before the target */
+			datumstreamread_skip_block(ds);
+			continue;
+		}
+
+		if (col != NULL && ds->getBlockInfo.firstRow >= 0)
+		{
+			known = AOCSZoneMapLookup(scan->aos_rel->rd_node, segno, attno,
+									  ds->blockFileOffset,
+									  ds->blockFirstRowNum,
+									  ds->blockRowCount, &zonemap);
+			if (known && AOCSZoneMapExcludes(col, &zonemap))
+			{
+				*target = ds->blockFirstRowNum + ds->blockRowCount;
+				datumstreamread_skip_block(ds);
+				scan->zonemap_skipped_blocks++;
+				SIMPLE_FAULT_INJECTOR("aocs_zonemap_skip_block");
+				continue;
+			}
+		}
+
+		datumstreamread_block_content(ds);
+
+		if (col != NULL && ds->getBlockInfo.firstRow >= 0 && !known)
+		{
+			aocs_zonemap_build(ds, col, &zonemap);
+			AOCSZoneMapInsert(scan->aos_rel->rd_node, segno, attno,
+							  ds->blockFileOffset, ds->blockFirstRowNum,
+							  &zonemap);
+			SIMPLE_FAULT_INJECTOR("aocs_zonemap_build");
+			if (AOCSZoneMapExcludes(col, &zonemap))
+			{
+				*target = ds->blockFirstRowNum + ds->blockRowCount;
+				scan->zonemap_skipped_blocks++;
+				SIMPLE_FAULT_INJECTOR("aocs_zonemap_skip_block");
+			}
+		}
+	}
+
+	/* Row numbers between blocks are not used by any column */
+	if (*target < ds->blockFirstRowNum)
+		*target = ds->blockFirstRowNum;
+
+	n = *target - ds->blockFirstRowNum;
+	if (n > 0)
+		datumstreamread_find(ds, n - 1);
+
+	return true;
+}
+
+/*
+ * Before the next row of the scan is read, skip the rows in the blocks that
+ * the zone maps rule out, in all columns.  Returns false if there are no rows
+ * left in the segment file.
+ */
+static bool
+aocs_zonemap_position(AOCSScanDesc scan)
+{
+	int64		target = scan->zonemap_next_row;
+	int64		prev;
+	int			i;
+
+	/*
+	 * Nothing to do as long as the current blocks of all the key columns
+	 * still have rows; their zone maps were checked when they were read.
+	 */
+	for (i = 0; i < scan->zonemap_natts; i++)
+	{
+		DatumStreamRead *ds = scan->ds[scan->zonemap_atts[i]];
+
+		if (target >= ds->blockFirstRowNum + ds->blockRowCount)
+			break;
+	}
+	if (i == scan->zonemap_natts)
+		return true;
+
+	/*
+	 * Moving a column to the target may move the target further, when the
+	 * column's next block is ruled out.  Repeat until all columns agree.
+	 */
+	do
+	{
+		prev = target;
+		for (i = 0; i < scan->num_proj_atts; i++)
+		{
+			if (!aocs_zonemap_position_column(scan, scan->proj_atts[i],
+											  &target))
+				return false;
+		}
+	} while (target != prev);
+
+	return true;
+}
+
+/*
+ * Read the next visible row of the scan into d[] and null[], indexed by
+ * column number.  Returns false at the end of the scan.
+ */
+static bool
+aocs_readnext(AOCSScanDesc scan, Datum *d, bool *null, AOTupleId *aoTupleId)
 {
-	int			ncol;
-	Datum	   *d = slot_get_values(slot);
-	bool	   *null = slot_get_isnull(slot);
-	AOTupleId	aoTupleId;
 	int64		rowNum = INT64CONST(-1);
 	int			err = 0;
 	int			i;
 	bool		isSnapshotAny = (scan->snapshot == SnapshotAny);
 
-	Assert(ScanDirectionIsForward(direction));
-
-	ncol = slot->tts_tupleDescriptor->natts;
-	Assert(ncol <= scan->relationTupleDesc->natts);
-
 	while (1)
 	{
 		AOCSFileSegInfo *curseginfo;
@@ -703,11 +941,21 @@ ReadNext:
 			if (err < 0)
 			{
 				/* No more seg, we are at the end */
-				ExecClearTuple(slot);
 				scan->cur_seg = -1;
 				return false;
 			}
 			scan->cur_seg_row = 0;
+
+			/*
+			 * Zone maps rely on the row numbers stored in the block headers,
+			 * and can't be used while building the block directory.
+			 */
+			scan->zonemap_active =
+				(scan->zonemap_natts > 0 && scan->blockDirectory == NULL &&
+				 scan->seginfo[scan->cur_seg]->formatversion ==
+				 AORelationVersion_GetLatest());
+			if (scan->zonemap_active)
+				aocs_zonemap_reset_columns(scan);
 		}
 
 		/* We shouldn't have a 0-column projection as we should've bailed out above */
@@ -716,6 +964,15 @@ ReadNext:
 		Assert(scan->cur_seg >= 0);
 		curseginfo = scan->seginfo[scan->cur_seg];
 
+		if (scan->zonemap_active && !aocs_zonemap_position(scan))
+		{
+			/* The zone maps rule out the rest of the segment file */
+			aocs_zonemap_reset_columns(scan);
+			close_cur_scan_seg(scan);
+			err = -1;
+			goto ReadNext;
+		}
+
 		/* Read from cur_seg */
 		for (i = 0; i < scan->num_proj_atts; i++)
 		{
@@ -764,24 +1021,25 @@ ReadNext:
 		}
 
 		scan->cur_seg_row++;
+		if (scan->zonemap_active)
+		{
+			Assert(rowNum != INT64CONST(-1));
+			scan->zonemap_next_row = rowNum + 1;
+		}
 		if (rowNum == INT64CONST(-1))
 		{
-			AOTupleIdInit(&aoTupleId, curseginfo->segno, scan->cur_seg_row);
+			AOTupleIdInit(aoTupleId, curseginfo->segno, scan->cur_seg_row);
 		}
 		else
 		{
-			AOTupleIdInit(&aoTupleId, curseginfo->segno, rowNum);
+			AOTupleIdInit(aoTupleId, curseginfo->segno, rowNum);
 		}
 
-		if (!isSnapshotAny && !AppendOnlyVisimap_IsVisible(&scan->visibilityMap, &aoTupleId))
+		if (!isSnapshotAny && !AppendOnlyVisimap_IsVisible(&scan->visibilityMap, aoTupleId))
 		{
 			rowNum = INT64CONST(-1);
 			goto ReadNext;
 		}
-		scan->cdb_fake_ctid = *((ItemPointer) &aoTupleId);
-
-		TupSetVirtualTupleNValid(slot, ncol);
-		slot_set_ctid(slot, &(scan->cdb_fake_ctid));
 		return true;
 	}
 
@@ -789,6 +1047,209 @@ ReadNext:
 	return false;
 }
 
+/*
+ * Read the next batch of rows, and evaluate the batch quals on it.  Returns
+ * false at the end of the scan.
+ */
+static bool
+aocs_batch_fill(AOCSScanDesc scan)
+{
+	AOCSScanBatch *batch = scan->batch;
+	int			nrows = 0;
+	int			i;
+	int			j;
+
+	batch->nsel = 0;
+	batch->next = 0;
+
+	if (batch->eof)
+		return false;
+
+	/* the by-reference values of the previous batch have been handed out */
+	MemoryContextReset(batch->valuecxt);
+
+	while (nrows < AOCS_BATCH_SIZE)
+	{
+		if (!aocs_readnext(scan, batch->rowvalues, batch->rownulls,
+						   &batch->tids[nrows]))
+		{
+			batch->eof = true;
+			break;
+		}
+
+		for (i = 0; i < scan->num_proj_atts; i++)
+		{
+			int			attno = scan->proj_atts[i];
+
+			batch->values[attno][nrows] = batch->rowvalues[attno];
+			batch->nulls[attno][nrows] = batch->rownulls[attno];
+		}
+
+		/*
+		 * By-reference values point into the block buffer of their column,
+		 * or into the buffer of upgraded values.  Reading the next rows may
+		 * load the next block, skipping invisible rows or blocks ruled out
+		 * by zone maps, or close the segment file, so keep a copy.
+		 */
+		if (batch->nbyref_atts > 0)
+		{
+			MemoryContext oldcxt = MemoryContextSwitchTo(batch->valuecxt);
+
+			for (i = 0; i < batch->nbyref_atts; i++)
+			{
+				int			attno = batch->byref_atts[i];
+
+				if (!batch->nulls[attno][nrows])
+					batch->values[attno][nrows] =
+						datumCopy(batch->values[attno][nrows], false,
+								  scan->relationTupleDesc->attrs[attno]->attlen);
+			}
+			MemoryContextSwitchTo(oldcxt);
+		}
+		nrows++;
+	}
+
+	if (nrows == 0)
+		return false;
+
+	memset(batch->match, true, sizeof(bool) * nrows);
+	for (i = 0; i < batch->nquals; i++)
+	{
+		AOCSBatchQual *bq = &batch->quals[i];
+
+		AOCSBatchFilter(bq, batch->values[bq->attno], batch->nulls[bq->attno],
+						batch->match, nrows);
+	}
+
+	for (j = 0; j < nrows; j++)
+	{
+		if (batch->match[j])
+			batch->sel[batch->nsel++] = j;
+	}
+
+	batch->nbatches++;
+	batch->nrows += nrows;
+	batch->nremoved += nrows - batch->nsel;
+
+	return true;
+}
+
+/*
+ * Set up batch mode for the scan.  See aocs_batch.c.
+ *
+ * pushed[] must have an entry for each clause of 'qual'.  It is set to true
+ * for the clauses that the scan evaluates itself from now on, which the
+ * caller no longer needs to evaluate.  Returns false, and leaves the scan
+ * in row mode, if there are no such clauses.
+ */
+bool
+aocs_set_batch_quals(AOCSScanDesc scan, List *qual, Index scanrelid,
+					 bool *pushed)
+{
+	AOCSScanBatch *batch;
+	AOCSBatchQual *quals;
+	int			nquals;
+	int			nvp = scan->relationTupleDesc->natts;
+	int			i;
+
+	quals = AOCSBatchExtractQuals(scan->relationTupleDesc, qual, scanrelid,
+								  pushed, &nquals);
+
+	if (nquals == 0)
+		return false;
+
+	/* The scan reads the columns of its qual, but better safe than sorry */
+	for (i = 0; i < nquals; i++)
+	{
+		if (!scan->ds[quals[i].attno])
+		{
+			memset(pushed, 0, sizeof(bool) * list_length(qual));
+			return false;
+		}
+	}
+
+	batch = palloc0(sizeof(AOCSScanBatch));
+	batch->nquals = nquals;
+	batch->quals = quals;
+	batch->values = palloc0(sizeof(Datum *) * nvp);
+	batch->nulls = palloc0(sizeof(bool *) * nvp);
+	batch->byref_atts = palloc(sizeof(int) * scan->num_proj_atts);
+	for (i = 0; i < scan->num_proj_atts; i++)
+	{
+		int			attno = scan->proj_atts[i];
+
+		batch->values[attno] = palloc(sizeof(Datum) * AOCS_BATCH_SIZE);
+		batch->nulls[attno] = palloc(sizeof(bool) * AOCS_BATCH_SIZE);
+		if (!scan->relationTupleDesc->attrs[attno]->attbyval)
+			batch->byref_atts[batch->nbyref_atts++] = attno;
+	}
+	batch->rowvalues = palloc(sizeof(Datum) * nvp);
+	batch->rownulls = palloc(sizeof(bool) * nvp);
+	batch->tids = palloc(sizeof(AOTupleId) * AOCS_BATCH_SIZE);
+	batch->match = palloc(sizeof(bool) * AOCS_BATCH_SIZE);
+	batch->sel = palloc(sizeof(int) * AOCS_BATCH_SIZE);
+	batch->valuecxt = AllocSetContextCreate(CurrentMemoryContext,
+											"AOCS batch values",
+											ALLOCSET_DEFAULT_MINSIZE,
+											ALLOCSET_DEFAULT_INITSIZE,
+											ALLOCSET_DEFAULT_MAXSIZE);
+
+	scan->batch = batch;
+
+	return true;
+}
+
+bool
+aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot)
+{
+	int			ncol;
+	Datum	   *d = slot_get_values(slot);
+	bool	   *null = slot_get_isnull(slot);
+	AOTupleId	aoTupleId;
+
+	Assert(ScanDirectionIsForward(direction));
+
+	ncol = slot->tts_tupleDescriptor->natts;
+	Assert(ncol <= scan->relationTupleDesc->natts);
+
+	if (scan->batch)
+	{
+		AOCSScanBatch *batch = scan->batch;
+		int			row;
+		int			i;
+
+		while (batch->next >= batch->nsel)
+		{
+			if (!aocs_batch_fill(scan))
+			{
+				ExecClearTuple(slot);
+				return false;
+			}
+		}
+
+		row = batch->sel[batch->next++];
+		for (i = 0; i < scan->num_proj_atts; i++)
+		{
+			int			attno = scan->proj_atts[i];
+
+			d[attno] = batch->values[attno][row];
+			null[attno] = batch->nulls[attno][row];
+		}
+		aoTupleId = batch->tids[row];
+	}
+	else if (!aocs_readnext(scan, d, null, &aoTupleId))
+	{
+		ExecClearTuple(slot);
+		return false;
+	}
+
+	scan->cdb_fake_ctid = *((ItemPointer) &aoTupleId);
+
+	TupSetVirtualTupleNValid(slot, ncol);
+	slot_set_ctid(slot, &(scan->cdb_fake_ctid));
+	return true;
+}
+
 
 /* Open next file segment for write.  See SetCurrentFileSegForWrite */
 /* XXX Right now, we put each column to different files */
@@ -28,6 +28,7 @@
 #include <sys/file.h>
 #include <access/aomd.h>
 
+#include "access/aocs_zonemap.h"
 #include "access/aomd.h"
 #include "access/appendonlytid.h"
 #include "access/appendonlywriter.h"
@@ -192,6 +193,10 @@ TruncateAOSegmentFile(File fd, Relation rel, int32 segFileNum, int64 offset)
 	if (XLogIsNeeded() && RelationNeedsWAL(rel))
 		xlog_ao_truncate(rel->rd_node, segFileNum, offset);
 
+	/* The truncated blocks may be written again with different contents */
+	if (RelationIsAoCols(rel))
+		AOCSZoneMapInvalidateRelation(rel->rd_node);
+
 	if (file_truncate_hook)
 	{
 		RelFileNodeBackend rnode;
@@ -83,6 +83,7 @@
 #include "storage/smgr.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
+#include "utils/cardfeedback.h"
 #include "utils/fmgroids.h"
 #include "utils/inval.h"
 #include "utils/lsyscache.h"
@@ -2467,6 +2468,11 @@ heap_drop_with_catalog(Oid relid)
 	 */
 	RemoveStatistics(relid, 0);
 
+	/*
+	 * forget the cardinality feedback on the relation, the oid may be reused
+	 */
+	CardinalityFeedbackForgetRelation(relid);
+
 	/*
 	 * delete attribute tuples
 	 */
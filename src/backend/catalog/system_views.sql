@@ -682,6 +682,12 @@ CREATE VIEW gp_stat_replication AS
          ON G.gp_segment_id = R.gp_segment_id
     );
 
+CREATE VIEW gp_optimizer_plan_cache AS
+    SELECT * FROM pg_catalog.gp_optimizer_plan_cache_stats();
+
+CREATE VIEW gp_optimizer_cardinality_feedback AS
+    SELECT * FROM pg_catalog.gp_optimizer_cardinality_feedback();
+
 CREATE VIEW pg_replication_slots AS
     SELECT
             L.slot_name,
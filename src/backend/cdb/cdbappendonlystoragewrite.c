@@ -35,6 +35,16 @@
 #include "utils/faultinjector.h"
 #include "utils/guc.h"
 
+static void AppendOnlyStorageWrite_FinishCompressedBlock(AppendOnlyStorageWrite *storageWrite,
+											 uint8 *header,
+											 uint8 *sourceData,
+											 int32 sourceLen,
+											 int executorBlockKind,
+											 int itemCount,
+											 int32 *compressedLen,
+											 int32 *bufferLen);
+static void AppendOnlyStorageWrite_FinishCompression(AppendOnlyStorageWrite *storageWrite);
+
 
 /*----------------------------------------------------------------
  * Initialization
@@ -168,6 +178,15 @@ AppendOnlyStorageWrite_Init(AppendOnlyStorageWrite *storageWrite,
 		Assert(storageWrite->verifyWriteBuffer == NULL);
 	}
 
+	/*
+	 * Compress the blocks in the compression thread pool if configured.  Not
+	 * when they are verified, as that needs the compression state.
+	 */
+	if (storageWrite->storageAttributes.compress &&
+		!gp_appendonly_verify_write_block)
+		storageWrite->compressPoolMethod =
+			CompressPool_GetMethod(storageWrite->storageAttributes.compressType);
+
 	storageWrite->file = -1;
 	storageWrite->formatVersion = -1;
 	storageWrite->needsWAL = needsWAL;
@@ -188,6 +207,17 @@ AppendOnlyStorageWrite_FinishSession(AppendOnlyStorageWrite *storageWrite)
 	if (!storageWrite->isActive)
 		return;
 
+	/*
+	 * A block still being compressed was never flushed, so the file is not
+	 * going to be written anymore.  Just give the job back.
+	 */
+	if (storageWrite->compressJob != NULL)
+	{
+		CompressPool_Wait(storageWrite->compressJob);
+		CompressPool_Release(storageWrite->compressJob);
+		storageWrite->compressJob = NULL;
+	}
+
 	oldMemoryContext = MemoryContextSwitchTo(storageWrite->memoryContext);
 
 	/*
@@ -482,6 +512,8 @@ AppendOnlyStorageWrite_FlushAndCloseFile(
 		return;
 	}
 
+	AppendOnlyStorageWrite_FinishCompression(storageWrite);
+
 	/*
 	 * We pad out append commands to the page boundary.
 	 */
@@ -758,6 +790,8 @@ AppendOnlyStorageWrite_GetBuffer(AppendOnlyStorageWrite *storageWrite,
 		   aoHeaderKind == AoHeaderKind_NonBulkDenseContent ||
 		   aoHeaderKind == AoHeaderKind_BulkDenseContent);
 
+	AppendOnlyStorageWrite_FinishCompression(storageWrite);
+
 	storageWrite->getBufferAoHeaderKind = aoHeaderKind;
 
 	/*
@@ -790,6 +824,10 @@ AppendOnlyStorageWrite_GetBuffer(AppendOnlyStorageWrite *storageWrite,
 
 /*
  * Test if a buffer is currently allocated.
+ *
+ * A block handed to the compression thread pool is done with, as far as the
+ * caller is concerned, although its header is still set up until
+ * AppendOnlyStorageWrite_FinishCompression() is called.
  */
 bool
 AppendOnlyStorageWrite_IsBufferAllocated(AppendOnlyStorageWrite *storageWrite)
@@ -797,6 +835,9 @@ AppendOnlyStorageWrite_IsBufferAllocated(AppendOnlyStorageWrite *storageWrite)
 	Assert(storageWrite != NULL);
 	Assert(storageWrite->isActive);
 
+	if (storageWrite->compressJob != NULL)
+		return false;
+
 	return (storageWrite->currentCompleteHeaderLen > 0);
 }
 
@@ -818,6 +859,8 @@ AppendOnlyStorageWrite_CurrentPosition(AppendOnlyStorageWrite *storageWrite)
 	Assert(storageWrite != NULL);
 	Assert(storageWrite->isActive);
 
+	AppendOnlyStorageWrite_FinishCompression(storageWrite);
+
 	return BufferedAppendCurrentBufferPosition(
 											   &storageWrite->bufferedAppend);
 }
@@ -832,6 +875,8 @@ AppendOnlyStorageWrite_GetCurrentInternalBuffer(AppendOnlyStorageWrite *storageW
 	Assert(storageWrite != NULL);
 	Assert(storageWrite->isActive);
 
+	AppendOnlyStorageWrite_FinishCompression(storageWrite);
+
 	return BufferedAppendGetCurrentBuffer(&storageWrite->bufferedAppend);
 }
 
@@ -1181,6 +1226,34 @@ AppendOnlyStorageWrite_CompressAppend(AppendOnlyStorageWrite *storageWrite,
 					compressor,
 					storageWrite->compressionState);
 
+	AppendOnlyStorageWrite_FinishCompressedBlock(storageWrite,
+												 header,
+												 sourceData,
+												 sourceLen,
+												 executorBlockKind,
+												 itemCount,
+												 compressedLen,
+												 bufferLen);
+}
+
+/*
+ * Make the header of a block compressed into the BufferedAppend buffer.
+ *
+ * If the data did not compress, it is stored uncompressed instead, and
+ * *compressedLen is set to 0.  *bufferLen is set to the length of the block.
+ */
+static void
+AppendOnlyStorageWrite_FinishCompressedBlock(AppendOnlyStorageWrite *storageWrite,
+											 uint8 *header,
+											 uint8 *sourceData,
+											 int32 sourceLen,
+											 int executorBlockKind,
+											 int itemCount,
+											 int32 *compressedLen,
+											 int32 *bufferLen)
+{
+	uint8	   *dataBuffer = &header[storageWrite->currentCompleteHeaderLen];
+
 #ifdef FAULT_INJECTOR
 	/* Simulate that compression is not possible if the fault is set. */
 	if (FaultInjector_InjectFaultIfSet(
@@ -1431,6 +1504,29 @@ AppendOnlyStorageWrite_FinishBuffer(AppendOnlyStorageWrite *storageWrite,
 	{
 		int32		compressedLen = 0;
 
+		/*
+		 * Hand the block to the compression thread pool if we can.  It is
+		 * finished by AppendOnlyStorageWrite_FinishCompression() when the
+		 * next block is started, or the file is flushed.  Meanwhile, the
+		 * executor can fill the blocks of the other columns.
+		 */
+		if (storageWrite->compressPoolMethod != CompressPoolMethod_None)
+			storageWrite->compressJob =
+				CompressPool_Submit(storageWrite->compressPoolMethod,
+									storageWrite->storageAttributes.compressLevel,
+									storageWrite->uncompressedBuffer,
+									contentLen,
+									storageWrite->maxBufferWithCompressionOverrrunLen -
+									storageWrite->currentCompleteHeaderLen);
+
+		if (storageWrite->compressJob != NULL)
+		{
+			storageWrite->compressJobExecutorBlockKind = executorBlockKind;
+			storageWrite->compressJobRowCount = rowCount;
+			storageWrite->currentBuffer = NULL;
+			return;
+		}
+
 		AppendOnlyStorageWrite_CompressAppend(storageWrite,
 											  storageWrite->uncompressedBuffer,
 											  contentLen,
@@ -1470,6 +1566,69 @@ AppendOnlyStorageWrite_FinishBuffer(AppendOnlyStorageWrite *storageWrite,
 	storageWrite->isFirstRowNumSet = false;
 }
 
+/*
+ * Finish the block that the compression thread pool compressed, if any.
+ *
+ * This copies the result to the BufferedAppend buffer, and does the rest of
+ * what AppendOnlyStorageWrite_FinishBuffer does for a block it compresses
+ * itself.
+ */
+static void
+AppendOnlyStorageWrite_FinishCompression(AppendOnlyStorageWrite *storageWrite)
+{
+	CompressPoolJob *job = storageWrite->compressJob;
+	uint8	   *header;
+	int32		contentLen;
+	int32		compressedLen;
+	int32		bufferLen;
+
+	if (job == NULL)
+		return;
+	storageWrite->compressJob = NULL;
+
+	CompressPool_Wait(job);
+
+	if (job->error != NULL)
+	{
+		const char *error = job->error;
+
+		CompressPool_Release(job);
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("could not compress append-only block: %s", error),
+				 errcontext_appendonly_write_storage_block(storageWrite)));
+	}
+
+	header = BufferedAppendGetMaxBuffer(&storageWrite->bufferedAppend);
+	Assert(header != NULL);
+
+	contentLen = job->srcLen;
+	compressedLen = job->compressedLen;
+	if (compressedLen < contentLen)
+		memcpy(&header[storageWrite->currentCompleteHeaderLen], job->dst,
+			   compressedLen);
+
+	AppendOnlyStorageWrite_FinishCompressedBlock(storageWrite,
+												 header,
+												 job->src,
+												 contentLen,
+												 storageWrite->compressJobExecutorBlockKind,
+												 storageWrite->compressJobRowCount,
+												 &compressedLen,
+												 &bufferLen);
+	CompressPool_Release(job);
+
+	BufferedAppendFinishBuffer(&storageWrite->bufferedAppend,
+							   bufferLen,
+							   (storageWrite->currentCompleteHeaderLen +
+								AOStorage_RoundUp(contentLen, storageWrite->formatVersion) /* non-compressed size */ ),
+							   storageWrite->needsWAL);
+
+	/* Declare it finished. */
+	storageWrite->currentCompleteHeaderLen = 0;
+	storageWrite->isFirstRowNumSet = false;
+}
+
 /*
  * Cancel the last ~GetBuffer call.
  *
@@ -1545,6 +1704,8 @@ AppendOnlyStorageWrite_Content(AppendOnlyStorageWrite *storageWrite,
 	Assert(storageWrite != NULL);
 	Assert(storageWrite->isActive);
 
+	AppendOnlyStorageWrite_FinishCompression(storageWrite);
+
 	completeHeaderLen =
 		AppendOnlyStorageWrite_CompleteHeaderLen(storageWrite,
 												 AoHeaderKind_SmallContent);
@@ -1780,6 +1941,9 @@ AppendOnlyStorageWrite_SetFirstRowNum(AppendOnlyStorageWrite *storageWrite,
 
 	/* UNDONE: Range check firstRowNum */
 
+	/* The header of a block still being compressed needs the old values. */
+	AppendOnlyStorageWrite_FinishCompression(storageWrite);
+
 	storageWrite->isFirstRowNumSet = true;
 	storageWrite->firstRowNum = firstRowNum;
 }
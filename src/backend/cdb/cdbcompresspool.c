@@ -0,0 +1,416 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbcompresspool.c
+ *	  A pool of threads that compress the blocks of append-only tables.
+ *
+ * With gp_appendonly_compress_threads set, AppendOnlyStorageWrite hands each
+ * full zlib or zstd block to this pool instead of compressing it itself, and
+ * picks up the result only when it starts its next block.  Meanwhile the
+ * executor keeps filling the blocks of the other columns of a column table,
+ * so up to one block per column compresses in parallel.
+ *
+ * The threads call the compression libraries directly, never fmgr.  They
+ * also never touch memory that the backend manages: a job carries a copy of
+ * the data to compress and its own output buffer, both malloc'ed and
+ * recycled by the pool.  A job that is still running when its transaction
+ * aborts thus does no harm; it is marked abandoned at the end of the
+ * transaction, and freed by the thread once it is done.
+ *
+ * NOTE: The code run by the threads MUST NOT contain elog or ereport
+ * statements, nor use palloc.
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ * IDENTIFICATION
+ *	    src/backend/cdb/cdbcompresspool.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <pthread.h>
+#include <signal.h>
+
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#include <zstd_errors.h>
+#endif
+
+#include "access/xact.h"
+#include "cdb/cdbcompresspool.h"
+
+/* GUC */
+int			gp_appendonly_compress_threads = 0;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Signalled when a job is queued, and when one is done. */
+static pthread_cond_t pool_queued_cv = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done_cv = PTHREAD_COND_INITIALIZER;
+
+/* The jobs waiting for a thread, in submission order. */
+static CompressPoolJob *queue_head = NULL;
+static CompressPoolJob *queue_tail = NULL;
+
+/* All the jobs that are allocated, linked by allNext. */
+static CompressPoolJob *all_jobs = NULL;
+
+static int	pool_nthreads = 0;
+static bool pool_callback_registered = false;
+
+static void *compressPoolThreadMain(void *arg);
+static void compressPoolCompress(CompressPoolJob *job, void *zstdContext);
+static bool compressPoolStartThreads(void);
+static CompressPoolJob *compressPoolGetJob(int32 srcLen, int32 dstLen);
+static void compressPoolUnlinkAndFree(CompressPoolJob *job);
+static void compressPoolXactCallback(XactEvent event, void *arg);
+
+/*
+ * The library to compress with for a compresstype, or
+ * CompressPoolMethod_None if the blocks must be compressed the usual way.
+ */
+CompressPoolMethod
+CompressPool_GetMethod(char *compressType)
+{
+	if (gp_appendonly_compress_threads <= 0 || compressType == NULL)
+		return CompressPoolMethod_None;
+
+#ifdef HAVE_LIBZ
+	if (pg_strcasecmp(compressType, "zlib") == 0)
+		return CompressPoolMethod_Zlib;
+#endif
+#ifdef HAVE_LIBZSTD
+	if (pg_strcasecmp(compressType, "zstd") == 0)
+		return CompressPoolMethod_Zstd;
+#endif
+
+	return CompressPoolMethod_None;
+}
+
+/*
+ * Queue srcLen bytes at src for compression into at most dstLen bytes.
+ *
+ * The data is copied, so src may be reused as soon as this returns.
+ * Returns NULL if the pool cannot take the job, in which case the caller
+ * compresses the block itself.
+ */
+CompressPoolJob *
+CompressPool_Submit(CompressPoolMethod method, int level,
+					uint8 *src, int32 srcLen, int32 dstLen)
+{
+	CompressPoolJob *job;
+
+	Assert(method != CompressPoolMethod_None);
+
+	if (!pool_callback_registered)
+	{
+		RegisterXactCallback(compressPoolXactCallback, NULL);
+		pool_callback_registered = true;
+	}
+
+	if (!compressPoolStartThreads())
+		return NULL;
+
+	pthread_mutex_lock(&pool_lock);
+	job = compressPoolGetJob(srcLen, dstLen);
+	pthread_mutex_unlock(&pool_lock);
+
+	if (job == NULL)
+		return NULL;
+
+	/* Like the constructors of pg_compression, level 0 means 1. */
+	job->method = method;
+	job->level = (level == 0) ? 1 : level;
+	memcpy(job->src, src, srcLen);
+	job->srcLen = srcLen;
+	job->dstLen = dstLen;
+	job->compressedLen = 0;
+	job->error = NULL;
+
+	pthread_mutex_lock(&pool_lock);
+	job->state = CompressPoolJob_Queued;
+	job->next = NULL;
+	if (queue_tail)
+		queue_tail->next = job;
+	else
+		queue_head = job;
+	queue_tail = job;
+	pthread_cond_signal(&pool_queued_cv);
+	pthread_mutex_unlock(&pool_lock);
+
+	return job;
+}
+
+/*
+ * Wait for a job to be done.
+ */
+void
+CompressPool_Wait(CompressPoolJob *job)
+{
+	pthread_mutex_lock(&pool_lock);
+	while (job->state != CompressPoolJob_Done)
+		pthread_cond_wait(&pool_done_cv, &pool_lock);
+	pthread_mutex_unlock(&pool_lock);
+}
+
+/*
+ * Give a job, which must be done, back to the pool for reuse.
+ */
+void
+CompressPool_Release(CompressPoolJob *job)
+{
+	Assert(job->state == CompressPoolJob_Done);
+
+	pthread_mutex_lock(&pool_lock);
+	job->state = CompressPoolJob_Free;
+	pthread_mutex_unlock(&pool_lock);
+}
+
+/*
+ * Start threads until there are gp_appendonly_compress_threads of them.
+ * Returns false if there are none.
+ *
+ * The threads block all signals, so that the signal handlers of the backend
+ * only ever run in the main thread.
+ */
+static bool
+compressPoolStartThreads(void)
+{
+	int			target = Min(gp_appendonly_compress_threads, COMPRESS_POOL_MAX_THREADS);
+	pthread_attr_t t_atts;
+	sigset_t	sigs;
+	sigset_t	old_sigs;
+
+	if (pool_nthreads >= target)
+		return pool_nthreads > 0;
+
+	pthread_attr_init(&t_atts);
+	pthread_attr_setdetachstate(&t_atts, PTHREAD_CREATE_DETACHED);
+	pthread_attr_setstacksize(&t_atts, Max(PTHREAD_STACK_MIN, (256 * 1024)));
+
+	sigfillset(&sigs);
+	pthread_sigmask(SIG_BLOCK, &sigs, &old_sigs);
+
+	while (pool_nthreads < target)
+	{
+		pthread_t	thread;
+		int			err;
+
+		err = pthread_create(&thread, &t_atts, compressPoolThreadMain, NULL);
+		if (err != 0)
+		{
+			elog(LOG, "could not create append-only compression thread: error code %d",
+				 err);
+			break;
+		}
+		pool_nthreads++;
+	}
+
+	pthread_sigmask(SIG_SETMASK, &old_sigs, NULL);
+	pthread_attr_destroy(&t_atts);
+
+	return pool_nthreads > 0;
+}
+
+/*
+ * Get a free job with buffers of at least the given sizes, or allocate a
+ * new one.  Returns NULL if out of memory.
+ *
+ * SHOULD BE CALLED WITH pool_lock *LOCKED*
+ */
+static CompressPoolJob *
+compressPoolGetJob(int32 srcLen, int32 dstLen)
+{
+	CompressPoolJob *job;
+
+	for (job = all_jobs; job != NULL; job = job->allNext)
+	{
+		if (job->state == CompressPoolJob_Free &&
+			job->srcSize >= srcLen && job->dstSize >= dstLen)
+		{
+			job->state = CompressPoolJob_Queued;
+			job->abandoned = false;
+			return job;
+		}
+	}
+
+	job = calloc(1, sizeof(CompressPoolJob));
+	if (job == NULL)
+		return NULL;
+	job->src = malloc(srcLen);
+	job->dst = malloc(dstLen);
+	if (job->src == NULL || job->dst == NULL)
+	{
+		free(job->src);
+		free(job->dst);
+		free(job);
+		return NULL;
+	}
+	job->srcSize = srcLen;
+	job->dstSize = dstLen;
+	job->state = CompressPoolJob_Queued;
+
+	job->allNext = all_jobs;
+	all_jobs = job;
+
+	return job;
+}
+
+/*
+ * Remove a job from the list of all jobs, and free it.
+ *
+ * SHOULD BE CALLED WITH pool_lock *LOCKED*
+ */
+static void
+compressPoolUnlinkAndFree(CompressPoolJob *job)
+{
+	CompressPoolJob **link;
+
+	for (link = &all_jobs; *link != NULL; link = &(*link)->allNext)
+	{
+		if (*link == job)
+		{
+			*link = job->allNext;
+			break;
+		}
+	}
+
+	free(job->src);
+	free(job->dst);
+	free(job);
+}
+
+/*
+ * At the end of a transaction, free the jobs nobody uses, and abandon the
+ * ones that are still queued or running; their threads free them.  Any job
+ * that was not released by now belongs to a write that was aborted.
+ *
+ * This also gives back the memory of the recycled jobs after a load.
+ */
+static void
+compressPoolXactCallback(XactEvent event, void *arg)
+{
+	CompressPoolJob *job;
+	CompressPoolJob *next;
+
+	if (event != XACT_EVENT_COMMIT && event != XACT_EVENT_ABORT &&
+		event != XACT_EVENT_PREPARE)
+		return;
+
+	pthread_mutex_lock(&pool_lock);
+	for (job = all_jobs; job != NULL; job = next)
+	{
+		next = job->allNext;
+
+		if (job->state == CompressPoolJob_Free ||
+			job->state == CompressPoolJob_Done)
+			compressPoolUnlinkAndFree(job);
+		else
+			job->abandoned = true;
+	}
+	pthread_mutex_unlock(&pool_lock);
+}
+
+/*
+ * The main loop of a compression thread.
+ */
+static void *
+compressPoolThreadMain(void *arg)
+{
+	void	   *zstdContext = NULL;
+
+#ifdef HAVE_LIBZSTD
+	/* Each thread keeps one compression context for all its jobs. */
+	zstdContext = ZSTD_createCCtx();
+#endif
+
+	for (;;)
+	{
+		CompressPoolJob *job;
+
+		pthread_mutex_lock(&pool_lock);
+		while (queue_head == NULL)
+			pthread_cond_wait(&pool_queued_cv, &pool_lock);
+
+		job = queue_head;
+		queue_head = job->next;
+		if (queue_head == NULL)
+			queue_tail = NULL;
+		job->state = CompressPoolJob_Running;
+		pthread_mutex_unlock(&pool_lock);
+
+		compressPoolCompress(job, zstdContext);
+
+		pthread_mutex_lock(&pool_lock);
+		job->state = CompressPoolJob_Done;
+		if (job->abandoned)
+			compressPoolUnlinkAndFree(job);
+		pthread_cond_broadcast(&pool_done_cv);
+		pthread_mutex_unlock(&pool_lock);
+	}
+
+	return NULL;
+}
+
+/*
+ * Compress the data of a job, the same way the compression functions of
+ * pg_compression do.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ */
+static void
+compressPoolCompress(CompressPoolJob *job, void *zstdContext)
+{
+	switch (job->method)
+	{
+#ifdef HAVE_LIBZ
+		case CompressPoolMethod_Zlib:
+			{
+				unsigned long dst_used = job->dstLen;
+				int			rc;
+
+				rc = compress2(job->dst, &dst_used, job->src, job->srcLen,
+							   job->level);
+				if (rc == Z_OK)
+					job->compressedLen = (int32) dst_used;
+				else if (rc == Z_BUF_ERROR)
+					job->compressedLen = job->srcLen;	/* did not compress */
+				else if (rc == Z_MEM_ERROR)
+					job->error = "out of memory";
+				else
+					job->error = "zlib compression failed";
+				break;
+			}
+#endif
+#ifdef HAVE_LIBZSTD
+		case CompressPoolMethod_Zstd:
+			{
+				size_t		dst_used;
+
+				if (zstdContext == NULL)
+				{
+					job->error = "out of memory";
+					break;
+				}
+
+				dst_used = ZSTD_compressCCtx((ZSTD_CCtx *) zstdContext,
+											 job->dst, job->dstLen,
+											 job->src, job->srcLen,
+											 job->level);
+				if (!ZSTD_isError(dst_used))
+					job->compressedLen = (int32) dst_used;
+				else if (ZSTD_getErrorCode(dst_used) == ZSTD_error_dstSize_tooSmall)
+					job->compressedLen = job->srcLen;	/* did not compress */
+				else
+					job->error = ZSTD_getErrorName(dst_used);
+				break;
+			}
+#endif
+		default:
+			job->error = "unexpected compression method";
+			break;
+	}
+}
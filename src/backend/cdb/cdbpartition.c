@@ -19,6 +19,7 @@
 
 #include "access/genam.h"
 #include "access/hash.h"
+#include "access/nbtree.h"
 #include "access/heapam.h"
 #include "access/reloptions.h"
 #include "access/xact.h"
@@ -157,6 +158,55 @@ static char parttype_to_char(PartitionByType type);
 static void add_partition(Partition *part);
 static void add_partition_rule(PartitionRule *rule);
 static Oid	get_part_oid(Oid rootrelid, int16 parlevel, bool istemplate);
+/*
+ * Index of the rules of a PartitionNode, so that the rule of a value can be
+ * found without walking the list of rules, which is slow for tables with
+ * thousands of partitions.  The indexes are built the first time a
+ * PartitionNode is searched, and kept in the PartitionAccessMethods, or in
+ * the PartitionNode when there are none.
+ */
+typedef struct PartitionRuleIndex
+{
+	PartitionNode *partnode;	/* hash key, must be first */
+	MemoryContext cxt;			/* where the arrays below live */
+
+	/* the rules, for a binary search of RANGE partitions */
+	int			nrules;
+	PartitionRule **rules;
+
+	/*
+	 * The values of a single-column LIST PartitionNode, sorted and distinct,
+	 * with the rule of each one.  Sorting them takes about as long as a few
+	 * searches of the list of rules, so it is only done once the
+	 * PartitionNode has been searched PARTITION_LIST_INDEX_MIN_LOOKUPS times.
+	 */
+	int			nlookups;		/* searches done before sorting */
+	bool		listBuilt;		/* tried to sort the values? */
+	bool		listIndexed;	/* the values are sorted? */
+	int			nvalues;
+	Datum	   *values;
+	PartitionRule **valueRules;
+	PartitionRule *nullRule;	/* rule of the NULL value, if any */
+	Oid			valueType;
+	Oid			valueCollation;
+	FmgrInfo	sortfunc;		/* btree order proc of valueType */
+
+	/* btree order proc of the last type searched for, and valueType */
+	Oid			lookupType;
+	bool		lookupValid;
+	FmgrInfo	lookupfunc;
+} PartitionRuleIndex;
+
+#define PARTITION_LIST_INDEX_MIN_LOOKUPS	8
+
+/* a value of a LIST partition, for sorting */
+typedef struct PartitionListValue
+{
+	Datum		value;
+	PartitionRule *rule;
+	int			pos;			/* position among the values of the rules */
+} PartitionListValue;
+
 static Datum *magic_expr_to_datum(Relation rel, PartitionNode *partnode,
 					Node *expr, bool **ppisnull);
 static Oid	selectPartitionByRank(PartitionNode *partnode, int rnk);
@@ -165,6 +215,12 @@ static bool compare_partn_opfuncid(PartitionNode *partnode,
 					   List *colvals,
 					   Datum *values, bool *isnull,
 					   TupleDesc tupdesc);
+static PartitionRuleIndex *get_partition_rule_index(PartitionNode *partnode,
+						 PartitionAccessMethods *accessMethods);
+static void build_list_rule_index(PartitionRuleIndex *idx, PartitionNode *partnode);
+static bool list_rule_index_lookup(PartitionRuleIndex *idx, Oid opclass,
+					   Datum value, bool isnull, Oid typid,
+					   PartitionRule **prule);
 static PartitionNode *selectListPartition(PartitionNode *partnode, Datum *values, bool *isnull,
 					TupleDesc tupdesc, PartitionAccessMethods *accessMethods,
 					Oid *foundOid, PartitionRule **prule);
@@ -4063,6 +4119,294 @@ compare_partn_opfuncid(PartitionNode *partnode,
 	return true;
 }								/* end compare_partn_opfuncid */
 
+/*
+ * get_partition_order_proc
+ *   Retrieves the btree order proc of the opclass for the given types, looking
+ *   through binary-compatible types like cdb_retrieve_btree_op().  Returns
+ *   InvalidOid if there is none.
+ */
+static Oid
+get_partition_order_proc(Oid opclass, Oid lhstypid, Oid rhstypid)
+{
+	Oid			opfamily = get_opclass_family(opclass);
+	Oid			procid;
+
+	procid = get_opfamily_proc(opfamily, lhstypid, rhstypid, BTORDER_PROC);
+	if (!OidIsValid(procid))
+	{
+		Oid			inctypid = get_opclass_input_type(opclass);
+
+		if (IsBinaryCoercible(lhstypid, inctypid) && IsBinaryCoercible(rhstypid, inctypid))
+			procid = get_opfamily_proc(opfamily, inctypid, inctypid, BTORDER_PROC);
+	}
+
+	return procid;
+}
+
+/*
+ * get_partition_rule_index
+ *   Returns the index of the rules of partnode, building it if needed.
+ *
+ * Without accessMethods, only the array of rules is filled in, and the
+ * index is kept in the PartitionNode itself, so that a caller selecting a
+ * partition for every tuple does not build it again each time.
+ */
+static PartitionRuleIndex *
+get_partition_rule_index(PartitionNode *partnode,
+						 PartitionAccessMethods *accessMethods)
+{
+	PartitionRuleIndex *idx;
+	MemoryContext cxt;
+	ListCell   *lc;
+	int			i = 0;
+
+	if (accessMethods)
+	{
+		bool		found;
+
+		/*
+		 * part_cxt may be reset for every tuple, so keep the indexes with the
+		 * access methods themselves.
+		 */
+		cxt = GetMemoryChunkContext(accessMethods);
+
+		if (accessMethods->ruleIndexes == NULL)
+		{
+			HASHCTL		ctl;
+
+			MemSet(&ctl, 0, sizeof(ctl));
+			ctl.keysize = sizeof(PartitionNode *);
+			ctl.entrysize = sizeof(PartitionRuleIndex);
+			ctl.hash = tag_hash;
+			ctl.hcxt = cxt;
+			accessMethods->ruleIndexes = hash_create("partition rule indexes", 16, &ctl,
+													 HASH_ELEM | HASH_CONTEXT | HASH_FUNCTION);
+		}
+
+		idx = (PartitionRuleIndex *) hash_search(accessMethods->ruleIndexes,
+												 &partnode, HASH_ENTER, &found);
+		if (found)
+			return idx;
+
+		MemSet(idx, 0, sizeof(PartitionRuleIndex));
+		idx->partnode = partnode;
+	}
+	else
+	{
+		idx = partnode->ruleIndex;
+		if (idx != NULL && idx->nrules == list_length(partnode->rules))
+			return idx;
+
+		/* rules were added since it was built */
+		if (idx != NULL)
+		{
+			pfree(idx->rules);
+			pfree(idx);
+		}
+
+		cxt = GetMemoryChunkContext(partnode);
+		idx = MemoryContextAllocZero(cxt, sizeof(PartitionRuleIndex));
+		idx->partnode = partnode;
+		idx->listBuilt = true;
+		partnode->ruleIndex = idx;
+	}
+
+	idx->cxt = cxt;
+	idx->nrules = list_length(partnode->rules);
+	idx->rules = MemoryContextAlloc(cxt, sizeof(PartitionRule *) * Max(idx->nrules, 1));
+	foreach(lc, partnode->rules)
+		idx->rules[i++] = (PartitionRule *) lfirst(lc);
+
+	return idx;
+}
+
+static int
+partition_list_value_cmp(const void *a, const void *b, void *arg)
+{
+	const PartitionListValue *va = (const PartitionListValue *) a;
+	const PartitionListValue *vb = (const PartitionListValue *) b;
+	PartitionRuleIndex *idx = (PartitionRuleIndex *) arg;
+	int32		cmp;
+
+	cmp = DatumGetInt32(FunctionCall2Coll(&idx->sortfunc, idx->valueCollation,
+										  va->value, vb->value));
+	if (cmp != 0)
+		return cmp;
+
+	/* keep the first rule of a value, that is the one a linear search finds */
+	return va->pos - vb->pos;
+}
+
+/*
+ * build_list_rule_index
+ *   Sorts the values of a single-column LIST PartitionNode.
+ *
+ * The values are left unsorted, and the list of rules is searched instead,
+ * if there are several key columns, if the values are not all of the same
+ * type and collation, or if the opclass has no order proc for them.
+ */
+static void
+build_list_rule_index(PartitionRuleIndex *idx, PartitionNode *partnode)
+{
+	Partition  *part = partnode->part;
+	PartitionListValue *entries;
+	int			nentries = 0;
+	int			pos = 0;
+	int			i;
+	ListCell   *lc;
+	Oid			procid;
+	int16		typlen = 0;
+	bool		typbyval = false;
+	MemoryContext oldcxt;
+
+	idx->listBuilt = true;
+
+	if (part->parnatts != 1)
+		return;
+
+	/*
+	 * The caller runs in part_cxt, which may be reset for every tuple, so
+	 * build the index, and copy the by-reference values, in its own context.
+	 */
+	oldcxt = MemoryContextSwitchTo(idx->cxt);
+
+	foreach(lc, partnode->rules)
+		nentries += list_length(((PartitionRule *) lfirst(lc))->parlistvalues);
+	entries = palloc(sizeof(PartitionListValue) * Max(nentries, 1));
+
+	nentries = 0;
+	foreach(lc, partnode->rules)
+	{
+		PartitionRule *rule = lfirst(lc);
+		ListCell   *lc2;
+
+		foreach(lc2, rule->parlistvalues)
+		{
+			List	   *colvals = (List *) lfirst(lc2);
+			Const	   *c;
+
+			if (list_length(colvals) != 1)
+				goto l_no_index;
+
+			c = (Const *) linitial(colvals);
+			if (c->constisnull)
+			{
+				if (idx->nullRule == NULL)
+					idx->nullRule = rule;
+				continue;
+			}
+
+			if (nentries == 0)
+			{
+				idx->valueType = c->consttype;
+				idx->valueCollation = c->constcollid;
+			}
+			else if (c->consttype != idx->valueType ||
+					 c->constcollid != idx->valueCollation)
+				goto l_no_index;
+
+			entries[nentries].value = c->constvalue;
+			entries[nentries].rule = rule;
+			entries[nentries].pos = pos++;
+			nentries++;
+		}
+	}
+
+	if (nentries > 0)
+	{
+		procid = get_partition_order_proc(part->parclass[0], idx->valueType,
+										  idx->valueType);
+		if (!OidIsValid(procid))
+			goto l_no_index;
+
+		fmgr_info_cxt(procid, &idx->sortfunc, idx->cxt);
+		qsort_arg(entries, nentries, sizeof(PartitionListValue),
+				  partition_list_value_cmp, idx);
+		get_typlenbyval(idx->valueType, &typlen, &typbyval);
+	}
+
+	idx->values = palloc(sizeof(Datum) * Max(nentries, 1));
+	idx->valueRules = palloc(sizeof(PartitionRule *) * Max(nentries, 1));
+	idx->nvalues = 0;
+	for (i = 0; i < nentries; i++)
+	{
+		/* skip the later rules of a value */
+		if (i > 0 &&
+			DatumGetInt32(FunctionCall2Coll(&idx->sortfunc, idx->valueCollation,
+											entries[i - 1].value,
+											entries[i].value)) == 0)
+			continue;
+
+		idx->values[idx->nvalues] = datumCopy(entries[i].value, typbyval, typlen);
+		idx->valueRules[idx->nvalues] = entries[i].rule;
+		idx->nvalues++;
+	}
+
+	idx->listIndexed = true;
+
+l_no_index:
+	pfree(entries);
+	MemoryContextSwitchTo(oldcxt);
+}
+
+/*
+ * list_rule_index_lookup
+ *   Binary search of the sorted values of a LIST PartitionNode.
+ *
+ * Returns false if the values cannot be compared with the given type, for
+ * the caller to search the list of rules instead.  Otherwise, sets *prule
+ * to the rule of the value, or NULL if no rule has it.
+ */
+static bool
+list_rule_index_lookup(PartitionRuleIndex *idx, Oid opclass, Datum value,
+					   bool isnull, Oid typid, PartitionRule **prule)
+{
+	int			low = 0;
+	int			high = idx->nvalues - 1;
+
+	Assert(idx->listIndexed);
+
+	if (isnull)
+	{
+		*prule = idx->nullRule;
+		return true;
+	}
+
+	if (idx->lookupType != typid)
+	{
+		Oid			procid = get_partition_order_proc(opclass, typid, idx->valueType);
+
+		idx->lookupType = typid;
+		idx->lookupValid = OidIsValid(procid);
+		if (idx->lookupValid)
+			fmgr_info_cxt(procid, &idx->lookupfunc, idx->cxt);
+	}
+
+	if (!idx->lookupValid)
+		return false;
+
+	*prule = NULL;
+	while (low <= high)
+	{
+		int			mid = low + (high - low) / 2;
+		int32		cmp;
+
+		cmp = DatumGetInt32(FunctionCall2Coll(&idx->lookupfunc, idx->valueCollation,
+											  value, idx->values[mid]));
+		if (cmp < 0)
+			high = mid - 1;
+		else if (cmp > 0)
+			low = mid + 1;
+		else
+		{
+			*prule = idx->valueRules[mid];
+			break;
+		}
+	}
+
+	return true;
+}
+
 /*
  *	Given a partition-by-list PartitionNode, search for
  *	a part that matches the given datum value.
@@ -4113,7 +4457,36 @@ selectListPartition(PartitionNode *partnode, Datum *values, bool *isnull,
 
 	*foundOid = InvalidOid;
 
-	/* With LIST, we have no choice at the moment except to be exhaustive */
+	/* Binary search of the sorted values, once they are worth sorting */
+	if (accessMethods && natts == 1)
+	{
+		PartitionRuleIndex *idx = get_partition_rule_index(partnode, accessMethods);
+		AttrNumber	attno = part->paratts[0];
+		PartitionRule *rule;
+
+		if (!idx->listBuilt && ++idx->nlookups >= PARTITION_LIST_INDEX_MIN_LOOKUPS)
+			build_list_rule_index(idx, partnode);
+
+		if (idx->listIndexed &&
+			list_rule_index_lookup(idx, part->parclass[0], values[attno - 1],
+								   isnull[attno - 1],
+								   tupdesc->attrs[attno - 1]->atttypid, &rule))
+		{
+			if (oldcxt)
+				MemoryContextSwitchTo(oldcxt);
+
+			if (rule == NULL)
+				return NULL;
+
+			*foundOid = rule->parchildrelid;
+			*prule = rule;
+
+			/* go to the next level */
+			return rule->children;
+		}
+	}
+
+	/* Otherwise, we have no choice except to be exhaustive */
 	foreach(lc, partnode->rules)
 	{
 		PartitionRule *rule = lfirst(lc);
@@ -4427,8 +4800,8 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 					 TupleDesc tupdesc, PartitionAccessMethods *accessMethods,
 					 Oid *foundOid, int *pSearch, PartitionRule **prule)
 {
-	List	   *rules = partnode->rules;
-	int			high = list_length(rules) - 1;
+	PartitionRuleIndex *idx;
+	int			high;
 	int			low = 0;
 	int			searchpoint = 0;
 	int			mid = 0;
@@ -4455,25 +4828,12 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 		rs->ltfuncs_direct = palloc0(sizeof(FmgrInfo) * natts);
 		rs->lefuncs_inverse = palloc0(sizeof(FmgrInfo) * natts);
 		rs->ltfuncs_inverse = palloc0(sizeof(FmgrInfo) * natts);
-
-		/*
-		 * Unrolling the rules into an array currently works for the top level
-		 * partition only
-		 */
-		if (partnode->part->parlevel == 0)
-		{
-			int			i = 0;
-			ListCell   *lc;
-
-			rs->rules = palloc(sizeof(PartitionRule *) * list_length(rules));
-
-			foreach(lc, rules)
-				rs->rules[i++] = (PartitionRule *) lfirst(lc);
-		}
-		else
-			rs->rules = NULL;
 	}
 
+	/* The rules unrolled into an array, at every level */
+	idx = get_partition_rule_index(partnode, accessMethods);
+	high = idx->nrules - 1;
+
 	/*
 	 *  Invalidating the fn_oid, so that for each call of selectRangePartition()
 	 *  we choose the new fn_oid based on the type of datum
@@ -4519,10 +4879,7 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 
 		mid = low + (high - low) / 2;
 
-		if (rs->rules)
-			rule = rs->rules[mid];
-		else
-			rule = (PartitionRule *) list_nth(rules, mid);
+		rule = idx->rules[mid];
 
 		if (isnull[attno - 1])
 		{
@@ -4583,7 +4940,7 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 				Oid			dTypeOid = tupdesc->attrs[attno - 1]->atttypid;
 
 				if (j != mid)
-					rule = (PartitionRule *) list_nth(rules, j);
+					rule = idx->rules[j];
 
 				if (isnull[attno - 1])
 				{
@@ -4636,7 +4993,7 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 				int			ret;
 				Oid			dTypeOid = tupdesc->attrs[attno - 1]->atttypid;
 
-				rule = (PartitionRule *) list_nth(rules, j);
+				rule = idx->rules[j];
 
 				if (isnull[attno - 1])
 				{
@@ -4672,7 +5029,7 @@ selectRangePartition(PartitionNode *partnode, Datum *values, bool *isnull,
 			}
 
 		}
-		while (++j < list_length(rules));
+		while (++j < idx->nrules);
 	}							/* end if matched */
 
 	pNode = NULL;
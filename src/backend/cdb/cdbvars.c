@@ -271,6 +271,11 @@ double		gp_selectivity_damping_factor = 1;
 bool		gp_selectivity_damping_sigsort = true;
 
 int			gp_hashjoin_tuples_per_bucket = 5;
+bool		gp_enable_runtime_filter = false;
+bool		gp_enable_hashjoin_partitioning = true;
+int			gp_hashjoin_partition_size = 1024;
+bool		gp_enable_hashjoin_prefetch = true;
+bool		gp_enable_aocs_batch_scan = false;
 int			gp_hashagg_groups_per_bucket = 5;
 
 /* Analyzing aid */
@@ -322,6 +327,9 @@ int			gp_workfile_limit_files_per_query = 0;
  */
 int         gp_workfile_compression_overhead_limit = 0;
 
+/* Number of blocks of a sort tape to prefetch ahead of its reader */
+int			gp_workfile_prefetch_blocks = 16;
+
 /* Gpmon */
 bool		gp_enable_gpperfmon = false;
 int			gp_gpperfmon_send_interval = 1;
@@ -138,6 +138,17 @@ int
 /* 1/4 sec in msec */
 #define RX_THREAD_POLL_TIMEOUT (250)
 
+/*
+ * The maximal number of packets sent or received with one sendmmsg() or
+ * recvmmsg() call.  Without these calls, packets go one at a time.
+ */
+#if defined(HAVE_SENDMMSG) && defined(HAVE_RECVMMSG)
+#define UDPIC_USE_MMSG
+#define UDPIC_MAX_BATCH_SIZE (32)
+#else
+#define UDPIC_MAX_BATCH_SIZE (1)
+#endif
+
 /*
  * Flags definitions for flag-field of UDP-messages
  *
@@ -353,8 +364,15 @@ static SendBufferPool snd_buffer_pool;
 typedef struct SendControlInfo SendControlInfo;
 struct SendControlInfo
 {
-	/* The buffer used for accepting acks */
+	/*
+	 * The buffers used for accepting acks, UDPIC_MAX_BATCH_SIZE packets of
+	 * MIN_PACKET_SIZE each.  ackBatchCount acks were received by the last
+	 * call of recvAck(), the next one to hand out is ackBatchNext.
+	 */
 	icpkthdr   *ackBuffer;
+	int			ackBatchLen[UDPIC_MAX_BATCH_SIZE];
+	int			ackBatchCount;
+	int			ackBatchNext;
 
 	/* congestion window */
 	float		cwnd;
@@ -585,6 +603,36 @@ typedef struct AckSendParam
 	socklen_t	peer_len;
 } AckSendParam;
 
+/*
+ * RxBatch
+ *
+ * The data packets the rx thread received with one recvmmsg() call, and the
+ * acks to send for them.  The packet buffers come from rx_buffer_pool; the
+ * slot of a packet that is handed over to a connection is set to NULL, and
+ * gets a new buffer before the next call.
+ *
+ * size is the number of packets to ask for in the next call.  It doubles
+ * while the calls return full batches, and drops to the number of packets
+ * received when they do not, so that the thread does not hold on to rx
+ * buffers when the traffic is light.
+ */
+typedef struct RxBatch
+{
+	icpkthdr   *pkts[UDPIC_MAX_BATCH_SIZE];
+	int			lens[UDPIC_MAX_BATCH_SIZE];
+	struct sockaddr_storage peers[UDPIC_MAX_BATCH_SIZE];
+	socklen_t	peerLens[UDPIC_MAX_BATCH_SIZE];
+	int			count;			/* number of packets received */
+	int			next;			/* the next packet to handle */
+	int			size;
+
+	AckSendParam acks[UDPIC_MAX_BATCH_SIZE];
+	int			nacks;
+} RxBatch;
+
+/* The batch of the rx thread, too large for its stack. */
+static RxBatch rx_batch;
+
 /*
  * ICStatistics
  *
@@ -608,6 +656,10 @@ typedef struct AckSendParam
  * duplicatedPktNum          - duplicate packet number.
  * recvAckNum                - the number of Acks received.
  * statusQueryMsgNum         - the number of status query messages sent.
+ * sndBatchNum               - the number of sendmmsg() calls for data packets.
+ * recvBatchNum              - the number of recvmmsg() calls for data packets.
+ * ackSndBatchNum            - the number of sendmmsg() calls for acks.
+ * ackRecvBatchNum           - the number of recvmmsg() calls for acks.
  *
  */
 typedef struct ICStatistics
@@ -629,6 +681,10 @@ typedef struct ICStatistics
 	int32		duplicatedPktNum;
 	int32		recvAckNum;
 	int32		statusQueryMsgNum;
+	int32		sndBatchNum;
+	int32		recvBatchNum;
+	int32		ackSndBatchNum;
+	int32		ackRecvBatchNum;
 } ICStatistics;
 
 /* Statistics for UDP interconnect. */
@@ -686,6 +742,7 @@ static void sendAck(MotionConn *conn, int32 flags, uint32 seq, uint32 extraSeq);
 static void sendDisorderAck(MotionConn *conn, uint32 seq, uint32 extraSeq, uint32 lostPktCnt);
 static void sendStatusQueryMessage(MotionConn *conn, int fd, uint32 seq);
 static inline void sendControlMessage(icpkthdr *pkt, int fd, struct sockaddr *addr, socklen_t peerLen);
+static void sendAckBatch(AckSendParam *params, int nparams);
 
 static void putRxBufferAndSendAck(MotionConn *conn, AckSendParam *param);
 static inline void putRxBufferToFreeList(RxBufferPool *p, icpkthdr *buf);
@@ -738,6 +795,9 @@ static void checkQDConnectionAlive(void);
 
 
 static void *rxThreadFunc(void *arg);
+static int	fillRxBatch(RxBatch *batch);
+static int	recvRxBatch(RxBatch *batch, int nbufs);
+static void adjustRxBatchSize(RxBatch *batch);
 
 static bool handleMismatch(icpkthdr *pkt, struct sockaddr_storage *peer, int peer_len);
 static void handleAckedPacket(MotionConn *ackConn, ICBuffer *buf, uint64 now);
@@ -753,6 +813,8 @@ static inline void addCRC(icpkthdr *pkt);
 static inline bool checkCRC(icpkthdr *pkt);
 static void sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn);
 static void sendOnce(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer *buf, MotionConn *conn);
+static void sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn, ICBuffer **bufs, int nbufs);
+static int	recvAck(int fd, icpkthdr **pkt);
 static inline uint64 computeExpirationPeriod(MotionConn *conn, uint32 retry);
 
 static ICBuffer *getSndBuffer(MotionConn *conn);
@@ -1577,7 +1639,9 @@ InitMotionUDPIFC(int *listenerSocketFd, uint16 *listenerPort)
 	/* Initialize send control data */
 	snd_control_info.cwnd = 0;
 	snd_control_info.minCwnd = 0;
-	snd_control_info.ackBuffer = palloc0(MIN_PACKET_SIZE);
+	snd_control_info.ackBuffer = palloc0(MIN_PACKET_SIZE * UDPIC_MAX_BATCH_SIZE);
+	snd_control_info.ackBatchCount = 0;
+	snd_control_info.ackBatchNext = 0;
 
 	MemoryContextSwitchTo(old);
 
@@ -1933,6 +1997,71 @@ sendControlMessage(icpkthdr *pkt, int fd, struct sockaddr *addr, socklen_t peerL
 		write_log("sendcontrolmessage: got error %d errno %d seq %d", n, errno, pkt->seq);
 }
 
+/*
+ * sendAckBatch
+ * 		Send the acks the rx thread collected for a batch of packets.
+ *
+ * Like in sendControlMessage(), errors are only logged, the retransmit logic
+ * takes care of lost acks.
+ */
+static void
+sendAckBatch(AckSendParam *params, int nparams)
+{
+	int			i;
+#ifdef UDPIC_USE_MMSG
+	struct mmsghdr msgs[UDPIC_MAX_BATCH_SIZE];
+	struct iovec iovs[UDPIC_MAX_BATCH_SIZE];
+	int			nmsgs = 0;
+	int			n;
+
+	if (nparams == 1)
+	{
+		sendAckWithParam(&params[0]);
+		return;
+	}
+
+	for (i = 0; i < nparams; i++)
+	{
+		icpkthdr   *pkt = &params[i].msg;
+
+#ifdef USE_ASSERT_CHECKING
+		if (testmode_inject_fault(gp_udpic_dropacks_percent))
+			continue;
+#endif
+
+		/* Add CRC for the control message. */
+		if (gp_interconnect_full_crc)
+			addCRC(pkt);
+
+		iovs[nmsgs].iov_base = pkt;
+		iovs[nmsgs].iov_len = pkt->len;
+		memset(&msgs[nmsgs], 0, sizeof(struct mmsghdr));
+		msgs[nmsgs].msg_hdr.msg_name = &params[i].peer;
+		msgs[nmsgs].msg_hdr.msg_namelen = params[i].peer_len;
+		msgs[nmsgs].msg_hdr.msg_iov = &iovs[nmsgs];
+		msgs[nmsgs].msg_hdr.msg_iovlen = 1;
+		nmsgs++;
+	}
+
+	for (i = 0; i < nmsgs; i += n)
+	{
+		n = sendmmsg(UDP_listenerFd, &msgs[i], nmsgs - i, 0);
+		if (n <= 0)
+		{
+			write_log("sendAckBatch: got error %d errno %d seq %d", n, errno,
+					  ((icpkthdr *) iovs[i].iov_base)->seq);
+			/* skip the ack that failed */
+			n = 1;
+			continue;
+		}
+		ic_statistics.ackSndBatchNum++;
+	}
+#else
+	for (i = 0; i < nparams; i++)
+		sendAckWithParam(&params[i]);
+#endif
+}
+
 /*
  * setAckSendParam
  * 		Set the ack sending parameters.
@@ -3761,7 +3890,8 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 " freebuf_avg %f "
 		 "mismatch_pkt_num %d disordered_pkt_num %d duplicated_pkt_num %d"
 		 " rtt/dev [" UINT64_FORMAT "/" UINT64_FORMAT ", %f/%f, " UINT64_FORMAT "/" UINT64_FORMAT "] "
-		 " cwnd %f status_query_msg_num %d",
+		 " cwnd %f status_query_msg_num %d"
+		 " snd_batch_num %d recv_batch_num %d ack_snd_batch_num %d ack_recv_batch_num %d",
 		 ic_control_info.isSender, isReceiver,
 		 Gp_interconnect_snd_queue_depth, Gp_interconnect_queue_depth, Gp_max_packet_size,
 		 UNACK_QUEUE_RING_SLOTS_NUM, TIMER_SPAN, DEFAULT_RTT,
@@ -3774,7 +3904,9 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 		 (double) ((double) ic_statistics.totalBuffers) / ((double) ic_statistics.bufferCountingTime),
 		 ic_statistics.mismatchNum, ic_statistics.disorderedPktNum, ic_statistics.duplicatedPktNum,
 		 (minRtt == ~((uint64) 0) ? 0 : minRtt), (minDev == ~((uint64) 0) ? 0 : minDev), avgRtt, avgDev, maxRtt, maxDev,
-		 snd_control_info.cwnd, ic_statistics.statusQueryMsgNum);
+		 snd_control_info.cwnd, ic_statistics.statusQueryMsgNum,
+		 ic_statistics.sndBatchNum, ic_statistics.recvBatchNum,
+		 ic_statistics.ackSndBatchNum, ic_statistics.ackRecvBatchNum);
 
 	ic_control_info.isSender = false;
 	memset(&ic_statistics, 0, sizeof(ICStatistics));
@@ -4387,6 +4519,65 @@ handleAckedPacket(MotionConn *ackConn, ICBuffer *buf, uint64 now)
 #endif
 }
 
+/*
+ * recvAck
+ * 		Receive the next ack on a sender socket.
+ *
+ * The acks are read from the socket up to UDPIC_MAX_BATCH_SIZE at a time,
+ * and handed out one by one.  Returns the length of the ack and points *pkt
+ * to it, or returns -1 with errno set by the failed call.
+ */
+static int
+recvAck(int fd, icpkthdr **pkt)
+{
+	SendControlInfo *sci = &snd_control_info;
+	int			i;
+	int			n;
+
+	if (sci->ackBatchNext >= sci->ackBatchCount)
+	{
+#ifdef UDPIC_USE_MMSG
+		struct mmsghdr msgs[UDPIC_MAX_BATCH_SIZE];
+		struct iovec iovs[UDPIC_MAX_BATCH_SIZE];
+
+		memset(msgs, 0, sizeof(msgs));
+		for (i = 0; i < UDPIC_MAX_BATCH_SIZE; i++)
+		{
+			iovs[i].iov_base = (char *) sci->ackBuffer + i * MIN_PACKET_SIZE;
+			iovs[i].iov_len = MIN_PACKET_SIZE;
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		n = recvmmsg(fd, msgs, UDPIC_MAX_BATCH_SIZE, 0, NULL);
+		if (n < 0)
+			return -1;
+
+		for (i = 0; i < n; i++)
+			sci->ackBatchLen[i] = msgs[i].msg_len;
+		ic_statistics.ackRecvBatchNum++;
+#else
+		struct sockaddr_storage peer;
+		socklen_t	peerlen = sizeof(peer);
+
+		n = recvfrom(fd, (char *) sci->ackBuffer, MIN_PACKET_SIZE, 0,
+					 (struct sockaddr *) &peer, &peerlen);
+		if (n < 0)
+			return -1;
+
+		sci->ackBatchLen[0] = n;
+		n = 1;
+#endif
+		sci->ackBatchCount = n;
+		sci->ackBatchNext = 0;
+	}
+
+	i = sci->ackBatchNext++;
+	*pkt = (icpkthdr *) ((char *) sci->ackBuffer + i * MIN_PACKET_SIZE);
+
+	return sci->ackBatchLen[i];
+}
+
 /*
  * handleAck
  * 		handle acks incoming from our upstream peers.
@@ -4401,10 +4592,7 @@ handleAcks(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntr
 	MotionConn *ackConn = NULL;
 	int			n;
 
-	struct sockaddr_storage peer;
-	socklen_t	peerlen;
-
-	struct icpkthdr *pkt = snd_control_info.ackBuffer;
+	struct icpkthdr *pkt = NULL;
 
 
 	bool		shouldSendBuffers = false;
@@ -4414,9 +4602,7 @@ handleAcks(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntr
 	{
 
 		/* ready to read on our socket ? */
-		peerlen = sizeof(peer);
-		n = recvfrom(pEntry->txfd, (char *) pkt, MIN_PACKET_SIZE, 0,
-					 (struct sockaddr *) &peer, &peerlen);
+		n = recvAck(pEntry->txfd, &pkt);
 
 		if (n < 0)
 		{
@@ -4760,6 +4946,75 @@ xmit_retry:
 }
 
 
+/*
+ * sendBatch
+ * 		Send packets of a connection with as few system calls as possible.
+ *
+ * A packet that sendmmsg() fails on is handed to sendOnce(), which retries
+ * it or reports the error.  If the socket buffer is full, the rest of the
+ * packets are left to the retransmit logic, as sendOnce() does.
+ */
+static void
+sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry,
+		  MotionConn *conn, ICBuffer **bufs, int nbufs)
+{
+	int			i;
+#ifdef UDPIC_USE_MMSG
+	struct mmsghdr msgs[UDPIC_MAX_BATCH_SIZE];
+	struct iovec iovs[UDPIC_MAX_BATCH_SIZE];
+	ICBuffer   *msgbufs[UDPIC_MAX_BATCH_SIZE];
+	int			nmsgs = 0;
+	int			n;
+
+	if (nbufs == 1)
+	{
+		sendOnce(transportStates, pEntry, bufs[0], conn);
+		return;
+	}
+
+	for (i = 0; i < nbufs; i++)
+	{
+#ifdef USE_ASSERT_CHECKING
+		if (testmode_inject_fault(gp_udpic_dropxmit_percent))
+			continue;
+#endif
+
+		iovs[nmsgs].iov_base = bufs[i]->pkt;
+		iovs[nmsgs].iov_len = bufs[i]->pkt->len;
+		memset(&msgs[nmsgs], 0, sizeof(struct mmsghdr));
+		msgs[nmsgs].msg_hdr.msg_name = &conn->peer;
+		msgs[nmsgs].msg_hdr.msg_namelen = conn->peer_len;
+		msgs[nmsgs].msg_hdr.msg_iov = &iovs[nmsgs];
+		msgs[nmsgs].msg_hdr.msg_iovlen = 1;
+		msgbufs[nmsgs] = bufs[i];
+		nmsgs++;
+	}
+
+	i = 0;
+	while (i < nmsgs)
+	{
+		n = sendmmsg(pEntry->txfd, &msgs[i], nmsgs - i, 0);
+		if (n > 0)
+		{
+			ic_statistics.sndBatchNum++;
+			i += n;
+		}
+		else if (errno == EINTR)
+			continue;
+		else if (errno == EAGAIN)	/* no space ? not an error. */
+			break;
+		else
+		{
+			sendOnce(transportStates, pEntry, msgbufs[i], conn);
+			i++;
+		}
+	}
+#else
+	for (i = 0; i < nbufs; i++)
+		sendOnce(transportStates, pEntry, bufs[i], conn);
+#endif
+}
+
 /*
  * handleStopMsgs
  *		handle stop messages.
@@ -4868,6 +5123,9 @@ handleStopMsgs(ChunkTransportState *transportStates, ChunkTransportStateEntry *p
 static void
 sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn)
 {
+	ICBuffer   *batch[UDPIC_MAX_BATCH_SIZE];
+	int			nbatch = 0;
+
 	while (conn->capacity > 0 && icBufferListLength(&conn->sndQueue) > 0)
 	{
 		ICBuffer   *buf = NULL;
@@ -4906,18 +5164,26 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		}
 
 		/*
-		 * Note the place of sendOnce here. If we send before appending it to
+		 * Note the place of sendBatch here. If we send before appending it to
 		 * the unack queue and putting it into unack queue ring, and there is
-		 * a network error occurred in the sendOnce function, error message
+		 * a network error occurred in the sendBatch function, error message
 		 * will be output. In the time of error message output, interrupts is
 		 * potentially checked, if there is a pending query cancel, it will
 		 * lead to a dangled buffer (memory leak).
+		 *
+		 * The packets that the capacity and the congestion window allow are
+		 * collected, and sent together.
 		 */
 #ifdef TRANSFER_PROTOCOL_STATS
 		updateStats(TPE_DATA_PKT_SEND, conn, buf->pkt);
 #endif
 
-		sendOnce(transportStates, pEntry, buf, conn);
+		batch[nbatch++] = buf;
+		if (nbatch == UDPIC_MAX_BATCH_SIZE)
+		{
+			sendBatch(transportStates, pEntry, conn, batch, nbatch);
+			nbatch = 0;
+		}
 		ic_statistics.sndPktNum++;
 
 #ifdef AMS_VERBOSE_LOGGING
@@ -4926,6 +5192,9 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 
 		buf->conn->sentSeq = buf->pkt->seq;
 	}
+
+	if (nbatch > 0)
+		sendBatch(transportStates, pEntry, conn, batch, nbatch);
 }
 
 /*
@@ -6277,8 +6546,12 @@ handleDataPacket(MotionConn *conn, icpkthdr *pkt, struct sockaddr_storage *peer,
 static void *
 rxThreadFunc(void *arg)
 {
-	icpkthdr   *pkt = NULL;
+	RxBatch    *batch = &rx_batch;
 	bool		skip_poll = false;
+	int			i;
+
+	memset(batch, 0, sizeof(RxBatch));
+	batch->size = 1;
 
 	for (;;)
 	{
@@ -6295,72 +6568,68 @@ rxThreadFunc(void *arg)
 			break;
 		}
 
-		/* Try to get a buffer */
-		if (pkt == NULL)
+		if (batch->next >= batch->count)
 		{
-			pthread_mutex_lock(&ic_control_info.lock);
-			pkt = getRxBuffer(&rx_buffer_pool);
-			pthread_mutex_unlock(&ic_control_info.lock);
+			int			nbufs;
 
-			if (pkt == NULL)
+			/*
+			 * All packets of the last batch are handled.  Send the acks for
+			 * them, and receive the next batch.
+			 */
+			if (batch->nacks > 0)
+			{
+				sendAckBatch(batch->acks, batch->nacks);
+				batch->nacks = 0;
+			}
+
+			/* Try to get the buffers */
+			nbufs = fillRxBatch(batch);
+			if (nbufs == 0)
 			{
 				setRxThreadError(ENOMEM);
 				continue;
 			}
-		}
 
-		if (!skip_poll)
-		{
-			/* Do we have inbound traffic to handle ? */
-			nfd.fd = UDP_listenerFd;
-			nfd.events = POLLIN;
+			if (!skip_poll)
+			{
+				/* Do we have inbound traffic to handle ? */
+				nfd.fd = UDP_listenerFd;
+				nfd.events = POLLIN;
 
-			n = poll(&nfd, 1, RX_THREAD_POLL_TIMEOUT);
+				n = poll(&nfd, 1, RX_THREAD_POLL_TIMEOUT);
 
-			if (pg_atomic_read_u32(&ic_control_info.shutdown) == 1)
-			{
-				if (DEBUG1 >= log_min_messages)
+				if (pg_atomic_read_u32(&ic_control_info.shutdown) == 1)
 				{
-					write_log("udp-ic: rx-thread shutting down");
+					if (DEBUG1 >= log_min_messages)
+					{
+						write_log("udp-ic: rx-thread shutting down");
+					}
+					break;
 				}
-				break;
-			}
 
-			if (n < 0)
-			{
-				if (errno == EINTR)
+				if (n < 0)
+				{
+					if (errno == EINTR)
+						continue;
+
+					/*
+					 * ERROR case: if simply break out the loop here, there
+					 * will be a hung here, since main thread will never be
+					 * waken up, and senders will not get responses anymore.
+					 *
+					 * Thus, we set an error flag, and let main thread to
+					 * report an error.
+					 */
+					setRxThreadError(errno);
 					continue;
+				}
 
-				/*
-				 * ERROR case: if simply break out the loop here, there will
-				 * be a hung here, since main thread will never be waken up,
-				 * and senders will not get responses anymore.
-				 *
-				 * Thus, we set an error flag, and let main thread to report
-				 * an error.
-				 */
-				setRxThreadError(errno);
-				continue;
+				if (n == 0)
+					continue;
 			}
 
-			if (n == 0)
-				continue;
-		}
-
-		if (skip_poll || (n == 1 && (nfd.events & POLLIN)))
-		{
 			/* we've got something interesting to read */
-			/* handle incoming */
-			/* ready to read on our socket */
-			MotionConn *conn = NULL;
-			int			read_count = 0;
-
-			struct sockaddr_storage peer;
-			socklen_t	peerlen;
-
-			peerlen = sizeof(peer);
-			read_count = recvfrom(UDP_listenerFd, (char *) pkt, Gp_max_packet_size, 0,
-								  (struct sockaddr *) &peer, &peerlen);
+			n = recvRxBatch(batch, nbufs);
 
 			if (pg_atomic_read_u32(&ic_control_info.shutdown) == 1)
 			{
@@ -6371,10 +6640,7 @@ rxThreadFunc(void *arg)
 				break;
 			}
 
-			if (DEBUG5 >= log_min_messages)
-				write_log("received inbound len %d", read_count);
-
-			if (read_count < 0)
+			if (n < 0)
 			{
 				skip_poll = false;
 
@@ -6395,6 +6661,27 @@ rxThreadFunc(void *arg)
 				continue;
 			}
 
+			/*
+			 * when we get a "good" recvfrom() result, we can skip poll()
+			 * until we get a bad one.
+			 */
+			skip_poll = true;
+
+			batch->count = n;
+			batch->next = 0;
+			adjustRxBatchSize(batch);
+		}
+
+		/* handle the next packet of the batch */
+		{
+			int			slot = batch->next++;
+			icpkthdr   *pkt = batch->pkts[slot];
+			int			read_count = batch->lens[slot];
+			MotionConn *conn = NULL;
+
+			if (DEBUG5 >= log_min_messages)
+				write_log("received inbound len %d", read_count);
+
 			if (read_count < sizeof(icpkthdr))
 			{
 				if (DEBUG1 >= log_min_messages)
@@ -6402,12 +6689,6 @@ rxThreadFunc(void *arg)
 				continue;
 			}
 
-			/*
-			 * when we get a "good" recvfrom() result, we can skip poll()
-			 * until we get a bad one.
-			 */
-			skip_poll = true;
-
 			/* length must be >= 0 */
 			if (pkt->len < 0)
 			{
@@ -6460,8 +6741,8 @@ rxThreadFunc(void *arg)
 			if (conn != NULL)
 			{
 				/* Handling a regular packet */
-				if (handleDataPacket(conn, pkt, &peer, &peerlen, &param, &wakeup_mainthread))
-					pkt = NULL;
+				if (handleDataPacket(conn, pkt, &batch->peers[slot], &batch->peerLens[slot], &param, &wakeup_mainthread))
+					batch->pkts[slot] = NULL;
 				ic_statistics.recvPktNum++;
 			}
 			else
@@ -6483,8 +6764,8 @@ rxThreadFunc(void *arg)
 					logPkt("Got a Mismatched Packet", pkt);
 #endif
 
-					if (handleMismatch(pkt, &peer, peerlen))
-						pkt = NULL;
+					if (handleMismatch(pkt, &batch->peers[slot], batch->peerLens[slot]))
+						batch->pkts[slot] = NULL;
 					ic_statistics.mismatchNum++;
 				}
 			}
@@ -6495,28 +6776,145 @@ rxThreadFunc(void *arg)
 
 			/*
 			 * real ack sending is after lock release to decrease the lock
-			 * holding time.
+			 * holding time.  The acks for a batch of packets are sent
+			 * together, once the batch is handled.
 			 */
 			if (param.msg.len != 0)
-				sendAckWithParam(&param);
+				batch->acks[batch->nacks++] = param;
 		}
 
 		/* pthread_yield(); */
 	}
 
-	/* Before return, we release the packet. */
-	if (pkt)
+	/* Before return, we release the packets. */
+	pthread_mutex_lock(&ic_control_info.lock);
+	for (i = 0; i < UDPIC_MAX_BATCH_SIZE; i++)
 	{
-		pthread_mutex_lock(&ic_control_info.lock);
-		freeRxBuffer(&rx_buffer_pool, pkt);
-		pkt = NULL;
-		pthread_mutex_unlock(&ic_control_info.lock);
+		if (batch->pkts[i])
+		{
+			freeRxBuffer(&rx_buffer_pool, batch->pkts[i]);
+			batch->pkts[i] = NULL;
+		}
 	}
+	pthread_mutex_unlock(&ic_control_info.lock);
 
 	/* nothing to return */
 	return NULL;
 }
 
+/*
+ * fillRxBatch
+ * 		Get rx buffers for the empty slots among the first size ones of the
+ * 		batch.
+ *
+ * Returns the number of slots, from the first one, that have a buffer.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ */
+static int
+fillRxBatch(RxBatch *batch)
+{
+	int			i;
+
+	pthread_mutex_lock(&ic_control_info.lock);
+	for (i = 0; i < batch->size; i++)
+	{
+		if (batch->pkts[i] == NULL)
+		{
+			batch->pkts[i] = getRxBuffer(&rx_buffer_pool);
+			if (batch->pkts[i] == NULL)
+				break;
+		}
+	}
+	pthread_mutex_unlock(&ic_control_info.lock);
+
+	return i;
+}
+
+/*
+ * recvRxBatch
+ * 		Receive up to nbufs data packets on the listener socket.
+ *
+ * Returns the number of packets received, or -1 with errno set by the failed
+ * call.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ */
+static int
+recvRxBatch(RxBatch *batch, int nbufs)
+{
+#ifdef UDPIC_USE_MMSG
+	struct mmsghdr msgs[UDPIC_MAX_BATCH_SIZE];
+	struct iovec iovs[UDPIC_MAX_BATCH_SIZE];
+	int			i;
+	int			n;
+
+	memset(msgs, 0, sizeof(struct mmsghdr) * nbufs);
+	for (i = 0; i < nbufs; i++)
+	{
+		iovs[i].iov_base = batch->pkts[i];
+		iovs[i].iov_len = Gp_max_packet_size;
+		msgs[i].msg_hdr.msg_name = &batch->peers[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	n = recvmmsg(UDP_listenerFd, msgs, nbufs, 0, NULL);
+
+	for (i = 0; i < n; i++)
+	{
+		batch->lens[i] = msgs[i].msg_len;
+		batch->peerLens[i] = msgs[i].msg_hdr.msg_namelen;
+	}
+	if (n > 0)
+		ic_statistics.recvBatchNum++;
+
+	return n;
+#else
+	batch->peerLens[0] = sizeof(struct sockaddr_storage);
+	batch->lens[0] = recvfrom(UDP_listenerFd, (char *) batch->pkts[0], Gp_max_packet_size, 0,
+							  (struct sockaddr *) &batch->peers[0], &batch->peerLens[0]);
+
+	return batch->lens[0] < 0 ? -1 : 1;
+#endif
+}
+
+/*
+ * adjustRxBatchSize
+ * 		Choose the number of packets to ask for in the next recvmmsg() call.
+ *
+ * The buffers of the slots that are no longer used are returned to the pool;
+ * they hold no packets, as less packets than the new size were received.
+ */
+static void
+adjustRxBatchSize(RxBatch *batch)
+{
+	int			newsize;
+	int			i;
+
+	if (batch->count == batch->size)
+		newsize = Min(batch->size * 2, UDPIC_MAX_BATCH_SIZE);
+	else
+		newsize = Max(batch->count, 1);
+
+	if (newsize < batch->size)
+	{
+		pthread_mutex_lock(&ic_control_info.lock);
+		for (i = newsize; i < batch->size; i++)
+		{
+			if (batch->pkts[i])
+			{
+				putRxBufferToFreeList(&rx_buffer_pool, batch->pkts[i]);
+				batch->pkts[i] = NULL;
+			}
+		}
+		pthread_mutex_unlock(&ic_control_info.lock);
+	}
+
+	batch->size = newsize;
+}
+
 /*
  * handleMismatch
  * 		If the mismatched packet is from an old connection, we may need to
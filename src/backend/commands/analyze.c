@@ -131,6 +131,7 @@
 #include "funcapi.h"
 #include "libpq-fe.h"
 #include "utils/builtins.h"
+#include "utils/cardfeedback.h"
 #include "utils/hyperloglog/gp_hyperloglog.h"
 #include "utils/snapmgr.h"
 
@@ -904,6 +905,9 @@ do_analyze_rel(Relation onerel, VacuumStmt *vacstmt,
 			update_attstats(RelationGetRelid(Irel[ind]), false,
 							thisdata->attr_cnt, thisdata->vacattrstats);
 		}
+
+		/* the cardinality feedback was learned with the old statistics */
+		CardinalityFeedbackForgetRelation(RelationGetRelid(onerel));
 	}
 
 	/*
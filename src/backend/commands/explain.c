@@ -31,6 +31,7 @@
 #include "storage/bufmgr.h"
 #include "tcop/tcopprot.h"
 #include "utils/builtins.h"
+#include "utils/cardfeedback.h"
 #include "utils/json.h"
 #include "utils/lsyscache.h"
 #include "utils/metrics_utils.h"
@@ -43,6 +44,8 @@
 #include "executor/execDynamicScan.h"
 
 #ifdef USE_ORCA
+#include "optimizer/orca.h"
+
 extern char *SerializeDXLPlan(Query *parse);
 #endif
 
@@ -73,6 +76,7 @@ static void report_triggers(ResultRelInfo *rInfo, bool show_relname,
 static void ExplainDXL(Query *query, ExplainState *es,
 							const char *queryString,
 							ParamListInfo params);
+static void ExplainOptimizerProfile(OptimizerProfile *profile, ExplainState *es);
 #endif
 static double elapsed_time(instr_time *starttime);
 static void ExplainPreScanNode(PlanState *planstate, Bitmapset **rels_used);
@@ -368,6 +372,95 @@ ExplainDXL(Query *query, ExplainState *es, const char *queryString,
 	/* Free the memory we used. */
 	MemoryContextSwitchTo(oldcxt);
 }
+
+/*
+ * Comparator to sort the xforms of an optimizer profile by decreasing time
+ */
+static int
+xform_profile_time_cmp(const void *a, const void *b)
+{
+	const OptimizerXformProfile *xa = (const OptimizerXformProfile *) a;
+	const OptimizerXformProfile *xb = (const OptimizerXformProfile *) b;
+
+	if (xa->time_ms > xb->time_ms)
+		return -1;
+	if (xa->time_ms < xb->time_ms)
+		return 1;
+	return 0;
+}
+
+/*
+ * ExplainOptimizerProfile -
+ *	  print out the time ORCA spent in each type of job and in each xform
+ *	  while optimizing the plan, the xforms by decreasing time
+ */
+static void
+ExplainOptimizerProfile(OptimizerProfile *profile, ExplainState *es)
+{
+	int			i;
+
+	qsort(profile->xforms, profile->num_xforms, sizeof(OptimizerXformProfile),
+		  xform_profile_time_cmp);
+
+	if (es->format == EXPLAIN_FORMAT_TEXT)
+	{
+		appendStringInfoSpaces(es->str, es->indent * 2);
+		appendStringInfo(es->str, "Optimizer profile: groups=" INT64_FORMAT "\n",
+						 profile->groups);
+		for (i = 0; i < profile->num_jobs; i++)
+		{
+			OptimizerJobProfile *job = &profile->jobs[i];
+
+			appendStringInfoSpaces(es->str, es->indent * 2 + 2);
+			appendStringInfo(es->str, "Job %s: steps=" INT64_FORMAT
+							 " time=%.3f ms\n",
+							 job->name, job->steps, job->time_ms);
+		}
+		for (i = 0; i < profile->num_xforms; i++)
+		{
+			OptimizerXformProfile *xform = &profile->xforms[i];
+
+			appendStringInfoSpaces(es->str, es->indent * 2 + 2);
+			appendStringInfo(es->str, "Xform %s: calls=" INT64_FORMAT
+							 " alternatives=" INT64_FORMAT " time=%.3f ms\n",
+							 xform->name, xform->calls, xform->alternatives,
+							 xform->time_ms);
+		}
+		return;
+	}
+
+	ExplainOpenGroup("Optimizer Profile", "Optimizer Profile", true, es);
+	ExplainPropertyLong("Groups", profile->groups, es);
+
+	ExplainOpenGroup("Jobs", "Jobs", false, es);
+	for (i = 0; i < profile->num_jobs; i++)
+	{
+		OptimizerJobProfile *job = &profile->jobs[i];
+
+		ExplainOpenGroup("Job", NULL, true, es);
+		ExplainPropertyText("Job Type", job->name, es);
+		ExplainPropertyLong("Steps", job->steps, es);
+		ExplainPropertyFloat("Time", job->time_ms, 3, es);
+		ExplainCloseGroup("Job", NULL, true, es);
+	}
+	ExplainCloseGroup("Jobs", "Jobs", false, es);
+
+	ExplainOpenGroup("Xforms", "Xforms", false, es);
+	for (i = 0; i < profile->num_xforms; i++)
+	{
+		OptimizerXformProfile *xform = &profile->xforms[i];
+
+		ExplainOpenGroup("Xform", NULL, true, es);
+		ExplainPropertyText("Xform", xform->name, es);
+		ExplainPropertyLong("Calls", xform->calls, es);
+		ExplainPropertyLong("Alternatives", xform->alternatives, es);
+		ExplainPropertyFloat("Time", xform->time_ms, 3, es);
+		ExplainCloseGroup("Xform", NULL, true, es);
+	}
+	ExplainCloseGroup("Xforms", "Xforms", false, es);
+
+	ExplainCloseGroup("Optimizer Profile", "Optimizer Profile", true, es);
+}
 #endif
 
 /*
@@ -623,6 +716,10 @@ ExplainOnePlan(PlannedStmt *plannedstmt, IntoClause *into, ExplainState *es,
 	/* Create textual dump of plan tree */
 	ExplainPrintPlan(es, queryDesc);
 
+	/* Feed the actual rows back to GPORCA, now that they are gathered */
+	if (es->analyze)
+		CardinalityFeedbackRecord(queryDesc);
+
 	if (cursorOptions & CURSOR_OPT_PARALLEL_RETRIEVE)
 		ExplainParallelRetrieveCursor(es, queryDesc);
 
@@ -670,6 +767,12 @@ ExplainOnePlan(PlannedStmt *plannedstmt, IntoClause *into, ExplainState *es,
 
 		if (list_length(settings) > 0)
 			ExplainPropertyList("Settings", settings, es);
+
+#ifdef USE_ORCA
+		/* show the profile of ORCA, if it was collected for this plan */
+		if (queryDesc->plannedstmt->optimizerProfile != NULL)
+			ExplainOptimizerProfile(queryDesc->plannedstmt->optimizerProfile, es);
+#endif
 	}
 
 	ExplainCloseGroup("Settings", "Settings", true, es);
@@ -2000,6 +2103,16 @@ ExplainNode(PlanState *planstate, List *ancestors,
 			if (plan->qual)
 				show_instrumentation_count("Rows Removed by Filter", 1,
 										   planstate, es);
+			/*
+			 * CDB: the runtime filter of a hash join is installed at
+			 * execution time, so the plan can't tell whether there was
+			 * one; show the count only when it removed something.
+			 */
+			if ((IsA(plan, SeqScan) || IsA(plan, DynamicSeqScan)) &&
+				planstate->instrument &&
+				planstate->instrument->nfiltered2 > 0)
+				show_instrumentation_count("Rows Removed by Runtime Filter", 2,
+										   planstate, es);
 			break;
 		case T_FunctionScan:
 			if (es->verbose)
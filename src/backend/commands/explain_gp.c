@@ -102,6 +102,8 @@ typedef struct CdbExplain_StatInst
 	double		total;			/* Total total time (in seconds) */
 	double		ntuples;		/* Total tuples produced */
 	double		nloops;			/* # of run cycles for this node */
+	double		nfiltered1;		/* # tuples removed by scanqual or joinqual */
+	double		nfiltered2;		/* # tuples removed by "other" quals */
 	double		execmemused;	/* executor memory used (bytes) */
 	double		workmemused;	/* work_mem actually used (bytes) */
 	double		workmemwanted;	/* work_mem to avoid workfile i/o (bytes) */
@@ -985,6 +987,8 @@ cdbexplain_collectStatsFromNode(PlanState *planstate, CdbExplain_SendStatCtx *ct
 	si->total = instr->total;
 	si->ntuples = instr->ntuples;
 	si->nloops = instr->nloops;
+	si->nfiltered1 = instr->nfiltered1;
+	si->nfiltered2 = instr->nfiltered2;
 	si->execmemused = instr->execmemused;
 	si->workmemused = instr->workmemused;
 	si->workmemwanted = instr->workmemwanted;
@@ -1236,6 +1240,8 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 		instr->total = ntuples.nsimax->total;
 		instr->ntuples = ntuples.nsimax->ntuples;
 		instr->nloops = ntuples.nsimax->nloops;
+		instr->nfiltered1 = ntuples.nsimax->nfiltered1;
+		instr->nfiltered2 = ntuples.nsimax->nfiltered2;
 		instr->execmemused = ntuples.nsimax->execmemused;
 		instr->workmemused = ntuples.nsimax->workmemused;
 		instr->workmemwanted = ntuples.nsimax->workmemwanted;
@@ -1519,6 +1525,31 @@ cdbexplain_showStatCtxFree(struct CdbExplain_ShowStatCtx *ctx)
 	pfree(ctx);
 }
 
+/*
+ * cdbexplain_getNodeRows
+ *	  Number of rows a node returned over all the workers of its slice, and
+ *	  the largest number of run cycles of the node in any worker.
+ */
+bool
+cdbexplain_getNodeRows(PlanState *planstate, double *ntuples, double *nloops)
+{
+	CdbExplain_NodeSummary *ns;
+	int			i;
+
+	if (planstate->instrument == NULL ||
+		planstate->instrument->cdbNodeSummary == NULL)
+		return false;
+
+	ns = planstate->instrument->cdbNodeSummary;
+
+	*ntuples = ns->ntuples.vsum;
+	*nloops = 0;
+	for (i = 0; i < ns->ninst; i++)
+		*nloops = Max(*nloops, ns->insts[i].nloops);
+
+	return true;
+}
+
 /*
  * nodeSupportWorkfileCaching
  *	 Return true if a given node supports workfile caching.
@@ -111,6 +111,7 @@
 #include "storage/smgr.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
+#include "utils/cardfeedback.h"
 #include "utils/datum.h"
 #include "utils/fmgroids.h"
 #include "utils/inval.h"
@@ -1837,6 +1838,9 @@ ExecuteTruncate(TruncateStmt *stmt)
 
 		Assert(CheckExclusiveAccess(rel));
 
+		/* the cardinality feedback was learned from the old contents */
+		CardinalityFeedbackForgetRelation(RelationGetRelid(rel));
+
 		/*
 		 * Normally, we need a transaction-safe truncation here.  However, if
 		 * the table was either created in the current (sub)transaction or has
@@ -39,6 +39,10 @@
 #include "cdb/cdbexplain.h"
 #include "cdb/cdbvars.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #define BUFFER_INCREMENT_SIZE 1024
 #define HHA_MSG_LVL DEBUG2
 
@@ -89,7 +93,7 @@ typedef enum InputRecordType
 #define SANITY_CHECK_METADATA_SIZE(hashtable) \
 	do { \
 		Assert((hashtable)->mem_for_metadata > 0); \
-		Assert((hashtable)->mem_for_metadata > (hashtable)->nbuckets * OVERHEAD_PER_BUCKET); \
+		Assert((hashtable)->mem_for_metadata > (hashtable)->nslots * OVERHEAD_PER_SLOT); \
 		if ((hashtable)->mem_for_metadata >= (hashtable)->max_mem) \
 			ereport(ERROR, (errcode(ERRCODE_INTERNAL_ERROR), \
 				errmsg(ERRMSG_GP_INSUFFICIENT_STATEMENT_MEMORY)));\
@@ -104,13 +108,25 @@ typedef enum InputRecordType
 #define HAVE_FREESPACE(hashtable) \
 		(AVAIL_MEM(hashtable) > 0)
 
-/* Actual memory needed per bucket = entry pointer + bloom value */
-#define OVERHEAD_PER_BUCKET (sizeof(HashAggBucket) + sizeof(uint64))
+/* Actual memory needed per slot = control byte + hash key + entry pointer */
+#define OVERHEAD_PER_SLOT (sizeof(uint8) + sizeof(HashKey) + sizeof(HashAggEntry *))
+
+/*
+ * The slots are probed in groups of HASHAGG_GROUP_WIDTH, whose control
+ * bytes are matched at once. The table grows, or is full, when more than
+ * HASHAGG_MAX_FILL of its slots are used.
+ */
+#define HASHAGG_GROUP_WIDTH 16
+#define HASHAGG_MAX_FILL 0.875
+#define HASHAGG_MAX_ENTRIES(nslots) ((nslots) - (nslots) / 8)
 
-#define BLOOMVAL(hashkey) ((uint64)1) << (((hashkey) >> 23) & 0x3f);
+/* Control byte of an empty slot, and of a slot holding a hash key */
+#define HASHAGG_CTRL_EMPTY ((uint8) 0x80)
+#define HASHAGG_CTRL_TAG(hashkey) ((uint8) ((hashkey) >> 25))
 
-#define BUCKET_IDX(hashtable, hashkey) \
-		(((hashkey) >> (hashtable)->pshift) & ((hashtable)->nbuckets - 1))
+#define GROUP_IDX(hashtable, hashkey) \
+		(((hashkey) >> (hashtable)->pshift) & \
+		 ((hashtable)->nslots / HASHAGG_GROUP_WIDTH - 1))
 
 #define LOG2(x) (ceil(log((x)) / log(2)))
 
@@ -139,6 +155,9 @@ static void agg_hash_table_stat_upd(HashAggTable *ht);
 static void reset_agg_hash_table(AggState *aggstate, int64 nentries);
 static bool agg_hash_reload(AggState *aggstate);
 static void reCalcNumberBatches(HashAggTable *hashtable, SpillFile *spill_file);
+static void alloc_agg_hash_slots(HashAggTable *hashtable, MemoryContext cxt,
+								 unsigned nslots);
+static void free_agg_hash_slots(HashAggTable *hashtable);
 static inline void *mpool_cxt_alloc(void *manager, Size len);
 
 static inline void *mpool_cxt_alloc(void *manager, Size len)
@@ -324,7 +343,6 @@ makeHashAggEntryForInput(AggState *aggstate, TupleTableSlot *inputslot, uint32 h
 	entry->tuple_and_aggs = NULL;
 	entry->hashvalue = hashvalue;
 	entry->is_primodial = !(hashtable->is_spilling);
-	entry->next = NULL;
 
 	/*
 	 * Calculate the tup_len we need.
@@ -407,7 +425,6 @@ makeHashAggEntryForGroup(AggState *aggstate, void *tuple_and_aggs,
 	entry->hashvalue = hashvalue;
 	entry->is_primodial = !(hashtable->is_spilling);
 	entry->tuple_and_aggs = copy_tuple_and_aggs;
-	entry->next = NULL;
 
 	/* Initialize per group data */
 	adjustInputGroup(aggstate, entry->tuple_and_aggs, false);
@@ -435,6 +452,133 @@ setGroupAggs(HashAggTable *hashtable, HashAggEntry *entry)
 	}
 }
 
+/*
+ * Function: match_group_ctrl
+ *
+ * Returns a bitmask of the slots of the group starting at ctrl whose
+ * control byte equals the given one.
+ */
+static inline uint32
+match_group_ctrl(const uint8 *ctrl, uint8 value)
+{
+#ifdef __SSE2__
+	__m128i group = _mm_loadu_si128((const __m128i *) ctrl);
+
+	return (uint32) _mm_movemask_epi8(_mm_cmpeq_epi8(group,
+													  _mm_set1_epi8((char) value)));
+#else
+	uint32 mask = 0;
+	int i;
+
+	for (i = 0; i < HASHAGG_GROUP_WIDTH; i++)
+	{
+		if (ctrl[i] == value)
+			mask |= ((uint32) 1) << i;
+	}
+	return mask;
+#endif
+}
+
+/*
+ * Function: first_group_slot
+ *
+ * Returns the position of the first slot set in a non-empty bitmask
+ * returned by match_group_ctrl.
+ */
+static inline int
+first_group_slot(uint32 mask)
+{
+	Assert(mask != 0);
+#ifdef __GNUC__
+	return __builtin_ctz(mask);
+#else
+	{
+		int pos = 0;
+
+		while ((mask & 1) == 0)
+		{
+			mask >>= 1;
+			pos++;
+		}
+		return pos;
+	}
+#endif
+}
+
+/*
+ * Function: find_empty_slot
+ *
+ * Returns the first empty slot on the probe sequence of the given hash key.
+ * The table must not be full.
+ */
+static inline unsigned
+find_empty_slot(HashAggTable *hashtable, HashKey hashkey)
+{
+	unsigned group_mask = hashtable->nslots / HASHAGG_GROUP_WIDTH - 1;
+	unsigned group_idx = GROUP_IDX(hashtable, hashkey);
+
+	while (true)
+	{
+		unsigned group_start = group_idx * HASHAGG_GROUP_WIDTH;
+		uint32 empty = match_group_ctrl(hashtable->ctrl + group_start,
+										HASHAGG_CTRL_EMPTY);
+
+		if (empty != 0)
+			return group_start + first_group_slot(empty);
+
+		group_idx = (group_idx + 1) & group_mask;
+	}
+}
+
+/*
+ * Function: match_group_keys
+ *
+ * Returns true if the grouping keys of the input record equal those of
+ * the given hash table entry. NULLs match in group keys.
+ */
+static inline bool
+match_group_keys(AggState *aggstate, HashAggEntry *entry,
+				 void *input_record, InputRecordType input_type)
+{
+	MemTupleBinding *mt_bind = aggstate->hashslot->tts_mt_bind;
+	Agg *agg = (Agg*)aggstate->ss.ps.plan;
+	MemTuple mtup = (MemTuple) entry->tuple_and_aggs;
+	int i;
+
+	for (i = 0; i < agg->numCols; i++)
+	{
+		AttrNumber	att = agg->grpColIdx[i];
+		Datum input_datum = 0;
+		Datum entry_datum = 0;
+		bool input_isNull = false;
+		bool entry_isNull = false;
+
+		switch(input_type)
+		{
+			case INPUT_RECORD_TUPLE:
+				input_datum = slot_getattr((TupleTableSlot *)input_record, att, &input_isNull);
+				break;
+			case INPUT_RECORD_GROUP_AND_AGGS:
+				input_datum = memtuple_getattr((MemTuple)input_record, mt_bind, att, &input_isNull);
+				break;
+			default:
+				elog(ERROR, "invalid record type %d", input_type);
+		}
+
+		entry_datum = memtuple_getattr(mtup, mt_bind, att, &entry_isNull);
+
+		if ( !input_isNull && !entry_isNull &&
+			 (DatumGetBool(FunctionCall2(&aggstate->eqfunctions[i],
+										 input_datum,
+										 entry_datum)) ) )
+			continue; /* Both non-NULL and equal. */
+		if (!(input_isNull && entry_isNull))
+			return false;
+	}
+
+	return true;
+}
+
 /*
  * Function: lookup_agg_hash_entry
  *
@@ -458,16 +602,16 @@ lookup_agg_hash_entry(AggState *aggstate,
 					  InputRecordType input_type, int32 input_size,
 					  uint32 hashkey, bool *p_isnew)
 {
-	HashAggEntry *entry;
+	HashAggEntry *entry = NULL;
 	HashAggTable *hashtable = aggstate->hhashtable;
-	MemTupleBinding *mt_bind = aggstate->hashslot->tts_mt_bind;
 	ExprContext *tmpcontext = aggstate->tmpcontext; /* per input tuple context */
-	Agg *agg = (Agg*)aggstate->ss.ps.plan;
 	MemoryContext oldcxt;
-	unsigned int bucket_idx;
-	uint64 bloomval;			/* bloom filter value */
-   
-	Assert(mt_bind != NULL);
+	unsigned group_mask;
+	unsigned group_idx;
+	unsigned slot_idx = 0;
+	uint8 tag = HASHAGG_CTRL_TAG(hashkey);
+
+	Assert(aggstate->hashslot->tts_mt_bind != NULL);
 
 #ifdef FAULT_INJECTOR
 	if (SIMPLE_FAULT_INJECTOR("force_hashagg_stream_hashtable") == FaultInjectorTypeSkip)
@@ -480,69 +624,68 @@ lookup_agg_hash_entry(AggState *aggstate,
 
 	oldcxt = MemoryContextSwitchTo(tmpcontext->ecxt_per_tuple_memory);
 
-	bucket_idx = BUCKET_IDX(hashtable, hashkey);
-	bloomval = BLOOMVAL(hashkey);
-	entry = (0 == (hashtable->bloom[bucket_idx] & bloomval) ? NULL :
-			 hashtable->buckets[bucket_idx]);
-
 	/*
-	 * Search entry chain for the bucket. If such an entry found in the
-	 * chain, move it to the front of the chain. Otherwise, if there
-	 * are any space left, create a new entry, and insert it in
-	 * the front of the chain.
+	 * Probe the groups of slots from the one of the hash key. Within a
+	 * group, only the slots whose control byte and hash key match are
+	 * compared with the input. The first group with an empty slot ends
+	 * the probe, and the entry goes to that slot if it is not found.
 	 */
-	while (entry != NULL)
+	group_mask = hashtable->nslots / HASHAGG_GROUP_WIDTH - 1;
+	group_idx = GROUP_IDX(hashtable, hashkey);
+	while (true)
 	{
-		MemTuple mtup = (MemTuple) entry->tuple_and_aggs;
-		int i;
-		bool match = true;
+		unsigned group_start = group_idx * HASHAGG_GROUP_WIDTH;
+		const uint8 *ctrl = hashtable->ctrl + group_start;
+		uint32 match = match_group_ctrl(ctrl, tag);
+		uint32 empty;
 
-		if (hashkey != entry->hashvalue)
+		while (match != 0)
 		{
-			entry = entry->next;
-			continue;
-		}
-		
-		for (i = 0; match && i < agg->numCols; i++)
-		{
-			AttrNumber	att = agg->grpColIdx[i];
-			Datum input_datum = 0;
-			Datum entry_datum = 0;
-			bool input_isNull = false;
-			bool entry_isNull = false;
-				
-			switch(input_type)
+			slot_idx = group_start + first_group_slot(match);
+			match &= match - 1;
+
+			if (hashtable->slot_hashes[slot_idx] == hashkey &&
+				match_group_keys(aggstate, hashtable->slots[slot_idx],
+								 input_record, input_type))
 			{
-				case INPUT_RECORD_TUPLE:
-					input_datum = slot_getattr((TupleTableSlot *)input_record, att, &input_isNull);
-					break;
-				case INPUT_RECORD_GROUP_AND_AGGS:
-					input_datum = memtuple_getattr((MemTuple)input_record, mt_bind, att, &input_isNull);
-					break;
-				default:
-					elog(ERROR, "invalid record type %d", input_type);
+				entry = hashtable->slots[slot_idx];
+				break;
 			}
+		}
 
-			entry_datum = memtuple_getattr(mtup, mt_bind, att, &entry_isNull);
+		if (entry != NULL)
+			break;
 
-			if ( !input_isNull && !entry_isNull &&
-				 (DatumGetBool(FunctionCall2(&aggstate->eqfunctions[i],
-											 input_datum,
-											 entry_datum)) ) )
-				continue; /* Both non-NULL and equal. */
-			match = (input_isNull && entry_isNull);/* NULLs match in group keys. */
-		}
-		
-		/* Break if found an existing matching entry. */
-		if (match)
+		empty = match_group_ctrl(ctrl, HASHAGG_CTRL_EMPTY);
+		if (empty != 0)
+		{
+			slot_idx = group_start + first_group_slot(empty);
 			break;
+		}
 
-		entry = entry->next;
+		group_idx = (group_idx + 1) & group_mask;
 	}
 
 	if (entry == NULL)
 	{
-		/* Entry not found! Create a new matching entry. */
+		/* Entry not found! Make room for it, if there is none left. */
+		if (hashtable->num_entries >= HASHAGG_MAX_ENTRIES(hashtable->nslots))
+		{
+			if (hashtable->expandable)
+				expand_hash_table(aggstate);
+
+			if (hashtable->num_entries >= HASHAGG_MAX_ENTRIES(hashtable->nslots))
+			{
+				/* no matching entry, and no room to create one. */
+				(void) MemoryContextSwitchTo(oldcxt);
+				return NULL;
+			}
+
+			/* The slots have been rehashed; find the empty slot again */
+			slot_idx = find_empty_slot(hashtable, hashkey);
+		}
+
+		/* Create a new matching entry. */
 		switch(input_type)
 		{
 			case INPUT_RECORD_TUPLE:
@@ -557,18 +700,11 @@ lookup_agg_hash_entry(AggState *aggstate,
 			
 		if (entry != NULL)
 		{
-			if (hashtable->expandable &&
-					hashtable->num_entries >= (hashtable->nbuckets * gp_hashagg_groups_per_bucket))
-			{
-				/* The hashtable is denser than envisioned; increase the number of buckets */
-				expand_hash_table(aggstate);
-				/* Recompute bucket_idx in case nbuckets changed */
-				bucket_idx = BUCKET_IDX(hashtable, hashkey);
-			}
+			Assert(hashtable->ctrl[slot_idx] == HASHAGG_CTRL_EMPTY);
 
-			entry->next = hashtable->buckets[bucket_idx];
-			hashtable->buckets[bucket_idx] = entry;
-			hashtable->bloom[bucket_idx] |= bloomval;
+			hashtable->ctrl[slot_idx] = tag;
+			hashtable->slot_hashes[slot_idx] = hashkey;
+			hashtable->slots[slot_idx] = entry;
 			
 			++hashtable->num_ht_groups;
 			++hashtable->num_entries;
@@ -614,16 +750,16 @@ calcHashAggTableSizes(double memquota,	/* Memory quota in bytes. */
 					  bool force,      /* true => succeed even if work_mem too small */
 					  HashAggTableSizes   *out_hats)
 {
-	double entrysize, nbuckets, nentries;
+	double entrysize, nslots, nentries;
 
 	/* Assume we don't need to spill */
 	bool expectSpill = false;
-	double nbatches = 0, batchfile_mem = 0, entries_mem = 0, buckets_mem = 0;
+	double nbatches = 0, batchfile_mem = 0, entries_mem = 0, slots_mem = 0;
 
 	Assert(ngroups >= 0);
 
 	/* Estimate the overhead per entry in the hash table */
-	entrysize = entrywidth + OVERHEAD_PER_BUCKET / (double) gp_hashagg_groups_per_bucket;
+	entrysize = entrywidth + OVERHEAD_PER_SLOT / HASHAGG_MAX_FILL;
 
 	elog(HHA_MSG_LVL, "HashAgg: ngroups = %g, memquota = %g, entrysize = %g",
 		 ngroups, memquota, entrysize);
@@ -670,53 +806,47 @@ calcHashAggTableSizes(double memquota,	/* Memory quota in bytes. */
 	 */
 	if ((memquota - entries_mem) <= 0)
 	{
-		elog(HHA_MSG_LVL, "HashAgg: not enough memory for the overhead of buckets.");
+		elog(HHA_MSG_LVL, "HashAgg: not enough memory for the overhead of slots.");
 		return false;
 	}
 
 	memquota -= entries_mem;
 
-	/* Determine the number of buckets */
-	nbuckets = ceil(nentries / gp_hashagg_groups_per_bucket);
+	/* Determine the number of slots to hold the entries at the maximum fill */
+	nslots = ceil(nentries / HASHAGG_MAX_FILL);
 
 	/* Use only as many allowed by memory */
-	nbuckets = Min(nbuckets, floor(memquota / OVERHEAD_PER_BUCKET));
+	nslots = Min(nslots, floor(memquota / OVERHEAD_PER_SLOT));
 
-	/* Set nbuckets to the next power of 2. */
-	nbuckets = (((unsigned)1) << ((unsigned) LOG2(nbuckets)));
+	/* Set nslots to the next power of 2. */
+	nslots = (((unsigned)1) << ((unsigned) LOG2(nslots)));
 
-	if ((nbuckets * OVERHEAD_PER_BUCKET) > memquota)
+	if ((nslots * OVERHEAD_PER_SLOT) > memquota)
 	{
 		/*
-		 * If the current nentries and nbuckets will make us go OOM, nbuckets was
-		 * rounded up too high. Reduce the nbuckets to a lower power of 2
+		 * If the current nentries and nslots will make us go OOM, nslots was
+		 * rounded up too high. Reduce the nslots to a lower power of 2
 		 */
-		nbuckets = nbuckets / 2;
+		nslots = nslots / 2;
 	}
 
-	/*
-	 * Always set nbuckets greater than gp_hashagg_default_nbatches since
-	 * the spilling relies on this fact to choose which files to spill
-	 * groups to.
-	 * Note: gp_hashagg_default_nbatches must be a power of two
-	 */
-	nbuckets = Max(nbuckets, gp_hashagg_default_nbatches);
-	buckets_mem = nbuckets * OVERHEAD_PER_BUCKET;
+	/* The slots are probed in whole groups */
+	nslots = Max(nslots, HASHAGG_GROUP_WIDTH);
+	slots_mem = nslots * OVERHEAD_PER_SLOT;
 
 	/* Reserve memory for the entries + hash table */
-	memquota -= buckets_mem;
+	memquota -= slots_mem;
 
 	if (memquota < 0)
 	{
 		elog(HHA_MSG_LVL, "HashAgg: not enough memory for the hash table parameters chosen:");
-		elog(HHA_MSG_LVL, "HashAgg: nbuckets = %d, nentries = %d, nbatches = %d",
-			 (int)nbuckets, (int)nentries, (int)nbatches);
-		elog(HHA_MSG_LVL, "HashAgg: ngroups = %d, gp_hashagg_groups_per_bucket = %d",
-			 (int)ngroups, (int)gp_hashagg_groups_per_bucket);
+		elog(HHA_MSG_LVL, "HashAgg: nslots = %d, nentries = %d, nbatches = %d",
+			 (int)nslots, (int)nentries, (int)nbatches);
+		elog(HHA_MSG_LVL, "HashAgg: ngroups = %d", (int)ngroups);
 		return false;
 	}
 
-	if (nbatches > UINT_MAX || nentries > UINT_MAX || nbuckets > UINT_MAX)
+	if (nbatches > UINT_MAX || nentries > UINT_MAX || nslots > UINT_MAX)
 	{
 		if (force)
 		{
@@ -731,7 +861,7 @@ calcHashAggTableSizes(double memquota,	/* Memory quota in bytes. */
 
 	if (out_hats)
 	{
-		out_hats->nbuckets = (unsigned)nbuckets;
+		out_hats->nslots = (unsigned)nslots;
 		out_hats->nentries = (unsigned)nentries;
 		out_hats->nbatches = (unsigned)nbatches;
 		out_hats->hashentry_width = entrywidth;
@@ -740,10 +870,10 @@ calcHashAggTableSizes(double memquota,	/* Memory quota in bytes. */
 		out_hats->workmem_per_entry = (unsigned) entrysize;
 	}
 	
-	elog(HHA_MSG_LVL, "HashAgg: nbuckets = %d, nentries = %d, nbatches = %d",
-		 (int)nbuckets, (int)nentries, (int)nbatches);
+	elog(HHA_MSG_LVL, "HashAgg: nslots = %d, nentries = %d, nbatches = %d",
+		 (int)nslots, (int)nentries, (int)nbatches);
 	elog(HHA_MSG_LVL, "HashAgg: expected memory footprint = %d",
-		(int)(batchfile_mem + buckets_mem + entries_mem));
+		(int)(batchfile_mem + slots_mem + entries_mem));
 	
 	return true;
 }
@@ -798,6 +928,40 @@ static Size est_hash_tuple_size(TupleTableSlot *hashslot, List *hash_needed)
 	return len;
 }
 
+/* Function: alloc_agg_hash_slots
+ *
+ * Allocate nslots empty slots for the hash table in the given memory
+ * context. The caller accounts for their memory.
+ */
+static void
+alloc_agg_hash_slots(HashAggTable *hashtable, MemoryContext cxt, unsigned nslots)
+{
+	Assert(nslots >= HASHAGG_GROUP_WIDTH && (nslots & (nslots - 1)) == 0);
+
+	hashtable->nslots = nslots;
+	hashtable->ctrl = (uint8 *) MemoryContextAlloc(cxt, nslots * sizeof(uint8));
+	hashtable->slot_hashes = (HashKey *) MemoryContextAlloc(cxt, nslots * sizeof(HashKey));
+	hashtable->slots = (HashAggEntry **) MemoryContextAlloc(cxt, nslots * sizeof(HashAggEntry *));
+
+	memset(hashtable->ctrl, HASHAGG_CTRL_EMPTY, nslots * sizeof(uint8));
+}
+
+/* Function: free_agg_hash_slots
+ *
+ * Free the slots of the hash table.
+ */
+static void
+free_agg_hash_slots(HashAggTable *hashtable)
+{
+	pfree(hashtable->ctrl);
+	pfree(hashtable->slot_hashes);
+	pfree(hashtable->slots);
+
+	hashtable->ctrl = NULL;
+	hashtable->slot_hashes = NULL;
+	hashtable->slots = NULL;
+}
+
 /* Function: create_agg_hash_table
  *
  * Creates and initializes a hash table for the given AggState.  Should be
@@ -805,7 +969,7 @@ static Size est_hash_tuple_size(TupleTableSlot *hashslot, List *hash_needed)
  * should be installed in the AggState.
  *
  * The main control structure for the hash table is allocated in the memory
- * context aggstate->aggcontext as is the bucket array, the hashtable and the items related
+ * context aggstate->aggcontext as are the slot arrays, the hashtable and the items related
  * to overflow files.  
  */
 HashAggTable *
@@ -848,10 +1012,8 @@ create_agg_hash_table(AggState *aggstate)
 		elog(ERROR, ERRMSG_GP_INSUFFICIENT_STATEMENT_MEMORY);
 	}
 
-	/* Initialize the hash buckets */
-	hashtable->nbuckets = hashtable->hats.nbuckets;
-	hashtable->buckets = (HashAggBucket *) palloc0(hashtable->nbuckets * sizeof(HashAggBucket));
-	hashtable->bloom = (uint64 *) palloc0(hashtable->nbuckets * sizeof(uint64));
+	/* Initialize the hash slots */
+	alloc_agg_hash_slots(hashtable, aggstate->aggcontext, hashtable->hats.nslots);
 
 	hashtable->pshift = 0;
 	hashtable->expandable = true;
@@ -873,7 +1035,7 @@ create_agg_hash_table(AggState *aggstate)
 
 	hashtable->max_mem = 1024.0 * operatorMemKB;
 	hashtable->mem_for_metadata = sizeof(HashAggTable) +
-			hashtable->nbuckets * OVERHEAD_PER_BUCKET +
+			hashtable->nslots * OVERHEAD_PER_SLOT +
 			sizeof(GroupKeysAndAggs);
 	hashtable->mem_wanted = hashtable->mem_for_metadata;
 	hashtable->mem_used = hashtable->mem_for_metadata;
@@ -1342,11 +1504,11 @@ obtain_spill_set(HashAggTable *hashtable)
 /* Spill all entries from the hash table to file in order to make room
  * for new hash entries.
  *
- * We want to maximize the sequential writes to each spill file. Since
- * the number of buckets and the number of batches (#batches) are the power of 2,
- * We simply write bucket 0, #batches, 2 * #batches, ... to the batch 0;
- * write bucket 1, (#batches + 1), (2 * #batches + 1), ... to the batch 1;
- * and etc.
+ * The spill file of an entry is selected by the bits of its hash key
+ * above those already used by the batch being processed. All the spill
+ * files are opened first, and the slots are then scanned once, writing
+ * each entry to its file; the files are buffered, so each of them is
+ * still written sequentially.
  */
 static void
 spill_hash_table(AggState *aggstate)
@@ -1355,7 +1517,8 @@ spill_hash_table(AggState *aggstate)
 	elog(HHA_MSG_LVL, "Spilling hash table at %ld entries", hashtable->num_entries);
 	SpillSet *spill_set;
 	SpillFile *spill_file;
-	int bucket_no;
+	unsigned slot_idx;
+	unsigned batch_hash_bit;
 	int file_no;
 	MemoryContext oldcxt;
 	uint64 old_num_spill_groups = hashtable->num_spill_groups;
@@ -1374,10 +1537,8 @@ spill_hash_table(AggState *aggstate)
 	/* Book keeping. */
 	hashtable->is_spilling = true;
 
-	Assert(hashtable->nbuckets >= spill_set->num_spill_files);
-
 	/*
-	 * Write each spill file. Write the last spill file first, since it will
+	 * Open each spill file. Open the last spill file first, since it will
 	 * be processed the last.
 	 */
 	for (file_no = spill_set->num_spill_files - 1; file_no >= 0; file_no--)
@@ -1406,38 +1567,38 @@ spill_hash_table(AggState *aggstate)
 			
 			CheckSendPlanStateGpmonPkt(&aggstate->ss.ps);
 		}
+	}
 
-		for (bucket_no = file_no; bucket_no < hashtable->nbuckets;
-			 bucket_no += spill_set->num_spill_files)
-		{
-			HashAggEntry *entry = hashtable->buckets[bucket_no];
-			
-			/* Ignore empty chains. */
-			if (entry == NULL) continue;
-			
-			/* Write all entries in the hash chain. */
-			while ( entry  != NULL )
-			{
-				HashAggEntry *spill_entry = entry;
-				entry = spill_entry->next;
-
-				if (spill_entry != NULL)
-				{
-					int32 written_bytes;
-					
-					written_bytes = writeHashEntry(aggstate, spill_file->file_info, spill_entry);
-					spill_file->file_info->ntuples++;
-					spill_file->file_info->total_bytes += written_bytes;
-
-					hashtable->num_spill_groups++;
-				}
-			}
+	/*
+	 * Write the entries of all the slots. The spill set was created for the
+	 * batch being processed, so its hash bit is the shift of the slots.
+	 */
+	batch_hash_bit = spill_set->spill_files[0].batch_hash_bit;
+	Assert(batch_hash_bit == hashtable->pshift);
 
-			hashtable->buckets[bucket_no] = NULL;
-			hashtable->bloom[bucket_no] = 0;
-		}
+	for (slot_idx = 0; slot_idx < hashtable->nslots; slot_idx++)
+	{
+		HashAggEntry *spill_entry;
+		int32 written_bytes;
+
+		/* Ignore empty slots. */
+		if (hashtable->ctrl[slot_idx] == HASHAGG_CTRL_EMPTY)
+			continue;
+
+		spill_entry = hashtable->slots[slot_idx];
+		file_no = (hashtable->slot_hashes[slot_idx] >> batch_hash_bit) &
+			(spill_set->num_spill_files - 1);
+		spill_file = &spill_set->spill_files[file_no];
+
+		written_bytes = writeHashEntry(aggstate, spill_file->file_info, spill_entry);
+		spill_file->file_info->ntuples++;
+		spill_file->file_info->total_bytes += written_bytes;
+
+		hashtable->num_spill_groups++;
 	}
 
+	memset(hashtable->ctrl, HASHAGG_CTRL_EMPTY, hashtable->nslots * sizeof(uint8));
+
 	/* Reset the buffer */
 	mpool_reset(hashtable->group_buf);
 
@@ -1453,13 +1614,18 @@ spill_hash_table(AggState *aggstate)
 	MemoryContextSwitchTo(oldcxt);
 }
 
+/* Double the number of slots of the hash table, and rehash its entries.
+ *
+ * The hash keys are kept in the slots, so the entries themselves are not
+ * visited.
+ */
 static void
 expand_hash_table(AggState *aggstate)
 {
-	unsigned mem_needed, old_nbuckets, bucket_idx, new_bucket_idx;
-	uint32 hashkey;
-	uint64 bloomval;
-	HashAggEntry *entry, *nextentry;
+	unsigned mem_needed, old_nslots, slot_idx;
+	uint8 *old_ctrl;
+	HashKey *old_slot_hashes;
+	HashAggEntry **old_slots;
 	HashAggTable *hashtable = aggstate->hhashtable;
 
 #ifdef USE_ASSERT_CHECKING
@@ -1467,68 +1633,56 @@ expand_hash_table(AggState *aggstate)
 #endif
 
 	Assert(hashtable);
-	old_nbuckets = hashtable->nbuckets;
+	old_nslots = hashtable->nslots;
 
-	/* Make sure there is memory available for additional buckets */
-	mem_needed = old_nbuckets * OVERHEAD_PER_BUCKET;
-	if (mem_needed > AVAIL_MEM(hashtable) || hashtable->nbuckets > (UINT_MAX / 2))
+	/* Make sure there is memory available for additional slots */
+	mem_needed = old_nslots * OVERHEAD_PER_SLOT;
+	if (mem_needed > AVAIL_MEM(hashtable) || hashtable->nslots > (UINT_MAX / 2) ||
+		(Size) hashtable->nslots * 2 > MaxAllocSize / sizeof(HashAggEntry *))
 	{
-		/* Cannot double the buckets if there is not enough space */
-		elog(HHA_MSG_LVL, "HashAgg: cannot grow the number of buckets!");
-		elog(HHA_MSG_LVL, "HashAgg: mem needed = %d available = %d; nbuckets = %d",
-				mem_needed, (unsigned) AVAIL_MEM(hashtable), hashtable->nbuckets);
+		/* Cannot double the slots if there is not enough space */
+		elog(HHA_MSG_LVL, "HashAgg: cannot grow the number of slots!");
+		elog(HHA_MSG_LVL, "HashAgg: mem needed = %d available = %d; nslots = %d",
+				mem_needed, (unsigned) AVAIL_MEM(hashtable), hashtable->nslots);
 		hashtable->expandable = false;
 		return;
 	}
-	elog(HHA_MSG_LVL, "Growing the hash table to %d buckets with %ld entries",
-			hashtable->nbuckets * 2, hashtable->num_entries);
-
-	Assert(hashtable->nbuckets > 1);
+	elog(HHA_MSG_LVL, "Growing the hash table to %d slots with %ld entries",
+			hashtable->nslots * 2, hashtable->num_entries);
 
 	/* OK, do it */
 
-	hashtable->nbuckets = hashtable->nbuckets * 2;
-	hashtable->mem_for_metadata += old_nbuckets * OVERHEAD_PER_BUCKET;
+	old_ctrl = hashtable->ctrl;
+	old_slot_hashes = hashtable->slot_hashes;
+	old_slots = hashtable->slots;
+
+	alloc_agg_hash_slots(hashtable, aggstate->aggcontext, old_nslots * 2);
+	hashtable->mem_for_metadata += old_nslots * OVERHEAD_PER_SLOT;
 	hashtable->mem_wanted = Max(hashtable->mem_wanted, hashtable->mem_for_metadata);
 
 	Assert(GET_TOTAL_USED_SIZE(hashtable) < hashtable->max_mem);
 
-	hashtable->buckets = (HashAggBucket *) repalloc(hashtable->buckets,
-		hashtable->nbuckets * sizeof(HashAggBucket));
-	hashtable->bloom =  (uint64 *) repalloc(hashtable->bloom,
-		hashtable->nbuckets * sizeof(uint64));
-
-	memset(hashtable->bloom, 0, hashtable->nbuckets * sizeof(uint64));
-	memset(hashtable->buckets + old_nbuckets, 0, old_nbuckets * sizeof(HashAggBucket));
-
-	/* Iterate all the entries from the hashtable move them as needed */
-	for(bucket_idx=0; bucket_idx < old_nbuckets; ++bucket_idx)
+	/* Move all the entries to the new slots */
+	for (slot_idx = 0; slot_idx < old_nslots; slot_idx++)
 	{
-		entry = hashtable->buckets[bucket_idx];
-		hashtable->buckets[bucket_idx] = NULL;
+		unsigned new_slot_idx;
 
-		while(entry != NULL)
-		{
-			nextentry = entry->next;
-			hashkey = entry->hashvalue;
-			bloomval = BLOOMVAL(hashkey);
-
-			new_bucket_idx = BUCKET_IDX(hashtable, hashkey);
-
-			Assert(new_bucket_idx == bucket_idx ||
-					new_bucket_idx == bucket_idx + old_nbuckets);
-
-			/* Insert this at the head of the bucket */
-			entry->next = hashtable->buckets[new_bucket_idx];
-			hashtable->buckets[new_bucket_idx] = entry;
-			hashtable->bloom[new_bucket_idx] |= bloomval;
+		if (old_ctrl[slot_idx] == HASHAGG_CTRL_EMPTY)
+			continue;
 
-			entry = nextentry;
+		new_slot_idx = find_empty_slot(hashtable, old_slot_hashes[slot_idx]);
+		hashtable->ctrl[new_slot_idx] = old_ctrl[slot_idx];
+		hashtable->slot_hashes[new_slot_idx] = old_slot_hashes[slot_idx];
+		hashtable->slots[new_slot_idx] = old_slots[slot_idx];
 #ifdef USE_ASSERT_CHECKING
-			++nentries;
+		++nentries;
 #endif
-		}
 	}
+
+	pfree(old_ctrl);
+	pfree(old_slot_hashes);
+	pfree(old_slots);
+
 	hashtable->num_expansions++;
 	Assert(hashtable->mem_for_metadata > 0);
 	Assert(nentries == hashtable->num_entries);
@@ -1685,31 +1839,33 @@ writeHashEntry(AggState *aggstate, BatchFileInfo *file_info,
 
 /*
  * agg_hash_table_stat_upd
- *   Collect buckets and hash chain statistics of the in-memory hash table for
- *   EXPLAIN ANALYZE
+ *   Collect slot and probe length statistics of the in-memory hash table for
+ *   EXPLAIN ANALYZE. The probe length of an entry is the number of groups of
+ *   slots probed to find it.
  */
 static void
 agg_hash_table_stat_upd(HashAggTable *hashtable)
 {
 	unsigned int	i;
+	unsigned int	group_mask = hashtable->nslots / HASHAGG_GROUP_WIDTH - 1;
 
-	for (i = 0; i < hashtable->nbuckets; i++)
+	for (i = 0; i < hashtable->nslots; i++)
 	{
-		HashAggEntry   *entry = hashtable->buckets[i];
-		int             chainlength = 0;
+		unsigned int	home_group;
+		unsigned int	probelength;
 
-		if (entry)
-		{
-			for (chainlength = 0; entry; chainlength++)
-				entry = entry->next;
-			cdbexplain_agg_upd(&hashtable->chainlength, chainlength, i);
-		}
+		if (hashtable->ctrl[i] == HASHAGG_CTRL_EMPTY)
+			continue;
+
+		home_group = GROUP_IDX(hashtable, hashtable->slot_hashes[i]);
+		probelength = ((i / HASHAGG_GROUP_WIDTH - home_group) & group_mask) + 1;
+		cdbexplain_agg_upd(&hashtable->probelength, probelength, i);
 	}
 
-	hashtable->total_buckets += hashtable->nbuckets;
+	hashtable->total_slots += hashtable->nslots;
 
-	/* Cannot use more buckets than have been created */
-	Assert(hashtable->chainlength.vcnt <= hashtable->total_buckets);
+	/* Cannot use more slots than have been created */
+	Assert(hashtable->probelength.vcnt <= hashtable->total_slots);
 }
 
 /* Function: init_agg_hash_iter
@@ -1717,10 +1873,9 @@ agg_hash_table_stat_upd(HashAggTable *hashtable)
  * Initialize the HashAggTable's (one and only) entry iterator. */
 void init_agg_hash_iter(HashAggTable* hashtable)
 {
-	Assert( hashtable != NULL && hashtable->buckets != NULL && hashtable->nbuckets > 0 );
+	Assert( hashtable != NULL && hashtable->ctrl != NULL && hashtable->nslots > 0 );
 	
-	hashtable->curr_bucket_idx = -1;
-	hashtable->next_entry = NULL;
+	hashtable->curr_slot_idx = -1;
 }
 
 /* Function: agg_hash_iter
@@ -1736,34 +1891,29 @@ HashAggEntry *
 agg_hash_iter(AggState *aggstate)
 {
 	HashAggTable* hashtable = aggstate->hhashtable;
-	HashAggEntry *entry = hashtable->next_entry;
+	HashAggEntry *entry = NULL;
 	SpillSet *spill_set = hashtable->spill_set;
 	MemoryContext oldcxt;
 
-	Assert( hashtable != NULL && hashtable->buckets != NULL && hashtable->nbuckets > 0 );
+	Assert( hashtable != NULL && hashtable->ctrl != NULL && hashtable->nslots > 0 );
 
 	if (hashtable->curr_spill_file != NULL)
 		spill_set = hashtable->curr_spill_file->spill_set;
 	
 	oldcxt = MemoryContextSwitchTo(hashtable->entry_cxt);
 
-	while (entry == NULL &&
-		   hashtable->nbuckets > ++ hashtable->curr_bucket_idx)
+	while (hashtable->nslots > ++ hashtable->curr_slot_idx)
 	{
-		entry = hashtable->buckets[hashtable->curr_bucket_idx];
-		if (entry != NULL)
+		if (hashtable->ctrl[hashtable->curr_slot_idx] != HASHAGG_CTRL_EMPTY)
 		{
+			entry = hashtable->slots[hashtable->curr_slot_idx];
 			Assert(entry->is_primodial);
 			break;
 		}
 	}
 
 	if (entry != NULL)
-	{
 		hashtable->num_output_groups++;
-		hashtable->next_entry = entry->next;
-		entry->next = NULL;
-	}
 
 	MemoryContextSwitchTo(oldcxt);
 
@@ -1838,7 +1988,7 @@ agg_hash_stream(AggState *aggstate)
 	elog(HHA_MSG_LVL,
 		"HashAgg: streaming");
 
-	reset_agg_hash_table(aggstate, 0 /* don't reallocate buckets */);
+	reset_agg_hash_table(aggstate, 0 /* don't reallocate slots */);
 	
 	return agg_hash_initial_pass(aggstate);
 }
@@ -2265,17 +2415,17 @@ agg_hash_explain(AggState *aggstate)
 		appendStringInfo(hbuf, ".\n");
 	}
 
-	/* Hash chain statistics */
-	if (hashtable->chainlength.vcnt > 0)
+	/* Hash probe statistics */
+	if (hashtable->probelength.vcnt > 0)
 	{
 		appendStringInfo(hbuf,
-				"Hash chain length %.1f avg, %.0f max,"
-				" using %d of " INT64_FORMAT " buckets"
+				"Hash probe length %.1f avg, %.0f max,"
+				" using %d of " INT64_FORMAT " slots"
 				"; total %d expansions.\n",
-				cdbexplain_agg_avg(&hashtable->chainlength),
-				hashtable->chainlength.vmax,
-				hashtable->chainlength.vcnt,
-				hashtable->total_buckets,
+				cdbexplain_agg_avg(&hashtable->probelength),
+				hashtable->probelength.vmax,
+				hashtable->probelength.vcnt,
+				hashtable->total_slots,
 				hashtable->num_expansions);
 	}
 }
@@ -2289,70 +2439,61 @@ Gpmon_ResetAggHashTable(AggState* aggstate)
 
 /* Function: reset_agg_hash_table
  *
- * Clear the hash table content anchored by the bucket array.
+ * Clear the hash table content anchored by the slot arrays.
  */
 void reset_agg_hash_table(AggState *aggstate, int64 nentries)
 {
 	HashAggTable *hashtable = aggstate->hhashtable;
-	bool reallocate_buckets = true;
-	double old_nbuckets;
+	bool reallocate_slots = true;
+	double old_nslots;
 	HashAggTableSizes hats;
-	MemoryContext oldcxt;
 	
 	elog(HHA_MSG_LVL,
 		"HashAgg: resetting " INT64_FORMAT "-entry hash table",
 		hashtable->num_ht_groups);
 
-	Assert(hashtable->buckets && hashtable->bloom);
+	Assert(hashtable->ctrl && hashtable->slot_hashes && hashtable->slots);
 
 	/*
-	 * Determine whether to reallocate buckets. Especially avoid re-allocation if
+	 * Determine whether to reallocate slots. Especially avoid re-allocation if
 	 * already the right size
 	 */
-	reallocate_buckets = nentries > 0 &&
+	reallocate_slots = nentries > 0 &&
 		calcHashAggTableSizes(hashtable->max_mem,
 			nentries,
 			hashtable->hats.hashentry_width,
 			true,
 			&hats) &&
-		(hats.nbuckets != hashtable->nbuckets);
+		(hats.nslots != hashtable->nslots);
 
-	if (reallocate_buckets)
+	if (reallocate_slots)
 	{
-		Assert(hats.nbuckets > 0);
-		old_nbuckets = hashtable->nbuckets;
-		oldcxt = MemoryContextSwitchTo(aggstate->aggcontext);
+		Assert(hats.nslots > 0);
+		old_nslots = hashtable->nslots;
 
-		Assert(hashtable->mem_for_metadata > hashtable->nbuckets * OVERHEAD_PER_BUCKET);
+		Assert(hashtable->mem_for_metadata > hashtable->nslots * OVERHEAD_PER_SLOT);
 
-		/* Recalculate memory used with the increase/decrease in nbuckets */
+		/* Recalculate memory used with the increase/decrease in nslots */
 		hashtable->mem_for_metadata +=
-			((hats.nbuckets - old_nbuckets) * OVERHEAD_PER_BUCKET);
-		hashtable->nbuckets = hats.nbuckets;
+			((hats.nslots - old_nslots) * OVERHEAD_PER_SLOT);
 
 		/* Copy relevant stats into the hashtable */
-		hashtable->hats.nbuckets = hats.nbuckets;
+		hashtable->hats.nslots = hats.nslots;
 		hashtable->hats.nentries = hats.nentries;
 
-		pfree(hashtable->buckets);
-		pfree(hashtable->bloom);
-
-		hashtable->buckets = (HashAggBucket *) palloc0(hashtable->nbuckets * sizeof(HashAggBucket));
-		hashtable->bloom = (uint64 *) palloc0(hashtable->nbuckets * sizeof(uint64));
+		free_agg_hash_slots(hashtable);
+		alloc_agg_hash_slots(hashtable, aggstate->aggcontext, hats.nslots);
 
 		hashtable->expandable = true;
 
-		MemoryContextSwitchTo(oldcxt);
-
 		Assert(AVAIL_MEM(hashtable) > 0);
-		elog(HHA_MSG_LVL, "Resetting with %d buckets for %d entries",
-				hashtable->nbuckets, hats.nentries);
+		elog(HHA_MSG_LVL, "Resetting with %d slots for %d entries",
+				hashtable->nslots, hats.nentries);
 	}
 	else
 	{
-		/* No need to reallocated buckets. Reset to zero. */
-		MemSet(hashtable->buckets, 0, hashtable->nbuckets * sizeof(HashAggBucket));
-		MemSet(hashtable->bloom, 0, hashtable->nbuckets * sizeof(uint64));
+		/* No need to reallocated slots. Mark them empty. */
+		memset(hashtable->ctrl, HASHAGG_CTRL_EMPTY, hashtable->nslots * sizeof(uint8));
 	}
 
 	Assert(hashtable->mem_for_metadata > 0);
@@ -2391,8 +2532,7 @@ void destroy_agg_hash_table(AggState *aggstate)
 		Gpmon_ResetAggHashTable(aggstate);
 
 		/* destroy_batches(aggstate->hhashtable); */
-		pfree(aggstate->hhashtable->buckets);
-		pfree(aggstate->hhashtable->bloom);
+		free_agg_hash_slots(aggstate->hhashtable);
 		if (aggstate->hhashtable->hashkey_buf)
 			pfree(aggstate->hhashtable->hashkey_buf);
 
@@ -5436,6 +5436,7 @@ createPartitionAccessMethods(int numLevels)
 	accessMethods->partLevels = numLevels;
 	accessMethods->amstate = palloc0(numLevels * sizeof(void *));
 	accessMethods->part_cxt = NULL;
+	accessMethods->ruleIndexes = NULL;
 
 	return accessMethods;
 }
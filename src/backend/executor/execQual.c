@@ -63,6 +63,7 @@
 #include "pgstat.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
+#include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/memutils.h"
 #include "utils/typcache.h"
@@ -769,23 +770,17 @@ ExecEvalScalarVar(ExprState *exprstate, ExprContext *econtext,
 	return slot_getattr(slot, attnum, isNull);
 }
 
-/* ----------------------------------------------------------------
- *		ExecEvalScalarVarFast
- *
- *		Returns a Datum for a scalar variable.
- * ----------------------------------------------------------------
+/*
+ * Fetch the value of a scalar variable whose type has already been checked,
+ * see ExecEvalScalarVar.  Shared by ExecEvalScalarVarFast and the argument
+ * evaluation of the fast-pathed functions.
  */
-static Datum
-ExecEvalScalarVarFast(ExprState *exprstate, ExprContext *econtext,
-					  bool *isNull, ExprDoneCond *isDone)
+static inline Datum
+ExecFetchScalarVar(Var *variable, ExprContext *econtext, bool *isNull)
 {
-	Var		   *variable = (Var *) exprstate->expr;
 	TupleTableSlot *slot;
 	AttrNumber	attnum;
 
-	if (isDone)
-		*isDone = ExprSingleResult;
-
 	/* Get the input slot and attribute number we want */
 	switch (variable->varno)
 	{
@@ -811,6 +806,22 @@ ExecEvalScalarVarFast(ExprState *exprstate, ExprContext *econtext,
 	return slot_getattr(slot, attnum, isNull);
 }
 
+/* ----------------------------------------------------------------
+ *		ExecEvalScalarVarFast
+ *
+ *		Returns a Datum for a scalar variable.
+ * ----------------------------------------------------------------
+ */
+static Datum
+ExecEvalScalarVarFast(ExprState *exprstate, ExprContext *econtext,
+					  bool *isNull, ExprDoneCond *isDone)
+{
+	if (isDone)
+		*isDone = ExprSingleResult;
+
+	return ExecFetchScalarVar((Var *) exprstate->expr, econtext, isNull);
+}
+
 /* ----------------------------------------------------------------
  *		ExecEvalWholeRowVar
  *
@@ -2807,43 +2818,73 @@ ExecEvalDistinct(FuncExprState *fcache,
 	return result;
 }
 
-static inline void ExecEvalFPStrict2Arg(FuncExprState *expr, ExprContext *econtext, bool *isNull, ExprDoneCond *isDone)
+/*
+ * Evaluate one argument of a fast-pathed function.  Plain Vars and Consts,
+ * which are by far the most common arguments, are evaluated right here,
+ * saving the indirect call through their evalfunc.
+ */
+static inline Datum ExecEvalFPArg(ExprState *arg, ExprContext *econtext, bool *isNull)
 {
-	ExprDoneCond argDone[2];
+	ExprDoneCond argDone;
 
-	Assert(expr->fp_arg[0] && expr->fp_arg[1]);
-	if(isDone)
-		*isDone = ExprSingleResult;
+	if (arg->evalfunc == ExecEvalScalarVarFast)
+		return ExecFetchScalarVar((Var *) arg->expr, econtext, isNull);
+	else if (arg->evalfunc == ExecEvalConst)
+	{
+		Const	   *con = (Const *) arg->expr;
 
-	expr->fp_datum[0] = ExecEvalExpr(expr->fp_arg[0], econtext, &expr->fp_null[0], &argDone[0]);
-	expr->fp_datum[1] = ExecEvalExpr(expr->fp_arg[1], econtext, &expr->fp_null[1], &argDone[1]);
+		*isNull = con->constisnull;
+		return con->constvalue;
+	}
 
-	*isNull = expr->fp_null[0] || expr->fp_null[1];
+	return ExecEvalExpr(arg, econtext, isNull, &argDone);
 }
 
-static Datum ExecEvalFPStrict2_Int2Eq(FuncExprState *fstate, ExprContext *ctxt, bool *isNull, ExprDoneCond *isDone)
+static inline void ExecEvalFPStrict2Arg(FuncExprState *expr, ExprContext *econtext, bool *isNull, ExprDoneCond *isDone)
 {
-	ExecEvalFPStrict2Arg(fstate, ctxt, isNull, isDone);
-	return BoolGetDatum(
-			DatumGetInt16(fstate->fp_datum[0]) == DatumGetInt16(fstate->fp_datum[1])
-			);
-}
+	Assert(expr->fp_arg[0] && expr->fp_arg[1]);
+	if(isDone)
+		*isDone = ExprSingleResult;
 
-static Datum ExecEvalFPStrict2_Int4Eq(FuncExprState *fstate, ExprContext *ctxt, bool *isNull, ExprDoneCond *isDone)
-{
+	expr->fp_datum[0] = ExecEvalFPArg(expr->fp_arg[0], econtext, &expr->fp_null[0]);
+	expr->fp_datum[1] = ExecEvalFPArg(expr->fp_arg[1], econtext, &expr->fp_null[1]);
 
-	ExecEvalFPStrict2Arg(fstate, ctxt, isNull, isDone);
-	return BoolGetDatum(
-			DatumGetInt32(fstate->fp_datum[0]) == DatumGetInt32(fstate->fp_datum[1])
-			);
+	*isNull = expr->fp_null[0] || expr->fp_null[1];
 }
 
-static Datum ExecEvalFPStrict2_Int8Eq(FuncExprState *fstate, ExprContext *ctxt, bool *isNull, ExprDoneCond *isDone)
-{
-	ExecEvalFPStrict2Arg(fstate, ctxt, isNull, isDone);
-	return BoolGetDatum(fstate->fp_datum[0] == fstate->fp_datum[1]);
+/*
+ * The fast-pathed comparison functions.  Each one is the same as the fmgr
+ * function it replaces, e.g. ExecEvalFPStrict2_Int48Lt does what int48lt
+ * does.  The argument datums are only looked at when neither is NULL, as
+ * int8 may be pass-by-reference.
+ */
+#define FP_STRICT2_CMP(name, get0, get1, op) \
+static Datum ExecEvalFPStrict2_##name(FuncExprState *fstate, ExprContext *ctxt, bool *isNull, ExprDoneCond *isDone) \
+{ \
+	ExecEvalFPStrict2Arg(fstate, ctxt, isNull, isDone); \
+	if (*isNull) \
+		return BoolGetDatum(false); \
+	return BoolGetDatum(get0(fstate->fp_datum[0]) op get1(fstate->fp_datum[1])); \
 }
 
+#define FP_STRICT2_CMPS(name, get0, get1) \
+	FP_STRICT2_CMP(name##Eq, get0, get1, ==) \
+	FP_STRICT2_CMP(name##Ne, get0, get1, !=) \
+	FP_STRICT2_CMP(name##Lt, get0, get1, <) \
+	FP_STRICT2_CMP(name##Le, get0, get1, <=) \
+	FP_STRICT2_CMP(name##Gt, get0, get1, >) \
+	FP_STRICT2_CMP(name##Ge, get0, get1, >=)
+
+FP_STRICT2_CMPS(Int2, DatumGetInt16, DatumGetInt16)
+FP_STRICT2_CMPS(Int4, DatumGetInt32, DatumGetInt32)
+FP_STRICT2_CMPS(Int8, DatumGetInt64, DatumGetInt64)
+FP_STRICT2_CMPS(Int24, DatumGetInt16, DatumGetInt32)
+FP_STRICT2_CMPS(Int42, DatumGetInt32, DatumGetInt16)
+FP_STRICT2_CMPS(Int48, DatumGetInt32, DatumGetInt64)
+FP_STRICT2_CMPS(Int84, DatumGetInt64, DatumGetInt32)
+FP_STRICT2_CMPS(Int28, DatumGetInt16, DatumGetInt64)
+FP_STRICT2_CMPS(Int82, DatumGetInt64, DatumGetInt16)
+
 /* Some Oids that we want to fast path.  See pg_proc.h */
 #define INT2EQ_OID 63
 #define INT4EQ_OID 65
@@ -2858,31 +2899,53 @@ static Datum ExecEvalFPStrict2_Int8Eq(FuncExprState *fstate, ExprContext *ctxt,
  * NOTE: You need to implement the ExecEvalFPStrict2_FUNC FAITHFULLY.
  * For example, before you fast path int4add, make sure your implementation
  * is the same as the old int4add, that is, you need to handle under/over flow etc.
+ *
+ * Arguments that return sets are left to the regular path, as ExecEvalFPArg
+ * evaluates each argument only once per call and drops its isDone.
  */
-static void FastPathStrict2Func(Oid funcoid, FuncExprState *fstate)
+static void FastPathStrict2Func(Oid funcoid, List *args, FuncExprState *fstate)
 {
-	static Oid strict2oid[] = {
-		INT2EQ_OID,
-		INT4EQ_OID,
-		DATE_EQ_OID,
-		INT8EQ_OID,
-	};
-	static ExprStateEvalFunc strict2func[] = {
-		(ExprStateEvalFunc) ExecEvalFPStrict2_Int2Eq,
-		(ExprStateEvalFunc) ExecEvalFPStrict2_Int4Eq,
-		(ExprStateEvalFunc) ExecEvalFPStrict2_Int4Eq, /* date_eq is int4 eq */
-		(ExprStateEvalFunc) ExecEvalFPStrict2_Int8Eq,
+#define FP_STRICT2_ENTRY(oid, name) \
+	{ oid, (ExprStateEvalFunc) ExecEvalFPStrict2_##name }
+#define FP_STRICT2_ENTRIES(eq, ne, lt, le, gt, ge, name) \
+	FP_STRICT2_ENTRY(eq, name##Eq), \
+	FP_STRICT2_ENTRY(ne, name##Ne), \
+	FP_STRICT2_ENTRY(lt, name##Lt), \
+	FP_STRICT2_ENTRY(le, name##Le), \
+	FP_STRICT2_ENTRY(gt, name##Gt), \
+	FP_STRICT2_ENTRY(ge, name##Ge)
+
+	static const struct
+	{
+		Oid			funcoid;
+		ExprStateEvalFunc evalfunc;
+	}			strict2[] = {
+		FP_STRICT2_ENTRIES(F_INT2EQ, F_INT2NE, F_INT2LT, F_INT2LE, F_INT2GT, F_INT2GE, Int2),
+		FP_STRICT2_ENTRIES(F_INT4EQ, F_INT4NE, F_INT4LT, F_INT4LE, F_INT4GT, F_INT4GE, Int4),
+		FP_STRICT2_ENTRIES(F_INT8EQ, F_INT8NE, F_INT8LT, F_INT8LE, F_INT8GT, F_INT8GE, Int8),
+		/* date is an int32 day number, and compares like one */
+		FP_STRICT2_ENTRIES(F_DATE_EQ, F_DATE_NE, F_DATE_LT, F_DATE_LE, F_DATE_GT, F_DATE_GE, Int4),
+		FP_STRICT2_ENTRIES(F_INT24EQ, F_INT24NE, F_INT24LT, F_INT24LE, F_INT24GT, F_INT24GE, Int24),
+		FP_STRICT2_ENTRIES(F_INT42EQ, F_INT42NE, F_INT42LT, F_INT42LE, F_INT42GT, F_INT42GE, Int42),
+		FP_STRICT2_ENTRIES(F_INT48EQ, F_INT48NE, F_INT48LT, F_INT48LE, F_INT48GT, F_INT48GE, Int48),
+		FP_STRICT2_ENTRIES(F_INT84EQ, F_INT84NE, F_INT84LT, F_INT84LE, F_INT84GT, F_INT84GE, Int84),
+		FP_STRICT2_ENTRIES(F_INT28EQ, F_INT28NE, F_INT28LT, F_INT28LE, F_INT28GT, F_INT28GE, Int28),
+		FP_STRICT2_ENTRIES(F_INT82EQ, F_INT82NE, F_INT82LT, F_INT82LE, F_INT82GT, F_INT82GE, Int82),
 	};
 
+#undef FP_STRICT2_ENTRIES
+#undef FP_STRICT2_ENTRY
+
 	int i;
 
-	COMPILE_ASSERT(ARRAY_SIZE(strict2oid) == ARRAY_SIZE(strict2func));
+	if (list_length(args) != 2 || expression_returns_set((Node *) args))
+		return;
 
-	for(i=0; i<ARRAY_SIZE(strict2oid); ++i)
+	for(i=0; i<ARRAY_SIZE(strict2); ++i)
 	{
-		if (strict2oid[i] == funcoid)
+		if (strict2[i].funcoid == funcoid)
 		{
-			fstate->xprstate.evalfunc = strict2func[i];
+			fstate->xprstate.evalfunc = strict2[i].evalfunc;
 			fstate->fp_arg[0] = linitial(fstate->args);
 			fstate->fp_arg[1] = lsecond(fstate->args);
 			return;
@@ -5626,7 +5689,7 @@ ExecInitExpr(Expr *node, PlanState *parent)
 				fstate->args = (List *)
 					ExecInitExpr((Expr *) funcexpr->args, parent);
 				fstate->func.fn_oid = InvalidOid;		/* not initialized */
-				FastPathStrict2Func(funcexpr->funcid, fstate);
+				FastPathStrict2Func(funcexpr->funcid, funcexpr->args, fstate);
 				state = (ExprState *) fstate;
 				assign_func_result_transient_type(funcexpr->funcid);
 			}
@@ -5640,7 +5703,7 @@ ExecInitExpr(Expr *node, PlanState *parent)
 				fstate->args = (List *)
 					ExecInitExpr((Expr *) opexpr->args, parent);
 				fstate->func.fn_oid = InvalidOid;		/* not initialized */
-				FastPathStrict2Func(opexpr->opfuncid, fstate);
+				FastPathStrict2Func(opexpr->opfuncid, opexpr->args, fstate);
 				state = (ExprState *) fstate;
 			}
 			break;
@@ -21,6 +21,7 @@
 #include "postgres.h"
 
 #include "executor/executor.h"
+#include "executor/nodeHashjoin.h"
 #include "miscadmin.h"
 #include "utils/faultinjector.h"
 #include "utils/memutils.h"
@@ -126,10 +127,11 @@ ExecScan(ScanState *node,
 	econtext = node->ps.ps_ExprContext;
 
 	/*
-	 * If we have neither a qual to check nor a projection to do, just skip
-	 * all the overhead and return the raw scan tuple.
+	 * If we have neither a qual to check nor a projection to do, nor a
+	 * runtime filter to apply, just skip all the overhead and return the raw
+	 * scan tuple.
 	 */
-	if (!qual && !projInfo)
+	if (!qual && !projInfo && !node->ss_runtimeFilter)
 	{
 		ResetExprContext(econtext);
 		return ExecScanFetch(node, accessMtd, recheckMtd);
@@ -190,18 +192,23 @@ ExecScan(ScanState *node,
 			if (projInfo)
 			{
 				/*
-				 * Form a projection tuple, store it in the result tuple slot
-				 * and return it.
+				 * Form a projection tuple and store it in the result tuple
+				 * slot.  Otherwise, we aren't projecting, so we return the
+				 * scan tuple.
 				 */
-				return ExecProject(projInfo, NULL);
+				slot = ExecProject(projInfo, NULL);
 			}
-			else
-			{
-				/*
-				 * Here, we aren't projecting, so just return scan tuple.
-				 */
+
+			/*
+			 * CDB: Drop the tuple if the runtime filter of the hash join
+			 * above us says that it cannot find a match.  The join evaluates
+			 * its hash keys on our output, so test the projected tuple.
+			 */
+			if (!node->ss_runtimeFilter ||
+				ExecHashJoinRuntimeFilterPass(node->ss_runtimeFilter, slot))
 				return slot;
-			}
+
+			InstrCountFiltered2(node, 1);
 		}
 		else
 			InstrCountFiltered1(node, 1);
@@ -255,6 +255,9 @@ ExecDynamicSeqScan(DynamicSeqScanState *node)
 				break;
 		}
 
+		/* pass down the runtime filter, if the hash join above us made one */
+		node->seqScanState->ss.ss_runtimeFilter = node->ss.ss_runtimeFilter;
+
 		slot = ExecSeqScan(node->seqScanState);
 
 		if (!TupIsNull(slot))
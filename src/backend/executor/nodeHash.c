@@ -34,6 +34,7 @@
 #include "executor/hashjoin.h"
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
+#include "lib/bloomfilter.h"
 #include "miscadmin.h"
 #include "utils/dynahash.h"
 #include "utils/memutils.h"
@@ -46,6 +47,8 @@
 #include "cdb/cdbvars.h"
 
 static void ExecHashIncreaseNumBatches(HashJoinTable hashtable);
+static int ExecHashChooseNumPartitions(double ntuples, int tupwidth,
+							int nbuckets, uint64 operatorMemKB);
 static void ExecHashBuildSkewHash(HashJoinTable hashtable, Hash *node,
 					  int mcvsToUse);
 static void ExecHashSkewTableInsert(HashState *hashState, HashJoinTable hashtable,
@@ -131,6 +134,11 @@ MultiExecHash(HashState *node)
 		{
 			int			bucketNumber;
 
+			/* Remember the hash value for the runtime filter of the join */
+			if (node->hs_bloom)
+				bloom_add_element(node->hs_bloom, (unsigned char *) &hashvalue,
+								  sizeof(hashvalue));
+
 			bucketNumber = ExecHashGetSkewBucket(hashtable, hashvalue);
 			if (bucketNumber != INVALID_SKEW_BUCKET_NO)
 			{
@@ -276,6 +284,8 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 	int			nbatch;
 	int			num_skew_mcvs;
 	int			log2_nbuckets;
+	int			npartitions;
+	bool		batchProbes;
 	int			nkeys;
 	int			i;
 	ListCell   *ho;
@@ -305,6 +315,20 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 	log2_nbuckets = my_log2(nbuckets);
 	Assert(nbuckets == (1 << log2_nbuckets));
 
+	/*
+	 * A table larger than the CPU cache is partitioned, and probed in
+	 * batches of outer tuples whose buckets are prefetched; either can be
+	 * turned off.  See HashProbeBuffer.
+	 */
+	npartitions = ExecHashChooseNumPartitions(outerNode->plan_rows,
+											  outerNode->plan_width,
+											  nbuckets, operatorMemKB);
+	batchProbes = (npartitions > 1 &&
+				   (gp_enable_hashjoin_partitioning ||
+					gp_enable_hashjoin_prefetch));
+	if (!gp_enable_hashjoin_partitioning)
+		npartitions = 1;
+
 	/*
 	 * Initialize the hash table control block.
 	 *
@@ -328,6 +352,15 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 	hashtable->nbatch_outstart = nbatch;
 	hashtable->growEnabled = true;
 	hashtable->totalTuples = 0;
+	hashtable->npartitions = npartitions;
+	hashtable->log2_npartitions = my_log2(npartitions);
+	hashtable->partitionCxt = NULL;
+	hashtable->probeCxt = NULL;
+	hashtable->probeBuffers = NULL;
+	hashtable->drainPartition = -1;
+	hashtable->drainAll = false;
+	hashtable->drainedTuple = NULL;
+	hashtable->prefetchProbes = gp_enable_hashjoin_prefetch;
 	hashtable->innerBatchFile = NULL;
 	hashtable->outerBatchFile = NULL;
 	hashtable->work_set = NULL;
@@ -337,6 +370,14 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 	hashtable->spaceUsedSkew = 0;
 	hashtable->spaceAllowedSkew =
 		hashtable->spaceAllowed * SKEW_WORK_MEM_PERCENT / 100;
+	hashtable->spaceUsedProbe = 0;
+	hashtable->spaceAllowedProbe = 0;
+	if (batchProbes)
+	{
+		hashtable->spaceAllowedProbe =
+			hashtable->spaceAllowed * PROBE_WORK_MEM_PERCENT / 100;
+		hashtable->spaceAllowed -= hashtable->spaceAllowedProbe;
+	}
 	hashtable->stats = NULL;
 	hashtable->eagerlyReleased = false;
 	hashtable->hjstate = hjstate;
@@ -409,6 +450,36 @@ ExecHashTableCreate(HashState *hashState, HashJoinState *hjstate, List *hashOper
 		PrepareTempTablespaces();
 	}
 
+	/*
+	 * If the table is partitioned, each partition keeps its tuples in a
+	 * child of batchCxt.  The outer tuples of batched probes are buffered in
+	 * probeCxt.
+	 */
+	if (npartitions > 1)
+	{
+		hashtable->partitionCxt = (MemoryContext *)
+			palloc(npartitions * sizeof(MemoryContext));
+		for (i = 0; i < npartitions; i++)
+			hashtable->partitionCxt[i] =
+				AllocSetContextCreate(hashtable->batchCxt,
+									  "HashPartitionContext",
+									  ALLOCSET_DEFAULT_MINSIZE,
+									  ALLOCSET_DEFAULT_INITSIZE,
+									  ALLOCSET_DEFAULT_MAXSIZE);
+	}
+
+	if (batchProbes)
+	{
+		hashtable->probeCxt = AllocSetContextCreate(hashtable->hashCxt,
+													"HashProbeContext",
+													ALLOCSET_DEFAULT_MINSIZE,
+													ALLOCSET_DEFAULT_INITSIZE,
+													ALLOCSET_DEFAULT_MAXSIZE);
+		hashtable->probeBuffers = (HashProbeBuffer *)
+			palloc0(npartitions * sizeof(HashProbeBuffer));
+		hashtable->spaceUsedProbe = npartitions * sizeof(HashProbeBuffer);
+	}
+
 	/*
 	 * Prepare context for the first-scan space allocations; allocate the
 	 * hashbucket array therein, and set each bucket "empty".
@@ -658,6 +729,47 @@ ExecChooseHashTableSize(double ntuples, int tupwidth, bool useskew,
 	*numbatches = nbatch;
 }
 
+/*
+ * ExecHashChooseNumPartitions
+ *		choose the number of radix partitions of the in-memory hash table
+ *
+ * Like ExecChooseHashTableSize, this works from the planner's estimate of
+ * the inner relation.  The table needs partitions only if the part of it
+ * that is in memory at a time, buckets included, is larger than
+ * gp_hashjoin_partition_size; the number of partitions is then the power
+ * of 2 that brings each partition down to about that size, capped so that
+ * a partition has at least one bucket.  See HashProbeBuffer.
+ */
+static int
+ExecHashChooseNumPartitions(double ntuples, int tupwidth, int nbuckets,
+							uint64 operatorMemKB)
+{
+	double		batch_bytes;
+	double		partition_bytes;
+	int			npartitions;
+
+	/* num tuples is a global number, as in ExecChooseHashTableSize */
+	if (Gp_role == GP_ROLE_EXECUTE)
+		ntuples = ntuples / getgpsegmentCount();
+
+	/* a batch holds no more than the memory allowed */
+	batch_bytes = ntuples * ExecHashRowSize(tupwidth);
+	batch_bytes = Min(batch_bytes, (double) operatorMemKB * 1024.0);
+	batch_bytes += (double) nbuckets * sizeof(HashJoinTuple);
+
+	partition_bytes = (double) gp_hashjoin_partition_size * 1024.0;
+	if (batch_bytes <= partition_bytes)
+		return 1;
+
+	npartitions = 2;
+	while (npartitions < HJ_MAX_PARTITIONS &&
+		   npartitions < nbuckets &&
+		   npartitions * partition_bytes < batch_bytes)
+		npartitions <<= 1;
+
+	return npartitions;
+}
+
 
 /* ----------------------------------------------------------------
  *		ExecHashTableDestroy
@@ -931,9 +1043,14 @@ ExecHashTableInsert(HashState *hashState, HashJoinTable hashtable,
 		 */
 		HashJoinTuple hashTuple;
 
-		/* Create the HashJoinTuple */
-		hashTuple = (HashJoinTuple) MemoryContextAlloc(hashtable->batchCxt,
-													   hashTupleSize);
+		/* Create the HashJoinTuple, next to the others of its partition */
+		if (hashtable->npartitions > 1)
+			hashTuple = (HashJoinTuple)
+				MemoryContextAlloc(hashtable->partitionCxt[HJ_BUCKET_PARTITION(hashtable, bucketno)],
+								   hashTupleSize);
+		else
+			hashTuple = (HashJoinTuple) MemoryContextAlloc(hashtable->batchCxt,
+														   hashTupleSize);
 		hashTuple->hashvalue = hashvalue;
 		memcpy(HJTUPLE_MINTUPLE(hashTuple), tuple, memtuple_get_size(tuple));
 
@@ -1150,6 +1267,35 @@ ExecHashGetBucketAndBatch(HashJoinTable hashtable,
 	}
 }
 
+/*
+ * ExecHashTableResetProbeBuffers
+ *		discard the outer tuples buffered for batched probes
+ *
+ * The caller must make sure that no slot still holds the buffered tuple
+ * returned last, as it is freed here.
+ */
+void
+ExecHashTableResetProbeBuffers(HashJoinTable hashtable)
+{
+	int			i;
+
+	if (hashtable->probeBuffers == NULL)
+		return;
+
+	for (i = 0; i < hashtable->npartitions; i++)
+	{
+		hashtable->probeBuffers[i].ntuples = 0;
+		hashtable->probeBuffers[i].nextTuple = 0;
+	}
+	hashtable->drainPartition = -1;
+	hashtable->drainAll = false;
+	hashtable->drainedTuple = NULL;
+	hashtable->spaceUsedProbe =
+		hashtable->npartitions * sizeof(HashProbeBuffer);
+
+	MemoryContextReset(hashtable->probeCxt);
+}
+
 /*
  * ExecScanHashBucket
  *		scan a hash bucket for matches to the current outer tuple
@@ -1547,6 +1693,10 @@ ExecHashTableExplainEnd(PlanState *planstate, struct StringInfoData *buf)
             appendStringInfo(buf,
                              "  Skipped %d empty batches.",
                              hashtable->nbatch - stats->nonemptybatches);
+        if (hashtable->npartitions > 1)
+            appendStringInfo(buf,
+                             "  Probed in %d partitions.",
+                             hashtable->npartitions);
     }
 }                               /* ExecHashTableExplainEnd */
 
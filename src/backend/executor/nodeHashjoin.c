@@ -23,7 +23,9 @@
 #include "executor/instrument.h"	/* Instrumentation */
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
+#include "lib/bloomfilter.h"
 #include "miscadmin.h"
+#include "optimizer/clauses.h"
 #include "utils/faultinjector.h"
 #include "utils/memutils.h"
 
@@ -45,11 +47,42 @@
 /* Returns true if doing null-fill on inner relation */
 #define HJ_FILL_INNER(hjstate)	((hjstate)->hj_NullOuterTupleSlot != NULL)
 
+/*
+ * A runtime filter is dropped if it is more than this full after the hash
+ * table has been built, because the estimate of the number of inner rows
+ * it was sized for was badly off.
+ */
+#define RUNTIME_FILTER_MAX_FILL			0.7
+/*
+ * A runtime filter is disabled if it removes less than this fraction of the
+ * first RUNTIME_FILTER_SAMPLE_SIZE outer tuples; it is not worth hashing the
+ * outer tuples twice then.
+ */
+#define RUNTIME_FILTER_SAMPLE_SIZE		4096
+#define RUNTIME_FILTER_MIN_REMOVED		0.1
+
+/*
+ * Batched probes prefetch the first tuple of the bucket of an outer tuple
+ * this many tuples before it is probed.
+ */
+#define HJ_PREFETCH_DISTANCE			8
+
+#if defined(__GNUC__)
+#define HJ_PREFETCH(addr)	__builtin_prefetch(addr)
+#else
+#define HJ_PREFETCH(addr)	((void) 0)
+#endif
+
 extern bool Test_print_prefetch_joinqual;
 
 static TupleTableSlot *ExecHashJoinOuterGetTuple(PlanState *outerNode,
 						  HashJoinState *hjstate,
 						  uint32 *hashvalue);
+static TupleTableSlot *ExecHashJoinOuterGetBufferedTuple(PlanState *outerNode,
+								  HashJoinState *hjstate,
+								  uint32 *hashvalue);
+static void ExecHashJoinPrefetchBuckets(HashJoinTable hashtable,
+							HashProbeBuffer *buffer);
 static TupleTableSlot *ExecHashJoinGetSavedTuple(HashJoinState *hjstate,
 						  BufFile *file,
 						  uint32 *hashvalue,
@@ -63,6 +96,11 @@ static void SpillCurrentBatch(HashJoinState *node);
 static bool ExecHashJoinReloadHashTable(HashJoinState *hjstate);
 static void ExecEagerFreeHashJoin(HashJoinState *node);
 
+static void ExecHashJoinInitRuntimeFilter(HashJoinState *hjstate);
+static void ExecHashJoinBuildRuntimeFilter(HashJoinState *node);
+static void ExecHashJoinPushRuntimeFilter(HashJoinState *node);
+static void ExecHashJoinDropRuntimeFilter(HashJoinState *node);
+
 static inline void SaveWorkFileSetStatsInfo(HashJoinTable hashtable);
 
 /* ----------------------------------------------------------------
@@ -223,10 +261,13 @@ ExecHashJoin_guts(HashJoinState *node)
 				hashNode->hs_quit_if_hashkeys_null = (node->js.jointype == JOIN_LASJ_NOTIN);
 
 				/*
-				 * execute the Hash node, to build the hash table
+				 * execute the Hash node, to build the hash table, and the
+				 * runtime filter for the outer scan along with it
 				 */
 				hashNode->hashtable = hashtable;
+				ExecHashJoinBuildRuntimeFilter(node);
 				(void) MultiExecProcNode((PlanState *) hashNode);
+				ExecHashJoinPushRuntimeFilter(node);
 
 #ifdef HJDEBUG
 				elog(gp_workfile_caching_loglevel, "HashJoin built table with %.1f tuples by executing subplan for batch 0", hashtable->totalTuples);
@@ -283,9 +324,14 @@ ExecHashJoin_guts(HashJoinState *node)
 				/*
 				 * We don't have an outer tuple, try to get the next one
 				 */
-				outerTupleSlot = ExecHashJoinOuterGetTuple(outerNode,
-														   node,
-														   &hashvalue);
+				if (hashtable->probeBuffers != NULL)
+					outerTupleSlot = ExecHashJoinOuterGetBufferedTuple(outerNode,
+																	   node,
+																	   &hashvalue);
+				else
+					outerTupleSlot = ExecHashJoinOuterGetTuple(outerNode,
+															   node,
+															   &hashvalue);
 				if (TupIsNull(outerTupleSlot))
 				{
 					/* end of batch, or maybe whole join */
@@ -737,6 +783,8 @@ ExecInitHashJoin(HashJoin *node, EState *estate, int eflags)
 	hjstate->hj_MatchedOuter = false;
 	hjstate->hj_OuterNotEmpty = false;
 
+	ExecHashJoinInitRuntimeFilter(hjstate);
+
 	return hjstate;
 }
 
@@ -896,6 +944,150 @@ ExecHashJoinOuterGetTuple(PlanState *outerNode,
 	return NULL;
 }
 
+/*
+ * ExecHashJoinOuterGetBufferedTuple
+ *
+ *		get the next outer tuple for a hashjoin whose hash table is larger
+ *		than the CPU cache: the outer tuples of the current batch are
+ *		collected in the probe buffers of their partitions, and returned a
+ *		full buffer at a time, then all the buffers in partition order at
+ *		the end of the batch.  See HashProbeBuffer in hashjoin.h.
+ *
+ * Same interface as ExecHashJoinOuterGetTuple.  The buffered tuples are
+ * stored in hj_OuterTupleSlot, which does not own them; each one is freed
+ * at the next call.
+ */
+static TupleTableSlot *
+ExecHashJoinOuterGetBufferedTuple(PlanState *outerNode,
+								  HashJoinState *hjstate,
+								  uint32 *hashvalue)
+{
+	HashJoinTable hashtable = hjstate->hj_HashTable;
+	HashProbeBuffer *buffer;
+	TupleTableSlot *slot;
+	MemoryContext oldcxt;
+	int			bucketno;
+	int			batchno;
+	int			partno;
+
+	/* The previous outer tuple is done with */
+	if (hashtable->drainedTuple != NULL)
+	{
+		ExecClearTuple(hjstate->hj_OuterTupleSlot);
+		hashtable->spaceUsedProbe -=
+			GetMemoryChunkSpace(hashtable->drainedTuple);
+		pfree(hashtable->drainedTuple);
+		hashtable->drainedTuple = NULL;
+	}
+
+	for (;;)
+	{
+		if (hashtable->drainPartition >= 0)
+		{
+			/* Probe the next tuple of the partition being drained */
+			buffer = &hashtable->probeBuffers[hashtable->drainPartition];
+			if (buffer->nextTuple < buffer->ntuples)
+			{
+				int			i = buffer->nextTuple++;
+
+				if (hashtable->prefetchProbes)
+					ExecHashJoinPrefetchBuckets(hashtable, buffer);
+
+				*hashvalue = buffer->hashvalues[i];
+				hashtable->drainedTuple = buffer->tuples[i];
+				return ExecStoreMinimalTuple(buffer->tuples[i],
+											 hjstate->hj_OuterTupleSlot,
+											 false);
+			}
+			buffer->ntuples = 0;
+			buffer->nextTuple = 0;
+
+			if (!hashtable->drainAll)
+				hashtable->drainPartition = -1;
+			else if (++hashtable->drainPartition == hashtable->npartitions)
+			{
+				/* All the buffers are empty: end of this batch */
+				hashtable->drainPartition = -1;
+				hashtable->drainAll = false;
+				return NULL;
+			}
+			continue;
+		}
+
+		slot = ExecHashJoinOuterGetTuple(outerNode, hjstate, hashvalue);
+		if (TupIsNull(slot))
+		{
+			/* Probe whatever is left in the buffers */
+			hashtable->drainPartition = 0;
+			hashtable->drainAll = true;
+			continue;
+		}
+
+		/*
+		 * Tuples of later batches are saved to their batch files by the
+		 * caller, and tuples of skew buckets are not in any partition.
+		 */
+		ExecHashGetBucketAndBatch(hashtable, *hashvalue, &bucketno, &batchno);
+		if (batchno != hashtable->curbatch ||
+			ExecHashGetSkewBucket(hashtable, *hashvalue) != INVALID_SKEW_BUCKET_NO)
+			return slot;
+
+		partno = HJ_BUCKET_PARTITION(hashtable, bucketno);
+		buffer = &hashtable->probeBuffers[partno];
+
+		oldcxt = MemoryContextSwitchTo(hashtable->probeCxt);
+		buffer->tuples[buffer->ntuples] = ExecCopySlotMemTuple(slot);
+		MemoryContextSwitchTo(oldcxt);
+		buffer->hashvalues[buffer->ntuples] = *hashvalue;
+
+		hashtable->spaceUsedProbe +=
+			GetMemoryChunkSpace(buffer->tuples[buffer->ntuples]);
+		if (hashtable->spaceUsed + hashtable->spaceUsedProbe >
+			hashtable->spacePeak)
+			hashtable->spacePeak =
+				hashtable->spaceUsed + hashtable->spaceUsedProbe;
+
+		/*
+		 * Probe the buffer when it is full, or earlier if the buffered tuples
+		 * take up all the memory set aside for them.
+		 */
+		if (++buffer->ntuples == HJ_PROBE_BUFFER_SIZE ||
+			hashtable->spaceUsedProbe > hashtable->spaceAllowedProbe)
+			hashtable->drainPartition = partno;
+	}
+}
+
+/*
+ * ExecHashJoinPrefetchBuckets
+ *
+ *		prefetch the buckets of the buffered outer tuples about to be probed
+ *
+ * Called for each tuple returned from a probe buffer, after nextTuple has
+ * been advanced past it.  When the buffer starts to be drained, the bucket
+ * headers of all its tuples are prefetched; then, HJ_PREFETCH_DISTANCE
+ * tuples ahead of the one being probed, the first tuple of the bucket's
+ * chain.  The cache misses of the probes thus overlap instead of stalling
+ * one after another.
+ */
+static void
+ExecHashJoinPrefetchBuckets(HashJoinTable hashtable, HashProbeBuffer *buffer)
+{
+	uint32		bucketmask = (uint32) hashtable->nbuckets - 1;
+	int			i;
+
+	if (buffer->nextTuple == 1)
+	{
+		for (i = 0; i < buffer->ntuples; i++)
+			HJ_PREFETCH(&hashtable->buckets[buffer->hashvalues[i] & bucketmask]);
+		for (i = 0; i < Min(HJ_PREFETCH_DISTANCE, buffer->ntuples); i++)
+			HJ_PREFETCH(hashtable->buckets[buffer->hashvalues[i] & bucketmask]);
+	}
+
+	i = buffer->nextTuple - 1 + HJ_PREFETCH_DISTANCE;
+	if (i < buffer->ntuples)
+		HJ_PREFETCH(hashtable->buckets[buffer->hashvalues[i] & bucketmask]);
+}
+
 /*
  * ExecHashJoinNewBatch
  *		switch to a new hashjoin batch
@@ -1250,6 +1442,10 @@ ExecReScanHashJoin(HashJoinState *node)
 				}
 			}
 
+			/* Forget the outer tuples buffered for the previous scan */
+			ExecClearTuple(node->hj_OuterTupleSlot);
+			ExecHashTableResetProbeBuffers(hashtable);
+
 			/* ExecHashJoin can skip the BUILD_HASHTABLE step */
 			node->hj_JoinState = HJ_NEED_NEW_OUTER;
 
@@ -1288,6 +1484,9 @@ ExecReScanHashJoin(HashJoinState *node)
 			node->hj_HashTable = NULL;
 			node->hj_JoinState = HJ_BUILD_HASHTABLE;
 
+			/* the runtime filter is rebuilt along with the hash table */
+			ExecHashJoinDropRuntimeFilter(node);
+
 			/*
 			 * if chgParam of subnode is not null then plan will be re-scanned
 			 * by first ExecProcNode.
@@ -1523,6 +1722,189 @@ ExecHashJoinReloadHashTable(HashJoinState *hjstate)
 	return true;
 }
 
+/*
+ * ExecHashJoinInitRuntimeFilter
+ *
+ * Decide whether the join can use a runtime filter for its outer side, and
+ * set one up if so.
+ *
+ * The filter is only applied to a scan that is directly below us, and thus
+ * in the same slice.  The filter can only drop outer tuples that have no
+ * match, so it is not used for joins that emit unmatched outer tuples.  The
+ * outer hash keys are evaluated for the filter and again by the join, so
+ * they must not be volatile.
+ */
+static void
+ExecHashJoinInitRuntimeFilter(HashJoinState *hjstate)
+{
+	PlanState  *outerNode = outerPlanState(hjstate);
+	HashRuntimeFilterData *rf;
+	ListCell   *lc;
+
+	hjstate->hj_RuntimeFilter = NULL;
+
+	if (!gp_enable_runtime_filter || HJ_FILL_OUTER(hjstate))
+		return;
+
+	if (!IsA(outerNode, SeqScanState) &&
+		!IsA(outerNode, DynamicSeqScanState))
+		return;
+
+	foreach(lc, hjstate->hj_OuterHashKeys)
+	{
+		ExprState  *keyexpr = (ExprState *) lfirst(lc);
+
+		if (contain_volatile_functions((Node *) keyexpr->expr))
+			return;
+	}
+
+	rf = palloc0(sizeof(HashRuntimeFilterData));
+	rf->hjstate = hjstate;
+	rf->target = (ScanState *) outerNode;
+	rf->econtext = CreateExprContext(hjstate->js.ps.state);
+
+	hjstate->hj_RuntimeFilter = rf;
+}
+
+/*
+ * ExecHashJoinBuildRuntimeFilter
+ *
+ * Create an empty runtime filter, to be filled in by the Hash node as it
+ * builds the hash table.
+ */
+static void
+ExecHashJoinBuildRuntimeFilter(HashJoinState *node)
+{
+	HashRuntimeFilterData *rf = node->hj_RuntimeFilter;
+	HashState  *hashNode = (HashState *) innerPlanState(node);
+	double		nrows;
+	int			bloom_work_mem;
+
+	if (rf == NULL)
+		return;
+
+	/* discard the filter of the previous scan, if any */
+	ExecHashJoinDropRuntimeFilter(node);
+
+	/* Spend no more than an eighth of the memory of the hash table on it */
+	nrows = Min(Max(hashNode->ps.plan->plan_rows, 1.0), (double) PG_INT32_MAX);
+	bloom_work_mem = Max(PlanStateOperatorMemKB((PlanState *) hashNode) / 8, 64);
+
+	rf->bloom = bloom_create((int64) nrows, bloom_work_mem, 0);
+	rf->disabled = false;
+	rf->ntested = 0;
+	rf->nremoved = 0;
+
+	hashNode->hs_bloom = rf->bloom;
+}
+
+/*
+ * ExecHashJoinPushRuntimeFilter
+ *
+ * Install the runtime filter in the outer scan, now that the hash table has
+ * been built.  Outer tuples that were fetched before that, to check whether
+ * the outer side is empty, are not filtered.
+ */
+static void
+ExecHashJoinPushRuntimeFilter(HashJoinState *node)
+{
+	HashRuntimeFilterData *rf = node->hj_RuntimeFilter;
+	HashState  *hashNode = (HashState *) innerPlanState(node);
+	double		fill;
+
+	if (rf == NULL)
+		return;
+
+	hashNode->hs_bloom = NULL;
+
+	fill = bloom_prop_bits_set(rf->bloom);
+	if (fill > RUNTIME_FILTER_MAX_FILL)
+	{
+		elog(DEBUG1, "not using runtime filter of hash join, %.0f%% of its bits are set",
+			 fill * 100);
+		rf->disabled = true;
+		return;
+	}
+
+	rf->target->ss_runtimeFilter = rf;
+}
+
+/*
+ * ExecHashJoinDropRuntimeFilter
+ *
+ * Remove the runtime filter from the outer scan, and free it.
+ */
+static void
+ExecHashJoinDropRuntimeFilter(HashJoinState *node)
+{
+	HashRuntimeFilterData *rf = node->hj_RuntimeFilter;
+
+	if (rf == NULL)
+		return;
+
+	rf->target->ss_runtimeFilter = NULL;
+
+	if (rf->bloom)
+	{
+		bloom_free(rf->bloom);
+		rf->bloom = NULL;
+	}
+}
+
+/*
+ * ExecHashJoinRuntimeFilterPass
+ *
+ * Called by the outer scan of the join, to test whether the tuple in 'slot'
+ * can possibly find a match in the hash table.  Returns false if it cannot,
+ * in which case the scan may drop the tuple.
+ */
+bool
+ExecHashJoinRuntimeFilterPass(HashRuntimeFilterData *rf, TupleTableSlot *slot)
+{
+	HashJoinState *hjstate = rf->hjstate;
+	HashJoinTable hashtable = hjstate->hj_HashTable;
+	ExprContext *econtext = rf->econtext;
+	uint32		hashvalue;
+	bool		hashkeys_null = false;
+	bool		pass;
+
+	if (rf->disabled || rf->bloom == NULL ||
+		hashtable == NULL || hashtable->eagerlyReleased)
+		return true;
+
+	/*
+	 * Compute the hash value just like ExecHashJoinOuterGetTuple() does.  A
+	 * tuple with a NULL key that cannot match is dropped, as the join would
+	 * drop it anyway.
+	 */
+	econtext->ecxt_outertuple = slot;
+	if (ExecHashGetHashValue((HashState *) innerPlanState(hjstate), hashtable,
+							 econtext, hjstate->hj_OuterHashKeys,
+							 true,		/* outer tuple */
+							 hjstate->hj_nonequijoin,
+							 &hashvalue,
+							 &hashkeys_null))
+		pass = !bloom_lacks_element(rf->bloom, (unsigned char *) &hashvalue,
+									sizeof(hashvalue));
+	else
+		pass = false;
+
+	rf->ntested++;
+	if (!pass)
+		rf->nremoved++;
+
+	if (rf->ntested == RUNTIME_FILTER_SAMPLE_SIZE &&
+		rf->nremoved < rf->ntested * RUNTIME_FILTER_MIN_REMOVED)
+	{
+		elog(DEBUG1, "disabling runtime filter of hash join, it removed "
+			 UINT64_FORMAT " of " UINT64_FORMAT " tuples",
+			 rf->nremoved, rf->ntested);
+		rf->disabled = true;
+	}
+
+	return pass;
+}
+
 static inline void SaveWorkFileSetStatsInfo(HashJoinTable hashtable)
 {
 	workfile_set *work_set = hashtable->work_set;
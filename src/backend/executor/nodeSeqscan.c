@@ -31,12 +31,14 @@
 
 #include "cdb/cdbappendonlyam.h"
 #include "cdb/cdbaocsam.h"
+#include "cdb/cdbvars.h"
 #include "utils/snapmgr.h"
 
 static void InitScanRelation(SeqScanState *node, EState *estate, int eflags, Relation currentRelation);
 static TupleTableSlot *SeqNext(SeqScanState *node);
 
 static void InitAOCSScanOpaque(SeqScanState *scanState, Relation currentRelation);
+static void ExecSeqScanExplainEnd(PlanState *planstate, struct StringInfoData *buf);
 
 /* ----------------------------------------------------------------
  *						Scan Support
@@ -184,6 +186,44 @@ InitScanRelation(SeqScanState *node, EState *estate, int eflags, Relation curren
 						   appendOnlyMetaDataSnapshot,
 						   NULL /* relationTupleDesc */,
 						   node->ss_aocs_proj);
+
+		/* let the scan skip the blocks that the qual rules out */
+		aocs_set_zonemap_quals(node->ss_currentScanDesc_aocs,
+							   node->ss.ps.plan->qual,
+							   ((Scan *) node->ss.ps.plan)->scanrelid);
+
+		/*
+		 * In batch mode, the scan evaluates the simple clauses of the qual
+		 * itself, on whole column vectors.  Leave only the rest to ExecScan.
+		 */
+		if (gp_enable_aocs_batch_scan && node->ss.ps.plan->qual != NIL)
+		{
+			List	   *qual = node->ss.ps.plan->qual;
+			bool	   *pushed = palloc(sizeof(bool) * list_length(qual));
+
+			if (aocs_set_batch_quals(node->ss_currentScanDesc_aocs, qual,
+									 ((Scan *) node->ss.ps.plan)->scanrelid,
+									 pushed))
+			{
+				List	   *rest = NIL;
+				ListCell   *lc;
+				int			i = 0;
+
+				Assert(list_length(node->ss.ps.qual) == list_length(qual));
+				foreach(lc, node->ss.ps.qual)
+				{
+					if (!pushed[i++])
+						rest = lappend(rest, lfirst(lc));
+				}
+				node->ss.ps.qual = rest;
+
+				/* Show the work done in batches in EXPLAIN ANALYZE */
+				if (estate->es_instrument &&
+					(estate->es_instrument & INSTRUMENT_CDB))
+					node->ss.ps.cdbexplainfun = ExecSeqScanExplainEnd;
+			}
+			pfree(pushed);
+		}
 	}
 	else
 	{
@@ -199,6 +239,30 @@ InitScanRelation(SeqScanState *node, EState *estate, int eflags, Relation curren
 }
 
 
+/*
+ * ExecSeqScanExplainEnd
+ *		Called before ExecutorEnd to finish EXPLAIN ANALYZE reporting.
+ *
+ * Reports how many rows a scan in batch mode read in batches, and how many
+ * of them the clauses evaluated on the column vectors removed.  Those rows
+ * never reach the node's qual.
+ */
+static void
+ExecSeqScanExplainEnd(PlanState *planstate, struct StringInfoData *buf)
+{
+	SeqScanState *node = (SeqScanState *) planstate;
+	AOCSScanBatch *batch;
+
+	if (!node->ss_currentScanDesc_aocs || !node->ss_currentScanDesc_aocs->batch)
+		return;
+
+	batch = node->ss_currentScanDesc_aocs->batch;
+	appendStringInfo(buf, "Batch mode: %d clauses, " INT64_FORMAT " rows in "
+					 INT64_FORMAT " batches, " INT64_FORMAT " rows removed",
+					 batch->nquals, batch->nrows, batch->nbatches,
+					 batch->nremoved);
+}
+
 /* ----------------------------------------------------------------
  *		ExecInitSeqScan
  * ----------------------------------------------------------------
@@ -23,6 +23,7 @@
 #include "gpos/_api.h"
 #include "gpos/memory/CMemoryPoolManager.h"
 
+#include "gpdbcost/CCostModelParamsGPDB.h"
 #include "gpopt/gpdbwrappers.h"
 #include "gpopt/init.h"
 #include "naucrates/exception.h"
@@ -45,17 +46,23 @@ PlannedStmt *
 CGPOptimizer::GPOPTOptimizedPlan(
 	Query *query,
 	bool *
-		had_unexpected_failure	// output : set to true if optimizer unexpectedly failed to produce plan
+		had_unexpected_failure,	 // output : set to true if optimizer unexpectedly failed to produce plan
+	MemoryContext
+		profile_context,  // context to allocate the profile in, NULL if it is not collected
+	OptimizerProfile **profile	// output : profile of the optimization
 )
 {
 	SOptContext gpopt_context;
 	PlannedStmt *plStmt = NULL;
 
 	*had_unexpected_failure = false;
+	*profile = NULL;
+	gpopt_context.m_profile_context = profile_context;
 
 	GPOS_TRY
 	{
 		plStmt = COptTasks::GPOPTOptimizedPlan(query, &gpopt_context);
+		*profile = gpopt_context.m_profile;
 		// clean up context
 		gpopt_context.Free(gpopt_context.epinQuery, gpopt_context.epinPlStmt);
 	}
@@ -211,6 +218,20 @@ CGPOptimizer::TerminateGPOPT()
 	gpos_terminate();
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CGPOptimizer::IsCostModelParam
+//
+//	@doc:
+//		Check whether the cost model has a parameter with the given name
+//
+//---------------------------------------------------------------------------
+bool
+CGPOptimizer::IsCostModelParam(const char *name)
+{
+	return CCostModelParamsGPDB::FKnownParam(name);
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		GPOPTOptimizedPlan
@@ -221,9 +242,11 @@ CGPOptimizer::TerminateGPOPT()
 //---------------------------------------------------------------------------
 extern "C" {
 PlannedStmt *
-GPOPTOptimizedPlan(Query *query, bool *had_unexpected_failure)
+GPOPTOptimizedPlan(Query *query, bool *had_unexpected_failure,
+				   MemoryContext profile_context, OptimizerProfile **profile)
 {
-	return CGPOptimizer::GPOPTOptimizedPlan(query, had_unexpected_failure);
+	return CGPOptimizer::GPOPTOptimizedPlan(query, had_unexpected_failure,
+											profile_context, profile);
 }
 }
 
@@ -313,4 +336,21 @@ TerminateGPOPT()
 }
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		GPOPTIsCostModelParam()
+//
+//	@doc:
+//		Check the name of a cost model parameter, for the GUC check hook of
+//		optimizer_cost_model_profile
+//
+//---------------------------------------------------------------------------
+extern "C" {
+bool
+GPOPTIsCostModelParam(const char *name)
+{
+	return CGPOptimizer::IsCostModelParam(name);
+}
+}
+
 // EOF
@@ -492,6 +492,9 @@ CConfigParamMapping::PackConfigParamInBitset(
 		case JOIN_ORDER_EXHAUSTIVE2_SEARCH:
 			join_heuristic_bitset = CXform::PbsJoinOrderOnExhaustive2Xforms(mp);
 			break;
+		case JOIN_ORDER_DPHYP_SEARCH:
+			join_heuristic_bitset = CXform::PbsJoinOrderOnDPhypXforms(mp);
+			break;
 		default:
 			elog(ERROR,
 				 "Invalid value for optimizer_join_order, must \
@@ -35,7 +35,9 @@ extern "C" {
 #include "optimizer/tlist.h"
 #include "parser/parse_clause.h"
 #include "parser/parse_oper.h"
+#include "utils/cardfeedback.h"
 #include "utils/memutils.h"
+#include "utils/sharedmdcache.h"
 #include "utils/snapmgr.h"
 }
 #define GP_WRAP_START                                            \
@@ -2670,6 +2672,74 @@ gpdb::MDCacheInTransientState(void)
 	return false;
 }
 
+// returns true if the shared metadata cache can be used by this backend
+bool
+gpdb::SharedMDCacheIsEnabled(void)
+{
+	GP_WRAP_START;
+	{
+		return SharedMDCacheEnabled();
+	}
+	GP_WRAP_END;
+	return false;
+}
+
+uint64
+gpdb::SharedMDCacheGetGeneration(void)
+{
+	GP_WRAP_START;
+	{
+		uint64 generation = SharedMDCacheGeneration();
+
+		/*
+		 * A committer bumps the generation after sending its invalidations.
+		 * Syscache lookups, e.g. of pg_statistic, do not process them, so
+		 * without this an object translated from stale caches could be
+		 * stored under the new generation.
+		 */
+		AcceptInvalidationMessages();
+
+		return generation;
+	}
+	GP_WRAP_END;
+	return 0;
+}
+
+void *
+gpdb::SharedMDCacheGet(const char *mdid, Size *len)
+{
+	GP_WRAP_START;
+	{
+		return SharedMDCacheLookup(mdid, len);
+	}
+	GP_WRAP_END;
+	return NULL;
+}
+
+bool
+gpdb::SharedMDCachePut(const char *mdid, const void *data, Size len,
+					   uint64 generation)
+{
+	GP_WRAP_START;
+	{
+		return SharedMDCacheInsert(mdid, data, len, generation);
+	}
+	GP_WRAP_END;
+	return false;
+}
+
+CardinalityFeedbackFactor *
+gpdb::CardinalityFeedbackGetFactors(Query *query, int *nfactors)
+{
+	GP_WRAP_START;
+	{
+		return ::CardinalityFeedbackGetFactors(query, nfactors);
+	}
+	GP_WRAP_END;
+	*nfactors = 0;
+	return NULL;
+}
+
 // returns true if a query cancel is requested in GPDB
 bool
 gpdb::IsAbortRequested(void)
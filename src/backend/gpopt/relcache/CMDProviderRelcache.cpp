@@ -16,7 +16,10 @@
 
 extern "C" {
 #include "postgres.h"
+
+#include "utils/sharedmdcache.h"
 }
+#include "gpopt/gpdbwrappers.h"
 #include "gpopt/mdcache/CMDAccessor.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
 #include "gpopt/translate/CTranslatorRelcacheToDXL.h"
@@ -32,12 +35,49 @@ CMDProviderRelcache::CMDProviderRelcache(CMemoryPool *mp) : m_mp(mp)
 	GPOS_ASSERT(NULL != m_mp);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDProviderRelcache::GetSharedCacheKey
+//
+//	@doc:
+//		Build the key of the given object in the shared metadata cache;
+//		returns false if the object cannot be stored in the shared cache
+//
+//---------------------------------------------------------------------------
+BOOL
+CMDProviderRelcache::GetSharedCacheKey(IMDId *md_id, CHAR *key)
+{
+	// CTAS objects have a fixed id, and must not be cached (see
+	// CMDAccessor::GetImdObj)
+	if (IMDId::EmdidGPDBCtas == md_id->MdidType())
+	{
+		return false;
+	}
+
+	const WCHAR *wsz = md_id->GetBuffer();
+	ULONG ul = 0;
+	for (; 0 != wsz[ul]; ul++)
+	{
+		// serialized mdids are plain ASCII
+		if (SHARED_MDCACHE_KEYLEN - 1 == ul || 0x7f < wsz[ul])
+		{
+			return false;
+		}
+		key[ul] = (CHAR) wsz[ul];
+	}
+	key[ul] = '\0';
+
+	return true;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMDProviderRelcache::GetMDObjDXLStr
 //
 //	@doc:
-//		Returns the DXL of the requested object in the provided memory pool
+//		Returns the DXL of the requested object in the provided memory pool;
+//		the object is looked up in the shared metadata cache first, and
+//		stored there after it has been translated from the relcache
 //
 //---------------------------------------------------------------------------
 CWStringBase *
@@ -45,6 +85,30 @@ CMDProviderRelcache::GetMDObjDXLStr(CMemoryPool *mp, CMDAccessor *md_accessor,
 									IMDId *md_id,
 									IMDCacheObject::Emdtype mdtype) const
 {
+	CHAR key[SHARED_MDCACHE_KEYLEN];
+	BOOL use_shared_cache =
+		gpdb::SharedMDCacheIsEnabled() && GetSharedCacheKey(md_id, key);
+	uint64 generation = 0;
+
+	if (use_shared_cache)
+	{
+		Size len = 0;
+		WCHAR *cached_str = (WCHAR *) gpdb::SharedMDCacheGet(key, &len);
+		if (NULL != cached_str)
+		{
+			GPOS_ASSERT(0 == cached_str[len / GPOS_SIZEOF(WCHAR) - 1]);
+
+			CWStringDynamic *str =
+				GPOS_NEW(m_mp) CWStringDynamic(m_mp, cached_str);
+			gpdb::GPDBFree(cached_str);
+
+			return str;
+		}
+
+		// must be read before the catalog is accessed
+		generation = gpdb::SharedMDCacheGetGeneration();
+	}
+
 	IMDCacheObject *md_obj = CTranslatorRelcacheToDXL::RetrieveObject(
 		mp, md_accessor, md_id, mdtype);
 
@@ -56,6 +120,15 @@ CMDProviderRelcache::GetMDObjDXLStr(CMemoryPool *mp, CMDAccessor *md_accessor,
 	// cleanup DXL object
 	md_obj->Release();
 
+	// objects translated while the relcache hides some of the indexes are
+	// only valid for this backend
+	if (use_shared_cache && !gpdb::MDCacheInTransientState())
+	{
+		gpdb::SharedMDCachePut(key, str->GetBuffer(),
+							   (str->Length() + 1) * GPOS_SIZEOF(WCHAR),
+							   generation);
+	}
+
 	return str;
 }
 
@@ -84,6 +84,13 @@ CMemoryPoolPalloc::TotalAllocatedSize() const
 	return MemoryContextGetCurrentSpace(m_cxt);
 }
 
+// Largest total allocated size so far
+ULLONG
+CMemoryPoolPalloc::PeakAllocatedSize() const
+{
+	return MemoryContextGetPeakSpace(m_cxt);
+}
+
 // get user requested size of array allocation. Note: this is ONLY called for arrays
 ULONG
 CMemoryPoolPalloc::UserSizeOfAlloc(const void *ptr)
@@ -93,7 +100,7 @@ CMemoryPoolPalloc::UserSizeOfAlloc(const void *ptr)
 						GPOS_MEM_ALIGNED_STRUCT_SIZE(SArrayAllocHeader);
 	const SArrayAllocHeader *header =
 		static_cast<SArrayAllocHeader *>(void_header);
-	return header->m_user_size;
+	return (ULONG) header->m_user_size;
 }
 
 
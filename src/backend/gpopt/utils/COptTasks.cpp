@@ -34,6 +34,7 @@
 
 #include "cdb/cdbvars.h"
 #include "storage/proc.h"
+#include "utils/cardfeedback.h"
 #include "utils/fmgroids.h"
 #include "utils/guc.h"
 #undef setstate
@@ -55,8 +56,11 @@
 #include "gpopt/mdcache/CAutoMDAccessor.h"
 #include "gpopt/mdcache/CMDCache.h"
 #include "gpopt/minidump/CMinidumperUtils.h"
+#include "gpopt/optimizer/CCardinalityFeedback.h"
+#include "gpopt/optimizer/COptimizationStats.h"
 #include "gpopt/optimizer/COptimizer.h"
 #include "gpopt/optimizer/COptimizerConfig.h"
+#include "gpopt/optimizer/CPlanCache.h"
 #include "gpopt/translate/CTranslatorDXLToExpr.h"
 #include "gpopt/translate/CTranslatorExprToDXL.h"
 #include "gpopt/xforms/CXformFactory.h"
@@ -65,6 +69,7 @@
 #include "naucrates/dxl/CIdGenerator.h"
 #include "naucrates/dxl/operators/CDXLNode.h"
 #include "naucrates/dxl/parser/CParseHandlerDXL.h"
+#include "naucrates/dxl/xml/CXMLSerializer.h"
 #include "naucrates/exception.h"
 #include "naucrates/init.h"
 #include "naucrates/md/CMDIdCast.h"
@@ -83,9 +88,6 @@ using namespace gpdbcost;
 // size of error buffer
 #define GPOPT_ERROR_BUFFER_SIZE 10 * 1024 * 1024
 
-// definition of default AutoMemoryPool
-#define AUTO_MEM_POOL(amp) CAutoMemoryPool amp(CAutoMemoryPool::ElcExc)
-
 // default id for the source system
 const CSystemId default_sysid(IMDId::EmdidGeneral, GPOS_WSZ_STR_LENGTH("GPDB"));
 
@@ -107,7 +109,9 @@ SOptContext::SOptContext()
 	  m_should_serialize_plan_dxl(false),
 	  m_is_unexpected_failure(false),
 	  m_should_error_out(false),
-	  m_error_msg(NULL)
+	  m_error_msg(NULL),
+	  m_profile_context(NULL),
+	  m_profile(NULL)
 {
 }
 
@@ -407,12 +411,58 @@ COptTasks::CreateOptimizerConfig(CMemoryPool *mp, ICostModel *cost_model)
 		GPOS_NEW(mp) CWindowOids(OID(F_WINDOW_ROW_NUMBER), OID(F_WINDOW_RANK)));
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::CreateCardinalityFeedback
+//
+//	@doc:
+//		Create the cardinality feedback for the tables of the given query,
+//		as learned from the actual rows of earlier plans
+//
+//---------------------------------------------------------------------------
+CCardinalityFeedback *
+COptTasks::CreateCardinalityFeedback(CMemoryPool *mp, Query *query)
+{
+	int num_factors = 0;
+	CardinalityFeedbackFactor *factors =
+		gpdb::CardinalityFeedbackGetFactors(query, &num_factors);
+	if (0 == num_factors)
+	{
+		return NULL;
+	}
+
+	CCardinalityFeedback *cardinality_feedback =
+		GPOS_NEW(mp) CCardinalityFeedback(mp);
+	for (int i = 0; i < num_factors; i++)
+	{
+		const CardinalityFeedbackSignature *sig = &factors[i].sig;
+		CCardinalityFeedback::SColumn cols[CCardinalityFeedback::MaxColumns];
+
+		GPOS_ASSERT(sig->ncols <= (int) CCardinalityFeedback::MaxColumns);
+		for (int col = 0; col < sig->ncols; col++)
+		{
+			cols[col].m_rel_oid = sig->cols[col].relid;
+			cols[col].m_attno = sig->cols[col].attno;
+			cols[col].m_shape = sig->cols[col].shape;
+		}
+
+		cardinality_feedback->Add(CARDINALITY_FEEDBACK_SCAN == sig->kind
+									  ? CCardinalityFeedback::EfkScan
+									  : CCardinalityFeedback::EfkJoin,
+								  cols, sig->ncols, CDouble(factors[i].factor));
+	}
+	gpdb::GPDBFree(factors);
+
+	return cardinality_feedback;
+}
+
 //---------------------------------------------------------------------------
 //		@function:
 //			COptTasks::SetCostModelParams
 //
 //      @doc:
-//			Set cost model parameters
+//			Set cost model parameters; the factors of the cost model profile
+//			apply to the defaults, before the nestloop and sort factors
 //
 //---------------------------------------------------------------------------
 void
@@ -420,6 +470,27 @@ COptTasks::SetCostModelParams(ICostModel *cost_model)
 {
 	GPOS_ASSERT(NULL != cost_model);
 
+	const int num_factors =
+		NULL == optimizer_cost_profile ? 0 : optimizer_cost_profile->nfactors;
+	for (int i = 0; i < num_factors; i++)
+	{
+		const OptimizerCostParamFactor *param_factor =
+			&optimizer_cost_profile->factors[i];
+		ICostModelParams::SCostParam *cost_param =
+			cost_model->GetCostModelParams()->PcpLookup(param_factor->name);
+		if (NULL == cost_param)
+		{
+			elog(WARNING, "unknown optimizer cost model parameter \"%s\"",
+				 param_factor->name);
+			continue;
+		}
+
+		cost_model->GetCostModelParams()->SetParam(
+			cost_param->Id(), cost_param->Get() * param_factor->factor,
+			cost_param->GetLowerBoundVal() * param_factor->factor,
+			cost_param->GetUpperBoundVal() * param_factor->factor);
+	}
+
 	if (optimizer_nestloop_factor > 1.0)
 	{
 		// change NLJ cost factor
@@ -483,7 +554,10 @@ COptTasks::OptimizeTask(void *ptr)
 	GPOS_ASSERT(NULL == opt_ctxt->m_plan_dxl);
 	GPOS_ASSERT(NULL == opt_ctxt->m_plan_stmt);
 
-	AUTO_MEM_POOL(amp);
+	// the objects of the optimization are freed all at once when it ends,
+	// so they are allocated from an arena unless told otherwise
+	CAutoMemoryPool amp(CAutoMemoryPool::ElcExc,
+						optimizer_use_arena_allocator);
 	CMemoryPool *mp = amp.Pmp();
 
 	// Does the metadatacache need to be reset?
@@ -493,6 +567,7 @@ COptTasks::OptimizeTask(void *ptr)
 	// we need to call it anyway, to give it a chance to initialize
 	// the invalidation mechanism.
 	bool reset_mdcache = gpdb::MDCacheNeedsReset();
+	bool purge_plan_cache = reset_mdcache || !CMDCache::FInitialized();
 
 	// initialize metadata cache, or purge if needed, or change size if requested
 	if (!CMDCache::FInitialized())
@@ -513,6 +588,23 @@ COptTasks::OptimizeTask(void *ptr)
 		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
 	}
 
+	// the plans in the plan cache are only valid for the metadata in the
+	// metadata cache, so the plan cache is purged along with it
+	if (0 == optimizer_plan_cache_size || !optimizer_metadata_caching)
+	{
+		CPlanCache::Shutdown();
+	}
+	else if (!CPlanCache::FInitialized() || purge_plan_cache)
+	{
+		CPlanCache::Reset();
+		CPlanCache::SetCacheQuota(optimizer_plan_cache_size * 1024L);
+	}
+	else if (CPlanCache::ULLGetCacheQuota() !=
+			 (ULLONG) optimizer_plan_cache_size * 1024L)
+	{
+		CPlanCache::SetCacheQuota(optimizer_plan_cache_size * 1024L);
+	}
+
 
 	// load search strategy
 	CSearchStageArray *search_strategy_arr =
@@ -557,6 +649,16 @@ COptTasks::OptimizeTask(void *ptr)
 			ICostModel *cost_model = GetCostModel(mp, num_segments_for_costing);
 			COptimizerConfig *optimizer_config =
 				CreateOptimizerConfig(mp, cost_model);
+			if (NULL != opt_ctxt->m_profile_context)
+			{
+				optimizer_config->SetOptimizationStats(
+					GPOS_NEW(mp) COptimizationStats());
+			}
+			if (optimizer_cardinality_feedback)
+			{
+				optimizer_config->SetCardinalityFeedback(
+					CreateCardinalityFeedback(mp, opt_ctxt->m_query));
+			}
 			CConstExprEvaluatorProxy expr_eval_proxy(mp, &mda);
 			IConstExprEvaluator *expr_evaluator =
 				GPOS_NEW(mp) CConstExprEvaluatorDXL(mp, &mda, &expr_eval_proxy);
@@ -581,10 +683,45 @@ COptTasks::OptimizeTask(void *ptr)
 			CAutoTraceFlag atf2(EopttraceUseLegacyOpfamilies,
 								use_legacy_opfamilies);
 
-			plan_dxl = COptimizer::PdxlnOptimize(
-				mp, &mda, query_dxl, query_output_dxlnode_array,
-				cte_dxlnode_array, expr_evaluator, num_segments, gp_session_id,
-				MyProc->queryCommandId, search_strategy_arr, optimizer_config);
+			// a plan found in the plan cache is pinned by the accessor until
+			// the end of the scope; plans corrected by cardinality feedback
+			// are not cached, the feedback changes as queries run
+			CAutoP<CPlanCache::PlanCacheAccessor> plan_cache_accessor;
+			CAutoP<CWStringDynamic> plan_cache_key;
+			if (CPlanCache::FInitialized() && NULL == search_strategy_arr &&
+				NULL == optimizer_config->GetCardinalityFeedback() &&
+				CanUsePlanCache(opt_ctxt->m_query))
+			{
+				plan_cache_key = GetPlanCacheKey(
+					mp, query_dxl, query_output_dxlnode_array,
+					cte_dxlnode_array, optimizer_config, num_segments);
+				plan_cache_accessor = GPOS_NEW(mp)
+					CPlanCache::PlanCacheAccessor(CPlanCache::Pcache());
+				plan_dxl = CPlanCache::PdxlnLookup(
+					&mda, plan_cache_accessor.Value(), plan_cache_key.Value());
+			}
+
+			if (NULL == plan_dxl)
+			{
+				plan_dxl = COptimizer::PdxlnOptimize(
+					mp, &mda, query_dxl, query_output_dxlnode_array,
+					cte_dxlnode_array, expr_evaluator, num_segments,
+					gp_session_id, MyProc->queryCommandId, search_strategy_arr,
+					optimizer_config);
+
+				if (NULL != plan_cache_key.Value())
+				{
+					CPlanCache::Insert(mp, &mda, plan_cache_key.Value(),
+									   query_dxl, cte_dxlnode_array, plan_dxl);
+				}
+
+				if (NULL != opt_ctxt->m_profile_context)
+				{
+					opt_ctxt->m_profile =
+						CreateProfile(opt_ctxt->m_profile_context,
+									  optimizer_config->GetOptimizationStats());
+				}
+			}
 
 			if (opt_ctxt->m_should_serialize_plan_dxl)
 			{
@@ -638,6 +775,7 @@ COptTasks::OptimizeTask(void *ptr)
 		CRefCount::SafeRelease(trace_flags);
 		CRefCount::SafeRelease(plan_dxl);
 		CMDCache::Shutdown();
+		CPlanCache::Shutdown();
 
 		CTask *task = CTask::Self();
 		IErrorContext *errctxt = (NULL != task) ? task->GetErrCtxt() : NULL;
@@ -666,6 +804,122 @@ COptTasks::OptimizeTask(void *ptr)
 	return NULL;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::CreateProfile
+//
+//	@doc:
+//		Convert the counters of an optimization into a profile allocated in
+//		the given memory context, listing the job types that ran and the
+//		xforms that were applied
+//
+//---------------------------------------------------------------------------
+OptimizerProfile *
+COptTasks::CreateProfile(MemoryContext context,
+						 const COptimizationStats *optimization_stats)
+{
+	GPOS_ASSERT(NULL != optimization_stats);
+
+	OptimizerProfile *profile = (OptimizerProfile *) gpdb::MemCtxtAllocZero(
+		context, sizeof(OptimizerProfile));
+	profile->groups = optimization_stats->Groups();
+
+	profile->jobs = (OptimizerJobProfile *) gpdb::MemCtxtAllocZero(
+		context, CJob::EjtSentinel * sizeof(OptimizerJobProfile));
+	for (ULONG ul = 0; ul < CJob::EjtSentinel; ul++)
+	{
+		CJob::EJobType ejt = (CJob::EJobType) ul;
+		if (0 == optimization_stats->JobSteps(ejt))
+		{
+			continue;
+		}
+
+		OptimizerJobProfile *job = &profile->jobs[profile->num_jobs++];
+		job->name = COptimizationStats::JobName(ejt);
+		job->steps = optimization_stats->JobSteps(ejt);
+		job->time_ms =
+			(double) optimization_stats->JobTimeUS(ejt) / GPOS_USEC_IN_MSEC;
+	}
+
+	profile->xforms = (OptimizerXformProfile *) gpdb::MemCtxtAllocZero(
+		context, CXform::ExfSentinel * sizeof(OptimizerXformProfile));
+	for (ULONG ul = 0; ul < CXform::ExfSentinel; ul++)
+	{
+		CXform::EXformId exfid = (CXform::EXformId) ul;
+		if (0 == optimization_stats->XformCalls(exfid))
+		{
+			continue;
+		}
+
+		OptimizerXformProfile *xform = &profile->xforms[profile->num_xforms++];
+		xform->name = CXformFactory::Pxff()->Pxf(exfid)->SzId();
+		xform->calls = optimization_stats->XformCalls(exfid);
+		xform->alternatives = optimization_stats->XformResults(exfid);
+		xform->time_ms =
+			(double) optimization_stats->XformTimeUS(exfid) / GPOS_USEC_IN_MSEC;
+	}
+
+	return profile;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::CanUsePlanCache
+//
+//	@doc:
+//		Can the plan of the given query be looked up in and stored into the
+//		plan cache? Only plain queries are cached; the plans of DML and of
+//		CTAS depend on more than the query DXL
+//
+//---------------------------------------------------------------------------
+BOOL
+COptTasks::CanUsePlanCache(const Query *query)
+{
+	// minidumps are produced by the search
+	if (OPTIMIZER_MINIDUMP_ALWAYS == optimizer_minidump)
+	{
+		return false;
+	}
+
+	return CMD_SELECT == query->commandType &&
+		   PARENTSTMTTYPE_NONE == query->parentStmtType;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::GetPlanCacheKey
+//
+//	@doc:
+//		Build the plan cache key of the given query: the query DXL, followed
+//		by everything else the search depends on, i.e. the optimizer
+//		configuration, the trace flags, and the number of segments
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+COptTasks::GetPlanCacheKey(CMemoryPool *mp, const CDXLNode *query_dxl,
+						   const CDXLNodeArray *query_output_dxlnode_array,
+						   const CDXLNodeArray *cte_dxlnode_array,
+						   const COptimizerConfig *optimizer_config,
+						   ULONG num_segments)
+{
+	CWStringDynamic *key = GPOS_NEW(mp) CWStringDynamic(mp);
+	COstreamString oss(key);
+
+	CDXLUtils::SerializeQuery(mp, oss, query_dxl, query_output_dxlnode_array,
+							  cte_dxlnode_array,
+							  false /*serialize_document_header_footer*/,
+							  false /*indentation*/);
+
+	CXMLSerializer xml_serializer(mp, oss, false /*indentation*/);
+	CBitSet *trace_flags = CTask::Self()->GetTaskCtxt()->copy_trace_flags(mp);
+	optimizer_config->Serialize(mp, &xml_serializer, trace_flags);
+	trace_flags->Release();
+
+	oss << num_segments;
+
+	return key;
+}
+
 
 //---------------------------------------------------------------------------
 //	@function:
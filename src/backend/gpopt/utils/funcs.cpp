@@ -25,6 +25,7 @@ extern "C" {
 #include "gpos/_api.h"
 
 #include "gpopt/gpdbwrappers.h"
+#include "gpopt/optimizer/CPlanCache.h"
 #include "gpopt/utils/COptTasks.h"
 #include "gpopt/utils/funcs.h"
 
@@ -116,3 +117,25 @@ LibraryVersion()
 	PG_RETURN_TEXT_P(result);
 }
 }
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		GetPlanCacheStats
+//
+//	@doc:
+//		Returns the counters of the plan cache of the current backend
+//
+//---------------------------------------------------------------------------
+extern "C" {
+void
+GetPlanCacheStats(int64 *entries, int64 *hits, int64 *misses,
+				  int64 *evictions, int64 *invalidations)
+{
+	*entries = (int64) CPlanCache::ULLGetEntries();
+	*hits = (int64) CPlanCache::ULLGetHits();
+	*misses = (int64) CPlanCache::ULLGetMisses();
+	*evictions = (int64) CPlanCache::ULLGetEvictions();
+	*invalidations = (int64) CPlanCache::ULLGetInvalidations();
+}
+}
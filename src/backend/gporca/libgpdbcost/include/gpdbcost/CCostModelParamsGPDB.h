@@ -310,6 +310,9 @@ public:
 
 	virtual const CHAR *SzNameLookup(ULONG id) const;
 
+	// is there a param with the given name
+	static BOOL FKnownParam(const CHAR *szName);
+
 };	// class CCostModelParamsGPDB
 
 }  // namespace gpopt
@@ -598,4 +598,30 @@ CCostModelParamsGPDB::SzNameLookup(ULONG id) const
 	return rgszCostParamNames[ecp];
 }
 
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCostModelParamsGPDB::FKnownParam
+//
+//	@doc:
+//		Check whether there is a param with the given name; needs no
+//		instance, so that a name can be checked outside of optimization
+//
+//---------------------------------------------------------------------------
+BOOL
+CCostModelParamsGPDB::FKnownParam(const CHAR *szName)
+{
+	GPOS_ASSERT(NULL != szName);
+
+	for (ULONG ul = 0; ul < EcpSentinel; ul++)
+	{
+		if (0 == clib::Strcmp(szName, rgszCostParamNames[ul]))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
 // EOF
@@ -33,6 +33,7 @@ class COptimizationContext;
 class CReqdPropPlan;
 class CReqdPropRelational;
 class CEnumeratorConfig;
+class COptimizationStats;
 
 //---------------------------------------------------------------------------
 //	@class:
@@ -71,7 +72,7 @@ private:
 	// number of calls to each xform
 	UlongPtrArray *m_pdrgpulpXformCalls;
 
-	// time consumed by each xform
+	// time consumed by each xform, in microseconds
 	UlongPtrArray *m_pdrgpulpXformTimes;
 
 	// number of bindings for each xform
@@ -80,6 +81,9 @@ private:
 	// number of alternatives generated by each xform
 	UlongPtrArray *m_pdrgpulpXformResults;
 
+	// counters requested by the optimizer configuration, if any
+	COptimizationStats *m_optimization_stats;
+
 #ifdef GPOS_DEBUG
 
 	// a set of internal debugging function used for recursive
@@ -320,6 +324,13 @@ public:
 		return m_pqc;
 	}
 
+	// counters of the optimization, NULL if they are not collected
+	COptimizationStats *
+	GetOptimizationStats() const
+	{
+		return m_optimization_stats;
+	}
+
 	// return current search stage
 	CSearchStage *
 	PssCurrent() const
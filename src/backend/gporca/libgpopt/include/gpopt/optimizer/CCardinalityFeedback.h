@@ -0,0 +1,195 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (c) 2025 Greengage Community
+//
+//	@filename:
+//		CCardinalityFeedback.h
+//
+//	@doc:
+//		Corrections of cardinality estimates observed in executed plans
+//---------------------------------------------------------------------------
+#ifndef GPOPT_CCardinalityFeedback_H
+#define GPOPT_CCardinalityFeedback_H
+
+#include "gpos/base.h"
+#include "gpos/common/CDouble.h"
+#include "gpos/common/CDynamicPtrArray.h"
+#include "gpos/common/CRefCount.h"
+
+#include "naucrates/dxl/gpdb_types.h"
+#include "naucrates/md/IMDType.h"
+#include "naucrates/statistics/CStatsPredJoin.h"
+
+namespace gpopt
+{
+using namespace gpos;
+using namespace gpnaucrates;
+
+// fwd declarations
+class CColRef;
+class CColRefSet;
+class CExpression;
+class CTableDescriptor;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CCardinalityFeedback
+//
+//	@doc:
+//		Correction factors for the cardinality estimates of filters and inner
+//		equi-joins on base table columns, learned by the executor from the
+//		actual row counts of earlier plans.
+//
+//		A factor is identified by a signature: the kind of estimate and the
+//		base table columns the predicate refers to, each given by the oid of
+//		the table, the attribute number of the column and the shape of the
+//		predicates on the column. The shape records the comparison types
+//		the column is compared with, whether it is compared with anything
+//		but a constant, and whether it appears in any other kind of
+//		predicate, so that "a = 1" and "a < 1" do not share a factor. The
+//		signature of a filter is its sorted, distinct columns, all of a
+//		single table. The signature of a join is its equality predicates,
+//		each written as an ordered pair of columns, sorted and flattened.
+//		The host computes the same signatures from executed plans.
+//
+//		The factors are only applied when an instance is attached to the
+//		optimizer configuration, see COptimizerConfig::SetCardinalityFeedback.
+//		They are not part of the configuration saved in minidumps.
+//
+//---------------------------------------------------------------------------
+class CCardinalityFeedback : public CRefCount
+{
+public:
+	// kind of estimate a factor corrects
+	enum EFeedbackKind
+	{
+		EfkScan,  // rows returned by a filter on a base table
+		EfkJoin,  // rows returned by an inner equi-join
+
+		EfkSentinel
+	};
+
+	// shape of the predicates on a column, a bit mask; the host uses the
+	// same values
+	enum EPredicateShape
+	{
+		EpsEq = 0x01,		  // compared with =
+		EpsNEq = 0x02,		  // compared with <>
+		EpsL = 0x04,		  // compared with <
+		EpsLEq = 0x08,		  // compared with <=
+		EpsG = 0x10,		  // compared with >
+		EpsGEq = 0x20,		  // compared with >=
+		EpsOther = 0x40,	  // any other predicate
+		EpsNonConst = 0x80	  // compared with something but a constant
+	};
+
+	// maximum number of columns of a signature
+	static const ULONG MaxColumns = 8;
+
+	// smallest and largest factor applied
+	static const CDouble MinFactor;
+	static const CDouble MaxFactor;
+
+	// a column of a base table
+	struct SColumn
+	{
+		// oid of the table
+		OID m_rel_oid;
+
+		// attribute number of the column
+		INT m_attno;
+
+		// shape of the predicates on the column, see EPredicateShape
+		ULONG m_shape;
+	};
+
+private:
+	// a correction factor and its signature
+	struct SFeedback
+	{
+		EFeedbackKind m_kind;
+
+		ULONG m_num_cols;
+
+		SColumn m_cols[MaxColumns];
+
+		CDouble m_factor;
+
+		// ctor
+		SFeedback(EFeedbackKind kind, CDouble factor)
+			: m_kind(kind), m_num_cols(0), m_factor(factor)
+		{
+		}
+	};
+
+	typedef CDynamicPtrArray<SFeedback, CleanupDelete> SFeedbackArray;
+
+	// memory pool
+	CMemoryPool *m_mp;
+
+	// all factors
+	SFeedbackArray *m_feedback;
+
+	// private copy ctor
+	CCardinalityFeedback(const CCardinalityFeedback &);
+
+	// compare two columns
+	static INT Compare(const SColumn &col1, const SColumn &col2);
+
+	// sort columns, or column pairs, and remove duplicates
+	static ULONG SortUnique(SColumn *cols, ULONG num_cols, ULONG width);
+
+	// base table column of a column reference
+	static BOOL FTableColumn(const CColRef *colref, SColumn *col);
+
+	// shape of a comparison of a column, possibly written the other way
+	static ULONG UlCmpShape(gpmd::IMDType::ECmpType cmp_type, BOOL fCommuted);
+
+	// add the shape of a predicate on a column to a filter signature
+	static BOOL FAddColumn(const CColRef *colref, ULONG shape, SColumn *cols,
+						   ULONG *num_cols);
+
+	// add the shape of a predicate on several columns to a filter signature
+	static BOOL FAddColumns(CColRefSet *pcrs, ULONG shape, SColumn *cols,
+							ULONG *num_cols);
+
+	// add the columns of a conjunct of a filter to its signature
+	static BOOL FAddConjunct(CExpression *pexpr, SColumn *cols,
+							 ULONG *num_cols);
+
+	// factor with the given signature, 1.0 if there is none
+	CDouble Factor(EFeedbackKind kind, const SColumn *cols,
+				   ULONG num_cols) const;
+
+public:
+	// ctor
+	explicit CCardinalityFeedback(CMemoryPool *mp);
+
+	// dtor
+	virtual ~CCardinalityFeedback();
+
+	// add a factor; the columns must be given in the canonical order
+	void Add(EFeedbackKind kind, const SColumn *cols, ULONG num_cols,
+			 CDouble factor);
+
+	// number of factors
+	ULONG
+	Size() const
+	{
+		return m_feedback->Size();
+	}
+
+	// factor for a filter with the given predicate right on top of a scan
+	// of the given table
+	CDouble ScanFactor(CMemoryPool *mp, CExpression *pexprScalar,
+					   const CTableDescriptor *ptabdesc) const;
+
+	// factor for an inner join with the given predicates
+	CDouble JoinFactor(const CStatsPredJoinArray *join_preds_stats) const;
+
+};	// class CCardinalityFeedback
+}  // namespace gpopt
+
+#endif	// !GPOPT_CCardinalityFeedback_H
+
+// EOF
@@ -0,0 +1,226 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (c) 2025 Greengage Community
+//
+//	@filename:
+//		COptimizationStats.h
+//
+//	@doc:
+//		Counters collected while optimizing a query
+//---------------------------------------------------------------------------
+#ifndef GPOPT_COptimizationStats_H
+#define GPOPT_COptimizationStats_H
+
+#include "gpos/base.h"
+#include "gpos/common/CRefCount.h"
+
+#include "gpopt/search/CJob.h"
+#include "gpopt/xforms/CXform.h"
+
+namespace gpopt
+{
+using namespace gpos;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		COptimizationStats
+//
+//	@doc:
+//		Counters of the work done by the search engine: the jobs run by the
+//		scheduler, the number and time of the job steps of each job type,
+//		and the calls, bindings, alternatives and time of each xform.
+//		Times are wall-clock microseconds.
+//
+//		The counters are only collected when an instance is attached to the
+//		optimizer configuration, see COptimizerConfig::SetOptimizationStats,
+//		and add up over all the queries optimized with that configuration
+//		until they are reset.
+//
+//---------------------------------------------------------------------------
+class COptimizationStats : public CRefCount
+{
+private:
+	// number of xform applications, indexed by xform id
+	ULLONG m_xform_calls[CXform::ExfSentinel];
+
+	// number of bindings the xforms were applied to
+	ULLONG m_xform_bindings[CXform::ExfSentinel];
+
+	// number of alternatives the xforms produced
+	ULLONG m_xform_results[CXform::ExfSentinel];
+
+	// time spent in the xforms
+	ULLONG m_xform_time_us[CXform::ExfSentinel];
+
+	// number of job steps run, indexed by job type
+	ULLONG m_job_steps[CJob::EjtSentinel];
+
+	// time spent running the job steps
+	ULLONG m_job_time_us[CJob::EjtSentinel];
+
+	// scheduler counters
+	ULLONG m_jobs_queued;
+	ULLONG m_jobs_dequeued;
+	ULLONG m_jobs_suspended;
+	ULLONG m_jobs_resumed;
+	ULLONG m_jobs_completed_queued;
+	ULLONG m_jobs_completed;
+
+	// number of groups in the memo
+	ULLONG m_groups;
+
+	// number of queries optimized
+	ULLONG m_queries;
+
+	// private copy ctor
+	COptimizationStats(const COptimizationStats &);
+
+public:
+	// ctor
+	COptimizationStats();
+
+	// reset all counters
+	void Reset();
+
+	// record the application of an xform
+	void
+	RecordXform(CXform::EXformId exfid, ULONG bindings, ULONG results,
+				ULONG time_us)
+	{
+		GPOS_ASSERT(exfid < CXform::ExfSentinel);
+
+		m_xform_calls[exfid]++;
+		m_xform_bindings[exfid] += bindings;
+		m_xform_results[exfid] += results;
+		m_xform_time_us[exfid] += time_us;
+	}
+
+	// record a step of a job, i.e. one run of the job until it completes
+	// or is suspended
+	void
+	RecordJobStep(CJob::EJobType ejt, ULONG time_us)
+	{
+		GPOS_ASSERT(ejt < CJob::EjtSentinel);
+
+		m_job_steps[ejt]++;
+		m_job_time_us[ejt] += time_us;
+	}
+
+	// record the counters of the scheduler at the end of a search
+	void RecordJobs(ULLONG queued, ULLONG dequeued, ULLONG suspended,
+					ULLONG resumed, ULLONG completed_queued,
+					ULLONG completed);
+
+	// record the memo at the end of a search
+	void
+	RecordGroups(ULLONG groups)
+	{
+		m_groups += groups;
+		m_queries++;
+	}
+
+	// number of applications of an xform
+	ULLONG
+	XformCalls(CXform::EXformId exfid) const
+	{
+		return m_xform_calls[exfid];
+	}
+
+	// number of bindings an xform was applied to
+	ULLONG
+	XformBindings(CXform::EXformId exfid) const
+	{
+		return m_xform_bindings[exfid];
+	}
+
+	// number of alternatives an xform produced
+	ULLONG
+	XformResults(CXform::EXformId exfid) const
+	{
+		return m_xform_results[exfid];
+	}
+
+	// time spent in an xform
+	ULLONG
+	XformTimeUS(CXform::EXformId exfid) const
+	{
+		return m_xform_time_us[exfid];
+	}
+
+	// number of steps of the jobs of a type
+	ULLONG
+	JobSteps(CJob::EJobType ejt) const
+	{
+		return m_job_steps[ejt];
+	}
+
+	// time spent in the jobs of a type
+	ULLONG
+	JobTimeUS(CJob::EJobType ejt) const
+	{
+		return m_job_time_us[ejt];
+	}
+
+	// name of a job type
+	static const CHAR *JobName(CJob::EJobType ejt);
+
+	// scheduler counters
+	ULLONG
+	JobsQueued() const
+	{
+		return m_jobs_queued;
+	}
+
+	ULLONG
+	JobsDequeued() const
+	{
+		return m_jobs_dequeued;
+	}
+
+	ULLONG
+	JobsSuspended() const
+	{
+		return m_jobs_suspended;
+	}
+
+	ULLONG
+	JobsResumed() const
+	{
+		return m_jobs_resumed;
+	}
+
+	ULLONG
+	JobsCompletedQueued() const
+	{
+		return m_jobs_completed_queued;
+	}
+
+	ULLONG
+	JobsCompleted() const
+	{
+		return m_jobs_completed;
+	}
+
+	// number of groups in the memo
+	ULLONG
+	Groups() const
+	{
+		return m_groups;
+	}
+
+	// number of queries optimized
+	ULLONG
+	Queries() const
+	{
+		return m_queries;
+	}
+
+	// print counters
+	IOstream &OsPrint(IOstream &os) const;
+
+};	// class COptimizationStats
+}  // namespace gpopt
+
+#endif	// !GPOPT_COptimizationStats_H
+
+// EOF
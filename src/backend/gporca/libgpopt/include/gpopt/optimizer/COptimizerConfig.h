@@ -28,6 +28,8 @@ using namespace gpos;
 
 // forward decl
 class ICostModel;
+class COptimizationStats;
+class CCardinalityFeedback;
 
 //---------------------------------------------------------------------------
 //	@class:
@@ -65,6 +67,14 @@ private:
 	// default window oids
 	CWindowOids *m_window_oids;
 
+	// counters of the optimizations done with this configuration, if any;
+	// not part of the configuration saved in minidumps
+	COptimizationStats *m_optimization_stats;
+
+	// corrections of cardinality estimates observed by the executor, if any;
+	// not part of the configuration saved in minidumps
+	CCardinalityFeedback *m_cardinality_feedback;
+
 public:
 	// ctor
 	COptimizerConfig(CEnumeratorConfig *pec, CStatisticsConfig *stats_config,
@@ -117,6 +127,28 @@ public:
 		return m_hint;
 	}
 
+	// counters of the optimizations, NULL if they are not collected
+	COptimizationStats *
+	GetOptimizationStats() const
+	{
+		return m_optimization_stats;
+	}
+
+	// collect counters of the optimizations in the given object; takes
+	// ownership of a reference
+	void SetOptimizationStats(COptimizationStats *optimization_stats);
+
+	// corrections of cardinality estimates, NULL if there are none
+	CCardinalityFeedback *
+	GetCardinalityFeedback() const
+	{
+		return m_cardinality_feedback;
+	}
+
+	// apply the given corrections of cardinality estimates; takes ownership
+	// of a reference
+	void SetCardinalityFeedback(CCardinalityFeedback *cardinality_feedback);
+
 	// generate default optimizer configurations
 	static COptimizerConfig *PoconfDefault(CMemoryPool *mp);
 
@@ -0,0 +1,250 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (c) 2025 Greengage Community
+//
+//	@filename:
+//		CPlanCache.h
+//
+//	@doc:
+//		Cache of optimized plans keyed on the query DXL
+//---------------------------------------------------------------------------
+#ifndef GPOPT_CPlanCache_H
+#define GPOPT_CPlanCache_H
+
+#include "gpos/base.h"
+#include "gpos/common/CRefCount.h"
+#include "gpos/memory/CCache.h"
+#include "gpos/memory/CCacheAccessor.h"
+#include "gpos/memory/CCacheFactory.h"
+#include "gpos/string/CWStringConst.h"
+
+#include "gpopt/mdcache/CMDAccessor.h"
+#include "naucrates/dxl/operators/CDXLNode.h"
+#include "naucrates/statistics/CHistogram.h"
+
+namespace gpopt
+{
+using namespace gpos;
+using namespace gpmd;
+using namespace gpdxl;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CPlanCacheKey
+//
+//	@doc:
+//		Key for plans in the cache; the serialized query DXL together with
+//		the optimizer configuration it was optimized with
+//
+//---------------------------------------------------------------------------
+class CPlanCacheKey
+{
+private:
+	// serialized query and configuration
+	const CWStringBase *m_str;
+
+	// hash value of the string, computed once
+	ULONG m_hash;
+
+	// private copy ctor
+	CPlanCacheKey(const CPlanCacheKey &);
+
+public:
+	// ctor
+	explicit CPlanCacheKey(const CWStringBase *str);
+
+	// dtor
+	~CPlanCacheKey()
+	{
+	}
+
+	// string representation of the key
+	const CWStringBase *
+	GetStr() const
+	{
+		return m_str;
+	}
+
+	// equality function for using plan keys in a cache
+	static BOOL FEqualPlanKey(CPlanCacheKey *const &pkeyLeft,
+							  CPlanCacheKey *const &pkeyRight);
+
+	// hash function for using plan keys in a cache
+	static ULONG UlHashPlanKey(CPlanCacheKey *const &pkey);
+};
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CPlanCacheEntry
+//
+//	@doc:
+//		A cached plan, along with the row counts of the relations of the
+//		query at the time the plan was produced
+//
+//---------------------------------------------------------------------------
+class CPlanCacheEntry : public CRefCount
+{
+private:
+	// physical plan
+	CDXLNode *m_plan_dxl;
+
+	// relation statistics ids of the relations used by the query
+	IMdIdArray *m_rel_stats_mdids;
+
+	// row counts of the relations the plan was optimized for
+	CDoubleArray *m_rows;
+
+	// relative change of the row count of a relation beyond which the
+	// plan is optimized again
+	static const DOUBLE RowsDriftTolerance;
+
+	// private copy ctor
+	CPlanCacheEntry(const CPlanCacheEntry &);
+
+public:
+	// ctor
+	CPlanCacheEntry(CDXLNode *plan_dxl, IMdIdArray *rel_stats_mdids,
+					CDoubleArray *rows);
+
+	// dtor
+	virtual ~CPlanCacheEntry();
+
+	// physical plan
+	CDXLNode *
+	GetPlan() const
+	{
+		return m_plan_dxl;
+	}
+
+	// have the statistics of any of the relations drifted beyond the
+	// tolerance?
+	BOOL FStatsChanged(CMDAccessor *md_accessor) const;
+};
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CPlanCache
+//
+//	@doc:
+//		A wrapper for a generic cache to hide the details of plan cache
+//		creation and encapsulate a singleton cache object; similar to
+//		CMDCache, and purged together with it
+//
+//---------------------------------------------------------------------------
+class CPlanCache
+{
+public:
+	typedef CCache<CPlanCacheEntry *, CPlanCacheKey *> PlanCache;
+
+	typedef CCacheAccessor<CPlanCacheEntry *, CPlanCacheKey *>
+		PlanCacheAccessor;
+
+private:
+	// pointer to the underlying cache
+	static PlanCache *m_pcache;
+
+	// the maximum size of the cache
+	static ULLONG m_ullCacheQuota;
+
+	// number of lookups that found a plan
+	static ULLONG m_ullHits;
+
+	// number of lookups that did not find a plan
+	static ULLONG m_ullMisses;
+
+	// number of evictions from instances of the cache destroyed so far
+	static ULLONG m_ullEvictions;
+
+	// number of plans dropped other than by eviction, e.g. because of
+	// metadata or statistics changes
+	static ULLONG m_ullInvalidations;
+
+	// private ctor
+	CPlanCache(){};
+
+	// no copy ctor
+	CPlanCache(const CPlanCache &);
+
+	// private dtor
+	~CPlanCache(){};
+
+	// collect the ids of the relations read by the given query tree
+	static void CollectRelMdids(CMemoryPool *mp, const CDXLNode *dxlnode,
+								IMdIdArray *rel_mdids);
+
+public:
+	// initialize underlying cache
+	static void Init();
+
+	// has cache been initialized?
+	static BOOL
+	FInitialized()
+	{
+		return (NULL != m_pcache);
+	}
+
+	// destroy global instance
+	static void Shutdown();
+
+	// reset global instance, dropping all plans
+	static void Reset();
+
+	// set the maximum size of the cache
+	static void SetCacheQuota(ULLONG ullCacheQuota);
+
+	// get the maximum size of the cache
+	static ULLONG ULLGetCacheQuota();
+
+	// global accessor
+	static PlanCache *
+	Pcache()
+	{
+		return m_pcache;
+	}
+
+	// look up the plan for the given key; the returned plan is pinned by
+	// the accessor and must be released by the caller
+	static CDXLNode *PdxlnLookup(CMDAccessor *md_accessor,
+								 PlanCacheAccessor *accessor,
+								 const CWStringBase *key_str);
+
+	// store a copy of the given plan for the given key
+	static void Insert(CMemoryPool *mp, CMDAccessor *md_accessor,
+					   const CWStringBase *key_str, const CDXLNode *query_dxl,
+					   const CDXLNodeArray *cte_producers,
+					   const CDXLNode *plan_dxl);
+
+	// number of cached plans
+	static ULLONG ULLGetEntries();
+
+	// number of lookups that found a plan
+	static ULLONG
+	ULLGetHits()
+	{
+		return m_ullHits;
+	}
+
+	// number of lookups that did not find a plan
+	static ULLONG
+	ULLGetMisses()
+	{
+		return m_ullMisses;
+	}
+
+	// number of times plans were evicted to stay within the quota
+	static ULLONG ULLGetEvictions();
+
+	// number of plans dropped other than by eviction
+	static ULLONG
+	ULLGetInvalidations()
+	{
+		return m_ullInvalidations;
+	}
+
+};	// class CPlanCache
+
+}  // namespace gpopt
+
+#endif	// !GPOPT_CPlanCache_H
+
+// EOF
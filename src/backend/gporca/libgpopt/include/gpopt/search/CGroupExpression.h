@@ -156,6 +156,11 @@ private:
 	void PostprocessTransform(CMemoryPool *pmpLocal, CMemoryPool *pmpGlobal,
 							  CXform *pxform);
 
+	// transform group expression, without measuring the time it takes
+	void TransformUntimed(CMemoryPool *mp, CMemoryPool *pmpLocal,
+						  CXform *pxform, CXformResult *pxfres,
+						  ULONG *pulNumberOfBindings);
+
 	// costing scheme
 	CCost CostCompute(CMemoryPool *mp, CCostContext *pcc) const;
 
@@ -35,19 +35,15 @@ using namespace gpos;
 //		CJobFactory
 //
 //	@doc:
-//		Highly concurrent job factory
+//		Job factory
 //
-//		The factory uses bulk memory allocation to create and recycle jobs with
-//		minimal synchronization. The factory maintains a lock-free list defined
-//		by the class CSyncPool for each job type. This allows concurrent
-//		retrieval of jobs from the lists without the need for synchronization
-//		through heavy locking operations.
-//		A lock-free list is pre-allocated as an array of given size. The
-//		allocation of lock-free lists happens lazily when the first job of a
-//		given type is created.
-//		Each job is given a unique id. When a job needs to be retrieved from
-//		the list, atomic operations are used to reserve a free job object and
-//		return it to the caller.
+//		The factory uses bulk memory allocation to create and recycle jobs.
+//		The factory maintains a pool of pre-allocated jobs, defined by the
+//		class CSyncPool, for each job type. The allocation of a pool happens
+//		lazily when the first job of a given type is created.
+//		Each job is given a unique id which is its index in the pool; free
+//		jobs are tracked by a stack of ids, so reserving a job and returning
+//		it to the pool are constant time operations.
 //
 //---------------------------------------------------------------------------
 class CJobFactory
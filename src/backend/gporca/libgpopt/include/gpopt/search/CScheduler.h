@@ -26,6 +26,7 @@ using namespace gpos;
 
 // prototypes
 class CSchedulerContext;
+class COptimizationStats;
 
 //---------------------------------------------------------------------------
 //	@class:
@@ -188,6 +189,9 @@ public:
 	// print statistics
 	void PrintStats() const;
 
+	// add statistics to the counters of the optimization
+	void RecordStats(COptimizationStats *optimization_stats) const;
+
 #ifdef GPOS_DEBUG
 	// get flag for tracking jobs
 	BOOL
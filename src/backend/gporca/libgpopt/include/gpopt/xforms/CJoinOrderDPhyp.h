@@ -0,0 +1,282 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (C) 2025 Greengage Community
+//
+//	@filename:
+//		CJoinOrderDPhyp.h
+//
+//	@doc:
+//		Join order generation by enumerating the connected subgraphs of
+//		the join graph (DPccp/DPhyp)
+//---------------------------------------------------------------------------
+#ifndef GPOPT_CJoinOrderDPhyp_H
+#define GPOPT_CJoinOrderDPhyp_H
+
+#include "gpos/base.h"
+#include "gpos/common/CHashMap.h"
+#include "gpos/common/DbgPrintMixin.h"
+#include "gpos/io/IOstream.h"
+
+#include "gpopt/operators/CExpression.h"
+#include "gpopt/xforms/CJoinOrder.h"
+
+
+namespace gpopt
+{
+using namespace gpos;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CJoinOrderDPhyp
+//
+//	@doc:
+//		Helper class for creating join orders using dynamic programming
+//		over the join graph, after Moerkotte and Neumann, "Dynamic
+//		Programming Strikes Back" (SIGMOD 2008).
+//
+//		Unlike DP and DPv2, which consider every pair of disjoint sets of
+//		atoms, this enumerator only visits pairs of connected subgraphs
+//		that are connected to each other by a join predicate (csg-cmp
+//		pairs). Each pair is visited exactly once, and a set is combined
+//		only after all of its subsets are final. For chains, cycles and
+//		snowflakes of 20-30 atoms, this is a small fraction of the pairs
+//		considered by an exhaustive search.
+//
+//		Predicates between two atoms are simple edges (DPccp), predicates
+//		between more atoms and the ON predicates of left outer joins are
+//		hyperedges (DPhyp). The right child of a left outer join is only
+//		ever joined on its own, as the right side of the outer join, once
+//		the left side covers every atom that the ON predicate refers to.
+//		This is the same restriction DPv2 applies.
+//
+//		To keep the enumeration cheap, the cardinality of a set of atoms
+//		is estimated with the selectivity of each predicate, which is
+//		derived once, instead of deriving stats for every set. The cost
+//		of a join is the cost used by DPv2, the sum of the rows flowing
+//		out of every join in the tree.
+//
+//		FExpand() returns false if the join graph is not connected,
+//		if there are more than 64 atoms, or if the enumeration exceeds
+//		its budget, in which case the caller should use another
+//		enumerator.
+//
+//---------------------------------------------------------------------------
+class CJoinOrderDPhyp : public CJoinOrder,
+						public gpos::DbgPrintMixin<CJoinOrderDPhyp>
+{
+private:
+	// a set of atoms, one bit per atom
+	typedef ULLONG AtomSet;
+
+	//---------------------------------------------------------------------------
+	//	@struct:
+	//		SPlanInfo
+	//
+	//	@doc:
+	//		Best plan found so far for a set of atoms, in the DP table
+	//
+	//---------------------------------------------------------------------------
+	struct SPlanInfo
+	{
+		// the two sets joined, both 0 for an atom
+		AtomSet m_left;
+		AtomSet m_right;
+
+		// is this a left outer join of m_left with m_right
+		BOOL m_is_loj;
+
+		// estimated rows of the set
+		CDouble m_rows;
+
+		// cost of the best plan
+		CDouble m_cost;
+
+		// ctor
+		SPlanInfo(CDouble rows, CDouble cost)
+			: m_left(0), m_right(0), m_is_loj(false), m_rows(rows), m_cost(cost)
+		{
+		}
+	};
+
+	//---------------------------------------------------------------------------
+	//	@struct:
+	//		STopSplit
+	//
+	//	@doc:
+	//		A way of joining all the atoms, for the top-k alternatives
+	//
+	//---------------------------------------------------------------------------
+	struct STopSplit
+	{
+		AtomSet m_left;
+		AtomSet m_right;
+		BOOL m_is_loj;
+		DOUBLE m_cost;
+	};
+
+	// hash map from a set of atoms to its best plan
+	typedef CHashMap<AtomSet, SPlanInfo, gpos::HashValue<AtomSet>,
+					 gpos::Equals<AtomSet>, CleanupDelete<AtomSet>,
+					 CleanupDelete<SPlanInfo> >
+		AtomSetToPlanMap;
+
+	// the DP table
+	AtomSetToPlanMap *m_plans;
+
+	// all the atoms
+	AtomSet m_all_atoms;
+
+	// atoms connected to each atom by a predicate between two atoms
+	AtomSet *m_neighbors;
+
+	// atoms covered by each edge, 0 for edges not used to join
+	AtomSet *m_edge_atoms;
+
+	// edges between more than two atoms
+	ULongPtrArray *m_hyperedges;
+
+	// estimated selectivity of each edge
+	DOUBLE *m_edge_selectivity;
+
+	// can each edge be the predicate of a hash join
+	BOOL *m_edge_hashable;
+
+	// for the right child of an LOJ, the index of its ON predicate in
+	// m_rgpedge, gpos::ulong_max for the other atoms
+	ULONG *m_atom_loj_edge;
+
+	// for the right child of an LOJ, the atoms that must be on its left
+	AtomSet *m_atom_loj_required;
+
+	// atoms that are the right child of an LOJ
+	AtomSet m_loj_right_atoms;
+
+	// ON predicates of the LOJs, the n-th belongs to LOJ n+1
+	CExpressionArray *m_on_pred_conjuncts;
+
+	// the NAry join child of each ON predicate, NULL if there are no LOJs
+	ULongPtrArray *m_child_pred_indexes;
+
+	// best ways of joining all the atoms, ordered by cost
+	STopSplit *m_top_splits;
+	ULONG m_num_top_splits;
+
+	// next entry of m_top_splits to return
+	ULONG m_next_top_split;
+
+	// number of csg-cmp pairs seen, and the limits for pairs and DP
+	// table entries
+	ULLONG m_num_pairs;
+	ULLONG m_max_pairs;
+	ULLONG m_max_plans;
+
+	// was the budget exceeded
+	BOOL m_exceeded_budget;
+
+	// the index of the lowest atom in a set
+	static ULONG
+	LowestAtom(AtomSet atoms)
+	{
+		GPOS_ASSERT(0 != atoms);
+
+		ULONG ul = 0;
+		while (0 == (atoms & 1))
+		{
+			atoms >>= 1;
+			ul++;
+		}
+		return ul;
+	}
+
+	// the number of atoms in a set
+	static ULONG
+	NumAtoms(AtomSet atoms)
+	{
+		ULONG ul = 0;
+		for (; 0 != atoms; atoms &= atoms - 1)
+		{
+			ul++;
+		}
+		return ul;
+	}
+
+	// the set of atoms with a lower index than the given one, and itself
+	static AtomSet
+	AtomsUpTo(ULONG atom)
+	{
+		return (atom >= 63) ? ~AtomSet(0) : ((AtomSet(1) << (atom + 1)) - 1);
+	}
+
+	// look up the DP table
+	SPlanInfo *
+	Plan(AtomSet atoms) const
+	{
+		return m_plans->Find(&atoms);
+	}
+
+	// build the graph, and estimate the selectivity of the edges
+	void BuildGraph();
+
+	// estimate the selectivity of an edge on the atoms it covers
+	void EstimateEdge(ULONG edge);
+
+	// neighborhood of a set, excluding the given set
+	AtomSet Neighborhood(AtomSet atoms, AtomSet excluded) const;
+
+	// DPhyp enumeration
+	void EnumerateCsgRec(AtomSet csg, AtomSet excluded);
+	void EmitCsg(AtomSet csg);
+	void EnumerateCmpRec(AtomSet csg, AtomSet cmp, AtomSet excluded);
+	void EmitCsgCmp(AtomSet csg, AtomSet cmp);
+
+	// can the two sets be joined, and how
+	BOOL FJoinable(AtomSet left, AtomSet right, AtomSet *outer,
+				   AtomSet *inner, BOOL *is_loj, BOOL *is_hashable,
+				   CDouble *selectivity) const;
+
+	// record a way of joining all the atoms
+	void AddTopSplit(AtomSet left, AtomSet right, BOOL is_loj, CDouble cost);
+
+	// build the expression for the best plan of a set
+	CExpression *PexprBuild(AtomSet atoms, CBitSet *used_edges);
+
+	// build the join of the two given sets
+	CExpression *PexprJoin(AtomSet left, AtomSet right, BOOL is_loj,
+						   CBitSet *used_edges);
+
+	// add a select node with the edges not used by the joins
+	CExpression *PexprAddSelectForUnusedEdges(CExpression *join_expr,
+											  CBitSet *used_edges);
+
+public:
+	// ctor
+	CJoinOrderDPhyp(CMemoryPool *mp, CExpressionArray *pdrgpexprAtoms,
+					CExpressionArray *innerJoinConjuncts,
+					CExpressionArray *onPredConjuncts,
+					ULongPtrArray *childPredIndexes);
+
+	// dtor
+	virtual ~CJoinOrderDPhyp();
+
+	// main handler, returns false if no join order was found
+	BOOL FExpand();
+
+	// return the next of the best join orders, NULL if there are no more
+	CExpression *GetNextOfTopK();
+
+	// print function
+	virtual IOstream &OsPrint(IOstream &) const;
+
+	virtual CXform::EXformId
+	EOriginXForm() const
+	{
+		return CXform::ExfExpandNAryJoinDPhyp;
+	}
+
+};	// class CJoinOrderDPhyp
+
+}  // namespace gpopt
+
+#endif	// !GPOPT_CJoinOrderDPhyp_H
+
+// EOF
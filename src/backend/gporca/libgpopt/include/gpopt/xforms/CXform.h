@@ -224,6 +224,7 @@ public:
 		ExfLeftJoin2RightJoin,
 		ExfRightOuterJoin2HashJoin,
 		ExfImplementInnerJoin,
+		ExfExpandNAryJoinDPhyp,
 		ExfInvalid,
 		ExfSentinel = ExfInvalid
 	};
@@ -341,6 +342,9 @@ public:
 	// returns a set containing xforms to use for exhaustive2 join order
 	static CBitSet *PbsJoinOrderOnExhaustive2Xforms(CMemoryPool *mp);
 
+	// returns a set containing xforms to use for dphyp join order
+	static CBitSet *PbsJoinOrderOnDPhypXforms(CMemoryPool *mp);
+
 	// return true if xform should be applied only once.
 	// for expression of type CPatternTree, in deep trees, the number
 	// of expressions generated for group expression can be significantly
@@ -39,6 +39,7 @@
 #include "gpopt/operators/CPhysicalAgg.h"
 #include "gpopt/operators/CPhysicalMotionGather.h"
 #include "gpopt/operators/CPhysicalSort.h"
+#include "gpopt/optimizer/COptimizationStats.h"
 #include "gpopt/optimizer/COptimizerConfig.h"
 #include "gpopt/search/CBinding.h"
 #include "gpopt/search/CGroup.h"
@@ -85,7 +86,8 @@ CEngine::CEngine(CMemoryPool *mp)
 	  m_pdrgpulpXformCalls(NULL),
 	  m_pdrgpulpXformTimes(NULL),
 	  m_pdrgpulpXformBindings(NULL),
-	  m_pdrgpulpXformResults(NULL)
+	  m_pdrgpulpXformResults(NULL),
+	  m_optimization_stats(NULL)
 {
 	m_pmemo = GPOS_NEW(mp) CMemo(mp);
 	m_pexprEnforcerPattern =
@@ -162,6 +164,10 @@ CEngine::Init(CQueryContext *pqc, CSearchStageArray *search_stage_array)
 					0 == pqc->Prpp()->PcrsRequired()->Size() &&
 						"requiring columns from a zero column expression");
 
+	m_optimization_stats = COptCtxt::PoctxtFromTLS()
+							   ->GetOptimizerConfig()
+							   ->GetOptimizationStats();
+
 	m_search_stage_array = search_stage_array;
 	if (NULL == search_stage_array)
 	{
@@ -355,7 +361,7 @@ void
 CEngine::InsertXformResult(
 	CGroup *pgroupOrigin, CXformResult *pxfres, CXform::EXformId exfidOrigin,
 	CGroupExpression *pgexprOrigin,
-	ULONG ulXformTime,	// time consumed by transformation in msec
+	ULONG ulXformTime,	// time consumed by transformation in usec
 	ULONG ulNumberOfBindings)
 {
 	GPOS_ASSERT(NULL != pxfres);
@@ -363,6 +369,13 @@ CEngine::InsertXformResult(
 	GPOS_ASSERT(CXform::ExfInvalid != exfidOrigin);
 	GPOS_ASSERT(NULL != pgexprOrigin);
 
+	if (NULL != m_optimization_stats)
+	{
+		m_optimization_stats->RecordXform(exfidOrigin, ulNumberOfBindings,
+										  pxfres->Pdrgpexpr()->Size(),
+										  ulXformTime);
+	}
+
 	if (GPOS_FTRACE(EopttracePrintOptimizationStatistics) &&
 		0 < pxfres->Pdrgpexpr()->Size())
 	{
@@ -1570,7 +1583,8 @@ CEngine::PrintActivatedXforms(IOstream &os) const
 				*m_pdrgpulpXformResults)[m_ulCurrSearchStage][pxform->Exfid()];
 			os << pxform->SzId() << ": " << ulCalls << " calls, " << ulBindings
 			   << " total bindings, " << ulResults
-			   << " alternatives generated, " << ulTime << "ms" << std::endl;
+			   << " alternatives generated, " << ulTime / GPOS_USEC_IN_MSEC
+			   << "ms" << std::endl;
 		}
 		os << "[OPT]: <End Xforms - stage " << m_ulCurrSearchStage << ">"
 		   << std::endl;
@@ -1596,6 +1610,8 @@ CEngine::OsPrintMemoryConsumption(IOstream &os, const CHAR *szHeader) const
 	os << std::endl
 	   << szHeader << "Engine: ["
 	   << (DOUBLE) m_mp->TotalAllocatedSize() / GPOPT_MEM_UNIT << "] "
+	   << GPOPT_MEM_UNIT_NAME << ", Engine peak: ["
+	   << (DOUBLE) m_mp->PeakAllocatedSize() / GPOPT_MEM_UNIT << "] "
 	   << GPOPT_MEM_UNIT_NAME << ", MD Cache: ["
 	   << (DOUBLE)(pcache->TotalAllocatedSize()) / GPOPT_MEM_UNIT << "] "
 	   << GPOPT_MEM_UNIT_NAME << ", Total: ["
@@ -1727,6 +1743,11 @@ CEngine::Optimize()
 		FinalizeSearchStage();
 	}
 
+	if (NULL != m_optimization_stats)
+	{
+		sched.RecordStats(m_optimization_stats);
+		m_optimization_stats->RecordGroups(m_pmemo->UlpGroups());
+	}
 
 	if (GPOS_FTRACE(EopttracePrintOptimizationStatistics))
 	{
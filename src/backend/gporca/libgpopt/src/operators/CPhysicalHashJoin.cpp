@@ -949,7 +949,8 @@ CPhysicalHashJoin::CreateOptRequests(CMemoryPool *mp)
 	// from CXformExpandNAryJoinGreedy.
 	CPhysicalJoin *physical_join = dynamic_cast<CPhysicalJoin *>(this);
 	if ((GPOPT_FDISABLED_XFORM(CXform::ExfExpandNAryJoinDP) &&
-		 GPOPT_FDISABLED_XFORM(CXform::ExfExpandNAryJoinDPv2)) ||
+		 GPOPT_FDISABLED_XFORM(CXform::ExfExpandNAryJoinDPv2) &&
+		 GPOPT_FDISABLED_XFORM(CXform::ExfExpandNAryJoinDPhyp)) ||
 		physical_join->OriginXform() == CXform::ExfExpandNAryJoinGreedy)
 	{
 		SetPartPropagateRequests(2);
@@ -0,0 +1,534 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (c) 2025 Greengage Community
+//
+//	@filename:
+//		CCardinalityFeedback.cpp
+//
+//	@doc:
+//		Implementation of the corrections of cardinality estimates
+//---------------------------------------------------------------------------
+
+#include "gpopt/optimizer/CCardinalityFeedback.h"
+
+#include "gpopt/base/CCastUtils.h"
+#include "gpopt/base/CColRefSet.h"
+#include "gpopt/base/CColRefSetIter.h"
+#include "gpopt/base/CColRefTable.h"
+#include "gpopt/base/CColumnFactory.h"
+#include "gpopt/base/COptCtxt.h"
+#include "gpopt/base/CUtils.h"
+#include "gpopt/metadata/CTableDescriptor.h"
+#include "gpopt/operators/CPredicateUtils.h"
+#include "gpopt/operators/CScalarCmp.h"
+#include "gpopt/operators/CScalarIdent.h"
+#include "naucrates/md/CMDIdGPDB.h"
+
+using namespace gpopt;
+using namespace gpmd;
+
+// factors are clamped to this range, so that a single bad observation
+// cannot turn an estimate into nonsense
+const CDouble CCardinalityFeedback::MinFactor(0.000001);
+const CDouble CCardinalityFeedback::MaxFactor(1000000.0);
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::CCardinalityFeedback
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+CCardinalityFeedback::CCardinalityFeedback(CMemoryPool *mp)
+	: m_mp(mp), m_feedback(GPOS_NEW(mp) SFeedbackArray(mp))
+{
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::~CCardinalityFeedback
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CCardinalityFeedback::~CCardinalityFeedback()
+{
+	m_feedback->Release();
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::Compare
+//
+//	@doc:
+//		Compare two columns by table oid, then by attribute number, then
+//		by the shape of their predicates
+//
+//---------------------------------------------------------------------------
+INT
+CCardinalityFeedback::Compare(const SColumn &col1, const SColumn &col2)
+{
+	if (col1.m_rel_oid != col2.m_rel_oid)
+	{
+		return col1.m_rel_oid < col2.m_rel_oid ? -1 : 1;
+	}
+
+	if (col1.m_attno != col2.m_attno)
+	{
+		return col1.m_attno < col2.m_attno ? -1 : 1;
+	}
+
+	if (col1.m_shape != col2.m_shape)
+	{
+		return col1.m_shape < col2.m_shape ? -1 : 1;
+	}
+
+	return 0;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::SortUnique
+//
+//	@doc:
+//		Sort groups of 'width' consecutive columns lexicographically and
+//		remove duplicate groups; returns the number of columns left.
+//		Signatures are short, so an insertion sort will do
+//
+//---------------------------------------------------------------------------
+ULONG
+CCardinalityFeedback::SortUnique(SColumn *cols, ULONG num_cols, ULONG width)
+{
+	GPOS_ASSERT(0 == num_cols % width);
+	GPOS_ASSERT(width <= MaxColumns);
+
+	const ULONG num_groups = num_cols / width;
+
+	for (ULONG ul = 1; ul < num_groups; ul++)
+	{
+		SColumn group[MaxColumns];
+		for (ULONG ulCol = 0; ulCol < width; ulCol++)
+		{
+			group[ulCol] = cols[ul * width + ulCol];
+		}
+
+		ULONG ulPos = ul;
+		while (0 < ulPos)
+		{
+			INT cmp = 0;
+			for (ULONG ulCol = 0; ulCol < width && 0 == cmp; ulCol++)
+			{
+				cmp = Compare(cols[(ulPos - 1) * width + ulCol], group[ulCol]);
+			}
+
+			if (0 >= cmp)
+			{
+				break;
+			}
+
+			for (ULONG ulCol = 0; ulCol < width; ulCol++)
+			{
+				cols[ulPos * width + ulCol] = cols[(ulPos - 1) * width + ulCol];
+			}
+			ulPos--;
+		}
+
+		for (ULONG ulCol = 0; ulCol < width; ulCol++)
+		{
+			cols[ulPos * width + ulCol] = group[ulCol];
+		}
+	}
+
+	ULONG num_unique = 0;
+	for (ULONG ul = 0; ul < num_groups; ul++)
+	{
+		BOOL fDuplicate = (0 < num_unique);
+		for (ULONG ulCol = 0; ulCol < width && fDuplicate; ulCol++)
+		{
+			fDuplicate = (0 == Compare(cols[(num_unique - 1) * width + ulCol],
+									   cols[ul * width + ulCol]));
+		}
+
+		if (!fDuplicate)
+		{
+			for (ULONG ulCol = 0; ulCol < width; ulCol++)
+			{
+				cols[num_unique * width + ulCol] = cols[ul * width + ulCol];
+			}
+			num_unique++;
+		}
+	}
+
+	return num_unique * width;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::FTableColumn
+//
+//	@doc:
+//		Find the base table column a column reference stands for; returns
+//		false if it is a computed or system column
+//
+//---------------------------------------------------------------------------
+BOOL
+CCardinalityFeedback::FTableColumn(const CColRef *colref, SColumn *col)
+{
+	if (CColRef::EcrtTable != colref->Ecrt() ||
+		!IMDId::IsValid(colref->GetMdidTable()))
+	{
+		return false;
+	}
+
+	const CColRefTable *colref_table =
+		dynamic_cast<const CColRefTable *>(colref);
+	const CMDIdGPDB *mdid =
+		dynamic_cast<const CMDIdGPDB *>(colref->GetMdidTable());
+	if (NULL == mdid || colref_table->IsSystemCol())
+	{
+		return false;
+	}
+
+	col->m_rel_oid = mdid->Oid();
+	col->m_attno = colref_table->AttrNum();
+	col->m_shape = 0;
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::UlCmpShape
+//
+//	@doc:
+//		Shape of a comparison of a column; if the comparison is commuted,
+//		the column is its right operand
+//
+//---------------------------------------------------------------------------
+ULONG
+CCardinalityFeedback::UlCmpShape(IMDType::ECmpType cmp_type, BOOL fCommuted)
+{
+	switch (cmp_type)
+	{
+		case IMDType::EcmptEq:
+			return EpsEq;
+		case IMDType::EcmptNEq:
+			return EpsNEq;
+		case IMDType::EcmptL:
+			return fCommuted ? EpsG : EpsL;
+		case IMDType::EcmptLEq:
+			return fCommuted ? EpsGEq : EpsLEq;
+		case IMDType::EcmptG:
+			return fCommuted ? EpsL : EpsG;
+		case IMDType::EcmptGEq:
+			return fCommuted ? EpsLEq : EpsGEq;
+		default:
+			return EpsOther;
+	}
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::FAddColumn
+//
+//	@doc:
+//		Add the shape of a predicate on a column to a filter signature;
+//		returns false if the column is not a column of the table of the
+//		signature, or there are too many columns
+//
+//---------------------------------------------------------------------------
+BOOL
+CCardinalityFeedback::FAddColumn(const CColRef *colref, ULONG shape,
+								 SColumn *cols, ULONG *num_cols)
+{
+	SColumn col;
+	if (!FTableColumn(colref, &col) ||
+		(0 < *num_cols && cols[0].m_rel_oid != col.m_rel_oid))
+	{
+		return false;
+	}
+
+	for (ULONG ul = 0; ul < *num_cols; ul++)
+	{
+		if (cols[ul].m_attno == col.m_attno)
+		{
+			cols[ul].m_shape |= shape;
+			return true;
+		}
+	}
+
+	if (MaxColumns == *num_cols)
+	{
+		return false;
+	}
+
+	col.m_shape = shape;
+	cols[(*num_cols)++] = col;
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::FAddColumns
+//
+//	@doc:
+//		Add the shape of a predicate on several columns to a filter
+//		signature
+//
+//---------------------------------------------------------------------------
+BOOL
+CCardinalityFeedback::FAddColumns(CColRefSet *pcrs, ULONG shape,
+								  SColumn *cols, ULONG *num_cols)
+{
+	CColRefSetIter crsi(*pcrs);
+	while (crsi.Advance())
+	{
+		if (!FAddColumn(crsi.Pcr(), shape, cols, num_cols))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::FAddConjunct
+//
+//	@doc:
+//		Add the columns of a conjunct of a filter to its signature. A
+//		comparison of a column with something gives the column the shape
+//		of the comparison; the columns of anything else, including the
+//		other side of such a comparison, get EpsOther. Must match
+//		cardfeedback_scan_conjunct() on the host
+//
+//---------------------------------------------------------------------------
+BOOL
+CCardinalityFeedback::FAddConjunct(CExpression *pexpr, SColumn *cols,
+								   ULONG *num_cols)
+{
+	if (CUtils::FScalarCmp(pexpr))
+	{
+		CExpression *pexprLeft =
+			CCastUtils::PexprWithoutBinaryCoercibleCasts((*pexpr)[0]);
+		CExpression *pexprRight =
+			CCastUtils::PexprWithoutBinaryCoercibleCasts((*pexpr)[1]);
+		BOOL fCommuted = false;
+
+		if (!CUtils::FScalarIdent(pexprLeft) &&
+			CUtils::FScalarIdent(pexprRight))
+		{
+			std::swap(pexprLeft, pexprRight);
+			fCommuted = true;
+		}
+
+		if (CUtils::FScalarIdent(pexprLeft))
+		{
+			CScalarCmp *popCmp = CScalarCmp::PopConvert(pexpr->Pop());
+			ULONG shape = UlCmpShape(popCmp->ParseCmpType(), fCommuted);
+			if (!CUtils::FScalarConst(pexprRight))
+			{
+				shape |= EpsNonConst;
+			}
+
+			return FAddColumn(CScalarIdent::PopConvert(pexprLeft->Pop())->Pcr(),
+							  shape, cols, num_cols) &&
+				   FAddColumns(pexprRight->DeriveUsedColumns(), EpsOther, cols,
+							   num_cols);
+		}
+	}
+
+	return FAddColumns(pexpr->DeriveUsedColumns(), EpsOther, cols, num_cols);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::Add
+//
+//	@doc:
+//		Add a factor
+//
+//---------------------------------------------------------------------------
+void
+CCardinalityFeedback::Add(EFeedbackKind kind, const SColumn *cols,
+						  ULONG num_cols, CDouble factor)
+{
+	GPOS_ASSERT(kind < EfkSentinel);
+	GPOS_ASSERT(0 < num_cols && num_cols <= MaxColumns);
+
+	SFeedback *feedback = GPOS_NEW(m_mp) SFeedback(
+		kind,
+		std::min(MaxFactor.Get(), std::max(MinFactor.Get(), factor.Get())));
+	feedback->m_num_cols = num_cols;
+	for (ULONG ul = 0; ul < num_cols; ul++)
+	{
+		feedback->m_cols[ul] = cols[ul];
+	}
+
+	m_feedback->Append(feedback);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::Factor
+//
+//	@doc:
+//		Factor with the given signature, 1.0 if there is none
+//
+//---------------------------------------------------------------------------
+CDouble
+CCardinalityFeedback::Factor(EFeedbackKind kind, const SColumn *cols,
+							 ULONG num_cols) const
+{
+	const ULONG size = m_feedback->Size();
+	for (ULONG ul = 0; ul < size; ul++)
+	{
+		const SFeedback *feedback = (*m_feedback)[ul];
+		if (feedback->m_kind != kind || feedback->m_num_cols != num_cols)
+		{
+			continue;
+		}
+
+		BOOL fMatch = true;
+		for (ULONG ulCol = 0; ulCol < num_cols && fMatch; ulCol++)
+		{
+			fMatch = (0 == Compare(feedback->m_cols[ulCol], cols[ulCol]));
+		}
+
+		if (fMatch)
+		{
+			return feedback->m_factor;
+		}
+	}
+
+	return CDouble(1.0);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::ScanFactor
+//
+//	@doc:
+//		Factor for a filter with the given predicate, evaluated right on
+//		top of a scan of the given table; the columns of the predicate must
+//		all belong to that table
+//
+//---------------------------------------------------------------------------
+CDouble
+CCardinalityFeedback::ScanFactor(CMemoryPool *mp, CExpression *pexprScalar,
+								 const CTableDescriptor *ptabdesc) const
+{
+	if (0 == m_feedback->Size() || NULL == ptabdesc)
+	{
+		return CDouble(1.0);
+	}
+
+	const CMDIdGPDB *rel_mdid =
+		dynamic_cast<const CMDIdGPDB *>(ptabdesc->MDId());
+	if (NULL == rel_mdid)
+	{
+		return CDouble(1.0);
+	}
+
+	SColumn cols[MaxColumns];
+	ULONG num_cols = 0;
+	BOOL fValid = true;
+
+	CExpressionArray *pdrgpexpr =
+		CPredicateUtils::PdrgpexprConjuncts(mp, pexprScalar);
+	const ULONG num_conjuncts = pdrgpexpr->Size();
+	for (ULONG ul = 0; ul < num_conjuncts && fValid; ul++)
+	{
+		fValid = FAddConjunct((*pdrgpexpr)[ul], cols, &num_cols);
+	}
+	pdrgpexpr->Release();
+
+	if (!fValid || 0 == num_cols || rel_mdid->Oid() != cols[0].m_rel_oid)
+	{
+		return CDouble(1.0);
+	}
+
+	num_cols = SortUnique(cols, num_cols, 1 /*width*/);
+
+	return Factor(EfkScan, cols, num_cols);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CCardinalityFeedback::JoinFactor
+//
+//	@doc:
+//		Factor for an inner join with the given predicates; all of them
+//		must be equalities between base table columns
+//
+//---------------------------------------------------------------------------
+CDouble
+CCardinalityFeedback::JoinFactor(
+	const CStatsPredJoinArray *join_preds_stats) const
+{
+	const ULONG num_preds = join_preds_stats->Size();
+	if (0 == m_feedback->Size() || 0 == num_preds ||
+		MaxColumns < 2 * num_preds)
+	{
+		return CDouble(1.0);
+	}
+
+	CColumnFactory *col_factory = COptCtxt::PoctxtFromTLS()->Pcf();
+	SColumn cols[MaxColumns];
+
+	for (ULONG ul = 0; ul < num_preds; ul++)
+	{
+		CStatsPredJoin *join_pred_stats = (*join_preds_stats)[ul];
+		CStatsPred::EStatsCmpType cmp_type = join_pred_stats->GetCmpType();
+
+		if ((CStatsPred::EstatscmptEq != cmp_type &&
+			 CStatsPred::EstatscmptEqNDV != cmp_type) ||
+			!join_pred_stats->HasValidColIdOuter() ||
+			!join_pred_stats->HasValidColIdInner())
+		{
+			return CDouble(1.0);
+		}
+
+		SColumn *pair = &cols[2 * ul];
+		if (!FTableColumn(
+				col_factory->LookupColRef(join_pred_stats->ColIdOuter()),
+				&pair[0]) ||
+			!FTableColumn(
+				col_factory->LookupColRef(join_pred_stats->ColIdInner()),
+				&pair[1]))
+		{
+			return CDouble(1.0);
+		}
+
+		pair[0].m_shape = EpsEq;
+		pair[1].m_shape = EpsEq;
+		if (0 < Compare(pair[0], pair[1]))
+		{
+			std::swap(pair[0], pair[1]);
+		}
+	}
+
+	ULONG num_cols = SortUnique(cols, 2 * num_preds, 2 /*width*/);
+
+	return Factor(EfkJoin, cols, num_cols);
+}
+
+
+// EOF
@@ -0,0 +1,165 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (c) 2025 Greengage Community
+//
+//	@filename:
+//		COptimizationStats.cpp
+//
+//	@doc:
+//		Implementation of the counters collected while optimizing a query
+//---------------------------------------------------------------------------
+
+#include "gpopt/optimizer/COptimizationStats.h"
+
+#include "gpopt/xforms/CXformFactory.h"
+
+using namespace gpopt;
+
+// names of the job types, in the order of CJob::EJobType
+static const CHAR *rgszJobNames[] = {
+	"Test",
+	"GroupOptimization",
+	"GroupImplementation",
+	"GroupExploration",
+	"GroupExpressionOptimization",
+	"GroupExpressionImplementation",
+	"GroupExpressionExploration",
+	"Transformation",
+};
+
+GPOS_CPL_ASSERT(CJob::EjtSentinel == GPOS_ARRAY_SIZE(rgszJobNames));
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptimizationStats::COptimizationStats
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+COptimizationStats::COptimizationStats()
+{
+	Reset();
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptimizationStats::Reset
+//
+//	@doc:
+//		Reset all counters
+//
+//---------------------------------------------------------------------------
+void
+COptimizationStats::Reset()
+{
+	for (ULONG ul = 0; ul < CXform::ExfSentinel; ul++)
+	{
+		m_xform_calls[ul] = 0;
+		m_xform_bindings[ul] = 0;
+		m_xform_results[ul] = 0;
+		m_xform_time_us[ul] = 0;
+	}
+
+	for (ULONG ul = 0; ul < CJob::EjtSentinel; ul++)
+	{
+		m_job_steps[ul] = 0;
+		m_job_time_us[ul] = 0;
+	}
+
+	m_jobs_queued = 0;
+	m_jobs_dequeued = 0;
+	m_jobs_suspended = 0;
+	m_jobs_resumed = 0;
+	m_jobs_completed_queued = 0;
+	m_jobs_completed = 0;
+	m_groups = 0;
+	m_queries = 0;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptimizationStats::RecordJobs
+//
+//	@doc:
+//		Record the counters of the scheduler at the end of a search
+//
+//---------------------------------------------------------------------------
+void
+COptimizationStats::RecordJobs(ULLONG queued, ULLONG dequeued,
+							   ULLONG suspended, ULLONG resumed,
+							   ULLONG completed_queued, ULLONG completed)
+{
+	m_jobs_queued += queued;
+	m_jobs_dequeued += dequeued;
+	m_jobs_suspended += suspended;
+	m_jobs_resumed += resumed;
+	m_jobs_completed_queued += completed_queued;
+	m_jobs_completed += completed;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptimizationStats::JobName
+//
+//	@doc:
+//		Name of a job type
+//
+//---------------------------------------------------------------------------
+const CHAR *
+COptimizationStats::JobName(CJob::EJobType ejt)
+{
+	GPOS_ASSERT(ejt < CJob::EjtSentinel);
+
+	return rgszJobNames[ejt];
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptimizationStats::OsPrint
+//
+//	@doc:
+//		Print counters
+//
+//---------------------------------------------------------------------------
+IOstream &
+COptimizationStats::OsPrint(IOstream &os) const
+{
+	os << "Queries: " << m_queries << ", groups: " << m_groups << std::endl;
+	os << "Jobs: queued " << m_jobs_queued << ", dequeued " << m_jobs_dequeued
+	   << ", suspended " << m_jobs_suspended << ", resumed " << m_jobs_resumed
+	   << ", completed queued " << m_jobs_completed_queued << ", completed "
+	   << m_jobs_completed << std::endl;
+
+	for (ULONG ul = 0; ul < CJob::EjtSentinel; ul++)
+	{
+		if (0 != m_job_steps[ul])
+		{
+			os << rgszJobNames[ul] << " jobs: " << m_job_steps[ul]
+			   << " steps, " << m_job_time_us[ul] << "us" << std::endl;
+		}
+	}
+
+	for (ULONG ul = 0; ul < CXform::ExfSentinel; ul++)
+	{
+		if (0 == m_xform_calls[ul])
+		{
+			continue;
+		}
+
+		CXform *pxform = CXformFactory::Pxff()->Pxf((CXform::EXformId) ul);
+		os << pxform->SzId() << ": " << m_xform_calls[ul] << " calls, "
+		   << m_xform_bindings[ul] << " bindings, " << m_xform_results[ul]
+		   << " alternatives, " << m_xform_time_us[ul] << "us" << std::endl;
+	}
+
+	return os;
+}
+
+
+// EOF
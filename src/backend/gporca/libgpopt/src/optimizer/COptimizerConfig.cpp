@@ -16,6 +16,8 @@
 #include "gpos/string/CWStringDynamic.h"
 
 #include "gpopt/cost/ICostModel.h"
+#include "gpopt/optimizer/CCardinalityFeedback.h"
+#include "gpopt/optimizer/COptimizationStats.h"
 #include "naucrates/dxl/CCostModelConfigSerializer.h"
 #include "naucrates/dxl/xml/CXMLSerializer.h"
 
@@ -38,7 +40,9 @@ COptimizerConfig::COptimizerConfig(CEnumeratorConfig *pec,
 	  m_cte_conf(pcteconf),
 	  m_cost_model(cost_model),
 	  m_hint(phint),
-	  m_window_oids(pwindowoids)
+	  m_window_oids(pwindowoids),
+	  m_optimization_stats(NULL),
+	  m_cardinality_feedback(NULL)
 {
 	GPOS_ASSERT(NULL != pec);
 	GPOS_ASSERT(NULL != stats_config);
@@ -64,6 +68,39 @@ COptimizerConfig::~COptimizerConfig()
 	m_cost_model->Release();
 	m_hint->Release();
 	m_window_oids->Release();
+	CRefCount::SafeRelease(m_optimization_stats);
+	CRefCount::SafeRelease(m_cardinality_feedback);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptimizerConfig::SetOptimizationStats
+//
+//	@doc:
+//		Collect counters of the optimizations in the given object
+//
+//---------------------------------------------------------------------------
+void
+COptimizerConfig::SetOptimizationStats(COptimizationStats *optimization_stats)
+{
+	CRefCount::SafeRelease(m_optimization_stats);
+	m_optimization_stats = optimization_stats;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptimizerConfig::SetCardinalityFeedback
+//
+//	@doc:
+//		Apply the given corrections of cardinality estimates
+//
+//---------------------------------------------------------------------------
+void
+COptimizerConfig::SetCardinalityFeedback(
+	CCardinalityFeedback *cardinality_feedback)
+{
+	CRefCount::SafeRelease(m_cardinality_feedback);
+	m_cardinality_feedback = cardinality_feedback;
 }
 
 //---------------------------------------------------------------------------
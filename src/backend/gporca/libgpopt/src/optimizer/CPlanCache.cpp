@@ -0,0 +1,463 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (c) 2025 Greengage Community
+//
+//	@filename:
+//		CPlanCache.cpp
+//
+//	@doc:
+//		Implementation of the cache of optimized plans
+//---------------------------------------------------------------------------
+
+#include "gpopt/optimizer/CPlanCache.h"
+
+#include "gpos/common/CAutoRg.h"
+#include "gpos/io/COstreamString.h"
+#include "gpos/string/CWStringDynamic.h"
+#include "gpos/task/CAutoTraceFlag.h"
+
+#include "naucrates/dxl/CDXLUtils.h"
+#include "naucrates/dxl/operators/CDXLLogicalGet.h"
+#include "naucrates/dxl/operators/CDXLTableDescr.h"
+#include "naucrates/exception.h"
+#include "naucrates/md/CMDIdGPDB.h"
+#include "naucrates/md/CMDIdRelStats.h"
+#include "naucrates/md/IMDRelStats.h"
+
+using namespace gpos;
+using namespace gpmd;
+using namespace gpdxl;
+using namespace gpopt;
+
+
+// global instance of plan cache
+CPlanCache::PlanCache *CPlanCache::m_pcache = NULL;
+
+// maximum size of the cache
+ULLONG CPlanCache::m_ullCacheQuota = UNLIMITED_CACHE_QUOTA;
+
+// relative change of row count that invalidates a cached plan
+const DOUBLE CPlanCacheEntry::RowsDriftTolerance = 0.1;
+
+// counters
+ULLONG CPlanCache::m_ullHits = 0;
+ULLONG CPlanCache::m_ullMisses = 0;
+ULLONG CPlanCache::m_ullEvictions = 0;
+ULLONG CPlanCache::m_ullInvalidations = 0;
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCacheKey::CPlanCacheKey
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+CPlanCacheKey::CPlanCacheKey(const CWStringBase *str) : m_str(str)
+{
+	GPOS_ASSERT(NULL != str);
+
+	m_hash = gpos::HashByteArray((const BYTE *) str->GetBuffer(),
+								 str->Length() * GPOS_SIZEOF(WCHAR));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCacheKey::FEqualPlanKey
+//
+//	@doc:
+//		Equality function for using plan keys in a cache
+//
+//---------------------------------------------------------------------------
+BOOL
+CPlanCacheKey::FEqualPlanKey(CPlanCacheKey *const &pkeyLeft,
+							 CPlanCacheKey *const &pkeyRight)
+{
+	if (NULL == pkeyLeft && NULL == pkeyRight)
+	{
+		return true;
+	}
+
+	if (NULL == pkeyLeft || NULL == pkeyRight)
+	{
+		return false;
+	}
+
+	return pkeyLeft->m_hash == pkeyRight->m_hash &&
+		   pkeyLeft->GetStr()->Equals(pkeyRight->GetStr());
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCacheKey::UlHashPlanKey
+//
+//	@doc:
+//		Hash function for using plan keys in a cache
+//
+//---------------------------------------------------------------------------
+ULONG
+CPlanCacheKey::UlHashPlanKey(CPlanCacheKey *const &pkey)
+{
+	return pkey->m_hash;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCacheEntry::CPlanCacheEntry
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+CPlanCacheEntry::CPlanCacheEntry(CDXLNode *plan_dxl,
+								 IMdIdArray *rel_stats_mdids,
+								 CDoubleArray *rows)
+	: m_plan_dxl(plan_dxl), m_rel_stats_mdids(rel_stats_mdids), m_rows(rows)
+{
+	GPOS_ASSERT(NULL != plan_dxl);
+	GPOS_ASSERT(rel_stats_mdids->Size() == rows->Size());
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCacheEntry::~CPlanCacheEntry
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CPlanCacheEntry::~CPlanCacheEntry()
+{
+	m_plan_dxl->Release();
+	m_rel_stats_mdids->Release();
+	m_rows->Release();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCacheEntry::FStatsChanged
+//
+//	@doc:
+//		Compare the row counts the plan was optimized for with the ones
+//		the metadata accessor sees now. A re-ANALYZE gives slightly
+//		different estimates even if the data did not change, so only a
+//		change of more than RowsDriftTolerance of the old count counts.
+//		Small relations are given a change of at least one row
+//
+//---------------------------------------------------------------------------
+BOOL
+CPlanCacheEntry::FStatsChanged(CMDAccessor *md_accessor) const
+{
+	const ULONG size = m_rel_stats_mdids->Size();
+	for (ULONG ul = 0; ul < size; ul++)
+	{
+		const IMDRelStats *rel_stats =
+			md_accessor->Pmdrelstats((*m_rel_stats_mdids)[ul]);
+
+		DOUBLE old_rows = (*(*m_rows)[ul]).Get();
+		DOUBLE drift = rel_stats->Rows().Get() - old_rows;
+
+		if (drift < 0)
+		{
+			drift = -drift;
+		}
+
+		if (drift >
+			RowsDriftTolerance * std::max(old_rows, 1.0 / RowsDriftTolerance))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::Init
+//
+//	@doc:
+//		Initializes global instance
+//
+//---------------------------------------------------------------------------
+void
+CPlanCache::Init()
+{
+	GPOS_ASSERT(NULL == m_pcache && "Plan cache was already created");
+
+	m_pcache = CCacheFactory::CreateCache<CPlanCacheEntry *, CPlanCacheKey *>(
+		true /*fUnique*/, m_ullCacheQuota, CPlanCacheKey::UlHashPlanKey,
+		CPlanCacheKey::FEqualPlanKey);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::Shutdown
+//
+//	@doc:
+//		Cleans up the underlying cache
+//
+//---------------------------------------------------------------------------
+void
+CPlanCache::Shutdown()
+{
+	if (NULL != m_pcache)
+	{
+		m_ullEvictions += m_pcache->GetEvictionCounter();
+		m_ullInvalidations += m_pcache->Size();
+	}
+
+	GPOS_DELETE(m_pcache);
+	m_pcache = NULL;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::Reset
+//
+//	@doc:
+//		Reset plan cache
+//
+//---------------------------------------------------------------------------
+void
+CPlanCache::Reset()
+{
+	CAutoTraceFlag atf1(EtraceSimulateOOM, false);
+	CAutoTraceFlag atf2(EtraceSimulateAbort, false);
+	CAutoTraceFlag atf3(EtraceSimulateIOError, false);
+	CAutoTraceFlag atf4(EtraceSimulateNetError, false);
+
+	Shutdown();
+	Init();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::SetCacheQuota
+//
+//	@doc:
+//		Set the maximum size of the cache
+//
+//---------------------------------------------------------------------------
+void
+CPlanCache::SetCacheQuota(ULLONG ullCacheQuota)
+{
+	GPOS_ASSERT(NULL != m_pcache && "Plan cache was not created");
+	m_ullCacheQuota = ullCacheQuota;
+	m_pcache->SetCacheQuota(ullCacheQuota);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::ULLGetCacheQuota
+//
+//	@doc:
+//		Get the maximum size of the cache
+//
+//---------------------------------------------------------------------------
+ULLONG
+CPlanCache::ULLGetCacheQuota()
+{
+	GPOS_ASSERT_IMP(NULL != m_pcache,
+					m_pcache->GetCacheQuota() == m_ullCacheQuota);
+	return m_ullCacheQuota;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::ULLGetEntries
+//
+//	@doc:
+//		Number of cached plans
+//
+//---------------------------------------------------------------------------
+ULLONG
+CPlanCache::ULLGetEntries()
+{
+	if (NULL == m_pcache)
+	{
+		return 0;
+	}
+
+	return m_pcache->Size();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::ULLGetEvictions
+//
+//	@doc:
+//		Number of times plans were evicted to stay within the quota
+//
+//---------------------------------------------------------------------------
+ULLONG
+CPlanCache::ULLGetEvictions()
+{
+	if (NULL == m_pcache)
+	{
+		return m_ullEvictions;
+	}
+
+	return m_ullEvictions + m_pcache->GetEvictionCounter();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::CollectRelMdids
+//
+//	@doc:
+//		Collect the ids of the relations read by the given query tree
+//
+//---------------------------------------------------------------------------
+void
+CPlanCache::CollectRelMdids(CMemoryPool *mp, const CDXLNode *dxlnode,
+							IMdIdArray *rel_mdids)
+{
+	GPOS_CHECK_STACK_SIZE;
+
+	Edxlopid op_id = dxlnode->GetOperator()->GetDXLOperator();
+	if (EdxlopLogicalGet == op_id || EdxlopLogicalExternalGet == op_id)
+	{
+		IMDId *rel_mdid = CDXLLogicalGet::Cast(dxlnode->GetOperator())
+							  ->GetDXLTableDescr()
+							  ->MDId();
+		rel_mdids->Append(GPOS_NEW(mp) CMDIdRelStats(GPOS_NEW(mp)
+			CMDIdGPDB(*CMDIdGPDB::CastMdid(rel_mdid))));
+	}
+
+	const ULONG arity = dxlnode->Arity();
+	for (ULONG ul = 0; ul < arity; ul++)
+	{
+		CollectRelMdids(mp, (*dxlnode)[ul], rel_mdids);
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::PdxlnLookup
+//
+//	@doc:
+//		Look up the plan for the given key. A plan is only returned if the
+//		row counts of the relations it reads did not change since it was
+//		produced; stale plans are dropped from the cache
+//
+//---------------------------------------------------------------------------
+CDXLNode *
+CPlanCache::PdxlnLookup(CMDAccessor *md_accessor, PlanCacheAccessor *accessor,
+						const CWStringBase *key_str)
+{
+	GPOS_ASSERT(NULL != m_pcache);
+
+	CPlanCacheKey key(key_str);
+	accessor->Lookup(&key);
+
+	CPlanCacheEntry *entry = accessor->Val();
+	if (NULL == entry)
+	{
+		m_ullMisses++;
+		return NULL;
+	}
+
+	if (entry->FStatsChanged(md_accessor))
+	{
+		// entry is removed once the accessor releases it
+		accessor->MarkForDeletion();
+		m_ullInvalidations++;
+		m_ullMisses++;
+		return NULL;
+	}
+
+	m_ullHits++;
+
+	CDXLNode *plan_dxl = entry->GetPlan();
+	plan_dxl->AddRef();
+
+	return plan_dxl;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CPlanCache::Insert
+//
+//	@doc:
+//		Store a copy of the given plan for the given key. The plan is copied
+//		to the memory pool of the cache entry by serializing and parsing it.
+//		Plans that cannot be copied are not cached
+//
+//---------------------------------------------------------------------------
+void
+CPlanCache::Insert(CMemoryPool *mp, CMDAccessor *md_accessor,
+				   const CWStringBase *key_str, const CDXLNode *query_dxl,
+				   const CDXLNodeArray *cte_producers,
+				   const CDXLNode *plan_dxl)
+{
+	GPOS_ASSERT(NULL != m_pcache);
+
+	CWStringDynamic plan_str(mp);
+	COstreamString oss(&plan_str);
+	CDXLUtils::SerializePlan(mp, oss, plan_dxl, 0 /*plan_id*/,
+							 0 /*plan_space_size*/,
+							 true /*serialize_header_footer*/,
+							 false /*indentation*/);
+
+	CAutoRg<CHAR> a_sz;
+	a_sz = CDXLUtils::CreateMultiByteCharStringFromWCString(
+		mp, plan_str.GetBuffer());
+
+	PlanCacheAccessor accessor(m_pcache);
+	CMemoryPool *entry_mp = accessor.Pmp();
+
+	GPOS_TRY
+	{
+		ULLONG plan_id = 0;
+		ULLONG plan_space_size = 0;
+		CDXLNode *cached_plan_dxl = CDXLUtils::GetPlanDXLNode(
+			entry_mp, a_sz.Rgt(), NULL /*xsd_file_path*/, &plan_id,
+			&plan_space_size);
+
+		IMdIdArray *rel_stats_mdids = GPOS_NEW(entry_mp) IMdIdArray(entry_mp);
+		CollectRelMdids(entry_mp, query_dxl, rel_stats_mdids);
+		const ULONG num_ctes = cte_producers->Size();
+		for (ULONG ul = 0; ul < num_ctes; ul++)
+		{
+			CollectRelMdids(entry_mp, (*cte_producers)[ul], rel_stats_mdids);
+		}
+
+		CDoubleArray *rows = GPOS_NEW(entry_mp) CDoubleArray(entry_mp);
+		const ULONG num_rels = rel_stats_mdids->Size();
+		for (ULONG ul = 0; ul < num_rels; ul++)
+		{
+			const IMDRelStats *rel_stats =
+				md_accessor->Pmdrelstats((*rel_stats_mdids)[ul]);
+			rows->Append(GPOS_NEW(entry_mp) CDouble(rel_stats->Rows()));
+		}
+
+		CPlanCacheEntry *entry = GPOS_NEW(entry_mp)
+			CPlanCacheEntry(cached_plan_dxl, rel_stats_mdids, rows);
+
+		// the key owns a copy of the string, allocated along with the plan
+		CPlanCacheKey *key = GPOS_NEW(entry_mp) CPlanCacheKey(
+			GPOS_NEW(entry_mp) CWStringConst(entry_mp, key_str->GetBuffer()));
+
+		// the cache takes over the entry; if another plan was cached for
+		// the same key in the meantime, the new one is discarded along with
+		// the memory pool of the accessor
+		(void) accessor.Insert(key, entry);
+
+		// the cache entry holds its own reference
+		entry->Release();
+	}
+	GPOS_CATCH_EX(ex)
+	{
+		if (gpdxl::ExmaDXL != ex.Major())
+		{
+			GPOS_RETHROW(ex);
+		}
+
+		// the plan could not be copied, optimize it again next time
+		GPOS_RESET_EX;
+	}
+	GPOS_CATCH_END;
+}
+
+// EOF
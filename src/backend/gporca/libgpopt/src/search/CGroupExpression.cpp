@@ -12,6 +12,7 @@
 #include "gpopt/search/CGroupExpression.h"
 
 #include "gpos/base.h"
+#include "gpos/common/CWallClock.h"
 #include "gpos/error/CAutoTrace.h"
 #include "gpos/io/COstreamString.h"
 #include "gpos/string/CWStringDynamic.h"
@@ -769,28 +770,51 @@ void
 CGroupExpression::Transform(
 	CMemoryPool *mp, CMemoryPool *pmpLocal, CXform *pxform,
 	CXformResult *pxfres,
-	ULONG *pulElapsedTime,	// output: elapsed time in millisecond
+	ULONG *pulElapsedTime,	// output: elapsed time in microseconds
 	ULONG *pulNumberOfBindings)
 {
 	GPOS_ASSERT(NULL != pulElapsedTime);
-	GPOS_CHECK_ABORT;
 
-	BOOL fPrintOptStats = GPOS_FTRACE(EopttracePrintOptimizationStatistics);
-	CTimerUser timer;
-	if (fPrintOptStats)
+	COptimizerConfig *optconfig =
+		COptCtxt::PoctxtFromTLS()->GetOptimizerConfig();
+
+	// the time is measured for the optimization statistics and profile only,
+	// as reading the clock for every xform shows in the optimization time
+	if (GPOS_FTRACE(EopttracePrintOptimizationStatistics) ||
+		NULL != optconfig->GetOptimizationStats())
+	{
+		CWallClock timer;
+		TransformUntimed(mp, pmpLocal, pxform, pxfres, pulNumberOfBindings);
+		*pulElapsedTime = timer.ElapsedUS();
+	}
+	else
 	{
-		timer.Restart();
+		TransformUntimed(mp, pmpLocal, pxform, pxfres, pulNumberOfBindings);
+		*pulElapsedTime = 0;
 	}
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CGroupExpression::TransformUntimed
+//
+//	@doc:
+//		Transform group expression using the given xform, without measuring
+//		the time it takes
+//
+//---------------------------------------------------------------------------
+void
+CGroupExpression::TransformUntimed(CMemoryPool *mp, CMemoryPool *pmpLocal,
+								   CXform *pxform, CXformResult *pxfres,
+								   ULONG *pulNumberOfBindings)
+{
+	GPOS_CHECK_ABORT;
 
-	*pulElapsedTime = 0;
 	// check traceflag and compatibility with origin xform
 	if (GPOPT_FDISABLED_XFORM(pxform->Exfid()) ||
 		!pxform->FCompatible(m_exfidOrigin))
 	{
-		if (fPrintOptStats)
-		{
-			*pulElapsedTime = timer.ElapsedMS();
-		}
 		return;
 	}
 
@@ -800,10 +824,6 @@ CGroupExpression::Transform(
 	exprhdl.DeriveProps(NULL /*pdpctxt*/);
 	if (CXform::ExfpNone == pxform->Exfp(exprhdl))
 	{
-		if (GPOS_FTRACE(EopttracePrintOptimizationStatistics))
-		{
-			*pulElapsedTime = timer.ElapsedMS();
-		}
 		return;
 	}
 
@@ -849,11 +869,6 @@ CGroupExpression::Transform(
 
 	// post-prcoessing before applying xform to group expression
 	PostprocessTransform(pmpLocal, mp, pxform);
-
-	if (fPrintOptStats)
-	{
-		*pulElapsedTime = timer.ElapsedMS();
-	}
 }
 
 
@@ -12,8 +12,11 @@
 #include "gpopt/search/CScheduler.h"
 
 #include "gpos/base.h"
+#include "gpos/common/CWallClock.h"
 #include "gpos/error/CAutoTrace.h"
 
+#include "gpopt/engine/CEngine.h"
+#include "gpopt/optimizer/COptimizationStats.h"
 #include "gpopt/search/CJobFactory.h"
 #include "gpopt/search/CSchedulerContext.h"
 #include "naucrates/traceflags/traceflags.h"
@@ -113,15 +116,30 @@ CScheduler::ExecuteJobs(CSchedulerContext *psc)
 	CJob *pj = NULL;
 	ULONG count = 0;
 
+	// job steps are only timed when the counters are collected
+	COptimizationStats *optimization_stats =
+		psc->Peng()->GetOptimizationStats();
+	CWallClock clock;
+
 	// keep retrieving jobs
 	while (NULL != (pj = PjRetrieve()))
 	{
 		// prepare for job execution
 		PreExecute(pj);
 
+		if (NULL != optimization_stats)
+		{
+			clock.Restart();
+		}
+
 		// execute job
 		BOOL fCompleted = FExecute(pj, psc);
 
+		if (NULL != optimization_stats)
+		{
+			optimization_stats->RecordJobStep(pj->Ejt(), clock.ElapsedUS());
+		}
+
 #ifdef GPOS_DEBUG
 		// restrict parallelism to keep track of jobs
 		if (FTrackingJobs())
@@ -573,6 +591,25 @@ CScheduler::PrintStats() const
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CScheduler::RecordStats
+//
+//	@doc:
+//		Add statistics to the counters of the optimization
+//
+//---------------------------------------------------------------------------
+void
+CScheduler::RecordStats(COptimizationStats *optimization_stats) const
+{
+	GPOS_ASSERT(NULL != optimization_stats);
+
+	optimization_stats->RecordJobs(
+		m_ulpStatsQueued, m_ulpStatsDequeued, m_ulpStatsSuspended,
+		m_ulpStatsResumed, m_ulpStatsCompletedQueued, m_ulpStatsCompleted);
+}
+
+
 #ifdef GPOS_DEBUG
 
 //---------------------------------------------------------------------------
@@ -0,0 +1,909 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (C) 2025 Greengage Community
+//
+//	@filename:
+//		CJoinOrderDPhyp.cpp
+//
+//	@doc:
+//		Implementation of join order generation by enumerating the
+//		connected subgraphs of the join graph
+//---------------------------------------------------------------------------
+
+#include "gpopt/xforms/CJoinOrderDPhyp.h"
+
+#include "gpos/base.h"
+#include "gpos/common/CBitSet.h"
+#include "gpos/common/CBitSetIter.h"
+
+#include "gpopt/base/CUtils.h"
+#include "gpopt/engine/CHint.h"
+#include "gpopt/operators/CLogicalInnerJoin.h"
+#include "gpopt/operators/CLogicalLeftOuterJoin.h"
+#include "gpopt/operators/CLogicalNAryJoin.h"
+#include "gpopt/operators/CLogicalSelect.h"
+#include "gpopt/operators/CPredicateUtils.h"
+#include "gpopt/optimizer/COptimizerConfig.h"
+
+using namespace gpopt;
+
+// how many expressions will we return?
+#define GPOPT_DPHYP_JOIN_ORDERING_TOPK 5
+// largest join we enumerate, one bit per atom in an AtomSet
+#define GPOPT_DPHYP_MAX_ATOMS 64
+// cost penalty (a factor) for joins without a hashable predicate, same
+// as the default cross product penalty of DPv2
+#define GPOPT_DPHYP_NLJ_PENALTY 1024
+// the budget grows with optimizer_join_order_threshold up to this value
+#define GPOPT_DPHYP_MAX_BUDGET_THRESHOLD 14
+// log2 of the number of DP table entries and csg-cmp pairs we allow for
+// each atom of optimizer_join_order_threshold
+#define GPOPT_DPHYP_PLANS_BUDGET_SHIFT 6
+#define GPOPT_DPHYP_PAIRS_BUDGET_SHIFT 10
+// number of chains of the DP table
+#define GPOPT_DPHYP_PLAN_CHAINS 4099
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::CJoinOrderDPhyp
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+CJoinOrderDPhyp::CJoinOrderDPhyp(CMemoryPool *mp,
+								 CExpressionArray *pdrgpexprAtoms,
+								 CExpressionArray *innerJoinConjuncts,
+								 CExpressionArray *onPredConjuncts,
+								 ULongPtrArray *childPredIndexes)
+	: CJoinOrder(mp, pdrgpexprAtoms, innerJoinConjuncts, onPredConjuncts,
+				 childPredIndexes),
+	  m_plans(NULL),
+	  m_all_atoms(0),
+	  m_neighbors(NULL),
+	  m_edge_atoms(NULL),
+	  m_hyperedges(NULL),
+	  m_edge_selectivity(NULL),
+	  m_edge_hashable(NULL),
+	  m_atom_loj_edge(NULL),
+	  m_atom_loj_required(NULL),
+	  m_loj_right_atoms(0),
+	  m_on_pred_conjuncts(onPredConjuncts),
+	  m_child_pred_indexes(childPredIndexes),
+	  m_top_splits(NULL),
+	  m_num_top_splits(0),
+	  m_next_top_split(0),
+	  m_num_pairs(0),
+	  m_max_pairs(0),
+	  m_max_plans(0),
+	  m_exceeded_budget(false)
+{
+	// scale the budget with the largest join for which DPv2 does an
+	// exhaustive search
+	COptimizerConfig *optimizer_config =
+		COptCtxt::PoctxtFromTLS()->GetOptimizerConfig();
+	ULONG threshold = std::min(optimizer_config->GetHint()->UlJoinOrderDPLimit(),
+							   ULONG(GPOPT_DPHYP_MAX_BUDGET_THRESHOLD));
+
+	m_max_plans = ULLONG(1) << (threshold + GPOPT_DPHYP_PLANS_BUDGET_SHIFT);
+	m_max_pairs = ULLONG(1) << (threshold + GPOPT_DPHYP_PAIRS_BUDGET_SHIFT);
+
+	m_top_splits =
+		GPOS_NEW_ARRAY(mp, STopSplit, GPOPT_DPHYP_JOIN_ORDERING_TOPK);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::~CJoinOrderDPhyp
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CJoinOrderDPhyp::~CJoinOrderDPhyp()
+{
+#ifdef GPOS_DEBUG
+	// in optimized build, we flush-down memory pools without leak checking,
+	// we can save time in optimized build by skipping all de-allocations here,
+	// we still have all de-allocations enabled in debug-build to detect any possible leaks
+	CRefCount::SafeRelease(m_plans);
+	CRefCount::SafeRelease(m_hyperedges);
+	CRefCount::SafeRelease(m_child_pred_indexes);
+	m_on_pred_conjuncts->Release();
+	GPOS_DELETE_ARRAY(m_neighbors);
+	GPOS_DELETE_ARRAY(m_edge_atoms);
+	GPOS_DELETE_ARRAY(m_edge_selectivity);
+	GPOS_DELETE_ARRAY(m_edge_hashable);
+	GPOS_DELETE_ARRAY(m_atom_loj_edge);
+	GPOS_DELETE_ARRAY(m_atom_loj_required);
+	GPOS_DELETE_ARRAY(m_top_splits);
+#endif	// GPOS_DEBUG
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::BuildGraph
+//
+//	@doc:
+//		Turn the edges into the join graph: predicates between two atoms
+//		are simple edges, predicates between more atoms are hyperedges.
+//		The ON predicate of an LOJ connects its right child with the atoms
+//		the predicate refers to. Predicates on a single atom don't join
+//		anything, they go into a select on top of the joins.
+//
+//---------------------------------------------------------------------------
+void
+CJoinOrderDPhyp::BuildGraph()
+{
+	GPOS_ASSERT(GPOPT_DPHYP_MAX_ATOMS >= m_ulComps);
+
+	m_all_atoms = (GPOPT_DPHYP_MAX_ATOMS == m_ulComps)
+					  ? ~AtomSet(0)
+					  : ((AtomSet(1) << m_ulComps) - 1);
+
+	m_neighbors = GPOS_NEW_ARRAY(m_mp, AtomSet, m_ulComps);
+	m_atom_loj_edge = GPOS_NEW_ARRAY(m_mp, ULONG, m_ulComps);
+	m_atom_loj_required = GPOS_NEW_ARRAY(m_mp, AtomSet, m_ulComps);
+	for (ULONG ul = 0; ul < m_ulComps; ul++)
+	{
+		m_neighbors[ul] = 0;
+		m_atom_loj_edge[ul] = gpos::ulong_max;
+		m_atom_loj_required[ul] = 0;
+	}
+
+	m_edge_atoms = GPOS_NEW_ARRAY(m_mp, AtomSet, m_ulEdges);
+	m_edge_selectivity = GPOS_NEW_ARRAY(m_mp, DOUBLE, m_ulEdges);
+	m_edge_hashable = GPOS_NEW_ARRAY(m_mp, BOOL, m_ulEdges);
+	m_hyperedges = GPOS_NEW(m_mp) ULongPtrArray(m_mp);
+
+	for (ULONG ul = 0; ul < m_ulEdges; ul++)
+	{
+		SEdge *pedge = m_rgpedge[ul];
+		AtomSet atoms = 0;
+
+		m_edge_atoms[ul] = 0;
+		m_edge_selectivity[ul] = 1.0;
+		m_edge_hashable[ul] = false;
+
+		CBitSetIter bsi(*pedge->m_pbs);
+		while (bsi.Advance())
+		{
+			atoms |= AtomSet(1) << bsi.Bit();
+		}
+
+		if (0 < pedge->m_loj_num)
+		{
+			// the ON predicate of an LOJ, find its right child
+			ULONG right_atom = gpos::ulong_max;
+			for (ULONG c = 0; c < m_child_pred_indexes->Size(); c++)
+			{
+				if (*(*m_child_pred_indexes)[c] == pedge->m_loj_num)
+				{
+					right_atom = c;
+					break;
+				}
+			}
+			GPOS_ASSERT(right_atom < m_ulComps);
+
+			AtomSet right = AtomSet(1) << right_atom;
+			m_atom_loj_edge[right_atom] = ul;
+			m_atom_loj_required[right_atom] = atoms & ~right;
+			m_loj_right_atoms |= right;
+		}
+
+		if (2 > NumAtoms(atoms))
+		{
+			continue;
+		}
+
+		m_edge_atoms[ul] = atoms;
+		if (2 == NumAtoms(atoms))
+		{
+			ULONG first = LowestAtom(atoms);
+			ULONG second = LowestAtom(atoms & (atoms - 1));
+
+			m_neighbors[first] |= AtomSet(1) << second;
+			m_neighbors[second] |= AtomSet(1) << first;
+		}
+		else
+		{
+			m_hyperedges->Append(GPOS_NEW(m_mp) ULONG(ul));
+		}
+
+		EstimateEdge(ul);
+	}
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::EstimateEdge
+//
+//	@doc:
+//		Derive the stats of the join of the atoms covered by an edge, with
+//		the edge as the only predicate, to get the selectivity of the edge.
+//		For an ON predicate, this is the selectivity of the corresponding
+//		inner join.
+//
+//---------------------------------------------------------------------------
+void
+CJoinOrderDPhyp::EstimateEdge(ULONG edge)
+{
+	AtomSet atoms = m_edge_atoms[edge];
+	CExpressionArray *pdrgpexpr = GPOS_NEW(m_mp) CExpressionArray(m_mp);
+	CDouble cross_rows(1.0);
+
+	for (AtomSet rest = atoms; 0 != rest; rest &= rest - 1)
+	{
+		CExpression *pexprAtom = m_rgpcomp[LowestAtom(rest)]->m_pexpr;
+
+		DeriveStats(pexprAtom);
+		cross_rows =
+			cross_rows * std::max(CDouble(1.0), pexprAtom->Pstats()->Rows());
+		pexprAtom->AddRef();
+		pdrgpexpr->Append(pexprAtom);
+	}
+
+	CExpression *pexprPred = m_rgpedge[edge]->m_pexpr;
+	pexprPred->AddRef();
+
+	CExpression *pexprJoin = NULL;
+	if (2 == pdrgpexpr->Size())
+	{
+		(*pdrgpexpr)[0]->AddRef();
+		(*pdrgpexpr)[1]->AddRef();
+		pexprJoin = CUtils::PexprLogicalJoin<CLogicalInnerJoin>(
+			m_mp, (*pdrgpexpr)[0], (*pdrgpexpr)[1], pexprPred);
+		pdrgpexpr->Release();
+
+		m_edge_hashable[edge] = CUtils::IsHashJoinPossible(m_mp, pexprJoin);
+	}
+	else
+	{
+		// a hyperedge, we can't tell which sides a hash join would have
+		pdrgpexpr->Append(pexprPred);
+		pexprJoin = GPOS_NEW(m_mp)
+			CExpression(m_mp, GPOS_NEW(m_mp) CLogicalNAryJoin(m_mp), pdrgpexpr);
+	}
+
+	DeriveStats(pexprJoin);
+	m_edge_selectivity[edge] =
+		std::min(CDouble(1.0), pexprJoin->Pstats()->Rows() / cross_rows).Get();
+	pexprJoin->Release();
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::Neighborhood
+//
+//	@doc:
+//		The atoms adjacent to a set, that are not in the set or in the
+//		excluded atoms. For a hyperedge, this only returns the lowest of
+//		the atoms it needs besides those in the set, the others are added
+//		as the enumeration grows the set.
+//
+//---------------------------------------------------------------------------
+CJoinOrderDPhyp::AtomSet
+CJoinOrderDPhyp::Neighborhood(AtomSet atoms, AtomSet excluded) const
+{
+	AtomSet neighbors = 0;
+
+	excluded |= atoms;
+
+	for (AtomSet rest = atoms; 0 != rest; rest &= rest - 1)
+	{
+		neighbors |= m_neighbors[LowestAtom(rest)];
+	}
+	neighbors &= ~excluded;
+
+	const ULONG num_hyperedges = m_hyperedges->Size();
+	for (ULONG ul = 0; ul < num_hyperedges; ul++)
+	{
+		AtomSet edge_atoms = m_edge_atoms[*(*m_hyperedges)[ul]];
+		AtomSet others = edge_atoms & ~atoms;
+
+		if (0 != (edge_atoms & atoms) && 0 != others &&
+			0 == (others & excluded))
+		{
+			neighbors |= others & (~others + 1);
+		}
+	}
+
+	return neighbors;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::EnumerateCsgRec
+//
+//	@doc:
+//		Grow a connected subgraph with its neighbors, except the excluded
+//		atoms, and emit every extension that is connected
+//
+//---------------------------------------------------------------------------
+void
+CJoinOrderDPhyp::EnumerateCsgRec(AtomSet csg, AtomSet excluded)
+{
+	GPOS_CHECK_STACK_SIZE;
+
+	AtomSet neighbors = Neighborhood(csg, excluded);
+	if (0 == neighbors)
+	{
+		return;
+	}
+
+	// visit the subsets of the neighborhood in increasing order
+	AtomSet subset = 0;
+	while (0 != (subset = (subset - neighbors) & neighbors))
+	{
+		if (NULL != Plan(csg | subset))
+		{
+			EmitCsg(csg | subset);
+		}
+		if (m_exceeded_budget)
+		{
+			return;
+		}
+	}
+
+	excluded |= neighbors;
+	subset = 0;
+	while (0 != (subset = (subset - neighbors) & neighbors))
+	{
+		EnumerateCsgRec(csg | subset, excluded);
+		if (m_exceeded_budget)
+		{
+			return;
+		}
+	}
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::EmitCsg
+//
+//	@doc:
+//		Find the complements of a connected subgraph. Only atoms higher
+//		than the lowest atom of the subgraph are considered, so that each
+//		pair is seen once.
+//
+//---------------------------------------------------------------------------
+void
+CJoinOrderDPhyp::EmitCsg(AtomSet csg)
+{
+	GPOS_CHECK_ABORT;
+
+	AtomSet excluded = csg | AtomsUpTo(LowestAtom(csg));
+	AtomSet neighbors = Neighborhood(csg, excluded);
+
+	// start from the highest neighbor
+	for (ULONG ul = m_ulComps; 0 < ul && !m_exceeded_budget; ul--)
+	{
+		ULONG atom = ul - 1;
+		AtomSet cmp = AtomSet(1) << atom;
+
+		if (0 == (neighbors & cmp))
+		{
+			continue;
+		}
+
+		EmitCsgCmp(csg, cmp);
+		EnumerateCmpRec(csg, cmp, excluded | (AtomsUpTo(atom) & neighbors));
+	}
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::EnumerateCmpRec
+//
+//	@doc:
+//		Grow a complement with its neighbors, except the excluded atoms,
+//		and emit every extension that is connected
+//
+//---------------------------------------------------------------------------
+void
+CJoinOrderDPhyp::EnumerateCmpRec(AtomSet csg, AtomSet cmp, AtomSet excluded)
+{
+	GPOS_CHECK_STACK_SIZE;
+
+	AtomSet neighbors = Neighborhood(cmp, excluded);
+	if (0 == neighbors)
+	{
+		return;
+	}
+
+	AtomSet subset = 0;
+	while (0 != (subset = (subset - neighbors) & neighbors))
+	{
+		if (NULL != Plan(cmp | subset))
+		{
+			EmitCsgCmp(csg, cmp | subset);
+		}
+		if (m_exceeded_budget)
+		{
+			return;
+		}
+	}
+
+	excluded |= neighbors;
+	subset = 0;
+	while (0 != (subset = (subset - neighbors) & neighbors))
+	{
+		EnumerateCmpRec(csg, cmp | subset, excluded);
+		if (m_exceeded_budget)
+		{
+			return;
+		}
+	}
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::FJoinable
+//
+//	@doc:
+//		Can the two given sets be joined, and if so, which one is the outer
+//		side, is it an LOJ, is there a hashable predicate, and what is the
+//		selectivity of the join predicate.
+//
+//		The right child of an LOJ on its own can only be joined as the
+//		inner side of its LOJ, with an outer side that covers the other
+//		atoms of the ON predicate. Any other join is an inner join and
+//		needs a predicate between the two sets.
+//
+//---------------------------------------------------------------------------
+BOOL
+CJoinOrderDPhyp::FJoinable(AtomSet left, AtomSet right, AtomSet *outer,
+						   AtomSet *inner, BOOL *is_loj, BOOL *is_hashable,
+						   CDouble *selectivity) const
+{
+	BOOL left_is_loj_child =
+		(1 == NumAtoms(left) && 0 != (left & m_loj_right_atoms));
+	BOOL right_is_loj_child =
+		(1 == NumAtoms(right) && 0 != (right & m_loj_right_atoms));
+
+	*is_loj = false;
+	*is_hashable = false;
+	*selectivity = 1.0;
+
+	if (left_is_loj_child && right_is_loj_child)
+	{
+		// one would have to be the outer side of an LOJ on its own
+		return false;
+	}
+
+	if (left_is_loj_child || right_is_loj_child)
+	{
+		*outer = right_is_loj_child ? left : right;
+		*inner = right_is_loj_child ? right : left;
+
+		ULONG atom = LowestAtom(*inner);
+		AtomSet required = m_atom_loj_required[atom];
+		if (required != (*outer & required))
+		{
+			// the outer side does not produce all the values needed in
+			// the ON predicate
+			return false;
+		}
+
+		ULONG edge = m_atom_loj_edge[atom];
+		*is_loj = true;
+		*is_hashable = m_edge_hashable[edge];
+		*selectivity = m_edge_selectivity[edge];
+
+		return true;
+	}
+
+	BOOL found = false;
+	AtomSet atoms = left | right;
+	for (ULONG ul = 0; ul < m_ulEdges; ul++)
+	{
+		AtomSet edge_atoms = m_edge_atoms[ul];
+
+		if (0 == m_rgpedge[ul]->m_loj_num && 0 != edge_atoms &&
+			0 == (edge_atoms & ~atoms) && 0 != (edge_atoms & left) &&
+			0 != (edge_atoms & right))
+		{
+			found = true;
+			*is_hashable = *is_hashable || m_edge_hashable[ul];
+			*selectivity = *selectivity * m_edge_selectivity[ul];
+		}
+	}
+
+	if (!found)
+	{
+		return false;
+	}
+
+	// the smaller side goes on the inner side, where the hash table is
+	// built; join commutativity still considers the other way round
+	if (Plan(left)->m_rows < Plan(right)->m_rows)
+	{
+		*outer = right;
+		*inner = left;
+	}
+	else
+	{
+		*outer = left;
+		*inner = right;
+	}
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::EmitCsgCmp
+//
+//	@doc:
+//		Consider joining a connected subgraph with its complement, and
+//		keep the join if it is the cheapest for their union
+//
+//---------------------------------------------------------------------------
+void
+CJoinOrderDPhyp::EmitCsgCmp(AtomSet csg, AtomSet cmp)
+{
+	GPOS_ASSERT(0 == (csg & cmp));
+
+	if (++m_num_pairs > m_max_pairs)
+	{
+		m_exceeded_budget = true;
+		return;
+	}
+
+	AtomSet outer = 0;
+	AtomSet inner = 0;
+	BOOL is_loj = false;
+	BOOL is_hashable = false;
+	CDouble selectivity(1.0);
+
+	if (!FJoinable(csg, cmp, &outer, &inner, &is_loj, &is_hashable,
+				   &selectivity))
+	{
+		return;
+	}
+
+	SPlanInfo *outer_plan = Plan(outer);
+	SPlanInfo *inner_plan = Plan(inner);
+	GPOS_ASSERT(NULL != outer_plan && NULL != inner_plan);
+
+	AtomSet atoms = csg | cmp;
+	SPlanInfo *plan = Plan(atoms);
+
+	if (NULL == plan)
+	{
+		if (m_plans->Size() >= m_max_plans)
+		{
+			m_exceeded_budget = true;
+			return;
+		}
+
+		// the estimate of the rows depends only on the atoms, not on
+		// the join order, except for LOJs, which keep the outer rows
+		CDouble rows = inner_plan->m_rows * selectivity;
+		if (is_loj)
+		{
+			rows = std::max(CDouble(1.0), rows);
+		}
+		rows = std::max(CDouble(1.0), outer_plan->m_rows * rows);
+
+		plan = GPOS_NEW(m_mp) SPlanInfo(rows, CDouble(0.0));
+#ifdef GPOS_DEBUG
+		BOOL inserted =
+#endif	// GPOS_DEBUG
+			m_plans->Insert(GPOS_NEW(m_mp) AtomSet(atoms), plan);
+		GPOS_ASSERT(inserted);
+	}
+
+	// same cost as in DPv2: the rows of the join plus the cost of its
+	// children, penalized if this has to be a nested loop join
+	CDouble cost = plan->m_rows + outer_plan->m_cost + inner_plan->m_cost;
+	if (!is_hashable)
+	{
+		cost = cost * GPOPT_DPHYP_NLJ_PENALTY;
+	}
+
+	if (0 == plan->m_left || cost < plan->m_cost)
+	{
+		plan->m_left = outer;
+		plan->m_right = inner;
+		plan->m_is_loj = is_loj;
+		plan->m_cost = cost;
+	}
+
+	if (atoms == m_all_atoms)
+	{
+		AddTopSplit(outer, inner, is_loj, cost);
+	}
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::AddTopSplit
+//
+//	@doc:
+//		Keep the k cheapest ways of joining all the atoms. All the subsets
+//		are final by the time the full set is joined, so each of them is
+//		built from the best plans of its two sides.
+//
+//---------------------------------------------------------------------------
+void
+CJoinOrderDPhyp::AddTopSplit(AtomSet left, AtomSet right, BOOL is_loj,
+							 CDouble cost)
+{
+	ULONG pos = m_num_top_splits;
+
+	if (GPOPT_DPHYP_JOIN_ORDERING_TOPK == pos)
+	{
+		if (cost.Get() >= m_top_splits[pos - 1].m_cost)
+		{
+			return;
+		}
+		// drop the most expensive one
+		pos--;
+	}
+	else
+	{
+		m_num_top_splits++;
+	}
+
+	// insertion sort, cheapest first
+	while (0 < pos && cost.Get() < m_top_splits[pos - 1].m_cost)
+	{
+		m_top_splits[pos] = m_top_splits[pos - 1];
+		pos--;
+	}
+
+	m_top_splits[pos].m_left = left;
+	m_top_splits[pos].m_right = right;
+	m_top_splits[pos].m_is_loj = is_loj;
+	m_top_splits[pos].m_cost = cost.Get();
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::FExpand
+//
+//	@doc:
+//		Main driver for join order enumeration, called by xform. Returns
+//		false if it did not find a join order, because the join graph is
+//		not connected, or it is too large.
+//
+//---------------------------------------------------------------------------
+BOOL
+CJoinOrderDPhyp::FExpand()
+{
+	if (GPOPT_DPHYP_MAX_ATOMS < m_ulComps || 0 == m_ulEdges)
+	{
+		// too many atoms for an AtomSet, or only cross products
+		return false;
+	}
+
+	BuildGraph();
+
+	m_plans = GPOS_NEW(m_mp)
+		AtomSetToPlanMap(m_mp, GPOPT_DPHYP_PLAN_CHAINS);
+
+	// the atoms are the first entries of the DP table
+	for (ULONG ul = 0; ul < m_ulComps; ul++)
+	{
+		CExpression *pexprAtom = m_rgpcomp[ul]->m_pexpr;
+
+		DeriveStats(pexprAtom);
+		CDouble rows = std::max(CDouble(1.0), pexprAtom->Pstats()->Rows());
+		m_plans->Insert(GPOS_NEW(m_mp) AtomSet(AtomSet(1) << ul),
+						GPOS_NEW(m_mp) SPlanInfo(rows, rows));
+	}
+
+	// start from each atom, highest first, excluding all the lower atoms
+	for (ULONG ul = m_ulComps; 0 < ul && !m_exceeded_budget; ul--)
+	{
+		ULONG atom = ul - 1;
+		AtomSet csg = AtomSet(1) << atom;
+
+		EmitCsg(csg);
+		EnumerateCsgRec(csg, AtomsUpTo(atom));
+	}
+
+	return !m_exceeded_budget && 0 < m_num_top_splits;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::GetNextOfTopK
+//
+//	@doc:
+//		Return the next of the best join orders. This expression can then
+//		be used as an alternative of the transform. Return NULL if there
+//		are no more alternatives.
+//
+//---------------------------------------------------------------------------
+CExpression *
+CJoinOrderDPhyp::GetNextOfTopK()
+{
+	if (m_next_top_split == m_num_top_splits)
+	{
+		return NULL;
+	}
+
+	STopSplit &split = m_top_splits[m_next_top_split++];
+	CBitSet *used_edges = GPOS_NEW(m_mp) CBitSet(m_mp, m_ulEdges);
+
+	CExpression *join_expr =
+		PexprJoin(split.m_left, split.m_right, split.m_is_loj, used_edges);
+	join_expr = PexprAddSelectForUnusedEdges(join_expr, used_edges);
+	used_edges->Release();
+
+	return join_expr;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::PexprBuild
+//
+//	@doc:
+//		Build the expression for the best plan of a set of atoms
+//
+//---------------------------------------------------------------------------
+CExpression *
+CJoinOrderDPhyp::PexprBuild(AtomSet atoms, CBitSet *used_edges)
+{
+	GPOS_CHECK_STACK_SIZE;
+
+	SPlanInfo *plan = Plan(atoms);
+	GPOS_ASSERT(NULL != plan);
+
+	if (0 == plan->m_left)
+	{
+		GPOS_ASSERT(1 == NumAtoms(atoms));
+
+		CExpression *pexprAtom = m_rgpcomp[LowestAtom(atoms)]->m_pexpr;
+		pexprAtom->AddRef();
+		return pexprAtom;
+	}
+
+	return PexprJoin(plan->m_left, plan->m_right, plan->m_is_loj,
+					 used_edges);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::PexprJoin
+//
+//	@doc:
+//		Build the join of the best plans of two sets of atoms, and record
+//		the edges it uses
+//
+//---------------------------------------------------------------------------
+CExpression *
+CJoinOrderDPhyp::PexprJoin(AtomSet left, AtomSet right, BOOL is_loj,
+						   CBitSet *used_edges)
+{
+	CExpression *pexprLeft = PexprBuild(left, used_edges);
+	CExpression *pexprRight = PexprBuild(right, used_edges);
+
+	if (is_loj)
+	{
+		ULONG edge = m_atom_loj_edge[LowestAtom(right)];
+		CExpression *pexprPred = m_rgpedge[edge]->m_pexpr;
+
+		pexprPred->AddRef();
+		(void) used_edges->ExchangeSet(edge);
+
+		return CUtils::PexprLogicalJoin<CLogicalLeftOuterJoin>(
+			m_mp, pexprLeft, pexprRight, pexprPred);
+	}
+
+	// the predicates between the two sets
+	CExpressionArray *pdrgpexprPreds = GPOS_NEW(m_mp) CExpressionArray(m_mp);
+	AtomSet atoms = left | right;
+	for (ULONG ul = 0; ul < m_ulEdges; ul++)
+	{
+		AtomSet edge_atoms = m_edge_atoms[ul];
+
+		if (0 == m_rgpedge[ul]->m_loj_num && 0 != edge_atoms &&
+			0 == (edge_atoms & ~atoms) && 0 != (edge_atoms & left) &&
+			0 != (edge_atoms & right))
+		{
+			m_rgpedge[ul]->m_pexpr->AddRef();
+			pdrgpexprPreds->Append(m_rgpedge[ul]->m_pexpr);
+			(void) used_edges->ExchangeSet(ul);
+		}
+	}
+	GPOS_ASSERT(0 < pdrgpexprPreds->Size());
+
+	return CUtils::PexprLogicalJoin<CLogicalInnerJoin>(
+		m_mp, pexprLeft, pexprRight,
+		CPredicateUtils::PexprConjunction(m_mp, pdrgpexprPreds));
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::PexprAddSelectForUnusedEdges
+//
+//	@doc:
+//		Add a select node with the predicates that none of the joins used:
+//		predicates on a single atom, predicates with outer references, and
+//		WHERE predicates on the right child of an LOJ
+//
+//---------------------------------------------------------------------------
+CExpression *
+CJoinOrderDPhyp::PexprAddSelectForUnusedEdges(CExpression *join_expr,
+											  CBitSet *used_edges)
+{
+	CExpressionArray *pdrgpexprPreds = GPOS_NEW(m_mp) CExpressionArray(m_mp);
+
+	for (ULONG ul = 0; ul < m_ulEdges; ul++)
+	{
+		if (!used_edges->Get(ul))
+		{
+			GPOS_ASSERT(0 == m_rgpedge[ul]->m_loj_num);
+
+			m_rgpedge[ul]->m_pexpr->AddRef();
+			pdrgpexprPreds->Append(m_rgpedge[ul]->m_pexpr);
+		}
+	}
+
+	if (0 == pdrgpexprPreds->Size())
+	{
+		pdrgpexprPreds->Release();
+		return join_expr;
+	}
+
+	return GPOS_NEW(m_mp)
+		CExpression(m_mp, GPOS_NEW(m_mp) CLogicalSelect(m_mp), join_expr,
+					CPredicateUtils::PexprConjunction(m_mp, pdrgpexprPreds));
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderDPhyp::OsPrint
+//
+//	@doc:
+//		Print function
+//
+//---------------------------------------------------------------------------
+IOstream &
+CJoinOrderDPhyp::OsPrint(IOstream &os) const
+{
+	os << "Join Order DPhyp: " << m_ulComps << " atoms, " << m_ulEdges
+	   << " edges" << std::endl;
+	os << "csg-cmp pairs: " << m_num_pairs << " (limit " << m_max_pairs << ")"
+	   << std::endl;
+	if (NULL != m_plans)
+	{
+		os << "DP table entries: " << m_plans->Size() << " (limit "
+		   << m_max_plans << ")" << std::endl;
+	}
+	if (m_exceeded_budget)
+	{
+		os << "Budget exceeded" << std::endl;
+	}
+
+	for (ULONG ul = 0; ul < m_num_top_splits; ul++)
+	{
+		os << "Top " << ul + 1 << ": 0x" << IOstream::EsmHex << m_top_splits[ul].m_left
+		   << (m_top_splits[ul].m_is_loj ? " left join 0x" : " join 0x")
+		   << m_top_splits[ul].m_right << IOstream::EsmDec
+		   << ", cost: " << m_top_splits[ul].m_cost << std::endl;
+	}
+
+	return os;
+}
+
+// EOF
@@ -241,6 +241,9 @@ CXform::PbsJoinOrderInQueryXforms(CMemoryPool *mp)
 	(void) pbs->ExchangeSet(
 		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinGreedy));
 
+	(void) pbs->ExchangeSet(
+		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinDPhyp));
+
 	return pbs;
 }
 
@@ -258,6 +261,9 @@ CXform::PbsJoinOrderOnGreedyXforms(CMemoryPool *mp)
 	(void) pbs->ExchangeSet(
 		GPOPT_DISABLE_XFORM_TF(CXform::ExfJoinCommutativity));
 
+	(void) pbs->ExchangeSet(
+		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinDPhyp));
+
 	return pbs;
 }
 
@@ -269,6 +275,9 @@ CXform::PbsJoinOrderOnExhaustiveXforms(CMemoryPool *mp)
 	(void) pbs->ExchangeSet(
 		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinDPv2));
 
+	(void) pbs->ExchangeSet(
+		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinDPhyp));
+
 	return pbs;
 }
 
@@ -286,7 +295,31 @@ CXform::PbsJoinOrderOnExhaustive2Xforms(CMemoryPool *mp)
 		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinGreedy));
 	(void) pbs->ExchangeSet(
 		GPOPT_DISABLE_XFORM_TF(CXform::ExfPushDownLeftOuterJoin));
+	(void) pbs->ExchangeSet(
+		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinDPhyp));
+	(void) pbs->ExchangeSet(EopttraceEnableLOJInNAryJoin);
+
+	return pbs;
+}
+
+CBitSet *
+CXform::PbsJoinOrderOnDPhypXforms(CMemoryPool *mp)
+{
+	CBitSet *pbs = GPOS_NEW(mp) CBitSet(mp, EopttraceSentinel);
+
+	(void) pbs->ExchangeSet(GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoin));
+	(void) pbs->ExchangeSet(
+		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinDP));
+	(void) pbs->ExchangeSet(
+		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinDPv2));
+	(void) pbs->ExchangeSet(
+		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinMinCard));
+	(void) pbs->ExchangeSet(
+		GPOPT_DISABLE_XFORM_TF(CXform::ExfExpandNAryJoinGreedy));
+	(void) pbs->ExchangeSet(
+		GPOPT_DISABLE_XFORM_TF(CXform::ExfPushDownLeftOuterJoin));
 	(void) pbs->ExchangeSet(EopttraceEnableLOJInNAryJoin);
+	(void) pbs->ExchangeSet(EopttraceEnableDPhypJoinOrder);
 
 	return pbs;
 }
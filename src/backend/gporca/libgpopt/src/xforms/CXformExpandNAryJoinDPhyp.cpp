@@ -0,0 +1,193 @@
+//---------------------------------------------------------------------------
+// Greengage Database
+// Copyright (C) 2025 Greengage Community
+//
+//	@filename:
+//		CXformExpandNAryJoinDPhyp.cpp
+//
+//	@doc:
+//		Implementation of n-ary join expansion using dynamic programming
+//		over the join graph
+//---------------------------------------------------------------------------
+
+#include "gpopt/xforms/CXformExpandNAryJoinDPhyp.h"
+
+#include "gpos/base.h"
+
+#include "gpopt/base/CUtils.h"
+#include "gpopt/operators/CLogicalNAryJoin.h"
+#include "gpopt/operators/CNormalizer.h"
+#include "gpopt/operators/CPatternMultiLeaf.h"
+#include "gpopt/operators/CPatternTree.h"
+#include "gpopt/operators/CPredicateUtils.h"
+#include "gpopt/operators/CScalarNAryJoinPredList.h"
+#include "gpopt/xforms/CJoinOrderDPhyp.h"
+#include "gpopt/xforms/CJoinOrderDPv2.h"
+#include "gpopt/xforms/CXformUtils.h"
+
+
+
+using namespace gpopt;
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CXformExpandNAryJoinDPhyp::CXformExpandNAryJoinDPhyp
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+CXformExpandNAryJoinDPhyp::CXformExpandNAryJoinDPhyp(CMemoryPool *mp)
+	: CXformExploration(
+		  // pattern
+		  GPOS_NEW(mp) CExpression(
+			  mp, GPOS_NEW(mp) CLogicalNAryJoin(mp),
+			  GPOS_NEW(mp) CExpression(mp, GPOS_NEW(mp) CPatternMultiLeaf(mp)),
+			  GPOS_NEW(mp) CExpression(mp, GPOS_NEW(mp) CPatternTree(mp))))
+{
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CXformExpandNAryJoinDPhyp::Exfp
+//
+//	@doc:
+//		Compute xform promise for a given expression handle. The xform is
+//		only used with optimizer_join_order=dphyp, which sets its trace
+//		flag, so that minidumps taken before it existed still replay
+//		with the join orders they were taken with.
+//
+//---------------------------------------------------------------------------
+CXform::EXformPromise
+CXformExpandNAryJoinDPhyp::Exfp(CExpressionHandle &exprhdl) const
+{
+	if (!GPOS_FTRACE(EopttraceEnableDPhypJoinOrder))
+	{
+		return CXform::ExfpNone;
+	}
+
+	return CXformUtils::ExfpExpandJoinOrder(exprhdl, this);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CXformExpandNAryJoinDPhyp::Transform
+//
+//	@doc:
+//		Actual transformation of n-ary join to cluster of inner joins using
+//		dynamic programming over the join graph, or using DPv2 if the join
+//		graph is not connected or too large
+//
+//---------------------------------------------------------------------------
+void
+CXformExpandNAryJoinDPhyp::Transform(CXformContext *pxfctxt,
+									 CXformResult *pxfres,
+									 CExpression *pexpr) const
+{
+	GPOS_ASSERT(NULL != pxfctxt);
+	GPOS_ASSERT(NULL != pxfres);
+	GPOS_ASSERT(FPromising(pxfctxt->Pmp(), this, pexpr));
+	GPOS_ASSERT(FCheckPattern(pexpr));
+
+	CMemoryPool *mp = pxfctxt->Pmp();
+
+	const ULONG arity = pexpr->Arity();
+	GPOS_ASSERT(arity >= 3);
+
+	// Make an expression array with all the atoms (the logical children)
+	CExpressionArray *pdrgpexpr = GPOS_NEW(mp) CExpressionArray(mp);
+	for (ULONG ul = 0; ul < arity - 1; ul++)
+	{
+		CExpression *pexprChild = (*pexpr)[ul];
+		pexprChild->AddRef();
+		pdrgpexpr->Append(pexprChild);
+	}
+
+	// Make an expression array with all the join predicates, the ON
+	// predicates of the non-inner joins and the lookup table for the
+	// children of non-inner joins, same as for DPv2
+	CLogicalNAryJoin *naryJoin = CLogicalNAryJoin::PopConvert(pexpr->Pop());
+	CExpression *pexprScalar = (*pexpr)[arity - 1];
+	CExpressionArray *innerJoinPreds = NULL;
+	CExpressionArray *onPreds = GPOS_NEW(mp) CExpressionArray(mp);
+	ULongPtrArray *childPredIndexes = NULL;
+
+	if (NULL != CScalarNAryJoinPredList::PopConvert(pexprScalar->Pop()))
+	{
+		innerJoinPreds =
+			CPredicateUtils::PdrgpexprConjuncts(mp, (*pexprScalar)[0]);
+
+		for (ULONG ul = 1; ul < pexprScalar->Arity(); ul++)
+		{
+			(*pexprScalar)[ul]->AddRef();
+			onPreds->Append((*pexprScalar)[ul]);
+		}
+
+		childPredIndexes = naryJoin->GetLojChildPredIndexes();
+		GPOS_ASSERT(NULL != childPredIndexes);
+		childPredIndexes->AddRef();
+	}
+	else
+	{
+		innerJoinPreds = CPredicateUtils::PdrgpexprConjuncts(mp, pexprScalar);
+	}
+
+	// keep a reference to the inputs, in case we have to fall back to DPv2
+	pdrgpexpr->AddRef();
+	innerJoinPreds->AddRef();
+	onPreds->AddRef();
+	if (NULL != childPredIndexes)
+	{
+		childPredIndexes->AddRef();
+	}
+
+	{
+		CJoinOrderDPhyp jodphyp(mp, pdrgpexpr, innerJoinPreds, onPreds,
+								childPredIndexes);
+
+		if (jodphyp.FExpand())
+		{
+			CExpression *nextJoinOrder = NULL;
+
+			while (NULL != (nextJoinOrder = jodphyp.GetNextOfTopK()))
+			{
+				CExpression *pexprNormalized =
+					CNormalizer::PexprNormalize(mp, nextJoinOrder);
+
+				nextJoinOrder->Release();
+				pxfres->Add(pexprNormalized);
+			}
+
+			pdrgpexpr->Release();
+			innerJoinPreds->Release();
+			onPreds->Release();
+			CRefCount::SafeRelease(childPredIndexes);
+
+			return;
+		}
+	}
+
+	CColRefSet *outerRefs = pexpr->DeriveOuterReferences();
+
+	outerRefs->AddRef();
+
+	CJoinOrderDPv2 jodp(mp, pdrgpexpr, innerJoinPreds, onPreds,
+						childPredIndexes, outerRefs);
+	jodp.PexprExpand();
+
+	CExpression *nextJoinOrder = NULL;
+
+	while (NULL != (nextJoinOrder = jodp.GetNextOfTopK()))
+	{
+		CExpression *pexprNormalized =
+			CNormalizer::PexprNormalize(mp, nextJoinOrder);
+
+		nextJoinOrder->Release();
+		pxfres->Add(pexprNormalized);
+	}
+}
+
+// EOF
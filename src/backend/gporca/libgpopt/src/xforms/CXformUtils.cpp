@@ -148,11 +148,12 @@ CXformUtils::ExfpExpandJoinOrder(CExpressionHandle &exprhdl,
 	// With optimizer_join_order set to 'query' or 'exhaustive', the
 	// 'query' join order will expand the join even if it contains
 	// outer refs, using another method to get the promise.
-	// Therefore we also allow expansion for 'exhaustive2'
+	// Therefore we also allow expansion for 'exhaustive2' and 'dphyp'
 	// when we have outer refs.
 	if (exprhdl.DeriveHasSubquery(exprhdl.Arity() - 1) ||
 		(exprhdl.HasOuterRefs() &&
-		 CXform::ExfExpandNAryJoinDPv2 != xform->Exfid()))
+		 CXform::ExfExpandNAryJoinDPv2 != xform->Exfid() &&
+		 CXform::ExfExpandNAryJoinDPhyp != xform->Exfid()))
 	{
 		// subqueries must be unnested before applying xform
 		return CXform::ExfpNone;
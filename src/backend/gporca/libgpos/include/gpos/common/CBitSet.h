@@ -6,7 +6,7 @@
 //		CBitSet.h
 //
 //	@doc:
-//		Implementation of bitset as linked list of bitvectors
+//		Implementation of bitset as an array of words
 //---------------------------------------------------------------------------
 #ifndef GPOS_CBitSet_H
 #define GPOS_CBitSet_H
@@ -20,12 +20,23 @@
 
 namespace gpos
 {
+// number of words held in the set itself, enough for a set whose bits
+// lie within a range of 128; larger sets spill to an array
+#define GPOS_BITSET_INLINE_WORDS 2
+
 //---------------------------------------------------------------------------
 //	@class:
 //		CBitSet
 //
 //	@doc:
-//		Linked list of CBitSetLink's
+//		Set of ULONGs, kept as one contiguous array of 64-bit words which
+//		covers the range between the lowest and the highest element. The
+//		words of small sets, such as the column sets of most operators,
+//		are held in the set itself; the array is only allocated once the
+//		range grows beyond that, and doubles on further growth.
+//
+//		Set operations are loops over the words of the overlapping range,
+//		which the compiler can vectorize.
 //
 //---------------------------------------------------------------------------
 class CBitSet : public CRefCount, public DbgPrintMixin<CBitSet>
@@ -34,83 +45,60 @@ class CBitSet : public CRefCount, public DbgPrintMixin<CBitSet>
 	friend class CBitSetIter;
 
 protected:
-	//---------------------------------------------------------------------------
-	//	@class:
-	//		CBitSetLink
-	//
-	//	@doc:
-	//		bit vector + offset + link
-	//
-	//---------------------------------------------------------------------------
-	class CBitSetLink
-	{
-	private:
-		// private copy ctor
-		CBitSetLink(const CBitSetLink &);
+	// pool to allocate the words from
+	CMemoryPool *m_mp;
 
-		// offset
-		ULONG m_offset;
+	// number of elements
+	ULONG m_size;
 
-		// bitvector
-		CBitVector *m_vec;
+	// index of the first word held, words before it are zero
+	ULONG m_base;
 
-	public:
-		// ctor
-		explicit CBitSetLink(CMemoryPool *, ULONG offset, ULONG vector_size);
+	// number of words held, words after them are zero
+	ULONG m_num_words;
 
-		explicit CBitSetLink(CMemoryPool *, const CBitSetLink &);
+	// number of words that fit in m_words
+	ULONG m_capacity;
 
-		// dtor
-		~CBitSetLink();
+	// the words, either m_inline_words or an array from m_mp
+	ULLONG *m_words;
 
-		// accessor
-		ULONG
-		GetOffset() const
-		{
-			return m_offset;
-		}
+	// words of small sets
+	ULLONG m_inline_words[GPOS_BITSET_INLINE_WORDS];
+
+	// private copy ctor
+	CBitSet(const CBitSet &);
 
-		// accessor
-		CBitVector *
-		GetVec() const
+	// word with the given index, zero if it is not held
+	ULLONG
+	Word(ULONG word) const
+	{
+		if (word < m_base || word - m_base >= m_num_words)
 		{
-			return m_vec;
+			return 0;
 		}
 
-		// list link
-		SLink m_link;
-
-	};	// class CBitSetLink
-
-	// list of bit set links
-	CList<CBitSetLink> m_bsllist;
-
-	// pool to allocate links from
-	CMemoryPool *m_mp;
-
-	// size of individual bitvectors
-	ULONG m_vector_size;
-
-	// number of elements
-	ULONG m_size;
+		return m_words[word - m_base];
+	}
 
-	// private copy ctor
-	CBitSet(const CBitSet &);
+	// make the held words cover the given range of words
+	void Grow(ULONG first_word, ULONG end_word);
 
-	// find link with offset less or equal to given value
-	CBitSetLink *FindLinkByOffset(ULONG, CBitSetLink * = NULL) const;
+	// drop the zero words at the end
+	void Trim();
 
 	// reset set
 	void Clear();
 
-	// compute target offset
-	ULONG ComputeOffset(ULONG) const;
-
 	// re-compute size of set
 	void RecomputeSize();
 
+	// find the first element not less than the given value
+	BOOL GetNextSetBit(ULONG start_pos, ULONG &pos) const;
+
 public:
-	// ctor
+	// ctor; the vector size is no longer used, and is only kept for the
+	// callers that pass it
 	CBitSet(CMemoryPool *mp, ULONG vector_size = 256);
 	CBitSet(CMemoryPool *mp, const CBitSet &);
 
@@ -6,16 +6,14 @@
 //		CSyncPool.h
 //
 //	@doc:
-//		Template-based synchronized object pool class with minimum synchronization
-//		overhead; it provides thread-safe object retrieval and release through
-//		atomic primitives (lock-free);
+//		Template-based object pool class; objects are pre-allocated in bulk
+//		during initialization and released at destruction; users retrieve
+//		objects without incurring the construction cost (memory allocation,
+//		constructor invocation)
 //
-//		Object pool is dynamically created during construction and released at
-//		destruction; users retrieve objects without incurring the construction
-//		cost (memory allocation, constructor invocation)
-//
-//		In order for the objects to be used in lock-free lists, the class uses
-//		the clock algorithm to recycle objects.
+//		Objects that are not in use are kept on a stack of free indexes, so
+//		both retrieval and recycling take constant time regardless of the
+//		size of the pool.
 //---------------------------------------------------------------------------
 #ifndef GPOS_CSyncPool_H
 #define GPOS_CSyncPool_H
@@ -48,75 +46,40 @@ private:
 	// array of preallocated objects
 	T *m_objects;
 
-	// bitmap indicating object reservation
-	ULONG *m_objs_reserved;
+	// stack of indexes of objects available for retrieval
+	ULONG *m_free_objs;
 
-	// bitmap indicating object recycle
-	ULONG *m_objs_recycled;
+	// number of entries in the stack of free objects
+	ULONG m_num_free_objs;
 
 	// number of allocated objects
 	ULONG m_numobjs;
 
-	// number of elements (ULONG) in bitmap
-	ULONG m_bitmap_size;
-
-	// offset of last lookup - clock index
-	ULONG_PTR m_last_lookup_idx;
-
 	// offset of id inside the object
 	ULONG m_id_offset;
 
-	// atomically set bit if it is unset
-	BOOL
-	SetBit(ULONG *dest, ULONG bit_val)
-	{
-		GPOS_ASSERT(NULL != dest);
-
-		ULONG old_val = *dest;
-
-		// keep trying while the bit is unset
-		while (0 == (bit_val & old_val))
-		{
-			ULONG new_val = bit_val | old_val;
-
-			// attempt to set the bit
-			if (*dest == old_val)
-			{
-				*dest = new_val;
-				return true;
-			}
-
-			old_val = *dest;
-		}
+#ifdef GPOS_DEBUG
+	// bitmap indicating object reservation
+	ULONG *m_objs_reserved;
 
-		return false;
-	}
+	// number of elements (ULONG) in bitmap
+	ULONG m_bitmap_size;
 
-	// atomically unset bit if it is set
+	// check if object at given index is reserved
 	BOOL
-	UnsetBit(ULONG *dest, ULONG bit_val)
+	IsReserved(ULONG index) const
 	{
-		GPOS_ASSERT(NULL != dest);
-
-		ULONG old_val = *dest;
-
-		// keep trying while the bit is set
-		while (bit_val == (bit_val & old_val))
-		{
-			ULONG new_val = bit_val ^ old_val;
-
-			// attempt to set the bit
-			if (*dest == old_val)
-			{
-				*dest = new_val;
-				return true;
-			}
-
-			old_val = *dest;
-		}
+		ULONG bit_val = 1 << (index % BITS_PER_ULONG);
+		return bit_val == (m_objs_reserved[index / BITS_PER_ULONG] & bit_val);
+	}
 
-		return false;
+	// flip reservation bit of object at given index
+	void
+	FlipReserved(ULONG index)
+	{
+		m_objs_reserved[index / BITS_PER_ULONG] ^= 1 << (index % BITS_PER_ULONG);
 	}
+#endif	// GPOS_DEBUG
 
 	// no copy ctor
 	CSyncPool(const CSyncPool &);
@@ -126,12 +89,15 @@ public:
 	CSyncPool(CMemoryPool *mp, ULONG size)
 		: m_mp(mp),
 		  m_objects(NULL),
-		  m_objs_reserved(NULL),
-		  m_objs_recycled(NULL),
+		  m_free_objs(NULL),
+		  m_num_free_objs(0),
 		  m_numobjs(size),
-		  m_bitmap_size(size / BITS_PER_ULONG + 1),
-		  m_last_lookup_idx(0),
 		  m_id_offset(gpos::ulong_max)
+#ifdef GPOS_DEBUG
+		  ,
+		  m_objs_reserved(NULL),
+		  m_bitmap_size(size / BITS_PER_ULONG + 1)
+#endif	// GPOS_DEBUG
 	{
 	}
 
@@ -141,32 +107,20 @@ public:
 		if (gpos::ulong_max != m_id_offset)
 		{
 			GPOS_ASSERT(NULL != m_objects);
-			GPOS_ASSERT(NULL != m_objs_reserved);
-			GPOS_ASSERT(NULL != m_objs_recycled);
+			GPOS_ASSERT(NULL != m_free_objs);
 
 #ifdef GPOS_DEBUG
 			if (!ITask::Self()->HasPendingExceptions())
 			{
-				for (ULONG i = 0; i < m_numobjs; i++)
-				{
-					ULONG elem_offset = i / BITS_PER_ULONG;
-					ULONG bit_offset = i % BITS_PER_ULONG;
-					ULONG bit_val = 1 << bit_offset;
-
-					BOOL reserved =
-						(bit_val == (m_objs_reserved[elem_offset] & bit_val));
-					BOOL recycled =
-						(bit_val == (m_objs_recycled[elem_offset] & bit_val));
-
-					GPOS_ASSERT((!reserved || recycled) &&
-								"Object is still in use");
-				}
+				GPOS_ASSERT(m_num_free_objs == m_numobjs &&
+							"Object is still in use");
 			}
+
+			GPOS_DELETE_ARRAY(m_objs_reserved);
 #endif	// GPOS_DEBUG
 
 			GPOS_DELETE_ARRAY(m_objects);
-			GPOS_DELETE_ARRAY(m_objs_reserved);
-			GPOS_DELETE_ARRAY(m_objs_recycled);
+			GPOS_DELETE_ARRAY(m_free_objs);
 		}
 	}
 
@@ -177,24 +131,28 @@ public:
 		GPOS_ASSERT(ALIGNED_32(id_offset));
 
 		m_objects = GPOS_NEW_ARRAY(m_mp, T, m_numobjs);
-		m_objs_reserved = GPOS_NEW_ARRAY(m_mp, ULONG, m_bitmap_size);
-		m_objs_recycled = GPOS_NEW_ARRAY(m_mp, ULONG, m_bitmap_size);
+		m_free_objs = GPOS_NEW_ARRAY(m_mp, ULONG, m_numobjs);
 
 		m_id_offset = id_offset;
 
-		// initialize object ids
+		// initialize object ids; push free objects in reverse order so that
+		// objects are handed out starting from the beginning of the array
 		for (ULONG i = 0; i < m_numobjs; i++)
 		{
 			ULONG *id = (ULONG *) (((BYTE *) &m_objects[i]) + m_id_offset);
 			*id = i;
+
+			m_free_objs[i] = m_numobjs - i - 1;
 		}
+		m_num_free_objs = m_numobjs;
 
-		// initialize bitmaps
+#ifdef GPOS_DEBUG
+		m_objs_reserved = GPOS_NEW_ARRAY(m_mp, ULONG, m_bitmap_size);
 		for (ULONG i = 0; i < m_bitmap_size; i++)
 		{
 			m_objs_reserved[i] = 0;
-			m_objs_recycled[i] = 0;
 		}
+#endif	// GPOS_DEBUG
 	}
 
 	// find unreserved object and reserve it
@@ -204,48 +162,20 @@ public:
 		GPOS_ASSERT(gpos::ulong_max != m_id_offset &&
 					"Id offset not initialized.");
 
-		// iterate over all objects twice (two full clock rotations);
-		// objects marked as recycled cannot be reserved on the first round;
-		for (ULONG i = 0; i < 2 * m_numobjs; i++)
+		if (0 < m_num_free_objs)
 		{
-			// move clock index
-			ULONG_PTR index = (m_last_lookup_idx++) % m_numobjs;
-
-			ULONG elem_offset = (ULONG) index / BITS_PER_ULONG;
-			ULONG bit_offset = (ULONG) index % BITS_PER_ULONG;
-			ULONG bit_val = 1 << bit_offset;
-
-			// attempt to reserve object
-			if (SetBit(&m_objs_reserved[elem_offset], bit_val))
-			{
-				// set id in corresponding object
-				T *elem = &m_objects[index];
+			ULONG index = m_free_objs[--m_num_free_objs];
+			T *elem = &m_objects[index];
 
 #ifdef GPOS_DEBUG
-				ULONG *id = (ULONG *) (((BYTE *) elem) + m_id_offset);
-				GPOS_ASSERT(index == *id);
-#endif	// GPOS_DEBUG
+			ULONG *id = (ULONG *) (((BYTE *) elem) + m_id_offset);
+			GPOS_ASSERT(index == *id);
+			GPOS_ASSERT(!IsReserved(index) && "Object is already reserved");
 
-				return elem;
-			}
-
-			// object is reserved, check if it has been marked for recycling
-			if (bit_val == (bit_val & m_objs_recycled[elem_offset]))
-			{
-				// attempt to unset the recycle bit
-				if (UnsetBit(&m_objs_recycled[elem_offset], bit_val))
-				{
-#ifdef GPOS_DEBUG
-					BOOL recycled =
+			FlipReserved(index);
 #endif	// GPOS_DEBUG
 
-						// unset the reserve bit - must succeed
-						UnsetBit(&m_objs_reserved[elem_offset], bit_val);
-
-					GPOS_ASSERT(recycled &&
-								"Object was reserved before being recycled");
-				}
-			}
+			return elem;
 		}
 
 		// no object is currently available, create a new one
@@ -271,22 +201,15 @@ public:
 		}
 
 		GPOS_ASSERT(offset < m_numobjs);
-
-		ULONG elem_offset = offset / BITS_PER_ULONG;
-		ULONG bit_offset = offset % BITS_PER_ULONG;
-		ULONG bit_val = 1 << bit_offset;
+		GPOS_ASSERT(m_num_free_objs < m_numobjs);
 
 #ifdef GPOS_DEBUG
-		ULONG reserved = m_objs_reserved[elem_offset];
-		GPOS_ASSERT((bit_val == (bit_val & reserved)) &&
-					"Object is not reserved");
+		GPOS_ASSERT(IsReserved(offset) && "Object is not reserved");
 
-		BOOL mark_recycled =
+		FlipReserved(offset);
 #endif	// GPOS_DEBUG
-			SetBit(&m_objs_recycled[elem_offset], bit_val);
 
-		GPOS_ASSERT(mark_recycled &&
-					"Object has already been marked for recycling");
+		m_free_objs[m_num_free_objs++] = offset;
 	}
 
 };	// class CSyncPool
@@ -59,8 +59,10 @@ private:
 	ELeakCheck m_leak_check_type;
 
 public:
-	// ctor
-	CAutoMemoryPool(ELeakCheck leak_check_type = ElcExc);
+	// ctor; an arena pool frees all its allocations at once when it is
+	// torn down, see CMemoryPoolArena
+	CAutoMemoryPool(ELeakCheck leak_check_type = ElcExc,
+					BOOL use_arena = false);
 
 	// dtor
 	~CAutoMemoryPool() noexcept(false);
@@ -154,6 +154,13 @@ public:
 		return 0;
 	}
 
+	// return the largest total allocated size so far
+	virtual ULLONG
+	PeakAllocatedSize() const
+	{
+		return TotalAllocatedSize();
+	}
+
 	// requested size of allocation
 	static ULONG UserSizeOfAlloc(const void *ptr);
 
@@ -0,0 +1,219 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (C) 2025 Greengage Community
+//
+//	@filename:
+//		CMemoryPoolArena.h
+//
+//	@doc:
+//		Memory pool that carves allocations out of large blocks and
+//		releases all of them at once when the pool is destroyed
+//
+//---------------------------------------------------------------------------
+#ifndef GPOS_CMemoryPoolArena_H
+#define GPOS_CMemoryPoolArena_H
+
+#include "gpos/assert.h"
+#include "gpos/common/CList.h"
+#include "gpos/common/CStackDescriptor.h"
+#include "gpos/memory/CMemoryPool.h"
+#include "gpos/memory/CMemoryPoolStatistics.h"
+#include "gpos/types.h"
+#include "gpos/utils.h"
+
+// size of the first block, later blocks double up to the max block size
+#define GPOS_MEM_ARENA_INIT_BLOCK_SIZE (8 * 1024)
+#define GPOS_MEM_ARENA_MAX_BLOCK_SIZE (1024 * 1024)
+
+// allocations larger than this get a block of their own, which is returned
+// to the block pool as soon as the allocation is freed
+#define GPOS_MEM_ARENA_MAX_CHUNK_SIZE (8 * 1024)
+
+// number of free lists, one for each aligned chunk size
+#define GPOS_MEM_ARENA_FREE_LISTS \
+	(GPOS_MEM_ARENA_MAX_CHUNK_SIZE / GPOS_MEM_ARCH + 1)
+
+// tag in the upper half of the word before every arena allocation; a word
+// before a tracker or palloc allocation is a pointer, a size or a serial
+// number, which never has the top bit set
+#define GPOS_MEM_ARENA_TAG (0xA7E4A00000000000ULL)
+#define GPOS_MEM_ARENA_TAG_MASK (0xFFFFFFFF00000000ULL)
+
+namespace gpos
+{
+//---------------------------------------------------------------------------
+//	@class:
+//		CMemoryPoolArena
+//
+//	@doc:
+//		Memory pool for short-lived sessions that make a large number of
+//		small allocations, such as the optimization of a query.
+//
+//		Allocations are carved out of blocks obtained from a block pool of
+//		the type the memory pool manager creates, so the memory is still
+//		accounted for the same way. Freed allocations are kept on a free
+//		list per size and reused, except for the large ones, which have a
+//		block of their own. All the blocks are released at once when the
+//		pool is torn down.
+//
+//		In release builds the header of an allocation only holds the pool
+//		and the size; the file, line, stack and the list of live objects
+//		for leak checking are only kept in debug builds.
+//
+//---------------------------------------------------------------------------
+class CMemoryPoolArena : public CMemoryPool
+{
+private:
+	// header of an allocation; the tagged size must be the last member,
+	// right before the user data
+	struct SArenaHeader
+	{
+#ifdef GPOS_DEBUG
+		// file name
+		const CHAR *m_filename;
+
+		// line in file
+		ULONG m_line;
+
+		// singleton or array
+		ULONG m_alloc_type;
+
+		// sequence number
+		ULLONG m_serial;
+
+		// allocation stack
+		CStackDescriptor m_stack_desc;
+
+		// link for allocation list
+		SLink m_link;
+#endif	// GPOS_DEBUG
+
+		// pool the allocation belongs to
+		CMemoryPoolArena *m_mp;
+
+		// user requested size, or-ed with GPOS_MEM_ARENA_TAG
+		ULLONG m_tagged_size;
+	};
+
+	// pool the blocks are allocated from
+	CMemoryPool *m_block_pool;
+
+	// free space in the current block
+	BYTE *m_block_cur;
+	BYTE *m_block_end;
+
+	// size of the next block
+	ULONG m_next_block_size;
+
+	// freed chunks, by aligned size
+	SArenaHeader *m_free_lists[GPOS_MEM_ARENA_FREE_LISTS];
+
+	// bytes obtained from the block pool, now and at most
+	ULLONG m_block_bytes;
+	ULLONG m_peak_block_bytes;
+
+	// statistics
+	CMemoryPoolStatistics m_memory_pool_statistics;
+
+#ifdef GPOS_DEBUG
+	// allocation sequence number
+	ULLONG m_alloc_sequence;
+
+	// list of allocated (live) objects
+	CList<SArenaHeader> m_allocations_list;
+#endif	// GPOS_DEBUG
+
+	// private copy ctor
+	CMemoryPoolArena(CMemoryPoolArena &);
+
+	// size of the chunk holding an allocation, including the header
+	static ULONG
+	ChunkSize(ULONG bytes)
+	{
+		// a freed chunk holds the link of its free list
+		if (bytes < GPOS_SIZEOF(void *))
+		{
+			bytes = GPOS_SIZEOF(void *);
+		}
+		return GPOS_MEM_ALIGNED_STRUCT_SIZE(SArenaHeader) +
+			   GPOS_MEM_ALIGNED_SIZE(bytes);
+	}
+
+	// header of an allocation
+	static SArenaHeader *
+	Header(const void *ptr)
+	{
+		return static_cast<SArenaHeader *>(const_cast<void *>(ptr)) - 1;
+	}
+
+	// carve a chunk out of the current block, or of a new one
+	void *AllocChunk(ULONG chunk_size);
+
+	// allocate a block of its own for a large chunk
+	void *AllocLargeChunk(ULONG chunk_size);
+
+	// return a freed allocation to the pool
+	void Free(SArenaHeader *header);
+
+protected:
+	// dtor
+	virtual ~CMemoryPoolArena();
+
+public:
+	// ctor, takes ownership of the block pool
+	explicit CMemoryPoolArena(CMemoryPool *block_pool);
+
+	// prepare the memory pool to be deleted
+	virtual void TearDown();
+
+	// allocate memory
+	void *NewImpl(const ULONG bytes, const CHAR *file, const ULONG line,
+				  CMemoryPool::EAllocationType eat);
+
+	// free memory allocation
+	static void DeleteImpl(void *ptr, EAllocationType eat);
+
+	// get user requested size of allocation
+	static ULONG UserSizeOfAlloc(const void *ptr);
+
+	// was the allocation made by an arena pool
+	static BOOL
+	IsArenaAllocation(const void *ptr)
+	{
+		const ULLONG word = *(static_cast<const ULLONG *>(ptr) - 1);
+		return GPOS_MEM_ARENA_TAG == (word & GPOS_MEM_ARENA_TAG_MASK);
+	}
+
+	// return total allocated size, the size of the blocks in use
+	virtual ULLONG
+	TotalAllocatedSize() const
+	{
+		return m_block_bytes;
+	}
+
+	// return the largest allocated size so far
+	virtual ULLONG
+	PeakAllocatedSize() const
+	{
+		return m_peak_block_bytes;
+	}
+
+#ifdef GPOS_DEBUG
+
+	// check if the memory pool keeps track of live objects
+	virtual BOOL
+	SupportsLiveObjectWalk() const
+	{
+		return true;
+	}
+
+	// walk the live objects
+	virtual void WalkLiveObjects(gpos::IMemoryVisitor *visitor);
+
+#endif	// GPOS_DEBUG
+};
+}  // namespace gpos
+
+#endif	// !GPOS_CMemoryPoolArena_H
+
+// EOF
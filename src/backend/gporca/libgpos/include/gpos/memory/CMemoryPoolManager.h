@@ -65,6 +65,9 @@ private:
 	// create new pool of given type
 	virtual CMemoryPool *NewMemoryPool();
 
+	// add a new pool to the hash table of pools
+	CMemoryPool *RegisterMemoryPool(CMemoryPool *mp);
+
 	// no copy ctor
 	CMemoryPoolManager(const CMemoryPoolManager &);
 
@@ -122,6 +125,9 @@ public:
 	// create new memory pool
 	CMemoryPool *CreateMemoryPool();
 
+	// create new arena memory pool, on top of a pool of the managed type
+	CMemoryPool *CreateArenaMemoryPool();
+
 	// release memory pool
 	void Destroy(CMemoryPool *);
 
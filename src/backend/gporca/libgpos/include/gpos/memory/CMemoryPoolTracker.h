@@ -34,6 +34,8 @@ class CMemoryPoolTracker : public CMemoryPool
 private:
 	// Defines memory block header layout for all allocations;
 	// does not include the pointer to the pool;
+	// the sequence number is the last member, so that the word before an
+	// allocation never looks like the tag of an arena allocation
 	struct SAllocHeader
 	{
 		// pointer to pool
@@ -45,9 +47,6 @@ private:
 		// user requested size
 		ULONG m_user_size;
 
-		// sequence number
-		ULLONG m_serial;
-
 		// file name
 		const CHAR *m_filename;
 
@@ -61,6 +60,9 @@ private:
 
 		// link for allocation list
 		SLink m_link;
+
+		// sequence number
+		ULLONG m_serial;
 	};
 
 	// statistics
@@ -109,6 +111,13 @@ public:
 		return m_memory_pool_statistics.TotalAllocatedSize();
 	}
 
+	// return the largest total allocated size so far
+	virtual ULLONG
+	PeakAllocatedSize() const
+	{
+		return m_memory_pool_statistics.PeakLiveObjTotalSize();
+	}
+
 #ifdef GPOS_DEBUG
 
 	// check if the memory pool keeps track of live objects
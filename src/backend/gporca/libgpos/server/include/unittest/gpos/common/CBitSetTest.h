@@ -31,6 +31,7 @@ public:
 	static GPOS_RESULT EresUnittest_Basics();
 	static GPOS_RESULT EresUnittest_Removal();
 	static GPOS_RESULT EresUnittest_SetOps();
+	static GPOS_RESULT EresUnittest_Spill();
 	static GPOS_RESULT EresUnittest_Performance();
 
 };	// class CBitSetTest
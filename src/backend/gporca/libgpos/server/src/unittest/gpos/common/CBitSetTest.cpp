@@ -13,6 +13,7 @@
 
 #include "gpos/base.h"
 #include "gpos/common/CBitSet.h"
+#include "gpos/common/CBitSetIter.h"
 #include "gpos/io/COstreamString.h"
 #include "gpos/memory/CAutoMemoryPool.h"
 #include "gpos/string/CWStringDynamic.h"
@@ -35,6 +36,7 @@ CBitSetTest::EresUnittest()
 		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Basics),
 		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Removal),
 		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_SetOps),
+		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Spill),
 		GPOS_UNITTEST_FUNC(CBitSetTest::EresUnittest_Performance)};
 
 	return CUnittest::EresExecute(rgut, GPOS_ARRAY_SIZE(rgut));
@@ -221,6 +223,73 @@ CBitSetTest::EresUnittest_SetOps()
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSetTest::EresUnittest_Spill
+//
+//	@doc:
+//		Test for sets that outgrow the words held in the set itself, and
+//		for operations on sets that hold different ranges of words
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CBitSetTest::EresUnittest_Spill()
+{
+	// create memory pool
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	// high elements first, so that the lower ones extend the set downwards
+	CBitSet *pbs1 = GPOS_NEW(mp) CBitSet(mp);
+	(void) pbs1->ExchangeSet(10000);
+	(void) pbs1->ExchangeSet(5000);
+	(void) pbs1->ExchangeSet(3);
+	GPOS_ASSERT(3 == pbs1->Size());
+	GPOS_ASSERT(pbs1->Get(3) && pbs1->Get(5000) && pbs1->Get(10000));
+	GPOS_ASSERT(!pbs1->Get(4) && !pbs1->Get(20000));
+
+	CBitSetIter bsiter(*pbs1);
+	ULONG rgul[] = {3, 5000, 10000};
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(rgul); ul++)
+	{
+		GPOS_ASSERT(bsiter.Advance() && rgul[ul] == bsiter.Bit());
+	}
+	GPOS_ASSERT(!bsiter.Advance());
+
+	// a set with a single high element only holds one word
+	CBitSet *pbs2 = GPOS_NEW(mp) CBitSet(mp);
+	(void) pbs2->ExchangeSet(5000);
+	GPOS_ASSERT(pbs1->ContainsAll(pbs2) && !pbs2->ContainsAll(pbs1));
+	GPOS_ASSERT(!pbs1->IsDisjoint(pbs2));
+
+	// equal sets are equal and hash the same, whatever words they hold
+	CBitSet *pbs3 = GPOS_NEW(mp) CBitSet(mp, *pbs1);
+	pbs3->Intersection(pbs2);
+	GPOS_ASSERT(pbs3->Equals(pbs2) && pbs2->Equals(pbs3));
+	GPOS_ASSERT(pbs3->HashValue() == pbs2->HashValue());
+
+	pbs3->Union(pbs1);
+	pbs3->Difference(pbs2);
+	GPOS_ASSERT(2 == pbs3->Size() && !pbs3->Get(5000));
+	GPOS_ASSERT(pbs3->IsDisjoint(pbs2));
+
+	(void) pbs3->ExchangeClear(3);
+	(void) pbs3->ExchangeClear(10000);
+	GPOS_ASSERT(0 == pbs3->Size());
+
+	// an emptied set can take elements anywhere
+	(void) pbs3->ExchangeSet(5000);
+	GPOS_ASSERT(pbs3->Equals(pbs2));
+	GPOS_ASSERT(pbs3->HashValue() == pbs2->HashValue());
+
+	pbs3->Release();
+	pbs2->Release();
+	pbs1->Release();
+
+	return GPOS_OK;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CBitSetTest::EresUnittest_Performance
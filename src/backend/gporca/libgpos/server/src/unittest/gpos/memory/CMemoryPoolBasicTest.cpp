@@ -18,6 +18,7 @@
 #include "gpos/error/CException.h"
 #include "gpos/io/COstreamString.h"
 #include "gpos/memory/CAutoMemoryPool.h"
+#include "gpos/memory/CMemoryPoolArena.h"
 #include "gpos/memory/CMemoryVisitorPrint.h"
 #include "gpos/string/CWStringDynamic.h"
 #include "gpos/task/CAutoTaskProxy.h"
@@ -45,7 +46,9 @@ CMemoryPoolBasicTest::EresUnittest()
 #ifdef GPOS_DEBUG
 		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_Print),
 #endif	// GPOS_DEBUG
-		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestTracker)};
+		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestTracker),
+		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestArena),
+		GPOS_UNITTEST_FUNC(CMemoryPoolBasicTest::EresUnittest_TestArenaMaxChunk)};
 
 	CAutoTraceFlag atf(EtraceTestMemoryPools, true /*value*/);
 
@@ -97,6 +100,102 @@ CMemoryPoolBasicTest::EresUnittest_TestTracker()
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolBasicTest::EresUnittest_TestArena
+//
+//	@doc:
+//		Run tests for arena pool: freed chunks are reused, large chunks are
+//		returned right away, and deletes work from outside the pool
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CMemoryPoolBasicTest::EresUnittest_TestArena()
+{
+	CAutoMemoryPool amp(CAutoMemoryPool::ElcExc, true /*use_arena*/);
+	CMemoryPool *mp = amp.Pmp();
+
+	const ULONG ulAllocs = 1000;
+	ULONG *rgrgul[ulAllocs];
+	for (ULONG ul = 0; ul < ulAllocs; ul++)
+	{
+		rgrgul[ul] = GPOS_NEW_ARRAY(mp, ULONG, Size(ul));
+		rgrgul[ul][0] = ul;
+	}
+
+	for (ULONG ul = 0; ul < ulAllocs; ul++)
+	{
+		GPOS_RTL_ASSERT(ul == rgrgul[ul][0]);
+		GPOS_RTL_ASSERT(Size(ul) * GPOS_SIZEOF(ULONG) ==
+						CMemoryPool::UserSizeOfAlloc(rgrgul[ul]));
+	}
+
+	// a freed chunk is reused by the next allocation of the same size
+	ULONG *pulFreed = rgrgul[ulAllocs - 1];
+	GPOS_DELETE_ARRAY(pulFreed);
+	rgrgul[ulAllocs - 1] = GPOS_NEW_ARRAY(mp, ULONG, Size(ulAllocs - 1));
+	GPOS_RTL_ASSERT(pulFreed == rgrgul[ulAllocs - 1]);
+
+	// a large allocation is returned to the block pool when freed
+	const ULLONG ullSize = mp->TotalAllocatedSize();
+	BYTE *pbLarge =
+		GPOS_NEW_ARRAY(mp, BYTE, 4 * GPOS_MEM_ARENA_MAX_CHUNK_SIZE);
+	GPOS_RTL_ASSERT(ullSize < mp->TotalAllocatedSize());
+	GPOS_DELETE_ARRAY(pbLarge);
+	GPOS_RTL_ASSERT(ullSize == mp->TotalAllocatedSize());
+	GPOS_RTL_ASSERT(ullSize < mp->PeakAllocatedSize());
+
+	for (ULONG ul = 0; ul < ulAllocs; ul++)
+	{
+		GPOS_DELETE_ARRAY(rgrgul[ul]);
+	}
+
+	return GPOS_OK;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMemoryPoolBasicTest::EresUnittest_TestArenaMaxChunk
+//
+//	@doc:
+//		The largest chunk carved from a block, allocated first in a fresh
+//		arena, must fit in the block even though the block starts out at
+//		the same size as the chunk's user bytes
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CMemoryPoolBasicTest::EresUnittest_TestArenaMaxChunk()
+{
+	CAutoMemoryPool amp(CAutoMemoryPool::ElcExc, true /*use_arena*/);
+	CMemoryPool *mp = amp.Pmp();
+
+	BYTE *pbFirst = GPOS_NEW_ARRAY(mp, BYTE, GPOS_MEM_ARENA_MAX_CHUNK_SIZE);
+	clib::Memset(pbFirst, 0xAB, GPOS_MEM_ARENA_MAX_CHUNK_SIZE);
+
+	// the next chunk must not overlap the first one
+	ULONG *pulNext = GPOS_NEW_ARRAY(mp, ULONG, GPOS_MEM_TEST_ALLOC_SMALL);
+	clib::Memset(pulNext, 0, GPOS_MEM_TEST_ALLOC_SMALL * GPOS_SIZEOF(ULONG));
+	GPOS_RTL_ASSERT(
+		reinterpret_cast<BYTE *>(pulNext) >=
+			pbFirst + GPOS_MEM_ARENA_MAX_CHUNK_SIZE ||
+		reinterpret_cast<BYTE *>(pulNext + GPOS_MEM_TEST_ALLOC_SMALL) <=
+			pbFirst);
+
+	for (ULONG ul = 0; ul < GPOS_MEM_ARENA_MAX_CHUNK_SIZE; ul++)
+	{
+		GPOS_RTL_ASSERT(0xAB == pbFirst[ul]);
+	}
+	GPOS_RTL_ASSERT(GPOS_MEM_ARENA_MAX_CHUNK_SIZE ==
+					CMemoryPool::UserSizeOfAlloc(pbFirst));
+
+	GPOS_DELETE_ARRAY(pulNext);
+	GPOS_DELETE_ARRAY(pbFirst);
+
+	return GPOS_OK;
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CMemoryPoolBasicTest::EresTestType
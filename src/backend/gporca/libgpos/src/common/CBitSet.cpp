@@ -7,16 +7,13 @@
 //
 //	@doc:
 //		Implementation of bit sets
-//
-//		Underlying assumption: a set contains only a few links of bitvectors
-//		hence, keeping them in a linked list is efficient;
 //---------------------------------------------------------------------------
 
 #include "gpos/common/CBitSet.h"
 
 #include "gpos/base.h"
-#include "gpos/common/CAutoRef.h"
 #include "gpos/common/CBitSetIter.h"
+#include "gpos/common/clibwrapper.h"
 
 #ifdef GPOS_DEBUG
 #include "gpos/error/CAutoTrace.h"
@@ -26,96 +23,118 @@ using namespace gpos;
 
 FORCE_GENERATE_DBGSTR(CBitSet);
 
-//---------------------------------------------------------------------------
-//	@function:
-//		CBitSetLink
-//
-//	@doc:
-//		ctor
-//
-//---------------------------------------------------------------------------
-CBitSet::CBitSetLink::CBitSetLink(CMemoryPool *mp, ULONG offset,
-								  ULONG vector_size)
-	: m_offset(offset)
-{
-	m_vec = GPOS_NEW(mp) CBitVector(mp, vector_size);
-}
+#define GPOS_BITSET_WORD_BITS (8 * GPOS_SIZEOF(ULLONG))
 
-
-//---------------------------------------------------------------------------
-//	@function:
-//		CBitSetLink
-//
-//	@doc:
-//		copy ctor
-//
-//---------------------------------------------------------------------------
-CBitSet::CBitSetLink::CBitSetLink(CMemoryPool *mp, const CBitSetLink &bsl)
-	: m_offset(bsl.m_offset)
+namespace
 {
-	m_vec = GPOS_NEW(mp) CBitVector(mp, *bsl.GetVec());
+// number of bits set in a word
+inline ULONG
+CountBits(ULLONG word)
+{
+#ifdef __GNUC__
+	return (ULONG) __builtin_popcountll(word);
+#else
+	ULONG count = 0;
+	for (; 0 != word; word &= word - 1)
+	{
+		count++;
+	}
+	return count;
+#endif	// __GNUC__
 }
 
-
-//---------------------------------------------------------------------------
-//	@function:
-//		~CBitSetLink
-//
-//	@doc:
-//		ctor
-//
-//---------------------------------------------------------------------------
-CBitSet::CBitSetLink::~CBitSetLink()
+// position of the lowest bit set in a non-zero word
+inline ULONG
+LowestBit(ULLONG word)
 {
-	GPOS_DELETE(m_vec);
+	GPOS_ASSERT(0 != word);
+#ifdef __GNUC__
+	return (ULONG) __builtin_ctzll(word);
+#else
+	ULONG pos = 0;
+	while (0 == (word & 1))
+	{
+		word >>= 1;
+		pos++;
+	}
+	return pos;
+#endif	// __GNUC__
 }
+}  // namespace
 
 
 //---------------------------------------------------------------------------
 //	@function:
-//		CBitSet::FindLinkByOffset
+//		CBitSet::Grow
 //
 //	@doc:
-//		Find bit set link for a given offset; if non-existent return previous
-//		link (may be NULL);
-//		By providing a starting link we can implement a number of operations
-//		in one sweep, ie O(N)
+//		Make the held words cover the words from first_word up to, but not
+//		including, end_word; the words are moved to a larger array if they
+//		do not fit, the new words are zero
 //
 //---------------------------------------------------------------------------
-CBitSet::CBitSetLink *
-CBitSet::FindLinkByOffset(ULONG offset, CBitSetLink *bsl) const
+void
+CBitSet::Grow(ULONG first_word, ULONG end_word)
 {
-	CBitSetLink *found = NULL;
-	CBitSetLink *cursor = bsl;
+	GPOS_ASSERT(first_word < end_word);
 
-	if (NULL == bsl)
+	if (0 == m_num_words)
 	{
-		// if no cursor provided start with first element
-		cursor = m_bsllist.First();
-	}
-	else
-	{
-		GPOS_ASSERT(bsl->GetOffset() <= offset && "invalid start cursor");
-		found = bsl;
+		m_base = first_word;
 	}
 
-	GPOS_ASSERT_IMP(NULL != cursor,
-					GPOS_OK == m_bsllist.Find(cursor) && "cursor not in list");
+	const ULONG base = std::min(m_base, first_word);
+	const ULONG end = std::max(m_base + m_num_words, end_word);
 
-	while (1)
+	if (base == m_base && end - base <= m_capacity)
 	{
-		// no more links or we've overshot the target
-		if (NULL == cursor || cursor->GetOffset() > offset)
+		// zero the new words at the end
+		for (ULONG ul = m_num_words; ul < end - base; ul++)
 		{
-			break;
+			m_words[ul] = 0;
 		}
+		m_num_words = end - base;
+
+		return;
+	}
+
+	const ULONG capacity = std::max(end - base, 2 * m_capacity);
+	ULLONG *words = GPOS_NEW_ARRAY(m_mp, ULLONG, capacity);
+	clib::Memset(words, 0, capacity * GPOS_SIZEOF(ULLONG));
+	if (0 < m_num_words)
+	{
+		clib::Memcpy(words + (m_base - base), m_words,
+					 m_num_words * GPOS_SIZEOF(ULLONG));
+	}
 
-		found = cursor;
-		cursor = m_bsllist.Next(cursor);
+	if (m_words != m_inline_words)
+	{
+		GPOS_DELETE_ARRAY(m_words);
 	}
 
-	GPOS_ASSERT_IMP(found, found->GetOffset() <= offset);
-	return found;
+	m_words = words;
+	m_capacity = capacity;
+	m_base = base;
+	m_num_words = end - base;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CBitSet::Trim
+//
+//	@doc:
+//		Drop the zero words at the end, so that a set that lost all its
+//		elements can later be rebased anywhere
+//
+//---------------------------------------------------------------------------
+void
+CBitSet::Trim()
+{
+	while (0 < m_num_words && 0 == m_words[m_num_words - 1])
+	{
+		m_num_words--;
+	}
 }
 
 
@@ -124,18 +143,16 @@ CBitSet::FindLinkByOffset(ULONG offset, CBitSetLink *bsl) const
 //		CBitSet::RecomputeSize
 //
 //	@doc:
-//		Compute size of set by adding up sizes of links
+//		Compute size of set by counting the bits of all words
 //
 //---------------------------------------------------------------------------
 void
 CBitSet::RecomputeSize()
 {
 	m_size = 0;
-	CBitSetLink *bsl = NULL;
-
-	for (bsl = m_bsllist.First(); bsl != NULL; bsl = m_bsllist.Next(bsl))
+	for (ULONG ul = 0; ul < m_num_words; ul++)
 	{
-		m_size += bsl->GetVec()->CountSetBits();
+		m_size += CountBits(m_words[ul]);
 	}
 }
 
@@ -145,41 +162,58 @@ CBitSet::RecomputeSize()
 //		CBitSet::Clear
 //
 //	@doc:
-//		release all links
+//		Release the array of words, if any
 //
 //---------------------------------------------------------------------------
 void
 CBitSet::Clear()
 {
-	CBitSetLink *bsl = NULL;
-
-	while (NULL != (bsl = m_bsllist.First()))
+	if (m_words != m_inline_words)
 	{
-		CBitSetLink *bsl_to_remove = bsl;
-		bsl = m_bsllist.Next(bsl);
-
-		m_bsllist.Remove(bsl_to_remove);
-		GPOS_DELETE(bsl_to_remove);
+		GPOS_DELETE_ARRAY(m_words);
+		m_words = m_inline_words;
+		m_capacity = GPOS_BITSET_INLINE_WORDS;
 	}
 
-	RecomputeSize();
+	m_base = 0;
+	m_num_words = 0;
+	m_size = 0;
 }
 
 
 //---------------------------------------------------------------------------
 //	@function:
-//		CBitSet::GetOffset
+//		CBitSet::GetNextSetBit
 //
 //	@doc:
-//		Compute offset
+//		Find the first element that is not less than start_pos
 //
 //---------------------------------------------------------------------------
-ULONG
-CBitSet::ComputeOffset(ULONG ul) const
+BOOL
+CBitSet::GetNextSetBit(ULONG start_pos, ULONG &pos) const
 {
-	return (ul / m_vector_size) * m_vector_size;
-}
+	ULONG word = start_pos / GPOS_BITSET_WORD_BITS;
+	ULLONG mask = ~0ULL << (start_pos % GPOS_BITSET_WORD_BITS);
 
+	if (word < m_base)
+	{
+		word = m_base;
+		mask = ~0ULL;
+	}
+
+	for (ULONG ul = word - m_base; ul < m_num_words; ul++)
+	{
+		const ULLONG bits = m_words[ul] & mask;
+		if (0 != bits)
+		{
+			pos = (m_base + ul) * GPOS_BITSET_WORD_BITS + LowestBit(bits);
+			return true;
+		}
+		mask = ~0ULL;
+	}
+
+	return false;
+}
 
 
 //---------------------------------------------------------------------------
@@ -190,10 +224,14 @@ CBitSet::ComputeOffset(ULONG ul) const
 //		ctor
 //
 //---------------------------------------------------------------------------
-CBitSet::CBitSet(CMemoryPool *mp, ULONG vector_size)
-	: m_mp(mp), m_vector_size(vector_size), m_size(0)
+CBitSet::CBitSet(CMemoryPool *mp, ULONG)
+	: m_mp(mp),
+	  m_size(0),
+	  m_base(0),
+	  m_num_words(0),
+	  m_capacity(GPOS_BITSET_INLINE_WORDS),
+	  m_words(m_inline_words)
 {
-	m_bsllist.Init(GPOS_OFFSET(CBitSetLink, m_link));
 }
 
 
@@ -206,9 +244,13 @@ CBitSet::CBitSet(CMemoryPool *mp, ULONG vector_size)
 //
 //---------------------------------------------------------------------------
 CBitSet::CBitSet(CMemoryPool *mp, const CBitSet &bs)
-	: m_mp(mp), m_vector_size(bs.m_vector_size), m_size(0)
+	: m_mp(mp),
+	  m_size(0),
+	  m_base(0),
+	  m_num_words(0),
+	  m_capacity(GPOS_BITSET_INLINE_WORDS),
+	  m_words(m_inline_words)
 {
-	m_bsllist.Init(GPOS_OFFSET(CBitSetLink, m_link));
 	Union(&bs);
 }
 
@@ -238,15 +280,9 @@ CBitSet::~CBitSet()
 BOOL
 CBitSet::Get(ULONG pos) const
 {
-	ULONG offset = ComputeOffset(pos);
+	const ULLONG mask = 1ULL << (pos % GPOS_BITSET_WORD_BITS);
 
-	CBitSetLink *bsl = FindLinkByOffset(offset);
-	if (NULL != bsl && bsl->GetOffset() == offset)
-	{
-		return bsl->GetVec()->Get(pos - offset);
-	}
-
-	return false;
+	return 0 != (Word(pos / GPOS_BITSET_WORD_BITS) & mask);
 }
 
 
@@ -255,41 +291,30 @@ CBitSet::Get(ULONG pos) const
 //		CBitSet::ExchangeSet
 //
 //	@doc:
-//		Set given bit; return previous value; allocate new link if necessary
+//		Set given bit; return previous value; grow the words if necessary
 //
 //---------------------------------------------------------------------------
 BOOL
 CBitSet::ExchangeSet(ULONG pos)
 {
-	ULONG offset = ComputeOffset(pos);
+	const ULONG word = pos / GPOS_BITSET_WORD_BITS;
+	const ULLONG mask = 1ULL << (pos % GPOS_BITSET_WORD_BITS);
 
-	CBitSetLink *bsl = FindLinkByOffset(offset);
-	if (NULL == bsl || bsl->GetOffset() != offset)
+	if (word < m_base || word - m_base >= m_num_words)
 	{
-		CBitSetLink *pbsl_new =
-			GPOS_NEW(m_mp) CBitSetLink(m_mp, offset, m_vector_size);
-		if (NULL == bsl)
-		{
-			m_bsllist.Prepend(pbsl_new);
-		}
-		else
-		{
-			// insert after found link
-			m_bsllist.Append(pbsl_new, bsl);
-		}
-
-		bsl = pbsl_new;
+		Grow(word, word + 1);
 	}
 
-	GPOS_ASSERT(bsl->GetOffset() == offset);
-
-	BOOL bit = bsl->GetVec()->ExchangeSet(pos - offset);
-	if (!bit)
+	ULLONG &bits = m_words[word - m_base];
+	if (0 != (bits & mask))
 	{
-		m_size++;
+		return true;
 	}
 
-	return bit;
+	bits |= mask;
+	m_size++;
+
+	return false;
 }
 
 
@@ -304,29 +329,19 @@ CBitSet::ExchangeSet(ULONG pos)
 BOOL
 CBitSet::ExchangeClear(ULONG pos)
 {
-	ULONG offset = ComputeOffset(pos);
+	const ULONG word = pos / GPOS_BITSET_WORD_BITS;
+	const ULLONG mask = 1ULL << (pos % GPOS_BITSET_WORD_BITS);
 
-	CBitSetLink *bsl = FindLinkByOffset(offset);
-	if (NULL != bsl && bsl->GetOffset() == offset)
+	if (0 == (Word(word) & mask))
 	{
-		BOOL bit = bsl->GetVec()->ExchangeClear(pos - offset);
-
-		// remove empty link
-		if (bsl->GetVec()->IsEmpty())
-		{
-			m_bsllist.Remove(bsl);
-			GPOS_DELETE(bsl);
-		}
-
-		if (bit)
-		{
-			m_size--;
-		}
-
-		return bit;
+		return false;
 	}
 
-	return false;
+	m_words[word - m_base] &= ~mask;
+	m_size--;
+	Trim();
+
+	return true;
 }
 
 
@@ -335,74 +350,27 @@ CBitSet::ExchangeClear(ULONG pos)
 //		CBitSet::Union
 //
 //	@doc:
-//		Union with given other set;
-//		(1) determine which links need to be allocated before(!) modifying
-//			the set allocate and copy missing links aside
-//		(2) insert the new links into the list
-//		(3) union all links, old and new, on a per-bitvector basis
-//
-//		For clarity step (2) and (3) are separated;
+//		Union with given other set; grow the words to cover the other set,
+//		then or the other set's words in
 //
 //---------------------------------------------------------------------------
 void
 CBitSet::Union(const CBitSet *pbsOther)
 {
-	CBitSetLink *bsl = NULL;
-	CBitSetLink *bsl_other = NULL;
-
-	// dynamic array of CBitSetLink
-	typedef CDynamicPtrArray<CBitSetLink, CleanupNULL> CBitSetLinkArray;
-
-	CAutoRef<CBitSetLinkArray> a_drgpbsl;
-	a_drgpbsl = GPOS_NEW(m_mp) CBitSetLinkArray(m_mp);
-
-	// iterate through other's links and copy missing links to array
-	for (bsl_other = pbsOther->m_bsllist.First(); bsl_other != NULL;
-		 bsl_other = pbsOther->m_bsllist.Next(bsl_other))
+	if (0 == pbsOther->m_num_words)
 	{
-		bsl = FindLinkByOffset(bsl_other->GetOffset(), bsl);
-		if (NULL == bsl || bsl->GetOffset() != bsl_other->GetOffset())
-		{
-			// need to copy this link
-			CAutoP<CBitSetLink> a_pbsl;
-			a_pbsl = GPOS_NEW(m_mp) CBitSetLink(m_mp, *bsl_other);
-			a_drgpbsl->Append(a_pbsl.Value());
-
-			a_pbsl.Reset();
-		}
+		return;
 	}
 
-	// insert all new links
-	bsl = NULL;
-	for (ULONG i = 0; i < a_drgpbsl->Size(); i++)
-	{
-		CBitSetLink *pbslInsert = (*a_drgpbsl)[i];
-		bsl = FindLinkByOffset(pbslInsert->GetOffset(), bsl);
+	Grow(pbsOther->m_base, pbsOther->m_base + pbsOther->m_num_words);
 
-		GPOS_ASSERT_IMP(NULL != bsl,
-						bsl->GetOffset() < pbslInsert->GetOffset());
-		if (NULL == bsl)
-		{
-			m_bsllist.Prepend(pbslInsert);
-		}
-		else
-		{
-			m_bsllist.Append(pbslInsert, bsl);
-		}
-	}
+	ULLONG *words = m_words + (pbsOther->m_base - m_base);
+	const ULLONG *words_other = pbsOther->m_words;
+	const ULONG num_words = pbsOther->m_num_words;
 
-	// iterate through all links and union them up
-	bsl_other = NULL;
-	bsl = m_bsllist.First();
-	while (NULL != bsl)
+	for (ULONG ul = 0; ul < num_words; ul++)
 	{
-		bsl_other = pbsOther->FindLinkByOffset(bsl->GetOffset(), bsl_other);
-		if (NULL != bsl_other && bsl_other->GetOffset() == bsl->GetOffset())
-		{
-			bsl->GetVec()->Or(bsl_other->GetVec());
-		}
-
-		bsl = m_bsllist.Next(bsl);
+		words[ul] |= words_other[ul];
 	}
 
 	RecomputeSize();
@@ -414,7 +382,7 @@ CBitSet::Union(const CBitSet *pbsOther)
 //		CBitSet::Intersection
 //
 //	@doc:
-//		Iterate through all links and intersect them; release unused links
+//		And the words both sets hold, and clear the words only this set holds
 //
 //---------------------------------------------------------------------------
 void
@@ -425,39 +393,35 @@ CBitSet::Intersection(const CBitSet *pbsOther)
 		return;
 	}
 
-	CBitSetLink *bsl_other = NULL;
-	CBitSetLink *bsl = m_bsllist.First();
+	const ULONG end = m_base + m_num_words;
+	const ULONG end_other = pbsOther->m_base + pbsOther->m_num_words;
+	const ULONG first_common = std::max(m_base, pbsOther->m_base);
+	const ULONG end_common = std::min(end, end_other);
 
-	while (NULL != bsl)
+	if (first_common >= end_common)
 	{
-		CBitSetLink *bsl_to_remove = NULL;
+		m_num_words = 0;
+		m_size = 0;
+		return;
+	}
 
-		bsl_other = pbsOther->FindLinkByOffset(bsl->GetOffset(), bsl_other);
-		if (NULL != bsl_other && bsl_other->GetOffset() == bsl->GetOffset())
-		{
-			bsl->GetVec()->And(bsl_other->GetVec());
-			CBitSetLink *bsl_prev = bsl;
-
-			bsl = m_bsllist.Next(bsl);
-			// If vector is empty after "ANDing", remove the vector, otherwise
-			// we can get into a situation where an empty vector exists
-			// and causes wrong results for equals/contains operations later
-			if (bsl_prev->GetVec()->IsEmpty())
-			{
-				m_bsllist.Remove(bsl_prev);
-				GPOS_DELETE(bsl_prev);
-			}
-		}
-		else
-		{
-			bsl_to_remove = bsl;
-			bsl = m_bsllist.Next(bsl);
+	for (ULONG ul = m_base; ul < first_common; ul++)
+	{
+		m_words[ul - m_base] = 0;
+	}
 
-			m_bsllist.Remove(bsl_to_remove);
-			GPOS_DELETE(bsl_to_remove);
-		}
+	ULLONG *words = m_words + (first_common - m_base);
+	const ULLONG *words_other =
+		pbsOther->m_words + (first_common - pbsOther->m_base);
+	const ULONG num_words = end_common - first_common;
+
+	for (ULONG ul = 0; ul < num_words; ul++)
+	{
+		words[ul] &= words_other[ul];
 	}
 
+	m_num_words = end_common - m_base;
+	Trim();
 	RecomputeSize();
 }
 
@@ -467,23 +431,32 @@ CBitSet::Intersection(const CBitSet *pbsOther)
 //		CBitSet::Difference
 //
 //	@doc:
-//		Substract other set from this by iterating through other set and
-//		explicit removal of elements;
+//		Clear the bits of the other set in the words both sets hold
 //
 //---------------------------------------------------------------------------
 void
 CBitSet::Difference(const CBitSet *pbs)
 {
-	if (IsDisjoint(pbs))
+	const ULONG first_common = std::max(m_base, pbs->m_base);
+	const ULONG end_common = std::min(m_base + m_num_words,
+									  pbs->m_base + pbs->m_num_words);
+
+	if (first_common >= end_common)
 	{
 		return;
 	}
 
-	CBitSetIter bsiter(*pbs);
-	while (bsiter.Advance())
+	ULLONG *words = m_words + (first_common - m_base);
+	const ULLONG *words_other = pbs->m_words + (first_common - pbs->m_base);
+	const ULONG num_words = end_common - first_common;
+
+	for (ULONG ul = 0; ul < num_words; ul++)
 	{
-		(void) ExchangeClear(bsiter.Bit());
+		words[ul] &= ~words_other[ul];
 	}
+
+	Trim();
+	RecomputeSize();
 }
 
 
@@ -504,17 +477,10 @@ CBitSet::ContainsAll(const CBitSet *bs) const
 		return false;
 	}
 
-	CBitSetLink *bsl = NULL;
-	CBitSetLink *bsl_other = NULL;
-
-	// iterate through other's links and check for subsets
-	for (bsl_other = bs->m_bsllist.First(); bsl_other != NULL;
-		 bsl_other = bs->m_bsllist.Next(bsl_other))
+	for (ULONG ul = 0; ul < bs->m_num_words; ul++)
 	{
-		bsl = FindLinkByOffset(bsl_other->GetOffset(), bsl);
-
-		if (NULL == bsl || bsl->GetOffset() != bsl_other->GetOffset() ||
-			!bsl->GetVec()->ContainsAll(bsl_other->GetVec()))
+		const ULLONG bits_other = bs->m_words[ul];
+		if (bits_other != (bits_other & Word(bs->m_base + ul)))
 		{
 			return false;
 		}
@@ -541,29 +507,8 @@ CBitSet::Equals(const CBitSet *bs) const
 		return true;
 	}
 
-	// skip iterating if we can already tell by the sizes
-	if (Size() != bs->Size())
-	{
-		return false;
-	}
-
-	CBitSetLink *bsl = m_bsllist.First();
-	CBitSetLink *bsl_other = bs->m_bsllist.First();
-
-	while (NULL != bsl)
-	{
-		if (NULL == bsl_other || bsl->GetOffset() != bsl_other->GetOffset() ||
-			!bsl->GetVec()->Equals(bsl_other->GetVec()))
-		{
-			return false;
-		}
-
-		bsl = m_bsllist.Next(bsl);
-		bsl_other = bs->m_bsllist.Next(bsl_other);
-	}
-
-	// same length implies bsl_other must have reached end as well
-	return bsl_other == NULL;
+	// sets of the same size are equal if one contains the other
+	return Size() == bs->Size() && ContainsAll(bs);
 }
 
 
@@ -579,23 +524,26 @@ CBitSet::Equals(const CBitSet *bs) const
 BOOL
 CBitSet::IsDisjoint(const CBitSet *bs) const
 {
-	CBitSetLink *bsl = NULL;
-	CBitSetLink *bsl_other = NULL;
+	const ULONG first_common = std::max(m_base, bs->m_base);
+	const ULONG end_common =
+		std::min(m_base + m_num_words, bs->m_base + bs->m_num_words);
 
-	// iterate through other's links an check if disjoint
-	for (bsl_other = bs->m_bsllist.First(); bsl_other != NULL;
-		 bsl_other = bs->m_bsllist.Next(bsl_other))
+	if (first_common >= end_common)
 	{
-		bsl = FindLinkByOffset(bsl_other->GetOffset(), bsl);
+		return true;
+	}
 
-		if (NULL != bsl && bsl->GetOffset() == bsl_other->GetOffset() &&
-			!bsl->GetVec()->IsDisjoint(bsl_other->GetVec()))
-		{
-			return false;
-		}
+	const ULLONG *words = m_words + (first_common - m_base);
+	const ULLONG *words_other = bs->m_words + (first_common - bs->m_base);
+	const ULONG num_words = end_common - first_common;
+
+	ULLONG common = 0;
+	for (ULONG ul = 0; ul < num_words; ul++)
+	{
+		common |= words[ul] & words_other[ul];
 	}
 
-	return true;
+	return 0 == common;
 }
 
 
@@ -604,7 +552,9 @@ CBitSet::IsDisjoint(const CBitSet *bs) const
 //		CBitSet::HashValue
 //
 //	@doc:
-//		Compute hash value for set
+//		Compute hash value for set; only the non-zero words and their
+//		position are hashed, so equal sets hash the same however many
+//		words they hold
 //
 //---------------------------------------------------------------------------
 ULONG
@@ -612,11 +562,16 @@ CBitSet::HashValue() const
 {
 	ULONG ulHash = 0;
 
-	CBitSetLink *bsl = m_bsllist.First();
-	while (NULL != bsl)
+	for (ULONG ul = 0; ul < m_num_words; ul++)
 	{
-		ulHash = gpos::CombineHashes(ulHash, bsl->GetVec()->HashValue());
-		bsl = m_bsllist.Next(bsl);
+		if (0 != m_words[ul])
+		{
+			const ULONG word = m_base + ul;
+			ulHash = gpos::CombineHashes(
+				ulHash, gpos::CombineHashes(gpos::HashValue<ULONG>(&word),
+											gpos::HashValue<ULLONG>(
+												&m_words[ul])));
+		}
 	}
 
 	return ulHash;
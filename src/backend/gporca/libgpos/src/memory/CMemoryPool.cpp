@@ -16,6 +16,7 @@
 #include "gpos/error/CFSimulator.h"
 #endif	// GPOS_DEBUG
 #include "gpos/memory/CMemoryPool.h"
+#include "gpos/memory/CMemoryPoolArena.h"
 #include "gpos/memory/CMemoryPoolManager.h"
 #include "gpos/memory/CMemoryPoolTracker.h"
 #include "gpos/memory/CMemoryVisitorPrint.h"
@@ -33,13 +34,27 @@ CMemoryPool::UserSizeOfAlloc(const void *ptr)
 {
 	GPOS_ASSERT(NULL != ptr);
 
+	if (CMemoryPoolArena::IsArenaAllocation(ptr))
+	{
+		return CMemoryPoolArena::UserSizeOfAlloc(ptr);
+	}
+
 	return CMemoryPoolManager::GetMemoryPoolMgr()->UserSizeOfAlloc(ptr);
 }
 
 
+// free allocation; arena pools can be created by any memory pool manager,
+// so their allocations are recognized before handing the rest to the
+// manager
 void
 CMemoryPool::DeleteImpl(void *ptr, EAllocationType eat)
 {
+	if (CMemoryPoolArena::IsArenaAllocation(ptr))
+	{
+		CMemoryPoolArena::DeleteImpl(ptr, eat);
+		return;
+	}
+
 	CMemoryPoolManager::GetMemoryPoolMgr()->DeleteImpl(ptr, eat);
 }
 
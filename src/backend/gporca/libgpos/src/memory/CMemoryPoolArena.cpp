@@ -0,0 +1,276 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (C) 2025 Greengage Community
+//
+//	@filename:
+//		CMemoryPoolArena.cpp
+//
+//	@doc:
+//		Implementation of memory pool that carves allocations out of
+//		large blocks and releases all of them at once
+//
+//---------------------------------------------------------------------------
+
+#include "gpos/memory/CMemoryPoolArena.h"
+
+#include "gpos/assert.h"
+#include "gpos/common/clibwrapper.h"
+#include "gpos/memory/CMemoryPoolManager.h"
+#include "gpos/memory/IMemoryVisitor.h"
+#include "gpos/types.h"
+#include "gpos/utils.h"
+
+using namespace gpos;
+
+#define GPOS_MEM_ARENA_HEADER_SIZE GPOS_MEM_ALIGNED_STRUCT_SIZE(SArenaHeader)
+
+
+// ctor
+CMemoryPoolArena::CMemoryPoolArena(CMemoryPool *block_pool)
+	: CMemoryPool(),
+	  m_block_pool(block_pool),
+	  m_block_cur(NULL),
+	  m_block_end(NULL),
+	  m_next_block_size(GPOS_MEM_ARENA_INIT_BLOCK_SIZE),
+	  m_block_bytes(0),
+	  m_peak_block_bytes(0)
+#ifdef GPOS_DEBUG
+	  ,
+	  m_alloc_sequence(0)
+#endif	// GPOS_DEBUG
+{
+	GPOS_ASSERT(NULL != block_pool);
+	GPOS_ASSERT(GPOS_SIZEOF(SArenaHeader) ==
+				GPOS_MEM_ALIGNED_STRUCT_SIZE(SArenaHeader));
+
+	for (ULONG ul = 0; ul < GPOS_MEM_ARENA_FREE_LISTS; ul++)
+	{
+		m_free_lists[ul] = NULL;
+	}
+
+#ifdef GPOS_DEBUG
+	m_allocations_list.Init(GPOS_OFFSET(SArenaHeader, m_link));
+#endif	// GPOS_DEBUG
+}
+
+
+// dtor
+CMemoryPoolArena::~CMemoryPoolArena()
+{
+	GPOS_ASSERT(NULL == m_block_pool);
+}
+
+
+// carve a chunk out of the current block, or of a new one
+void *
+CMemoryPoolArena::AllocChunk(ULONG chunk_size)
+{
+	if (m_block_cur + chunk_size > m_block_end)
+	{
+		// the rest of the current block is abandoned; a chunk near
+		// GPOS_MEM_ARENA_MAX_CHUNK_SIZE plus its header may not fit in
+		// the early, smaller blocks, so the block grows to hold it
+		ULONG block_size = m_next_block_size;
+		if (block_size < chunk_size)
+		{
+			block_size = chunk_size;
+		}
+
+		m_block_cur = static_cast<BYTE *>(m_block_pool->NewImpl(
+			block_size, __FILE__, __LINE__, CMemoryPool::EatSingleton));
+		m_block_end = m_block_cur + block_size;
+
+		m_block_bytes += block_size;
+		if (m_block_bytes > m_peak_block_bytes)
+		{
+			m_peak_block_bytes = m_block_bytes;
+		}
+
+		if (m_next_block_size < GPOS_MEM_ARENA_MAX_BLOCK_SIZE)
+		{
+			m_next_block_size *= 2;
+		}
+	}
+
+	void *chunk = m_block_cur;
+	m_block_cur += chunk_size;
+
+	return chunk;
+}
+
+
+// allocate a block of its own for a large chunk
+void *
+CMemoryPoolArena::AllocLargeChunk(ULONG chunk_size)
+{
+	void *chunk = m_block_pool->NewImpl(chunk_size, __FILE__, __LINE__,
+										CMemoryPool::EatSingleton);
+
+	m_block_bytes += chunk_size;
+	if (m_block_bytes > m_peak_block_bytes)
+	{
+		m_peak_block_bytes = m_block_bytes;
+	}
+
+	return chunk;
+}
+
+
+void *
+CMemoryPoolArena::NewImpl(const ULONG bytes, const CHAR *file, const ULONG line,
+						  CMemoryPool::EAllocationType eat)
+{
+	GPOS_ASSERT(bytes <= GPOS_MEM_ALLOC_MAX);
+	GPOS_ASSERT(NULL != m_block_pool);
+
+	const ULONG chunk_size = ChunkSize(bytes);
+	const ULONG user_size = chunk_size - GPOS_MEM_ARENA_HEADER_SIZE;
+
+	SArenaHeader *header = NULL;
+	if (user_size > GPOS_MEM_ARENA_MAX_CHUNK_SIZE)
+	{
+		header = static_cast<SArenaHeader *>(AllocLargeChunk(chunk_size));
+	}
+	else if (NULL != m_free_lists[user_size / GPOS_MEM_ARCH])
+	{
+		// reuse a freed chunk of the same size
+		header = m_free_lists[user_size / GPOS_MEM_ARCH];
+		m_free_lists[user_size / GPOS_MEM_ARCH] =
+			*reinterpret_cast<SArenaHeader **>(header + 1);
+	}
+	else
+	{
+		header = static_cast<SArenaHeader *>(AllocChunk(chunk_size));
+	}
+
+	header->m_mp = this;
+	header->m_tagged_size = GPOS_MEM_ARENA_TAG | bytes;
+
+	m_memory_pool_statistics.RecordAllocation(bytes, chunk_size);
+
+	void *ptr_result = header + 1;
+
+#ifdef GPOS_DEBUG
+	header->m_filename = file;
+	header->m_line = line;
+	header->m_alloc_type = eat;
+	header->m_serial = m_alloc_sequence;
+	++m_alloc_sequence;
+
+	header->m_stack_desc.BackTrace();
+	m_allocations_list.Prepend(header);
+
+	clib::Memset(ptr_result, GPOS_MEM_INIT_PATTERN_CHAR, bytes);
+#else
+	(void) file;
+	(void) line;
+	(void) eat;
+#endif	// GPOS_DEBUG
+
+	return ptr_result;
+}
+
+
+// return a freed allocation to the pool
+void
+CMemoryPoolArena::Free(SArenaHeader *header)
+{
+	const ULONG bytes = UserSizeOfAlloc(header + 1);
+	const ULONG chunk_size = ChunkSize(bytes);
+	const ULONG user_size = chunk_size - GPOS_MEM_ARENA_HEADER_SIZE;
+
+	m_memory_pool_statistics.RecordFree(bytes, chunk_size);
+
+#ifdef GPOS_DEBUG
+	m_allocations_list.Remove(header);
+
+	// mark user memory as unused in debug mode
+	clib::Memset(header + 1, GPOS_MEM_FREED_PATTERN_CHAR, user_size);
+#endif	// GPOS_DEBUG
+
+	if (user_size > GPOS_MEM_ARENA_MAX_CHUNK_SIZE)
+	{
+		m_block_bytes -= chunk_size;
+		CMemoryPool::DeleteImpl(header, CMemoryPool::EatSingleton);
+		return;
+	}
+
+	*reinterpret_cast<SArenaHeader **>(header + 1) =
+		m_free_lists[user_size / GPOS_MEM_ARCH];
+	m_free_lists[user_size / GPOS_MEM_ARCH] = header;
+}
+
+
+// free memory allocation
+void
+CMemoryPoolArena::DeleteImpl(void *ptr, EAllocationType eat)
+{
+	GPOS_ASSERT(IsArenaAllocation(ptr));
+
+	SArenaHeader *header = Header(ptr);
+
+	// this assert ensures we aren't freeing an array as a singleton
+	GPOS_ASSERT(eat == EatUnknown || header->m_alloc_type == (ULONG) eat);
+	(void) eat;
+
+	GPOS_ASSERT(NULL != header->m_mp);
+	header->m_mp->Free(header);
+}
+
+
+// get user requested size of allocation
+ULONG
+CMemoryPoolArena::UserSizeOfAlloc(const void *ptr)
+{
+	GPOS_ASSERT(IsArenaAllocation(ptr));
+
+	return (ULONG)(Header(ptr)->m_tagged_size & ~GPOS_MEM_ARENA_TAG_MASK);
+}
+
+
+// Prepare the memory pool to be deleted; all the blocks are released at
+// once, with the block pool they were allocated from
+void
+CMemoryPoolArena::TearDown()
+{
+#ifdef GPOS_DEBUG
+	while (!m_allocations_list.IsEmpty())
+	{
+		(void) m_allocations_list.RemoveHead();
+	}
+#endif	// GPOS_DEBUG
+
+	m_block_pool->TearDown();
+	GPOS_DELETE(m_block_pool);
+	m_block_pool = NULL;
+
+	m_block_cur = NULL;
+	m_block_end = NULL;
+	m_block_bytes = 0;
+}
+
+
+#ifdef GPOS_DEBUG
+
+void
+CMemoryPoolArena::WalkLiveObjects(gpos::IMemoryVisitor *visitor)
+{
+	GPOS_ASSERT(NULL != visitor);
+
+	SArenaHeader *header = m_allocations_list.First();
+	while (NULL != header)
+	{
+		void *user = header + 1;
+		const ULONG user_size = UserSizeOfAlloc(user);
+
+		visitor->Visit(user, user_size, header, ChunkSize(user_size),
+					   header->m_filename, header->m_line, header->m_serial,
+					   &header->m_stack_desc);
+
+		header = m_allocations_list.Next(header);
+	}
+}
+
+#endif	// GPOS_DEBUG
+
+// EOF
@@ -19,6 +19,7 @@
 #include "gpos/error/CAutoTrace.h"
 #include "gpos/error/CFSimulator.h"	 // for GPOS_FPSIMULATOR
 #include "gpos/memory/CMemoryPool.h"
+#include "gpos/memory/CMemoryPoolArena.h"
 #include "gpos/memory/CMemoryPoolTracker.h"
 #include "gpos/memory/CMemoryVisitorPrint.h"
 #include "gpos/task/CAutoSuspendAbort.h"
@@ -79,8 +80,26 @@ CMemoryPoolManager::Init()
 CMemoryPool *
 CMemoryPoolManager::CreateMemoryPool()
 {
-	CMemoryPool *mp = NewMemoryPool();
+	return RegisterMemoryPool(NewMemoryPool());
+}
+
+
+// Create a new arena memory pool; its blocks are allocated from a pool of
+// the type this manager creates, which is not registered on its own
+CMemoryPool *
+CMemoryPoolManager::CreateArenaMemoryPool()
+{
+	CMemoryPool *block_pool = NewMemoryPool();
 
+	return RegisterMemoryPool(GPOS_NEW(m_internal_memory_pool)
+								  CMemoryPoolArena(block_pool));
+}
+
+
+// Add a new memory pool to the hash table of pools
+CMemoryPool *
+CMemoryPoolManager::RegisterMemoryPool(CMemoryPool *mp)
+{
 	// accessor scope
 	{
 		// HERE BE DRAGONS
@@ -0,0 +1,81 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (C) 2025 Greengage Community
+//
+//	@filename:
+//		CDXLBinary.h
+//
+//	@doc:
+//		Binary encoding of DXL documents
+//---------------------------------------------------------------------------
+#ifndef GPDXL_CDXLBinary_H
+#define GPDXL_CDXLBinary_H
+
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+
+#include "gpos/base.h"
+#include "gpos/string/CWStringDynamic.h"
+
+// first bytes of a binary DXL document; an XML document starts with '<'
+#define GPDXL_BINARY_MAGIC "GPBDXL1"
+
+namespace gpdxl
+{
+using namespace gpos;
+
+XERCES_CPP_NAMESPACE_USE
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CDXLBinary
+//
+//	@doc:
+//		Compact binary encoding of DXL documents, such as metadata, query
+//		and plan trees and minidumps.
+//
+//		A binary document is the magic string followed by the elements of
+//		the XML document in document order: an open record with the name
+//		and the attributes of an element, and a close record at its end.
+//		Names and attribute values are stored once, the first time they
+//		occur, and are referenced by number afterwards, so the document
+//		is free of the tokenizing, escaping and transcoding of XML, and
+//		repeated names and values, such as type ids, only cost a byte or
+//		two each.
+//
+//		The records are fed to the DXL parse handlers the same way the XML
+//		parser would, so every kind of DXL document can be encoded. All
+//		numbers are encoded so that they never contain a zero byte, which
+//		lets a binary document pass through every function that takes a
+//		DXL document as a C string.
+//
+//---------------------------------------------------------------------------
+class CDXLBinary
+{
+private:
+	// private copy ctor
+	CDXLBinary(const CDXLBinary &);
+
+public:
+	// is the given document in the binary format
+	static BOOL IsBinary(const CHAR *dxl_string);
+
+	// is the given file a binary document
+	static BOOL IsBinaryFile(const CHAR *file_name);
+
+	// encode the given XML document in the binary format
+	static CHAR *Encode(CMemoryPool *mp, const CHAR *xml_string);
+
+	// decode the given binary document to XML
+	static CWStringDynamic *Decode(CMemoryPool *mp, const CHAR *dxl_binary,
+								   BOOL indentation = true);
+
+	// feed the elements of the given binary document to the content
+	// handler of the reader, as the reader would when parsing XML
+	static void Parse(CMemoryPool *mp, const CHAR *dxl_binary,
+					  SAX2XMLReader *xml_reader);
+};
+}  // namespace gpdxl
+
+#endif	// !GPDXL_CDXLBinary_H
+
+// EOF
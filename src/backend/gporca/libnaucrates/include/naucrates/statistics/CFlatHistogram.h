@@ -0,0 +1,185 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (c) 2025 Greengage Community
+//
+//	@filename:
+//		CFlatHistogram.h
+//
+//	@doc:
+//		Columnar representation of the buckets of a histogram
+//---------------------------------------------------------------------------
+#ifndef GPNAUCRATES_CFlatHistogram_H
+#define GPNAUCRATES_CFlatHistogram_H
+
+#include "gpos/base.h"
+#include "gpos/common/CRefCount.h"
+
+#include "naucrates/statistics/CBucket.h"
+
+namespace gpnaucrates
+{
+using namespace gpos;
+using namespace gpmd;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CFlatHistogram
+//
+//	@doc:
+//		The buckets of a histogram as parallel arrays of bounds, frequencies
+//		and NDVs, for the kernels of stats derivation that would otherwise
+//		compare CPoint objects through virtual calls on their datums.
+//
+//		Only histograms whose bounds are all of the same type, and mappable
+//		to LINT or to double, can be flattened. A bound mapped to LINT is
+//		kept as a double, so it must be small enough to be represented
+//		exactly; the comparisons then give the same results as the LINT
+//		comparisons of IDatum. Other histograms are flagged as not mappable,
+//		and their callers keep using the buckets.
+//
+//		The kernels reproduce the arithmetic of CBucket exactly, and build
+//		the buckets of their results on the CPoints of the input buckets.
+//
+//---------------------------------------------------------------------------
+class CFlatHistogram : public CRefCount
+{
+private:
+	// memory pool
+	CMemoryPool *m_mp;
+
+	// buckets the arrays were built from
+	CBucketArray *m_buckets;
+
+	// number of buckets
+	ULONG m_num_buckets;
+
+	// can the bounds be compared through the arrays
+	BOOL m_is_mappable;
+
+	// type of the bounds, NULL if there are no buckets
+	IMDId *m_mdid;
+
+	// are the bounds LINT mappings
+	BOOL m_is_lint_mapping;
+
+	// bounds of the buckets
+	DOUBLE *m_lower;
+	DOUBLE *m_upper;
+	BOOL *m_is_lower_closed;
+	BOOL *m_is_upper_closed;
+
+	// frequencies and NDVs of the buckets
+	DOUBLE *m_frequency;
+	DOUBLE *m_distinct;
+
+	// private copy ctor
+	CFlatHistogram(const CFlatHistogram &);
+
+	// mapping of a datum, false if it has none that can be used
+	static BOOL GetMapping(const IDatum *datum, BOOL *is_lint_mapping,
+						   DOUBLE *value);
+
+	// comparisons of mapped values, with the tolerance of IDatum
+	static BOOL Equals(DOUBLE value1, DOUBLE value2);
+
+	static BOOL IsLessThan(DOUBLE value1, DOUBLE value2);
+
+	static BOOL
+	IsLessThanOrEqual(DOUBLE value1, DOUBLE value2)
+	{
+		return IsLessThan(value1, value2) || Equals(value1, value2);
+	}
+
+	// distance between two mapped values, see CPoint::Distance
+	static CDouble Distance(DOUBLE upper, DOUBLE lower);
+
+	// is the n-th bucket a singleton
+	BOOL
+	IsSingleton(ULONG ul) const
+	{
+		return Equals(m_lower[ul], m_upper[ul]);
+	}
+
+	// width of the n-th bucket, see CBucket::Width
+	CDouble Width(ULONG ul) const;
+
+	// does the n-th bucket contain a value
+	BOOL Contains(ULONG ul, DOUBLE value) const;
+
+	// bucket comparisons, see the functions of CBucket of the same names
+	static INT CompareLowerBounds(const CFlatHistogram *flat1, ULONG ul1,
+								  const CFlatHistogram *flat2, ULONG ul2);
+
+	static INT CompareUpperBounds(const CFlatHistogram *flat1, ULONG ul1,
+								  const CFlatHistogram *flat2, ULONG ul2);
+
+	static INT CompareLowerBoundToUpperBound(const CFlatHistogram *flat1,
+											 ULONG ul1,
+											 const CFlatHistogram *flat2,
+											 ULONG ul2);
+
+	static BOOL Subsumes(const CFlatHistogram *flat1, ULONG ul1,
+						 const CFlatHistogram *flat2, ULONG ul2);
+
+	static BOOL Intersects(const CFlatHistogram *flat1, ULONG ul1,
+						   const CFlatHistogram *flat2, ULONG ul2);
+
+	// intersection of two buckets, see CBucket::MakeBucketIntersect
+	static CBucket *MakeBucketIntersect(CMemoryPool *mp,
+										const CFlatHistogram *flat1, ULONG ul1,
+										const CFlatHistogram *flat2, ULONG ul2,
+										CDouble *result_freq_intersect1,
+										CDouble *result_freq_intersect2);
+
+	// ctor
+	CFlatHistogram(CMemoryPool *mp, CBucketArray *buckets);
+
+public:
+	// dtor
+	virtual ~CFlatHistogram();
+
+	// flatten an array of buckets
+	static CFlatHistogram *Make(CMemoryPool *mp, CBucketArray *buckets);
+
+	// buckets the arrays were built from
+	const CBucketArray *
+	GetBuckets() const
+	{
+		return m_buckets;
+	}
+
+	// number of buckets
+	ULONG
+	Size() const
+	{
+		return m_num_buckets;
+	}
+
+	// can the bounds be compared through the arrays
+	BOOL
+	IsMappable() const
+	{
+		return m_is_mappable;
+	}
+
+	// can the bounds be compared with those of another histogram
+	BOOL IsComparable(const CFlatHistogram *flat) const;
+
+	// find the bucket containing a point; returns false if the point cannot
+	// be compared through the arrays, otherwise sets bucket_index to the
+	// bucket or to gpos::ulong_max if there is none
+	BOOL FindBucket(const CPoint *point, ULONG *bucket_index) const;
+
+	// buckets of an equality join, see CHistogram::MakeJoinHistogramEqualityFilter
+	static CBucketArray *MakeJoinBuckets(CMemoryPool *mp,
+										 const CFlatHistogram *flat1,
+										 const CFlatHistogram *flat2,
+										 CDouble *result_freq1,
+										 CDouble *result_freq2);
+
+};	// class CFlatHistogram
+}  // namespace gpnaucrates
+
+#endif	// !GPNAUCRATES_CFlatHistogram_H
+
+// EOF
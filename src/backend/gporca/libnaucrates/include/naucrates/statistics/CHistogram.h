@@ -16,6 +16,7 @@
 
 #include "gpopt/base/CKHeap.h"
 #include "naucrates/statistics/CBucket.h"
+#include "naucrates/statistics/CFlatHistogram.h"
 #include "naucrates/statistics/CStatsPred.h"
 
 namespace gpopt
@@ -97,6 +98,9 @@ private:
 	// is column statistics missing in the database
 	BOOL m_is_col_stats_missing;
 
+	// columnar representation of the buckets, built on first use
+	mutable CFlatHistogram *m_flat_histogram;
+
 	// private copy ctor
 	CHistogram(const CHistogram &);
 
@@ -143,6 +147,9 @@ private:
 	// accessor for n-th bucket
 	CBucket *operator[](ULONG) const;
 
+	// columnar representation of the buckets
+	const CFlatHistogram *GetFlatHistogram() const;
+
 	// Populate sample ratio within each bucket
 	void GetSampleRate(DOUBLE left, DOUBLE right, DOUBLE *sample_rate,
 					   ULONG index);
@@ -366,6 +373,7 @@ public:
 	// destructor
 	virtual ~CHistogram()
 	{
+		CRefCount::SafeRelease(m_flat_histogram);
 		m_histogram_buckets->Release();
 	}
 
@@ -233,6 +233,9 @@ enum EOptTraceFlag
 
 	EopttraceDoNotEnforceCorrelatedExecution = 103046,
 
+	// Expand N-ary joins with the DPhyp join enumerator
+	EopttraceEnableDPhypJoinOrder = 103047,
+
 	///////////////////////////////////////////////////////
 	///////////////////// statistics flags ////////////////
 	//////////////////////////////////////////////////////
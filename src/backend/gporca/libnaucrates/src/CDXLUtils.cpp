@@ -39,6 +39,7 @@
 #include "naucrates/dxl/parser/CParseHandlerFactory.h"
 #include "naucrates/dxl/parser/CParseHandlerManager.h"
 #include "naucrates/dxl/parser/CParseHandlerPlan.h"
+#include "naucrates/dxl/xml/CDXLBinary.h"
 #include "naucrates/dxl/xml/CDXLMemoryManager.h"
 #include "naucrates/dxl/xml/CXMLSerializer.h"
 #include "naucrates/md/CDXLStatsDerivedRelation.h"
@@ -62,6 +63,7 @@ XERCES_CPP_NAMESPACE_USE
 //		Start the parsing of the given DXL string and return the top-level parser.
 //		If a non-empty XSD schema location is provided, the DXL is validated against
 //		that schema, and an exception is thrown if the DXL does not conform.
+//		The string may also be a binary DXL document, which is not validated.
 //
 //---------------------------------------------------------------------------
 CParseHandlerDXL *
@@ -104,28 +106,39 @@ CDXLUtils::GetParseHandlerForDXLString(CMemoryPool *mp, const CHAR *dxl_string,
 
 	parse_handler_mgr->ActivateParseHandler(parse_handler_dxl);
 
-	MemBufInputSource *input_src_memory_buffer = new (memory_manager)
-		MemBufInputSource((const XMLByte *) dxl_string, strlen(dxl_string),
-						  "dxl test", false, memory_manager);
+	MemBufInputSource *input_src_memory_buffer = NULL;
 
-	try
+	if (CDXLBinary::IsBinary(dxl_string))
 	{
-		sax_2_xml_reader->parse(*input_src_memory_buffer);
+		// binary documents are encoded from parsed XML, and feed the parse
+		// handlers without going through the XML parser and the validation
+		CDXLBinary::Parse(mp, dxl_string, sax_2_xml_reader);
 	}
-	catch (const XMLException &)
+	else
 	{
-		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
-		return NULL;
-	}
-	catch (const SAXParseException &)
-	{
-		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
-		return NULL;
-	}
-	catch (const SAXException &)
-	{
-		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
-		return NULL;
+		input_src_memory_buffer = new (memory_manager)
+			MemBufInputSource((const XMLByte *) dxl_string, strlen(dxl_string),
+							  "dxl test", false, memory_manager);
+
+		try
+		{
+			sax_2_xml_reader->parse(*input_src_memory_buffer);
+		}
+		catch (const XMLException &)
+		{
+			GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
+			return NULL;
+		}
+		catch (const SAXParseException &)
+		{
+			GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
+			return NULL;
+		}
+		catch (const SAXException &)
+		{
+			GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
+			return NULL;
+		}
 	}
 
 
@@ -159,6 +172,13 @@ CDXLUtils::GetParseHandlerForDXLFile(CMemoryPool *mp, const CHAR *dxl_filename,
 {
 	GPOS_ASSERT(NULL != mp);
 
+	if (CDXLBinary::IsBinaryFile(dxl_filename))
+	{
+		CAutoRg<CHAR> dxl_binary(Read(mp, dxl_filename));
+		return GetParseHandlerForDXLString(mp, dxl_binary.Rgt(),
+										   xsd_file_path);
+	}
+
 	// setup own memory manager
 	CDXLMemoryManager mm(mp);
 	SAX2XMLReader *sax_2_xml_reader = NULL;
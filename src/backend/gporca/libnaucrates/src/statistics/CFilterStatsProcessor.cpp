@@ -11,9 +11,12 @@
 
 #include "naucrates/statistics/CFilterStatsProcessor.h"
 
+#include "gpopt/base/CUtils.h"
 #include "gpopt/operators/CExpressionHandle.h"
+#include "gpopt/operators/CPhysicalScan.h"
 #include "gpopt/operators/CPredicateUtils.h"
 #include "gpopt/operators/CScalarCmp.h"
+#include "gpopt/optimizer/CCardinalityFeedback.h"
 #include "gpopt/optimizer/COptimizerConfig.h"
 #include "naucrates/statistics/CBucket.h"
 #include "naucrates/statistics/CJoinStatsProcessor.h"
@@ -52,6 +55,52 @@ CFilterStatsProcessor::MakeStatsFilterForScalarExpr(
 		mp, dynamic_cast<CStatistics *>(child_stats), pred_stats, do_cap_NDVs);
 	pred_stats->Release();
 
+	// correct the estimate of a filter on top of a table with the number of
+	// rows the executor saw such a filter return before
+	COptimizerConfig *optimizer_config =
+		COptCtxt::PoctxtFromTLS()->GetOptimizerConfig();
+	CCardinalityFeedback *cardinality_feedback =
+		optimizer_config->GetCardinalityFeedback();
+	if (NULL != cardinality_feedback && do_cap_NDVs && !exprhdl.HasOuterRefs())
+	{
+		// the factors are learned on the filters of table scans, so only a
+		// select directly over a table, or a scan with a filter of its own,
+		// gets one; not a select over a join or a subquery
+		const CTableDescriptor *ptabdesc = NULL;
+		COperator *pop = exprhdl.Pop();
+		if (COperator::EopLogicalSelect == pop->Eopid())
+		{
+			COperator *popChild = exprhdl.Pop(0 /*child_index*/);
+			if (NULL == popChild ||
+				COperator::EopLogicalSelect != popChild->Eopid())
+			{
+				ptabdesc = exprhdl.DeriveTableDescriptor(0 /*child_index*/);
+			}
+		}
+		else if (pop->FLogical())
+		{
+			ptabdesc = exprhdl.DeriveTableDescriptor();
+		}
+		else if (CUtils::FPhysicalScan(pop))
+		{
+			ptabdesc = CPhysicalScan::PopConvert(pop)->Ptabdesc();
+		}
+
+		CDouble factor = cardinality_feedback->ScanFactor(
+			mp, local_scalar_expr, ptabdesc);
+		CDouble rows = result_stats->Rows();
+		if (1.0 != factor && 0.0 < rows)
+		{
+			CDouble corrected_rows = std::max(
+				CStatistics::MinRows.Get(),
+				std::min(child_stats->Rows().Get(), (rows * factor).Get()));
+			IStatistics *stats =
+				result_stats->ScaleStats(mp, corrected_rows / rows);
+			result_stats->Release();
+			result_stats = stats;
+		}
+	}
+
 	if (exprhdl.HasOuterRefs() && 0 < all_outer_stats->Size())
 	{
 		// derive stats based on outer references
@@ -0,0 +1,724 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (c) 2025 Greengage Community
+//
+//	@filename:
+//		CFlatHistogram.cpp
+//
+//	@doc:
+//		Implementation of the columnar representation of histogram buckets
+//---------------------------------------------------------------------------
+
+#include "naucrates/statistics/CFlatHistogram.h"
+
+#include "naucrates/statistics/CStatistics.h"
+
+using namespace gpnaucrates;
+
+// largest LINT mapping that converts to a double exactly
+#define GPNAUCRATES_FLAT_HISTOGRAM_MAX_LINT (LINT(1) << 53)
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::CFlatHistogram
+//
+//	@doc:
+//		Ctor
+//
+//---------------------------------------------------------------------------
+CFlatHistogram::CFlatHistogram(CMemoryPool *mp, CBucketArray *buckets)
+	: m_mp(mp),
+	  m_buckets(buckets),
+	  m_num_buckets(buckets->Size()),
+	  m_is_mappable(false),
+	  m_mdid(NULL),
+	  m_is_lint_mapping(false),
+	  m_lower(NULL),
+	  m_upper(NULL),
+	  m_is_lower_closed(NULL),
+	  m_is_upper_closed(NULL),
+	  m_frequency(NULL),
+	  m_distinct(NULL)
+{
+	GPOS_ASSERT(NULL != buckets);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::~CFlatHistogram
+//
+//	@doc:
+//		Dtor
+//
+//---------------------------------------------------------------------------
+CFlatHistogram::~CFlatHistogram()
+{
+	GPOS_DELETE_ARRAY(m_lower);
+	GPOS_DELETE_ARRAY(m_upper);
+	GPOS_DELETE_ARRAY(m_is_lower_closed);
+	GPOS_DELETE_ARRAY(m_is_upper_closed);
+	GPOS_DELETE_ARRAY(m_frequency);
+	GPOS_DELETE_ARRAY(m_distinct);
+	CRefCount::SafeRelease(m_mdid);
+	m_buckets->Release();
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::Make
+//
+//	@doc:
+//		Flatten an array of buckets. The result holds a reference to the
+//		buckets, and is flagged as not mappable if its bounds cannot be
+//		compared through the arrays
+//
+//---------------------------------------------------------------------------
+CFlatHistogram *
+CFlatHistogram::Make(CMemoryPool *mp, CBucketArray *buckets)
+{
+	buckets->AddRef();
+	CFlatHistogram *flat = GPOS_NEW(mp) CFlatHistogram(mp, buckets);
+
+	const ULONG num_buckets = flat->m_num_buckets;
+	if (0 == num_buckets)
+	{
+		flat->m_is_mappable = true;
+		return flat;
+	}
+
+	IMDId *mdid = (*buckets)[0]->GetLowerBound()->GetDatum()->MDId();
+	BOOL is_lint_mapping = false;
+	DOUBLE value = 0.0;
+	if (!GetMapping((*buckets)[0]->GetLowerBound()->GetDatum(),
+					&is_lint_mapping, &value))
+	{
+		return flat;
+	}
+
+	flat->m_lower = GPOS_NEW_ARRAY(mp, DOUBLE, num_buckets);
+	flat->m_upper = GPOS_NEW_ARRAY(mp, DOUBLE, num_buckets);
+	flat->m_is_lower_closed = GPOS_NEW_ARRAY(mp, BOOL, num_buckets);
+	flat->m_is_upper_closed = GPOS_NEW_ARRAY(mp, BOOL, num_buckets);
+	flat->m_frequency = GPOS_NEW_ARRAY(mp, DOUBLE, num_buckets);
+	flat->m_distinct = GPOS_NEW_ARRAY(mp, DOUBLE, num_buckets);
+
+	for (ULONG ul = 0; ul < num_buckets; ul++)
+	{
+		CBucket *bucket = (*buckets)[ul];
+		const IDatum *bounds[] = {bucket->GetLowerBound()->GetDatum(),
+								  bucket->GetUpperBound()->GetDatum()};
+		DOUBLE *values[] = {&flat->m_lower[ul], &flat->m_upper[ul]};
+
+		for (ULONG ulBound = 0; ulBound < GPOS_ARRAY_SIZE(bounds); ulBound++)
+		{
+			BOOL is_lint = false;
+			if (!bounds[ulBound]->MDId()->Equals(mdid) ||
+				!GetMapping(bounds[ulBound], &is_lint, values[ulBound]) ||
+				is_lint != is_lint_mapping)
+			{
+				return flat;
+			}
+		}
+
+		flat->m_is_lower_closed[ul] = bucket->IsLowerClosed();
+		flat->m_is_upper_closed[ul] = bucket->IsUpperClosed();
+		flat->m_frequency[ul] = bucket->GetFrequency().Get();
+		flat->m_distinct[ul] = bucket->GetNumDistinct().Get();
+	}
+
+	mdid->AddRef();
+	flat->m_mdid = mdid;
+	flat->m_is_lint_mapping = is_lint_mapping;
+	flat->m_is_mappable = true;
+
+	return flat;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::GetMapping
+//
+//	@doc:
+//		Mapping of a datum used for statistics, the LINT one if there is
+//		one, as in IDatum; returns false if it is null, not mappable, or
+//		mapped to a LINT too large to be represented exactly as a double
+//
+//---------------------------------------------------------------------------
+BOOL
+CFlatHistogram::GetMapping(const IDatum *datum, BOOL *is_lint_mapping,
+						   DOUBLE *value)
+{
+	if (datum->IsNull())
+	{
+		return false;
+	}
+
+	if (datum->IsDatumMappableToLINT())
+	{
+		LINT lint_value = datum->GetLINTMapping();
+		if (GPNAUCRATES_FLAT_HISTOGRAM_MAX_LINT < lint_value ||
+			-GPNAUCRATES_FLAT_HISTOGRAM_MAX_LINT > lint_value)
+		{
+			return false;
+		}
+
+		*is_lint_mapping = true;
+		*value = DOUBLE(lint_value);
+		return true;
+	}
+
+	if (datum->IsDatumMappableToDouble())
+	{
+		*is_lint_mapping = false;
+		*value = datum->GetDoubleMapping().Get();
+		return true;
+	}
+
+	return false;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::Equals
+//
+//	@doc:
+//		Equality of two mapped values, see IDatum::StatsAreEqual. LINT
+//		mappings differ by at least 1, so the tolerance does not change
+//		their comparison
+//
+//---------------------------------------------------------------------------
+BOOL
+CFlatHistogram::Equals(DOUBLE value1, DOUBLE value2)
+{
+	CDouble diff = CDouble(value1) - CDouble(value2);
+	return diff.Absolute() <= CStatistics::Epsilon;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::IsLessThan
+//
+//	@doc:
+//		Less than comparison of two mapped values, see
+//		IDatum::StatsAreLessThan
+//
+//---------------------------------------------------------------------------
+BOOL
+CFlatHistogram::IsLessThan(DOUBLE value1, DOUBLE value2)
+{
+	CDouble diff = CDouble(value2) - CDouble(value1);
+	return diff > CStatistics::Epsilon;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::Distance
+//
+//	@doc:
+//		Distance between two mapped values, assuming a closed lower bound
+//		and an open upper bound
+//
+//---------------------------------------------------------------------------
+CDouble
+CFlatHistogram::Distance(DOUBLE upper, DOUBLE lower)
+{
+	CDouble width = CDouble(upper) - CDouble(lower);
+	GPOS_ASSERT(width >= CDouble(0.0));
+
+	return width;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::Width
+//
+//	@doc:
+//		Width of the n-th bucket
+//
+//---------------------------------------------------------------------------
+CDouble
+CFlatHistogram::Width(ULONG ul) const
+{
+	if (IsSingleton(ul))
+	{
+		return CDouble(1.0);
+	}
+
+	return Distance(m_upper[ul], m_lower[ul]);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::Contains
+//
+//	@doc:
+//		Does the n-th bucket contain a value
+//
+//---------------------------------------------------------------------------
+BOOL
+CFlatHistogram::Contains(ULONG ul, DOUBLE value) const
+{
+	if (IsSingleton(ul))
+	{
+		return Equals(m_lower[ul], value);
+	}
+
+	if ((m_is_lower_closed[ul] && Equals(m_lower[ul], value)) ||
+		(m_is_upper_closed[ul] && Equals(m_upper[ul], value)))
+	{
+		return true;
+	}
+
+	return IsLessThan(m_lower[ul], value) && IsLessThan(value, m_upper[ul]);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::CompareLowerBounds
+//
+//	@doc:
+//		Compare the lower bounds of two buckets
+//
+//---------------------------------------------------------------------------
+INT
+CFlatHistogram::CompareLowerBounds(const CFlatHistogram *flat1, ULONG ul1,
+								   const CFlatHistogram *flat2, ULONG ul2)
+{
+	DOUBLE value1 = flat1->m_lower[ul1];
+	DOUBLE value2 = flat2->m_lower[ul2];
+
+	if (Equals(value1, value2))
+	{
+		BOOL is_closed1 = flat1->m_is_lower_closed[ul1];
+		if (is_closed1 == flat2->m_is_lower_closed[ul2])
+		{
+			return 0;
+		}
+
+		return is_closed1 ? -1 : 1;
+	}
+
+	return IsLessThan(value1, value2) ? -1 : 1;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::CompareUpperBounds
+//
+//	@doc:
+//		Compare the upper bounds of two buckets
+//
+//---------------------------------------------------------------------------
+INT
+CFlatHistogram::CompareUpperBounds(const CFlatHistogram *flat1, ULONG ul1,
+								   const CFlatHistogram *flat2, ULONG ul2)
+{
+	DOUBLE value1 = flat1->m_upper[ul1];
+	DOUBLE value2 = flat2->m_upper[ul2];
+
+	if (Equals(value1, value2))
+	{
+		BOOL is_closed1 = flat1->m_is_upper_closed[ul1];
+		if (is_closed1 == flat2->m_is_upper_closed[ul2])
+		{
+			return 0;
+		}
+
+		return is_closed1 ? 1 : -1;
+	}
+
+	return IsLessThan(value1, value2) ? -1 : 1;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::CompareLowerBoundToUpperBound
+//
+//	@doc:
+//		Compare the lower bound of the first bucket to the upper bound of
+//		the second one
+//
+//---------------------------------------------------------------------------
+INT
+CFlatHistogram::CompareLowerBoundToUpperBound(const CFlatHistogram *flat1,
+											  ULONG ul1,
+											  const CFlatHistogram *flat2,
+											  ULONG ul2)
+{
+	DOUBLE lower = flat1->m_lower[ul1];
+	DOUBLE upper = flat2->m_upper[ul2];
+
+	if (IsLessThan(upper, lower))
+	{
+		return 1;
+	}
+
+	if (IsLessThan(lower, upper))
+	{
+		return -1;
+	}
+
+	if (flat1->m_is_lower_closed[ul1] && flat2->m_is_upper_closed[ul2])
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::Subsumes
+//
+//	@doc:
+//		Does the first bucket subsume the second one
+//
+//---------------------------------------------------------------------------
+BOOL
+CFlatHistogram::Subsumes(const CFlatHistogram *flat1, ULONG ul1,
+						 const CFlatHistogram *flat2, ULONG ul2)
+{
+	if (flat2->IsSingleton(ul2))
+	{
+		if (flat1->IsSingleton(ul1))
+		{
+			return Equals(flat1->m_lower[ul1], flat2->m_lower[ul2]);
+		}
+
+		return flat1->Contains(ul1, flat2->m_lower[ul2]);
+	}
+
+	return 0 >= CompareLowerBounds(flat1, ul1, flat2, ul2) &&
+		   0 <= CompareUpperBounds(flat1, ul1, flat2, ul2);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::Intersects
+//
+//	@doc:
+//		Do the ranges of two buckets intersect
+//
+//---------------------------------------------------------------------------
+BOOL
+CFlatHistogram::Intersects(const CFlatHistogram *flat1, ULONG ul1,
+						   const CFlatHistogram *flat2, ULONG ul2)
+{
+	BOOL is_singleton1 = flat1->IsSingleton(ul1);
+	BOOL is_singleton2 = flat2->IsSingleton(ul2);
+
+	if (is_singleton1 && is_singleton2)
+	{
+		return Equals(flat1->m_lower[ul1], flat2->m_lower[ul2]);
+	}
+
+	if (is_singleton1)
+	{
+		return flat2->Contains(ul2, flat1->m_lower[ul1]);
+	}
+
+	if (is_singleton2)
+	{
+		return flat1->Contains(ul1, flat2->m_lower[ul2]);
+	}
+
+	if (Subsumes(flat1, ul1, flat2, ul2) || Subsumes(flat2, ul2, flat1, ul1))
+	{
+		return true;
+	}
+
+	if (0 >= CompareLowerBounds(flat1, ul1, flat2, ul2))
+	{
+		// first bucket starts before the second one; do they overlap
+		return 0 >= CompareLowerBoundToUpperBound(flat2, ul2, flat1, ul1);
+	}
+
+	return 0 >= CompareLowerBoundToUpperBound(flat1, ul1, flat2, ul2);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::MakeBucketIntersect
+//
+//	@doc:
+//		Bucket of the intersection of two buckets, and the frequency of
+//		each input bucket that falls in it
+//
+//---------------------------------------------------------------------------
+CBucket *
+CFlatHistogram::MakeBucketIntersect(CMemoryPool *mp,
+									const CFlatHistogram *flat1, ULONG ul1,
+									const CFlatHistogram *flat2, ULONG ul2,
+									CDouble *result_freq_intersect1,
+									CDouble *result_freq_intersect2)
+{
+	GPOS_ASSERT(Intersects(flat1, ul1, flat2, ul2));
+
+	CBucket *bucket1 = (*flat1->m_buckets)[ul1];
+	CBucket *bucket2 = (*flat2->m_buckets)[ul2];
+
+	// greatest lower bound and least upper bound, as CPoint::MaxPoint and
+	// CPoint::MinPoint pick them
+	BOOL lower_is_first =
+		!IsLessThan(flat1->m_lower[ul1], flat2->m_lower[ul2]);
+	BOOL upper_is_first =
+		IsLessThanOrEqual(flat1->m_upper[ul1], flat2->m_upper[ul2]);
+	DOUBLE lower_new =
+		lower_is_first ? flat1->m_lower[ul1] : flat2->m_lower[ul2];
+	DOUBLE upper_new =
+		upper_is_first ? flat1->m_upper[ul1] : flat2->m_upper[ul2];
+
+	BOOL lower_new_is_closed = true;
+	BOOL upper_new_is_closed = true;
+
+	CDouble ratio1(0.0);
+	CDouble ratio2(0.0);
+	if (flat1->IsSingleton(ul1) && flat2->IsSingleton(ul2))
+	{
+		ratio1 = CDouble(1.0);
+		ratio2 = CDouble(1.0);
+	}
+	else
+	{
+		CDouble distance_new = 1.0;
+		if (!Equals(lower_new, upper_new))
+		{
+			lower_new_is_closed = flat1->m_is_lower_closed[ul1];
+			upper_new_is_closed = flat1->m_is_upper_closed[ul1];
+
+			if (Equals(lower_new, flat2->m_lower[ul2]))
+			{
+				lower_new_is_closed = flat2->m_is_lower_closed[ul2];
+				if (Equals(lower_new, flat1->m_lower[ul1]))
+				{
+					lower_new_is_closed = flat1->m_is_lower_closed[ul1] &&
+										  flat2->m_is_lower_closed[ul2];
+				}
+			}
+
+			if (Equals(upper_new, flat2->m_upper[ul2]))
+			{
+				upper_new_is_closed = flat2->m_is_upper_closed[ul2];
+				if (Equals(upper_new, flat1->m_upper[ul1]))
+				{
+					upper_new_is_closed = flat1->m_is_upper_closed[ul1] &&
+										  flat2->m_is_upper_closed[ul2];
+				}
+			}
+
+			distance_new = Distance(upper_new, lower_new);
+		}
+
+		GPOS_ASSERT(distance_new <= flat1->Width(ul1));
+		GPOS_ASSERT(distance_new <= flat2->Width(ul2));
+
+		ratio1 = distance_new / flat1->Width(ul1);
+		ratio2 = distance_new / flat2->Width(ul2);
+	}
+
+	CDouble distinct1(flat1->m_distinct[ul1]);
+	CDouble distinct2(flat2->m_distinct[ul2]);
+	CDouble distinct_new(std::min(ratio1.Get() * distinct1.Get(),
+								  ratio2.Get() * distinct2.Get()));
+
+	CDouble freq_intersect1 = ratio1 * CDouble(flat1->m_frequency[ul1]);
+	CDouble freq_intersect2 = ratio2 * CDouble(flat2->m_frequency[ul2]);
+
+	CDouble frequency_new(freq_intersect1 * freq_intersect2 * DOUBLE(1.0) /
+						  std::max(ratio1.Get() * distinct1.Get(),
+								   ratio2.Get() * distinct2.Get()));
+
+	CPoint *point_lower = lower_is_first ? bucket1->GetLowerBound()
+										 : bucket2->GetLowerBound();
+	CPoint *point_upper = upper_is_first ? bucket1->GetUpperBound()
+										 : bucket2->GetUpperBound();
+	point_lower->AddRef();
+	point_upper->AddRef();
+
+	*result_freq_intersect1 = freq_intersect1;
+	*result_freq_intersect2 = freq_intersect2;
+
+	return GPOS_NEW(mp)
+		CBucket(point_lower, point_upper, lower_new_is_closed,
+				upper_new_is_closed, frequency_new, distinct_new);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::IsComparable
+//
+//	@doc:
+//		Can the bounds be compared with those of another histogram
+//
+//---------------------------------------------------------------------------
+BOOL
+CFlatHistogram::IsComparable(const CFlatHistogram *flat) const
+{
+	GPOS_ASSERT(NULL != flat);
+
+	if (!m_is_mappable || !flat->m_is_mappable)
+	{
+		return false;
+	}
+
+	if (0 == m_num_buckets || 0 == flat->m_num_buckets)
+	{
+		return true;
+	}
+
+	return m_is_lint_mapping == flat->m_is_lint_mapping &&
+		   m_mdid->Equals(flat->m_mdid);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::FindBucket
+//
+//	@doc:
+//		Binary search of the bucket containing a point. The buckets are
+//		sorted and do not overlap, so the first bucket that does not end
+//		before the point is the only one that may contain it
+//
+//---------------------------------------------------------------------------
+BOOL
+CFlatHistogram::FindBucket(const CPoint *point, ULONG *bucket_index) const
+{
+	GPOS_ASSERT(NULL != point);
+	GPOS_ASSERT(NULL != bucket_index);
+
+	if (!m_is_mappable)
+	{
+		return false;
+	}
+
+	*bucket_index = gpos::ulong_max;
+	if (0 == m_num_buckets)
+	{
+		return true;
+	}
+
+	const IDatum *datum = point->GetDatum();
+	BOOL is_lint_mapping = false;
+	DOUBLE value = 0.0;
+	if (!datum->MDId()->Equals(m_mdid) ||
+		!GetMapping(datum, &is_lint_mapping, &value) ||
+		is_lint_mapping != m_is_lint_mapping)
+	{
+		return false;
+	}
+
+	ULONG low = 0;
+	ULONG high = m_num_buckets;
+	while (low < high)
+	{
+		ULONG mid = low + (high - low) / 2;
+		BOOL ends_before = IsLessThan(m_upper[mid], value) ||
+						   (!m_is_upper_closed[mid] && !IsSingleton(mid) &&
+							Equals(m_upper[mid], value));
+		if (ends_before)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	if (low < m_num_buckets && Contains(low, value))
+	{
+		*bucket_index = low;
+	}
+
+	return true;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CFlatHistogram::MakeJoinBuckets
+//
+//	@doc:
+//		Merge the buckets of two histograms for an equality join, returning
+//		the intersections of their buckets, and the frequency of each input
+//		that contributed to them
+//
+//---------------------------------------------------------------------------
+CBucketArray *
+CFlatHistogram::MakeJoinBuckets(CMemoryPool *mp, const CFlatHistogram *flat1,
+								const CFlatHistogram *flat2,
+								CDouble *result_freq1, CDouble *result_freq2)
+{
+	GPOS_ASSERT(flat1->IsComparable(flat2));
+
+	CBucketArray *join_buckets = GPOS_NEW(mp) CBucketArray(mp);
+	CDouble freq1(0.0);
+	CDouble freq2(0.0);
+
+	ULONG ul1 = 0;
+	ULONG ul2 = 0;
+	while (ul1 < flat1->m_num_buckets && ul2 < flat2->m_num_buckets)
+	{
+		if (Intersects(flat1, ul1, flat2, ul2))
+		{
+			CDouble freq_intersect1(0.0);
+			CDouble freq_intersect2(0.0);
+
+			join_buckets->Append(MakeBucketIntersect(
+				mp, flat1, ul1, flat2, ul2, &freq_intersect1,
+				&freq_intersect2));
+
+			freq1 = freq1 + freq_intersect1;
+			freq2 = freq2 + freq_intersect2;
+
+			INT res = CompareUpperBounds(flat1, ul1, flat2, ul2);
+			if (0 == res)
+			{
+				ul1++;
+				ul2++;
+			}
+			else if (1 > res)
+			{
+				ul1++;
+			}
+			else
+			{
+				ul2++;
+			}
+		}
+		else if (IsLessThanOrEqual(flat1->m_upper[ul1], flat2->m_lower[ul2]))
+		{
+			// first bucket is before the second one
+			ul1++;
+		}
+		else
+		{
+			ul2++;
+		}
+	}
+
+	*result_freq1 = freq1;
+	*result_freq2 = freq2;
+
+	return join_buckets;
+}
+
+
+// EOF
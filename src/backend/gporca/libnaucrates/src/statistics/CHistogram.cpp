@@ -61,7 +61,8 @@ CHistogram::CHistogram(CMemoryPool *mp, CBucketArray *histogram_buckets,
 	  m_skew_was_measured(false),
 	  m_skew(1.0),
 	  m_NDVs_were_scaled(false),
-	  m_is_col_stats_missing(false)
+	  m_is_col_stats_missing(false),
+	  m_flat_histogram(NULL)
 {
 	GPOS_ASSERT(NULL != histogram_buckets);
 }
@@ -77,7 +78,8 @@ CHistogram::CHistogram(CMemoryPool *mp, BOOL is_well_defined)
 	  m_skew_was_measured(false),
 	  m_skew(1.0),
 	  m_NDVs_were_scaled(false),
-	  m_is_col_stats_missing(false)
+	  m_is_col_stats_missing(false),
+	  m_flat_histogram(NULL)
 {
 	m_histogram_buckets = GPOS_NEW(m_mp) CBucketArray(m_mp);
 }
@@ -96,7 +98,8 @@ CHistogram::CHistogram(CMemoryPool *mp, CBucketArray *histogram_buckets,
 	  m_skew_was_measured(false),
 	  m_skew(1.0),
 	  m_NDVs_were_scaled(false),
-	  m_is_col_stats_missing(is_col_stats_missing)
+	  m_is_col_stats_missing(is_col_stats_missing),
+	  m_flat_histogram(NULL)
 {
 	GPOS_ASSERT(m_histogram_buckets);
 	GPOS_ASSERT(CDouble(0.0) <= null_freq);
@@ -300,7 +303,18 @@ CHistogram::MakeBucketsWithEqualityFilter(CPoint *point) const
 	const ULONG num_buckets = m_histogram_buckets->Size();
 	ULONG bucket_index = 0;
 
-	for (bucket_index = 0; bucket_index < num_buckets; bucket_index++)
+	// binary search of the columnar buckets, when the point maps onto them
+	ULONG found_index = gpos::ulong_max;
+	if (GetFlatHistogram()->FindBucket(point, &found_index))
+	{
+		if (gpos::ulong_max == found_index)
+		{
+			return histogram_buckets;
+		}
+		bucket_index = found_index;
+	}
+
+	for (; bucket_index < num_buckets; bucket_index++)
 	{
 		CBucket *bucket = (*m_histogram_buckets)[bucket_index];
 
@@ -1021,6 +1035,14 @@ CHistogram::CopyHistogram() const
 		histogram_copy->SetNDVScaled();
 	}
 
+	// the copy shares the buckets, and so their columnar representation
+	if (NULL != m_flat_histogram &&
+		m_flat_histogram->GetBuckets() == m_histogram_buckets)
+	{
+		m_flat_histogram->AddRef();
+		histogram_copy->m_flat_histogram = m_flat_histogram;
+	}
+
 	return histogram_copy;
 }
 
@@ -1105,6 +1127,23 @@ CHistogram::MakeJoinHistogramEqualityFilter(const CHistogram *histogram) const
 		return MakeNDVBasedJoinHistogramEqualityFilter(histogram);
 	}
 
+	// merge the columnar buckets, when both sides map onto comparable ones
+	const CFlatHistogram *flat1 = GetFlatHistogram();
+	const CFlatHistogram *flat2 = histogram->GetFlatHistogram();
+	if (flat1->IsComparable(flat2))
+	{
+		CBucketArray *join_buckets = CFlatHistogram::MakeJoinBuckets(
+			m_mp, flat1, flat2, &hist1_buckets_freq, &hist2_buckets_freq);
+
+		ComputeJoinNDVRemainInfo(this, histogram, join_buckets,
+								 hist1_buckets_freq, hist2_buckets_freq,
+								 &distinct_remaining, &freq_remaining);
+
+		return GPOS_NEW(m_mp)
+			CHistogram(m_mp, join_buckets, true /*is_well_defined*/,
+					   0.0 /*null_freq*/, distinct_remaining, freq_remaining);
+	}
+
 	CBucketArray *join_buckets = GPOS_NEW(m_mp) CBucketArray(m_mp);
 	while (idx1 < buckets1 && idx2 < buckets2)
 	{
@@ -2010,6 +2049,21 @@ CHistogram::operator[](ULONG pos) const
 	return NULL;
 }
 
+// columnar representation of the buckets. It is built the first time it is
+// needed, and again if the buckets have been replaced since
+const CFlatHistogram *
+CHistogram::GetFlatHistogram() const
+{
+	if (NULL == m_flat_histogram ||
+		m_flat_histogram->GetBuckets() != m_histogram_buckets)
+	{
+		CRefCount::SafeRelease(m_flat_histogram);
+		m_flat_histogram = CFlatHistogram::Make(m_mp, m_histogram_buckets);
+	}
+
+	return m_flat_histogram;
+}
+
 // translate the histogram into a the dxl derived column statistics
 CDXLStatsDerivedColumn *
 CHistogram::TranslateToDXLDerivedColumnStats(CMDAccessor *md_accessor,
@@ -15,6 +15,7 @@
 #include "gpopt/operators/CLogicalNAryJoin.h"
 #include "gpopt/operators/CPredicateUtils.h"
 #include "gpopt/operators/CScalarNAryJoinPredList.h"
+#include "gpopt/optimizer/CCardinalityFeedback.h"
 #include "gpopt/optimizer/COptimizerConfig.h"
 #include "naucrates/statistics/CFilterStatsProcessor.h"
 #include "naucrates/statistics/CLeftAntiSemiJoinStatsProcessor.h"
@@ -131,6 +132,12 @@ CJoinStatsProcessor::CalcAllJoinStats(CMemoryPool *mp,
 	// create an empty set of outer references for statistics derivation
 	CColRefSet *outer_refs = GPOS_NEW(mp) CColRefSet(mp);
 
+	// corrections of join estimates observed by the executor, if any
+	COptimizerConfig *optimizer_config =
+		COptCtxt::PoctxtFromTLS()->GetOptimizerConfig();
+	CCardinalityFeedback *cardinality_feedback =
+		optimizer_config->GetCardinalityFeedback();
+
 	// join statistics objects one by one using relevant predicates in given scalar expression
 	const ULONG num_stats = statistics_array->Size();
 	IStatistics *stats = (*statistics_array)[0]->CopyStats(mp);
@@ -207,6 +214,27 @@ CJoinStatsProcessor::CalcAllJoinStats(CMemoryPool *mp,
 		{
 			new_stats =
 				stats->CalcInnerJoinStats(mp, current_stats, join_preds_stats);
+
+			// correct the estimate of an equi-join with the number of rows
+			// the executor saw a join on the same columns return before
+			CDouble factor(1.0);
+			if (NULL != cardinality_feedback && NULL == unsupported_pred_stats)
+			{
+				factor = cardinality_feedback->JoinFactor(join_preds_stats);
+			}
+
+			CDouble rows = new_stats->Rows();
+			if (1.0 != factor && 0.0 < rows)
+			{
+				CDouble corrected_rows = std::max(
+					CStatistics::MinRows.Get(),
+					std::min((stats->Rows() * current_stats->Rows()).Get(),
+							 (rows * factor).Get()));
+				IStatistics *scaled_stats =
+					new_stats->ScaleStats(mp, corrected_rows / rows);
+				new_stats->Release();
+				new_stats = scaled_stats;
+			}
 		}
 		stats->Release();
 		stats = new_stats;
@@ -0,0 +1,1127 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (C) 2025 Greengage Community
+//
+//	@filename:
+//		CDXLBinary.cpp
+//
+//	@doc:
+//		Implementation of the binary encoding of DXL documents
+//
+//		Following the magic string, a document is a sequence of records:
+//
+//			open:	GPDXL_BINARY_OPEN, name, attribute count + 1, and the
+//					name and value of each attribute
+//			close:	GPDXL_BINARY_CLOSE
+//
+//		and ends with a zero byte. Numbers are LEB128 encoded, and are
+//		never zero, so that no byte of a number is zero. A string is the
+//		number 1, followed by its length + 1 and its UTF-8 bytes, the
+//		first time it occurs, and its index in the order of first
+//		occurrence + 2 afterwards.
+//---------------------------------------------------------------------------
+
+#include "naucrates/dxl/xml/CDXLBinary.h"
+
+#include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+
+#include "gpos/common/CAutoRg.h"
+#include "gpos/common/CHashMap.h"
+#include "gpos/common/clibwrapper.h"
+#include "gpos/io/CFileReader.h"
+#include "gpos/io/COstreamString.h"
+#include "gpos/task/CAutoTraceFlag.h"
+
+#include "naucrates/dxl/xml/CDXLMemoryManager.h"
+#include "naucrates/dxl/xml/CXMLSerializer.h"
+#include "naucrates/dxl/xml/dxltokens.h"
+#include "naucrates/exception.h"
+
+using namespace gpdxl;
+
+#define GPDXL_BINARY_MAGIC_LENGTH (GPOS_ARRAY_SIZE(GPDXL_BINARY_MAGIC) - 1)
+
+// record types
+#define GPDXL_BINARY_OPEN 0x01
+#define GPDXL_BINARY_CLOSE 0x02
+
+// string number of a string that follows in the document
+#define GPDXL_BINARY_NEW_STRING 1
+
+// number of hash chains for the strings of a document being encoded
+#define GPDXL_BINARY_STRING_CHAINS 8191
+
+namespace
+{
+// type of all attributes, as reported by the XML parser without a DTD
+const XMLCh szCDATA[] = {'C', 'D', 'A', 'T', 'A', 0};
+
+// empty string, for the namespace URI of names without a prefix
+const XMLCh szEmpty[] = {0};
+
+// grow an array to hold at least the given number of elements
+template <class T>
+void
+GrowArray(CMemoryPool *mp, T *&array, ULONG length, ULONG &capacity,
+		  ULONG required)
+{
+	if (required <= capacity)
+	{
+		return;
+	}
+
+	ULONG new_capacity = std::max(required, 2 * capacity);
+	T *new_array = GPOS_NEW_ARRAY(mp, T, new_capacity);
+	if (0 < length)
+	{
+		clib::Memcpy(new_array, array, length * GPOS_SIZEOF(T));
+	}
+	GPOS_DELETE_ARRAY(array);
+
+	array = new_array;
+	capacity = new_capacity;
+}
+
+// does a UTF-16 string continue with a surrogate pair
+BOOL
+IsSurrogatePair(const XMLCh *xml_char)
+{
+	return 0xD800 <= xml_char[0] && xml_char[0] < 0xDC00 &&
+		   0xDC00 <= xml_char[1] && xml_char[1] < 0xE000;
+}
+
+// code point of a surrogate pair
+ULONG
+SurrogatePairCodePoint(const XMLCh *xml_char)
+{
+	return 0x10000 + ((ULONG)(xml_char[0] - 0xD800) << 10) +
+		   (ULONG)(xml_char[1] - 0xDC00);
+}
+
+// compare two strings
+BOOL
+XmlstrEquals(const XMLCh *xml_str1, const XMLCh *xml_str2)
+{
+	while (*xml_str1 == *xml_str2 && 0 != *xml_str1)
+	{
+		xml_str1++;
+		xml_str2++;
+	}
+
+	return *xml_str1 == *xml_str2;
+}
+
+// local part of a qualified name
+const XMLCh *
+XmlstrLocalName(const XMLCh *qname)
+{
+	for (const XMLCh *xml_char = qname; 0 != *xml_char; xml_char++)
+	{
+		if (':' == *xml_char)
+		{
+			return xml_char + 1;
+		}
+	}
+
+	return qname;
+}
+
+// namespace URI of a qualified name; DXL only uses the DXL namespace
+const XMLCh *
+XmlstrURI(const XMLCh *qname)
+{
+	if (XmlstrLocalName(qname) == qname)
+	{
+		return szEmpty;
+	}
+
+	return CDXLTokens::XmlstrToken(EdxltokenNamespaceURI);
+}
+
+//---------------------------------------------------------------------------
+//	@struct:
+//		SUtf8String
+//
+//	@doc:
+//		UTF-8 bytes of a string, as key of the strings of a document
+//
+//---------------------------------------------------------------------------
+struct SUtf8String
+{
+	// bytes of the string
+	BYTE *m_bytes;
+
+	// number of bytes
+	ULONG m_length;
+
+	// are the bytes owned by the key
+	BOOL m_owned;
+
+	// ctor
+	SUtf8String(BYTE *bytes, ULONG length, BOOL owned)
+		: m_bytes(bytes), m_length(length), m_owned(owned)
+	{
+	}
+
+	// dtor
+	~SUtf8String()
+	{
+		if (m_owned)
+		{
+			GPOS_DELETE_ARRAY(m_bytes);
+		}
+	}
+
+	// hash function
+	static ULONG
+	HashValue(const SUtf8String *str)
+	{
+		return gpos::HashByteArray(str->m_bytes, str->m_length);
+	}
+
+	// equality function
+	static BOOL
+	Equals(const SUtf8String *str1, const SUtf8String *str2)
+	{
+		return str1->m_length == str2->m_length &&
+			   0 == clib::Memcmp(str1->m_bytes, str2->m_bytes, str1->m_length);
+	}
+};
+
+// map from the strings of a document to their number
+typedef CHashMap<SUtf8String, ULONG, SUtf8String::HashValue,
+				 SUtf8String::Equals, CleanupDelete<SUtf8String>,
+				 CleanupDelete<ULONG> >
+	Utf8StringToNumberMap;
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CDXLBinaryEncoder
+//
+//	@doc:
+//		Content handler that encodes the elements reported by the XML parser
+//
+//---------------------------------------------------------------------------
+class CDXLBinaryEncoder : public DefaultHandler
+{
+private:
+	// memory pool
+	CMemoryPool *m_mp;
+
+	// the encoded document
+	BYTE *m_buffer;
+	ULONG m_length;
+	ULONG m_capacity;
+
+	// UTF-8 bytes of the current string
+	BYTE *m_utf8;
+	ULONG m_utf8_capacity;
+
+	// strings seen so far
+	Utf8StringToNumberMap *m_strings;
+	ULONG m_num_strings;
+
+	// private copy ctor
+	CDXLBinaryEncoder(const CDXLBinaryEncoder &);
+
+	// append a byte
+	void
+	AppendByte(BYTE byte)
+	{
+		GrowArray(m_mp, m_buffer, m_length, m_capacity, m_length + 1);
+		m_buffer[m_length++] = byte;
+	}
+
+	// append a number, which must not be zero
+	void
+	AppendNumber(ULONG value)
+	{
+		GPOS_ASSERT(0 != value);
+
+		while (0x80 <= value)
+		{
+			AppendByte((BYTE)(0x80 | (value & 0x7f)));
+			value >>= 7;
+		}
+		AppendByte((BYTE) value);
+	}
+
+	// convert a string to UTF-8, return the number of bytes
+	ULONG ConvertToUtf8(const XMLCh *xml_str);
+
+	// append a string, or its number if it was seen before
+	void AppendString(const XMLCh *xml_str);
+
+public:
+	// ctor
+	explicit CDXLBinaryEncoder(CMemoryPool *mp)
+		: m_mp(mp),
+		  m_buffer(NULL),
+		  m_length(0),
+		  m_capacity(0),
+		  m_utf8(NULL),
+		  m_utf8_capacity(0),
+		  m_strings(NULL),
+		  m_num_strings(0)
+	{
+		m_strings = GPOS_NEW(mp)
+			Utf8StringToNumberMap(mp, GPDXL_BINARY_STRING_CHAINS);
+
+		for (ULONG ul = 0; ul < GPDXL_BINARY_MAGIC_LENGTH; ul++)
+		{
+			AppendByte((BYTE) GPDXL_BINARY_MAGIC[ul]);
+		}
+	}
+
+	// dtor
+	virtual ~CDXLBinaryEncoder()
+	{
+		m_strings->Release();
+		GPOS_DELETE_ARRAY(m_utf8);
+		GPOS_DELETE_ARRAY(m_buffer);
+	}
+
+	// the encoded document, owned by the caller
+	CHAR *
+	Result()
+	{
+		AppendByte(0);
+
+		CHAR *result = (CHAR *) m_buffer;
+		m_buffer = NULL;
+		m_length = 0;
+		m_capacity = 0;
+
+		return result;
+	}
+
+	// process the opening tag of an element
+	virtual void
+	startElement(const XMLCh *const,  // element_uri
+				 const XMLCh *const,  // element_local_name
+				 const XMLCh *const element_qname, const Attributes &attrs)
+	{
+		AppendByte(GPDXL_BINARY_OPEN);
+		AppendString(element_qname);
+
+		const ULONG num_attrs = (ULONG) attrs.getLength();
+		AppendNumber(num_attrs + 1);
+		for (ULONG ul = 0; ul < num_attrs; ul++)
+		{
+			AppendString(attrs.getQName(ul));
+			AppendString(attrs.getValue(ul));
+		}
+	}
+
+	// process the closing tag of an element
+	virtual void
+	endElement(const XMLCh *const,	// element_uri
+			   const XMLCh *const,	// element_local_name
+			   const XMLCh *const	// element_qname
+	)
+	{
+		AppendByte(GPDXL_BINARY_CLOSE);
+	}
+
+	// errors in the document stop the encoding
+	virtual void
+	error(const SAXParseException &exc)
+	{
+		throw exc;
+	}
+
+	virtual void
+	fatalError(const SAXParseException &exc)
+	{
+		throw exc;
+	}
+};
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryEncoder::ConvertToUtf8
+//
+//	@doc:
+//		Convert a UTF-16 string to UTF-8 into m_utf8
+//
+//---------------------------------------------------------------------------
+ULONG
+CDXLBinaryEncoder::ConvertToUtf8(const XMLCh *xml_str)
+{
+	ULONG length = 0;
+	for (const XMLCh *xml_char = xml_str; 0 != *xml_char; xml_char++)
+	{
+		ULONG code_point = *xml_char;
+		if (IsSurrogatePair(xml_char))
+		{
+			code_point = SurrogatePairCodePoint(xml_char);
+			xml_char++;
+		}
+
+		GrowArray(m_mp, m_utf8, length, m_utf8_capacity, length + 4);
+
+		if (code_point < 0x80)
+		{
+			m_utf8[length++] = (BYTE) code_point;
+		}
+		else if (code_point < 0x800)
+		{
+			m_utf8[length++] = (BYTE)(0xC0 | (code_point >> 6));
+			m_utf8[length++] = (BYTE)(0x80 | (code_point & 0x3F));
+		}
+		else if (code_point < 0x10000)
+		{
+			m_utf8[length++] = (BYTE)(0xE0 | (code_point >> 12));
+			m_utf8[length++] = (BYTE)(0x80 | ((code_point >> 6) & 0x3F));
+			m_utf8[length++] = (BYTE)(0x80 | (code_point & 0x3F));
+		}
+		else
+		{
+			m_utf8[length++] = (BYTE)(0xF0 | (code_point >> 18));
+			m_utf8[length++] = (BYTE)(0x80 | ((code_point >> 12) & 0x3F));
+			m_utf8[length++] = (BYTE)(0x80 | ((code_point >> 6) & 0x3F));
+			m_utf8[length++] = (BYTE)(0x80 | (code_point & 0x3F));
+		}
+	}
+
+	return length;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryEncoder::AppendString
+//
+//	@doc:
+//		Append a string the first time it is seen, and its number afterwards
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinaryEncoder::AppendString(const XMLCh *xml_str)
+{
+	const ULONG length = ConvertToUtf8(xml_str);
+
+	SUtf8String key(m_utf8, length, false /*owned*/);
+	const ULONG *number = m_strings->Find(&key);
+	if (NULL != number)
+	{
+		AppendNumber(*number + 2);
+		return;
+	}
+
+	AppendNumber(GPDXL_BINARY_NEW_STRING);
+	AppendNumber(length + 1);
+	GrowArray(m_mp, m_buffer, m_length, m_capacity, m_length + length);
+	if (0 < length)
+	{
+		clib::Memcpy(m_buffer + m_length, m_utf8, length);
+	}
+	m_length += length;
+
+	BYTE *bytes = GPOS_NEW_ARRAY(m_mp, BYTE, std::max(length, (ULONG) 1));
+	if (0 < length)
+	{
+		clib::Memcpy(bytes, m_utf8, length);
+	}
+	BOOL result GPOS_ASSERTS_ONLY = m_strings->Insert(
+		GPOS_NEW(m_mp) SUtf8String(bytes, length, true /*owned*/),
+		GPOS_NEW(m_mp) ULONG(m_num_strings));
+	GPOS_ASSERT(result);
+
+	m_num_strings++;
+}
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CDXLBinaryReader
+//
+//	@doc:
+//		Reader of the records of a binary document
+//
+//---------------------------------------------------------------------------
+class CDXLBinaryReader
+{
+private:
+	// memory pool
+	CMemoryPool *m_mp;
+
+	// next byte to read
+	const BYTE *m_cursor;
+
+	// strings read so far, in the order of first occurrence
+	CDynamicPtrArray<XMLCh, CleanupDeleteArray> *m_strings;
+
+	// numbers of the names of the open elements
+	ULONG *m_open_elements;
+	ULONG m_num_open_elements;
+	ULONG m_open_elements_capacity;
+
+	// numbers of the names and values of the attributes of the current
+	// element
+	ULONG *m_attrs;
+	ULONG m_num_attrs;
+	ULONG m_attrs_capacity;
+
+	// number of the name of the current element
+	ULONG m_name;
+
+	// private copy ctor
+	CDXLBinaryReader(const CDXLBinaryReader &);
+
+	// raise an error for a malformed document
+	static void
+	RaiseMalformed()
+	{
+		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
+	}
+
+	// read a number
+	ULONG ReadNumber();
+
+	// read a string, return its number
+	ULONG ReadString();
+
+public:
+	// ctor
+	CDXLBinaryReader(CMemoryPool *mp, const CHAR *dxl_binary)
+		: m_mp(mp),
+		  m_cursor((const BYTE *) dxl_binary + GPDXL_BINARY_MAGIC_LENGTH),
+		  m_strings(NULL),
+		  m_open_elements(NULL),
+		  m_num_open_elements(0),
+		  m_open_elements_capacity(0),
+		  m_attrs(NULL),
+		  m_num_attrs(0),
+		  m_attrs_capacity(0),
+		  m_name(0)
+	{
+		if (!CDXLBinary::IsBinary(dxl_binary))
+		{
+			RaiseMalformed();
+		}
+
+		m_strings = GPOS_NEW(mp) CDynamicPtrArray<XMLCh, CleanupDeleteArray>(
+			mp, 1024 /*min_size*/);
+	}
+
+	// dtor
+	~CDXLBinaryReader()
+	{
+		m_strings->Release();
+		GPOS_DELETE_ARRAY(m_attrs);
+		GPOS_DELETE_ARRAY(m_open_elements);
+	}
+
+	// read the next record; return false at the end of the document, set
+	// is_open to distinguish the opening and the closing of an element
+	BOOL Next(BOOL *is_open);
+
+	// string with the given number
+	const XMLCh *
+	Xmlstr(ULONG number) const
+	{
+		return (*m_strings)[number];
+	}
+
+	// number of strings read so far
+	ULONG
+	NumStrings() const
+	{
+		return m_strings->Size();
+	}
+
+	// name of the current element
+	ULONG
+	Name() const
+	{
+		return m_name;
+	}
+
+	// number of attributes of the current element
+	ULONG
+	NumAttrs() const
+	{
+		return m_num_attrs;
+	}
+
+	// name of an attribute of the current element
+	ULONG
+	AttrName(ULONG attr) const
+	{
+		GPOS_ASSERT(attr < m_num_attrs);
+		return m_attrs[2 * attr];
+	}
+
+	// value of an attribute of the current element
+	ULONG
+	AttrValue(ULONG attr) const
+	{
+		GPOS_ASSERT(attr < m_num_attrs);
+		return m_attrs[2 * attr + 1];
+	}
+};
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::ReadNumber
+//
+//	@doc:
+//		Read a number; a zero byte is the end of the document, which must
+//		not occur within a record
+//
+//---------------------------------------------------------------------------
+ULONG
+CDXLBinaryReader::ReadNumber()
+{
+	ULONG value = 0;
+	for (ULONG shift = 0; shift < 32; shift += 7)
+	{
+		const BYTE byte = *m_cursor;
+		if (0 == byte)
+		{
+			RaiseMalformed();
+		}
+		m_cursor++;
+
+		value |= (ULONG)(byte & 0x7f) << shift;
+		if (0 == (byte & 0x80))
+		{
+			if (0 == value)
+			{
+				RaiseMalformed();
+			}
+			return value;
+		}
+	}
+
+	RaiseMalformed();
+	return 0;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::ReadString
+//
+//	@doc:
+//		Read a string; decode it from UTF-8 the first time it occurs
+//
+//---------------------------------------------------------------------------
+ULONG
+CDXLBinaryReader::ReadString()
+{
+	const ULONG number = ReadNumber();
+	if (GPDXL_BINARY_NEW_STRING != number)
+	{
+		if (number - 2 >= m_strings->Size())
+		{
+			RaiseMalformed();
+		}
+		return number - 2;
+	}
+
+	const ULONG length = ReadNumber() - 1;
+	const BYTE *end = m_cursor + length;
+
+	// a string never takes more UTF-16 units than UTF-8 bytes
+	XMLCh *xml_str = GPOS_NEW_ARRAY(m_mp, XMLCh, length + 1);
+	ULONG ul = 0;
+	while (m_cursor < end)
+	{
+		ULONG code_point = *m_cursor++;
+		ULONG num_continuation = 0;
+		if (0 == code_point)
+		{
+			GPOS_DELETE_ARRAY(xml_str);
+			RaiseMalformed();
+		}
+		else if (0xF0 <= code_point)
+		{
+			code_point &= 0x07;
+			num_continuation = 3;
+		}
+		else if (0xE0 <= code_point)
+		{
+			code_point &= 0x0F;
+			num_continuation = 2;
+		}
+		else if (0xC0 <= code_point)
+		{
+			code_point &= 0x1F;
+			num_continuation = 1;
+		}
+
+		for (; 0 < num_continuation; num_continuation--)
+		{
+			if (m_cursor >= end || 0x80 != (*m_cursor & 0xC0))
+			{
+				GPOS_DELETE_ARRAY(xml_str);
+				RaiseMalformed();
+			}
+			code_point = (code_point << 6) | (*m_cursor++ & 0x3F);
+		}
+
+		if (0x10000 <= code_point)
+		{
+			code_point -= 0x10000;
+			xml_str[ul++] = (XMLCh)(0xD800 + (code_point >> 10));
+			xml_str[ul++] = (XMLCh)(0xDC00 + (code_point & 0x3FF));
+		}
+		else
+		{
+			xml_str[ul++] = (XMLCh) code_point;
+		}
+	}
+	xml_str[ul] = 0;
+
+	m_strings->Append(xml_str);
+
+	return m_strings->Size() - 1;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinaryReader::Next
+//
+//	@doc:
+//		Read the next record
+//
+//---------------------------------------------------------------------------
+BOOL
+CDXLBinaryReader::Next(BOOL *is_open)
+{
+	switch (*m_cursor++)
+	{
+		case 0:
+			if (0 != m_num_open_elements)
+			{
+				RaiseMalformed();
+			}
+			m_cursor--;
+			return false;
+
+		case GPDXL_BINARY_OPEN:
+		{
+			m_name = ReadString();
+			m_num_attrs = ReadNumber() - 1;
+
+			GrowArray(m_mp, m_attrs, 0, m_attrs_capacity, 2 * m_num_attrs);
+			for (ULONG ul = 0; ul < 2 * m_num_attrs; ul++)
+			{
+				m_attrs[ul] = ReadString();
+			}
+
+			GrowArray(m_mp, m_open_elements, m_num_open_elements,
+					  m_open_elements_capacity, m_num_open_elements + 1);
+			m_open_elements[m_num_open_elements++] = m_name;
+
+			*is_open = true;
+			return true;
+		}
+
+		case GPDXL_BINARY_CLOSE:
+			if (0 == m_num_open_elements)
+			{
+				RaiseMalformed();
+			}
+			m_name = m_open_elements[--m_num_open_elements];
+			m_num_attrs = 0;
+
+			*is_open = false;
+			return true;
+
+		default:
+			RaiseMalformed();
+			return false;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@class:
+//		CDXLBinaryAttributes
+//
+//	@doc:
+//		Attributes of the current element of a binary document, as
+//		reported to the parse handlers
+//
+//---------------------------------------------------------------------------
+class CDXLBinaryAttributes : public Attributes
+{
+private:
+	// the reader
+	const CDXLBinaryReader *m_reader;
+
+	// private copy ctor
+	CDXLBinaryAttributes(const CDXLBinaryAttributes &);
+
+public:
+	// ctor
+	explicit CDXLBinaryAttributes(const CDXLBinaryReader *reader)
+		: m_reader(reader)
+	{
+	}
+
+	// dtor
+	virtual ~CDXLBinaryAttributes()
+	{
+	}
+
+	virtual XMLSize_t
+	getLength() const
+	{
+		return m_reader->NumAttrs();
+	}
+
+	virtual const XMLCh *
+	getURI(const XMLSize_t index) const
+	{
+		return XmlstrURI(getQName(index));
+	}
+
+	virtual const XMLCh *
+	getLocalName(const XMLSize_t index) const
+	{
+		return XmlstrLocalName(getQName(index));
+	}
+
+	virtual const XMLCh *
+	getQName(const XMLSize_t index) const
+	{
+		if (index >= m_reader->NumAttrs())
+		{
+			return NULL;
+		}
+		return m_reader->Xmlstr(m_reader->AttrName((ULONG) index));
+	}
+
+	virtual const XMLCh *
+	getType(const XMLSize_t index) const
+	{
+		return (index < m_reader->NumAttrs()) ? szCDATA : NULL;
+	}
+
+	virtual const XMLCh *
+	getValue(const XMLSize_t index) const
+	{
+		if (index >= m_reader->NumAttrs())
+		{
+			return NULL;
+		}
+		return m_reader->Xmlstr(m_reader->AttrValue((ULONG) index));
+	}
+
+	virtual bool
+	getIndex(const XMLCh *const,  // uri
+			 const XMLCh *const local_part, XMLSize_t &index) const
+	{
+		for (ULONG ul = 0; ul < m_reader->NumAttrs(); ul++)
+		{
+			if (XmlstrEquals(local_part, getLocalName(ul)))
+			{
+				index = ul;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	virtual int
+	getIndex(const XMLCh *const uri, const XMLCh *const local_part) const
+	{
+		XMLSize_t index = 0;
+		return getIndex(uri, local_part, index) ? (int) index : -1;
+	}
+
+	virtual bool
+	getIndex(const XMLCh *const qname, XMLSize_t &index) const
+	{
+		for (ULONG ul = 0; ul < m_reader->NumAttrs(); ul++)
+		{
+			if (XmlstrEquals(qname, getQName(ul)))
+			{
+				index = ul;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	virtual int
+	getIndex(const XMLCh *const qname) const
+	{
+		XMLSize_t index = 0;
+		return getIndex(qname, index) ? (int) index : -1;
+	}
+
+	virtual const XMLCh *
+	getType(const XMLCh *const uri, const XMLCh *const local_part) const
+	{
+		XMLSize_t index = 0;
+		return getIndex(uri, local_part, index) ? szCDATA : NULL;
+	}
+
+	virtual const XMLCh *
+	getType(const XMLCh *const qname) const
+	{
+		XMLSize_t index = 0;
+		return getIndex(qname, index) ? szCDATA : NULL;
+	}
+
+	virtual const XMLCh *
+	getValue(const XMLCh *const uri, const XMLCh *const local_part) const
+	{
+		XMLSize_t index = 0;
+		return getIndex(uri, local_part, index) ? getValue(index) : NULL;
+	}
+
+	virtual const XMLCh *
+	getValue(const XMLCh *const qname) const
+	{
+		XMLSize_t index = 0;
+		return getIndex(qname, index) ? getValue(index) : NULL;
+	}
+};
+
+// convert a UTF-16 string to a GPOS string
+CWStringDynamic *
+PstrFromXmlstr(CMemoryPool *mp, const XMLCh *xml_str)
+{
+	ULONG length = 0;
+	while (0 != xml_str[length])
+	{
+		length++;
+	}
+
+	CAutoRg<WCHAR> w_str(GPOS_NEW_ARRAY(mp, WCHAR, length + 1));
+	ULONG ul = 0;
+	for (const XMLCh *xml_char = xml_str; 0 != *xml_char; xml_char++)
+	{
+		ULONG code_point = *xml_char;
+		if (GPOS_SIZEOF(WCHAR) > GPOS_SIZEOF(XMLCh) &&
+			IsSurrogatePair(xml_char))
+		{
+			code_point = SurrogatePairCodePoint(xml_char);
+			xml_char++;
+		}
+		w_str[ul++] = (WCHAR) code_point;
+	}
+	w_str[ul] = 0;
+
+	return GPOS_NEW(mp) CWStringDynamic(mp, w_str.Rgt());
+}
+}  // namespace
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinary::IsBinary
+//
+//	@doc:
+//		Is the given document in the binary format
+//
+//---------------------------------------------------------------------------
+BOOL
+CDXLBinary::IsBinary(const CHAR *dxl_string)
+{
+	GPOS_ASSERT(NULL != dxl_string);
+
+	return 0 == clib::Strncmp(dxl_string, GPDXL_BINARY_MAGIC,
+							  GPDXL_BINARY_MAGIC_LENGTH);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinary::IsBinaryFile
+//
+//	@doc:
+//		Is the given file a binary document
+//
+//---------------------------------------------------------------------------
+BOOL
+CDXLBinary::IsBinaryFile(const CHAR *file_name)
+{
+	CFileReader fr;
+	fr.Open(file_name);
+
+	CHAR magic[GPDXL_BINARY_MAGIC_LENGTH + 1];
+	ULONG_PTR read_bytes = 0;
+	if (GPDXL_BINARY_MAGIC_LENGTH <= fr.FileSize())
+	{
+		read_bytes =
+			fr.ReadBytesToBuffer((BYTE *) magic, GPDXL_BINARY_MAGIC_LENGTH);
+	}
+	fr.Close();
+
+	magic[read_bytes] = '\0';
+
+	return IsBinary(magic);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinary::Encode
+//
+//	@doc:
+//		Encode the given XML document in the binary format. The function
+//		allocates the result in the given memory pool, and it is the
+//		responsibility of the caller to release it.
+//
+//---------------------------------------------------------------------------
+CHAR *
+CDXLBinary::Encode(CMemoryPool *mp, const CHAR *xml_string)
+{
+	GPOS_ASSERT(NULL != xml_string);
+
+	// disable OOM simulation, otherwise xerces throws ABORT signal
+	CAutoTraceFlag auto_trace_flg1(EtraceSimulateOOM, false);
+	CAutoTraceFlag auto_trace_flg2(EtraceSimulateAbort, false);
+
+	CDXLMemoryManager memory_manager(mp);
+	SAX2XMLReader *sax_2_xml_reader =
+		XMLReaderFactory::createXMLReader(&memory_manager);
+
+	// report the namespace declarations, so that the decoded document
+	// declares the namespace as well
+	sax_2_xml_reader->setFeature(XMLUni::fgSAX2CoreNameSpacePrefixes, true);
+
+	CDXLBinaryEncoder encoder(mp);
+	sax_2_xml_reader->setContentHandler(&encoder);
+	sax_2_xml_reader->setErrorHandler(&encoder);
+
+	MemBufInputSource *input_src_memory_buffer = new (&memory_manager)
+		MemBufInputSource((const XMLByte *) xml_string, strlen(xml_string),
+						  "dxl binary", false, &memory_manager);
+
+	BOOL parse_error = false;
+	try
+	{
+		sax_2_xml_reader->parse(*input_src_memory_buffer);
+	}
+	catch (const XMLException &)
+	{
+		parse_error = true;
+	}
+	catch (const SAXParseException &)
+	{
+		parse_error = true;
+	}
+	catch (const SAXException &)
+	{
+		parse_error = true;
+	}
+
+	delete sax_2_xml_reader;
+	delete input_src_memory_buffer;
+
+	if (parse_error)
+	{
+		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
+	}
+
+	return encoder.Result();
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinary::Decode
+//
+//	@doc:
+//		Decode the given binary document to XML
+//
+//---------------------------------------------------------------------------
+CWStringDynamic *
+CDXLBinary::Decode(CMemoryPool *mp, const CHAR *dxl_binary, BOOL indentation)
+{
+	CDXLBinaryReader reader(mp, dxl_binary);
+
+	CWStringDynamic *xml_str = GPOS_NEW(mp) CWStringDynamic(mp);
+	COstreamString oss(xml_str);
+	CXMLSerializer xml_serializer(mp, oss, indentation);
+
+	// the strings, converted once
+	CDynamicPtrArray<CWStringDynamic, CleanupDelete> *strings =
+		GPOS_NEW(mp) CDynamicPtrArray<CWStringDynamic, CleanupDelete>(mp);
+
+	xml_serializer.StartDocument();
+
+	BOOL is_open = false;
+	while (reader.Next(&is_open))
+	{
+		for (ULONG ul = strings->Size(); ul < reader.NumStrings(); ul++)
+		{
+			strings->Append(PstrFromXmlstr(mp, reader.Xmlstr(ul)));
+		}
+
+		if (!is_open)
+		{
+			xml_serializer.CloseElement(NULL, (*strings)[reader.Name()]);
+			continue;
+		}
+
+		xml_serializer.OpenElement(NULL, (*strings)[reader.Name()]);
+		for (ULONG ul = 0; ul < reader.NumAttrs(); ul++)
+		{
+			xml_serializer.AddAttribute((*strings)[reader.AttrName(ul)],
+										(*strings)[reader.AttrValue(ul)]);
+		}
+	}
+
+	strings->Release();
+
+	return xml_str;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLBinary::Parse
+//
+//	@doc:
+//		Feed the elements of the given binary document to the current
+//		content handler of the reader, which the parse handlers change as
+//		they go, the same way the reader does when parsing XML
+//
+//---------------------------------------------------------------------------
+void
+CDXLBinary::Parse(CMemoryPool *mp, const CHAR *dxl_binary,
+				  SAX2XMLReader *xml_reader)
+{
+	GPOS_ASSERT(NULL != xml_reader);
+
+	CDXLBinaryReader reader(mp, dxl_binary);
+	CDXLBinaryAttributes attrs(&reader);
+
+	GPOS_ASSERT(NULL != xml_reader->getContentHandler());
+	xml_reader->getContentHandler()->startDocument();
+
+	BOOL is_open = false;
+	while (reader.Next(&is_open))
+	{
+		ContentHandler *handler = xml_reader->getContentHandler();
+		if (NULL == handler)
+		{
+			// elements after the end of the DXL document
+			GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXLXercesParseError);
+		}
+
+		const XMLCh *qname = reader.Xmlstr(reader.Name());
+		if (is_open)
+		{
+			handler->startElement(XmlstrURI(qname), XmlstrLocalName(qname),
+								  qname, attrs);
+		}
+		else
+		{
+			handler->endElement(XmlstrURI(qname), XmlstrLocalName(qname),
+								qname);
+		}
+	}
+
+	ContentHandler *handler = xml_reader->getContentHandler();
+	if (NULL != handler)
+	{
+		handler->endDocument();
+	}
+}
+
+// EOF
@@ -0,0 +1,316 @@
+#!/usr/bin/env python
+
+# Optimizer cost model calibration
+#
+# This program runs a set of micro-workloads on the cluster, each one
+# dominated by a single kind of operator (scan, sort, hash join, hash
+# aggregate, motions), and compares the time each operator actually takes
+# with the cost GPORCA estimated for it. It then writes a cost model
+# profile: a factor for each cost model parameter, that makes the costs of
+# the operators proportional to their actual times on this cluster.
+#
+# The costs of GPORCA are relative, so the table scan is taken as the
+# reference and its parameters are left alone.
+#
+# Run this program with the -h or --help option to see argument syntax
+
+import argparse
+import json
+import sys
+
+try:
+    from gppylib.db import dbconn
+except ImportError as e:
+    sys.exit('ERROR: Cannot import modules.  Please check that you have sourced greengage_path.sh.  Detail: ' + str(e))
+
+_help = """
+Calibrate the cost model of the optimizer on this cluster. Optionally create
+the tables before running, and drop them afterwards. The resulting profile is
+meant to be set as optimizer_cost_model_profile, for instance with
+gpconfig -c optimizer_cost_model_profile -v "'<profile>'".
+"""
+
+# Description:
+#
+# The time of an operator is its "Actual Total Time" in EXPLAIN ANALYZE,
+# minus that of its inputs; its cost is its "Total Cost" minus that of its
+# inputs. A Hash node counts as part of its Hash Join, since GPORCA costs
+# them together. For each group of operators, the ratio of time to cost is
+# the median over the runs, and the factor of its parameters is that ratio
+# divided by the ratio of the table scan.
+#
+# The times of the slowest segment are reported by EXPLAIN ANALYZE, so the
+# data should be evenly distributed, as it is in the tables created by
+# --create. statement_mem should be large enough for the hash tables and
+# sorts not to spill, which is what the parameters calibrated here cost.
+
+# constants
+# -----------------------------------------------------------------------------
+
+# rows of the dimension table per row of the fact table
+DIM_RATIO = 100
+
+# the operator groups to calibrate: a name, the node type and strategy that
+# identify the operators in an EXPLAIN plan, and the parameters to scale
+OPERATOR_GROUPS = [
+    ("table_scan", "Seq Scan", None, []),
+    ("sort", "Sort", None, ["SortTupWidthCostUnit"]),
+    ("hash_join", "Hash Join", None, ["HJHashTableColumnCostUnit",
+                                      "HJHashTableWidthCostUnit",
+                                      "HJHashingTupWidthCostUnit",
+                                      "JoinFeedingTupColumnCostUnit",
+                                      "JoinFeedingTupWidthCostUnit",
+                                      "JoinOutputTupCostUnit"]),
+    ("hash_agg", "Aggregate", "Hashed", ["HashAggInputTupColumnCostUnit",
+                                         "HashAggInputTupWidthCostUnit",
+                                         "HashAggOutputTupWidthCostUnit"]),
+    ("redistribute_motion", "Redistribute Motion", None, ["RedistributeSendCostUnit",
+                                                          "RedistributeRecvCostUnit"]),
+    ("broadcast_motion", "Broadcast Motion", None, ["BroadcastSendCostUnit",
+                                                    "BroadcastRecvCostUnit"]),
+    ("gather_motion", "Gather Motion", None, ["GatherSendCostUnit",
+                                              "GatherRecvCostUnit"]),
+]
+
+REFERENCE_GROUP = "table_scan"
+
+# SQL statements, DDL and DML
+# -----------------------------------------------------------------------------
+
+_drop_tables = """
+DROP TABLE IF EXISTS cal_cm_fact, cal_cm_dim;
+"""
+
+_create_tables = ["""
+CREATE TABLE cal_cm_fact(id int, dim_id int, val int, pad text)
+DISTRIBUTED BY (id);
+""", """
+CREATE TABLE cal_cm_dim(id int, name text)
+DISTRIBUTED BY (id);
+"""]
+
+# parameters: rows of the dimension table, rows of the fact table (twice)
+_insert_fact = """
+INSERT INTO cal_cm_fact
+SELECT i, i %% %d, (i::bigint * 7919) %% %d, repeat('x', 32)
+FROM generate_series(0, %d - 1) i;
+"""
+
+_insert_dim = """
+INSERT INTO cal_cm_dim
+SELECT i, 'dim ' || i
+FROM generate_series(0, %d - 1) i;
+"""
+
+_analyze_tables = """
+ANALYZE cal_cm_fact, cal_cm_dim;
+"""
+
+# settings the costs are compared under
+_session_settings = [
+    "SET optimizer = on",
+    "SET optimizer_cost_model_profile = ''",
+    "SET optimizer_sort_factor = 1.0",
+    "SET optimizer_enable_motion_broadcast = on",
+]
+
+# the workloads; the fact table has --numRows rows
+_workloads = [
+    # table scan
+    "SELECT count(*) FROM cal_cm_fact",
+    # sort, and a gather motion of all the rows
+    "SELECT id, val, pad FROM cal_cm_fact ORDER BY val, pad OFFSET %(rows)d",
+    # hash join, and a broadcast motion of the dimension table
+    "SELECT count(*) FROM cal_cm_fact f JOIN cal_cm_dim d ON f.dim_id = d.id",
+    # hash aggregate on the distribution key
+    "SELECT count(*) FROM (SELECT id, count(*) FROM cal_cm_fact GROUP BY id) s",
+    # redistribute motion of the fact table
+    "SELECT count(*) FROM cal_cm_fact f1 JOIN cal_cm_fact f2 ON f1.val = f2.id",
+]
+
+
+# deal with command line arguments
+# -----------------------------------------------------------------------------
+
+def parseargs():
+    parser = argparse.ArgumentParser(description=_help)
+
+    parser.add_argument("--create", action="store_true",
+                        help="Create the tables to use in the calibration")
+    parser.add_argument("--drop", action="store_true",
+                        help="Drop the tables used in the calibration when finished")
+    parser.add_argument("--runs", type=int, default=5,
+                        help="Number of times to run each workload (default is 5)")
+    parser.add_argument("--numRows", type=int, default=10000000,
+                        help="Number of rows to INSERT INTO the fact table (default is 10 million)")
+    parser.add_argument("--output", default="",
+                        help="Write the profile to this file")
+    parser.add_argument("--verbose", action="store_true",
+                        help="Print the plans and timings of every run")
+    parser.add_argument("--host", default="",
+                        help="Host to connect to (default is localhost or $PGHOST, if set).")
+    parser.add_argument("--port", type=int, default=0,
+                        help="Port on the host to connect to (default is 0 or $PGPORT, if set)")
+    parser.add_argument("--dbName", default="",
+                        help="Database name to connect to")
+
+    return parser.parse_args()
+
+
+# SQL related methods
+# -----------------------------------------------------------------------------
+
+def connect(host, port_num, db_name):
+    try:
+        dburl = dbconn.DbURL(hostname=host, port=port_num, dbname=db_name)
+        conn = dbconn.connect(dburl, encoding="UTF8")
+    except Exception as e:
+        sys.exit("Exception during connect: %s" % e)
+
+    return conn
+
+
+def execute_sql(conn, sqlStr, verbose):
+    if verbose:
+        print("Executing query: %s" % sqlStr)
+    dbconn.execSQL(conn, sqlStr)
+    dbconn.execSQL(conn, "commit")
+
+
+def create_tables(conn, num_rows, verbose):
+    num_dim_rows = max(num_rows // DIM_RATIO, 1)
+
+    execute_sql(conn, _drop_tables, verbose)
+    for sqlStr in _create_tables:
+        execute_sql(conn, sqlStr, verbose)
+    execute_sql(conn, _insert_fact % (num_dim_rows, num_rows, num_rows), verbose)
+    execute_sql(conn, _insert_dim % num_dim_rows, verbose)
+    execute_sql(conn, _analyze_tables, verbose)
+
+
+def explain_analyze(conn, sqlStr, verbose):
+    curs = dbconn.execSQL(conn, "EXPLAIN (ANALYZE, FORMAT JSON) " + sqlStr)
+    result = curs.fetchall()[0][0]
+    if not isinstance(result, list):
+        result = json.loads(result)
+    if verbose:
+        print(json.dumps(result, indent=2))
+    return result[0]["Plan"]
+
+
+# calibration
+# -----------------------------------------------------------------------------
+
+def plan_inputs(node):
+    """The inputs of a plan node, looking through the Hash of a Hash Join"""
+    inputs = []
+    for child in node.get("Plans", []):
+        if node["Node Type"] == "Hash Join" and child["Node Type"] == "Hash":
+            inputs.extend(child.get("Plans", []))
+        else:
+            inputs.append(child)
+    return inputs
+
+
+def operator_group(node):
+    for (name, node_type, strategy, params) in OPERATOR_GROUPS:
+        if node["Node Type"] == node_type and \
+                (strategy is None or node.get("Strategy") == strategy):
+            return name
+    return None
+
+
+def collect_operators(node, samples):
+    """Add the time and cost of each operator of a plan to its group"""
+    group = operator_group(node)
+    if group is not None:
+        inputs = plan_inputs(node)
+        time = node.get("Actual Total Time", 0.0) - \
+            sum(child.get("Actual Total Time", 0.0) for child in inputs)
+        cost = node["Total Cost"] - sum(child["Total Cost"] for child in inputs)
+        if time > 0 and cost > 0:
+            (total_time, total_cost) = samples.get(group, (0.0, 0.0))
+            samples[group] = (total_time + time, total_cost + cost)
+
+    for child in node.get("Plans", []):
+        collect_operators(child, samples)
+
+
+def median(values):
+    values = sorted(values)
+    mid = len(values) // 2
+    if len(values) % 2 == 1:
+        return values[mid]
+    return (values[mid - 1] + values[mid]) / 2.0
+
+
+def calibrate(conn, runs, num_rows, verbose):
+    """Returns the median ratio of time to cost of each operator group"""
+    for sqlStr in _session_settings:
+        execute_sql(conn, sqlStr, verbose)
+
+    ratios = {}
+    for run in range(runs):
+        samples = {}
+        for workload in _workloads:
+            plan = explain_analyze(conn, workload % {"rows": num_rows}, verbose)
+            collect_operators(plan, samples)
+
+        for (group, (time, cost)) in samples.items():
+            ratios.setdefault(group, []).append(time / cost)
+
+    return dict((group, median(values)) for (group, values) in ratios.items())
+
+
+def make_profile(ratios):
+    """Returns the factors of the parameters, and a report of the groups"""
+    factors = []
+    report = []
+    reference = ratios[REFERENCE_GROUP]
+
+    for (name, node_type, strategy, params) in OPERATOR_GROUPS:
+        if name not in ratios:
+            report.append("%-20s not found in any plan, left alone" % name)
+            continue
+
+        factor = ratios[name] / reference
+        report.append("%-20s %12.6f ms/cost  factor %.4g" % (name, ratios[name], factor))
+        for param in params:
+            factors.append("%s=%.4g" % (param, factor))
+
+    return ", ".join(factors), report
+
+
+# main
+# -----------------------------------------------------------------------------
+
+def main():
+    args = parseargs()
+
+    conn = connect(args.host, args.port, args.dbName)
+
+    if args.create:
+        create_tables(conn, args.numRows, args.verbose)
+
+    ratios = calibrate(conn, args.runs, args.numRows, args.verbose)
+    if REFERENCE_GROUP not in ratios:
+        sys.exit("ERROR: No table scan found in the plans, was the optimizer used?")
+
+    profile, report = make_profile(ratios)
+    for line in report:
+        print(line)
+    print("")
+    print("optimizer_cost_model_profile = '%s'" % profile)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(profile + "\n")
+
+    if args.drop:
+        execute_sql(conn, _drop_tables, args.verbose)
+
+    conn.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,103 @@
+#!/usr/bin/env python
+
+import sys
+import json
+import argparse
+
+_help = """
+Compares two result files of gporca_bench, see ../server/bench/main.cpp,
+and reports the minidumps whose median optimization time, peak memory or
+number of jobs grew by more than the given percentage over the baseline.
+The exit status is 1 if any regression was found.
+"""
+
+# Description:
+#
+# A typical use is to save the results of a known good build as the baseline:
+#
+#   ./server/gporca_bench -n 20 -o baseline.json ../data/dxl/minidump/*.mdp
+#
+# and to compare the results of a new build against it:
+#
+#   ./server/gporca_bench -n 20 -o current.json ../data/dxl/minidump/*.mdp
+#   ../scripts/compare_minidump_bench.py baseline.json current.json
+#
+# Minidumps that take less than --min-time-us to optimize are not checked
+# for time regressions, since their timings are mostly noise.
+
+
+def load(file_name):
+    with open(file_name) as f:
+        results = json.load(f)
+    return dict((md['file'], md) for md in results['minidumps'])
+
+
+def growth(baseline, current):
+    if baseline == 0:
+        return 0.0 if current == 0 else float('inf')
+    return 100.0 * (current - baseline) / baseline
+
+
+def compare(baseline, current, args):
+    regressions = []
+    for file_name in sorted(current):
+        if file_name not in baseline:
+            print("%s: not in baseline" % file_name)
+            continue
+
+        base = baseline[file_name]
+        cur = current[file_name]
+        metrics = [('peak_bytes', base['peak_bytes'], cur['peak_bytes'],
+                    args.memory_threshold),
+                   ('jobs', base['jobs']['completed'],
+                    cur['jobs']['completed'], args.jobs_threshold)]
+        if base['time_us']['median'] >= args.min_time_us:
+            metrics.insert(0, ('median time_us', base['time_us']['median'],
+                               cur['time_us']['median'], args.time_threshold))
+
+        for name, base_value, cur_value, threshold in metrics:
+            pct = growth(base_value, cur_value)
+            line = "%s: %s %d -> %d (%+.1f%%)" % (file_name, name, base_value,
+                                                  cur_value, pct)
+            if pct > threshold:
+                regressions.append(line)
+            elif args.verbose:
+                print(line)
+
+        if args.verbose:
+            for xform, counts in sorted(cur['xforms'].items()):
+                base_calls = base['xforms'].get(xform, {}).get('calls', 0)
+                if base_calls != counts['calls']:
+                    print("%s: %s calls %d -> %d" % (file_name, xform,
+                                                     base_calls,
+                                                     counts['calls']))
+
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=_help)
+    parser.add_argument('baseline', help='results of the baseline build')
+    parser.add_argument('current', help='results of the build to check')
+    parser.add_argument('--time-threshold', type=float, default=10.0,
+                        help='allowed growth of the median time, in percent')
+    parser.add_argument('--memory-threshold', type=float, default=10.0,
+                        help='allowed growth of the peak memory, in percent')
+    parser.add_argument('--jobs-threshold', type=float, default=5.0,
+                        help='allowed growth of the number of jobs, in percent')
+    parser.add_argument('--min-time-us', type=int, default=10000,
+                        help='minimum median time to check, in microseconds')
+    parser.add_argument('-v', '--verbose', action='store_true',
+                        help='also print unchanged metrics and xform calls')
+    args = parser.parse_args()
+
+    regressions = compare(load(args.baseline), load(args.current), args)
+    for line in regressions:
+        print("REGRESSION %s" % line)
+
+    if regressions:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
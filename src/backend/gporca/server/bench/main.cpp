@@ -0,0 +1,421 @@
+//---------------------------------------------------------------------------
+//	Greengage Database
+//	Copyright (c) 2025 Greengage Community
+//
+//	@filename:
+//		main.cpp
+//
+//	@doc:
+//		Benchmark of the optimization time of minidumps
+//
+//		Usage: gporca_bench [-n iterations] [-w warmups] [-o file]
+//				[-T traceflag] minidump ...
+//
+//		Every minidump is loaded once and optimized the given number of
+//		times after the warmups. The wall time, the peak size of the
+//		optimization memory pool, the scheduler counters and the counters
+//		of each job type and xform are written as JSON to the output file,
+//		by default gporca_bench.json. scripts/compare_minidump_bench.py
+//		compares two such files.
+//---------------------------------------------------------------------------
+
+#include "gpos/_api.h"
+#include "gpos/common/CAutoRg.h"
+#include "gpos/common/CMainArgs.h"
+#include "gpos/common/CWallClock.h"
+#include "gpos/common/clibwrapper.h"
+#include "gpos/io/COstreamString.h"
+#include "gpos/memory/CAutoMemoryPool.h"
+#include "gpos/string/CWStringDynamic.h"
+#include "gpos/task/CAutoTraceFlag.h"
+
+#include "gpopt/base/CIOUtils.h"
+#include "gpopt/cost/ICostModel.h"
+#include "gpopt/engine/CEnumeratorConfig.h"
+#include "gpopt/init.h"
+#include "gpopt/mdcache/CMDCache.h"
+#include "gpopt/minidump/CDXLMinidump.h"
+#include "gpopt/minidump/CMinidumperUtils.h"
+#include "gpopt/optimizer/COptimizationStats.h"
+#include "gpopt/optimizer/COptimizerConfig.h"
+#include "gpopt/xforms/CXformFactory.h"
+#include "naucrates/dxl/CDXLUtils.h"
+#include "naucrates/init.h"
+
+using namespace gpos;
+using namespace gpopt;
+using namespace gpdxl;
+
+// default number of measured optimizations of each minidump
+#define GPOPT_BENCH_ITERATIONS 10
+
+// default number of optimizations before measuring
+#define GPOPT_BENCH_WARMUPS 1
+
+// default output file
+#define GPOPT_BENCH_OUTPUT "gporca_bench.json"
+
+// minimum number of segments to optimize for, as in gporca_test
+#define GPOPT_BENCH_SEGMENTS 2
+
+
+// settings of the benchmark
+struct SBenchArgs
+{
+	// command line
+	CMainArgs *m_main_args;
+
+	// number of measured optimizations of each minidump
+	ULONG m_iterations;
+
+	// number of optimizations before measuring
+	ULONG m_warmups;
+
+	// output file
+	const CHAR *m_output_file;
+
+	// arguments, the minidump files follow the options
+	const CHAR **m_argv;
+	ULONG m_argc;
+};
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CompareTimes
+//
+//	@doc:
+//		Comparator of elapsed times, for sorting
+//
+//---------------------------------------------------------------------------
+static INT
+CompareTimes(const void *pv1, const void *pv2)
+{
+	const ULONG ul1 = *static_cast<const ULONG *>(pv1);
+	const ULONG ul2 = *static_cast<const ULONG *>(pv2);
+
+	if (ul1 < ul2)
+	{
+		return -1;
+	}
+
+	return ul1 > ul2 ? 1 : 0;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		OsPrintJSONString
+//
+//	@doc:
+//		Print a string as a JSON string literal
+//
+//---------------------------------------------------------------------------
+static IOstream &
+OsPrintJSONString(IOstream &os, const CHAR *sz)
+{
+	os << "\"";
+	for (const CHAR *pc = sz; '\0' != *pc; pc++)
+	{
+		if ('"' == *pc || '\\' == *pc)
+		{
+			os << "\\";
+		}
+		os << *pc;
+	}
+
+	return os << "\"";
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		UlSegments
+//
+//	@doc:
+//		Number of segments to optimize a minidump for
+//
+//---------------------------------------------------------------------------
+static ULONG
+UlSegments(COptimizerConfig *optimizer_config)
+{
+	ULONG ulSegments = GPOPT_BENCH_SEGMENTS;
+	if (NULL != optimizer_config->GetCostModel() &&
+		ulSegments < optimizer_config->GetCostModel()->UlHosts())
+	{
+		ulSegments = optimizer_config->GetCostModel()->UlHosts();
+	}
+
+	return ulSegments;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		BenchMinidump
+//
+//	@doc:
+//		Optimize a minidump repeatedly and print the measurements as a JSON
+//		object
+//
+//---------------------------------------------------------------------------
+static void
+BenchMinidump(CMemoryPool *mp, const SBenchArgs *args, const CHAR *file_name,
+			  IOstream &os)
+{
+	CDXLMinidump *pdxlmd = CMinidumperUtils::PdxlmdLoad(mp, file_name);
+
+	COptimizerConfig *optimizer_config = pdxlmd->GetOptimizerConfig();
+	if (NULL == optimizer_config)
+	{
+		optimizer_config = COptimizerConfig::PoconfDefault(mp);
+	}
+	else
+	{
+		optimizer_config->AddRef();
+	}
+
+	COptimizationStats *optimization_stats =
+		GPOS_NEW(mp) COptimizationStats();
+	optimization_stats->AddRef();
+	optimizer_config->SetOptimizationStats(optimization_stats);
+
+	const ULONG ulSegments = UlSegments(optimizer_config);
+
+	CAutoRg<ULONG> a_rgulTimes;
+	a_rgulTimes = GPOS_NEW_ARRAY(mp, ULONG, args->m_iterations);
+	ULLONG ullTotalTime = 0;
+	ULLONG ullPeakBytes = 0;
+
+	for (ULONG ul = 0; ul < args->m_warmups + args->m_iterations; ul++)
+	{
+		optimization_stats->Reset();
+
+		// optimize in a pool of the same kind as the server does
+		CAutoMemoryPool amp(CAutoMemoryPool::ElcExc, true /*use_arena*/);
+		CMemoryPool *pmpRun = amp.Pmp();
+
+		CWallClock clock;
+		CDXLNode *pdxlnPlan = CMinidumperUtils::PdxlnExecuteMinidump(
+			pmpRun, pdxlmd, file_name, ulSegments, 1 /*ulSessionId*/,
+			1 /*ulCmdId*/, optimizer_config, NULL /*pceeval*/);
+		const ULONG ulTime = clock.ElapsedUS();
+
+		pdxlnPlan->Release();
+
+		if (ul < args->m_warmups)
+		{
+			continue;
+		}
+
+		a_rgulTimes[ul - args->m_warmups] = ulTime;
+		ullTotalTime += ulTime;
+		if (pmpRun->PeakAllocatedSize() > ullPeakBytes)
+		{
+			ullPeakBytes = pmpRun->PeakAllocatedSize();
+		}
+	}
+
+	clib::Qsort(a_rgulTimes.Rgt(), args->m_iterations, GPOS_SIZEOF(ULONG),
+				CompareTimes);
+
+	os << "{\"file\": ";
+	OsPrintJSONString(os, file_name);
+	os << ", \"iterations\": " << args->m_iterations;
+	os << ", \"time_us\": {\"min\": " << a_rgulTimes[0]
+	   << ", \"median\": " << a_rgulTimes[args->m_iterations / 2]
+	   << ", \"mean\": " << ullTotalTime / args->m_iterations
+	   << ", \"max\": " << a_rgulTimes[args->m_iterations - 1] << "}";
+	os << ", \"peak_bytes\": " << ullPeakBytes;
+
+	// the counters of the last optimization
+	os << ", \"groups\": " << optimization_stats->Groups();
+	os << ", \"jobs\": {\"queued\": " << optimization_stats->JobsQueued()
+	   << ", \"dequeued\": " << optimization_stats->JobsDequeued()
+	   << ", \"suspended\": " << optimization_stats->JobsSuspended()
+	   << ", \"resumed\": " << optimization_stats->JobsResumed()
+	   << ", \"completed_queued\": "
+	   << optimization_stats->JobsCompletedQueued()
+	   << ", \"completed\": " << optimization_stats->JobsCompleted() << "}";
+
+	os << ", \"job_types\": {";
+	const CHAR *szSeparator = "";
+	for (ULONG ul = 0; ul < CJob::EjtSentinel; ul++)
+	{
+		CJob::EJobType ejt = (CJob::EJobType) ul;
+		if (0 == optimization_stats->JobSteps(ejt))
+		{
+			continue;
+		}
+
+		os << szSeparator;
+		OsPrintJSONString(os, COptimizationStats::JobName(ejt));
+		os << ": {\"steps\": " << optimization_stats->JobSteps(ejt)
+		   << ", \"time_us\": " << optimization_stats->JobTimeUS(ejt) << "}";
+		szSeparator = ", ";
+	}
+	os << "}";
+
+	os << ", \"xforms\": {";
+	szSeparator = "";
+	for (ULONG ul = 0; ul < CXform::ExfSentinel; ul++)
+	{
+		CXform::EXformId exfid = (CXform::EXformId) ul;
+		if (0 == optimization_stats->XformCalls(exfid))
+		{
+			continue;
+		}
+
+		os << szSeparator;
+		OsPrintJSONString(os, CXformFactory::Pxff()->Pxf(exfid)->SzId());
+		os << ": {\"calls\": " << optimization_stats->XformCalls(exfid)
+		   << ", \"bindings\": " << optimization_stats->XformBindings(exfid)
+		   << ", \"results\": " << optimization_stats->XformResults(exfid)
+		   << ", \"time_us\": " << optimization_stats->XformTimeUS(exfid)
+		   << "}";
+		szSeparator = ", ";
+	}
+	os << "}}";
+
+	optimization_stats->Release();
+	optimizer_config->Release();
+	GPOS_DELETE(pdxlmd);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		PvExec
+//
+//	@doc:
+//		Function driving execution
+//
+//---------------------------------------------------------------------------
+static void *
+PvExec(void *pv)
+{
+	SBenchArgs *args = (SBenchArgs *) pv;
+
+	CHAR ch = '\0';
+	while (args->m_main_args->Getopt(&ch))
+	{
+		CHAR *pcEnd = NULL;
+		switch (ch)
+		{
+			case 'n':
+				args->m_iterations =
+					(ULONG) clib::Strtol(optarg, &pcEnd, 0 /*iBase*/);
+				break;
+
+			case 'w':
+				args->m_warmups =
+					(ULONG) clib::Strtol(optarg, &pcEnd, 0 /*iBase*/);
+				break;
+
+			case 'o':
+				args->m_output_file = optarg;
+				break;
+
+			case 'T':
+				GPOS_SET_TRACE(
+					(ULONG) clib::Strtol(optarg, &pcEnd, 0 /*iBase*/));
+				break;
+
+			default:
+				// ignore other parameters
+				break;
+		}
+	}
+
+	if (0 == args->m_iterations || args->m_argc <= (ULONG) optind)
+	{
+		GPOS_TRACE(GPOS_WSZ_LIT(
+			"Usage: gporca_bench [-n iterations] [-w warmups] [-o file] "
+			"[-T traceflag] minidump ..."));
+		return NULL;
+	}
+
+	InitDXL();
+	CMDCache::Init();
+
+	{
+		CAutoMemoryPool amp;
+		CMemoryPool *mp = amp.Pmp();
+
+		CWStringDynamic str(mp);
+		COstreamString oss(&str);
+
+		oss << "{\"iterations\": " << args->m_iterations
+			<< ", \"warmups\": " << args->m_warmups << ", \"minidumps\": [";
+		for (ULONG ul = optind; ul < args->m_argc; ul++)
+		{
+			if ((ULONG) optind < ul)
+			{
+				oss << ",";
+			}
+			oss << std::endl << "  ";
+			BenchMinidump(mp, args, args->m_argv[ul], oss);
+		}
+		oss << std::endl << "]}" << std::endl;
+
+		CAutoRg<CHAR> a_szJSON;
+		a_szJSON = CDXLUtils::CreateMultiByteCharStringFromWCString(
+			mp, str.GetBuffer());
+		CIOUtils::Dump(const_cast<CHAR *>(args->m_output_file),
+					   a_szJSON.Rgt());
+	}
+
+	CMDCache::Shutdown();
+
+	return NULL;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		main
+//
+//	@doc:
+//		Entry point for the benchmark binary
+//
+//---------------------------------------------------------------------------
+INT
+main(INT iArgs, const CHAR **rgszArgs)
+{
+	// Use default allocator
+	struct gpos_init_params gpos_params = {NULL};
+
+	gpos_init(&gpos_params);
+	gpdxl_init();
+	gpopt_init();
+
+	GPOS_ASSERT(iArgs >= 0);
+
+	CMainArgs ma(iArgs, rgszArgs, "n:w:o:T:");
+
+	SBenchArgs args;
+	args.m_main_args = &ma;
+	args.m_iterations = GPOPT_BENCH_ITERATIONS;
+	args.m_warmups = GPOPT_BENCH_WARMUPS;
+	args.m_output_file = GPOPT_BENCH_OUTPUT;
+	args.m_argv = rgszArgs;
+	args.m_argc = (ULONG) iArgs;
+
+	gpos_exec_params params;
+	params.func = PvExec;
+	params.arg = &args;
+	params.stack_start = &params;
+	params.error_buffer = NULL;
+	params.error_buffer_size = -1;
+	params.abort_requested = NULL;
+
+	if (gpos_exec(&params))
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
+
+// EOF
@@ -36,6 +36,7 @@ public:
 	static GPOS_RESULT EresUnittest_SerializeQuery();
 	static GPOS_RESULT EresUnittest_SerializePlan();
 	static GPOS_RESULT EresUnittest_Encoding();
+	static GPOS_RESULT EresUnittest_Binary();
 
 };	// class CDXLUtilsTest
 }  // namespace gpdxl
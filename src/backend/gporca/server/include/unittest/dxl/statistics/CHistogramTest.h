@@ -51,6 +51,9 @@ public:
 
 	// merge union test with double values differing by less than epsilon
 	static GPOS_RESULT EresUnittest_MergeUnionDoubleLessThanEpsilon();
+
+	// columnar histogram kernels against the bucket ones
+	static GPOS_RESULT EresUnittest_FlatHistogram();
 };	// class CHistogramTest
 }  // namespace gpnaucrates
 
@@ -31,11 +31,19 @@ private:
 	// counter used to mark last successful test
 	static ULONG m_ulTestCounter;
 
+	// counter of the DPhyp minidump tests
+	static ULONG m_ulDPhypTestCounter;
+
 public:
 	// unittests
 	static GPOS_RESULT EresUnittest();
 	static GPOS_RESULT EresUnittest_ExpandMinCard();
+	static GPOS_RESULT EresUnittest_ExpandDPhyp();
+	static GPOS_RESULT EresUnittest_ExpandDPhypLOJ();
+	static GPOS_RESULT EresUnittest_ExpandDPhypHyperedge();
+	static GPOS_RESULT EresUnittest_ExpandDPhypFallback();
 	static GPOS_RESULT EresUnittest_RunTests();
+	static GPOS_RESULT EresUnittest_RunDPhypTests();
 
 };	// class CJoinOrderTest
 }  // namespace gpopt
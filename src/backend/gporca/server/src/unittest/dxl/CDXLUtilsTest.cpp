@@ -23,6 +23,7 @@
 
 #include "naucrates/base/CQueryToDXLResult.h"
 #include "naucrates/dxl/CDXLUtils.h"
+#include "naucrates/dxl/xml/CDXLBinary.h"
 #include "naucrates/dxl/xml/CDXLMemoryManager.h"
 #include "naucrates/dxl/xml/CXMLSerializer.h"
 
@@ -50,6 +51,7 @@ CDXLUtilsTest::EresUnittest()
 		GPOS_UNITTEST_FUNC(CDXLUtilsTest::EresUnittest_SerializeQuery),
 		GPOS_UNITTEST_FUNC(CDXLUtilsTest::EresUnittest_SerializePlan),
 		GPOS_UNITTEST_FUNC(CDXLUtilsTest::EresUnittest_Encoding),
+		GPOS_UNITTEST_FUNC(CDXLUtilsTest::EresUnittest_Binary),
 	};
 
 	return CUnittest::EresExecute(rgut, GPOS_ARRAY_SIZE(rgut));
@@ -231,4 +233,80 @@ CDXLUtilsTest::EresUnittest_Encoding()
 	return GPOS_OK;
 }
 
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLUtilsTest::EresUnittest_Binary
+//
+//	@doc:
+//		Testing the binary encoding of DXL: a plan parsed from its binary
+//		encoding serializes to the same XML as the plan parsed from XML,
+//		and the decoded binary document parses to the same plan
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CDXLUtilsTest::EresUnittest_Binary()
+{
+	// create memory pool
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	// read DXL file
+	CHAR *dxl_string = CDXLUtils::Read(mp, szPlanFile);
+	GPOS_RTL_ASSERT(!CDXLBinary::IsBinary(dxl_string));
+
+	CHAR *dxl_binary = CDXLBinary::Encode(mp, dxl_string);
+	GPOS_RTL_ASSERT(CDXLBinary::IsBinary(dxl_binary));
+
+	CAutoTrace at(mp);
+	at.Os() << "XML: " << clib::Strlen(dxl_string)
+			<< " bytes, binary: " << clib::Strlen(dxl_binary) << " bytes";
+
+	CWStringDynamic *decoded_str = CDXLBinary::Decode(mp, dxl_binary);
+	CHAR *decoded_string = CDXLUtils::CreateMultiByteCharStringFromWCString(
+		mp, decoded_str->GetBuffer());
+
+	const CHAR *rgszDocuments[] = {dxl_string, dxl_binary, decoded_string};
+	CWStringDynamic *rgpstrPlans[GPOS_ARRAY_SIZE(rgszDocuments)];
+
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(rgszDocuments); ul++)
+	{
+		ULLONG plan_id = gpos::ullong_max;
+		ULLONG plan_space_size = gpos::ullong_max;
+		CDXLNode *node = CDXLUtils::GetPlanDXLNode(
+			mp, rgszDocuments[ul], NULL /*xsd_file_path*/, &plan_id,
+			&plan_space_size);
+
+		rgpstrPlans[ul] = GPOS_NEW(mp) CWStringDynamic(mp);
+		COstreamString oss(rgpstrPlans[ul]);
+		CDXLUtils::SerializePlan(mp, oss, node, plan_id, plan_space_size,
+								 true /*serialize_header_footer*/,
+								 true /*indentation*/);
+		node->Release();
+	}
+
+	GPOS_RESULT eres = GPOS_OK;
+	for (ULONG ul = 1; ul < GPOS_ARRAY_SIZE(rgszDocuments); ul++)
+	{
+		if (!rgpstrPlans[0]->Equals(rgpstrPlans[ul]))
+		{
+			GPOS_TRACE(rgpstrPlans[0]->GetBuffer());
+			GPOS_TRACE(rgpstrPlans[ul]->GetBuffer());
+			eres = GPOS_FAILED;
+		}
+	}
+
+	// cleanup
+	for (ULONG ul = 0; ul < GPOS_ARRAY_SIZE(rgszDocuments); ul++)
+	{
+		GPOS_DELETE(rgpstrPlans[ul]);
+	}
+	GPOS_DELETE_ARRAY(decoded_string);
+	GPOS_DELETE(decoded_str);
+	GPOS_DELETE_ARRAY(dxl_binary);
+	GPOS_DELETE_ARRAY(dxl_string);
+
+	return eres;
+}
+
 // EOF
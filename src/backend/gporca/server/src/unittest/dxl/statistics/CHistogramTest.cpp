@@ -21,6 +21,7 @@
 #include "gpos/io/COstreamString.h"
 #include "gpos/string/CWStringDynamic.h"
 
+#include "naucrates/statistics/CFlatHistogram.h"
 #include "naucrates/statistics/CHistogram.h"
 #include "naucrates/statistics/CPoint.h"
 
@@ -42,7 +43,8 @@ CHistogramTest::EresUnittest()
 		GPOS_UNITTEST_FUNC(CHistogramTest::EresUnittest_CHistogramValid),
 		GPOS_UNITTEST_FUNC(CHistogramTest::EresUnittest_MergeUnion),
 		GPOS_UNITTEST_FUNC(
-			CHistogramTest::EresUnittest_MergeUnionDoubleLessThanEpsilon)};
+			CHistogramTest::EresUnittest_MergeUnionDoubleLessThanEpsilon),
+		GPOS_UNITTEST_FUNC(CHistogramTest::EresUnittest_FlatHistogram)};
 
 
 	CAutoMemoryPool amp;
@@ -431,4 +433,142 @@ CHistogramTest::EresUnittest_MergeUnionDoubleLessThanEpsilon()
 
 	return GPOS_OK;
 }
+
+// columnar histogram kernels against the bucket ones
+GPOS_RESULT
+CHistogramTest::EresUnittest_FlatHistogram()
+{
+	// create memory pool
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	// singletons, ranges sharing bounds, open and closed bounds, and a gap
+	CBucketArray *buckets1 = GPOS_NEW(mp) CBucketArray(mp);
+	buckets1->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, 0, 0, true, true, CDouble(0.1), CDouble(1.0)));
+	buckets1->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, 0, 10, false, false, CDouble(0.2), CDouble(9.0)));
+	buckets1->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, 10, 30, true, true, CDouble(0.3), CDouble(15.0)));
+	buckets1->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, 50, 50, true, true, CDouble(0.1), CDouble(1.0)));
+	buckets1->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, 60, 100, true, false, CDouble(0.3), CDouble(40.0)));
+	CHistogram *histogram1 = GPOS_NEW(mp) CHistogram(mp, buckets1);
+
+	CBucketArray *buckets2 = GPOS_NEW(mp) CBucketArray(mp);
+	buckets2->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, -20, 5, true, false, CDouble(0.25), CDouble(20.0)));
+	buckets2->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, 5, 5, true, true, CDouble(0.05), CDouble(1.0)));
+	buckets2->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, 5, 50, false, true, CDouble(0.4), CDouble(30.0)));
+	buckets2->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, 70, 80, true, true, CDouble(0.2), CDouble(10.0)));
+	buckets2->Append(CCardinalityTestUtils::PbucketInteger(
+		mp, 100, 100, true, true, CDouble(0.1), CDouble(1.0)));
+	CHistogram *histogram2 = GPOS_NEW(mp) CHistogram(mp, buckets2);
+
+	CFlatHistogram *flat1 = CFlatHistogram::Make(mp, buckets1);
+	CFlatHistogram *flat2 = CFlatHistogram::Make(mp, buckets2);
+	GPOS_RTL_ASSERT(flat1->IsMappable() && flat2->IsMappable());
+	GPOS_RTL_ASSERT(flat1->IsComparable(flat2));
+
+	// equality join, merging the buckets as the histogram used to
+	CBucketArray *expected = GPOS_NEW(mp) CBucketArray(mp);
+	CDouble expected_freq1(0.0);
+	CDouble expected_freq2(0.0);
+	ULONG ul1 = 0;
+	ULONG ul2 = 0;
+	while (ul1 < buckets1->Size() && ul2 < buckets2->Size())
+	{
+		CBucket *bucket1 = (*buckets1)[ul1];
+		CBucket *bucket2 = (*buckets2)[ul2];
+		if (bucket1->Intersects(bucket2))
+		{
+			CDouble freq1(0.0);
+			CDouble freq2(0.0);
+			expected->Append(
+				bucket1->MakeBucketIntersect(mp, bucket2, &freq1, &freq2));
+			expected_freq1 = expected_freq1 + freq1;
+			expected_freq2 = expected_freq2 + freq2;
+
+			INT res = CBucket::CompareUpperBounds(bucket1, bucket2);
+			ul1 += (0 >= res) ? 1 : 0;
+			ul2 += (0 <= res) ? 1 : 0;
+		}
+		else if (bucket1->IsBefore(bucket2))
+		{
+			ul1++;
+		}
+		else
+		{
+			ul2++;
+		}
+	}
+
+	CDouble freq1(0.0);
+	CDouble freq2(0.0);
+	CBucketArray *join_buckets =
+		CFlatHistogram::MakeJoinBuckets(mp, flat1, flat2, &freq1, &freq2);
+
+	GPOS_RTL_ASSERT(0 < expected->Size());
+	GPOS_RTL_ASSERT(expected->Size() == join_buckets->Size());
+	GPOS_RTL_ASSERT(expected_freq1 == freq1 && expected_freq2 == freq2);
+	for (ULONG ul = 0; ul < expected->Size(); ul++)
+	{
+		CBucket *bucket = (*join_buckets)[ul];
+		CBucket *expected_bucket = (*expected)[ul];
+		GPOS_RTL_ASSERT(
+			bucket->GetLowerBound()->Equals(expected_bucket->GetLowerBound()));
+		GPOS_RTL_ASSERT(
+			bucket->GetUpperBound()->Equals(expected_bucket->GetUpperBound()));
+		GPOS_RTL_ASSERT(bucket->IsLowerClosed() ==
+							expected_bucket->IsLowerClosed() &&
+						bucket->IsUpperClosed() ==
+							expected_bucket->IsUpperClosed());
+		GPOS_RTL_ASSERT(bucket->GetFrequency() ==
+							expected_bucket->GetFrequency() &&
+						bucket->GetNumDistinct() ==
+							expected_bucket->GetNumDistinct());
+	}
+
+	// lookup of points, against a scan of the buckets
+	for (INT i = -30; i <= 110; i++)
+	{
+		CPoint *point = CTestUtils::PpointInt4(mp, i);
+		ULONG expected_index = gpos::ulong_max;
+		for (ULONG ul = 0; ul < buckets1->Size(); ul++)
+		{
+			if ((*buckets1)[ul]->Contains(point))
+			{
+				expected_index = ul;
+				break;
+			}
+		}
+
+		ULONG bucket_index = 0;
+		GPOS_RTL_ASSERT(flat1->FindBucket(point, &bucket_index));
+		GPOS_RTL_ASSERT(expected_index == bucket_index);
+		point->Release();
+	}
+
+	// the histogram takes the columnar path
+	CHistogram *join_histogram =
+		histogram1->MakeJoinHistogram(CStatsPred::EstatscmptEq, histogram2);
+	CCardinalityTestUtils::PrintHist(mp, "join_histogram", join_histogram);
+	GPOS_RTL_ASSERT(join_histogram->GetNumBuckets() == expected->Size());
+
+	// clean up
+	expected->Release();
+	join_buckets->Release();
+	flat1->Release();
+	flat2->Release();
+	GPOS_DELETE(join_histogram);
+	GPOS_DELETE(histogram1);
+	GPOS_DELETE(histogram2);
+
+	return GPOS_OK;
+}
+
 // EOF
@@ -12,6 +12,7 @@
 
 #include "gpos/error/CAutoTrace.h"
 #include "gpos/io/COstreamString.h"
+#include "gpos/task/CAutoTraceFlag.h"
 #include "gpos/test/CUnittest.h"
 
 #include "gpopt/base/CQueryContext.h"
@@ -20,18 +21,27 @@
 #include "gpopt/operators/CPredicateUtils.h"
 #include "gpopt/operators/ops.h"
 #include "gpopt/xforms/CJoinOrder.h"
+#include "gpopt/xforms/CJoinOrderDPhyp.h"
+#include "gpopt/xforms/CJoinOrderDPv2.h"
 #include "gpopt/xforms/CJoinOrderMinCard.h"
+#include "gpopt/xforms/CXformExpandNAryJoinDPhyp.h"
 
 #include "unittest/base.h"
 #include "unittest/gpopt/CTestUtils.h"
 
 ULONG CJoinOrderTest::m_ulTestCounter = 0;	// start from first test
+ULONG CJoinOrderTest::m_ulDPhypTestCounter = 0;	 // start from first test
 
 // minidump files
 const CHAR *rgszJoinOrderFileNames[] = {
 	"../data/dxl/minidump/JoinOptimizationLevelGreedyNonPartTblInnerJoin.mdp",
 	"../data/dxl/minidump/JoinOptimizationLevelQueryNonPartTblInnerJoin.mdp"};
 
+// minidump files of optimizer_join_order=dphyp; the DPhyp xform is checked
+// to produce a plan, which is not matched against the plan in the file
+const CHAR *rgszJoinOrderDPhypFileNames[] = {
+	"../data/dxl/minidump/SixWayDPhyp.mdp"};
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CJoinOrderTest::EresUnittest
@@ -44,7 +54,12 @@ GPOS_RESULT
 CJoinOrderTest::EresUnittest()
 {
 	CUnittest rgut[] = {GPOS_UNITTEST_FUNC(EresUnittest_ExpandMinCard),
-						GPOS_UNITTEST_FUNC(EresUnittest_RunTests)};
+						GPOS_UNITTEST_FUNC(EresUnittest_ExpandDPhyp),
+						GPOS_UNITTEST_FUNC(EresUnittest_ExpandDPhypLOJ),
+						GPOS_UNITTEST_FUNC(EresUnittest_ExpandDPhypHyperedge),
+						GPOS_UNITTEST_FUNC(EresUnittest_ExpandDPhypFallback),
+						GPOS_UNITTEST_FUNC(EresUnittest_RunTests),
+						GPOS_UNITTEST_FUNC(EresUnittest_RunDPhypTests)};
 
 	return CUnittest::EresExecute(rgut, GPOS_ARRAY_SIZE(rgut));
 }
@@ -135,6 +150,625 @@ CJoinOrderTest::EresUnittest_ExpandMinCard()
 	return GPOS_OK;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		DCostJoinTree
+//
+//	@doc:
+//		Cost of a join tree as DPv2 and DPhyp compute it, the sum of the
+//		rows of every join and atom in the tree, with derived stats. Used
+//		to compare the join orders of both enumerators on the same scale.
+//
+//---------------------------------------------------------------------------
+static CDouble
+DCostJoinTree(CMemoryPool *mp, CExpression *pexpr)
+{
+	GPOS_CHECK_STACK_SIZE;
+
+	COperator::EOperatorId eopid = pexpr->Pop()->Eopid();
+	if (COperator::EopLogicalSelect == eopid)
+	{
+		// predicates left over on top of the joins
+		return DCostJoinTree(mp, (*pexpr)[0]);
+	}
+
+	CDouble dCost(0.0);
+	BOOL fJoin = (COperator::EopLogicalInnerJoin == eopid ||
+				  COperator::EopLogicalLeftOuterJoin == eopid);
+	if (fJoin)
+	{
+		dCost = DCostJoinTree(mp, (*pexpr)[0]) + DCostJoinTree(mp, (*pexpr)[1]);
+	}
+
+	if (NULL == pexpr->Pstats())
+	{
+		CExpressionHandle exprhdl(mp);
+		exprhdl.Attach(pexpr);
+		exprhdl.DeriveStats(mp, mp, NULL /*prprel*/, NULL /*stats_ctxt*/);
+	}
+
+	return dCost + std::max(CDouble(1.0), pexpr->Pstats()->Rows());
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		PexprExpandDPhyp
+//
+//	@doc:
+//		Expand the given atoms and predicates with DPhyp, the same way
+//		CXformExpandNAryJoinDPhyp does, and return the cheapest join order.
+//		The inputs are not consumed.
+//
+//---------------------------------------------------------------------------
+static CExpression *
+PexprExpandDPhyp(CMemoryPool *mp, CExpressionArray *pdrgpexprAtoms,
+				 CExpressionArray *pdrgpexprPred,
+				 CExpressionArray *pdrgpexprOnPred,
+				 ULongPtrArray *childPredIndexes)
+{
+	pdrgpexprAtoms->AddRef();
+	pdrgpexprPred->AddRef();
+	pdrgpexprOnPred->AddRef();
+	if (NULL != childPredIndexes)
+	{
+		childPredIndexes->AddRef();
+	}
+
+	CJoinOrderDPhyp jodphyp(mp, pdrgpexprAtoms, pdrgpexprPred, pdrgpexprOnPred,
+							childPredIndexes);
+	GPOS_RTL_ASSERT(jodphyp.FExpand());
+
+	CExpression *pexprBest = NULL;
+	CExpression *pexprResult = NULL;
+	while (NULL != (pexprResult = jodphyp.GetNextOfTopK()))
+	{
+		{
+			CAutoTrace at(mp);
+			at.Os() << std::endl
+					<< "DPHYP OUTPUT:" << std::endl
+					<< *pexprResult << std::endl;
+		}
+
+		if (NULL == pexprBest)
+		{
+			pexprBest = pexprResult;
+		}
+		else
+		{
+			pexprResult->Release();
+		}
+	}
+	GPOS_RTL_ASSERT(NULL != pexprBest);
+
+	return pexprBest;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		DCostBestDPv2
+//
+//	@doc:
+//		Expand the given atoms and predicates with DPv2, and return the
+//		cost of the cheapest of its join orders. The inputs are not
+//		consumed.
+//
+//---------------------------------------------------------------------------
+static CDouble
+DCostBestDPv2(CMemoryPool *mp, CExpressionArray *pdrgpexprAtoms,
+			  CExpressionArray *pdrgpexprPred,
+			  CExpressionArray *pdrgpexprOnPred,
+			  ULongPtrArray *childPredIndexes)
+{
+	pdrgpexprAtoms->AddRef();
+	pdrgpexprPred->AddRef();
+	pdrgpexprOnPred->AddRef();
+	if (NULL != childPredIndexes)
+	{
+		childPredIndexes->AddRef();
+	}
+
+	CJoinOrderDPv2 jodpv2(mp, pdrgpexprAtoms, pdrgpexprPred, pdrgpexprOnPred,
+						  childPredIndexes, GPOS_NEW(mp) CColRefSet(mp));
+	jodpv2.PexprExpand();
+
+	CDouble dCostBest(0.0);
+	BOOL fFound = false;
+	CExpression *pexprResult = NULL;
+	while (NULL != (pexprResult = jodpv2.GetNextOfTopK()))
+	{
+		CDouble dCost = DCostJoinTree(mp, pexprResult);
+		{
+			CAutoTrace at(mp);
+			at.Os() << std::endl
+					<< "DPV2 OUTPUT, cost " << dCost << ":" << std::endl
+					<< *pexprResult << std::endl;
+		}
+
+		if (!fFound || dCost < dCostBest)
+		{
+			dCostBest = dCost;
+			fFound = true;
+		}
+		pexprResult->Release();
+	}
+	GPOS_RTL_ASSERT(fFound);
+
+	return dCostBest;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CheckCostAgainstDPv2
+//
+//	@doc:
+//		The best join order of DPhyp must cost about as much as the best one
+//		of DPv2. DPhyp estimates the rows of a set from the selectivity of
+//		each predicate, while the costs here come from derived stats, so a
+//		small difference is allowed.
+//
+//---------------------------------------------------------------------------
+static void
+CheckCostAgainstDPv2(CMemoryPool *mp, CExpression *pexprDPhyp,
+					 CDouble dCostDPv2)
+{
+	const DOUBLE dMaxCostRatio = 1.5;
+	CDouble dCostDPhyp = DCostJoinTree(mp, pexprDPhyp);
+
+	{
+		CAutoTrace at(mp);
+		at.Os() << "DPhyp cost: " << dCostDPhyp << ", DPv2 cost: " << dCostDPv2
+				<< std::endl;
+	}
+
+	GPOS_RTL_ASSERT(dCostDPhyp <= dCostDPv2 * CDouble(dMaxCostRatio));
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		PexprFindLOJ
+//
+//	@doc:
+//		Find the left outer join in a join tree, NULL if there is none
+//
+//---------------------------------------------------------------------------
+static CExpression *
+PexprFindLOJ(CExpression *pexpr)
+{
+	GPOS_CHECK_STACK_SIZE;
+
+	if (COperator::EopLogicalLeftOuterJoin == pexpr->Pop()->Eopid())
+	{
+		return pexpr;
+	}
+
+	for (ULONG ul = 0; ul < pexpr->Arity(); ul++)
+	{
+		CExpression *pexprChild = (*pexpr)[ul];
+		if (pexprChild->Pop()->FLogical())
+		{
+			CExpression *pexprLOJ = PexprFindLOJ(pexprChild);
+			if (NULL != pexprLOJ)
+			{
+				return pexprLOJ;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderTest::EresUnittest_ExpandDPhyp
+//
+//	@doc:
+//		Expansion by dynamic programming over the join graph, compared
+//		with DPv2 on a chain of inner joins
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CJoinOrderTest::EresUnittest_ExpandDPhyp()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	// array of relation names
+	CWStringConst rgscRel[] = {
+		GPOS_WSZ_LIT("Rel10"), GPOS_WSZ_LIT("Rel3"),  GPOS_WSZ_LIT("Rel4"),
+		GPOS_WSZ_LIT("Rel6"),  GPOS_WSZ_LIT("Rel7"),  GPOS_WSZ_LIT("Rel8"),
+		GPOS_WSZ_LIT("Rel12"), GPOS_WSZ_LIT("Rel13"), GPOS_WSZ_LIT("Rel5"),
+	};
+
+	// array of relation IDs
+	ULONG rgulRel[] = {
+		GPOPT_TEST_REL_OID10, GPOPT_TEST_REL_OID3,	GPOPT_TEST_REL_OID4,
+		GPOPT_TEST_REL_OID6,  GPOPT_TEST_REL_OID7,	GPOPT_TEST_REL_OID8,
+		GPOPT_TEST_REL_OID12, GPOPT_TEST_REL_OID13, GPOPT_TEST_REL_OID5,
+	};
+
+	const ULONG ulRels = GPOS_ARRAY_SIZE(rgscRel);
+	GPOS_ASSERT(GPOS_ARRAY_SIZE(rgulRel) == ulRels);
+
+	// setup a file-based provider
+	CMDProviderMemory *pmdp = CTestUtils::m_pmdpf;
+	pmdp->AddRef();
+	CMDAccessor mda(mp, CMDCache::Pcache());
+	mda.RegisterProvider(CTestUtils::m_sysidDefault, pmdp);
+
+	{
+		// install opt context in TLS
+		CAutoOptCtxt aoc(mp, &mda, NULL, /* pceeval */
+						 CTestUtils::GetCostModel(mp));
+
+		CExpression *pexprNAryJoin = CTestUtils::PexprLogicalNAryJoin(
+			mp, rgscRel, rgulRel, ulRels, false /*fCrossProduct*/);
+
+		// derive stats on input expression
+		CExpressionHandle exprhdl(mp);
+		exprhdl.Attach(pexprNAryJoin);
+		exprhdl.DeriveStats(mp, mp, NULL /*prprel*/, NULL /*stats_ctxt*/);
+
+		CExpressionArray *pdrgpexpr = GPOS_NEW(mp) CExpressionArray(mp);
+		for (ULONG ul = 0; ul < ulRels; ul++)
+		{
+			CExpression *pexprChild = (*pexprNAryJoin)[ul];
+			pexprChild->AddRef();
+			pdrgpexpr->Append(pexprChild);
+		}
+		CExpressionArray *pdrgpexprPred =
+			CPredicateUtils::PdrgpexprConjuncts(mp, (*pexprNAryJoin)[ulRels]);
+		CExpressionArray *pdrgpexprOnPred = GPOS_NEW(mp) CExpressionArray(mp);
+
+		CExpression *pexprDPhyp =
+			PexprExpandDPhyp(mp, pdrgpexpr, pdrgpexprPred, pdrgpexprOnPred,
+							 NULL /*childPredIndexes*/);
+
+		// every predicate of the chain is a join predicate
+		GPOS_RTL_ASSERT(COperator::EopLogicalInnerJoin ==
+						pexprDPhyp->Pop()->Eopid());
+
+		CheckCostAgainstDPv2(
+			mp, pexprDPhyp,
+			DCostBestDPv2(mp, pdrgpexpr, pdrgpexprPred, pdrgpexprOnPred,
+						  NULL /*childPredIndexes*/));
+
+		pexprDPhyp->Release();
+		pexprNAryJoin->Release();
+		pdrgpexpr->Release();
+		pdrgpexprPred->Release();
+		pdrgpexprOnPred->Release();
+	}
+
+	return GPOS_OK;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderTest::EresUnittest_ExpandDPhypLOJ
+//
+//	@doc:
+//		DPhyp on a chain whose last atom is the right child of a left outer
+//		join: the ON predicate is a hyperedge, and the right child is only
+//		joined on its own, as the inner side of its LOJ
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CJoinOrderTest::EresUnittest_ExpandDPhypLOJ()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	// array of relation names
+	CWStringConst rgscRel[] = {
+		GPOS_WSZ_LIT("Rel10"),
+		GPOS_WSZ_LIT("Rel3"),
+		GPOS_WSZ_LIT("Rel4"),
+		GPOS_WSZ_LIT("Rel6"),
+		GPOS_WSZ_LIT("Rel7"),
+	};
+
+	// array of relation IDs
+	ULONG rgulRel[] = {
+		GPOPT_TEST_REL_OID10, GPOPT_TEST_REL_OID3, GPOPT_TEST_REL_OID4,
+		GPOPT_TEST_REL_OID6,  GPOPT_TEST_REL_OID7,
+	};
+
+	const ULONG ulRels = GPOS_ARRAY_SIZE(rgscRel);
+	GPOS_ASSERT(GPOS_ARRAY_SIZE(rgulRel) == ulRels);
+
+	// setup a file-based provider
+	CMDProviderMemory *pmdp = CTestUtils::m_pmdpf;
+	pmdp->AddRef();
+	CMDAccessor mda(mp, CMDCache::Pcache());
+	mda.RegisterProvider(CTestUtils::m_sysidDefault, pmdp);
+
+	{
+		// install opt context in TLS
+		CAutoOptCtxt aoc(mp, &mda, NULL, /* pceeval */
+						 CTestUtils::GetCostModel(mp));
+
+		CExpression *pexprNAryJoin = CTestUtils::PexprLogicalNAryJoin(
+			mp, rgscRel, rgulRel, ulRels, false /*fCrossProduct*/);
+
+		CExpressionArray *pdrgpexpr = GPOS_NEW(mp) CExpressionArray(mp);
+		for (ULONG ul = 0; ul < ulRels; ul++)
+		{
+			CExpression *pexprChild = (*pexprNAryJoin)[ul];
+			pexprChild->AddRef();
+			pdrgpexpr->Append(pexprChild);
+		}
+
+		// the predicate between the last two atoms becomes the ON predicate
+		// of LOJ 1, whose right child is the last atom
+		CExpressionArray *pdrgpexprChain =
+			CPredicateUtils::PdrgpexprConjuncts(mp, (*pexprNAryJoin)[ulRels]);
+		GPOS_ASSERT(ulRels - 1 == pdrgpexprChain->Size());
+
+		CExpressionArray *pdrgpexprPred = GPOS_NEW(mp) CExpressionArray(mp);
+		CExpressionArray *pdrgpexprOnPred = GPOS_NEW(mp) CExpressionArray(mp);
+		ULongPtrArray *childPredIndexes = GPOS_NEW(mp) ULongPtrArray(mp);
+		for (ULONG ul = 0; ul < ulRels - 1; ul++)
+		{
+			CExpression *pexprPred = (*pdrgpexprChain)[ul];
+			pexprPred->AddRef();
+			if (ul < ulRels - 2)
+			{
+				pdrgpexprPred->Append(pexprPred);
+			}
+			else
+			{
+				pdrgpexprOnPred->Append(pexprPred);
+			}
+			childPredIndexes->Append(GPOS_NEW(mp) ULONG(0));
+		}
+		childPredIndexes->Append(GPOS_NEW(mp) ULONG(1));
+
+		CExpression *pexprDPhyp = PexprExpandDPhyp(
+			mp, pdrgpexpr, pdrgpexprPred, pdrgpexprOnPred, childPredIndexes);
+
+		// the right child of the LOJ is the last atom on its own, and the
+		// outer side produces the atom the ON predicate refers to
+		CExpression *pexprLOJ = PexprFindLOJ(pexprDPhyp);
+		GPOS_RTL_ASSERT(NULL != pexprLOJ);
+		GPOS_RTL_ASSERT((*pdrgpexpr)[ulRels - 1] == (*pexprLOJ)[1]);
+		GPOS_RTL_ASSERT((*pexprLOJ)[0]->DeriveOutputColumns()->ContainsAll(
+			(*pdrgpexpr)[ulRels - 2]->DeriveOutputColumns()));
+
+		CheckCostAgainstDPv2(mp, pexprDPhyp,
+							 DCostBestDPv2(mp, pdrgpexpr, pdrgpexprPred,
+										   pdrgpexprOnPred, childPredIndexes));
+
+		pexprDPhyp->Release();
+		pexprNAryJoin->Release();
+		pdrgpexpr->Release();
+		pdrgpexprChain->Release();
+		pdrgpexprPred->Release();
+		pdrgpexprOnPred->Release();
+		childPredIndexes->Release();
+	}
+
+	return GPOS_OK;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderTest::EresUnittest_ExpandDPhypHyperedge
+//
+//	@doc:
+//		DPhyp on two pairs of atoms that are only connected by a predicate
+//		on three atoms, a hyperedge
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CJoinOrderTest::EresUnittest_ExpandDPhypHyperedge()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	// array of relation names
+	CWStringConst rgscRel[] = {
+		GPOS_WSZ_LIT("Rel10"),
+		GPOS_WSZ_LIT("Rel3"),
+		GPOS_WSZ_LIT("Rel4"),
+		GPOS_WSZ_LIT("Rel6"),
+	};
+
+	// array of relation IDs
+	ULONG rgulRel[] = {
+		GPOPT_TEST_REL_OID10,
+		GPOPT_TEST_REL_OID3,
+		GPOPT_TEST_REL_OID4,
+		GPOPT_TEST_REL_OID6,
+	};
+
+	const ULONG ulRels = GPOS_ARRAY_SIZE(rgscRel);
+	GPOS_ASSERT(GPOS_ARRAY_SIZE(rgulRel) == ulRels);
+
+	// setup a file-based provider
+	CMDProviderMemory *pmdp = CTestUtils::m_pmdpf;
+	pmdp->AddRef();
+	CMDAccessor mda(mp, CMDCache::Pcache());
+	mda.RegisterProvider(CTestUtils::m_sysidDefault, pmdp);
+
+	{
+		// install opt context in TLS
+		CAutoOptCtxt aoc(mp, &mda, NULL, /* pceeval */
+						 CTestUtils::GetCostModel(mp));
+
+		CExpression *pexprNAryJoin = CTestUtils::PexprLogicalNAryJoin(
+			mp, rgscRel, rgulRel, ulRels, false /*fCrossProduct*/);
+
+		CExpressionArray *pdrgpexpr = GPOS_NEW(mp) CExpressionArray(mp);
+		for (ULONG ul = 0; ul < ulRels; ul++)
+		{
+			CExpression *pexprChild = (*pexprNAryJoin)[ul];
+			pexprChild->AddRef();
+			pdrgpexpr->Append(pexprChild);
+		}
+
+		// keep the predicates of the first and the last pair of atoms, and
+		// connect the pairs with (a0 = a2 OR a1 = a2), on three atoms
+		CExpressionArray *pdrgpexprChain =
+			CPredicateUtils::PdrgpexprConjuncts(mp, (*pexprNAryJoin)[ulRels]);
+		GPOS_ASSERT(ulRels - 1 == pdrgpexprChain->Size());
+
+		CColRef *pcr0 = (*pdrgpexpr)[0]->DeriveOutputColumns()->PcrAny();
+		CColRef *pcr1 = (*pdrgpexpr)[1]->DeriveOutputColumns()->PcrAny();
+		CColRef *pcr2 = (*pdrgpexpr)[2]->DeriveOutputColumns()->PcrAny();
+		CExpressionArray *pdrgpexprDisjuncts =
+			GPOS_NEW(mp) CExpressionArray(mp);
+		pdrgpexprDisjuncts->Append(CUtils::PexprScalarEqCmp(mp, pcr0, pcr2));
+		pdrgpexprDisjuncts->Append(CUtils::PexprScalarEqCmp(mp, pcr1, pcr2));
+
+		CExpressionArray *pdrgpexprPred = GPOS_NEW(mp) CExpressionArray(mp);
+		(*pdrgpexprChain)[0]->AddRef();
+		pdrgpexprPred->Append((*pdrgpexprChain)[0]);
+		pdrgpexprPred->Append(
+			CPredicateUtils::PexprDisjunction(mp, pdrgpexprDisjuncts));
+		(*pdrgpexprChain)[2]->AddRef();
+		pdrgpexprPred->Append((*pdrgpexprChain)[2]);
+		CExpressionArray *pdrgpexprOnPred = GPOS_NEW(mp) CExpressionArray(mp);
+
+		CExpression *pexprDPhyp =
+			PexprExpandDPhyp(mp, pdrgpexpr, pdrgpexprPred, pdrgpexprOnPred,
+							 NULL /*childPredIndexes*/);
+
+		// the hyperedge joins the two pairs, no predicate is left over
+		GPOS_RTL_ASSERT(COperator::EopLogicalInnerJoin ==
+						pexprDPhyp->Pop()->Eopid());
+
+		pexprDPhyp->Release();
+		pexprNAryJoin->Release();
+		pdrgpexpr->Release();
+		pdrgpexprChain->Release();
+		pdrgpexprPred->Release();
+		pdrgpexprOnPred->Release();
+	}
+
+	return GPOS_OK;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CJoinOrderTest::EresUnittest_ExpandDPhypFallback
+//
+//	@doc:
+//		DPhyp finds no join order for a disconnected join graph, and
+//		CXformExpandNAryJoinDPhyp falls back to DPv2 for it
+//
+//---------------------------------------------------------------------------
+GPOS_RESULT
+CJoinOrderTest::EresUnittest_ExpandDPhypFallback()
+{
+	CAutoMemoryPool amp;
+	CMemoryPool *mp = amp.Pmp();
+
+	// array of relation names
+	CWStringConst rgscRel[] = {
+		GPOS_WSZ_LIT("Rel10"),
+		GPOS_WSZ_LIT("Rel3"),
+		GPOS_WSZ_LIT("Rel4"),
+		GPOS_WSZ_LIT("Rel6"),
+	};
+
+	// array of relation IDs
+	ULONG rgulRel[] = {
+		GPOPT_TEST_REL_OID10,
+		GPOPT_TEST_REL_OID3,
+		GPOPT_TEST_REL_OID4,
+		GPOPT_TEST_REL_OID6,
+	};
+
+	const ULONG ulRels = GPOS_ARRAY_SIZE(rgscRel);
+	GPOS_ASSERT(GPOS_ARRAY_SIZE(rgulRel) == ulRels);
+
+	// setup a file-based provider
+	CMDProviderMemory *pmdp = CTestUtils::m_pmdpf;
+	pmdp->AddRef();
+	CMDAccessor mda(mp, CMDCache::Pcache());
+	mda.RegisterProvider(CTestUtils::m_sysidDefault, pmdp);
+
+	{
+		// install opt context in TLS
+		CAutoOptCtxt aoc(mp, &mda, NULL, /* pceeval */
+						 CTestUtils::GetCostModel(mp));
+
+		// the xform is only promising with optimizer_join_order=dphyp
+		CAutoTraceFlag atf(EopttraceEnableDPhypJoinOrder, true /*value*/);
+
+		CExpression *pexprNAryJoin = CTestUtils::PexprLogicalNAryJoin(
+			mp, rgscRel, rgulRel, ulRels, false /*fCrossProduct*/);
+
+		// drop the predicate in the middle of the chain, leaving two
+		// connected pairs of atoms
+		CExpressionArray *pdrgpexprChain =
+			CPredicateUtils::PdrgpexprConjuncts(mp, (*pexprNAryJoin)[ulRels]);
+		GPOS_ASSERT(ulRels - 1 == pdrgpexprChain->Size());
+
+		CExpressionArray *pdrgpexprPred = GPOS_NEW(mp) CExpressionArray(mp);
+		(*pdrgpexprChain)[0]->AddRef();
+		pdrgpexprPred->Append((*pdrgpexprChain)[0]);
+		(*pdrgpexprChain)[2]->AddRef();
+		pdrgpexprPred->Append((*pdrgpexprChain)[2]);
+
+		CExpressionArray *pdrgpexpr = GPOS_NEW(mp) CExpressionArray(mp);
+		for (ULONG ul = 0; ul < ulRels; ul++)
+		{
+			CExpression *pexprChild = (*pexprNAryJoin)[ul];
+			pexprChild->AddRef();
+			pdrgpexpr->Append(pexprChild);
+		}
+
+		{
+			pdrgpexpr->AddRef();
+			pdrgpexprPred->AddRef();
+			CJoinOrderDPhyp jodphyp(mp, pdrgpexpr, pdrgpexprPred,
+									GPOS_NEW(mp) CExpressionArray(mp),
+									NULL /*childPredIndexes*/);
+			GPOS_RTL_ASSERT(!jodphyp.FExpand());
+		}
+
+		// the same join through the xform
+		pdrgpexpr->AddRef();
+		pdrgpexpr->Append(CPredicateUtils::PexprConjunction(mp, pdrgpexprPred));
+		CExpression *pexprDisconnected =
+			CTestUtils::PexprLogicalNAryJoin(mp, pdrgpexpr);
+
+		CExpressionHandle exprhdl(mp);
+		exprhdl.Attach(pexprDisconnected);
+		exprhdl.DeriveStats(mp, mp, NULL /*prprel*/, NULL /*stats_ctxt*/);
+
+		CXformContext *pxfctxt = GPOS_NEW(mp) CXformContext(mp);
+		CXformResult *pxfres = GPOS_NEW(mp) CXformResult(mp);
+		CXformExpandNAryJoinDPhyp *pxform =
+			GPOS_NEW(mp) CXformExpandNAryJoinDPhyp(mp);
+
+		pxform->Transform(pxfctxt, pxfres, pexprDisconnected);
+
+		// the join orders come from DPv2
+		ULONG ulResults = 0;
+		CExpression *pexprResult = NULL;
+		while (NULL != (pexprResult = pxfres->PexprNext()))
+		{
+			CAutoTrace at(mp);
+			at.Os() << std::endl
+					<< "FALLBACK OUTPUT:" << std::endl
+					<< *pexprResult << std::endl;
+			ulResults++;
+		}
+		GPOS_RTL_ASSERT(0 < ulResults);
+
+		pxform->Release();
+		pxfres->Release();
+		pxfctxt->Release();
+		pexprDisconnected->Release();
+		pexprNAryJoin->Release();
+		pdrgpexprChain->Release();
+	}
+
+	return GPOS_OK;
+}
+
 //	run all Minidump-based tests with plan matching
 GPOS_RESULT
 CJoinOrderTest::EresUnittest_RunTests()
@@ -143,4 +777,15 @@ CJoinOrderTest::EresUnittest_RunTests()
 		rgszJoinOrderFileNames, &m_ulTestCounter,
 		GPOS_ARRAY_SIZE(rgszJoinOrderFileNames));
 }
+
+//	run the minidump tests of optimizer_join_order=dphyp; their plans are
+//	not matched, see rgszJoinOrderDPhypFileNames
+GPOS_RESULT
+CJoinOrderTest::EresUnittest_RunDPhypTests()
+{
+	return CTestUtils::EresUnittest_RunTestsWithoutAdditionalTraceFlags(
+		rgszJoinOrderDPhypFileNames, &m_ulDPhypTestCounter,
+		GPOS_ARRAY_SIZE(rgszJoinOrderDPhypFileNames), false /*fMatchPlans*/,
+		true /*fTestSpacePruning*/);
+}
 // EOF
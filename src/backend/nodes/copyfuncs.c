@@ -137,6 +137,7 @@ _copyPlannedStmt(const PlannedStmt *from)
 
 	COPY_SCALAR_FIELD(total_memory_master);
 	COPY_SCALAR_FIELD(nsegments_master);
+	/* optimizerProfile is not copied */
 
 	return newnode;
 }
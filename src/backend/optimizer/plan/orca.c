@@ -30,11 +30,14 @@
 #include "optimizer/planner.h"
 #include "optimizer/transform.h"
 #include "portability/instr_time.h"
+#include "utils/cardfeedback.h"
 #include "utils/guc.h"
 #include "utils/lsyscache.h"
 
 /* GPORCA entry point */
-extern PlannedStmt * GPOPTOptimizedPlan(Query *parse, bool *had_unexpected_failure);
+extern PlannedStmt * GPOPTOptimizedPlan(Query *parse, bool *had_unexpected_failure,
+										MemoryContext profile_context,
+										OptimizerProfile **profile);
 
 /*
  * Logging of optimization outcome
@@ -89,6 +92,8 @@ optimize_query(Query *parse, ParamListInfo boundParams)
 	List		   *invalItems;
 	ListCell	   *lc;
 	ListCell	   *lp;
+	MemoryContext profile_context = NULL;
+	OptimizerProfile *profile = NULL;
 
 	/*
 	 * Initialize a dummy PlannerGlobal struct. ORCA doesn't use it, but the
@@ -134,8 +139,22 @@ optimize_query(Query *parse, ParamListInfo boundParams)
 	 */
 	pqueryCopy = fold_constants(root, pqueryCopy, boundParams, GPOPT_MAX_FOLDED_CONSTANT_SIZE);
 
+	/*
+	 * The profile is allocated in the same memory as the plan, and kept
+	 * with it, so that EXPLAIN shows the profile of the plan it explains.
+	 */
+	if (optimizer_collect_profile)
+		profile_context = CurrentMemoryContext;
+
 	/* Ok, invoke ORCA. */
-	result = GPOPTOptimizedPlan(pqueryCopy, &fUnexpectedFailure);
+	result = GPOPTOptimizedPlan(pqueryCopy, &fUnexpectedFailure,
+								profile_context, &profile);
+
+	if (result)
+		result->optimizerProfile = profile;
+
+	/* remember the cardinality feedback the plan was optimized with */
+	CardinalityFeedbackPlanned(result);
 
 	log_optimizer(result, fUnexpectedFailure);
 
@@ -873,6 +873,26 @@ BufFileSeekBlock(BufFile *file, int64 blknum)
 	return BufFileSeek(file, 0 /* fileno */, blknum * BLCKSZ, SEEK_SET);
 }
 
+/*
+ * BufFilePrefetchBlocks
+ *
+ * Initiate an asynchronous read of nblocks blocks starting at blknum, so
+ * that a later BufFileRead of them need not wait for the disk.  The logical
+ * position is not moved.
+ *
+ * The block numbers of a compressed file do not map to its physical offsets,
+ * so nothing is prefetched for those.
+ */
+void
+BufFilePrefetchBlocks(BufFile *file, int64 blknum, int nblocks)
+{
+	if (file->state == BFS_COMPRESSED_WRITING ||
+		file->state == BFS_COMPRESSED_READING)
+		return;
+
+	(void) FilePrefetch(file->file, blknum * BLCKSZ, nblocks * BLCKSZ);
+}
+
 /*
  * BufFileUpdateSize
  *
@@ -16,6 +16,7 @@
 
 #include <signal.h>
 
+#include "access/aocs_zonemap.h"
 #include "access/clog.h"
 #include "access/heapam.h"
 #include "access/multixact.h"
@@ -50,8 +51,10 @@
 #include "storage/sinvaladt.h"
 #include "storage/spin.h"
 #include "utils/backend_cancel.h"
+#include "utils/cardfeedback.h"
 #include "utils/resource_manager.h"
 #include "utils/faultinjector.h"
+#include "utils/sharedmdcache.h"
 #include "utils/sharedsnapshot.h"
 #include "utils/gpexpand.h"
 
@@ -220,6 +223,15 @@ CreateSharedMemoryAndSemaphores(int port)
 		/* size of pending deletes */
 		size = add_size(size, PdlShmemSize());
 
+		/* size of shared GPORCA metadata cache */
+		size = add_size(size, SharedMDCacheShmemSize());
+
+		/* size of shared AOCS zone map cache */
+		size = add_size(size, AOCSZoneMapShmemSize());
+
+		/* size of GPORCA cardinality feedback */
+		size = add_size(size, CardinalityFeedbackShmemSize());
+
 		elog(DEBUG3, "invoking IpcMemoryCreate(size=%zu)", size);
 
 		/*
@@ -394,6 +406,12 @@ CreateSharedMemoryAndSemaphores(int port)
 
 	PdlShmemInit();
 
+	SharedMDCacheShmemInit();
+
+	AOCSZoneMapShmemInit();
+
+	CardinalityFeedbackShmemInit();
+
 	/*
 	 * Now give loadable modules a chance to set up their shmem allocations
 	 */
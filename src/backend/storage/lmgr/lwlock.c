@@ -282,6 +282,15 @@ NumLWLocks(void)
 	/* storage_pending_deletes.c needs one for each backend */
 	numLocks += MaxBackends;
 
+	/* sharedmdcache.c needs one lock */
+	numLocks++;
+
+	/* aocs_zonemap.c needs one lock */
+	numLocks++;
+
+	/* cardfeedback.c needs one lock */
+	numLocks++;
+
 	return numLocks;
 }
 
@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#include "access/aocs_zonemap.h"
 #include "access/aomd.h"
 #include "access/appendonlywriter.h"
 #include "access/htup_details.h"
@@ -459,6 +460,10 @@ mdunlink(RelFileNodeBackend rnode, ForkNumber forkNum, bool isRedo, char relstor
 		 !relstorage_is_ao(relstorage)))
 		ForgetRelationFsyncRequests(rnode.node, forkNum);
 
+	/* Forget the zone maps of the blocks of the doomed relation */
+	if (relstorage_is_ao(relstorage))
+		AOCSZoneMapInvalidateRelation(rnode.node);
+
 	/* Now do the per-fork work */
 	if (forkNum == InvalidForkNumber)
 	{
@@ -8,11 +8,14 @@
  *
  * gp_opt_version: This function wraps LibraryVersion. 
  *
+ * gp_optimizer_plan_cache_stats: This function wraps GetPlanCacheStats.
+ *
  * Copyright(c) 2012 - present, EMC/Greenplum
  */
 
 #include "postgres.h"
 
+#include "access/htup_details.h"
 #include "funcapi.h"
 #include "utils/builtins.h"
 
@@ -60,3 +63,39 @@ gp_opt_version(PG_FUNCTION_ARGS __attribute__((unused)))
 	return CStringGetTextDatum("Server has been compiled without ORCA");
 #endif
 }
+
+extern void GetPlanCacheStats(int64 *entries, int64 *hits, int64 *misses,
+							  int64 *evictions, int64 *invalidations);
+
+/*
+ * Returns the counters of the optimizer's plan cache in the current backend.
+ */
+Datum
+gp_optimizer_plan_cache_stats(PG_FUNCTION_ARGS)
+{
+	TupleDesc	tupdesc;
+	Datum		values[5];
+	bool		nulls[5];
+	int64		entries = 0;
+	int64		hits = 0;
+	int64		misses = 0;
+	int64		evictions = 0;
+	int64		invalidations = 0;
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+#ifdef USE_ORCA
+	GetPlanCacheStats(&entries, &hits, &misses, &evictions, &invalidations);
+#endif
+
+	MemSet(nulls, 0, sizeof(nulls));
+	values[0] = Int64GetDatum(entries);
+	values[1] = Int64GetDatum(hits);
+	values[2] = Int64GetDatum(misses);
+	values[3] = Int64GetDatum(evictions);
+	values[4] = Int64GetDatum(invalidations);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(BlessTupleDesc(tupdesc),
+													  values, nulls)));
+}
@@ -0,0 +1,1405 @@
+/*-------------------------------------------------------------------------
+ *
+ * cardfeedback.c
+ *	  Cardinality feedback from executed plans to GPORCA.
+ *
+ * GPORCA estimates the selectivity of a conjunction of predicates, and of a
+ * join, by combining the histograms of the columns involved with damping
+ * factors.  When the columns are correlated, the estimates can be off by
+ * orders of magnitude, which leads to broadcasting the wrong side of a
+ * join and the like.  This module keeps the ratio between the actual and
+ * the estimated number of rows of the scans and joins of GPORCA plans run
+ * under EXPLAIN ANALYZE, and hands the ratios back to GPORCA as correction
+ * factors when it optimizes another query on the same tables.
+ *
+ * An observation is keyed by a signature of the predicate it was made for
+ * (see CardinalityFeedbackSignature): the columns a scan filters on and
+ * how it compares them, or the equality conditions of an inner join.  The
+ * values of constants are not part of the signature, so a factor learned
+ * for "a = 1 AND b = 2" applies to "a = 3 AND b = 4" as well, but not to
+ * "a < 3 AND b = 4" or "a = b".  For every signature we keep the geometric
+ * mean of the observed ratios, with older observations decaying
+ * exponentially.
+ *
+ * The ratios are taken against GPORCA's estimate before it applied the
+ * correction factor, so that a factor does not feed back into itself.  To
+ * know which factors a plan was optimized with, the factors handed to
+ * GPORCA are remembered with the plan it returns, until the end of the
+ * command (see CardinalityFeedbackPlanned()).  Plans that were not
+ * optimized by the current command are not observed.
+ *
+ * Only nodes that ran once in every worker, and are not below a Limit or
+ * next to an empty join input, are observed, since the executor may have
+ * stopped the others early.  Scans of replicated tables are not observed
+ * either, because every segment returns all of their rows.
+ *
+ * The feedback is kept in a hash table in shared memory, with room for
+ * optimizer_cardinality_feedback_size signatures.  When it is full, the
+ * signature updated least recently is evicted.  Like pg_stat_statements,
+ * the postmaster saves the table to a file at shutdown, and loads it back
+ * at startup.  The feedback on a table is forgotten when the table is
+ * analyzed, truncated or dropped, since it was learned from the old
+ * statistics or contents, and the oid may be reused.
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ *	  src/backend/utils/cache/cardfeedback.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <math.h>
+#include <unistd.h>
+
+#include "catalog/gp_policy.h"
+#include "catalog/pg_type.h"
+#include "cdb/cdbexplain.h"
+#include "cdb/cdbvars.h"
+#include "executor/execdesc.h"
+#include "executor/executor.h"
+#include "funcapi.h"
+#include "lib/stringinfo.h"
+#include "miscadmin.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "parser/parsetree.h"
+#include "pgstat.h"
+#include "storage/fd.h"
+#include "storage/ipc.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/array.h"
+#include "utils/builtins.h"
+#include "utils/cardfeedback.h"
+#include "utils/hsearch.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/timestamp.h"
+
+/* GUC: apply and collect cardinality feedback */
+bool		optimizer_cardinality_feedback = false;
+
+/* GUC: number of signatures kept, 0 disables the feedback */
+int			optimizer_cardinality_feedback_size = 1024;
+
+/* file the feedback is saved to while the server is down */
+#define CARDFEEDBACK_DUMP_FILE	PGSTAT_STAT_PERMANENT_DIRECTORY "/gp_cardinality_feedback.stat"
+
+/* magic number identifying the file format */
+static const uint32 CARDFEEDBACK_FILE_HEADER = 0x47434602;
+
+/*
+ * The first CARDFEEDBACK_WINDOW observations of a signature weigh the same;
+ * after that, a new observation weighs 1 / CARDFEEDBACK_WINDOW.
+ */
+#define CARDFEEDBACK_WINDOW		4
+
+/* observed ratios are clamped to [1 / CARDFEEDBACK_MAX_RATIO, CARDFEEDBACK_MAX_RATIO] */
+#define CARDFEEDBACK_MAX_RATIO	1e6
+
+typedef struct CardFeedbackEntry
+{
+	CardinalityFeedbackSignature key;	/* hash key, must be first */
+	double		log_factor;		/* smoothed log of actual / estimated rows */
+	int64		nobservations;	/* number of observations */
+	double		last_estimate;	/* uncorrected estimate of the last one */
+	double		last_actual;	/* actual rows of the last one */
+	TimestampTz last_update;	/* time of the last one */
+} CardFeedbackEntry;
+
+typedef struct CardFeedbackControl
+{
+	LWLock	   *lock;			/* protects the hash table */
+} CardFeedbackControl;
+
+static CardFeedbackControl *CardFeedback = NULL;
+static HTAB *CardFeedbackHash = NULL;
+
+/* the factors a plan was optimized with */
+typedef struct CardFeedbackPlanFactors
+{
+	PlannedStmt *stmt;			/* NULL until the plan is known */
+	int			nfactors;
+	CardinalityFeedbackFactor *factors;
+} CardFeedbackPlanFactors;
+
+/*
+ * Factors handed to GPORCA for the query it is optimizing, and the factors
+ * of the plans optimized by the current command.  Allocated in
+ * CardFeedbackContext, which is reset at the start of every command.
+ */
+static MemoryContext CardFeedbackContext = NULL;
+static int	CardFeedbackCommandCount = -1;
+static CardFeedbackPlanFactors *CardFeedbackPending = NULL;
+static List *CardFeedbackPlans = NIL;
+
+/* an observation of an executed plan node */
+typedef struct CardFeedbackObservation
+{
+	CardinalityFeedbackSignature sig;
+	double		estimate;		/* uncorrected estimate */
+	double		actual;
+} CardFeedbackObservation;
+
+/* state of the walk over an executed plan */
+typedef struct CardFeedbackCapture
+{
+	List	   *rtable;
+	CardFeedbackPlanFactors *applied;	/* factors the plan was optimized with */
+	List	   *observations;
+} CardFeedbackCapture;
+
+static void cardfeedback_shmem_shutdown(int code, Datum arg);
+static void cardfeedback_load(void);
+static void cardfeedback_start_command(void);
+static bool cardfeedback_relids_walker(Node *node, List **relids);
+static CdbVisitOpt cardfeedback_walker(PlanState *planstate, void *context);
+static void cardfeedback_observe(CardFeedbackCapture *capture,
+					 CardinalityFeedbackSignature *sig,
+					 double estimate, double actual);
+static void cardfeedback_store(List *observations);
+static void cardfeedback_evict(void);
+
+/*
+ * Calculate shmem size for the cardinality feedback.
+ */
+Size
+CardinalityFeedbackShmemSize(void)
+{
+	Size		size;
+
+	if (optimizer_cardinality_feedback_size <= 0)
+		return 0;
+
+	size = MAXALIGN(sizeof(CardFeedbackControl));
+	size = add_size(size, hash_estimate_size(optimizer_cardinality_feedback_size,
+											 sizeof(CardFeedbackEntry)));
+
+	return size;
+}
+
+/*
+ * Initialize the cardinality feedback, and load the feedback saved at the
+ * last shutdown.
+ */
+void
+CardinalityFeedbackShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
+
+	if (optimizer_cardinality_feedback_size <= 0)
+		return;
+
+	CardFeedback = (CardFeedbackControl *)
+		ShmemInitStruct("Cardinality feedback",
+						sizeof(CardFeedbackControl),
+						&found);
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(CardinalityFeedbackSignature);
+	info.entrysize = sizeof(CardFeedbackEntry);
+	info.hash = tag_hash;
+
+	CardFeedbackHash = ShmemInitHash("Cardinality feedback hash",
+									 optimizer_cardinality_feedback_size,
+									 optimizer_cardinality_feedback_size,
+									 &info,
+									 HASH_ELEM | HASH_FUNCTION |
+									 HASH_FIXED_SIZE);
+
+	/* in the postmaster, save the feedback at shutdown */
+	if (!IsUnderPostmaster)
+		on_shmem_exit(cardfeedback_shmem_shutdown, (Datum) 0);
+
+	if (found)
+		return;
+
+	CardFeedback->lock = LWLockAssign();
+
+	cardfeedback_load();
+}
+
+/*
+ * Load the feedback saved at the last shutdown.  No other process is
+ * running yet, so there is no need to lock.
+ */
+static void
+cardfeedback_load(void)
+{
+	FILE	   *file;
+	uint32		header;
+	int32		num;
+	int			i;
+
+	file = AllocateFile(CARDFEEDBACK_DUMP_FILE, PG_BINARY_R);
+	if (file == NULL)
+	{
+		if (errno == ENOENT)
+			return;
+		goto read_error;
+	}
+
+	if (fread(&header, sizeof(uint32), 1, file) != 1 ||
+		fread(&num, sizeof(int32), 1, file) != 1)
+		goto read_error;
+
+	if (header != CARDFEEDBACK_FILE_HEADER)
+		goto data_error;
+
+	for (i = 0; i < num; i++)
+	{
+		CardFeedbackEntry temp;
+		CardFeedbackEntry *entry;
+
+		if (fread(&temp, sizeof(CardFeedbackEntry), 1, file) != 1)
+			goto read_error;
+
+		/* the table may have been made smaller since */
+		if (hash_get_num_entries(CardFeedbackHash) >=
+			optimizer_cardinality_feedback_size)
+			break;
+
+		entry = (CardFeedbackEntry *) hash_search(CardFeedbackHash,
+												  &temp.key,
+												  HASH_ENTER_NULL, NULL);
+		if (entry == NULL)
+			break;
+		memcpy(entry, &temp, sizeof(CardFeedbackEntry));
+	}
+
+	FreeFile(file);
+
+	/* the file is written again at the next shutdown */
+	unlink(CARDFEEDBACK_DUMP_FILE);
+
+	return;
+
+read_error:
+	ereport(LOG,
+			(errcode_for_file_access(),
+			 errmsg("could not read file \"%s\": %m",
+					CARDFEEDBACK_DUMP_FILE)));
+	goto fail;
+data_error:
+	ereport(LOG,
+			(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			 errmsg("ignoring invalid data in file \"%s\"",
+					CARDFEEDBACK_DUMP_FILE)));
+fail:
+	if (file)
+		FreeFile(file);
+	unlink(CARDFEEDBACK_DUMP_FILE);
+}
+
+/*
+ * on_shmem_exit hook of the postmaster: save the feedback to a file.  No
+ * other process is running any more, so there is no need to lock.
+ */
+static void
+cardfeedback_shmem_shutdown(int code, Datum arg)
+{
+	FILE	   *file;
+	HASH_SEQ_STATUS status;
+	CardFeedbackEntry *entry;
+	int32		num;
+
+	/* don't save the feedback after a crash */
+	if (code)
+		return;
+
+	if (CardFeedback == NULL || CardFeedbackHash == NULL)
+		return;
+
+	num = hash_get_num_entries(CardFeedbackHash);
+	if (num == 0)
+		return;
+
+	file = AllocateFile(CARDFEEDBACK_DUMP_FILE ".tmp", PG_BINARY_W);
+	if (file == NULL)
+		goto error;
+
+	if (fwrite(&CARDFEEDBACK_FILE_HEADER, sizeof(uint32), 1, file) != 1 ||
+		fwrite(&num, sizeof(int32), 1, file) != 1)
+		goto error;
+
+	hash_seq_init(&status, CardFeedbackHash);
+	while ((entry = (CardFeedbackEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (fwrite(entry, sizeof(CardFeedbackEntry), 1, file) != 1)
+		{
+			hash_seq_term(&status);
+			goto error;
+		}
+	}
+
+	if (FreeFile(file))
+	{
+		file = NULL;
+		goto error;
+	}
+
+	(void) durable_rename(CARDFEEDBACK_DUMP_FILE ".tmp",
+						  CARDFEEDBACK_DUMP_FILE, LOG);
+
+	return;
+
+error:
+	ereport(LOG,
+			(errcode_for_file_access(),
+			 errmsg("could not write file \"%s\": %m",
+					CARDFEEDBACK_DUMP_FILE ".tmp")));
+	if (file)
+		FreeFile(file);
+	unlink(CARDFEEDBACK_DUMP_FILE ".tmp");
+}
+
+/*
+ * Forget the plans of the previous command.
+ */
+static void
+cardfeedback_start_command(void)
+{
+	if (CardFeedbackCommandCount == gp_command_count)
+		return;
+
+	if (CardFeedbackContext == NULL)
+		CardFeedbackContext = AllocSetContextCreate(TopMemoryContext,
+													"Cardinality feedback",
+													ALLOCSET_SMALL_MINSIZE,
+													ALLOCSET_SMALL_INITSIZE,
+													ALLOCSET_SMALL_MAXSIZE);
+	else
+		MemoryContextReset(CardFeedbackContext);
+
+	CardFeedbackCommandCount = gp_command_count;
+	CardFeedbackPending = NULL;
+	CardFeedbackPlans = NIL;
+}
+
+/*
+ * Collect the oids of all the relations a query reads.
+ */
+static bool
+cardfeedback_relids_walker(Node *node, List **relids)
+{
+	if (node == NULL)
+		return false;
+
+	if (IsA(node, RangeTblEntry))
+	{
+		RangeTblEntry *rte = (RangeTblEntry *) node;
+
+		if (rte->rtekind == RTE_RELATION)
+			*relids = list_append_unique_oid(*relids, rte->relid);
+		return false;
+	}
+
+	if (IsA(node, Query))
+		return query_tree_walker((Query *) node, cardfeedback_relids_walker,
+								 (void *) relids, QTW_EXAMINE_RTES);
+
+	return expression_tree_walker(node, cardfeedback_relids_walker,
+								  (void *) relids);
+}
+
+/*
+ * CardinalityFeedbackGetFactors
+ *		Correction factors for the estimates of a query
+ *
+ * Returns a palloc'd array of the factors of all signatures that only refer
+ * to relations the query reads, and sets *nfactors to its length.  GPORCA
+ * calls this before it optimizes the query.  The factors are remembered
+ * until CardinalityFeedbackPlanned() is called with the resulting plan.
+ */
+CardinalityFeedbackFactor *
+CardinalityFeedbackGetFactors(Query *query, int *nfactors)
+{
+	List	   *relids = NIL;
+	CardinalityFeedbackFactor *factors;
+	CardFeedbackPlanFactors *pending;
+	HASH_SEQ_STATUS status;
+	CardFeedbackEntry *entry;
+	MemoryContext oldcxt;
+	int			n = 0;
+
+	*nfactors = 0;
+
+	if (CardFeedback == NULL)
+		return NULL;
+
+	(void) cardfeedback_relids_walker((Node *) query, &relids);
+
+	LWLockAcquire(CardFeedback->lock, LW_SHARED);
+
+	factors = (CardinalityFeedbackFactor *)
+		palloc(Max(hash_get_num_entries(CardFeedbackHash), 1) *
+			   sizeof(CardinalityFeedbackFactor));
+
+	hash_seq_init(&status, CardFeedbackHash);
+	while ((entry = (CardFeedbackEntry *) hash_seq_search(&status)) != NULL)
+	{
+		int			i;
+
+		if (entry->key.dbid != MyDatabaseId)
+			continue;
+
+		for (i = 0; i < entry->key.ncols; i++)
+		{
+			if (!list_member_oid(relids, entry->key.cols[i].relid))
+				break;
+		}
+		if (i < entry->key.ncols)
+			continue;
+
+		memcpy(&factors[n].sig, &entry->key,
+			   sizeof(CardinalityFeedbackSignature));
+		factors[n].factor = exp(entry->log_factor);
+		n++;
+	}
+
+	LWLockRelease(CardFeedback->lock);
+
+	cardfeedback_start_command();
+
+	oldcxt = MemoryContextSwitchTo(CardFeedbackContext);
+	pending = (CardFeedbackPlanFactors *) palloc(sizeof(CardFeedbackPlanFactors));
+	pending->stmt = NULL;
+	pending->nfactors = n;
+	pending->factors = (CardinalityFeedbackFactor *)
+		palloc(Max(n, 1) * sizeof(CardinalityFeedbackFactor));
+	memcpy(pending->factors, factors, n * sizeof(CardinalityFeedbackFactor));
+	MemoryContextSwitchTo(oldcxt);
+
+	CardFeedbackPending = pending;
+
+	list_free(relids);
+
+	*nfactors = n;
+	return factors;
+}
+
+/*
+ * CardinalityFeedbackPlanned
+ *		Remember that 'stmt' was optimized with the factors last returned by
+ *		CardinalityFeedbackGetFactors()
+ *
+ * Called after every GPORCA optimization; 'stmt' is NULL if GPORCA did not
+ * produce a plan.
+ */
+void
+CardinalityFeedbackPlanned(PlannedStmt *stmt)
+{
+	MemoryContext oldcxt;
+
+	cardfeedback_start_command();
+
+	if (CardFeedbackPending == NULL)
+		return;
+
+	if (stmt != NULL)
+	{
+		CardFeedbackPending->stmt = stmt;
+
+		oldcxt = MemoryContextSwitchTo(CardFeedbackContext);
+		CardFeedbackPlans = lappend(CardFeedbackPlans, CardFeedbackPending);
+		MemoryContextSwitchTo(oldcxt);
+	}
+
+	CardFeedbackPending = NULL;
+}
+
+/*
+ * Factor applied to the estimate of a signature when the plan was
+ * optimized.
+ */
+static double
+cardfeedback_applied_factor(CardFeedbackCapture *capture,
+							CardinalityFeedbackSignature *sig)
+{
+	int			i;
+
+	for (i = 0; i < capture->applied->nfactors; i++)
+	{
+		CardinalityFeedbackFactor *factor = &capture->applied->factors[i];
+
+		if (memcmp(&factor->sig, sig, sizeof(CardinalityFeedbackSignature)) == 0)
+			return factor->factor;
+	}
+
+	return 1.0;
+}
+
+static int
+cardfeedback_column_cmp(const void *a, const void *b)
+{
+	const CardinalityFeedbackColumn *col1 = (const CardinalityFeedbackColumn *) a;
+	const CardinalityFeedbackColumn *col2 = (const CardinalityFeedbackColumn *) b;
+
+	if (col1->relid != col2->relid)
+		return col1->relid < col2->relid ? -1 : 1;
+	if (col1->attno != col2->attno)
+		return col1->attno < col2->attno ? -1 : 1;
+	if (col1->shape != col2->shape)
+		return col1->shape < col2->shape ? -1 : 1;
+	return 0;
+}
+
+static int
+cardfeedback_pair_cmp(const void *a, const void *b)
+{
+	const CardinalityFeedbackColumn *pair1 = (const CardinalityFeedbackColumn *) a;
+	const CardinalityFeedbackColumn *pair2 = (const CardinalityFeedbackColumn *) b;
+	int			cmp;
+
+	cmp = cardfeedback_column_cmp(&pair1[0], &pair2[0]);
+	if (cmp == 0)
+		cmp = cardfeedback_column_cmp(&pair1[1], &pair2[1]);
+	return cmp;
+}
+
+/*
+ * Put the columns of a signature in canonical order: sort groups of 'width'
+ * columns, i.e. single columns or column pairs, and remove duplicates.
+ * Must match CCardinalityFeedback::SortUnique() in GPORCA.
+ */
+static void
+cardfeedback_sort_unique(CardinalityFeedbackSignature *sig, int width)
+{
+	Size		size = width * sizeof(CardinalityFeedbackColumn);
+	int			ngroups = sig->ncols / width;
+	int			nunique = 0;
+	int			i;
+
+	qsort(sig->cols, ngroups, size,
+		  width == 1 ? cardfeedback_column_cmp : cardfeedback_pair_cmp);
+
+	for (i = 0; i < ngroups; i++)
+	{
+		if (nunique > 0 &&
+			memcmp(&sig->cols[(nunique - 1) * width], &sig->cols[i * width],
+				   size) == 0)
+			continue;
+
+		memmove(&sig->cols[nunique * width], &sig->cols[i * width], size);
+		nunique++;
+	}
+
+	/* keep the unused columns zeroed, the signature is a hash key */
+	for (i = nunique * width; i < sig->ncols; i++)
+		MemSet(&sig->cols[i], 0, sizeof(CardinalityFeedbackColumn));
+	sig->ncols = nunique * width;
+}
+
+/*
+ * Does a scan read a replicated table?  Every segment returns all of its
+ * rows, so the actual rows are not comparable to the estimate.
+ */
+static bool
+cardfeedback_is_replicated(Oid relid)
+{
+	GpPolicy   *policy = GpPolicyFetch(relid);
+	bool		result = GpPolicyIsReplicated(policy);
+
+	pfree(policy);
+	return result;
+}
+
+/*
+ * Does a plan read a replicated table anywhere?
+ */
+static bool
+cardfeedback_reads_replicated(Plan *plan, List *rtable)
+{
+	ListCell   *lc;
+
+	if (plan == NULL)
+		return false;
+
+	switch (nodeTag(plan))
+	{
+		case T_SeqScan:
+		case T_DynamicSeqScan:
+		case T_IndexScan:
+		case T_DynamicIndexScan:
+		case T_IndexOnlyScan:
+		case T_BitmapHeapScan:
+		case T_DynamicBitmapHeapScan:
+			{
+				RangeTblEntry *rte = rt_fetch(((Scan *) plan)->scanrelid,
+											  rtable);
+
+				return rte->rtekind == RTE_RELATION &&
+					cardfeedback_is_replicated(rte->relid);
+			}
+
+		case T_Append:
+			foreach(lc, ((Append *) plan)->appendplans)
+			{
+				if (cardfeedback_reads_replicated((Plan *) lfirst(lc), rtable))
+					return true;
+			}
+			return false;
+
+		case T_Sequence:
+			foreach(lc, ((Sequence *) plan)->subplans)
+			{
+				if (cardfeedback_reads_replicated((Plan *) lfirst(lc), rtable))
+					return true;
+			}
+			return false;
+
+		default:
+			return cardfeedback_reads_replicated(plan->lefttree, rtable) ||
+				cardfeedback_reads_replicated(plan->righttree, rtable);
+	}
+}
+
+/*
+ * Add the shape of the predicates on the columns a scan qual refers to to
+ * a signature.  Returns true, to abort the walk, if the qual refers to
+ * anything but the plain columns of the scanned table, or to too many
+ * columns.
+ */
+typedef struct CardFeedbackScanContext
+{
+	Index		scanrelid;
+	Oid			relid;
+	int16		shape;			/* shape of the predicate being walked */
+	CardinalityFeedbackSignature *sig;
+} CardFeedbackScanContext;
+
+static bool
+cardfeedback_scan_columns_walker(Node *node, CardFeedbackScanContext *context)
+{
+	if (node == NULL)
+		return false;
+
+	if (IsA(node, Var))
+	{
+		Var		   *var = (Var *) node;
+		CardinalityFeedbackSignature *sig = context->sig;
+		int			i;
+
+		if (var->varno != context->scanrelid || var->varlevelsup != 0 ||
+			var->varattno <= 0)
+			return true;
+
+		for (i = 0; i < sig->ncols; i++)
+		{
+			if (sig->cols[i].attno == var->varattno)
+			{
+				sig->cols[i].shape |= context->shape;
+				return false;
+			}
+		}
+
+		if (sig->ncols == CARDINALITY_FEEDBACK_MAX_COLUMNS)
+			return true;
+
+		sig->cols[sig->ncols].relid = context->relid;
+		sig->cols[sig->ncols].attno = var->varattno;
+		sig->cols[sig->ncols].shape = context->shape;
+		sig->ncols++;
+		return false;
+	}
+
+	/* the selectivity of these depends on more than the scanned table */
+	if ((IsA(node, Param) && ((Param *) node)->paramkind == PARAM_EXEC) ||
+		IsA(node, SubPlan) || IsA(node, AlternativeSubPlan))
+		return true;
+
+	return expression_tree_walker(node, cardfeedback_scan_columns_walker,
+								  (void *) context);
+}
+
+/*
+ * Shape of a comparison of a column.  If the comparison is commuted, the
+ * column is its right operand.
+ */
+static int16
+cardfeedback_cmp_shape(Oid opno, bool commuted)
+{
+	switch (get_comparison_type(opno))
+	{
+		case CmptEq:
+			return CARDINALITY_FEEDBACK_EQ;
+		case CmptNEq:
+			return CARDINALITY_FEEDBACK_NE;
+		case CmptLT:
+			return commuted ? CARDINALITY_FEEDBACK_GT : CARDINALITY_FEEDBACK_LT;
+		case CmptLEq:
+			return commuted ? CARDINALITY_FEEDBACK_GE : CARDINALITY_FEEDBACK_LE;
+		case CmptGT:
+			return commuted ? CARDINALITY_FEEDBACK_LT : CARDINALITY_FEEDBACK_GT;
+		case CmptGEq:
+			return commuted ? CARDINALITY_FEEDBACK_LE : CARDINALITY_FEEDBACK_GE;
+		default:
+			return CARDINALITY_FEEDBACK_OTHER;
+	}
+}
+
+/*
+ * Add a conjunct of a scan qual to a signature.  A comparison of a column
+ * with something gives the column the shape of the comparison; the columns
+ * of anything else, including the other side of such a comparison, get
+ * CARDINALITY_FEEDBACK_OTHER.  Must match CCardinalityFeedback::
+ * FAddConjunct() in GPORCA.  Returns true to abort, like the walker.
+ */
+static bool
+cardfeedback_scan_conjunct(Node *node, CardFeedbackScanContext *context)
+{
+	if (and_clause(node))
+	{
+		ListCell   *lc;
+
+		foreach(lc, ((BoolExpr *) node)->args)
+		{
+			if (cardfeedback_scan_conjunct((Node *) lfirst(lc), context))
+				return true;
+		}
+		return false;
+	}
+
+	if (IsA(node, OpExpr) && list_length(((OpExpr *) node)->args) == 2)
+	{
+		OpExpr	   *opexpr = (OpExpr *) node;
+		Node	   *left = linitial(opexpr->args);
+		Node	   *right = lsecond(opexpr->args);
+		bool		commuted = false;
+
+		/* GPORCA sees through binary coercible casts only */
+		while (IsA(left, RelabelType))
+			left = (Node *) ((RelabelType *) left)->arg;
+		while (IsA(right, RelabelType))
+			right = (Node *) ((RelabelType *) right)->arg;
+
+		if (!IsA(left, Var) && IsA(right, Var))
+		{
+			Node	   *tmp = left;
+
+			left = right;
+			right = tmp;
+			commuted = true;
+		}
+
+		if (IsA(left, Var))
+		{
+			context->shape = cardfeedback_cmp_shape(opexpr->opno, commuted);
+			if (!IsA(right, Const))
+				context->shape |= CARDINALITY_FEEDBACK_NONCONST;
+			if (cardfeedback_scan_columns_walker(left, context))
+				return true;
+
+			context->shape = CARDINALITY_FEEDBACK_OTHER;
+			return cardfeedback_scan_columns_walker(right, context);
+		}
+	}
+
+	context->shape = CARDINALITY_FEEDBACK_OTHER;
+	return cardfeedback_scan_columns_walker(node, context);
+}
+
+/*
+ * Observe the rows returned by a scan with a filter.
+ */
+static void
+cardfeedback_observe_scan(CardFeedbackCapture *capture, Scan *scan,
+						  double actual)
+{
+	RangeTblEntry *rte = rt_fetch(scan->scanrelid, capture->rtable);
+	CardinalityFeedbackSignature sig;
+	CardFeedbackScanContext context;
+	List	   *quals = scan->plan.qual;
+	ListCell   *lc;
+
+	if (rte->rtekind != RTE_RELATION || cardfeedback_is_replicated(rte->relid))
+		return;
+
+	switch (nodeTag(scan))
+	{
+		case T_IndexScan:
+		case T_DynamicIndexScan:
+			quals = list_concat(list_copy(quals),
+								((IndexScan *) scan)->indexqualorig);
+			break;
+		case T_IndexOnlyScan:
+			quals = list_concat(list_copy(quals),
+								((IndexOnlyScan *) scan)->indexqualorig);
+			break;
+		case T_BitmapHeapScan:
+		case T_DynamicBitmapHeapScan:
+			quals = list_concat(list_copy(quals),
+								((BitmapHeapScan *) scan)->bitmapqualorig);
+			break;
+		default:
+			break;
+	}
+
+	MemSet(&sig, 0, sizeof(sig));
+	sig.dbid = MyDatabaseId;
+	sig.kind = CARDINALITY_FEEDBACK_SCAN;
+
+	context.scanrelid = scan->scanrelid;
+	context.relid = rte->relid;
+	context.sig = &sig;
+
+	foreach(lc, quals)
+	{
+		if (cardfeedback_scan_conjunct((Node *) lfirst(lc), &context))
+			return;
+	}
+
+	if (sig.ncols == 0)
+		return;
+
+	cardfeedback_sort_unique(&sig, 1);
+
+	cardfeedback_observe(capture, &sig,
+						 scan->plan.plan_rows /
+						 cardfeedback_applied_factor(capture, &sig),
+						 actual);
+}
+
+/*
+ * Find the table column an expression in the quals or the target list of a
+ * plan node stands for, following references to the outputs of its
+ * children.
+ */
+static bool
+cardfeedback_resolve_column(Plan *plan, Expr *expr, List *rtable,
+							CardinalityFeedbackColumn *col)
+{
+	Var		   *var;
+	RangeTblEntry *rte;
+
+	while (IsA(expr, RelabelType))
+		expr = ((RelabelType *) expr)->arg;
+
+	if (!IsA(expr, Var))
+		return false;
+	var = (Var *) expr;
+
+	if (var->varno == OUTER_VAR || var->varno == INNER_VAR)
+	{
+		Plan	   *child;
+		TargetEntry *tle;
+
+		/* a Sequence returns the rows of its last subplan */
+		if (IsA(plan, Sequence))
+			child = (Plan *) llast(((Sequence *) plan)->subplans);
+		else if (var->varno == OUTER_VAR)
+			child = outerPlan(plan);
+		else
+			child = innerPlan(plan);
+
+		if (child == NULL)
+			return false;
+
+		tle = get_tle_by_resno(child->targetlist, var->varattno);
+		if (tle == NULL)
+			return false;
+
+		return cardfeedback_resolve_column(child, tle->expr, rtable, col);
+	}
+
+	if (var->varno == INDEX_VAR || var->varlevelsup != 0 || var->varattno <= 0)
+		return false;
+
+	rte = rt_fetch(var->varno, rtable);
+	if (rte->rtekind != RTE_RELATION)
+		return false;
+
+	col->relid = rte->relid;
+	col->attno = var->varattno;
+	return true;
+}
+
+/*
+ * The node whose rows a join input stands for.  A Motion may broadcast its
+ * input, and a Hash just passes it on.
+ */
+static PlanState *
+cardfeedback_join_input(PlanState *planstate)
+{
+	while (planstate != NULL &&
+		   (IsA(planstate, HashState) || IsA(planstate, MotionState)))
+		planstate = outerPlanState(planstate);
+
+	return planstate;
+}
+
+/*
+ * Observe the rows returned by an inner equi-join.
+ *
+ * What is compared is the selectivity of the join: the estimate is the
+ * number of rows GPORCA's selectivity, without the correction factor,
+ * predicts for the actual sizes of the inputs.
+ */
+static void
+cardfeedback_observe_join(CardFeedbackCapture *capture, PlanState *planstate,
+						  double actual)
+{
+	Join	   *join = (Join *) planstate->plan;
+	CardinalityFeedbackSignature sig;
+	List	   *clauses;
+	ListCell   *lc;
+	PlanState  *outer;
+	PlanState  *inner;
+	double		outer_rows;
+	double		inner_rows;
+	double		nloops;
+	double		estimate;
+
+	if (join->jointype != JOIN_INNER || join->joinqual != NIL ||
+		join->plan.qual != NIL)
+		return;
+
+	if (IsA(join, HashJoin))
+		clauses = ((HashJoin *) join)->hashclauses;
+	else
+		clauses = ((MergeJoin *) join)->mergeclauses;
+
+	MemSet(&sig, 0, sizeof(sig));
+	sig.dbid = MyDatabaseId;
+	sig.kind = CARDINALITY_FEEDBACK_JOIN;
+
+	foreach(lc, clauses)
+	{
+		OpExpr	   *clause = (OpExpr *) lfirst(lc);
+		CardinalityFeedbackColumn pair[2];
+
+		if (!IsA(clause, OpExpr) || list_length(clause->args) != 2 ||
+			sig.ncols + 2 > CARDINALITY_FEEDBACK_MAX_COLUMNS)
+			return;
+
+		MemSet(pair, 0, sizeof(pair));
+		if (!cardfeedback_resolve_column(&join->plan, linitial(clause->args),
+										 capture->rtable, &pair[0]) ||
+			!cardfeedback_resolve_column(&join->plan, lsecond(clause->args),
+										 capture->rtable, &pair[1]))
+			return;
+		pair[0].shape = CARDINALITY_FEEDBACK_EQ;
+		pair[1].shape = CARDINALITY_FEEDBACK_EQ;
+
+		if (cardfeedback_column_cmp(&pair[0], &pair[1]) <= 0)
+		{
+			memcpy(&sig.cols[sig.ncols], &pair[0], sizeof(pair[0]));
+			memcpy(&sig.cols[sig.ncols + 1], &pair[1], sizeof(pair[1]));
+		}
+		else
+		{
+			memcpy(&sig.cols[sig.ncols], &pair[1], sizeof(pair[1]));
+			memcpy(&sig.cols[sig.ncols + 1], &pair[0], sizeof(pair[0]));
+		}
+		sig.ncols += 2;
+	}
+
+	if (sig.ncols == 0)
+		return;
+
+	cardfeedback_sort_unique(&sig, 2);
+
+	outer = cardfeedback_join_input(outerPlanState(planstate));
+	inner = cardfeedback_join_input(innerPlanState(planstate));
+	if (outer == NULL || inner == NULL ||
+		!cdbexplain_getNodeRows(outer, &outer_rows, &nloops) ||
+		!cdbexplain_getNodeRows(inner, &inner_rows, &nloops) ||
+		cardfeedback_reads_replicated(outer->plan, capture->rtable) ||
+		cardfeedback_reads_replicated(inner->plan, capture->rtable))
+		return;
+
+	estimate = join->plan.plan_rows / cardfeedback_applied_factor(capture, &sig);
+	estimate *= (outer_rows / Max(outer->plan->plan_rows, 1.0)) *
+		(inner_rows / Max(inner->plan->plan_rows, 1.0));
+
+	cardfeedback_observe(capture, &sig, estimate, actual);
+}
+
+/*
+ * Observe the nodes of an executed plan.
+ */
+static CdbVisitOpt
+cardfeedback_walker(PlanState *planstate, void *context)
+{
+	CardFeedbackCapture *capture = (CardFeedbackCapture *) context;
+	Plan	   *plan = planstate->plan;
+	double		ntuples;
+	double		nloops;
+
+	/* a Limit may stop the nodes below it early */
+	if (IsA(plan, Limit))
+		return CdbVisit_Skip;
+
+	/* nodes that were rescanned, or not run at all, are not comparable */
+	if (!cdbexplain_getNodeRows(planstate, &ntuples, &nloops) || nloops != 1)
+		return CdbVisit_Skip;
+
+	switch (nodeTag(plan))
+	{
+		case T_SeqScan:
+		case T_DynamicSeqScan:
+		case T_IndexScan:
+		case T_DynamicIndexScan:
+		case T_IndexOnlyScan:
+		case T_BitmapHeapScan:
+		case T_DynamicBitmapHeapScan:
+			cardfeedback_observe_scan(capture, (Scan *) plan, ntuples);
+			break;
+
+		case T_HashJoin:
+		case T_MergeJoin:
+		case T_NestLoop:
+			{
+				double		outer_rows;
+				double		inner_rows;
+
+				/*
+				 * If one input of a join is empty, the executor may not have
+				 * run the other one to the end.
+				 */
+				if (!cdbexplain_getNodeRows(outerPlanState(planstate),
+											&outer_rows, &nloops) ||
+					!cdbexplain_getNodeRows(innerPlanState(planstate),
+											&inner_rows, &nloops) ||
+					outer_rows == 0 || inner_rows == 0)
+					return CdbVisit_Skip;
+
+				if (!IsA(plan, NestLoop))
+					cardfeedback_observe_join(capture, planstate, ntuples);
+				break;
+			}
+
+		default:
+			break;
+	}
+
+	return CdbVisit_Walk;
+}
+
+/*
+ * Add an observation of a signature.
+ */
+static void
+cardfeedback_observe(CardFeedbackCapture *capture,
+					 CardinalityFeedbackSignature *sig,
+					 double estimate, double actual)
+{
+	CardFeedbackObservation *observation;
+
+	observation = (CardFeedbackObservation *) palloc(sizeof(CardFeedbackObservation));
+	memcpy(&observation->sig, sig, sizeof(CardinalityFeedbackSignature));
+	observation->estimate = estimate;
+	observation->actual = actual;
+
+	capture->observations = lappend(capture->observations, observation);
+}
+
+/*
+ * CardinalityFeedbackRecord
+ *		Record the actual rows of the nodes of a GPORCA plan
+ *
+ * Called by EXPLAIN ANALYZE, once the statistics of all the slices have
+ * been gathered.
+ */
+void
+CardinalityFeedbackRecord(QueryDesc *queryDesc)
+{
+	PlannedStmt *stmt = queryDesc->plannedstmt;
+	CardFeedbackCapture capture;
+	ListCell   *lc;
+
+	if (!optimizer_cardinality_feedback || CardFeedback == NULL ||
+		Gp_role != GP_ROLE_DISPATCH || stmt->planGen == PLANGEN_PLANNER)
+		return;
+
+	cardfeedback_start_command();
+
+	capture.rtable = stmt->rtable;
+	capture.applied = NULL;
+	capture.observations = NIL;
+
+	foreach(lc, CardFeedbackPlans)
+	{
+		CardFeedbackPlanFactors *plan_factors = (CardFeedbackPlanFactors *) lfirst(lc);
+
+		if (plan_factors->stmt == stmt)
+			capture.applied = plan_factors;
+	}
+
+	/* we don't know what factors the plan was optimized with */
+	if (capture.applied == NULL)
+		return;
+
+	planstate_walk_node(queryDesc->planstate, cardfeedback_walker, &capture);
+
+	if (capture.observations != NIL)
+		cardfeedback_store(capture.observations);
+
+	list_free_deep(capture.observations);
+}
+
+/*
+ * Fold observations into the stored feedback.
+ */
+static void
+cardfeedback_store(List *observations)
+{
+	TimestampTz now = GetCurrentTimestamp();
+	ListCell   *lc;
+
+	LWLockAcquire(CardFeedback->lock, LW_EXCLUSIVE);
+
+	foreach(lc, observations)
+	{
+		CardFeedbackObservation *observation = (CardFeedbackObservation *) lfirst(lc);
+		CardFeedbackEntry *entry;
+		double		ratio;
+		bool		found;
+
+		entry = (CardFeedbackEntry *) hash_search(CardFeedbackHash,
+												  &observation->sig,
+												  HASH_FIND, NULL);
+		if (entry == NULL)
+		{
+			if (hash_get_num_entries(CardFeedbackHash) >=
+				optimizer_cardinality_feedback_size)
+				cardfeedback_evict();
+
+			entry = (CardFeedbackEntry *) hash_search(CardFeedbackHash,
+													  &observation->sig,
+													  HASH_ENTER_NULL,
+													  &found);
+			if (entry == NULL)
+				continue;
+
+			entry->log_factor = 0;
+			entry->nobservations = 0;
+		}
+
+		ratio = Max(observation->actual, 1.0) / Max(observation->estimate, 1.0);
+		ratio = Min(Max(ratio, 1.0 / CARDFEEDBACK_MAX_RATIO),
+					CARDFEEDBACK_MAX_RATIO);
+
+		entry->nobservations++;
+		entry->log_factor += (log(ratio) - entry->log_factor) /
+			Min(entry->nobservations, CARDFEEDBACK_WINDOW);
+		entry->last_estimate = observation->estimate;
+		entry->last_actual = observation->actual;
+		entry->last_update = now;
+	}
+
+	LWLockRelease(CardFeedback->lock);
+}
+
+/*
+ * Evict the signature updated least recently.  Caller must hold the lock
+ * exclusively.
+ */
+static void
+cardfeedback_evict(void)
+{
+	HASH_SEQ_STATUS status;
+	CardFeedbackEntry *entry;
+	CardFeedbackEntry *oldest = NULL;
+
+	hash_seq_init(&status, CardFeedbackHash);
+	while ((entry = (CardFeedbackEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (oldest == NULL || entry->last_update < oldest->last_update)
+			oldest = entry;
+	}
+
+	if (oldest != NULL)
+		hash_search(CardFeedbackHash, &oldest->key, HASH_REMOVE, NULL);
+}
+
+/*
+ * CardinalityFeedbackForgetRelation
+ *		Forget the feedback on the predicates on a table
+ *
+ * Called when the table is analyzed, truncated or dropped.
+ */
+void
+CardinalityFeedbackForgetRelation(Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	CardFeedbackEntry *entry;
+
+	if (CardFeedback == NULL || Gp_role != GP_ROLE_DISPATCH)
+		return;
+
+	LWLockAcquire(CardFeedback->lock, LW_EXCLUSIVE);
+
+	hash_seq_init(&status, CardFeedbackHash);
+	while ((entry = (CardFeedbackEntry *) hash_seq_search(&status)) != NULL)
+	{
+		int			i;
+
+		for (i = 0; i < entry->key.ncols; i++)
+		{
+			if (entry->key.cols[i].relid == relid)
+			{
+				hash_search(CardFeedbackHash, &entry->key, HASH_REMOVE, NULL);
+				break;
+			}
+		}
+	}
+
+	LWLockRelease(CardFeedback->lock);
+}
+
+/*
+ * Text form of the shape of the predicates on a column, e.g. "<,>=" for
+ * "a < 10 AND a >= 1".
+ */
+static Datum
+cardfeedback_shape_text(int16 shape)
+{
+	static const struct
+	{
+		int16		flag;
+		const char *name;
+	}			shapes[] =
+	{
+		{CARDINALITY_FEEDBACK_EQ, "="},
+		{CARDINALITY_FEEDBACK_NE, "<>"},
+		{CARDINALITY_FEEDBACK_LT, "<"},
+		{CARDINALITY_FEEDBACK_LE, "<="},
+		{CARDINALITY_FEEDBACK_GT, ">"},
+		{CARDINALITY_FEEDBACK_GE, ">="},
+		{CARDINALITY_FEEDBACK_OTHER, "other"},
+		{CARDINALITY_FEEDBACK_NONCONST, "non-constant"}
+	};
+	StringInfoData buf;
+	int			i;
+
+	initStringInfo(&buf);
+	for (i = 0; i < lengthof(shapes); i++)
+	{
+		if ((shape & shapes[i].flag) == 0)
+			continue;
+		if (buf.len > 0)
+			appendStringInfoChar(&buf, ',');
+		appendStringInfoString(&buf, shapes[i].name);
+	}
+
+	return CStringGetTextDatum(buf.data);
+}
+
+/*
+ * gp_optimizer_cardinality_feedback
+ *		Show the stored cardinality feedback
+ *
+ * The columns of a join signature come in pairs, one pair per equality
+ * condition.
+ */
+Datum
+gp_optimizer_cardinality_feedback(PG_FUNCTION_ARGS)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext oldcontext;
+	HASH_SEQ_STATUS status;
+	CardFeedbackEntry *entry;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not " \
+						"allowed in this context")));
+
+	oldcontext = MemoryContextSwitchTo(rsinfo->econtext->ecxt_per_query_memory);
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	if (CardFeedback == NULL)
+		return (Datum) 0;
+
+	LWLockAcquire(CardFeedback->lock, LW_SHARED);
+
+	hash_seq_init(&status, CardFeedbackHash);
+	while ((entry = (CardFeedbackEntry *) hash_seq_search(&status)) != NULL)
+	{
+		Datum		values[10];
+		bool		nulls[10];
+		Datum		relids[CARDINALITY_FEEDBACK_MAX_COLUMNS];
+		Datum		attnos[CARDINALITY_FEEDBACK_MAX_COLUMNS];
+		Datum		shapes[CARDINALITY_FEEDBACK_MAX_COLUMNS];
+		int			ncols = entry->key.ncols;
+		int			i;
+
+		for (i = 0; i < ncols; i++)
+		{
+			relids[i] = ObjectIdGetDatum(entry->key.cols[i].relid);
+			attnos[i] = Int16GetDatum(entry->key.cols[i].attno);
+			shapes[i] = cardfeedback_shape_text(entry->key.cols[i].shape);
+		}
+
+		MemSet(nulls, 0, sizeof(nulls));
+		values[0] = ObjectIdGetDatum(entry->key.dbid);
+		values[1] = CStringGetTextDatum(entry->key.kind == CARDINALITY_FEEDBACK_SCAN ?
+										"scan" : "join");
+		values[2] = PointerGetDatum(construct_array(relids, ncols, OIDOID,
+													sizeof(Oid), true, 'i'));
+		values[3] = PointerGetDatum(construct_array(attnos, ncols, INT2OID,
+													sizeof(int16), true, 's'));
+		values[4] = PointerGetDatum(construct_array(shapes, ncols, TEXTOID,
+													-1, false, 'i'));
+		values[5] = Float8GetDatum(exp(entry->log_factor));
+		values[6] = Int64GetDatum(entry->nobservations);
+		values[7] = Float8GetDatum(entry->last_estimate);
+		values[8] = Float8GetDatum(entry->last_actual);
+		values[9] = TimestampTzGetDatum(entry->last_update);
+
+		tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+	}
+
+	LWLockRelease(CardFeedback->lock);
+
+	return (Datum) 0;
+}
+
+/*
+ * gp_optimizer_cardinality_feedback_reset
+ *		Forget all the stored cardinality feedback
+ */
+Datum
+gp_optimizer_cardinality_feedback_reset(PG_FUNCTION_ARGS)
+{
+	HASH_SEQ_STATUS status;
+	CardFeedbackEntry *entry;
+
+	if (!superuser())
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+				 errmsg("must be superuser to reset the cardinality feedback")));
+
+	if (CardFeedback == NULL)
+		PG_RETURN_VOID();
+
+	LWLockAcquire(CardFeedback->lock, LW_EXCLUSIVE);
+
+	hash_seq_init(&status, CardFeedbackHash);
+	while ((entry = (CardFeedbackEntry *) hash_seq_search(&status)) != NULL)
+		hash_search(CardFeedbackHash, &entry->key, HASH_REMOVE, NULL);
+
+	LWLockRelease(CardFeedback->lock);
+
+	PG_RETURN_VOID();
+}
@@ -107,6 +107,7 @@
 #include "utils/memutils.h"
 #include "utils/rel.h"
 #include "utils/relmapper.h"
+#include "utils/sharedmdcache.h"
 #include "utils/snapmgr.h"
 #include "utils/syscache.h"
 
@@ -1008,6 +1009,12 @@ AtEOXact_Inval(bool isCommit)
 
 		if (transInvalInfo->RelcacheInitFileInval)
 			RelationCacheInitFilePostInvalidate();
+
+		/*
+		 * The shared GPORCA metadata cache has no fine-grained invalidation,
+		 * any catalog change empties it.
+		 */
+		SharedMDCacheInvalidateAll();
 	}
 	else
 	{
@@ -0,0 +1,379 @@
+/*-------------------------------------------------------------------------
+ *
+ * sharedmdcache.c
+ *	  Shared memory tier of the GPORCA metadata cache.
+ *
+ * GPORCA keeps the metadata objects it has looked up in a cache that is
+ * private to each backend (CMDCache).  A new session therefore translates
+ * the relcache entries, statistics and histograms of the same hot tables
+ * to DXL again.  This module keeps the DXL serialization of metadata
+ * objects in shared memory, so that a backend can skip the relcache to DXL
+ * translation for objects that any other backend has already translated.
+ *
+ * The entries are kept in a hash table keyed by database and the
+ * serialized mdid of the object.  The serialized objects themselves are
+ * allocated in a DSA area created in place, with a hard size limit of
+ * optimizer_shared_mdcache_size.
+ *
+ * Like the backend-local cache (see gpdbwrappers.cpp), there is no
+ * fine-grained invalidation: every commit of a transaction that sent
+ * catalog invalidation messages empties the whole cache and advances the
+ * cache generation.  A backend reads the generation before translating an
+ * object, and the translated object is only stored if the generation did
+ * not change in the meantime, so that a translation based on a catalog
+ * state that was concurrently replaced never makes it into the cache.
+ *
+ * If the cache runs out of space, it is emptied as well.
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ *	  src/backend/utils/cache/sharedmdcache.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/transam.h"
+#include "access/xact.h"
+#include "miscadmin.h"
+#include "storage/ipc.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/dsa.h"
+#include "utils/hsearch.h"
+#include "utils/sharedmdcache.h"
+
+/* GUC: size of the shared metadata cache in kB, 0 disables it */
+int			optimizer_shared_mdcache_size = 0;
+
+/* expected average size of a serialized metadata object */
+#define SHARED_MDCACHE_AVG_ENTRY_SIZE	2048
+
+typedef struct SharedMDCacheKey
+{
+	Oid			dbid;
+	char		mdid[SHARED_MDCACHE_KEYLEN];
+} SharedMDCacheKey;
+
+typedef struct SharedMDCacheEntry
+{
+	SharedMDCacheKey key;		/* hash key, must be first */
+	dsa_pointer data;			/* serialized metadata object */
+	Size		len;			/* length of data in bytes */
+} SharedMDCacheEntry;
+
+typedef struct SharedMDCacheControl
+{
+	LWLock	   *lock;			/* protects everything below */
+	uint64		generation;		/* advanced whenever the cache is emptied */
+	char		dsa_mem[FLEXIBLE_ARRAY_MEMBER];
+} SharedMDCacheControl;
+
+static SharedMDCacheControl *SharedMDCache = NULL;
+static HTAB *SharedMDCacheHash = NULL;
+
+/* DSA area attached by the current process */
+static dsa_area *SharedMDCacheArea = NULL;
+
+static inline Size
+SharedMDCacheAreaSize(void)
+{
+	return Max(mul_size(optimizer_shared_mdcache_size, 1024L),
+			   dsa_minimum_size());
+}
+
+static inline long
+SharedMDCacheMaxEntries(void)
+{
+	return Max(mul_size(optimizer_shared_mdcache_size, 1024L) /
+			   SHARED_MDCACHE_AVG_ENTRY_SIZE, 128);
+}
+
+/*
+ * Calculate shmem size for the shared metadata cache.
+ */
+Size
+SharedMDCacheShmemSize(void)
+{
+	Size		size;
+
+	if (optimizer_shared_mdcache_size <= 0)
+		return 0;
+
+	size = add_size(offsetof(SharedMDCacheControl, dsa_mem),
+					SharedMDCacheAreaSize());
+	size = add_size(size, hash_estimate_size(SharedMDCacheMaxEntries(),
+											 sizeof(SharedMDCacheEntry)));
+
+	return size;
+}
+
+/*
+ * Initialize the shared metadata cache.
+ */
+void
+SharedMDCacheShmemInit(void)
+{
+	HASHCTL		info;
+	long		max_entries;
+	dsa_area   *dsa;
+	bool		found;
+
+	if (optimizer_shared_mdcache_size <= 0)
+		return;
+
+	SharedMDCache = (SharedMDCacheControl *)
+		ShmemInitStruct("Shared MD cache",
+						add_size(offsetof(SharedMDCacheControl, dsa_mem),
+								 SharedMDCacheAreaSize()),
+						&found);
+
+	max_entries = SharedMDCacheMaxEntries();
+
+	MemSet(&info, 0, sizeof(info));
+	info.keysize = sizeof(SharedMDCacheKey);
+	info.entrysize = sizeof(SharedMDCacheEntry);
+	info.hash = tag_hash;
+
+	SharedMDCacheHash = ShmemInitHash("Shared MD cache hash",
+									  max_entries, max_entries,
+									  &info,
+									  HASH_ELEM | HASH_FUNCTION |
+									  HASH_FIXED_SIZE);
+
+	if (found)
+		return;
+
+	SharedMDCache->lock = LWLockAssign();
+	SharedMDCache->generation = 0;
+
+	dsa = dsa_create_in_place(SharedMDCache->dsa_mem,
+							  SharedMDCacheAreaSize(),
+							  LWLockNewTrancheId(),
+							  "shared_mdcache", NULL);
+
+	/* never grow beyond the space reserved in the main segment */
+	dsa_set_size_limit(dsa, SharedMDCacheAreaSize());
+
+	on_shmem_exit(dsa_on_shmem_exit_release_in_place,
+				  (Datum) SharedMDCache->dsa_mem);
+	dsa_detach(dsa);
+}
+
+static void
+shared_mdcache_shmem_exit(int code, Datum arg)
+{
+	dsa_release_in_place(SharedMDCache->dsa_mem);
+}
+
+/* Attach DSA once per process. */
+static dsa_area *
+SharedMDCacheAttachDsa(void)
+{
+	MemoryContext oldcxt;
+
+	if (SharedMDCacheArea)
+		return SharedMDCacheArea;
+
+	oldcxt = MemoryContextSwitchTo(TopMemoryContext);
+	SharedMDCacheArea = dsa_attach_in_place(SharedMDCache->dsa_mem, NULL);
+	MemoryContextSwitchTo(oldcxt);
+
+	/* pin mappings, so they can survive res owner life end */
+	dsa_pin_mapping(SharedMDCacheArea);
+
+	on_shmem_exit(shared_mdcache_shmem_exit, 0);
+
+	return SharedMDCacheArea;
+}
+
+static bool
+make_key(SharedMDCacheKey *key, const char *mdid)
+{
+	if (strlen(mdid) >= SHARED_MDCACHE_KEYLEN)
+		return false;
+
+	MemSet(key, 0, sizeof(*key));
+	key->dbid = MyDatabaseId;
+	strcpy(key->mdid, mdid);
+
+	return true;
+}
+
+/*
+ * Remove all entries.  Caller must hold the lock exclusively.
+ */
+static void
+shared_mdcache_reset(dsa_area *dsa)
+{
+	HASH_SEQ_STATUS status;
+	SharedMDCacheEntry *entry;
+
+	hash_seq_init(&status, SharedMDCacheHash);
+	while ((entry = (SharedMDCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		dsa_free(dsa, entry->data);
+		hash_search(SharedMDCacheHash, &entry->key, HASH_REMOVE, NULL);
+	}
+
+	SharedMDCache->generation++;
+}
+
+/*
+ * Can the current backend use the shared cache?
+ *
+ * A transaction that has modified the catalog sees catalog contents that
+ * are not visible to anybody else, so it must neither consume objects
+ * translated by other backends, nor publish its own.
+ */
+bool
+SharedMDCacheEnabled(void)
+{
+	return SharedMDCache != NULL &&
+		!IsBootstrapProcessingMode() &&
+		!TransactionIdIsValid(GetTopTransactionIdIfAny());
+}
+
+/*
+ * Return the current cache generation.  Must be called before the catalog
+ * is read to produce an object that is going to be passed to
+ * SharedMDCacheInsert().
+ */
+uint64
+SharedMDCacheGeneration(void)
+{
+	uint64		generation;
+
+	Assert(SharedMDCache != NULL);
+
+	LWLockAcquire(SharedMDCache->lock, LW_SHARED);
+	generation = SharedMDCache->generation;
+	LWLockRelease(SharedMDCache->lock);
+
+	return generation;
+}
+
+/*
+ * Look up the object with the given serialized mdid.  Returns a palloc'd
+ * copy of the object in the current memory context, or NULL if the object
+ * is not cached.
+ */
+void *
+SharedMDCacheLookup(const char *mdid, Size *len)
+{
+	SharedMDCacheKey key;
+	SharedMDCacheEntry *entry;
+	dsa_area   *dsa;
+	void	   *result = NULL;
+
+	Assert(SharedMDCacheEnabled());
+
+	if (!make_key(&key, mdid))
+		return NULL;
+
+	dsa = SharedMDCacheAttachDsa();
+
+	LWLockAcquire(SharedMDCache->lock, LW_SHARED);
+
+	entry = (SharedMDCacheEntry *) hash_search(SharedMDCacheHash, &key,
+											   HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		*len = entry->len;
+		result = palloc(entry->len);
+		memcpy(result, dsa_get_address(dsa, entry->data), entry->len);
+	}
+
+	LWLockRelease(SharedMDCache->lock);
+
+	return result;
+}
+
+/*
+ * Store a serialized object under the given mdid.
+ *
+ * 'generation' is the value of SharedMDCacheGeneration() from before the
+ * object was translated; if the cache has been emptied since then, the
+ * object may be stale and is not stored.  Returns true if the object was
+ * stored.
+ */
+bool
+SharedMDCacheInsert(const char *mdid, const void *data, Size len,
+					uint64 generation)
+{
+	SharedMDCacheKey key;
+	SharedMDCacheEntry *entry;
+	dsa_area   *dsa;
+	dsa_pointer dp;
+	bool		found;
+
+	Assert(SharedMDCacheEnabled());
+
+	if (!make_key(&key, mdid))
+		return false;
+
+	dsa = SharedMDCacheAttachDsa();
+
+	LWLockAcquire(SharedMDCache->lock, LW_EXCLUSIVE);
+
+	if (SharedMDCache->generation != generation)
+	{
+		LWLockRelease(SharedMDCache->lock);
+		return false;
+	}
+
+	dp = dsa_allocate(dsa, len);
+	if (!DsaPointerIsValid(dp))
+	{
+		/* out of space, start over */
+		shared_mdcache_reset(dsa);
+		LWLockRelease(SharedMDCache->lock);
+		return false;
+	}
+
+	entry = (SharedMDCacheEntry *) hash_search(SharedMDCacheHash, &key,
+											   HASH_ENTER_NULL, &found);
+	if (entry == NULL)
+	{
+		/* hash table is full, start over */
+		dsa_free(dsa, dp);
+		shared_mdcache_reset(dsa);
+		LWLockRelease(SharedMDCache->lock);
+		return false;
+	}
+
+	if (found)
+	{
+		/* somebody else got there first */
+		dsa_free(dsa, dp);
+		LWLockRelease(SharedMDCache->lock);
+		return false;
+	}
+
+	memcpy(dsa_get_address(dsa, dp), data, len);
+	entry->data = dp;
+	entry->len = len;
+
+	LWLockRelease(SharedMDCache->lock);
+
+	return true;
+}
+
+/*
+ * Empty the cache.  Called at commit of every transaction that sent catalog
+ * invalidation messages.
+ */
+void
+SharedMDCacheInvalidateAll(void)
+{
+	dsa_area   *dsa;
+
+	if (SharedMDCache == NULL)
+		return;
+
+	dsa = SharedMDCacheAttachDsa();
+
+	LWLockAcquire(SharedMDCache->lock, LW_EXCLUSIVE);
+	shared_mdcache_reset(dsa);
+	LWLockRelease(SharedMDCache->lock);
+}
@@ -1389,6 +1389,52 @@ datumstreamread_rewind_block(DatumStreamRead * datumStream)
 	datumstreamread_block_get_ready(datumStream);
 }
 
+/*
+ * Read the header of the next block, without reading its content.
+ *
+ * Returns false at the end of the segment file.  Otherwise the caller must
+ * either read the content with datumstreamread_block_content(), or skip the
+ * block with datumstreamread_skip_block().
+ */
+bool
+datumstreamread_block_header(DatumStreamRead * acc)
+{
+	int64		nextRowNum = acc->blockFirstRowNum + acc->blockRowCount;
+
+	if (!datumstreamread_block_info(acc))
+		return false;
+
+	/* Pre-4.0 blocks do not store firstRowNum, see datumstreamread_block() */
+	if (acc->getBlockInfo.firstRow < 0)
+		acc->blockFirstRowNum = nextRowNum;
+
+	return true;
+}
+
+/*
+ * Skip the block whose header was just read by datumstreamread_block_header().
+ */
+void
+datumstreamread_skip_block(DatumStreamRead * acc)
+{
+	AppendOnlyStorageRead_SkipCurrentBlock(&acc->ao_read);
+
+	datumstreamread_reset_block(acc);
+	acc->blockFirstRowNum += acc->blockRowCount;
+	acc->blockRowCount = 0;
+}
+
+/*
+ * Forget the current block, so that the next datumstreamread_advance()
+ * returns 0, as if no block had been read yet.
+ */
+void
+datumstreamread_reset_block(DatumStreamRead * acc)
+{
+	DatumStreamBlockRead_Reset(&acc->blockRead);
+	acc->largeObjectState = DatumStreamLargeObjectState_None;
+}
+
 /*
  * Find the specified row in the current block.
  *
@@ -16,14 +16,18 @@
  */
 #include "postgres.h"
 
+#include <ctype.h>
+#include <math.h>
 #include <sys/stat.h>
 #include <sys/unistd.h>
 
+#include "access/aocs_zonemap.h"
 #include "access/reloptions.h"
 #include "access/transam.h"
 #include "access/url.h"
 #include "access/xlog_internal.h"
 #include "cdb/cdbappendonlyam.h"
+#include "cdb/cdbcompresspool.h"
 #include "cdb/cdbendpoint.h"
 #include "cdb/cdbdisp.h"
 #include "cdb/cdbdisp_query.h"
@@ -44,12 +48,14 @@
 #include "storage/proc.h"
 #include "tcop/idle_resource_cleaner.h"
 #include "utils/builtins.h"
+#include "utils/cardfeedback.h"
 #include "utils/guc.h"
 #include "utils/guc_tables.h"
 #include "utils/inval.h"
 #include "utils/resscheduler.h"
 #include "utils/resgroup.h"
 #include "utils/resource_manager.h"
+#include "utils/sharedmdcache.h"
 #include "utils/vmem_tracker.h"
 #include "utils/gdd.h"
 
@@ -89,6 +95,12 @@ bool gpvars_check_gp_resqueue_priority_default_value(char **newval,
 static bool check_gp_default_storage_options(char **newval, void **extra, GucSource source);
 static void assign_gp_default_storage_options(const char *newval, void *extra);
 
+static bool check_optimizer_cost_model_profile(char **newval, void **extra, GucSource source);
+static void assign_optimizer_cost_model_profile(const char *newval, void *extra);
+#ifdef USE_ORCA
+extern bool GPOPTIsCostModelParam(const char *name);
+#endif
+
 
 static bool check_pljava_classpath_insecure(bool *newval, void **extra, GucSource source);
 static void assign_pljava_classpath_insecure(bool newval, void *extra);
@@ -305,12 +317,15 @@ bool		optimizer_log;
 int			optimizer_log_failure;
 bool		optimizer_control = true;
 bool		optimizer_trace_fallback;
+bool		optimizer_collect_profile;
 bool		optimizer_partition_selection_log;
 int			optimizer_minidump;
 int			optimizer_cost_model;
 bool		optimizer_metadata_caching;
 int			optimizer_mdcache_size;
+int			optimizer_plan_cache_size;
 bool		optimizer_use_gpdb_allocators;
+bool		optimizer_use_arena_allocator;
 bool		optimizer_enable_table_alias;
 
 /* Optimizer debugging GUCs */
@@ -399,6 +414,8 @@ int			optimizer_penalize_broadcast_threshold;
 double		optimizer_cost_threshold;
 double		optimizer_nestloop_factor;
 double		optimizer_sort_factor;
+char	   *optimizer_cost_model_profile;
+OptimizerCostProfile *optimizer_cost_profile = NULL;
 
 /* Optimizer hints */
 int			optimizer_join_arity_for_associativity_commutativity;
@@ -622,6 +639,7 @@ static const struct config_enum_entry optimizer_join_order_options[] = {
 	{"greedy", JOIN_ORDER_GREEDY_SEARCH},
 	{"exhaustive", JOIN_ORDER_EXHAUSTIVE_SEARCH},
 	{"exhaustive2", JOIN_ORDER_EXHAUSTIVE2_SEARCH},
+	{"dphyp", JOIN_ORDER_DPHYP_SEARCH},
 	{NULL, 0}
 };
 
@@ -692,6 +710,56 @@ struct config_bool ConfigureNamesBool_gp[] =
 		true,
 		NULL, NULL, NULL
 	},
+	{
+		{"gp_enable_runtime_filter", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables hash joins to filter the scan on their outer side "
+						 "by the join keys of their inner side."),
+			gettext_noop("The hash values of the inner rows are collected in a "
+						 "Bloom filter, which a sequential scan directly below "
+						 "the join uses to drop rows that cannot match.")
+		},
+		&gp_enable_runtime_filter,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"gp_enable_hashjoin_partitioning", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables hash joins to partition hash tables larger than "
+						 "the CPU cache."),
+			gettext_noop("The hash table is divided into partitions of "
+						 "gp_hashjoin_partition_size, and the outer rows are "
+						 "probed a partition at a time.")
+		},
+		&gp_enable_hashjoin_partitioning,
+		true,
+		NULL, NULL, NULL
+	},
+	{
+		{"gp_enable_hashjoin_prefetch", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables hash joins to probe hash tables larger than "
+						 "the CPU cache in batches, prefetching their buckets."),
+			gettext_noop("Only matters when the hash table of a batch is larger "
+						 "than gp_hashjoin_partition_size. Outer rows are then "
+						 "buffered, up to 64 per partition, and before a buffer "
+						 "is probed the bucket headers of its rows, and the first "
+						 "inner row of each bucket, are prefetched into the CPU "
+						 "cache.")
+		},
+		&gp_enable_hashjoin_prefetch,
+		true,
+		NULL, NULL, NULL
+	},
+	{
+		{"gp_enable_aocs_batch_scan", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables batch mode for sequential scans of append-optimized column tables."),
+			gettext_noop("The scan reads rows in batches, and evaluates simple "
+						 "comparisons of integer and date columns with constants "
+						 "on a whole batch at a time.")
+		},
+		&gp_enable_aocs_batch_scan,
+		false,
+		NULL, NULL, NULL
+	},
 	{
 		{"gp_enable_hashjoin_size_heuristic", PGC_USERSET, QUERY_TUNING_METHOD,
 			gettext_noop("In hash join plans, the smaller of the two inputs "
@@ -2138,6 +2206,28 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_collect_profile", PGC_USERSET, LOGGING_WHAT,
+			gettext_noop("Collect the time spent in the optimizer's jobs and transformations, shown by EXPLAIN VERBOSE."),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_collect_profile,
+		false,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_cardinality_feedback", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Corrects the cardinality estimates of GPORCA with the actual rows of earlier plans."),
+			gettext_noop("The actual rows are collected by EXPLAIN ANALYZE of GPORCA plans."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_cardinality_feedback,
+		false,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"optimizer_partition_selection_log", PGC_USERSET, LOGGING_WHAT,
 			gettext_noop("Log optimizer partition selection."),
@@ -3044,6 +3134,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_use_arena_allocator", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Allocate the objects of a query optimization from large blocks, freed all at once."),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_use_arena_allocator,
+		true,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"optimizer_enable_table_alias", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Enable using table aliases to make plan explain more descriptive"),
@@ -3647,6 +3748,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_appendonly_compress_threads", PGC_USERSET, APPENDONLY_TABLES,
+			gettext_noop("Sets the number of threads that compress the blocks of append-only tables in the background."),
+			gettext_noop("Only zlib and zstd compression use the threads. Zero compresses the blocks in the backend itself.")
+		},
+		&gp_appendonly_compress_threads,
+		0, 0, COMPRESS_POOL_MAX_THREADS,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_workfile_max_entries", PGC_POSTMASTER, RESOURCES,
 			gettext_noop("Sets the maximum number of entries that can be stored in the workfile directory"),
@@ -3679,6 +3790,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_workfile_prefetch_blocks", PGC_USERSET, RESOURCES_DISK,
+			gettext_noop("Number of blocks of a sort tape to prefetch ahead of its reader during a merge."),
+			gettext_noop("0 disables prefetching.")
+		},
+		&gp_workfile_prefetch_blocks,
+		16, 0, 1024,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_workfile_limit_per_segment", PGC_POSTMASTER, RESOURCES,
 			gettext_noop("Maximum disk space (in KB) used for workfiles per segment."),
@@ -4268,6 +4389,18 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"gp_hashjoin_partition_size", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the size of the partitions of the hash table of a hash join."),
+			gettext_noop("Should be about the size of the CPU cache available "
+						 "to a query process."),
+			GUC_UNIT_KB | GUC_NOT_IN_SAMPLE
+		},
+		&gp_hashjoin_partition_size,
+		1024, 64, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"gp_hashagg_groups_per_bucket", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Target density of hashtable used by Hashagg during execution"),
@@ -4684,6 +4817,50 @@ struct config_int ConfigureNamesInt_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_plan_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the size of the cache of plans produced by GPORCA."),
+			gettext_noop("0 disables the plan cache. Plans are only cached "
+						 "when optimizer_metadata_caching is enabled."),
+			GUC_UNIT_KB
+		},
+		&optimizer_plan_cache_size,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_shared_mdcache_size", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the size of the MDCache shared by all backends."),
+			gettext_noop("0 disables the shared MDCache."),
+			GUC_UNIT_KB
+		},
+		&optimizer_shared_mdcache_size,
+		0, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"gp_aocs_zonemap_cache_size", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the size of the shared cache of block min/max values of append-optimized column tables."),
+			gettext_noop("0 disables skipping blocks of append-optimized column tables by their min/max values."),
+			GUC_UNIT_KB
+		},
+		&gp_aocs_zonemap_cache_size,
+		0, 0, MAX_KILOBYTES,
+		NULL, NULL, NULL
+	},
+
+	{
+		{"optimizer_cardinality_feedback_size", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of cardinality estimates GPORCA keeps feedback for."),
+			gettext_noop("0 disables the cardinality feedback."),
+		},
+		&optimizer_cardinality_feedback_size,
+		1024, 0, INT_MAX / 2,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"memory_profiler_dataset_size", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Set the size in GB"),
@@ -5153,6 +5330,19 @@ struct config_string ConfigureNamesString_gp[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"optimizer_cost_model_profile", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Scales the parameters of the optimizer's cost model."),
+			gettext_noop("A comma-separated list of name=factor pairs, as written by "
+						 "the cost model calibration script of GPORCA. The default "
+						 "value of each named parameter is multiplied by its factor."),
+			GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_cost_model_profile,
+		"",
+		check_optimizer_cost_model_profile, assign_optimizer_cost_model_profile, NULL
+	},
+
 	{
 		{"gp_default_storage_options", PGC_USERSET, APPENDONLY_TABLES,
 			gettext_noop("default options for appendonly storage."),
@@ -5439,7 +5629,7 @@ struct config_enum ConfigureNamesEnum_gp[] =
 	{
 		{"optimizer_join_order", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("Set optimizer join heuristic model."),
-			gettext_noop("Valid values are query, greedy, exhaustive and exhaustive2"),
+			gettext_noop("Valid values are query, greedy, exhaustive, exhaustive2 and dphyp"),
 			GUC_NOT_IN_SAMPLE
 		},
 		&optimizer_join_order,
@@ -5780,6 +5970,110 @@ assign_gp_default_storage_options(const char *newval, void *extra)
 	setDefaultAOStorageOpts(newopts);
 }
 
+/*
+ * Parse optimizer_cost_model_profile, a list of name=factor pairs.  The
+ * names must be parameters of GPORCA's cost model; without GPORCA there is
+ * nothing to check them against, and the profile is not used anyway.
+ */
+static bool
+check_optimizer_cost_model_profile(char **newval, void **extra, GucSource source)
+{
+	OptimizerCostProfile *profile;
+	const char *p;
+	int			maxfactors = 1;
+
+	for (p = *newval; *p; p++)
+	{
+		if (*p == ',')
+			maxfactors++;
+	}
+
+	profile = (OptimizerCostProfile *)
+		malloc(offsetof(OptimizerCostProfile, factors) +
+			   maxfactors * sizeof(OptimizerCostParamFactor));
+	if (profile == NULL)
+		return false;
+	profile->nfactors = 0;
+
+	p = *newval;
+	while (scanner_isspace(*p))
+		p++;
+
+	while (*p)
+	{
+		OptimizerCostParamFactor *factor = &profile->factors[profile->nfactors];
+		const char *name = p;
+		char	   *end;
+		int			len;
+
+		while (isalnum((unsigned char) *p))
+			p++;
+		len = p - name;
+		while (scanner_isspace(*p))
+			p++;
+
+		if (len == 0 || len >= NAMEDATALEN || *p != '=')
+		{
+			GUC_check_errdetail("Expected a list of name=factor pairs.");
+			free(profile);
+			return false;
+		}
+		memcpy(factor->name, name, len);
+		factor->name[len] = '\0';
+
+#ifdef USE_ORCA
+		if (!GPOPTIsCostModelParam(factor->name))
+		{
+			GUC_check_errdetail("\"%s\" is not a parameter of the optimizer's cost model.",
+								factor->name);
+			free(profile);
+			return false;
+		}
+#endif
+
+		factor->factor = strtod(p + 1, &end);
+		if (end == p + 1 || !(factor->factor > 0) || isinf(factor->factor))
+		{
+			GUC_check_errdetail("The factor of \"%s\" must be a positive number.",
+								factor->name);
+			free(profile);
+			return false;
+		}
+		profile->nfactors++;
+
+		p = end;
+		while (scanner_isspace(*p))
+			p++;
+		if (*p == ',')
+		{
+			p++;
+			while (scanner_isspace(*p))
+				p++;
+			if (*p == '\0')
+			{
+				GUC_check_errdetail("Expected a list of name=factor pairs.");
+				free(profile);
+				return false;
+			}
+		}
+		else if (*p != '\0')
+		{
+			GUC_check_errdetail("Expected a list of name=factor pairs.");
+			free(profile);
+			return false;
+		}
+	}
+
+	*extra = profile;
+	return true;
+}
+
+static void
+assign_optimizer_cost_model_profile(const char *newval, void *extra)
+{
+	optimizer_cost_profile = (OptimizerCostProfile *) extra;
+}
+
 /*
  * Set GUC value in GP_REPLICATION_CONFIG_FILENAME.
  *
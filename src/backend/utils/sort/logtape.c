@@ -84,7 +84,7 @@
 
 #include "utils/logtape.h"
 
-#include "cdb/cdbvars.h"                /* currentSliceId */
+#include "cdb/cdbvars.h"                /* gp_workfile_prefetch_blocks */
 
 
 /* A logical tape block, log tape blocks are organized into doulbe linked lists */
@@ -113,6 +113,13 @@ struct LogicalTape
 
 	int64 		firstBlkNum;  /* First block block number */
 	LogicalTapePos   currPos;         /* current postion */
+
+	/*
+	 * Blocks [prefetchStart, prefetchEnd) of the underlying file have been
+	 * prefetched for the reader of this tape.
+	 */
+	int64		prefetchStart;
+	int64		prefetchEnd;
 };
 
 /*
@@ -157,6 +164,7 @@ static void ltsWriteBlock(LogicalTapeSet *lts, int64 blocknum, void *buffer);
 static void ltsReadBlock(LogicalTapeSet *lts, int64 blocknum, void *buffer);
 static long ltsGetFreeBlock(LogicalTapeSet *lts);
 static void ltsReleaseBlock(LogicalTapeSet *lts, int64 blocknum);
+static void ltsPrefetchBlocks(LogicalTapeSet *lts, LogicalTape *lt, int64 blocknum);
 
 /*
  * Writes state of a LogicalTapeSet to a state file
@@ -220,8 +228,14 @@ LoadLogicalTapeSetState(BufFile *statefile, BufFile *tapefile)
 	if(readSize != sizeof(lt->firstBlkNum))
 		elog(ERROR, "Load logicaltapeset failed to read tape firstBlkNum");
 
+	lt->prefetchStart = -1L;
+	lt->prefetchEnd = -1L;
+
 	if(lt->firstBlkNum != -1)
+	{
 		ltsReadBlock(lts, lt->firstBlkNum, &lt->currBlk);
+		ltsPrefetchBlocks(lts, lt, lt->currBlk.next_blk);
+	}
 
 	lt->currPos.blkNum = lt->firstBlkNum;
 	lt->currPos.offset = 0;
@@ -272,6 +286,44 @@ ltsReadBlock(LogicalTapeSet *lts, int64 blocknum, void *buffer)
 	}
 }
 
+/*
+ * Prefetch the blocks from blocknum on, which the reader of a tape will
+ * need next, so that merging many tapes does not wait on each of their
+ * reads in turn.
+ *
+ * Only the next block of a tape is known before it is read, but the blocks
+ * of a run are mostly contiguous in the underlying file, since they are
+ * taken from the lowest free blocks as the run is written.  So we prefetch
+ * a window of gp_workfile_prefetch_blocks blocks, and move it on once the
+ * reader is past half of it.  Blocks prefetched needlessly only cost some
+ * page cache.
+ */
+static void
+ltsPrefetchBlocks(LogicalTapeSet *lts, LogicalTape *lt, int64 blocknum)
+{
+	int64		start;
+	int64		end;
+
+	if (gp_workfile_prefetch_blocks <= 0 || blocknum == -1L)
+		return;
+
+	if (blocknum >= lt->prefetchStart && blocknum < lt->prefetchEnd)
+	{
+		if (blocknum - lt->prefetchStart < gp_workfile_prefetch_blocks / 2)
+			return;
+		start = lt->prefetchEnd;
+	}
+	else
+		start = blocknum;
+
+	end = Min(blocknum + gp_workfile_prefetch_blocks, lts->nFileBlocks);
+	if (end > start)
+		BufFilePrefetchBlocks(lts->pfile, start, (int) (end - start));
+
+	lt->prefetchStart = blocknum;
+	lt->prefetchEnd = Max(end, start);
+}
+
 /*
  * qsort comparator for sorting freeBlocks[] into decreasing order.
  */
@@ -367,6 +419,8 @@ LogicalTapeCreate(LogicalTapeSet *lts, LogicalTape *lt)
 	lt->firstBlkNum = -1L;
 	lt->currPos.blkNum = -1L;
 	lt->currPos.offset = 0;
+	lt->prefetchStart = -1L;
+	lt->prefetchEnd = -1L;
 	return lt;
 }
 
@@ -536,6 +590,10 @@ LogicalTapeRewind(LogicalTapeSet *lts, LogicalTape *lt, bool forWrite)
 
 				if(lt->currPos.blkNum != lt->firstBlkNum)
 					ltsReadBlock(lts, lt->firstBlkNum, &lt->currBlk);
+
+				lt->prefetchStart = -1L;
+				lt->prefetchEnd = -1L;
+				ltsPrefetchBlocks(lts, lt, lt->currBlk.next_blk);
 			}
 			
 			lt->currPos.blkNum = lt->firstBlkNum;
@@ -552,6 +610,11 @@ LogicalTapeRewind(LogicalTapeSet *lts, LogicalTape *lt, bool forWrite)
 			if(lt->currPos.blkNum != lt->firstBlkNum)
 				ltsReadBlock(lts, lt->firstBlkNum, &lt->currBlk);
 
+			lt->prefetchStart = -1L;
+			lt->prefetchEnd = -1L;
+			if(lt->firstBlkNum != -1)
+				ltsPrefetchBlocks(lts, lt, lt->currBlk.next_blk);
+
 			lt->currPos.blkNum = lt->firstBlkNum;
 			lt->currPos.offset = 0;
 		}
@@ -605,6 +668,7 @@ LogicalTapeRead(LogicalTapeSet *lts, LogicalTape *lt,
 			lt->currPos.blkNum = lt->currBlk.next_blk;
 			lt->currPos.offset = 0;
 			ltsReadBlock(lts, lt->currBlk.next_blk, &lt->currBlk);
+			ltsPrefetchBlocks(lts, lt, lt->currBlk.next_blk);
 
 			if(!lt->frozen)
 			{
@@ -121,6 +121,8 @@
 #include "utils/tuplesort.h"
 #include "utils/pg_locale.h"
 #include "utils/builtins.h"
+#include "utils/date.h"
+#include "utils/timestamp.h"
 #include "utils/tuplesort_mk.h"
 #include "utils/tuplesort_mk_details.h"
 #include "utils/string_wrapper.h"
@@ -503,6 +505,8 @@ static void readtup_datum(Tuplesortstate_mk *state, TuplesortPos_mk *pos, MKEntr
 			  LogicalTape *lt, uint32 len);
 
 static void tupsort_prepare_char(MKEntry *a, bool isChar);
+static MKNormKeyType tupsort_choose_nkey(MKLvContext *lvctxt, bool *exact);
+static uint64 tupsort_normalize_key(Datum d, MKLvContext *lvctxt);
 static int	tupsort_compare_char(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, MKContext *mkContext);
 
 static Datum tupsort_fetch_datum_mtup(MKEntry *a, MKContext *mkctxt, MKLvContext *lvctxt, bool *isNullOut);
@@ -731,6 +735,8 @@ create_mksort_context(MKContext *mkctxt,
 		sinfo->attno = attNums ? attNums[i] : i + 1;
 
 		sinfo->lvtype = MKLV_TYPE_NONE;
+		sinfo->nktype = MKNK_NONE;
+		sinfo->nkeyExact = false;
 
 		if (tupdesc)
 		{
@@ -757,6 +763,8 @@ create_mksort_context(MKContext *mkctxt,
 					sinfo->lvtype = MKLV_TYPE_TEXT;
 			}
 #endif
+
+			sinfo->nktype = tupsort_choose_nkey(sinfo, &sinfo->nkeyExact);
 		}
 		else
 		{
@@ -3174,9 +3182,14 @@ typedef struct refcnt_locale_str_k
 int
 tupsort_compare_datum(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, MKContext *context)
 {
+	int32		result;
+
 	Assert(!mke_is_null(v1));
 	Assert(!mke_is_null(v2));
 
+	if (mke_compare_nkey(v1, v2, lvctxt, &result))
+		return result;
+
 	switch (lvctxt->lvtype)
 	{
 		case MKLV_TYPE_NONE:
@@ -3417,6 +3430,9 @@ tupsort_prepare(MKEntry *a, MKContext *mkctxt, int lv)
 	else
 		mke_set_null(a, (lvctxt->scanKey.sk_flags & SK_BT_NULLS_FIRST) != 0);
 
+	if (lvctxt->nktype != MKNK_NONE)
+		a->nkey = isnull ? 0 : tupsort_normalize_key(a->d, lvctxt);
+
 	if (lvctxt->lvtype == MKLV_TYPE_CHAR)
 		tupsort_prepare_char(a, true);
 	else if (lvctxt->lvtype == MKLV_TYPE_TEXT)
@@ -3437,6 +3453,137 @@ bcTruelen(char *p, int len)
 	return i + 1;
 }
 
+/*
+ * Choose the normalized key of a level from its comparison function, see
+ * MKNormKeyType.  *exact is set if the key decides the order of the datums.
+ */
+static MKNormKeyType
+tupsort_choose_nkey(MKLvContext *lvctxt, bool *exact)
+{
+	PGFunction	cmp = lvctxt->scanKey.sk_func.fn_addr;
+
+	*exact = true;
+
+	if (cmp == btint2cmp)
+		return MKNK_INT16;
+	if (cmp == btint4cmp || cmp == date_cmp)
+		return MKNK_INT32;
+#ifdef HAVE_INT64_TIMESTAMP
+	if (cmp == btint8cmp || cmp == timestamp_cmp || cmp == time_cmp)
+		return MKNK_INT64;
+#else
+	if (cmp == btint8cmp)
+		return MKNK_INT64;
+	if (cmp == timestamp_cmp || cmp == time_cmp)
+		return MKNK_FLOAT8;
+#endif
+	if (cmp == btoidcmp)
+		return MKNK_UINT32;
+	if (cmp == btfloat4cmp)
+		return MKNK_FLOAT4;
+	if (cmp == btfloat8cmp)
+		return MKNK_FLOAT8;
+
+	/* strings compare bytewise only in the C collation */
+	*exact = false;
+	if (lc_collate_is_c(lvctxt->scanKey.sk_collation))
+	{
+		if (cmp == bttextcmp)
+			return MKNK_TEXT;
+		if (cmp == bpcharcmp)
+			return MKNK_BPCHAR;
+	}
+
+	return MKNK_NONE;
+}
+
+/*
+ * Map a float8 to an unsigned integer of the same order.  As in
+ * btfloat8cmp, -0 equals +0, and NaNs are equal and above all other values.
+ */
+static inline uint64
+normalize_float8(float8 f)
+{
+	union
+	{
+		float8		f;
+		uint64		i;
+	}			u;
+
+	if (isnan(f))
+		return ~UINT64CONST(0);
+	if (f == 0.0)
+		f = 0.0;
+
+	u.f = f;
+	if (u.i & UINT64CONST(0x8000000000000000))
+		return ~u.i;
+	return u.i | UINT64CONST(0x8000000000000000);
+}
+
+/*
+ * Normalized key of a non-null datum of a level, see MKNormKeyType.  For
+ * strings it is made of their first 8 bytes, zero padded, so that a string
+ * sorts after its prefixes as in varstr_cmp.
+ */
+static uint64
+tupsort_normalize_key(Datum d, MKLvContext *lvctxt)
+{
+	uint64		nkey = 0;
+
+	switch (lvctxt->nktype)
+	{
+		case MKNK_INT16:
+			nkey = (uint16) DatumGetInt16(d) ^ 0x8000;
+			break;
+		case MKNK_INT32:
+			nkey = (uint32) DatumGetInt32(d) ^ 0x80000000;
+			break;
+		case MKNK_INT64:
+			nkey = (uint64) DatumGetInt64(d) ^ UINT64CONST(0x8000000000000000);
+			break;
+		case MKNK_UINT32:
+			nkey = DatumGetObjectId(d);
+			break;
+		case MKNK_FLOAT4:
+			/* exact, and keeps the order */
+			nkey = normalize_float8((float8) DatumGetFloat4(d));
+			break;
+		case MKNK_FLOAT8:
+			nkey = normalize_float8(DatumGetFloat8(d));
+			break;
+		case MKNK_TEXT:
+		case MKNK_BPCHAR:
+			{
+				text	   *t = DatumGetTextPP(d);
+				char	   *p = VARDATA_ANY(t);
+				int			len = VARSIZE_ANY_EXHDR(t);
+				int			i;
+
+				if (lvctxt->nktype == MKNK_BPCHAR)
+					len = bcTruelen(p, len);
+
+				for (i = 0; i < sizeof(nkey); i++)
+				{
+					nkey <<= 8;
+					if (i < len)
+						nkey |= (unsigned char) p[i];
+				}
+
+				if ((Pointer) t != DatumGetPointer(d))
+					pfree(t);
+			}
+			break;
+		default:
+			Assert(!"unexpected normalized key type");
+	}
+
+	if ((lvctxt->scanKey.sk_flags & SK_BT_DESC) != 0)
+		nkey = ~nkey;
+
+	return nkey;
+}
+
 /**
  * should only be called for non-null Datum (caller must check the isnull flag from the fetch)
  */
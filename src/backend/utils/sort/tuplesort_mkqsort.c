@@ -30,6 +30,14 @@
 extern void mkqsort_verify(MKEntry *a, int l, int r, MKContext *mkctxt);
 #endif
 
+/*
+ * Chunks of at least this many entries are radix sorted, if their level has exact normalized
+ *   keys.  Smaller ones are quick sorted.
+ */
+#define MKQS_RADIX_MIN 64
+
+static void mk_qsort_equal(MKEntry *a, int left, int right, int lv, MKContext *ctxt, bool seenNull);
+
 /**
  * Given an array, swap the entries at a[i] and a[j]
  */
@@ -48,9 +56,9 @@ static inline void mkqs_swap(MKEntry *a, int i, int j)
  */
 static inline int32 mkqs_comp(MKEntry *a, MKEntry *b, MKLvContext *ctxt, MKContext *mkctxt)
 {
-	int ret = a->compflags - b->compflags;
+	int32 ret = a->compflags - b->compflags;
 
-	if (ret == 0 && !mke_is_null(a))
+	if (ret == 0 && !mke_is_null(a) && !mke_compare_nkey(a, b, ctxt, &ret))
 		ret = tupsort_compare_datum(a, b, ctxt, mkctxt);
 
 	return ret;
@@ -261,61 +269,32 @@ static void mk_qsort_part3(MKEntry *a, int left, int right, int lv, MKContext *m
 	*firstInHighOut = rightIndex;
 }
 
-void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKContext *ctxt, bool seenNull)
+/*
+ * Sort a chunk of entries that are all equal at level lv: [left,right] is the pivot region of a
+ *   three way partition, or a bucket of a radix sort.
+ */
+static void mk_qsort_equal(MKEntry *a, int left, int right, int lv, MKContext *ctxt, bool seenNull)
 {
-	int lastInLow;
-	int firstInHigh;
-
-	Assert(ctxt);
-	Assert(lv < ctxt->total_lv);
-
-	CHECK_FOR_INTERRUPTS();
-
-	if (QueryFinishPending)
-		return;
-
-	if(right <= left)
-		return;
-	
-	/* Prepare at level lv */
-	if(lvdown)
-        mk_prepare_array(a, left, right, lv, ctxt);
-
-	/* 
-	 * According to Bentley & McIlroy [1] (1993), using insert sort for case 
-	 * n < 7 is a significant saving.  However, according to Sedgewick & 
-	 * Bentley [2] (2002), the wisdom of new millenium is not to special case
-	 * smaller cases.  Here, we do not special case it because we want to save
-	 * memtuple_getattr, and expensive comparisons that has been prepared.
-	 *
-	 * XXX Find out why we have a new wisdom in [2] and impl. & compare.
-	 */
-	mk_qsort_part3(a, left, right, lv, ctxt, &lastInLow, &firstInHigh);
-
-	/* recurse to left chunk */
-	mk_qsort_impl(a, left, lastInLow, lv, false, ctxt, seenNull);
-
-	/* recurse to middle (equal) chunk */
 	if(lv < ctxt->total_lv-1)
 	{
 		/*
-		 * [lastInLow+1,firstInHigh-1] defines the pivot region which was all equal at level lv.  So increase the level and compare that region!
+		 * [left,right] was all equal at level lv.  So increase the level and compare that region!
 		 */
-		mk_qsort_impl(a, lastInLow+1, firstInHigh-1, lv+1, true, ctxt, seenNull || mke_is_null(a+lastInLow+1)); /* a + lastInLow + 1 points to the pivot */
+		mk_qsort_impl(a, left, right, lv+1, true, ctxt, seenNull || mke_is_null(a+left));
 	}
 	else
 	{
 		/* values are all equal to the deepest level...no need for more compares, but check uniqueness if requested */
-		if(firstInHigh-1 > lastInLow+1 &&
+		if(right > left &&
 				!seenNull &&
-				!mke_is_null(a+lastInLow+1)) /* a + lastInLow + 1 points to the pivot */
+				!mke_is_null(a+left))
 		{
 			if ( ctxt->enforceUnique )
 			{
 				Datum	values[INDEX_MAX_KEYS];
 				bool	isnull[INDEX_MAX_KEYS];
 		
-				index_deform_tuple((IndexTuple)(a+lastInLow+1)->ptr, ctxt->tupdesc, values, isnull);
+				index_deform_tuple((IndexTuple)(a+left)->ptr, ctxt->tupdesc, values, isnull);
 				ereport(ERROR,
 						(errcode(ERRCODE_UNIQUE_VIOLATION),
 						 errmsg("could not create unique index \"%s\"",
@@ -329,17 +308,186 @@ void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKConte
 			else if ( ctxt->unique)
 			{
 				int toFreeIndex;
-				for ( toFreeIndex = lastInLow + 2; toFreeIndex < firstInHigh; toFreeIndex++) /* +2 because we want to keep one around! */
+				for ( toFreeIndex = left + 1; toFreeIndex <= right; toFreeIndex++) /* +1 because we want to keep one around! */
 				{
 					MKEntry *toFree = a + toFreeIndex;
 					if ( ctxt->cpfr)
-						ctxt->cpfr(toFree, NULL, ctxt->lvctxt + lv); // todo: verify off-by-one
+						ctxt->cpfr(toFree, NULL, ctxt->lvctxt + lv);
 					ctxt->freeTup(toFree);
 					mke_set_empty(toFree);
 				}
 			}
 		}
 	}
+}
+
+/*
+ * MSD radix sort of the non-null entries [left,right] at level lv, whose normalized keys decide
+ *   their order, on the byte of the keys at shift and the bytes below it.  The buckets are
+ *   permuted in place, as in the American flag sort, so no memory is needed beyond the counts.
+ *   Small buckets are left to the quick sort, which compares the keys.
+ */
+static void mk_radix_sort_bytes(MKEntry *a, int left, int right, int lv, int shift, MKContext *ctxt, bool seenNull)
+{
+	int count[256];
+	int next[256];
+	int end[256];
+	int b;
+	int i;
+
+	CHECK_FOR_INTERRUPTS();
+
+	if (QueryFinishPending)
+		return;
+
+	if(right - left + 1 < MKQS_RADIX_MIN)
+	{
+		mk_qsort_impl(a, left, right, lv, false, ctxt, seenNull);
+		return;
+	}
+
+	memset(count, 0, sizeof(count));
+	for(i=left; i<=right; ++i)
+		++count[(a[i].nkey >> shift) & 0xFF];
+
+	/* Lay out the buckets, and skip the permutation if they are all in one */
+	i = left;
+	for(b=0; b<256; ++b)
+	{
+		if (count[b] == right - left + 1)
+			break;
+		next[b] = i;
+		i += count[b];
+		end[b] = i;
+	}
+
+	if (b == 256)
+	{
+		for(b=0; b<256; ++b)
+		{
+			while(next[b] < end[b])
+			{
+				MKEntry e = a[next[b]];
+				int d = (e.nkey >> shift) & 0xFF;
+
+				/* Move e to its bucket, and carry on with the entry it displaces */
+				while(d != b)
+				{
+					MKEntry tmp = a[next[d]];
+
+					a[next[d]++] = e;
+					e = tmp;
+					d = (e.nkey >> shift) & 0xFF;
+				}
+				a[next[b]++] = e;
+			}
+		}
+	}
+
+	/* Sort each bucket on the lower bytes; the last byte leaves equal entries */
+	i = left;
+	for(b=0; b<256; ++b)
+	{
+		if (count[b] > 0)
+		{
+			if (shift == 0)
+				mk_qsort_equal(a, i, i + count[b] - 1, lv, ctxt, seenNull);
+			else if (count[b] > 1)
+				mk_radix_sort_bytes(a, i, i + count[b] - 1, lv, shift - 8, ctxt, seenNull);
+			i += count[b];
+		}
+	}
+}
+
+/*
+ * Radix sort the entries [left,right] prepared at level lv.  The nulls are split off first, and
+ *   the other entries sorted on their normalized keys.  Returns false, without changing the
+ *   array, if the entries differ by more than nullness in their compflags.
+ */
+static bool mk_radix_sort(MKEntry *a, int left, int right, int lv, MKContext *ctxt, bool seenNull)
+{
+	int32 otherflags = a[left].compflags & ~MKE_CF_NULLBITS;
+	int lt;
+	int gt;
+	int i;
+
+	for(i=left; i<=right; ++i)
+	{
+		if ((a[i].compflags & ~MKE_CF_NULLBITS) != otherflags)
+			return false;
+	}
+
+	/* Three way partition on nullness: [left,lt) nulls first, (gt,right] nulls last */
+	lt = left;
+	gt = right;
+	i = left;
+	while(i <= gt)
+	{
+		int32 nullbits = mke_get_nullbits(a+i);
+
+		if (nullbits == MKE_CF_NullFirst)
+			mkqs_swap(a, lt++, i++);
+		else if (nullbits == MKE_CF_NullLast)
+			mkqs_swap(a, i, gt--);
+		else
+			++i;
+	}
+
+	if (lt > left)
+		mk_qsort_equal(a, left, lt-1, lv, ctxt, seenNull);
+	if (gt >= lt)
+		mk_radix_sort_bytes(a, lt, gt, lv, 56, ctxt, seenNull);
+	if (gt < right)
+		mk_qsort_equal(a, gt+1, right, lv, ctxt, seenNull);
+
+	return true;
+}
+
+void mk_qsort_impl(MKEntry *a, int left, int right, int lv, bool lvdown, MKContext *ctxt, bool seenNull)
+{
+	int lastInLow;
+	int firstInHigh;
+
+	Assert(ctxt);
+	Assert(lv < ctxt->total_lv);
+
+	CHECK_FOR_INTERRUPTS();
+
+	if (QueryFinishPending)
+		return;
+
+	if(right <= left)
+		return;
+	
+	/* Prepare at level lv */
+	if(lvdown)
+        mk_prepare_array(a, left, right, lv, ctxt);
+
+	/*
+	 * If the normalized keys decide the order at this level, a radix sort beats comparisons on
+	 * large chunks.
+	 */
+	if(ctxt->lvctxt[lv].nkeyExact &&
+			right - left + 1 >= MKQS_RADIX_MIN &&
+			mk_radix_sort(a, left, right, lv, ctxt, seenNull))
+		return;
+
+	/* 
+	 * According to Bentley & McIlroy [1] (1993), using insert sort for case 
+	 * n < 7 is a significant saving.  However, according to Sedgewick & 
+	 * Bentley [2] (2002), the wisdom of new millenium is not to special case
+	 * smaller cases.  Here, we do not special case it because we want to save
+	 * memtuple_getattr, and expensive comparisons that has been prepared.
+	 *
+	 * XXX Find out why we have a new wisdom in [2] and impl. & compare.
+	 */
+	mk_qsort_part3(a, left, right, lv, ctxt, &lastInLow, &firstInHigh);
+
+	/* recurse to left chunk */
+	mk_qsort_impl(a, left, lastInLow, lv, false, ctxt, seenNull);
+
+	/* recurse to middle (equal) chunk */
+	mk_qsort_equal(a, lastInLow+1, firstInHigh-1, lv, ctxt, seenNull);
 
 	/* recurse to right chunk */
 	mk_qsort_impl(a, firstInHigh, right, lv, false, ctxt, seenNull);
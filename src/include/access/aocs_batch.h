@@ -0,0 +1,41 @@
+/*-------------------------------------------------------------------------
+ *
+ * aocs_batch.h
+ *	  prototypes for functions in backend/access/aocs/aocs_batch.c
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ * src/include/access/aocs_batch.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef AOCS_BATCH_H
+#define AOCS_BATCH_H
+
+#include "access/skey.h"
+#include "access/tupdesc.h"
+#include "nodes/pg_list.h"
+
+/* number of rows an AOCS scan reads ahead in batch mode */
+#define AOCS_BATCH_SIZE		1024
+
+/*
+ * A "column op constant" qual clause that a scan in batch mode evaluates on
+ * a whole column vector at a time.  The column has an integer or integer-like
+ * type, and the constant is widened to int64.
+ */
+typedef struct AOCSBatchQual
+{
+	int			attno;			/* column number, starting from 0 */
+	int16		typlen;			/* 2, 4 or 8 */
+	StrategyNumber strategy;	/* btree strategy of the operator */
+	int64		value;			/* the constant */
+} AOCSBatchQual;
+
+extern AOCSBatchQual *AOCSBatchExtractQuals(TupleDesc tupdesc, List *qual,
+											Index scanrelid, bool *pushed,
+											int *nquals);
+extern void AOCSBatchFilter(const AOCSBatchQual *bq, const Datum *values,
+							const bool *nulls, bool *match, int nrows);
+
+#endif   /* AOCS_BATCH_H */
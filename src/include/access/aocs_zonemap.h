@@ -0,0 +1,64 @@
+/*-------------------------------------------------------------------------
+ *
+ * aocs_zonemap.h
+ *	  prototypes for functions in backend/access/aocs/aocs_zonemap.c
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ * src/include/access/aocs_zonemap.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef AOCS_ZONEMAP_H
+#define AOCS_ZONEMAP_H
+
+#include "access/skey.h"
+#include "access/tupdesc.h"
+#include "fmgr.h"
+#include "nodes/pg_list.h"
+#include "storage/relfilenode.h"
+
+/*
+ * Summary of the values of one column in one varblock.
+ */
+typedef struct AOCSZoneMap
+{
+	int32		rowCount;		/* number of rows in the block */
+	int32		nullCount;		/* number of NULLs in the block */
+	Datum		min;			/* smallest non-NULL value */
+	Datum		max;			/* largest non-NULL value */
+} AOCSZoneMap;
+
+/*
+ * A column of a scan that has zone map keys on it.
+ */
+typedef struct AOCSZoneMapScanColumn
+{
+	int			attno;			/* column number, starting from 0 */
+	FmgrInfo	cmp;			/* btree comparison function of the column */
+	Oid			collation;
+	int			nkeys;
+	ScanKey		keys;			/* "column op constant" keys on the column */
+} AOCSZoneMapScanColumn;
+
+extern int	gp_aocs_zonemap_cache_size;
+
+extern Size AOCSZoneMapShmemSize(void);
+extern void AOCSZoneMapShmemInit(void);
+
+extern bool AOCSZoneMapEnabled(void);
+extern AOCSZoneMapScanColumn *AOCSZoneMapExtractKeys(TupleDesc tupdesc,
+													 List *qual,
+													 Index scanrelid,
+													 int *ncols);
+extern bool AOCSZoneMapLookup(RelFileNode node, int32 segno, int32 attno,
+							  int64 fileOffset, int64 firstRowNum,
+							  int32 rowCount, AOCSZoneMap *zonemap);
+extern void AOCSZoneMapInsert(RelFileNode node, int32 segno, int32 attno,
+							  int64 fileOffset, int64 firstRowNum,
+							  const AOCSZoneMap *zonemap);
+extern bool AOCSZoneMapExcludes(AOCSZoneMapScanColumn *col,
+								const AOCSZoneMap *zonemap);
+extern void AOCSZoneMapInvalidateRelation(RelFileNode node);
+
+#endif   /* AOCS_ZONEMAP_H */
@@ -304,6 +304,12 @@
  CREATE FUNCTION enable_xform(text) RETURNS text LANGUAGE internal IMMUTABLE STRICT AS 'enable_xform' WITH (OID=6088, DESCRIPTION="enables transformations in the optimizer");
 
  CREATE FUNCTION gp_opt_version() RETURNS text LANGUAGE internal IMMUTABLE STRICT AS 'gp_opt_version' WITH (OID=6089, DESCRIPTION="Returns the optimizer and gpos library versions");
+
+ CREATE FUNCTION gp_optimizer_plan_cache_stats(OUT entries int8, OUT hits int8, OUT misses int8, OUT evictions int8, OUT invalidations int8) RETURNS pg_catalog.record LANGUAGE internal VOLATILE AS 'gp_optimizer_plan_cache_stats' WITH (OID=6090, DESCRIPTION="statistics: counters of the optimizer plan cache of the current backend");
+
+ CREATE FUNCTION gp_optimizer_cardinality_feedback(OUT dbid oid, OUT kind text, OUT relids _oid, OUT attnums _int2, OUT predicates _text, OUT factor float8, OUT observations int8, OUT last_estimate float8, OUT last_actual float8, OUT last_update timestamptz) RETURNS SETOF pg_catalog.record LANGUAGE internal VOLATILE AS 'gp_optimizer_cardinality_feedback' WITH (OID=6091, DESCRIPTION="statistics: cardinality feedback collected for the optimizer");
+
+ CREATE FUNCTION gp_optimizer_cardinality_feedback_reset() RETURNS void LANGUAGE internal VOLATILE AS 'gp_optimizer_cardinality_feedback_reset' WITH (OID=6094, DESCRIPTION="forget the cardinality feedback collected for the optimizer");
  
  
   -- functions for the complex data type
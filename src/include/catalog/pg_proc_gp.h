@@ -22,7 +22,7 @@
 
    WARNING: DO NOT MODIFY THE FOLLOWING SECTION: 
    Generated by catullus.pl version 8
-   on Wed May 29 10:02:27 2019
+   on Sat Oct 17 04:05:39 2026
 
    Please make your changes in pg_proc.sql
 */
@@ -150,7 +150,6 @@ DESCR("get replication error");
 DATA(insert OID = 7154 ( pg_terminate_backend  PGNSP PGUID 12 1 0 0 0 f f f f t f v 2 0 16 "23 25" _null_ _null_ _null_ _null_ pg_terminate_backend_msg _null_ _null_ _null_ n a ));
 DESCR("terminate a server process");
 
-
 /* pg_resgroup_get_status_kv(IN prop_in text, OUT rsgid oid, OUT prop text, OUT value text) => SETOF pg_catalog.record */
 DATA(insert OID = 6065 ( pg_resgroup_get_status_kv  PGNSP PGUID 12 1 1000 0 0 f f f f f t v 1 0 2249 "25" "{25,26,25,25}" "{i,o,o,o}" "{prop_in,rsgid,prop,value}" _null_ pg_resgroup_get_status_kv _null_ _null_ _null_ n a ));
 DESCR("statistics: information about resource groups in key-value style");
@@ -620,6 +619,18 @@ DESCR("enables transformations in the optimizer");
 DATA(insert OID = 6089 ( gp_opt_version  PGNSP PGUID 12 1 0 0 0 f f f f t f i 0 0 25 "" _null_ _null_ _null_ _null_ gp_opt_version _null_ _null_ _null_ n a ));
 DESCR("Returns the optimizer and gpos library versions");
 
+/* gp_optimizer_plan_cache_stats(OUT entries int8, OUT hits int8, OUT misses int8, OUT evictions int8, OUT invalidations int8) => pg_catalog.record */
+DATA(insert OID = 6090 ( gp_optimizer_plan_cache_stats  PGNSP PGUID 12 1 0 0 0 f f f f f f v 0 0 2249 "" "{20,20,20,20,20}" "{o,o,o,o,o}" "{entries,hits,misses,evictions,invalidations}" _null_ gp_optimizer_plan_cache_stats _null_ _null_ _null_ n a ));
+DESCR("statistics: counters of the optimizer plan cache of the current backend");
+
+/* gp_optimizer_cardinality_feedback(OUT dbid oid, OUT kind text, OUT relids _oid, OUT attnums _int2, OUT predicates _text, OUT factor float8, OUT observations int8, OUT last_estimate float8, OUT last_actual float8, OUT last_update timestamptz) => SETOF pg_catalog.record */
+DATA(insert OID = 6091 ( gp_optimizer_cardinality_feedback  PGNSP PGUID 12 1 1000 0 0 f f f f f t v 0 0 2249 "" "{26,25,1028,1005,1009,701,20,701,701,1184}" "{o,o,o,o,o,o,o,o,o,o}" "{dbid,kind,relids,attnums,predicates,factor,observations,last_estimate,last_actual,last_update}" _null_ gp_optimizer_cardinality_feedback _null_ _null_ _null_ n a ));
+DESCR("statistics: cardinality feedback collected for the optimizer");
+
+/* gp_optimizer_cardinality_feedback_reset() => void */
+DATA(insert OID = 6094 ( gp_optimizer_cardinality_feedback_reset  PGNSP PGUID 12 1 0 0 0 f f f f f f v 0 0 2278 "" _null_ _null_ _null_ _null_ gp_optimizer_cardinality_feedback_reset _null_ _null_ _null_ n a ));
+DESCR("forget the cardinality feedback collected for the optimizer");
+
 
   /* functions for the complex data type */
 /* complex_in(cstring) => complex */
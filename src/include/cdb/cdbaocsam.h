@@ -71,6 +71,38 @@ typedef struct AOCSInsertDescData
 
 typedef AOCSInsertDescData *AOCSInsertDesc;
 
+/*
+ * Rows read ahead by a scan in batch mode, in one vector per column.  See
+ * aocs_batch.c.
+ */
+typedef struct AOCSScanBatch
+{
+	int			nquals;
+	struct AOCSBatchQual *quals;	/* clauses evaluated on the vectors */
+
+	/* projected by-reference columns, their values are copied */
+	int			nbyref_atts;
+	int		   *byref_atts;
+	MemoryContext valuecxt;		/* copies of the values of the batch */
+
+	Datum	  **values;			/* values[attno][row], for projected columns */
+	bool	  **nulls;
+	AOTupleId  *tids;
+	bool	   *match;			/* result of the quals for each row */
+	int		   *sel;			/* rows that passed the quals */
+	int			nsel;
+	int			next;			/* next entry of sel to return */
+	bool		eof;			/* no more batches */
+
+	Datum	   *rowvalues;		/* scratch space for one row */
+	bool	   *rownulls;
+
+	/* counters for EXPLAIN ANALYZE */
+	int64		nbatches;		/* batches read */
+	int64		nrows;			/* rows read in them */
+	int64		nremoved;		/* rows that did not pass the quals */
+} AOCSScanBatch;
+
 /*
  * used for scan of append only relations using BufferedRead and VarBlocks
  */
@@ -126,6 +158,21 @@ typedef struct AOCSScanDescData
 
 	AppendOnlyVisimap visibilityMap;
 
+	/*
+	 * Zone map filtering, see aocs_zonemap.c.  zonemap_cols is indexed by
+	 * column number, and is NULL for the columns without keys.
+	 */
+	int			zonemap_natts;		/* number of columns with keys */
+	int		   *zonemap_atts;		/* column numbers of those columns */
+	struct AOCSZoneMapScanColumn **zonemap_cols;
+	bool		zonemap_active;		/* used for the current segment file? */
+	int64		zonemap_next_row;	/* row number of the next row, 0 if not
+									 * known yet */
+	int64		zonemap_skipped_blocks;
+
+	/* batch mode, NULL if the scan returns each row as soon as it's read */
+	AOCSScanBatch *batch;
+
 }	AOCSScanDescData;
 
 typedef AOCSScanDescData *AOCSScanDesc;
@@ -210,6 +257,10 @@ extern AOCSScanDesc aocs_beginrangescan(Relation relation, Snapshot snapshot,
 
 extern void aocs_afterscan(AOCSScanDesc scan);
 extern void aocs_rescan(AOCSScanDesc scan);
+extern void aocs_set_zonemap_quals(AOCSScanDesc scan, List *qual,
+								   Index scanrelid);
+extern bool aocs_set_batch_quals(AOCSScanDesc scan, List *qual,
+								 Index scanrelid, bool *pushed);
 extern void aocs_endscan(AOCSScanDesc scan);
 
 extern bool aocs_getnext(AOCSScanDesc scan, ScanDirection direction, TupleTableSlot *slot);
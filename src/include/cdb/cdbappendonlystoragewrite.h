@@ -19,6 +19,7 @@
 #include "cdb/cdbappendonlystorage.h"
 #include "cdb/cdbappendonlystoragelayer.h"
 #include "cdb/cdbbufferedappend.h"
+#include "cdb/cdbcompresspool.h"
 #include "utils/palloc.h"
 #include "storage/fd.h"
 
@@ -174,6 +175,17 @@ typedef struct AppendOnlyStorageWrite
 
 	bool needsWAL;
 
+	/*
+	 * With gp_appendonly_compress_threads, the blocks are compressed by the
+	 * compression thread pool, with compressPoolMethod.  compressJob is the
+	 * block being compressed; it is finished before anything else is done
+	 * with this write session.
+	 */
+	CompressPoolMethod compressPoolMethod;
+	CompressPoolJob *compressJob;
+	int			compressJobExecutorBlockKind;
+	int			compressJobRowCount;
+
 } AppendOnlyStorageWrite;
 
 extern void AppendOnlyStorageWrite_Init(AppendOnlyStorageWrite *storageWrite,
@@ -0,0 +1,74 @@
+/*-------------------------------------------------------------------------
+ *
+ * cdbcompresspool.h
+ *	  A pool of threads that compress the blocks of append-only tables.
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ * IDENTIFICATION
+ *	    src/include/cdb/cdbcompresspool.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CDBCOMPRESSPOOL_H
+#define CDBCOMPRESSPOOL_H
+
+/* upper limit of gp_appendonly_compress_threads */
+#define COMPRESS_POOL_MAX_THREADS	64
+
+/* The compression libraries the threads can call. */
+typedef enum CompressPoolMethod
+{
+	CompressPoolMethod_None = 0,
+	CompressPoolMethod_Zlib,
+	CompressPoolMethod_Zstd
+} CompressPoolMethod;
+
+typedef enum CompressPoolJobState
+{
+	CompressPoolJob_Free = 0,
+	CompressPoolJob_Queued,
+	CompressPoolJob_Running,
+	CompressPoolJob_Done
+} CompressPoolJobState;
+
+/*
+ * A block to compress.  The buffers belong to the pool, not to any memory
+ * context.
+ */
+typedef struct CompressPoolJob
+{
+	CompressPoolMethod method;
+	int			level;
+
+	uint8	   *src;			/* copy of the data to compress */
+	int32		srcLen;
+	uint8	   *dst;			/* the compressed data */
+	int32		dstLen;
+
+	/*
+	 * Set by the thread.  compressedLen is srcLen or more if the data does
+	 * not compress, like with the compression functions of pg_compression.
+	 */
+	int32		compressedLen;
+	const char *error;			/* NULL, or why the compression failed */
+
+	/* Owned by the pool */
+	CompressPoolJobState state;
+	bool		abandoned;		/* nobody is going to wait for it */
+	int32		srcSize;		/* allocated sizes of src and dst */
+	int32		dstSize;
+	struct CompressPoolJob *next;	/* in the queue */
+	struct CompressPoolJob *allNext;	/* in the list of all jobs */
+} CompressPoolJob;
+
+extern int	gp_appendonly_compress_threads;
+
+extern CompressPoolMethod CompressPool_GetMethod(char *compressType);
+extern CompressPoolJob *CompressPool_Submit(CompressPoolMethod method, int level,
+											uint8 *src, int32 srcLen,
+											int32 dstLen);
+extern void CompressPool_Wait(CompressPoolJob *job);
+extern void CompressPool_Release(CompressPoolJob *job);
+
+#endif   /* CDBCOMPRESSPOOL_H */
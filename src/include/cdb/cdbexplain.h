@@ -138,6 +138,19 @@ cdbexplain_showExecStatsBegin(struct QueryDesc *queryDesc,
 void
 cdbexplain_showStatCtxFree(struct CdbExplain_ShowStatCtx *ctx);
 
+/*
+ * cdbexplain_getNodeRows
+ *    Called by qDisp, once the EXPLAIN ANALYZE statistics have been
+ *    gathered, to get the number of rows a PlanState node returned, summed
+ *    over all the workers of its slice, and the largest number of run
+ *    cycles of the node in any worker.  Returns false if no statistics
+ *    were gathered for the node.
+ */
+bool
+cdbexplain_getNodeRows(struct PlanState *planstate,
+                       double *ntuples,
+                       double *nloops);
+
 
 
 #endif   /* CDBEXPLAIN_H */
@@ -616,6 +616,32 @@ extern bool gp_adjust_selectivity_for_outerjoins;
 extern int gp_hashjoin_tuples_per_bucket;
 extern int gp_hashagg_groups_per_bucket;
 
+/*
+ * Let a hash join filter the tuples of the scan on its outer side by the
+ * hash values of its inner side.
+ */
+extern bool gp_enable_runtime_filter;
+
+/*
+ * Partition the in-memory hash table of a hash join, and its probes, into
+ * partitions of about gp_hashjoin_partition_size kilobytes, when it is
+ * larger than that.
+ */
+extern bool gp_enable_hashjoin_partitioning;
+extern int gp_hashjoin_partition_size;
+
+/*
+ * Probe a hash table larger than gp_hashjoin_partition_size in batches of
+ * outer tuples, prefetching their buckets.
+ */
+extern bool gp_enable_hashjoin_prefetch;
+
+/*
+ * Let sequential scans of column tables read rows in batches, and evaluate
+ * simple quals on whole column vectors.
+ */
+extern bool gp_enable_aocs_batch_scan;
+
 /*
  * Damping of selectivities of clauses which pertain to the same base
  * relation; compensates for undetected correlation
@@ -854,6 +880,7 @@ extern int gp_workfile_limit_per_segment;
 extern int gp_workfile_limit_per_query;
 extern int gp_workfile_limit_files_per_query;
 extern int gp_workfile_compression_overhead_limit;
+extern int gp_workfile_prefetch_blocks;
 extern int gp_workfile_caching_loglevel;
 extern int gp_sessionstate_loglevel;
 extern int gp_workfile_bytes_to_checksum;
@@ -40,14 +40,11 @@ typedef struct BatchFileInfo BatchFileInfo;
  */
 typedef struct HashAggEntry
 {
-	struct HashAggEntry *next; /* Next entry in chain. */
 	void *tuple_and_aggs; /* grouping keys and aggregate values.*/
 	HashKey hashvalue;
 	bool is_primodial; /* indicates if this entry is there before spilling. */
 } HashAggEntry;
 
-typedef HashAggEntry* HashAggBucket;
-
 /* A SpillFile controls access to a temporary file used to hold  
  * transition tuples spilled from the hash table in order to free 
  * up space.
@@ -119,7 +116,7 @@ typedef struct SpillSet
 
 typedef struct HashAggTableSizes
 {
-	unsigned  nbuckets;   /* Calculated # of hash buckets. */
+	unsigned  nslots;     /* Calculated # of hash table slots. */
 	unsigned  nentries;   /* Calculated # of hash entries. */
 	unsigned  nbatches;   /* Calculated # of passes. */
 	double    hashentry_width; /* Estimated hash entry size */
@@ -146,17 +143,28 @@ typedef struct GroupKeysAndAggs
  * e.g., description of input and output tuples, tuple slots, expression 
  * and memory contexts, grouping key information (including hash and 
  * equality functions), etc. Thus it is very tightly coupled with them.
+ *
+ * The hash table itself uses open addressing. Its slots are probed in
+ * groups of consecutive slots, starting from the group selected by the
+ * hash key. Each slot has a control byte, which is either empty or holds
+ * 7 bits of the hash key of its entry, so that the control bytes of a
+ * whole group can be matched against a hash key at once. The full hash
+ * key of each entry is kept next to its pointer, so only the entries
+ * whose hash key matches are visited. Entries are only ever removed all
+ * at once, when the table spills or is reset, so a probe stops at the
+ * first group that has an empty slot.
  */
 typedef struct HashAggTable
 {
 	/* Hash table */
 	MemoryContext   entry_cxt;	/* memory context for hash table entries */
 
-	unsigned nbuckets;
-	HashAggBucket  *buckets;
-	uint64 *bloom;
+	unsigned nslots;	/* number of slots, a power of 2 */
+	uint8 *ctrl;		/* control byte of each slot */
+	HashKey *slot_hashes; /* hash key of the entry in each slot */
+	HashAggEntry **slots; /* entry in each slot */
 
-	/* hashkey bitshift amount to determine bucket - used when spilling */
+	/* hashkey bitshift amount to determine the group - used when spilling */
 	unsigned pshift;
 
 	/* Overflow batches */
@@ -181,8 +189,7 @@ typedef struct HashAggTable
 	GroupKeysAndAggs   *groupaggs;
 
 	/* Variables during iteration */
-	int curr_bucket_idx;
-	HashAggEntry *next_entry;
+	int curr_slot_idx;
 
 	/* buffer for calculating the hashkey */
 	HashKey *hashkey_buf;
@@ -206,12 +213,12 @@ typedef struct HashAggTable
 	uint32 num_expansions; /* number of times hash table is expanded */
 
 	bool is_spilling; /* indicate that spilling happened for this batch. */
-	bool expandable;  /* hash table buckets still have space to grow */
+	bool expandable;  /* hash table slots still have space to grow */
 	struct TupleTableSlot *prev_slot; /* a slot that is read previously. */
 
 	/* Statistics used for EXPLAIN ANALYZE */
-	CdbExplain_Agg      chainlength;
-	uint64 total_buckets; /* total of nbuckets across spills and reloads */
+	CdbExplain_Agg      probelength;
+	uint64 total_slots; /* total of nslots across spills and reloads */
 } HashAggTable;
 
 extern HashAggTable *create_agg_hash_table(AggState *aggstate);
@@ -109,6 +109,45 @@ typedef struct HashSkewBucket
 #define SKEW_WORK_MEM_PERCENT  2
 #define SKEW_MIN_OUTER_FRACTION  0.01
 
+/*
+ * When the in-memory part of the inner relation is much larger than the CPU
+ * cache, every probe of the hashtable is likely to miss it.  In that case we
+ * divide the buckets into npartitions ranges of consecutive bucket numbers,
+ * i.e. by the high bits of the bucket number.  The inner tuples of each range
+ * are allocated in a memory context of their own, so that the buckets and the
+ * tuples of a partition are packed together, and the outer tuples are
+ * collected by partition and probed a partition at a time, so that the probes
+ * of a partition find its tuples in the cache.
+ *
+ * Outer tuples are copied into the buffer of their partition; when a buffer
+ * is full, all of its tuples are probed before any other outer tuple is read.
+ * At the end of the batch the buffers are probed in partition order.  Outer
+ * tuples that belong to a later batch or to a skew bucket bypass the buffers.
+ *
+ * The buffers also batch the probes: when a buffer starts to be probed, the
+ * buckets of its tuples are prefetched, so that the cache misses of one probe
+ * overlap with the work on the previous ones.  The probes are batched even
+ * if partitioning is disabled; there is then a single buffer.
+ *
+ * The buffers and the tuples copied into them are limited to
+ * PROBE_WORK_MEM_PERCENT of the total memory allowed for the join, which is
+ * taken out of what the hash table may use.  When the limit is reached, the
+ * buffer that was just added to is probed before it is full.
+ */
+#define HJ_MAX_PARTITIONS  256
+#define HJ_PROBE_BUFFER_SIZE  64
+#define PROBE_WORK_MEM_PERCENT  5
+#define HJ_BUCKET_PARTITION(hashtable, bucketno) \
+	((bucketno) >> ((hashtable)->log2_nbuckets - (hashtable)->log2_npartitions))
+
+typedef struct HashProbeBuffer
+{
+	int			ntuples;		/* number of buffered outer tuples */
+	int			nextTuple;		/* next one to probe, while draining */
+	uint32		hashvalues[HJ_PROBE_BUFFER_SIZE];
+	MemTuple	tuples[HJ_PROBE_BUFFER_SIZE];
+} HashProbeBuffer;
+
 
 /* Statistics collection workareas for EXPLAIN ANALYZE */
 typedef struct HashJoinBatchStats
@@ -169,6 +208,18 @@ typedef struct HashJoinTableData
 
 	uint64		totalTuples;	/* # tuples obtained from inner plan */
 
+	/* radix partitioning of the in-memory hash table, see HashProbeBuffer */
+	int			npartitions;	/* # partitions, 1 if not partitioned */
+	int			log2_npartitions;	/* its log2 */
+	MemoryContext *partitionCxt;	/* tuple storage of each partition */
+	MemoryContext probeCxt;		/* storage of the buffered outer tuples */
+	HashProbeBuffer *probeBuffers;	/* buffered outer tuples of each
+									 * partition, NULL if not batched */
+	int			drainPartition; /* partition being probed, or -1 */
+	bool		drainAll;		/* probing all the buffers at end of batch */
+	MemTuple	drainedTuple;	/* buffered tuple returned last */
+	bool		prefetchProbes; /* prefetch the buckets of buffered tuples */
+
 	/*
 	 * These arrays are allocated for the life of the hash join, but only if
 	 * nbatch > 1.  A file is opened only when we first write a tuple into it
@@ -198,6 +249,8 @@ typedef struct HashJoinTableData
 	Size		spacePeak;		/* peak space used */
 	Size		spaceUsedSkew;	/* skew hash table's current space usage */
 	Size		spaceAllowedSkew;		/* upper limit for skew hashtable */
+	Size		spaceUsedProbe; /* probe buffers' current space usage */
+	Size		spaceAllowedProbe;		/* upper limit for probe buffers */
 
 	MemoryContext hashCxt;		/* context for whole-hash-join storage */
 	MemoryContext batchCxt;		/* context for this-batch-only storage */
@@ -216,4 +269,24 @@ typedef struct HashJoinTableData
 	uint64      workset_compression_buf_total;
 }	HashJoinTableData;
 
+/*
+ * Runtime filter of a hash join.
+ *
+ * When the outer side of an inner, semi or right hash join is a plain scan,
+ * the Hash node adds the hash values of all inner tuples to a Bloom filter
+ * while it builds the hash table.  The filter is then installed in the outer
+ * scan, which uses it to drop the tuples that cannot possibly find a match in
+ * the hash table, before they are passed up to the join.
+ */
+typedef struct HashRuntimeFilterData
+{
+	HashJoinState *hjstate;		/* join that owns the filter */
+	ScanState  *target;			/* outer scan to install the filter in */
+	ExprContext *econtext;		/* for evaluating the outer hash keys */
+	struct bloom_filter *bloom; /* hash values of the inner tuples, or NULL */
+	bool		disabled;		/* given up, as the filter is not selective */
+	uint64		ntested;		/* number of outer tuples tested */
+	uint64		nremoved;		/* number of outer tuples removed */
+}	HashRuntimeFilterData;
+
 #endif   /* HASHJOIN_H */
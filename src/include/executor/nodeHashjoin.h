@@ -27,4 +27,7 @@ extern void ExecHashJoinSaveTuple(PlanState *ps, MemTuple tuple, uint32 hashvalu
 								  MemoryContext bfCxt);
 extern void ExecSquelchHashJoin(HashJoinState *node);
 
+extern bool ExecHashJoinRuntimeFilterPass(struct HashRuntimeFilterData *rf,
+							  TupleTableSlot *slot);
+
 #endif   /* NODEHASHJOIN_H */
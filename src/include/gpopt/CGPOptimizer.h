@@ -21,6 +21,7 @@ extern "C" {
 #include "nodes/params.h"
 #include "nodes/parsenodes.h"
 #include "nodes/plannodes.h"
+#include "optimizer/orca.h"
 }
 
 class CGPOptimizer
@@ -30,7 +31,10 @@ public:
 	static PlannedStmt *GPOPTOptimizedPlan(
 		Query *query,
 		bool *
-			had_unexpected_failure	// output : set to true if optimizer unexpectedly failed to produce plan
+			had_unexpected_failure,	 // output : set to true if optimizer unexpectedly failed to produce plan
+		MemoryContext
+			profile_context,  // context to allocate the profile in, NULL if it is not collected
+		OptimizerProfile **profile	// output : profile of the optimization
 	);
 
 	// serialize planned statement into DXL
@@ -40,15 +44,21 @@ public:
 	static void InitGPOPT();
 
 	static void TerminateGPOPT();
+
+	// is there a cost model parameter with the given name
+	static bool IsCostModelParam(const char *name);
 };
 
 extern "C" {
 
 extern PlannedStmt *GPOPTOptimizedPlan(Query *query,
-									   bool *had_unexpected_failure);
+									   bool *had_unexpected_failure,
+									   MemoryContext profile_context,
+									   OptimizerProfile **profile);
 extern char *SerializeDXLPlan(Query *query);
 extern void InitGPOPT();
 extern void TerminateGPOPT();
+extern bool GPOPTIsCostModelParam(const char *name);
 }
 
 #endif	// CGPOptimizer_H
@@ -60,6 +60,7 @@ struct Motion;
 struct Var;
 struct Const;
 struct ArrayExpr;
+struct CardinalityFeedbackFactor;
 
 namespace gpdb
 {
@@ -700,6 +701,28 @@ void MDCacheResetTransientState(void);
 // returns true if cache is in transient state
 bool MDCacheInTransientState(void);
 
+// returns true if the shared metadata cache is available to this backend
+bool SharedMDCacheIsEnabled(void);
+
+// current generation of the shared metadata cache; the invalidation
+// messages sent before it was bumped are processed before returning, so
+// that the objects translated afterwards are not older than it
+uint64 SharedMDCacheGetGeneration(void);
+
+// look up a serialized metadata object in the shared metadata cache;
+// returns a palloc'd copy, or NULL if the object is not cached
+void *SharedMDCacheGet(const char *mdid, Size *len);
+
+// store a serialized metadata object in the shared metadata cache, unless
+// the cache generation has changed since it was read
+bool SharedMDCachePut(const char *mdid, const void *data, Size len,
+					  uint64 generation);
+
+// correction factors for the cardinality estimates of a query; returns a
+// palloc'd array
+CardinalityFeedbackFactor *CardinalityFeedbackGetFactors(Query *query,
+														 int *nfactors);
+
 // returns true if a query cancel is requested in GPDB
 bool IsAbortRequested(void);
 
@@ -52,6 +52,9 @@ private:
 	// private copy ctor
 	CMDProviderRelcache(const CMDProviderRelcache &);
 
+	// build the key of an object in the shared metadata cache
+	static BOOL GetSharedCacheKey(IMDId *md_id, CHAR *key);
+
 public:
 	// ctor/dtor
 	explicit CMDProviderRelcache(CMemoryPool *mp);
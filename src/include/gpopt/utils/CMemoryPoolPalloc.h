@@ -29,9 +29,11 @@ private:
 	// To do this, we need the size of the allocation, which we then divide by the
 	// the size of the element to get number of elements to iterate through.
 	// This struct is only used for array allocations (GPOS_NEW_ARRAY())
+	// The size takes a full word, so that the word before an array never
+	// looks like the tag of an arena allocation (see CMemoryPoolArena)
 	struct SArrayAllocHeader
 	{
-		ULONG m_user_size;
+		ULLONG m_user_size;
 	};
 
 public:
@@ -51,6 +53,9 @@ public:
 	// return total allocated size include management overhead
 	ULLONG TotalAllocatedSize() const;
 
+	// return the largest total allocated size so far
+	ULLONG PeakAllocatedSize() const;
+
 	// get user requested size of allocation
 	static ULONG UserSizeOfAlloc(const void *ptr);
 };
@@ -37,9 +37,11 @@ class CDXLNode;
 
 namespace gpopt
 {
+class CCardinalityFeedback;
 class CExpression;
 class CMDAccessor;
 class CQueryContext;
+class COptimizationStats;
 class COptimizerConfig;
 class ICostModel;
 }  // namespace gpopt
@@ -48,6 +50,7 @@ struct PlannedStmt;
 struct Query;
 struct List;
 struct MemoryContextData;
+struct OptimizerProfile;
 
 using namespace gpos;
 using namespace gpdxl;
@@ -95,6 +98,13 @@ struct SOptContext
 	// buffer for optimizer error messages
 	CHAR *m_error_msg;
 
+	// memory context to allocate the profile of the optimization in, NULL
+	// if no profile is collected
+	struct MemoryContextData *m_profile_context;
+
+	// profile of the optimization, NULL if the plan came from the plan cache
+	OptimizerProfile *m_profile;
+
 	// ctor
 	SOptContext();
 
@@ -127,9 +137,19 @@ private:
 	static COptimizerConfig *CreateOptimizerConfig(CMemoryPool *mp,
 												   ICostModel *cost_model);
 
+	// create the cardinality feedback to optimize a query with, NULL if
+	// there is none
+	static CCardinalityFeedback *CreateCardinalityFeedback(CMemoryPool *mp,
+														   Query *query);
+
 	// optimize a query to a physical DXL
 	static void *OptimizeTask(void *ptr);
 
+	// convert the counters of an optimization into a profile for the backend
+	static OptimizerProfile *CreateProfile(
+		struct MemoryContextData *context,
+		const COptimizationStats *optimization_stats);
+
 	// translate a DXL tree into a planned statement
 	static PlannedStmt *ConvertToPlanStmtFromDXL(
 		CMemoryPool *mp, CMDAccessor *md_accessor, const Query *orig_query,
@@ -148,6 +168,16 @@ private:
 	// generate an instance of optimizer cost model
 	static ICostModel *GetCostModel(CMemoryPool *mp, ULONG num_segments);
 
+	// can the plan of the given query be cached?
+	static BOOL CanUsePlanCache(const Query *query);
+
+	// build the plan cache key of the given query
+	static CWStringDynamic *GetPlanCacheKey(
+		CMemoryPool *mp, const CDXLNode *query_dxl,
+		const CDXLNodeArray *query_output_dxlnode_array,
+		const CDXLNodeArray *cte_dxlnode_array,
+		const COptimizerConfig *optimizer_config, ULONG num_segments);
+
 	// print warning messages for columns with missing statistics
 	static void PrintMissingStatsWarning(CMemoryPool *mp,
 										 CMDAccessor *md_accessor,
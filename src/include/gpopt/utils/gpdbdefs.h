@@ -45,6 +45,7 @@ extern "C" {
 #include "nodes/pg_list.h"
 #include "nodes/plannodes.h"
 #include "nodes/print.h"
+#include "optimizer/orca.h"
 #include "optimizer/planmain.h"
 #include "optimizer/tlist.h"
 #include "optimizer/walkers.h"
@@ -431,6 +431,9 @@ typedef struct PartitionAccessMethods
 
 	/* Memory context for access methods */
 	MemoryContext part_cxt;
+
+	/* Indexes of the rules of each PartitionNode searched, built on demand */
+	HTAB	   *ruleIndexes;
 } PartitionAccessMethods;
 
 typedef struct PartitionState
@@ -1697,6 +1700,9 @@ typedef struct ScanState
 	PlanState	ps;				/* its first field is NodeTag */
 	Relation	ss_currentRelation;
 	TupleTableSlot *ss_ScanTupleSlot;
+
+	/* CDB: filter pushed down by a hash join above us, or NULL */
+	struct HashRuntimeFilterData *ss_runtimeFilter;
 } ScanState;
 
 /*
@@ -2446,6 +2452,9 @@ typedef struct HashJoinState
 	/* set if the operator created workfiles */
 	bool workfiles_created;
 	bool reuse_hashtable; /* Do we need to preserve hash table to support rescan */
+
+	/* runtime filter for the outer scan, or NULL if not applicable */
+	struct HashRuntimeFilterData *hj_RuntimeFilter;
 } HashJoinState;
 
 
@@ -2744,6 +2753,7 @@ typedef struct HashState
 	bool		hs_quit_if_hashkeys_null;	/* quit building hash table if hashkeys are all null */
 	bool		hs_hashkeys_null;	/* found an instance wherein hashkeys are all null */
 	/* hashkeys is same as parent's hj_InnerHashKeys */
+	struct bloom_filter *hs_bloom;	/* if set, add the hash values of all inner tuples */
 } HashState;
 
 /* ----------------
@@ -153,6 +153,13 @@ typedef struct PlannedStmt
 
 	int			total_memory_master;	/* GPDB: The total usable virtual memory on master node in MB */
 	int			nsegments_master;		/* GPDB: The number of primary segments on master node  */
+
+	/*
+	 * GPDB: profile of the ORCA optimization that produced the plan, if
+	 * optimizer_collect_profile was on. It is only shown by EXPLAIN of the
+	 * plan just optimized, so it is neither copied nor dispatched.
+	 */
+	struct OptimizerProfile *optimizerProfile;
 } PlannedStmt;
 
 /*
@@ -1994,6 +1994,13 @@ struct PartitionNode
 	Partition *part;
 	struct PartitionRule *default_part;
 	List *rules; /* rules for this level */
+
+	/*
+	 * The rules unrolled into an array, for selecting a partition without
+	 * PartitionAccessMethods; built on first use, and not copied or
+	 * serialized.  See get_partition_rule_index().
+	 */
+	struct PartitionRuleIndex *ruleIndex;
 };
 
 /* Individual partitioning rule */
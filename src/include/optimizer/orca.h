@@ -19,6 +19,34 @@
 
 #include "pg_config.h"
 
+/*
+ * Profile of an ORCA optimization, collected when optimizer_collect_profile
+ * is on. The names point to constant strings of the optimizer.
+ */
+typedef struct OptimizerJobProfile
+{
+	const char *name;			/* job type */
+	int64		steps;			/* number of job steps run */
+	double		time_ms;		/* time spent running them */
+} OptimizerJobProfile;
+
+typedef struct OptimizerXformProfile
+{
+	const char *name;			/* transformation */
+	int64		calls;			/* number of applications */
+	int64		alternatives;	/* number of alternatives produced */
+	double		time_ms;		/* time spent applying it */
+} OptimizerXformProfile;
+
+typedef struct OptimizerProfile
+{
+	int64		groups;			/* number of groups in the memo */
+	int			num_jobs;
+	OptimizerJobProfile *jobs;	/* job types that ran */
+	int			num_xforms;
+	OptimizerXformProfile *xforms;	/* xforms that were applied */
+} OptimizerProfile;
+
 #ifdef USE_ORCA
 
 extern PlannedStmt * optimize_query(Query *parse, ParamListInfo boundParams);
@@ -1388,6 +1388,13 @@ extern Datum enable_xform(PG_FUNCTION_ARGS);
 /* Optimizer's version */
 extern Datum gp_opt_version(PG_FUNCTION_ARGS);
 
+/* Optimizer's plan cache */
+extern Datum gp_optimizer_plan_cache_stats(PG_FUNCTION_ARGS);
+
+/* Optimizer's cardinality feedback */
+extern Datum gp_optimizer_cardinality_feedback(PG_FUNCTION_ARGS);
+extern Datum gp_optimizer_cardinality_feedback_reset(PG_FUNCTION_ARGS);
+
 /* query_metrics.c */
 extern Datum gp_instrument_shmem_summary(PG_FUNCTION_ARGS);
 
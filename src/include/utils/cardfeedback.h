@@ -0,0 +1,84 @@
+/*-------------------------------------------------------------------------
+ *
+ * cardfeedback.h
+ *	  prototypes for functions in backend/utils/cache/cardfeedback.c
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ * src/include/utils/cardfeedback.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CARDFEEDBACK_H
+#define CARDFEEDBACK_H
+
+struct PlannedStmt;						/* #include "nodes/plannodes.h" */
+struct Query;							/* #include "nodes/parsenodes.h" */
+struct QueryDesc;						/* #include "executor/execdesc.h" */
+
+/* maximum number of columns in a signature */
+#define CARDINALITY_FEEDBACK_MAX_COLUMNS	8
+
+/* kind of estimate a correction factor applies to */
+typedef enum CardinalityFeedbackKind
+{
+	CARDINALITY_FEEDBACK_SCAN,	/* rows returned by a filter on a table */
+	CARDINALITY_FEEDBACK_JOIN	/* rows returned by an inner equi-join */
+} CardinalityFeedbackKind;
+
+/*
+ * Shape of the predicates on a column, a bit mask.  Must match
+ * CCardinalityFeedback::EPredicateShape in GPORCA.
+ */
+#define CARDINALITY_FEEDBACK_EQ			0x01	/* compared with = */
+#define CARDINALITY_FEEDBACK_NE			0x02	/* compared with <> */
+#define CARDINALITY_FEEDBACK_LT			0x04	/* compared with < */
+#define CARDINALITY_FEEDBACK_LE			0x08	/* compared with <= */
+#define CARDINALITY_FEEDBACK_GT			0x10	/* compared with > */
+#define CARDINALITY_FEEDBACK_GE			0x20	/* compared with >= */
+#define CARDINALITY_FEEDBACK_OTHER		0x40	/* any other predicate */
+#define CARDINALITY_FEEDBACK_NONCONST	0x80	/* compared with a non-constant */
+
+/* a column of a table, and the shape of the predicates on it */
+typedef struct CardinalityFeedbackColumn
+{
+	Oid			relid;
+	AttrNumber	attno;
+	int16		shape;
+} CardinalityFeedbackColumn;
+
+/*
+ * The predicate an estimate was made for.  For a scan, the columns its
+ * filter refers to, sorted and distinct, each with the shape of the
+ * predicates on it.  For a join, its equality conditions, each one written
+ * as an ordered pair of columns, sorted and distinct.  Must be zeroed
+ * before it is filled in, it is used as a hash key.
+ */
+typedef struct CardinalityFeedbackSignature
+{
+	Oid			dbid;
+	int16		kind;			/* a CardinalityFeedbackKind */
+	int16		ncols;
+	CardinalityFeedbackColumn cols[CARDINALITY_FEEDBACK_MAX_COLUMNS];
+} CardinalityFeedbackSignature;
+
+/* a correction factor for the estimates of a predicate */
+typedef struct CardinalityFeedbackFactor
+{
+	CardinalityFeedbackSignature sig;
+	double		factor;
+} CardinalityFeedbackFactor;
+
+extern bool optimizer_cardinality_feedback;
+extern int	optimizer_cardinality_feedback_size;
+
+extern Size CardinalityFeedbackShmemSize(void);
+extern void CardinalityFeedbackShmemInit(void);
+
+extern CardinalityFeedbackFactor *CardinalityFeedbackGetFactors(struct Query *query,
+																int *nfactors);
+extern void CardinalityFeedbackPlanned(struct PlannedStmt *stmt);
+extern void CardinalityFeedbackRecord(struct QueryDesc *queryDesc);
+extern void CardinalityFeedbackForgetRelation(Oid relid);
+
+#endif   /* CARDFEEDBACK_H */
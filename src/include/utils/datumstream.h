@@ -312,6 +312,9 @@ extern int	datumstreamread_block(DatumStreamRead * ds,
 extern void datumstreamread_find(DatumStreamRead * datumStream,
 					 int32 rowNumInBlock);
 extern void datumstreamread_rewind_block(DatumStreamRead * datumStream);
+extern bool datumstreamread_block_header(DatumStreamRead * acc);
+extern void datumstreamread_skip_block(DatumStreamRead * acc);
+extern void datumstreamread_reset_block(DatumStreamRead * acc);
 extern bool datumstreamread_find_block(DatumStreamRead * datumStream,
 						   DatumStreamFetchDesc datumStreamFetchDesc,
 						   int64 rowNum);
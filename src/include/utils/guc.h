@@ -434,10 +434,12 @@ extern bool optimizer_control;	/* controls whether the user can change the setti
 extern bool	optimizer_log;
 extern int  optimizer_log_failure;
 extern bool	optimizer_trace_fallback;
+extern bool	optimizer_collect_profile;
 extern int optimizer_minidump;
 extern int  optimizer_cost_model;
 extern bool optimizer_metadata_caching;
 extern int	optimizer_mdcache_size;
+extern int	optimizer_plan_cache_size;
 
 /* Optimizer debugging GUCs */
 extern bool optimizer_print_query;
@@ -526,6 +528,25 @@ extern int optimizer_penalize_broadcast_threshold;
 extern double optimizer_cost_threshold;
 extern double optimizer_nestloop_factor;
 extern double optimizer_sort_factor;
+extern char *optimizer_cost_model_profile;
+
+/*
+ * Cost model parameters to scale, parsed from optimizer_cost_model_profile.
+ * The names are those of the parameters of GPORCA's cost model.
+ */
+typedef struct OptimizerCostParamFactor
+{
+	char		name[NAMEDATALEN];
+	double		factor;
+} OptimizerCostParamFactor;
+
+typedef struct OptimizerCostProfile
+{
+	int			nfactors;
+	OptimizerCostParamFactor factors[FLEXIBLE_ARRAY_MEMBER];
+} OptimizerCostProfile;
+
+extern OptimizerCostProfile *optimizer_cost_profile;
 
 /* Optimizer hints */
 extern int optimizer_array_expansion_threshold;
@@ -562,6 +583,7 @@ extern bool optimizer_analyze_midlevel_partition;
 extern bool optimizer_analyze_enable_merge_of_leaf_stats;
 
 extern bool optimizer_use_gpdb_allocators;
+extern bool optimizer_use_arena_allocator;
 extern bool optimizer_enable_table_alias;
 
 /* optimizer GUCs for replicated table */
@@ -581,6 +603,7 @@ extern bool	optimizer_partition_selection_log;
 #define JOIN_ORDER_GREEDY_SEARCH            1
 #define JOIN_ORDER_EXHAUSTIVE_SEARCH        2
 #define JOIN_ORDER_EXHAUSTIVE2_SEARCH       3
+#define JOIN_ORDER_DPHYP_SEARCH             4
 
 /* Time based authentication GUC */
 extern char  *gp_auth_time_override_str;
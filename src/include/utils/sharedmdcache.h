@@ -0,0 +1,30 @@
+/*-------------------------------------------------------------------------
+ *
+ * sharedmdcache.h
+ *	  prototypes for functions in backend/utils/cache/sharedmdcache.c
+ *
+ * Copyright (c) 2025 Greengage Community
+ *
+ * src/include/utils/sharedmdcache.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef SHAREDMDCACHE_H
+#define SHAREDMDCACHE_H
+
+/* maximum length of a serialized mdid that can be used as a key */
+#define SHARED_MDCACHE_KEYLEN	64
+
+extern int	optimizer_shared_mdcache_size;
+
+extern Size SharedMDCacheShmemSize(void);
+extern void SharedMDCacheShmemInit(void);
+
+extern bool SharedMDCacheEnabled(void);
+extern uint64 SharedMDCacheGeneration(void);
+extern void *SharedMDCacheLookup(const char *mdid, Size *len);
+extern bool SharedMDCacheInsert(const char *mdid, const void *data, Size len,
+								uint64 generation);
+extern void SharedMDCacheInvalidateAll(void);
+
+#endif   /* SHAREDMDCACHE_H */
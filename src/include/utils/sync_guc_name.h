@@ -14,19 +14,25 @@
 		"explain_memory_verbosity",
 		"gin_fuzzy_search_limit",
 		"gp_allow_date_field_width_5digits",
+		"gp_appendonly_compress_threads",
 		"gp_blockdirectory_entry_min_range",
 		"gp_blockdirectory_minipage_size",
 		"gp_debug_linger",
 		"gp_default_storage_options",
 		"gp_detect_data_correctness",
 		"gp_disable_tuple_hints",
+		"gp_enable_aocs_batch_scan",
+		"gp_enable_hashjoin_partitioning",
+		"gp_enable_hashjoin_prefetch",
 		"gp_enable_mk_sort",
 		"gp_enable_motion_mk_sort",
+		"gp_enable_runtime_filter",
 		"gp_enable_segment_copy_checking",
 		"gp_external_enable_filter_pushdown",
 		"gp_gpperfmon_send_interval",
 		"gp_hashagg_default_nbatches",
 		"gp_hashagg_groups_per_bucket",
+		"gp_hashjoin_partition_size",
 		"gp_hashjoin_tuples_per_bucket",
 		"gp_ignore_error_table",
 		"gp_indexcheck_insert",
@@ -83,6 +89,7 @@
 		"gp_workfile_compression_overhead_limit",
 		"gp_workfile_limit_files_per_query",
 		"gp_workfile_limit_per_query",
+		"gp_workfile_prefetch_blocks",
 		"IntervalStyle",
 		"lc_monetary",
 		"lc_numeric",
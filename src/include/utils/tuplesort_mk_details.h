@@ -58,6 +58,12 @@ typedef struct MKEntry
      *   Deciphering of this field is done by the functions that are passed when the multi-key heap is prepared
      */
     void *ptr;
+
+    /**
+     * Normalized key of the datum, if the level has one (see MKNormKeyType).  Set when the entry
+     *   is prepared for a level, along with d.
+     */
+    uint64 nkey;
 } MKEntry;
 
 /**
@@ -149,6 +155,7 @@ static inline void mke_set_empty(MKEntry *e)
     e->flags = 0;
 	e->d = 0;
 	e->ptr = 0;
+	e->nkey = 0;
 }
 static inline bool mke_is_empty(MKEntry *e)
 {
@@ -223,6 +230,27 @@ typedef enum MKLvType
     MKLV_TYPE_TEXT,  /* this level contains text values */
 } MKLvType;
 
+/*
+ * Normalized keys.  For some types, a datum can be mapped to an unsigned
+ * integer whose order is the sort order of the datums (descending order
+ * included), so that two prepared entries are compared without calling the
+ * comparison function, and a level can be radix sorted.  For short strings
+ * in the C collation the integer holds the first bytes of the string, and
+ * only decides the order of strings whose first bytes differ.
+ */
+typedef enum MKNormKeyType
+{
+    MKNK_NONE,      /* no normalized key */
+    MKNK_INT16,     /* int2 */
+    MKNK_INT32,     /* int4, date */
+    MKNK_INT64,     /* int8, timestamp, timestamptz, time */
+    MKNK_UINT32,    /* oid */
+    MKNK_FLOAT4,    /* float4 */
+    MKNK_FLOAT8,    /* float8 */
+    MKNK_TEXT,      /* prefix of text or varchar, C collation */
+    MKNK_BPCHAR,    /* prefix of char, C collation */
+} MKNormKeyType;
+
 typedef struct MKLvContext
 {
 	/* Is the type of datums in this level passed by value instead of reference */
@@ -234,6 +262,10 @@ typedef struct MKLvContext
     /* type of datums in this level, converted to our MKLvType enumeration */
     MKLvType lvtype;
 
+    /* normalized key of datums in this level, and does it decide their order */
+    MKNormKeyType nktype;
+    bool nkeyExact;
+
 	ScanKeyData	scanKey;
 
     int16 attno;
@@ -300,6 +332,25 @@ typedef struct MKContext {
 	char	   *indexname;
 } MKContext;
 
+/**
+ * Compare two entries prepared for a level by their normalized keys.  Returns true, and the
+ *   result of the comparison in *result, if the keys decide it.  The entries must not be null.
+ */
+static inline bool mke_compare_nkey(MKEntry *v1, MKEntry *v2, MKLvContext *lvctxt, int32 *result)
+{
+    if (lvctxt->nktype == MKNK_NONE)
+        return false;
+
+    if (v1->nkey != v2->nkey)
+    {
+        *result = (v1->nkey < v2->nkey) ? -1 : 1;
+        return true;
+    }
+
+    *result = 0;
+    return lvctxt->nkeyExact;
+}
+
 /**
  * This prepares entries AND sets their level.
  */
@@ -139,6 +139,7 @@
 		"gp_adjust_selectivity_for_outerjoins",
 		"gp_allow_non_uniform_partitioning_ddl",
 		"gp_allow_rename_relation_without_lock",
+		"gp_aocs_zonemap_cache_size",
 		"gp_appendonly_compaction",
 		"gp_appendonly_compaction_threshold",
 		"gp_appendonly_verify_block_checksums",
@@ -354,8 +355,12 @@
 		"optimizer_apply_left_outer_to_union_all_disregarding_stats",
 		"optimizer_array_constraints",
 		"optimizer_array_expansion_threshold",
+		"optimizer_cardinality_feedback",
+		"optimizer_cardinality_feedback_size",
+		"optimizer_collect_profile",
 		"optimizer_control",
 		"optimizer_cost_model",
+		"optimizer_cost_model_profile",
 		"optimizer_cost_threshold",
 		"optimizer_cte_inlining",
 		"optimizer_damping_factor_filter",
@@ -432,6 +437,7 @@
 		"optimizer_parallel_union",
 		"optimizer_penalize_broadcast_threshold",
 		"optimizer_penalize_skew",
+		"optimizer_plan_cache_size",
 		"optimizer_print_expression_properties",
 		"optimizer_print_group_properties",
 		"optimizer_print_job_scheduler",
@@ -454,10 +460,12 @@
 		"optimizer_sample_plans",
 		"optimizer_search_strategy_path",
 		"optimizer_segments",
+		"optimizer_shared_mdcache_size",
 		"optimizer_sort_factor",
 		"optimizer_trace_fallback",
 		"optimizer_skew_factor",
 		"optimizer_use_external_constant_expression_evaluation_for_ints",
+		"optimizer_use_arena_allocator",
 		"optimizer_use_gpdb_allocators",
 		"optimizer_enable_table_alias",
 		"password_encryption",
@@ -0,0 +1,107 @@
+-- Test skipping the varblocks of column tables by their min/max values.
+-- The zone map cache is off by default.
+-- start_ignore
+! gpconfig -c gp_aocs_zonemap_cache_size -v 1024;
+! gpstop -rai;
+-- end_ignore
+
+-- Count the blocks that were skipped, and the zone maps that were built
+-- rather than found in the cache, by the scans since zonemap_arm().
+CREATE FUNCTION zonemap_arm() RETURNS void AS $$
+begin /*in func*/
+  perform gp_inject_fault('aocs_zonemap_skip_block', 'reset', dbid), /*in func*/
+          gp_inject_fault('aocs_zonemap_build', 'reset', dbid) /*in func*/
+  from gp_segment_configuration where role = 'p' and content >= 0; /*in func*/
+  perform gp_inject_fault_infinite('aocs_zonemap_skip_block', 'skip', dbid), /*in func*/
+          gp_inject_fault_infinite('aocs_zonemap_build', 'skip', dbid) /*in func*/
+  from gp_segment_configuration where role = 'p' and content >= 0; /*in func*/
+end $$ /*in func*/
+LANGUAGE plpgsql;
+CREATE FUNCTION zonemap_hits(fault text) RETURNS int AS $$
+  SELECT sum(substring(gp_inject_fault(fault, 'status', dbid) /*in func*/
+                       from 'num times hit:''([0-9]+)''')::int)::int /*in func*/
+  FROM gp_segment_configuration WHERE role = 'p' AND content >= 0; /*in func*/
+$$ LANGUAGE sql;
+
+-- All the rows are on one segment, in about 50 blocks per column, sorted
+-- by a. b is NULL in the first half of the table.
+CREATE TABLE zonemap_t (k int, a int, b int)
+WITH (appendonly = true, orientation = column, blocksize = 8192) DISTRIBUTED BY (k);
+INSERT INTO zonemap_t SELECT 1, i, CASE WHEN i > 50000 THEN i % 100 END
+FROM generate_series(1, 100000) i;
+
+-- The first scan builds the zone maps, and skips by them already
+SELECT zonemap_arm();
+SELECT count(*), min(a), max(a), sum(b) FROM zonemap_t WHERE a <= 1000;
+SELECT zonemap_hits('aocs_zonemap_skip_block') > 0 AS skipped, zonemap_hits('aocs_zonemap_build') > 0 AS built;
+
+-- The next one finds them in the cache
+SELECT zonemap_arm();
+SELECT count(*), min(a), max(a), sum(b) FROM zonemap_t WHERE a <= 1000;
+SELECT zonemap_hits('aocs_zonemap_skip_block') > 0 AS skipped, zonemap_hits('aocs_zonemap_build') AS built;
+
+-- Ranges and equality, at the edges of the table and between blocks
+SELECT count(*), min(a), max(a) FROM zonemap_t WHERE a > 99990;
+SELECT count(*), min(a), max(a) FROM zonemap_t WHERE a >= 40000 AND a < 40010;
+SELECT count(*), min(a), max(a) FROM zonemap_t WHERE a = 77777;
+SELECT count(*) FROM zonemap_t WHERE a > 100000;
+SELECT count(*) FROM zonemap_t WHERE a < 1;
+SELECT zonemap_arm();
+SELECT count(*), sum(b) FROM zonemap_t WHERE 50 > a;
+SELECT zonemap_hits('aocs_zonemap_skip_block') > 0 AS skipped;
+
+-- A qual no block can be ruled out by skips nothing
+SELECT zonemap_arm();
+SELECT count(*) FROM zonemap_t WHERE a >= 1;
+SELECT zonemap_hits('aocs_zonemap_skip_block') AS skipped;
+
+-- Blocks with only NULLs in b are skipped by any comparison on b, but
+-- IS NULL is not a zone map key
+SELECT zonemap_arm();
+SELECT count(*), min(a) FROM zonemap_t WHERE b = 42;
+SELECT zonemap_hits('aocs_zonemap_skip_block') > 0 AS skipped;
+SELECT zonemap_arm();
+SELECT count(*), max(a) FROM zonemap_t WHERE b IS NULL;
+SELECT zonemap_hits('aocs_zonemap_skip_block') AS skipped;
+SELECT count(*) FROM zonemap_t WHERE b > 100;
+
+-- A column added later has zone maps of its own
+ALTER TABLE zonemap_t ADD COLUMN c int DEFAULT 7;
+SELECT zonemap_arm();
+SELECT count(*) FROM zonemap_t WHERE c = 8;
+SELECT zonemap_hits('aocs_zonemap_skip_block') > 0 AS skipped;
+SELECT count(*), sum(c) FROM zonemap_t WHERE c = 7 AND a <= 1000;
+UPDATE zonemap_t SET c = 8 WHERE a = 500;
+SELECT count(*), sum(c) FROM zonemap_t WHERE c = 7 AND a <= 1000;
+SELECT k, a, b, c FROM zonemap_t WHERE c = 8;
+
+-- Deleted and updated rows stay invisible in the blocks that are not
+-- skipped, and the rows appended by UPDATE are found in new blocks,
+-- whose zone maps are not known yet
+DELETE FROM zonemap_t WHERE a <= 10;
+UPDATE zonemap_t SET a = 200000 WHERE a = 20;
+SELECT zonemap_arm();
+SELECT count(*), min(a), max(a) FROM zonemap_t WHERE a <= 1000;
+SELECT zonemap_hits('aocs_zonemap_skip_block') > 0 AS skipped;
+SELECT k, a, b, c FROM zonemap_t WHERE a > 100000;
+SELECT zonemap_hits('aocs_zonemap_build') > 0 AS built;
+
+-- After VACUUM, and after TRUNCATE gives the table new files, the zone
+-- maps of the old contents are not used for the new ones
+VACUUM zonemap_t;
+SELECT count(*), min(a), max(a) FROM zonemap_t WHERE a <= 1000;
+TRUNCATE zonemap_t;
+INSERT INTO zonemap_t SELECT 1, 100001 - i, NULL, 0 FROM generate_series(1, 100000) i;
+SELECT zonemap_arm();
+SELECT count(*), min(a), max(a) FROM zonemap_t WHERE a <= 1000;
+SELECT zonemap_hits('aocs_zonemap_build') > 0 AS built;
+
+SELECT gp_inject_fault('all', 'reset', dbid) FROM gp_segment_configuration WHERE role = 'p' AND content >= 0;
+DROP TABLE zonemap_t;
+DROP FUNCTION zonemap_arm();
+DROP FUNCTION zonemap_hits(text);
+
+-- start_ignore
+! gpconfig -r gp_aocs_zonemap_cache_size;
+! gpstop -rai;
+-- end_ignore
@@ -0,0 +1,43 @@
+-- Test that a catalog change committed by one session is seen by GPORCA in
+-- another session, when the metadata objects are shared between backends.
+-- start_ignore
+! gpconfig -c optimizer_shared_mdcache_size -v 16384;
+! gpstop -rai;
+-- end_ignore
+
+CREATE TABLE shared_mdcache_t (a int, b int) DISTRIBUTED BY (a);
+INSERT INTO shared_mdcache_t SELECT i, i % 10 FROM generate_series(1, 100) i;
+ANALYZE shared_mdcache_t;
+CREATE FUNCTION shared_mdcache_rows(q text) RETURNS float8 AS $$
+declare /*in func*/
+  plan json; /*in func*/
+begin /*in func*/
+  execute 'explain (format json) ' || q into plan; /*in func*/
+  return (plan->0->'Plan'->>'Plan Rows')::float8; /*in func*/
+end $$ /*in func*/
+LANGUAGE plpgsql;
+
+1: SET optimizer = on;
+2: SET optimizer = on;
+
+-- session 2 translates the table, and publishes it in the shared cache
+2: SELECT shared_mdcache_rows('SELECT * FROM shared_mdcache_t WHERE b = 3') < 50 AS before_analyze;
+
+-- the new statistics are seen by session 2
+1: INSERT INTO shared_mdcache_t SELECT i, i % 10 FROM generate_series(101, 1000) i;
+1: ANALYZE shared_mdcache_t;
+2: SELECT shared_mdcache_rows('SELECT * FROM shared_mdcache_t WHERE b = 3') > 50 AS after_analyze;
+
+-- and so is a new column
+1: ALTER TABLE shared_mdcache_t ADD COLUMN c int DEFAULT 7;
+2: SELECT count(*), sum(c) FROM shared_mdcache_t WHERE b = 3;
+
+1q:
+2q:
+DROP TABLE shared_mdcache_t;
+DROP FUNCTION shared_mdcache_rows(text);
+
+-- start_ignore
+! gpconfig -r optimizer_shared_mdcache_size;
+! gpstop -rai;
+-- end_ignore
@@ -0,0 +1,118 @@
+--
+-- Batch mode for sequential scans of append-optimized column tables
+--
+create table aocs_batch (a int, b bigint, c int2, d date, t text)
+  with (appendonly=true, orientation=column) distributed by (a);
+insert into aocs_batch
+  select i, i * 10, (i % 100)::int2, date '2020-01-01' + i % 365,
+         case when i % 7 = 0 then null else 'row ' || i end
+  from generate_series(1, 10000) i;
+insert into aocs_batch values (10001, null, null, null, 'nulls');
+
+set gp_enable_aocs_batch_scan = on;
+
+select count(*), sum(a) from aocs_batch where a < 100;
+select count(*) from aocs_batch where b >= 50000 and b < 60000;
+select count(*) from aocs_batch where c = 42;
+-- commuted clause, and a cross-type comparison
+select count(*) from aocs_batch where 5000 < a and c > 97;
+select count(*) from aocs_batch where c < 1000::bigint;
+select count(*) from aocs_batch where d <= date '2020-01-05';
+-- NULLs never pass
+select count(*) from aocs_batch where b > 0;
+-- clauses that are not evaluated in batches are still applied
+select count(*), count(t) from aocs_batch where a > 9990 and t like 'row%';
+-- values of by-reference columns must stay valid across a batch
+select count(*), count(distinct t), min(t), max(t)
+  from aocs_batch where a between 1000 and 3000;
+
+-- the same results in row mode, on the same data
+create function aocs_batch_same(query text) returns bool as $$
+declare
+  batch_result text[];
+  row_result text[];
+begin
+  perform set_config('gp_enable_aocs_batch_scan', 'on', false);
+  execute 'select array_agg(r::text order by r::text) from (' || query || ') r'
+    into batch_result;
+  perform set_config('gp_enable_aocs_batch_scan', 'off', false);
+  execute 'select array_agg(r::text order by r::text) from (' || query || ') r'
+    into row_result;
+  perform set_config('gp_enable_aocs_batch_scan', 'on', false);
+  return batch_result = row_result;
+end;
+$$ language plpgsql;
+
+select aocs_batch_same('select a, b, c, d, t from aocs_batch where a < 100');
+select aocs_batch_same('select a from aocs_batch where b >= 50000 and b < 60000');
+select aocs_batch_same('select a from aocs_batch where 5000 < a and c > 97');
+select aocs_batch_same('select a from aocs_batch where c < 1000::bigint');
+select aocs_batch_same('select a, d from aocs_batch where d <= date ''2020-01-05''');
+select aocs_batch_same('select a, t from aocs_batch where a > 9990 and t like ''row%''');
+select aocs_batch_same('select t from aocs_batch where a between 1000 and 3000');
+
+-- Deleted and updated rows. The rows skipped as invisible, and the blocks
+-- and segment files read to skip them, must not invalidate the values of
+-- by-reference columns already in the batch. Small blocks, so that the
+-- deleted rows cross block boundaries, and a VACUUM that moves the rows to
+-- another segment file before more are inserted.
+create table aocs_batch_del (a int, t text, b bigint)
+  with (appendonly=true, orientation=column, blocksize=8192) distributed by (a);
+insert into aocs_batch_del
+  select i, 'row ' || i || repeat('x', i % 50), i * 10
+  from generate_series(1, 20000) i;
+delete from aocs_batch_del where a % 7 <> 0 and a < 5000;
+delete from aocs_batch_del where a between 8000 and 12000;
+update aocs_batch_del set t = t || ' updated', b = b + 1 where a % 11 = 0;
+vacuum aocs_batch_del;
+insert into aocs_batch_del
+  select i, 'row ' || i || repeat('x', i % 50), i * 10
+  from generate_series(20001, 25000) i;
+delete from aocs_batch_del where a % 3 = 0 and a > 15000;
+select count(*), sum(a) from aocs_batch_del where a > 100;
+select count(*) from aocs_batch_del where b < 150000 and b % 10 = 1;
+select count(*), count(distinct t), sum(length(t))
+  from aocs_batch_del where a between 4000 and 13000;
+select aocs_batch_same('select a, t, b from aocs_batch_del where a > 100');
+select aocs_batch_same('select t from aocs_batch_del where b < 150000 and b % 10 = 1');
+drop table aocs_batch_del;
+
+-- EXPLAIN ANALYZE shows the clauses evaluated in batches, and the rows read
+-- in batches and removed by them. All rows are on one segment.
+create function aocs_batch_explain(query text, out clauses int,
+                                   out passed bigint) as $$
+declare
+  ln text;
+  m text[];
+  nrows bigint := -1;
+begin
+  for ln in execute 'explain (analyze) ' || query loop
+    m := regexp_matches(ln, 'Batch mode: (\d+) clauses, (\d+) rows in \d+ batches, (\d+) rows removed');
+    if m is not null and m[2]::bigint > nrows then
+      nrows := m[2]::bigint;
+      clauses := m[1]::int;
+      passed := m[2]::bigint - m[3]::bigint;
+    end if;
+  end loop;
+end;
+$$ language plpgsql;
+
+create table aocs_batch_one (k int, a int, b bigint)
+  with (appendonly=true, orientation=column) distributed by (k);
+insert into aocs_batch_one select 1, i, i * 10 from generate_series(1, 10000) i;
+select * from aocs_batch_explain('select count(*) from aocs_batch_one where a < 100 and b > 50');
+select count(*) from aocs_batch_one where a < 100 and b > 50;
+-- a clause that is not evaluated in batches only sees the rows that passed
+select * from aocs_batch_explain('select count(*) from aocs_batch_one where a < 100 and a % 2 = 0');
+select count(*) from aocs_batch_one where a < 100 and a % 2 = 0;
+
+set gp_enable_aocs_batch_scan = off;
+select * from aocs_batch_explain('select count(*) from aocs_batch_one where a < 100 and b > 50');
+select count(*) from aocs_batch_one where a < 100 and b > 50;
+select count(*) from aocs_batch_one where a < 100 and a % 2 = 0;
+
+reset gp_enable_aocs_batch_scan;
+drop function aocs_batch_same(text);
+drop function aocs_batch_explain(text);
+drop table aocs_batch_one;
+drop table aocs_batch;
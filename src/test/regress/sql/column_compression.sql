@@ -810,3 +810,33 @@ CREATE TABLE co_large_and_bulk_content(a INT,
 INSERT INTO co_large_and_bulk_content SELECT * FROM ao_from_table;
 -- can't do count(*) as CO optimizes to read only first column
 SELECT * FROM co_large_and_bulk_content where a > 1;
+
+-- Compress the blocks of zlib and zstd tables in the thread pool, and check
+-- that they read back the same as blocks compressed in the backend.
+CREATE TABLE co_compress_threads (a int, b text, c numeric)
+  WITH (appendonly=true, orientation=column, compresstype=zlib, compresslevel=1)
+  DISTRIBUTED BY (a);
+CREATE TABLE ao_compress_threads (a int, b text, c numeric)
+  WITH (appendonly=true, compresstype=zstd, compresslevel=1)
+  DISTRIBUTED BY (a);
+CREATE TABLE co_compress_nothreads (a int, b text, c numeric)
+  WITH (appendonly=true, orientation=column, compresstype=zlib, compresslevel=1)
+  DISTRIBUTED BY (a);
+SET gp_appendonly_compress_threads = 4;
+INSERT INTO co_compress_threads
+SELECT i, repeat('x', i % 100) || i, i * 1.5 FROM generate_series(1, 50000) i;
+INSERT INTO co_compress_threads
+SELECT i, repeat('x', i % 100) || i, i * 1.5 FROM generate_series(50001, 100000) i;
+INSERT INTO ao_compress_threads SELECT * FROM co_compress_threads;
+RESET gp_appendonly_compress_threads;
+INSERT INTO co_compress_nothreads
+SELECT i, repeat('x', i % 100) || i, i * 1.5 FROM generate_series(1, 100000) i;
+SELECT count(*), sum(a), sum(length(b)), sum(c) FROM co_compress_threads;
+SELECT count(*), sum(a), sum(length(b)), sum(c) FROM ao_compress_threads;
+SELECT count(*) FROM co_compress_threads t JOIN co_compress_nothreads n USING (a)
+WHERE t.b <> n.b OR t.c <> n.c;
+SELECT count(*) FROM ao_compress_threads t JOIN co_compress_nothreads n USING (a)
+WHERE t.b <> n.b OR t.c <> n.c;
+DROP TABLE co_compress_threads;
+DROP TABLE ao_compress_threads;
+DROP TABLE co_compress_nothreads;
@@ -169,6 +169,51 @@ set gp_enable_explain_allstat=true;
 explain (analyze, format json) select * from allstat_test;
 reset gp_enable_explain_allstat;
 
+-- Test the profile of ORCA shown by EXPLAIN VERBOSE when
+-- optimizer_collect_profile is on. The times vary, so only the shape of the
+-- profile is checked: the number of groups, and a line or an entry for the
+-- job types and for the xforms.
+create function orca_profile(query text, fmt text, collect boolean,
+                             out groups boolean, out jobs boolean,
+                             out xforms boolean) as $$
+declare
+  ln text;
+  js json;
+begin
+  groups := false;
+  jobs := false;
+  xforms := false;
+  perform set_config('optimizer_collect_profile', collect::text, false);
+  if fmt = 'json' then
+    execute 'explain (verbose, format json) ' || query into js;
+    js := js->0->'Settings'->'Optimizer Profile';
+    if js is not null then
+      groups := (js->>'Groups')::int > 0;
+      jobs := json_array_length(js->'Jobs') > 0;
+      xforms := json_array_length(js->'Xforms') > 0;
+    end if;
+  else
+    for ln in execute 'explain (verbose, costs off) ' || query loop
+      groups := groups or ln ~ '^\s*Optimizer profile: groups=[1-9]\d*$';
+      jobs := jobs or ln ~ '^\s+Job \w+: steps=\d+ time=\d+\.\d{3} ms$';
+      xforms := xforms or
+        ln ~ '^\s+Xform \w+: calls=\d+ alternatives=\d+ time=\d+\.\d{3} ms$';
+    end loop;
+  end if;
+end;
+$$ language plpgsql;
+set optimizer_collect_profile = on;
+select * from orca_profile('select * from allstat_test a1 join allstat_test a2 on a1.a = a2.a', 'text', true);
+select * from orca_profile('select * from allstat_test a1 join allstat_test a2 on a1.a = a2.a', 'json', true);
+-- The statement calling orca_profile() is itself optimized with the profile
+-- on, in the same command. Its profile must not be shown for the query
+-- explained inside, which is optimized with the profile off.
+select * from orca_profile('select * from allstat_test a1 join allstat_test a2 on a1.a = a2.a', 'text', false);
+set optimizer_collect_profile = on;
+select * from orca_profile('select * from allstat_test a1 join allstat_test a2 on a1.a = a2.a', 'json', false);
+reset optimizer_collect_profile;
+drop function orca_profile(text, text, boolean);
+
 -- Cleanup
 RESET search_path;
 DROP SCHEMA explaintest cascade;
@@ -442,3 +442,26 @@ FETCH c2;
 END;
 
 DROP TABLE guc_gp_t1;
+
+-- optimizer_cost_model_profile is a list of name=factor pairs, naming
+-- parameters of the cost model of GPORCA
+SET optimizer_cost_model_profile = 'SeqIOBandwidth=0.5, GatherSendCostUnit = 2';
+SHOW optimizer_cost_model_profile;
+-- malformed lists are rejected
+SET optimizer_cost_model_profile = 'SeqIOBandwidth';
+SET optimizer_cost_model_profile = 'SeqIOBandwidth=0.5,';
+SET optimizer_cost_model_profile = 'SeqIOBandwidth=0.5 GatherSendCostUnit=2';
+SET optimizer_cost_model_profile = '=2';
+SET optimizer_cost_model_profile = 'SeqIOBandwidth=';
+-- and so are unknown parameters
+SET optimizer_cost_model_profile = 'NoSuchCostUnit=2';
+SET optimizer_cost_model_profile = 'SeqIOBandwidth=0.5, seqiobandwidth=2';
+-- and factors that are not positive and finite
+SET optimizer_cost_model_profile = 'SeqIOBandwidth=0';
+SET optimizer_cost_model_profile = 'SeqIOBandwidth=-1';
+SET optimizer_cost_model_profile = 'SeqIOBandwidth=inf';
+SET optimizer_cost_model_profile = 'SeqIOBandwidth=nan';
+-- none of them replaced the valid profile
+SHOW optimizer_cost_model_profile;
+RESET optimizer_cost_model_profile;
+SHOW optimizer_cost_model_profile;
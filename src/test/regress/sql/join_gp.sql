@@ -883,3 +883,149 @@ select * from tbl1 join tbl2 using (b);
 
 drop table tbl1;
 drop table tbl2;
+
+-- Check that the runtime filter of a hash join doesn't drop rows that
+-- have a match, or rows that the join needs to preserve
+-- start_ignore
+drop table if exists rf_fact;
+drop table if exists rf_dim;
+-- end_ignore
+create table rf_fact (id int, dim_id int, val int) distributed by (dim_id);
+create table rf_dim (id int, name text) distributed by (id);
+insert into rf_fact select i, i % 1000, i from generate_series(1, 20000) i;
+insert into rf_fact values (0, null, 0);
+insert into rf_dim select i, 'dim' || i from generate_series(1, 1000, 100) i;
+insert into rf_dim values (null, 'null');
+analyze rf_fact;
+analyze rf_dim;
+
+set gp_enable_runtime_filter = on;
+select count(*), sum(f.val) from rf_fact f join rf_dim d on f.dim_id = d.id;
+select count(*) from rf_fact f where exists (select 1 from rf_dim d where d.id = f.dim_id);
+select count(*), count(f.id) from rf_fact f right join rf_dim d on f.dim_id = d.id;
+select count(*) from rf_fact f join rf_dim d on f.dim_id + 0 = d.id and f.val > 100;
+select count(*) from rf_fact f left join rf_dim d on f.dim_id = d.id;
+
+-- The rows the runtime filter drops are counted on the outer scan. The
+-- segment EXPLAIN ANALYZE reports on must account for all of its rows,
+-- either passed up to the join or removed by the filter.
+create function rf_scan_counts(query text, out scanned bigint,
+                               out removed bigint) as $$
+declare
+  ln text;
+  m text[];
+  in_scan bool := false;
+begin
+  for ln in execute 'explain (analyze) ' || query loop
+    m := regexp_matches(ln, 'Seq Scan on rf_fact .*actual [^)]*rows=(\d+)');
+    if m is not null then
+      scanned := m[1]::bigint;
+      in_scan := true;
+    elsif in_scan and ln ~ '->' then
+      in_scan := false;
+    elsif in_scan then
+      m := regexp_matches(ln, 'Rows Removed by Runtime Filter: (\d+)');
+      if m is not null then
+        removed := m[1]::bigint;
+      end if;
+    end if;
+  end loop;
+end;
+$$ language plpgsql;
+
+select removed > 0 as filtered,
+       scanned + removed in (select count(*) from rf_fact group by gp_segment_id) as accounted
+from rf_scan_counts('select count(*) from rf_fact f join rf_dim d on f.dim_id = d.id');
+set gp_enable_runtime_filter = off;
+select removed is null as not_filtered
+from rf_scan_counts('select count(*) from rf_fact f join rf_dim d on f.dim_id = d.id');
+reset gp_enable_runtime_filter;
+
+drop function rf_scan_counts(text);
+drop table rf_fact;
+drop table rf_dim;
+
+-- Check the results of hash joins whose hash table is partitioned for the
+-- CPU cache
+-- start_ignore
+drop table if exists hp_outer;
+drop table if exists hp_inner;
+-- end_ignore
+create table hp_outer (id int, k int) distributed by (id);
+create table hp_inner (k int, pad text) distributed by (k);
+insert into hp_outer select i, i % 40000 from generate_series(1, 60000) i;
+insert into hp_outer values (0, null);
+insert into hp_inner select i, repeat('x', 100) from generate_series(1, 45000) i;
+analyze hp_outer;
+analyze hp_inner;
+
+-- Does the EXPLAIN ANALYZE output of a query have a line matching a pattern?
+create or replace function hp_explain_matches(query text, pattern text) returns bool as
+$$
+declare
+  explainrow text;
+begin
+  for explainrow in execute 'explain (analyze) ' || query
+  loop
+    if explainrow ~ pattern then
+      return true;
+    end if;
+  end loop;
+  return false;
+end;
+$$ language plpgsql;
+
+set gp_hashjoin_partition_size = 64;
+select count(*), sum(o.id) from hp_outer o join hp_inner i on o.k = i.k;
+select count(*), count(i.k) from hp_outer o left join hp_inner i on o.k = i.k;
+select count(*), count(o.id), count(i.k) from hp_outer o full join hp_inner i on o.k = i.k;
+select count(*) from hp_outer o where o.k in (select k from hp_inner);
+select hp_explain_matches('select count(*) from hp_outer o join hp_inner i on o.k = i.k',
+                          'Probed in \d+ partitions');
+-- rescans of a partitioned hash table, complete or in the middle of a probe
+select g, (select count(*) from hp_outer o join hp_inner i on o.k = i.k
+           where o.id % 3 = g % 3)
+from generate_series(1, 3) g order by g;
+select g, (select count(*) from (select o.id from hp_outer o join hp_inner i on o.k = i.k
+                                 where o.id % 3 = g % 3 limit 100) s)
+from generate_series(1, 3) g order by g;
+-- a partitioned hash table that does not fit in memory
+set statement_mem = '1MB';
+select count(*), sum(length(i1.pad)) from hp_inner i1 join hp_inner i2 on i1.k = i2.k;
+select count(*), count(i.k) from hp_outer o left join hp_inner i on o.k = i.k;
+select hp_explain_matches('select count(*) from hp_inner i1 join hp_inner i2 on i1.k = i2.k',
+                          'Work file set');
+select hp_explain_matches('select count(*) from hp_inner i1 join hp_inner i2 on i1.k = i2.k',
+                          'Probed in \d+ partitions');
+reset statement_mem;
+-- batched probes without prefetching
+set gp_enable_hashjoin_prefetch = off;
+select count(*), sum(o.id) from hp_outer o join hp_inner i on o.k = i.k;
+select count(*), count(o.id), count(i.k) from hp_outer o full join hp_inner i on o.k = i.k;
+reset gp_enable_hashjoin_prefetch;
+-- batched probes of a single buffer
+set gp_enable_hashjoin_partitioning = off;
+select count(*), sum(o.id) from hp_outer o join hp_inner i on o.k = i.k;
+select count(*), count(o.id), count(i.k) from hp_outer o full join hp_inner i on o.k = i.k;
+-- probes of one outer tuple at a time
+set gp_enable_hashjoin_prefetch = off;
+select count(*), sum(o.id) from hp_outer o join hp_inner i on o.k = i.k;
+select count(*), count(o.id), count(i.k) from hp_outer o full join hp_inner i on o.k = i.k;
+select hp_explain_matches('select count(*) from hp_outer o join hp_inner i on o.k = i.k',
+                          'Probed in \d+ partitions');
+reset gp_enable_hashjoin_prefetch;
+reset gp_enable_hashjoin_partitioning;
+-- NOT IN drops the outer tuples with a NULL key, in each of the modes above
+select count(*) from hp_outer o where o.k not in (select k from hp_inner);
+set gp_enable_hashjoin_prefetch = off;
+select count(*) from hp_outer o where o.k not in (select k from hp_inner);
+set gp_enable_hashjoin_partitioning = off;
+select count(*) from hp_outer o where o.k not in (select k from hp_inner);
+reset gp_enable_hashjoin_prefetch;
+select count(*) from hp_outer o where o.k not in (select k from hp_inner);
+reset gp_enable_hashjoin_partitioning;
+reset gp_hashjoin_partition_size;
+
+drop function hp_explain_matches(text, text);
+drop table hp_outer;
+drop table hp_inner;
@@ -0,0 +1,103 @@
+--
+-- Tests for the cardinality feedback to GPORCA
+--
+set optimizer = on;
+set optimizer_cardinality_feedback = on;
+
+create table cardfb_t (a int, b int) distributed by (a);
+insert into cardfb_t select i, i % 10 from generate_series(1, 1000) i;
+create table cardfb_u (a int, c int) distributed by (a);
+insert into cardfb_u select i, i from generate_series(1, 100) i;
+analyze cardfb_t;
+analyze cardfb_u;
+
+-- run EXPLAIN ANALYZE of a query, without the output that varies
+create function cardfb_explain(q text) returns void as $$
+declare
+	r record;
+begin
+	for r in execute 'explain analyze ' || q loop
+	end loop;
+end;
+$$ language plpgsql;
+
+select gp_optimizer_cardinality_feedback_reset();
+
+-- The signature of a filter has the comparison type of every column, and
+-- whether it is compared with a constant
+select cardfb_explain('select * from cardfb_t where b = 3');
+select cardfb_explain('select * from cardfb_t where b < 3');
+select cardfb_explain('select * from cardfb_t where b = 5 and a > 100');
+select cardfb_explain('select * from cardfb_t where a = b');
+select cardfb_explain('select * from cardfb_t t join cardfb_u u on t.a = u.a');
+select kind, attnums, predicates, observations
+from gp_optimizer_cardinality_feedback
+where 'cardfb_t'::regclass = any(relids)
+order by kind, attnums::text collate "C", predicates::text collate "C";
+
+-- but not the values of the constants
+select cardfb_explain('select * from cardfb_t where b = 7');
+select observations from gp_optimizer_cardinality_feedback
+where 'cardfb_t'::regclass = any(relids) and predicates = '{=}';
+
+-- A later plan of the query is estimated with the factor. b and c are
+-- correlated, which GPORCA does not know, so it underestimates the filter
+-- until it has seen the actual row count.
+create table cardfb_c (a int, b int, c int) distributed by (a);
+insert into cardfb_c select i, i % 10, i % 10 from generate_series(1, 1000) i;
+analyze cardfb_c;
+create function cardfb_estimate(q text) returns float8 as $$
+declare
+	r record;
+	m text[];
+begin
+	for r in execute 'explain ' || q loop
+		m := regexp_matches(r."QUERY PLAN", 'rows=(\d+)');
+		if m is not null then
+			return m[1]::float8;
+		end if;
+	end loop;
+	return null;
+end;
+$$ language plpgsql;
+select cardfb_estimate('select * from cardfb_c where b = 3 and c = 3') as before_estimate \gset
+select :before_estimate < 90 as underestimated;
+select cardfb_explain('select * from cardfb_c where b = 3 and c = 3');
+select cardfb_estimate('select * from cardfb_c where b = 3 and c = 3') between 90 and 110 as corrected;
+select cardfb_estimate('select * from cardfb_c where b = 5 and c = 5') between 90 and 110 as corrected;
+
+-- but not a filter that is not right on top of the scan of the table
+select cardfb_estimate('select * from (select * from cardfb_c limit 1000) s where b = 3 and c = 3') < 90 as not_corrected;
+drop table cardfb_c;
+drop function cardfb_estimate(text);
+
+-- ANALYZE forgets the feedback on the table
+analyze cardfb_t;
+select count(*) from gp_optimizer_cardinality_feedback
+where 'cardfb_t'::regclass = any(relids);
+
+-- and so does TRUNCATE
+select cardfb_explain('select * from cardfb_t where b = 3');
+select count(*) from gp_optimizer_cardinality_feedback
+where 'cardfb_t'::regclass = any(relids);
+truncate cardfb_t;
+select count(*) from gp_optimizer_cardinality_feedback
+where 'cardfb_t'::regclass = any(relids);
+
+-- and DROP, the oid may be reused
+insert into cardfb_t select i, i % 10 from generate_series(1, 1000) i;
+select cardfb_explain('select * from cardfb_t where b = 3');
+select 'cardfb_t'::regclass::oid as cardfb_oid \gset
+drop table cardfb_t;
+select count(*) from gp_optimizer_cardinality_feedback
+where :cardfb_oid = any(relids);
+
+-- gp_optimizer_cardinality_feedback_reset() forgets everything
+select cardfb_explain('select * from cardfb_u where c < 10');
+select count(*) > 0 as recorded from gp_optimizer_cardinality_feedback
+where 'cardfb_u'::regclass = any(relids);
+select gp_optimizer_cardinality_feedback_reset();
+select count(*) from gp_optimizer_cardinality_feedback;
+
+drop table cardfb_u;
+drop function cardfb_explain(text);
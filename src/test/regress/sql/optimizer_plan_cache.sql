@@ -0,0 +1,50 @@
+--
+-- Tests for the plan cache of GPORCA
+--
+set optimizer = on;
+set optimizer_metadata_caching = on;
+set optimizer_plan_cache_size = 1024;
+
+create table plan_cache_t (a int, b int) distributed by (a);
+insert into plan_cache_t select i, i % 10 from generate_series(1, 1000) i;
+analyze plan_cache_t;
+
+-- the counters of the current backend
+select * from gp_optimizer_plan_cache where false;
+
+-- A query that repeats verbatim hits the cache
+select count(*) from plan_cache_t where b = 3;
+select hits as h0, invalidations as i0 from gp_optimizer_plan_cache \gset
+select count(*) from plan_cache_t where b = 3;
+select hits > :h0 as hit, entries > 0 as cached from gp_optimizer_plan_cache;
+
+-- ANALYZE invalidates the cached plans
+select count(*) from plan_cache_t where b = 3;
+insert into plan_cache_t select i, i % 10 from generate_series(1001, 2000) i;
+analyze plan_cache_t;
+select hits as h1, invalidations as i1 from gp_optimizer_plan_cache \gset
+select count(*) from plan_cache_t where b = 3;
+select hits = :h1 as not_hit, :i1 > :i0 as invalidated
+from gp_optimizer_plan_cache;
+
+-- and so does DDL on the relation
+select count(*) from plan_cache_t where b = 3;
+alter table plan_cache_t add column c int;
+select hits as h2, invalidations as i2 from gp_optimizer_plan_cache \gset
+select count(*) from plan_cache_t where b = 3;
+select hits = :h2 as not_hit, :i2 > :i1 as invalidated
+from gp_optimizer_plan_cache;
+select count(*) from plan_cache_t where b = 3;
+select hits > :h2 as hit from gp_optimizer_plan_cache;
+
+-- Nothing is cached when the cache is disabled
+set optimizer_plan_cache_size = 0;
+select hits as h3 from gp_optimizer_plan_cache \gset
+select count(*) from plan_cache_t where b = 3;
+select count(*) from plan_cache_t where b = 3;
+select hits = :h3 as no_hits, entries = 0 as no_entries from gp_optimizer_plan_cache;
+
+reset optimizer_plan_cache_size;
+reset optimizer_metadata_caching;
+reset optimizer;
+drop table plan_cache_t;
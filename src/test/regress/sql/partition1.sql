@@ -1487,3 +1487,37 @@ SELECT user_name FROM users_test_1_prt_p2019;
 SELECT user_name FROM users_test_1_prt_p2020;
 -- Expect C
 SELECT user_name FROM users_test_1_prt_extra;
+
+--
+-- Route rows of a multi-row INSERT through the sorted index of the values
+-- of a LIST partitioned table, which is built after a few rows and must
+-- keep its by-reference values across them.
+--
+create table part_list_text (a int, b text) distributed by (a)
+partition by list (b)
+(partition p1 values ('alpha', 'beta'),
+ partition p2 values ('gamma'),
+ partition p3 values ('delta'),
+ partition pnull values (null),
+ default partition other);
+insert into part_list_text
+select i, (array['alpha', 'beta', 'gamma', 'delta', null, 'omega'])[i % 6 + 1]
+from generate_series(1, 60) i;
+select tableoid::regclass::text as part, b, count(*) from part_list_text
+group by 1, 2 order by 1, 2;
+select gp_segment_id, count(*) from part_list_text group by 1 having count(*) < 9;
+
+create table part_list_numeric (a int, n numeric) distributed by (a)
+partition by list (n)
+(partition p1 values (1.5, 2.25),
+ partition p2 values (100),
+ partition pnull values (null),
+ default partition other);
+insert into part_list_numeric
+select i, (array[1.5, 2.25, 100, 7.125, null, 1.50])[i % 6 + 1]
+from generate_series(1, 60) i;
+select tableoid::regclass::text as part, n::text as n, count(*) from part_list_numeric
+group by 1, 2 order by 1, 2;
+
+drop table part_list_text;
+drop table part_list_numeric;
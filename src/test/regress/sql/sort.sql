@@ -142,3 +142,91 @@ select count(*) from t;
 
 reset gp_enable_mk_sort;
 reset enable_hashjoin;
+
+--
+-- Test sorts on the normalized keys of int, bigint, float and text columns,
+-- with nulls and duplicates, large enough to be radix sorted
+--
+set gp_enable_mk_sort = on;
+create table nkeysort (i int, b bigint, f float8, t text);
+insert into nkeysort
+select case when g % 50 = 0 then null else (g * 7919) % 1000 - 500 end,
+       ((g * 7919) % 1000)::bigint * 1000000007 - 1,
+       ((g * 7919) % 1000 - 500) / 7.0,
+       lpad(((g * 7919) % 1000)::text, 12, 'x')
+from generate_series(0, 1999) g;
+
+select count(*) from (select i, lag(i) over (order by i) p from nkeysort) s where p > i;
+select count(*) from (select i, row_number() over (order by i nulls first) rn from nkeysort) s where (i is null) <> (rn <= 40);
+select count(*) from (select b, lag(b) over (order by b desc) p from nkeysort) s where p < b;
+select count(*) from (select f, lag(f) over (order by f) p from nkeysort) s where p > f;
+select count(*) from (select t, lag(t) over (order by t collate "C" desc) p from nkeysort) s where p < t collate "C";
+
+-- Multi-column sorts. The buckets of equal keys of the first column are
+-- radix sorted on the next column, and small buckets are quick sorted on the
+-- last one.
+create table nkeymulti (a int, b bigint, t text);
+insert into nkeymulti
+select g % 10, (g * 7919) % 50, lpad(((g * 31) % 1000)::text, 10, 'x')
+from generate_series(0, 9999) g;
+
+select count(*) from (
+  select a, b, t, lag(a) over w pa, lag(b) over w pb, lag(t) over w pt
+  from nkeymulti window w as (order by a, b desc, t collate "C")) s
+where pa > a or (pa = a and (pb < b or (pb = b and pt > t collate "C")));
+-- text keys with a common 8-byte prefix, compared in full, then an int level
+select count(*) from (
+  select t, a, lag(t) over w pt, lag(a) over w pa
+  from (select 'prefix__' || (b % 5) t, a from nkeymulti) m
+  window w as (order by t collate "C", a)) s
+where pt > t collate "C" or (pt = t and pa > a);
+
+-- bpchar in the C collation: trailing spaces are not significant, and
+-- strings sort after their prefixes
+create table nkeybpchar (c char(12));
+insert into nkeybpchar values ('abcdefgh1'), ('abcdefgh 2'), ('abcdefgh'),
+  ('abc'), ('abc  '), ('B'), ('a'), (''), (null);
+select c from nkeybpchar order by c collate "C";
+select c from nkeybpchar order by c collate "C" desc;
+insert into nkeybpchar
+select case when g % 3 = 0 then 'k' || (g * 7919) % 1000
+            when g % 3 = 1 then ((g * 7919) % 1000)::text || '  '
+            else 'abcdefgh' || (g * 7919) % 100 end
+from generate_series(0, 1999) g;
+select count(*) from (select c, lag(c) over (order by c collate "C") p from nkeybpchar) s where p > c collate "C";
+select count(*) from (select c, lag(c) over (order by c collate "C" desc) p from nkeybpchar) s where p < c collate "C";
+
+-- External sorts, with runs merged from tapes, on the same keys
+create or replace function sort_schema.has_external_sort(explain_analyze_query text)
+returns bool as
+$$
+rv = plpy.execute(explain_analyze_query)
+for i in range(len(rv)):
+    if 'Sort Method:  external' in rv[i]['QUERY PLAN']:
+        return True
+return False
+$$
+language plpythonu;
+
+create table nkeyspill (i int, t text);
+insert into nkeyspill
+select case when g % 50 = 0 then null else (g * 7919) % 100000 - 50000 end,
+       lpad(((g * 7919) % 100000)::text, 20, 'x')
+from generate_series(0, 99999) g;
+
+set statement_mem = '1MB';
+set work_mem = '64kB';
+select sort_schema.has_external_sort('explain analyze select i, lag(i) over (order by i) from nkeyspill;');
+select count(*) from (select i, lag(i) over (order by i) p from nkeyspill) s where p > i;
+select count(*) from (select i, row_number() over (order by i nulls first) rn from nkeyspill) s where (i is null) <> (rn <= 2000);
+select count(*) from (select t, lag(t) over (order by t collate "C" desc) p from nkeyspill) s where p < t collate "C";
+reset statement_mem;
+reset work_mem;
+
+drop function sort_schema.has_external_sort(text);
+drop table nkeysort;
+drop table nkeymulti;
+drop table nkeybpchar;
+drop table nkeyspill;
+
+reset gp_enable_mk_sort;
@@ -12,7 +12,9 @@ SerializeDXLPlan(Query *pquery)
 }
 
 PlannedStmt *
-GPOPTOptimizedPlan(Query *pquery, bool pfUnexpectedFailure)
+GPOPTOptimizedPlan(Query *pquery, bool pfUnexpectedFailure,
+				   MemoryContext profile_context,
+				   struct OptimizerProfile **profile)
 {
 	elog(ERROR, "mock implementation of GPOPTOptimizedPlan called");
 	return NULL;
@@ -39,6 +41,13 @@ DisableXform(PG_FUNCTION_ARGS)
 	return (Datum) 0;
 }
 
+void
+GetPlanCacheStats(int64 *entries, int64 *hits, int64 *misses,
+				  int64 *evictions, int64 *invalidations)
+{
+	elog(ERROR, "mock implementation of GetPlanCacheStats called");
+}
+
 void
 InitGPOPT ()
 {